@@ -45,6 +45,11 @@
 //   0.42   201202  DAH - Moved RTC and Internal Time code from Iod.c to a new module, RealTime.c
 //                          - Added include of RealTime_def.h and deleted includes of Iod_def.h and
 //                            Iod_ext.h
+//   153    240205  DAH - Replaced the IAR location operator (@".sram1", @".sram2") with SRAM1_LOC and
+//                        SRAM2_LOC so the module can be compiled in the host build
+//   177    240229  DAH - Added CAMSvPub and CAM_SV_VarInit() for the sampled-value frames
+//                        (ENABLE_CAM_SV_FRAME defined)
+//                          - Added include of Iod_def.h (for ENABLE_CAM_SV_FRAME)
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -71,8 +76,9 @@
 //
 #include "stm32f4xx.h"
 #include "stm32f407xx.h"
-#include "CAMCom_def.h"
 #include "RealTime_def.h"
+#include "Iod_def.h"                    // Must be preceded by RealTime_def.h!
+#include "CAMCom_def.h"                 // Must be preceded by Iod_def.h!
 #include "Demand_def.h"
 #include "Events_def.h"
 #include "Setpnt_def.h"
@@ -98,6 +104,9 @@
 void CAM_VarInit(struct CAMPORTVARS *port);
 void CAM_Tx(struct CAMPORTVARS *port, DMA_Stream_TypeDef *DMA_Stream);
 void CAM_Rx(struct CAMPORTVARS *port, DMA_Stream_TypeDef *DMA_Stream);
+#ifdef ENABLE_CAM_SV_FRAME
+  void CAM_SV_VarInit(void);
+#endif
 
 
 //      Local Function Prototypes (These functions are called only within this module)
@@ -111,7 +120,10 @@ void CAM_Rx(struct CAMPORTVARS *port, DMA_Stream_TypeDef *DMA_Stream);
 //
 //       These variables are used by other modules...
 //
-struct CAMPORTVARS CAM1 @".sram2", CAM2 @".sram2";
+struct CAMPORTVARS CAM1 SRAM2_LOC, CAM2 SRAM2_LOC;
+#ifdef ENABLE_CAM_SV_FRAME
+  struct CAM_SV_PUB CAMSvPub SRAM2_LOC;
+#endif
 
 //
 //------------------------------------------------------------------------------------------------------------
@@ -184,6 +196,60 @@ void CAM_VarInit(struct CAMPORTVARS *port)
 
 
 
+#ifdef ENABLE_CAM_SV_FRAME
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        CAM_SV_VarInit()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Sampled-Value Frame Publisher Variable Initialization
+//
+//  MECHANICS:          This subroutine initializes the sampled-value frame publisher (ENABLE_CAM_SV_FRAME
+//                      defined).  The fixed header fields of both frames are set, so the sampling interrupt
+//                      only needs to fill in the sequence number and the time stamp.  The next frame is
+//                      Frame[0], with sequence number 0.
+//                      The following variables do not need initialization:
+//                          CAMSvPub.Crc                The CRC is started with the first sample set of each
+//                                                      frame
+//
+//  CAVEATS:            Call only during initialization, or with the sampling interrupt disabled
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            CAMSvPub
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void CAM_SV_VarInit(void)
+{
+  uint8_t i;
+
+  for (i=0; i<2; ++i)
+  {
+    CAMSvPub.Frame[i].Sync = CAMSV_SYNC;
+    CAMSvPub.Frame[i].NumSamples = CAMSV_SAMPLES;
+    CAMSvPub.Frame[i].Spare = 0;
+    CAMSvPub.Frame[i].Spare2 = 0;
+    CAMSvPub.Frames[i] = 0;
+    CAMSvPub.Drops[i] = 0;
+  }
+  CAMSvPub.SeqNum = 0;
+  CAMSvPub.FillNdx = 0;
+  CAMSvPub.NumSamp = 0;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          CAM_SV_VarInit()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_CAM_SV_FRAME
+
+
+
 
 
 //------------------------------------------------------------------------------------------------------------
@@ -29,6 +29,8 @@
 //  MODULE NAME:        CAMCom_def.h
 //
 //  MECHANICS:          This is the definitions file for the CAMCom.c module
+//                      Note, Iod_def.h must be included before this file, since the sampled-value frame
+//                      definitions are only compiled in if ENABLE_CAM_SV_FRAME is defined
 //
 //  TARGET HARDWARE:    PXR35 Rev 1 and later boards
 //
@@ -38,6 +40,8 @@
 //   0.00   150316  DAH File Creation
 //   0.15   160718  DAH - Added CAMPORTVARS and CAM.Status flag defs to support basic CAM port testing
 //   0.16   160818  DAH - Renamed NumChars to TxNumChars in struct CAMPORTVARS
+//   177    240229  DAH - Added the sampled-value frame constants (CAMSV_xx), struct CAM_SV_FRAME, and
+//                        struct CAM_SV_PUB (ENABLE_CAM_SV_FRAME defined)
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -63,6 +67,27 @@
 #define CAMPORT_RXBUFSIZE   96
 #define CAMPORT_TXBUFSIZE   52
 
+// Sampled-value frames (ENABLE_CAM_SV_FRAME defined).  Instead of a DMA transfer of each sample set, the
+//   sample sets are collected into frames of CAMSV_SAMPLES sets, and a frame is sent to each sampled-value
+//   CAM with one DMA transfer.  A frame is:
+//     Header (CAMSV_HDR_BYTES):  Sync (CAMSV_SYNC), number of sample sets, spare, sequence number,
+//                                internal time of the first sample set (seconds, nanoseconds)
+//     Sample sets:               CAMSV_SAMPLES x struct RAM_SAMPLES (CAMSV_SAMPLE_BYTES each)
+//     CRC:                       CRC-16 of the header and the sample sets (see Crc_def.h), ls byte first
+//   The multi-byte values are little-endian.  At 3.75Mbps, a frame (306 bytes) takes 816usec to send, and a
+//   frame is sent every 1.67msec (at 4800 samples/sec).  The receiver checks the CRC, and uses the sequence
+//   number to detect missing frames
+#ifdef ENABLE_CAM_SV_FRAME
+  #ifndef ENABLE_CRC_SLICE
+    #error ENABLE_CAM_SV_FRAME requires ENABLE_CRC_SLICE
+  #endif
+  #define CAMSV_SYNC            0xA55A      // Sent 0x5A, 0xA5
+  #define CAMSV_SAMPLES         8           // Sample sets per frame
+  #define CAMSV_SAMPLE_WORDS    9           // Words per sample set (sizeof(struct RAM_SAMPLES) / 4)
+  #define CAMSV_SAMPLE_BYTES    (CAMSV_SAMPLE_WORDS * 4)
+  #define CAMSV_HDR_BYTES       16
+  #define CAMSV_FRAME_BYTES     (CAMSV_HDR_BYTES + (CAMSV_SAMPLES * CAMSV_SAMPLE_BYTES) + 2)
+#endif
 
 
 
@@ -86,6 +111,34 @@ struct CAMPORTVARS
    uint32_t         DMA_HISR_TCIF_FlagMask;
 };
 
+#ifdef ENABLE_CAM_SV_FRAME
+  // Sampled-value frame.  The first CAMSV_FRAME_BYTES bytes are sent.  Spare2 is not sent
+  struct CAM_SV_FRAME
+  {
+     uint16_t         Sync;                 // CAMSV_SYNC
+     uint8_t          NumSamples;           // Sample sets in the frame (CAMSV_SAMPLES)
+     uint8_t          Spare;                // Spare to keep alignment ok
+     uint32_t         SeqNum;               // Frame sequence number
+     uint32_t         TS_secs;              // Internal time of the first sample set
+     uint32_t         TS_nsec;
+     uint32_t         Samples[CAMSV_SAMPLES][CAMSV_SAMPLE_WORDS];   // Sample sets (struct RAM_SAMPLES)
+     uint16_t         Crc;                  // CRC of the header and the sample sets
+     uint16_t         Spare2;
+  };
+
+  // Sampled-value publisher.  The sampling interrupt fills one frame while the other frame is being sent
+  struct CAM_SV_PUB
+  {
+     struct CAM_SV_FRAME Frame[2];          // Ping-pong frame buffers
+     uint32_t         SeqNum;               // Sequence number of the frame being filled
+     uint32_t         Frames[2];            // Frames started, CAM1 and CAM2
+     uint32_t         Drops[2];             // Frames aborted because the previous frame was not done
+     uint16_t         Crc;                  // Running CRC of the frame being filled
+     uint8_t          FillNdx;              // Index of the frame being filled
+     uint8_t          NumSamp;              // Sample sets in the frame being filled
+  };
+#endif
+
 
 // CAM.Status flag definitions
 // b7..b4 - unused
@@ -38,6 +38,7 @@
 //   0.00   150617  DAH File Creation
 //   0.15   160718  DAH - Added CAM1, CAM2, CAM_VarInit(), CAM_Rx(), and CAM_Tx() to support basic CAM port
 //                        testing
+//   177    240229  DAH - Added CAMSvPub and CAM_SV_VarInit() (ENABLE_CAM_SV_FRAME defined)
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -61,6 +62,9 @@
 //------------------------------------------------------------------------------------------------------------
 //
 extern struct CAMPORTVARS CAM1, CAM2;
+#ifdef ENABLE_CAM_SV_FRAME
+  extern struct CAM_SV_PUB CAMSvPub;
+#endif
 
 //------------------------------------------------------------------------------------------------------------
 //                    Global Function Declarations
@@ -69,4 +73,7 @@ extern struct CAMPORTVARS CAM1, CAM2;
 extern void CAM_VarInit(struct CAMPORTVARS *port);
 extern void CAM_Tx(struct CAMPORTVARS *port, DMA_Stream_TypeDef *DMA_Stream);
 extern void CAM_Rx(struct CAMPORTVARS *port, DMA_Stream_TypeDef *DMA_Stream);
+#ifdef ENABLE_CAM_SV_FRAME
+  extern void CAM_SV_VarInit(void);
+#endif
 
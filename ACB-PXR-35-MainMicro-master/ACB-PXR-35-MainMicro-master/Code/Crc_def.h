@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//
+//  MODULE NAME:        Crc_def.h
+//
+//  MECHANICS:          This is the definitions file for the Crc.c module.  It must be preceded by Iod_def.h,
+//                      since the module is only compiled in if ENABLE_CRC_SLICE is defined
+//
+//  TARGET HARDWARE:    PXR35 Rev 1 and later boards
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   169    240221  DAH File Creation
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+// Path for library files:
+//   IAR Systems\Embedded Workbench 8.3\arm\inc\c
+//
+//------------------------------------------------------------------------------------------------------------
+
+#ifndef CRC_DEF_H
+#define CRC_DEF_H
+
+//
+//------------------------------------------------------------------------------------------------------------
+//    Constants
+//------------------------------------------------------------------------------------------------------------
+
+// CRC-16 used by Modbus RTU and the display processor communications (ENABLE_CRC_SLICE defined).  The
+//   generator polynomial is x^16 + x^15 + x^2 + 1 (0xA001 reflected), the initial value is 0xFFFF, and the
+//   CRC is sent ls byte first.  A received message that includes its CRC bytes has a CRC of zero.
+//   CRC16_SLICE[0][] is the standard byte-wise table.  It is the same as CRC_TABLE1[] (DispComm.c) with the
+//   bytes swapped, so the byte update below needs only a shift and an exclusive-or, instead of the shifts
+//   and the multiply of the CRC_TABLE1[] update
+#define CRC16_INIT              0xFFFF
+#define CRC16_SLICES            8           // Tables (bytes processed per step in Crc16_Block())
+
+// Update the CRC with one byte.  Used by the packet assemblers, which process the message a byte at a time
+#define CRC16_BYTE(crc, ch)     ( (uint16_t)(((crc) >> 8) ^ CRC16_SLICE[0][((crc) ^ (ch)) & 0xFF]) )
+
+#endif                  // CRC_DEF_H
@@ -112,6 +112,8 @@
 //                      - Fixed bug in Calc_Demand() where EID was being incremented with each entry
 //    150   240202  DAH - Revised Calc_Demand() to handle cases where demand calculations and/or demand
 //                        logging may be disabled.  Switched subroutine to a state machine format
+//    167   240219  DAH - Revised Calc_Demand() to insert the demand events with InsertEventEntry() if
+//                        ENABLE_EVENT_QUEUE is defined
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -1286,8 +1288,12 @@ void Calc_Demand(void)
           EngyDmnd[1].TS.Time_secs = Dmnd_SaveEvent.TS.Time_secs;     // Insert an event into the queue with
           EngyDmnd[1].TS.Time_nsec = Dmnd_SaveEvent.TS.Time_nsec;     //   the saved EID and time stamp
           EngyDmnd[1].EID = Dmnd_SaveEvent.EID;
+#ifdef ENABLE_EVENT_QUEUE
+          InsertEventEntry(DEMAND_EVENT, EngyDmnd[1].EID, &EngyDmnd[1].TS);
+#else
           NewEventFIFO[NewEventInNdx++].Code = DEMAND_EVENT;
           NewEventInNdx &= 0x0F;                                // *** DAH This relies on NEWEVENTFIFO[] SIZE = 16!
+#endif
 
           Next_LA_Time = next_la_temp;                                // Update next logging anniversary time
           Dmnd_ForceLog = FALSE;                                      // Clear the force log flag
@@ -1300,10 +1306,16 @@ void Calc_Demand(void)
           //   the buffer.
           if (dmndwin_status != DMND_ERROR)
           {
+#ifdef ENABLE_EVENT_QUEUE
+            EngyDmnd[1].TS.Time_secs = presenttime.Time_secs;
+            EngyDmnd[1].TS.Time_nsec = presenttime.Time_nsec;
+            InsertEventEntry(DEMAND_EVENT, EngyDmnd[1].EID, &EngyDmnd[1].TS);
+#else
             NewEventFIFO[NewEventInNdx++].Code = DEMAND_EVENT;
             NewEventInNdx &= 0x0F;                              // This relies on NEWEVENTFIFO[] SIZE = 16!
             EngyDmnd[1].TS.Time_secs = presenttime.Time_secs;
             EngyDmnd[1].TS.Time_nsec = presenttime.Time_nsec;
+#endif
           }
           Next_LA_Time = next_la_temp;                          // Update next logging anniversary time
         }
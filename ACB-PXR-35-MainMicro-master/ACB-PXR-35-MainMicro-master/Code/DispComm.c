@@ -452,6 +452,27 @@
 //                            processor's firmware version buffer is received
 //                      - Modified ProcWrSetpoints() and ProcExActWAck() to add event insertion for
 //                        setpoints download and set change
+//   153    240205  DAH - Replaced the IAR location operator (@".sram1", @".sram2") with SRAM1_LOC and
+//                        SRAM2_LOC so the module can be compiled in the host build
+//   165    240217  DAH - Revised ProcReadReqDel() to pass the address of the capture for the waveform read
+//                        requests if the waveforms are coded (ENABLE_WF_CODEC defined)
+//   167    240219  DAH - Replaced the writes to the new event FIFO in ProcExActWAck() with calls to
+//                        InsertNewEvent() (ENABLE_EVENT_QUEUE defined).  The password event codes are held
+//                        in evcode until the event is inserted
+//   169    240221  DAH - If ENABLE_CRC_SLICE is defined, the CRC is computed with the tables in Crc.c
+//                          - AssembleTxPkt() and AssembleTxPkt1() revised to update the CRC with each set of
+//                            data in one call to Crc16_Block(), before the data is inserted
+//                          - AssembleRxPkt() and AssembleRxPkt1() revised to update the CRC with CRC16_BYTE()
+//                          - Added includes of Crc_def.h and Crc_ext.h
+//   170    240222  DAH - Added the scatter-gather packet encoder (ENABLE_DP_TX_SG defined).  The data to be
+//                        sent is given as a list of spans, and each segment is found with a look-ahead scan
+//                        and copied in one move, instead of inserting the data one byte at a time
+//                          - Added AssembleTxPktSG(), BuildTxSpans(), and DPTxSpan[]
+//                          - BuildRTDBufByTSlice() and BuildRTDBufByBufnum() revised to insert the RTD
+//                            buffer objects and the harmonics with AssembleTxPktSG()
+//                          - DispComm_Tx() revised to insert the write responses with AssembleTxPktSG()
+//   178    240301  DAH - ProcWrFactoryConfig() revised to call Apply_CalConstants() after the AFE and ADC cal
+//                        constants are written, so the new constants are used to scale the samples
 //                        
 //------------------------------------------------------------------------------------------------------------
 //
@@ -494,6 +515,7 @@
 #include "Intr_def.h"
 #include "Flags_def.h"
 #include "Modbus_def.h"
+#include "Crc_def.h"
 
 
 //
@@ -507,6 +529,11 @@
 #define TURNAROUND_TIME         4       // *** DAH  THIS MAY BE TOO SHORT FOR THE DISPLAY PROCESSOR - NEED TO TEST THE MAX RESPONSE TIME FOR THE DISPLAY PROCESSOR!!
 #define RESPONSE_TIME           6       // *** DAH  THIS MAY BE TOO SHORT FOR THE DISPLAY PROCESSOR - NEED TO TEST THE MAX RESPONSE TIME FOR THE DISPLAY PROCESSOR!!
 
+// The scatter-gather encoder computes the CRC of each span with Crc16_Block()
+#if defined(ENABLE_DP_TX_SG) && !defined(ENABLE_CRC_SLICE)
+  #error ENABLE_DP_TX_SG requires ENABLE_CRC_SLICE
+#endif
+
 //
 //
 //------------------------------------------------------------------------------------------------------------
@@ -527,6 +554,7 @@
 #include "RealTime_ext.h"
 #include "Ovrcom_ext.h"
 #include "Modbus_ext.h"
+#include "Crc_ext.h"
 
 
 //      Global (Visible) Function Prototypes (These functions are called by other modules)
@@ -542,6 +570,10 @@ void DispComm61850_Rx(void);
 //      Local Function Prototypes (These functions are called only within this module)
 //
 void AssembleTxPkt(uint8_t *SrcPtr, uint16_t SrcLen, struct DISPCOMMVARS *port, uint8_t LastSet);
+#ifdef ENABLE_DP_TX_SG
+  void AssembleTxPktSG(const struct DP_TXSPAN *span, uint8_t num, struct DISPCOMMVARS *port, uint8_t LastSet);
+  uint8_t BuildTxSpans(void * const *objaddr_ptr, uint16_t numobj, uint8_t objlen, uint8_t nspan);
+#endif
 uint8_t AssembleRxPkt(DMA_Stream_TypeDef *DMA_Stream, struct DISPCOMMVARS *port);
 void ProcReadReqImm();
 void ProcReadReqDel();
@@ -579,8 +611,8 @@ void AssembleDiagBuffer(uint16_t bufid, uint8_t cmnd, uint8_t addr, uint16_t buf
 //
 //       These variables are used by other modules...
 //
-struct DISPCOMMVARS DPComm @".sram2";
-struct DISPCOMM61850VARS DPComm61850 @".sram2";
+struct DISPCOMMVARS DPComm SRAM2_LOC;
+struct DISPCOMM61850VARS DPComm61850 SRAM2_LOC;
 struct INTERNAL_TIME IntSyncTime;
 
 uint8_t DispProc_FW_Rev;
@@ -650,6 +682,9 @@ uint8_t xmitwait;
 uint8_t DPTxReqFlags;
 uint8_t DP_Tmr4BufSel, DP_Tmr5BufSel;
 struct INTERNAL_TIME DP_OutSyncTime;
+#ifdef ENABLE_DP_TX_SG
+  struct DP_TXSPAN DPTxSpan[DP_TXSPAN_MAX];
+#endif
 
 uint8_t                     StartUP_Status_Send;
 struct SUB_CBSTATUSCTRL     Sub_GoCB_Status_Ctrl_Pkt[(MAX_GOOSE_SUB - 1)];
@@ -1399,14 +1434,20 @@ void DispComm_VarInit(void)
 //  ALTERS:             port->TxNdx - Next open index in the transmit buffer
 //                      port->TxCRC - CRC of the message
 //
-//  CALLS:              None
+//  CALLS:              Crc16_Block() (if ENABLE_CRC_SLICE is defined)
 //
 //------------------------------------------------------------------------------------------------------------
 
 void AssembleTxPkt(uint8_t *SrcPtr, uint16_t SrcLen, struct DISPCOMMVARS *port, uint8_t LastSet)
 {
   uint16_t SrcNdx;
+#ifdef ENABLE_CRC_SLICE
+  uint8_t i;
+
+  port->TxCRC = Crc16_Block(port->TxCRC, SrcPtr, SrcLen);   // Update the CRC with the whole set of data
+#else
   uint8_t nxt_char, i;
+#endif
 
   // Insert the data into the transmit buffer.  Check each character to see if it matches a packet
   //   delimiter.  If it does, this marks the end of a segement, so format it using the modified COBS
@@ -1420,8 +1461,10 @@ void AssembleTxPkt(uint8_t *SrcPtr, uint16_t SrcLen, struct DISPCOMMVARS *port,
       port->TxSegNdx = port->TxNdx++;       //   segment index to the next spot in the Tx buffer, increment
       ++port->TxSegCharCnt;                 //   the Tx buffer index, and increment the segment character
     }                                       //   count (to account for the stuffed 0xFF byte)
+#ifndef ENABLE_CRC_SLICE
     nxt_char = (port->TxCRC ^ SrcPtr[SrcNdx]) & 0x00FF;      // Update the CRC
     port->TxCRC = ((port->TxCRC ^ CRC_TABLE1[nxt_char]) >> 8) + ((CRC_TABLE1[nxt_char] & 0x00FF) * 256);
+#endif
     // If the data char does not match a delimiter, just store it in the transmit buffer and increment the
     //   index
     if (SrcPtr[SrcNdx] > 0x01)
@@ -1483,6 +1526,188 @@ void AssembleTxPkt(uint8_t *SrcPtr, uint16_t SrcLen, struct DISPCOMMVARS *port,
 //------------------------------------------------------------------------------------------------------------
 
 
+#ifdef ENABLE_DP_TX_SG
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        AssembleTxPktSG()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Insert a List of Data Spans For Transmission Subroutine
+//
+//  MECHANICS:          This subroutine inserts the data in span[0] thru span[num-1] into the transmit
+//                      buffer, in order, according to the Advanced Communications Adapter Interface
+//                      protocol.  The result is the same as calling AssembleTxPkt() for each span, and the
+//                      two may be mixed in the same message (the insertion state is kept in port).
+//                      The CRC of each span is computed with one call to Crc16_Block().  The data is then
+//                      inserted a segment at a time instead of a byte at a time:
+//                        - If the present segment already has 126 characters, it is ended with a segment
+//                          code of xFF (no encoded character) and a new segment is started
+//                        - The data is scanned ahead for the next delimiter (0 or 1), up to the number of
+//                          characters left in the segment.  Four bytes are checked at a time; a word has a
+//                          byte that is less than 2 if ((word - x02020202) & ~word & x80808080) is nonzero.
+//                          The bytes ahead of the delimiter are stored in the transmit buffer as they are
+//                          checked, a word at a time where possible
+//                        - If a delimiter was found, it is encoded in the segment code (b7..1 = segment
+//                          length, b0 = the delimiter), and a new segment is started
+//                      If this is the last set of data, AssembleTxPkt() is called with no data to insert
+//                      the CRC, the last segment code, and the end of packet character.
+//
+//  CAVEATS:            The encoded message must fit in the transmit buffer (see AssembleTxPkt()).  The
+//                      spans must not overlap the transmit buffer.
+//                      The data is copied into the transmit buffer, rather than transmitted by the DMA
+//                      directly from the source.  The STM32F407 DMA streams cannot be chained (only two
+//                      memory pointers in double-buffer mode), and the data (metered values, etc.) may
+//                      change after the CRC has been computed, so it must be captured when the message
+//                      is assembled.
+//
+//  INPUTS:             span[] - the data spans to be inserted
+//                      num - the number of spans
+//                      port->TxNdx - Next open index in the transmit buffer
+//                      port->TxSegCharCnt - Number of characters in the present segment
+//                      port->TxSegNdx - Location (index) of the present segment code
+//                      LastSet - True if this is the last set of data to be inserted into the packet
+//
+//  OUTPUTS:            port->TxBuf[] - Transmit buffer
+//
+//  ALTERS:             port->TxNdx - Next open index in the transmit buffer
+//                      port->TxCRC - CRC of the message
+//
+//  CALLS:              Crc16_Block(), memcpy(), AssembleTxPkt()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void AssembleTxPktSG(const struct DP_TXSPAN *span, uint8_t num, struct DISPCOMMVARS *port, uint8_t LastSet)
+{
+  const uint8_t *src;
+  uint8_t *dptr;
+  uint32_t word;
+  uint16_t left, run, k;
+  uint8_t n;
+
+  for (n=0; n<num; ++n)
+  {
+    src = span[n].Ptr;
+    left = span[n].Len;
+    port->TxCRC = Crc16_Block(port->TxCRC, src, left);     // Update the CRC with the whole span
+    while (left > 0)
+    {
+      if (port->TxSegCharCnt >= 126)        // If the segment is full, there are no data chars in this
+      {                                     //   segment that need to be encoded, so set the segment code to
+        port->TxBuf[port->TxSegNdx] = 0xFF; //   xFF, set the segment index to the next spot in the Tx
+        port->TxSegNdx = port->TxNdx++;     //   buffer, increment the Tx buffer index, and reset the
+        port->TxSegCharCnt = 0;             //   segment character count
+      }
+      run = 126 - port->TxSegCharCnt;      // Number of chars that fit in the present segment
+      if (run > left)
+      {
+        run = left;
+      }
+      // Look ahead for the first delimiter in the chars that fit in the present segment, and store the
+      //   data chars ahead of it as they are checked
+      dptr = &port->TxBuf[port->TxNdx];
+      k = 0;
+      while ((k + 4) <= run)
+      {
+        memcpy(&word, &src[k], 4);
+        if (((word - 0x02020202) & (~word) & 0x80808080) != 0)
+        {
+          break;
+        }
+        memcpy(&dptr[k], &word, 4);
+        k += 4;
+      }
+      while ( (k < run) && (src[k] > 0x01) )
+      {
+        dptr[k] = src[k];
+        ++k;
+      }
+      port->TxNdx += k;
+      port->TxSegCharCnt += k;
+      src += k;
+      left -= k;
+      // If a delimiter was found, store the segment code at the present segment index, set the segment
+      //   index to the next open spot in the Tx buffer, increment the Tx index (i.e., skip a spot to
+      //   reserve for the next segment code), and reset the segment character count
+      if (k < run)
+      {
+        port->TxBuf[port->TxSegNdx] = ((port->TxNdx - port->TxSegNdx) << 1)  // b7..b1 = segment length
+                                          + *src;                            // b0 = data val at next seg code
+        port->TxSegNdx = port->TxNdx++;
+        port->TxSegCharCnt = 0;
+        ++src;
+        --left;
+      }
+    }
+  }
+  if (LastSet)                              // Insert the CRC bytes, the last segment code, and the end of
+  {                                         //   packet char
+    AssembleTxPkt(&port->TxBuf[0], 0, port, TRUE);
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          AssembleTxPktSG()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        BuildTxSpans()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Add Data Objects to the Span List Subroutine
+//
+//  MECHANICS:          This subroutine adds numobj data objects, each objlen bytes long, to the span list
+//                      (DPTxSpan[]) for AssembleTxPktSG().  objaddr_ptr[] holds the addresses of the
+//                      objects (an RTD buffer address table).  If an object starts right after the end of
+//                      the last span, the span is lengthened instead of adding a new one, so objects that
+//                      are next to each other in memory are inserted as one span.
+//
+//  CAVEATS:            DP_TXSPAN_MAX must be at least the number of objects in the message
+//
+//  INPUTS:             objaddr_ptr[] - the addresses of the objects
+//                      numobj - the number of objects
+//                      objlen - the length of each object
+//                      nspan - the number of spans already in DPTxSpan[]
+//
+//  OUTPUTS:            DPTxSpan[]
+//                      The subroutine returns the new number of spans
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t BuildTxSpans(void * const *objaddr_ptr, uint16_t numobj, uint8_t objlen, uint8_t nspan)
+{
+  uint8_t *ptr;
+  uint16_t i;
+
+  for (i=0; i<numobj; ++i)
+  {
+    ptr = (uint8_t *)(objaddr_ptr[i]);
+    if ( (nspan > 0) && ((DPTxSpan[nspan-1].Ptr + DPTxSpan[nspan-1].Len) == ptr) )
+    {
+      DPTxSpan[nspan-1].Len += objlen;
+    }
+    else
+    {
+      DPTxSpan[nspan].Ptr = ptr;
+      DPTxSpan[nspan].Len = objlen;
+      ++nspan;
+    }
+  }
+  return (nspan);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          BuildTxSpans()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_DP_TX_SG
+
+
 
 
 
@@ -1513,14 +1738,20 @@ void AssembleTxPkt(uint8_t *SrcPtr, uint16_t SrcLen, struct DISPCOMMVARS *port,
 //  ALTERS:             port->TxNdx - Next open index in the transmit buffer
 //                      port->TxCRC - CRC of the message
 //
-//  CALLS:              None
+//  CALLS:              Crc16_Block() (if ENABLE_CRC_SLICE is defined)
 //
 //------------------------------------------------------------------------------------------------------------
 
 void AssembleTxPkt1(uint8_t *SrcPtr, uint16_t SrcLen, struct DPCOMMTXVARS *port, uint8_t LastSet)
 {
   uint16_t SrcNdx;
+#ifdef ENABLE_CRC_SLICE
+  uint8_t i;
+
+  port->TxCRC = Crc16_Block(port->TxCRC, SrcPtr, SrcLen);   // Update the CRC with the whole set of data
+#else
   uint8_t nxt_char, i;
+#endif
 
   // Insert the data into the transmit buffer.  Check each character to see if it matches a packet
   //   delimiter.  If it does, this marks the end of a segement, so format it using the modified COBS
@@ -1534,8 +1765,10 @@ void AssembleTxPkt1(uint8_t *SrcPtr, uint16_t SrcLen, struct DPCOMMTXVARS *port,
       port->TxSegNdx = port->TxNdx++;       //   segment index to the next spot in the Tx buffer, increment
       ++port->TxSegCharCnt;                 //   the Tx buffer index, and increment the segment character
     }                                       //   count (to account for the stuffed 0xFF byte)
+#ifndef ENABLE_CRC_SLICE
     nxt_char = (port->TxCRC ^ SrcPtr[SrcNdx]) & 0x00FF;      // Update the CRC
     port->TxCRC = ((port->TxCRC ^ CRC_TABLE1[nxt_char]) >> 8) + ((CRC_TABLE1[nxt_char] & 0x00FF) * 256);
+#endif
     // If the data char does not match a delimiter, just store it in the transmit buffer and increment the
     //   index
     if (SrcPtr[SrcNdx] > 0x01)
@@ -1638,7 +1871,7 @@ void AssembleTxPkt1(uint8_t *SrcPtr, uint16_t SrcLen, struct DPCOMMTXVARS *port,
 //  ALTERS:             DPComm.TxState, DPComm.XmitReqClrMsk, DPComm.Flags
 //
 //  CALLS:              AssembleAck(), ProcReadReqImm(), ProcReadReqDel(), AssembleTxPkt(),
-//                      AssembleExActBuffer(), Get_InternalTime()
+//                      AssembleExActBuffer(), Get_InternalTime(), AssembleTxPktSG()
 //
 //------------------------------------------------------------------------------------------------------------
 
@@ -1667,7 +1900,13 @@ void DispComm_Tx(void)
           DPComm.TxSegCharCnt = 0;
           DPComm.TxNdx = 2;
           DPComm.TxCRC = 0xFFFF;
+#ifdef ENABLE_DP_TX_SG
+          DPTxSpan[0].Ptr = &DPComm.TxDelMsgBuf[2];
+          DPTxSpan[0].Len = (msglen-2);
+          AssembleTxPktSG(&DPTxSpan[0], 1, &DPComm, TRUE);
+#else
           AssembleTxPkt(&DPComm.TxDelMsgBuf[2], (msglen-2), &DPComm, TRUE);
+#endif
         }
         else
         {
@@ -1892,7 +2131,11 @@ void DispComm_Tx(void)
 
 uint8_t AssembleRxPkt(DMA_Stream_TypeDef *DMA_Stream, struct DISPCOMMVARS *port)
 {
+#ifdef ENABLE_CRC_SLICE
+  uint8_t rxchar;
+#else
   uint8_t rxchar, nxt_char;
+#endif
   uint16_t charcount, chars_left;
 
   // Capture the number of chars left in the buffer - need to take a snapshot in case this changes due to
@@ -1962,9 +2205,13 @@ uint8_t AssembleRxPkt(DMA_Stream_TypeDef *DMA_Stream, struct DISPCOMMVARS *port)
             if ((port->RxSegCode & 0xFE) != 0xFE)
             {
               port->RxMsg[port->RxMsgNdx] = (port->RxSegCode & 0x01);
+#ifdef ENABLE_CRC_SLICE
+              port->RxCRC = CRC16_BYTE(port->RxCRC, port->RxMsg[port->RxMsgNdx++]);   // Update CRC, inc index
+#else
               nxt_char = (port->RxCRC ^ port->RxMsg[port->RxMsgNdx++]);   // Update CRC and inc Rx msg index
               port->RxCRC = ((port->RxCRC ^ CRC_TABLE1[nxt_char]) >> 8)
                     + ((CRC_TABLE1[nxt_char] & 0x00FF) * 256);
+#endif
             }
             port->RxSegCode = rxchar;                           // Save the new segment code
             if (--port->RxSegOffset > 0)                        // Decrement the new segment offset.  If it
@@ -1978,9 +2225,13 @@ uint8_t AssembleRxPkt(DMA_Stream_TypeDef *DMA_Stream, struct DISPCOMMVARS *port)
           if (port->RxMsgNdx < DISPCOMM_RXBUFSIZE)          // If room in message buffer, store the data
           {                                                 //   char and increment the index / char count
             port->RxMsg[port->RxMsgNdx] = rxchar;
+#ifdef ENABLE_CRC_SLICE
+            port->RxCRC = CRC16_BYTE(port->RxCRC, port->RxMsg[port->RxMsgNdx++]);     // Update CRC, inc index
+#else
             nxt_char = (port->RxCRC ^ port->RxMsg[port->RxMsgNdx++]);     // Update CRC and inc Rx msg index
             port->RxCRC = ((port->RxCRC ^ CRC_TABLE1[nxt_char]) >> 8)
                     + ((CRC_TABLE1[nxt_char] & 0x00FF) * 256);
+#endif
           }
           if (--port->RxSegOffset == 0)                     // Decrement the new segment offset.  If it has
           {                                                 //   reached 0, the next char is a segment code,
@@ -2048,7 +2299,11 @@ uint8_t AssembleRxPkt(DMA_Stream_TypeDef *DMA_Stream, struct DISPCOMMVARS *port)
 
 uint8_t AssembleRxPkt1(DMA_Stream_TypeDef *DMA_Stream, struct DPCOMMRXVARS *port)
 {
+#ifdef ENABLE_CRC_SLICE
+  uint8_t rxchar;
+#else
   uint8_t rxchar, nxt_char;
+#endif
   uint16_t chars_left;
 
   // Capture the number of chars left in the buffer - need to take a snapshot in case this changes due to
@@ -2119,9 +2374,13 @@ uint8_t AssembleRxPkt1(DMA_Stream_TypeDef *DMA_Stream, struct DPCOMMRXVARS *port
             if ((port->RxSegCode & 0xFE) != 0xFE)
             {
               port->RxMsg[port->RxMsgNdx] = (port->RxSegCode & 0x01);
+#ifdef ENABLE_CRC_SLICE
+              port->RxCRC = CRC16_BYTE(port->RxCRC, port->RxMsg[port->RxMsgNdx++]);   // Update CRC, inc index
+#else
               nxt_char = (port->RxCRC ^ port->RxMsg[port->RxMsgNdx++]);   // Update CRC and inc Rx msg index
               port->RxCRC = ((port->RxCRC ^ CRC_TABLE1[nxt_char]) >> 8)
                     + ((CRC_TABLE1[nxt_char] & 0x00FF) * 256);
+#endif
             }
             port->RxSegCode = rxchar;                           // Save the new segment code
             if (--port->RxSegOffset > 0)                        // Decrement the new segment offset.  If it
@@ -2135,9 +2394,13 @@ uint8_t AssembleRxPkt1(DMA_Stream_TypeDef *DMA_Stream, struct DPCOMMRXVARS *port
           if (port->RxMsgNdx < DISPCOMM_61850RXBUFSIZE)     // If room in message buffer, store the data
           {                                                 //   char and increment the index / char count
             port->RxMsg[port->RxMsgNdx] = rxchar;
+#ifdef ENABLE_CRC_SLICE
+            port->RxCRC = CRC16_BYTE(port->RxCRC, port->RxMsg[port->RxMsgNdx++]);     // Update CRC, inc index
+#else
             nxt_char = (port->RxCRC ^ port->RxMsg[port->RxMsgNdx++]);     // Update CRC and inc Rx msg index
             port->RxCRC = ((port->RxCRC ^ CRC_TABLE1[nxt_char]) >> 8)
                     + ((CRC_TABLE1[nxt_char] & 0x00FF) * 256);
+#endif
           }
           if (--port->RxSegOffset == 0)                     // Decrement the new segment offset.  If it has
           {                                                 //   reached 0, the next char is a segment code,
@@ -2654,7 +2917,8 @@ void ProcWrSetpoints(uint16_t bufid)
 //
 //  CALLS:              Get_Setpoints(), Checksum8_16(), FRAM_Write(), ExtCapt_FRAM_Write(),
 //                      Frame_FRAM_Write(), FRAM_Stat_Write(), FRAM_Read(), Frame_FRAM_Read(),
-//                      Gen_Values(), Save_Critical_BrkConfig(), ContinousDPCommRxtoSPI2BITSHIFT()
+//                      Gen_Values(), Save_Critical_BrkConfig(), ContinousDPCommRxtoSPI2BITSHIFT(),
+//                      Apply_CalConstants()
 //
 //------------------------------------------------------------------------------------------------------------
 
@@ -3040,6 +3304,7 @@ void ProcWrFactoryConfig(uint16_t bufid)
         {
         }
         SPI1Flash.Req &= (uint32_t)(~S1F_CAL_WR);
+        Apply_CalConstants();                 // Compute the coefficients used to scale the samples
         ok = 1;                               // Set code to Ack/No write
         // *** DAH   ADD CODE TO COMBINE THE NEW BOARD CAL CONSTANTS WITH THE FRAME CAL CONSTANTS - PROBABLY PUT IN SUBROUTINE AND CALL IT
         // MAYBE ADD CODE TO CLEAR MAXLOOPTIME SINCE THIS IS LIKELY TO TAKE A LONG TIME TO EXECUTE - PROBABLY NEED TO DO THROUGH A FLAG AND CLEAR IN MAIN LOOP
@@ -3068,6 +3333,7 @@ void ProcWrFactoryConfig(uint16_t bufid)
         {
         }
         SPI1Flash.Req &= (uint32_t)(~S1F_CAL_WR);
+        Apply_CalConstants();                 // Compute the coefficients used to scale the samples
         ok = 1;                               // Set code to Ack/No write
         break;
       case 20:                          // ADC Voltage Constants floats
@@ -3102,6 +3368,7 @@ void ProcWrFactoryConfig(uint16_t bufid)
         {
         }
         SPI1Flash.Req &= (uint32_t)(~S1F_CAL_WR);
+        Apply_CalConstants();                 // Compute the coefficients used to scale the samples
         ok = 1;                               // Set code to Ack/No write
         break;
       case 21:                          // SG Constants
@@ -3138,6 +3405,7 @@ void ProcWrFactoryConfig(uint16_t bufid)
         {
         }
         SPI1Flash.Req &= (uint32_t)(~S1F_CAL_WR);
+        Apply_CalConstants();                 // Compute the coefficients used to scale the samples
         ok = 1;                               // Set code to Ack/No write
         break;
       case 35:                          // AFE Current Calibration Constants
@@ -3182,6 +3450,7 @@ void ProcWrFactoryConfig(uint16_t bufid)
         {
         }
         SPI1Flash.Req &= (uint32_t)(~S1F_CAL_WR);
+        Apply_CalConstants();                 // Compute the coefficients used to scale the samples
         ok = 1;                               // Set code to Ack/No write
         break;
       case 36:                          // Low Gain ADC Current Calibration Constants
@@ -3225,6 +3494,7 @@ void ProcWrFactoryConfig(uint16_t bufid)
         {
         }
         SPI1Flash.Req &= (uint32_t)(~S1F_CAL_WR);
+        Apply_CalConstants();                 // Compute the coefficients used to scale the samples
         ok = 1;                               // Set code to Ack/No write
         break;
       case 37:                          // High Gain ADC Current Calibration Constants
@@ -3263,6 +3533,7 @@ void ProcWrFactoryConfig(uint16_t bufid)
         {
         }
         SPI1Flash.Req &= (uint32_t)(~S1F_CAL_WR);
+        Apply_CalConstants();                 // Compute the coefficients used to scale the samples
         ok = 1;                               // Set code to Ack/No write
         break;
 //      case 40:                          // Neutral CT Cal Constants - Not supported
@@ -3381,7 +3652,7 @@ void ProcExActWAck(uint16_t actionid, uint8_t actiontype)
     uint32_t uval;
   } temp;
   struct INTERNAL_TIME temptime1, oldtime;
-  uint8_t tmp;
+  uint8_t tmp, evcode;
 
   // The message has already been checked for address, CRC, and command validity.
   //   The Execute Action Command is stored as follows:
@@ -3455,17 +3726,25 @@ void ProcExActWAck(uint16_t actionid, uint8_t actiontype)
       // Enter an event if Frame mismatch or frame bad
       if (i == 1)                     // Status = 1: Frame Mismatch
       {
+#ifdef ENABLE_EVENT_QUEUE
+        InsertNewEvent(STP_FRAME_MISMATCH);
+#else
         NewEventFIFO[NewEventInNdx].Code = STP_FRAME_MISMATCH;
         Get_InternalTime(&NewEventFIFO[NewEventInNdx].TS);
         NewEventFIFO[NewEventInNdx++].EID = EventMasterEID++;
         NewEventInNdx &= 0x0F;              // Note, FIFO size must be 16!!
+#endif
       }
       else if (i == 2)                // Status = 2: Frame bad
       {
+#ifdef ENABLE_EVENT_QUEUE
+        InsertNewEvent(STP_ERROR);
+#else
         NewEventFIFO[NewEventInNdx].Code = STP_ERROR;
         Get_InternalTime(&NewEventFIFO[NewEventInNdx].TS);
         NewEventFIFO[NewEventInNdx++].EID = EventMasterEID++;
         NewEventInNdx &= 0x0F;              // Note, FIFO size must be 16!!
+#endif
       }
       DPComm.AckNak = DP_ACK;         // Ack since command is valid
     }
@@ -3768,19 +4047,19 @@ void ProcExActWAck(uint16_t actionid, uint8_t actiontype)
       {
         if(Pswd_Rejection_Tmr)
         {
-          NewEventFIFO[NewEventInNdx].Code = WRONG_PWD_ENTERED;
+          evcode = WRONG_PWD_ENTERED;
           DPComm.AckNak = DP_NAK_BUFINVALID; 
         }
         //Correct password received
         else if(rcvd_pswd == admin_pswd)
         {
-          NewEventFIFO[NewEventInNdx].Code = ADMIN_PWD_ENTERED;
+          evcode = ADMIN_PWD_ENTERED;
           Admin_Verified_Tmr = COUNT_10_MIN; 
           Pswd_attempt = 0;         
         }
         else
         {
-          NewEventFIFO[NewEventInNdx].Code = WRONG_PWD_ENTERED;
+          evcode = WRONG_PWD_ENTERED;
           DPComm.AckNak = DP_NAK_BUFINVALID;           
           Admin_Verified_Tmr = 0;  
           Pswd_attempt++; 
@@ -3790,9 +4069,14 @@ void ProcExActWAck(uint16_t actionid, uint8_t actiontype)
             User_Verified_Tmr = 0;
           }                                                        
         }
+#ifdef ENABLE_EVENT_QUEUE
+        InsertNewEvent(evcode);
+#else
+        NewEventFIFO[NewEventInNdx].Code = evcode;
         Get_InternalTime(&NewEventFIFO[NewEventInNdx].TS);
         NewEventFIFO[NewEventInNdx++].EID = EventMasterEID++;
         NewEventInNdx &= 0x0F;                                      // Note, FIFO size must be 16!! 
+#endif
       }
       break;
       case 0x03:  //Create User
@@ -3837,10 +4121,14 @@ void ProcExActWAck(uint16_t actionid, uint8_t actiontype)
           Password.data.Cksum_not = (Password.data.Cksum ^ 0xFFFF);
           FRAM_Write( DEV_FRAM2, PSWD_ADDRESS , PASSWORD_SIZE>>1, (uint16_t *)(&Password.buf[0]) );
 
+#ifdef ENABLE_EVENT_QUEUE
+          InsertNewEvent(USER_PWD_CHANGED);
+#else
           NewEventFIFO[NewEventInNdx].Code = USER_PWD_CHANGED;
           Get_InternalTime(&NewEventFIFO[NewEventInNdx].TS);
           NewEventFIFO[NewEventInNdx++].EID = EventMasterEID++;
           NewEventInNdx &= 0x0F;                                      // Note, FIFO size must be 16!! 
+#endif
         }
         else
         {
@@ -3877,19 +4165,19 @@ void ProcExActWAck(uint16_t actionid, uint8_t actiontype)
       {
         if(Pswd_Rejection_Tmr)
         {
-          NewEventFIFO[NewEventInNdx].Code = WRONG_PWD_ENTERED;
+          evcode = WRONG_PWD_ENTERED;
           DPComm.AckNak = DP_NAK_BUFINVALID; 
         }
         //Correct password received and User Exists
         else if(rcvd_pswd == user_pswd && user_exists)
         {
-          NewEventFIFO[NewEventInNdx].Code = USER_PWD_ENTERED;
+          evcode = USER_PWD_ENTERED;
           User_Verified_Tmr = COUNT_10_MIN; 
           Pswd_attempt = 0;         
         }
         else
         {
-          NewEventFIFO[NewEventInNdx].Code = WRONG_PWD_ENTERED;
+          evcode = WRONG_PWD_ENTERED;
           DPComm.AckNak = DP_NAK_BUFINVALID;           
           User_Verified_Tmr = 0;  
           Pswd_attempt++; 
@@ -3899,9 +4187,14 @@ void ProcExActWAck(uint16_t actionid, uint8_t actiontype)
             Admin_Verified_Tmr = 0;
           }                                                        
         }
+#ifdef ENABLE_EVENT_QUEUE
+        InsertNewEvent(evcode);
+#else
+        NewEventFIFO[NewEventInNdx].Code = evcode;
         Get_InternalTime(&NewEventFIFO[NewEventInNdx].TS);
         NewEventFIFO[NewEventInNdx++].EID = EventMasterEID++;
         NewEventInNdx &= 0x0F;                                      // Note, FIFO size must be 16!! 
+#endif
       }
       break;
       case 0x09:  //Change Admin Password
@@ -3915,10 +4208,14 @@ void ProcExActWAck(uint16_t actionid, uint8_t actiontype)
           Password.data.Cksum_not = (Password.data.Cksum ^ 0xFFFF);
           FRAM_Write( DEV_FRAM2, PSWD_ADDRESS , PASSWORD_SIZE>>1, (uint16_t *)(&Password.buf[0]) );
 
+#ifdef ENABLE_EVENT_QUEUE
+          InsertNewEvent(ADMIN_PWD_CHANGED);
+#else
           NewEventFIFO[NewEventInNdx].Code = ADMIN_PWD_CHANGED;
           Get_InternalTime(&NewEventFIFO[NewEventInNdx].TS);
           NewEventFIFO[NewEventInNdx++].EID = EventMasterEID++;
           NewEventInNdx &= 0x0F;                                      // Note, FIFO size must be 16!! 
+#endif
         }
         else
         {
@@ -4523,9 +4820,15 @@ void ProcReadReqDel()
             //   The page and byte offsets are handled in SPI1_Flash_Manager(), as these change as we read
             //   the samples
             // i still has the index of the requested waveform
+#ifdef ENABLE_WF_CODEC
+            // If the waveforms are coded, this is the address of the capture.  The cycle and value are
+            //   located from the capture's index in SPI1_Flash_Manager() (see WfCodec_Read())
+            temp32 += ((i * WF_SIZE_IN_SECTORS) << 12);          // offset of the selected waveform log
+#else
             temp32 += ((i * WF_SIZE_IN_SECTORS) << 12)           // offset of the selected waveform log
                    + (WF_ADDRESS[DPComm.RxMsg[12]][0] << 8)      // starting page address of the cycle
                    + wfvaloffset;                                // offset of the selected value
+#endif
             // Save this address
             DPComm.RxMsgSav[0] = (uint8_t)temp32;
             DPComm.RxMsgSav[1] = (uint8_t)(temp32 >> 8);
@@ -4622,7 +4925,7 @@ void ProcReadReqDel()
 //
 //  ALTERS:             DPTxReqFlags, DP_Tmr4BufSel, DP_Tmr5BufSel
 //
-//  CALLS:              AssembleTxPkt(), AssembleAck()
+//  CALLS:              AssembleTxPkt(), AssembleAck(), BuildTxSpans(), AssembleTxPktSG()
 //
 //  EXECUTION TIME:     Measured on 220411 with Buffer 0: ~200usec   *** DAH MEASURED BEFORE HARMONICS WERE ADDED
 //
@@ -4631,6 +4934,9 @@ void ProcReadReqDel()
 void BuildRTDBufByTSlice(uint8_t timeslice, uint8_t cmnd, uint8_t addr)
 {
   uint8_t bufnum;
+#ifdef ENABLE_DP_TX_SG
+  uint8_t nspan;
+#endif
   uint16_t temp, i;
   void * const *objaddr_ptr;
 
@@ -4762,9 +5068,16 @@ void BuildRTDBufByTSlice(uint8_t timeslice, uint8_t cmnd, uint8_t addr)
       // Buffer 1 is unique.  It is divided into two buffers.  The first nine objects are 8 bytes long.
       //   These are processed first.  The remaining objects are 4 bytes long and are processed next, in the
       //   same manner as the other buffers.
+#ifdef ENABLE_DP_TX_SG
+      nspan = 0;
+#endif
       if (bufnum == 1)
       {
         objaddr_ptr = DPCOMM_RTD_ADDR_BUF1_A;
+#ifdef ENABLE_DP_TX_SG
+        // Add the objects to the span list.  8 bytes per object
+        nspan = BuildTxSpans(objaddr_ptr, 9, 8, nspan);
+#else
         // Insert the objects into the transmit buffer
         for (i=0; i<9; ++i)
         {
@@ -4772,6 +5085,7 @@ void BuildRTDBufByTSlice(uint8_t timeslice, uint8_t cmnd, uint8_t addr)
           // 8 bytes are inserted since each object is 8 bytes in length
           AssembleTxPkt((uint8_t *)(objaddr_ptr[i]), 8, &DPComm, FALSE);
         }
+#endif
         // Reinitialize temp to buffer 1B size.  It was buffer 1A + 1B.  Buffer 1A is finished, so temp
         //   must now be just for 1B
         temp = DPCOMMM_RTD_BUFSIZE[bufnum];
@@ -4788,6 +5102,12 @@ void BuildRTDBufByTSlice(uint8_t timeslice, uint8_t cmnd, uint8_t addr)
         objaddr_ptr = DPCOMM_RTD_ADDR_BUF0_TESTINJ;
       }
 
+#ifdef ENABLE_DP_TX_SG
+      // Add the objects to the span list (4 bytes per object), and insert all of the spans into the
+      //   transmit buffer with one subroutine call
+      nspan = BuildTxSpans(objaddr_ptr, (temp/4), 4, nspan);
+      AssembleTxPktSG(&DPTxSpan[0], nspan, &DPComm, TRUE);
+#else
       // Set temp to the number of data objects in the buffer - 1.  Each object is 4 bytes long, so divide
       //   by 4.  The last object is processed differently than the other objects (parameter LastSet in
       //   AssembleTxPkt is True instead of False)
@@ -4801,6 +5121,7 @@ void BuildRTDBufByTSlice(uint8_t timeslice, uint8_t cmnd, uint8_t addr)
       }
       // Last object - set parameter to True
       AssembleTxPkt((uint8_t *)(objaddr_ptr[i]), 4, &DPComm, TRUE);
+#endif
       break;
 
     case 17:                            // Buffer 17: External Diagnostics
@@ -4865,7 +5186,7 @@ void BuildRTDBufByTSlice(uint8_t timeslice, uint8_t cmnd, uint8_t addr)
 //
 //  ALTERS:             DPTxReqFlags
 //
-//  CALLS:              AssembleTxPkt(), AssembleAck()
+//  CALLS:              AssembleTxPkt(), AssembleAck(), BuildTxSpans(), AssembleTxPktSG()
 //
 //  EXECUTION TIME:     Measured on 220411 with Buffer 0: ~200usec   *** DAH MEASURED BEFORE HARMONICS WERE ADDED
 //
@@ -4874,6 +5195,9 @@ void BuildRTDBufByTSlice(uint8_t timeslice, uint8_t cmnd, uint8_t addr)
 void BuildRTDBufByBufnum(uint8_t bufnum, uint8_t cmnd, uint8_t addr)
 {
   uint16_t temp, i;
+#ifdef ENABLE_DP_TX_SG
+  uint8_t nspan;
+#endif
   void * const *objaddr_ptr;
 
   // Common code for all of the real-time data buffers
@@ -4948,9 +5272,16 @@ void BuildRTDBufByBufnum(uint8_t bufnum, uint8_t cmnd, uint8_t addr)
       // Buffer 1 is unique.  It is divided into two buffers.  The first nine objects are 8 bytes long.
       //   These are processed first.  The remaining objects are 4 bytes long and are processed next, in the
       //   same manner as the other buffers.
+#ifdef ENABLE_DP_TX_SG
+      nspan = 0;
+#endif
       if (bufnum == 1)
       {
         objaddr_ptr = DPCOMM_RTD_ADDR_BUF1_A;
+#ifdef ENABLE_DP_TX_SG
+        // Add the objects to the span list.  8 bytes per object
+        nspan = BuildTxSpans(objaddr_ptr, 9, 8, nspan);
+#else
         // Insert the objects into the transmit buffer
         for (i=0; i<9; ++i)
         {
@@ -4958,6 +5289,7 @@ void BuildRTDBufByBufnum(uint8_t bufnum, uint8_t cmnd, uint8_t addr)
           // 8 bytes are inserted since each object is 8 bytes in length
           AssembleTxPkt((uint8_t *)(objaddr_ptr[i]), 8, &DPComm, FALSE);
         }
+#endif
         // Reinitialize temp to buffer 1B size.  It was buffer 1A + 1B.  Buffer 1A is finished, so temp
         //   must now be just for 1B
         temp = DPCOMMM_RTD_BUFSIZE[bufnum];
@@ -4974,6 +5306,12 @@ void BuildRTDBufByBufnum(uint8_t bufnum, uint8_t cmnd, uint8_t addr)
         objaddr_ptr = DPCOMM_RTD_ADDR_BUF0_TESTINJ;
       }
 
+#ifdef ENABLE_DP_TX_SG
+      // Add the objects to the span list (4 bytes per object), and insert all of the spans into the
+      //   transmit buffer with one subroutine call
+      nspan = BuildTxSpans(objaddr_ptr, (temp/4), 4, nspan);
+      AssembleTxPktSG(&DPTxSpan[0], nspan, &DPComm, TRUE);
+#else
       // Set temp to the number of data objects in the buffer - 1.  Each object is 4 bytes long, so divide
       //   by 4.  The last object is processed differently than the other objects (parameter LastSet in
       //   AssembleTxPkt is True instead of False)
@@ -4987,6 +5325,7 @@ void BuildRTDBufByBufnum(uint8_t bufnum, uint8_t cmnd, uint8_t addr)
       }
       // Last object - set parameter to True
       AssembleTxPkt((uint8_t *)(objaddr_ptr[i]), 4, &DPComm, TRUE);
+#endif
       break;
 
     case 11:                            // Buffer 11: Aggregated Harmonics Ia thru In
@@ -5006,7 +5345,13 @@ void BuildRTDBufByBufnum(uint8_t bufnum, uint8_t cmnd, uint8_t addr)
       }
       // All of the harmonics objects are two bytes each and are in order, so insert them all with one
       //   subroutine call
+#ifdef ENABLE_DP_TX_SG
+      DPTxSpan[0].Ptr = (uint8_t *)(objaddr_ptr);
+      DPTxSpan[0].Len = temp;
+      AssembleTxPktSG(&DPTxSpan[0], 1, &DPComm, TRUE);
+#else
       AssembleTxPkt((uint8_t *)(objaddr_ptr), temp, &DPComm, TRUE);
+#endif
       break;
 
     case 17:                            // Buffer 17: External Diagnostics
@@ -105,6 +105,7 @@
 //    99    231019  BP  - Moved Secondary Injection definitions to here and TESTINJ_VARS structure
 //   149    240131  DAH - Renamed NUM_RTD_BUFFERS to NUM_RTD_TIMESLICES and set value to 7
 //                      - Added display processor port addresses
+//   170    240222  DAH - Added struct DP_TXSPAN and DP_TXSPAN_MAX for the scatter-gather packet encoder
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -142,6 +143,11 @@
 #define START_OF_PKT        0x00            // Start of Packet
 #define END_OF_PKT          0x01            // End of Packet
 
+// Max number of source spans for the scatter-gather packet encoder (AssembleTxPktSG(), ENABLE_DP_TX_SG
+//   defined).  This is enough for the largest RTD buffer (buffer 5 or 6, 72 objects) even if none of the
+//   objects are next to each other
+#define DP_TXSPAN_MAX       80
+
 // Command definitions
 #define DP_CMND_RDIMM       0x02
 #define DP_CMND_RDDEL       0x03
@@ -357,6 +363,13 @@ struct DPCOMMRXVARS
    uint8_t              RxBuf[DISPCOMM_61850RXBUFSIZE];
 };
 
+// Source span for the scatter-gather packet encoder: Len bytes starting at Ptr
+struct DP_TXSPAN
+{
+   uint8_t              *Ptr;
+   uint16_t             Len;
+};
+
 struct DISPCOMM61850VARS
 {
    uint8_t              TxState;
@@ -285,6 +285,38 @@
 //                        they have not, these values are set to 0.
 //  149     240131  DAH - Removed code that initializes the demand logging EID from Event_VarInit().  The
 //                        demand logging EID is initialized to the power-up EID in main
+//  166     240218  DAH - Added the RAM EID index (ENABLE_EID_INDEX defined)
+//                          - Added EventIndexInit(), EventIndexLookUp(), EventIndexPut(), EventEIDNdx[],
+//                            and EV_EID_START[]
+//                          - Moved the FRAM search from EventLookUp() into EventLookUpFRAM().
+//                            EventLookUp() searches the index for the logs that are indexed, and calls
+//                            EventLookUpFRAM() for the rest
+//                          - Revised Event_VarInit() to build the index, and EventSummaryWrite(),
+//                            EventTimeAdjWrite(), EventTripWrite(), EventTestTripWrite(), EventAlarmWrite(),
+//                            and EventExtCapWrite() to update it
+//                          - Revised EventSummaryRead() to get the previous and next EIDs from the index
+//  167     240219  DAH - Added the event queue (ENABLE_EVENT_QUEUE defined)
+//                          - IntEventBuf[] is now a lock-free multi-producer buffer.  InsertNewEvent() may be
+//                            called from the interrupts, and places the event in the buffer with
+//                            InsertIntEvent().  The events are moved into NewEventFIFO[] and given their EIDs
+//                            by MoveIntEvents(), in the foreground
+//                          - Added InsertEventEntry() to place an event in NewEventFIFO[].  Events are no
+//                            longer written when the FIFO is full; they are counted in EventQStats
+//                          - The FIFO and buffer sizes are set by NEWEVENT_FIFO_SIZE and INTEVENT_BUF_SIZE
+//                          - InsertNewEvent() no longer enables interrupts after reading the time stamp.  It
+//                            restores PRIMASK instead, so it may be called with interrupts disabled
+//                          - Revised Event_VarInit() and EventManager() accordingly
+//   168    240220  DAH - Added event log write combining.  When ENABLE_EVENT_WC is defined:
+//                          - EventSummaryWrite() stages the entry in EventWC instead of writing it to FRAM
+//                          - EventTripWrite() and EventAlarmWrite() write the EID and time stamp with one
+//                            write, and mark their index records instead of writing them
+//                          - Added EventWC_Commit() to write the staged Summary log entries with one write,
+//                            then the Master EID, then the marked index records with one write
+//                          - EventManager() processes consecutive Summary events in one call, and calls
+//                            EventWC_Commit() before it returns
+//                          - Revised Event_VarInit() to reset EventWC
+//   178    240301  DAH - Added include of Intr_def.h.  Intr_ext.h declares arrays of the structures in
+//                        Intr_def.h, so the module did not compile with gcc (host build)
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -414,6 +446,7 @@
 #include "Meter_def.h"
 #include "Events_def.h"
 #include "Demand_def.h"
+#include "Intr_def.h"
 #include "Setpnt_def.h"
 #include "FRAM_Flash_def.h"             // Must be preceded by Events_def.h and Setpnt_def.h!
 #include "DispComm_def.h"
@@ -452,6 +485,9 @@ void EventManager(void);
 void ClearEvents(void);
 void ClearFRAM(void);
 uint32_t InsertNewEvent(uint8_t EventType);
+#ifdef ENABLE_EVENT_QUEUE
+  uint8_t InsertEventEntry(uint16_t EventCode, uint32_t eid, struct INTERNAL_TIME *ts);
+#endif
 uint8_t GetEVInfo(uint8_t ev_type);
 //void EventWrite(uint8_t EventType);
 void EventSummaryWrite(void);
@@ -468,6 +504,10 @@ void EventSnapshotRead(uint8_t *bufinfoptr, uint16_t bid);
 
 int16_t BinarySearch(uint16_t FirstIndex, uint16_t LastIndex, uint32_t ValueSearched, uint8_t EventType);
 int16_t EventLookUp(uint32_t EIDLookUp, uint8_t EventType);
+#ifdef ENABLE_EID_INDEX
+  void EventIndexInit(void);
+  int16_t EventLookUpFRAM(uint32_t EIDLookUp, uint8_t EventType);
+#endif
 
 //      Local Function Prototypes (These functions are called only within this module)
 //
@@ -479,6 +519,17 @@ void ExtendedCapture(uint8_t TypeOfRecord);
 void ExtendedCaptureValues(uint8_t TypeOfRecord);
 void DisturbanceCapture(void);
 void DisturbanceCaptureValues(struct DIST_VALUES *psDistValues, uint8_t proc_ndx);
+#ifdef ENABLE_EID_INDEX
+  int16_t EventIndexLookUp(uint32_t EIDLookUp, uint8_t EventType);
+  void EventIndexPut(uint8_t EventType, uint16_t ndx, uint32_t eid);
+#endif
+#ifdef ENABLE_EVENT_QUEUE
+  void InsertIntEvent(uint8_t EventType);
+  void MoveIntEvents(void);
+#endif
+#ifdef ENABLE_EVENT_WC
+  void EventWC_Commit(void);
+#endif
 
 
 
@@ -491,12 +542,28 @@ void DisturbanceCaptureValues(struct DIST_VALUES *psDistValues, uint8_t proc_ndx
 //       These variables are used by other modules...
 //
 uint32_t EventMasterEID;
-struct NEWEVENTFIFO NewEventFIFO[16];      // Note: If the size (16) is changed, the code that handles
-                                           //   NewEventInNdx AND NewEventOutNdx must be changed accordingly
-struct NEWEVENTFIFO IntEventBuf[8];        // This also applies to this array
-uint8_t NewEventInNdx;
-uint8_t IntEventInNdx, IntEventOutNdx, IntEventBufFull;
+#ifdef ENABLE_EVENT_QUEUE
+  struct NEWEVENTFIFO NewEventFIFO[NEWEVENT_FIFO_SIZE];
+  struct INTEVENT_SLOT IntEventBuf[INTEVENT_BUF_SIZE];
+  struct EVENTQ_STATS EventQStats;
+  uint8_t NewEventInNdx;
+#else
+  struct NEWEVENTFIFO NewEventFIFO[16];     // Note: If the size (16) is changed, the code that handles
+                                            //   NewEventInNdx AND NewEventOutNdx must be changed accordingly
+  struct NEWEVENTFIFO IntEventBuf[8];       // This also applies to this array
+  uint8_t NewEventInNdx;
+  uint8_t IntEventInNdx, IntEventOutNdx, IntEventBufFull;
+#endif
 uint8_t Dist_GOOSE;
+#ifdef ENABLE_EVENT_WC
+  struct EVENT_WC EventWC;
+  #if ((EVWC_SUM_WORDS << 1) != SUMMARY_EVENT_SIZE)
+    #error EVWC_SUM_WORDS must be SUMMARY_EVENT_SIZE/2
+  #endif
+  #if (ALARM_LOG_ADD != (SUMMARY_LOG_ADD + ((EVWC_NUM_LOGS - 1) << 3)))
+    #error The Summary thru Alarm log index records must be next to each other in FRAM (see EventWC_Commit())
+  #endif
+#endif
 
 struct EV_SUM EV_Sum;
 struct EV_ADD EV_TimeAdj;
@@ -652,12 +719,39 @@ const uint16_t MAX_NUM_EVENTS[] =
 //
 uint8_t EventState, EV_WfState;
 uint8_t NewEventOutNdx;
+#ifdef ENABLE_EVENT_QUEUE
+  volatile uint32_t IntEventHead;           // Next IntEventBuf[] position to be claimed (interrupts)
+  uint32_t IntEventTail;                    // Next IntEventBuf[] position to be moved (foreground)
+#endif
+#ifdef ENABLE_EID_INDEX
+  uint32_t EventEIDNdx[EV_EID_SIZE];        // RAM copy of the log EIDs (see EventIndexInit())
+#endif
 
 //
 //------------------------------------------------------------------------------------------------------------
 //                   Local Constants used in this module
 //------------------------------------------------------------------------------------------------------------
 //
+#ifdef ENABLE_EID_INDEX
+// Start of each log's EIDs in EventEIDNdx[], or EV_EID_NONE if the log is not indexed.  The logs that are
+//   indexed are the FRAM logs whose entries begin with the EID
+//   Note, these must align with the EVENT_TYPES definitions in Events_def.h!!
+const uint16_t EV_EID_START[] =
+{
+    EV_EID_NONE,                        // Not used
+    EV_EID_SUMMARY,
+    EV_EID_TIMEADJ,
+    EV_EID_TRIP,
+    EV_EID_TESTTRIP,
+    EV_EID_ALARM,
+    EV_EID_NONE,                        // Demand logs are stored in Flash
+    EV_EID_NONE,                        // Trip waveforms are stored in Flash
+    EV_EID_NONE,                        // Alarm waveforms are stored in Flash
+    EV_EID_NONE,                        // Extended capture waveforms are stored in Flash
+    EV_EID_NONE,                        // Disturbance log entries end with the EID
+    EV_EID_EXTCAP
+};
+#endif
 //
 
 
@@ -680,19 +774,21 @@ uint8_t NewEventOutNdx;
 //  INPUTS:             None
 //
 //  OUTPUTS:            NewEventInNdx, NewEventOutNdx, IntEventInNdx, IntEventOutNdx, IntEventBufFull,
-//                      EventState, Alarm_WF_Capture.Req, Alarm_WF_Capture.InProg, Trip_WF_Capture.Req,
-//                      Trip_WF_Capture.InProg, Ext_WF_Capture.Req, Ext_WF_Capture.InProg, EventMasterEID,
-//                      EV_Dmnd.NextDmndAdd, EV_Dmnd.Num_Entries, SPI1Flash.Req (S1F_DMND_ERASE),
+//                      IntEventHead, IntEventTail, IntEventBuf[].Seq, EventQStats (if ENABLE_EVENT_QUEUE
+//                      is defined), EventState, Alarm_WF_Capture.Req, Alarm_WF_Capture.InProg,
+//                      Trip_WF_Capture.Req, Trip_WF_Capture.InProg, Ext_WF_Capture.Req,
+//                      Ext_WF_Capture.InProg, EventMasterEID, EV_Dmnd.NextDmndAdd, EV_Dmnd.Num_Entries,
+//                      SPI1Flash.Req (S1F_DMND_ERASE), EventWC (if ENABLE_EVENT_WC is defined),
 //                      SystemFlags, EV_Sum.NextEvntNdx, EV_Sum.Num_Events,
 //                      Alarm_WF_Capture.EV_Add.NextEvntNdx, Alarm_WF_Capture.EV_Add.Num_Events,
 //                      Trip_WF_Capture.EV_Add.NextEvntNdx, Trip_WF_Capture.EV_Add.Num_Events,
 //                      Chart_WF_Capture.EV_Add.NextEvntNdx, Chart_WF_Capture.EV_Add.Num_Events,
 //                      SPI1Flash.Req (S1F_ALARM_WF_ERASE + S1F_TRIP_WF_ERASE + S1F_EXT_WF_ERASE),
-//                      EV_WfState, Goose_Capture_Code
+//                      EV_WfState, Goose_Capture_Code, EventEIDNdx[] (if ENABLE_EID_INDEX is defined)
 //
 //  ALTERS:             None
 //
-//  CALLS:              FRAM_Read(), ReadEVAddress()
+//  CALLS:              FRAM_Read(), ReadEVAddress(), EventIndexInit() (if ENABLE_EID_INDEX is defined)
 //
 //  EXECUTION TIME:     Measured on 230323 (rev 0.70 code): 183usec
 //
@@ -708,9 +804,22 @@ void Event_VarInit(void)
   } uval;
   NewEventInNdx = 0;
   NewEventOutNdx = 0;
+#ifdef ENABLE_EVENT_QUEUE
+  IntEventHead = 0;
+  IntEventTail = 0;
+  for (t_nxt_index = 0; t_nxt_index < INTEVENT_BUF_SIZE; ++t_nxt_index)
+  {
+    IntEventBuf[t_nxt_index].Seq = t_nxt_index;     // Each slot is free for its first position
+  }
+  memset(&EventQStats, 0, sizeof(EventQStats));
+#else
   IntEventInNdx = 0;
   IntEventOutNdx = 0;
   IntEventBufFull = 0;
+#endif
+#ifdef ENABLE_EVENT_WC
+  memset(&EventWC, 0, sizeof(EventWC));
+#endif
   EventState = 0;
   EV_WfState = 0;
 
@@ -942,6 +1051,9 @@ void Event_VarInit(void)
 
   Dist_GOOSE = 0;
 
+#ifdef ENABLE_EID_INDEX
+  EventIndexInit();                     // Build the EID index now that the number of events are known
+#endif
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -1095,6 +1207,10 @@ uint8_t ReadEVAddress(uint8_t ev_type, uint16_t *ev_index, uint16_t *ev_num_even
 //                      If there is not, the entry is then made at the next open location.  When an event in
 //                      the Pending Event List has been communicated to the CAM and Display Modules, it is
 //                      removed from the list.
+//                      If ENABLE_EVENT_WC is defined, consecutive Summary events (up to EVWC_MAX_SUM) are
+//                      processed in one call.  Their Summary log entries are staged by EventSummaryWrite(),
+//                      and are written to FRAM by EventWC_Commit() before this subroutine returns, so the
+//                      logs in FRAM are always up to date when it is not running.
 //
 //  CAVEATS:            None
 //
@@ -1111,6 +1227,9 @@ uint8_t ReadEVAddress(uint8_t ev_type, uint16_t *ev_index, uint16_t *ev_num_even
 void EventManager(void)
 {
   uint8_t em_exit;
+#ifdef ENABLE_EVENT_WC
+  uint8_t em_num;
+#endif
   union dword_word
   {
     uint32_t u32[2];
@@ -1118,6 +1237,9 @@ void EventManager(void)
   } uval;
 
   em_exit = FALSE;
+#ifdef ENABLE_EVENT_WC
+  em_num = 0;
+#endif
 
   // Call InsertNewEvent() with no event to check for events that occurred during the interrupts.
   InsertNewEvent(NO_EVENT);
@@ -1405,10 +1527,21 @@ void EventManager(void)
 
       case EM_FINISH:                   // Common Code to Finish Processing an Event
         // Update the output index for the events FIFO
+#ifdef ENABLE_EVENT_QUEUE
+        NewEventOutNdx = ((NewEventOutNdx + 1) & NEWEVENT_FIFO_MASK);
+#else
         ++NewEventOutNdx;
         NewEventOutNdx &= 0x0F;                 // *** DAH THIS RELIES ON NEWEVENTFIFO[] SIZE = 16  CHANGE WHEN FINALIZED
+#endif
         EventState = EM_IDLE;
+#ifdef ENABLE_EVENT_WC
+        // If the next event is a Summary event, process it in this call too, so the Summary log entries of a
+        //   burst of events are written together.  Other events are left for the next call, as before
+        em_exit = ( (++em_num >= EVWC_MAX_SUM) || (NewEventInNdx == NewEventOutNdx)
+                 || (NewEventFIFO[NewEventOutNdx].Code > SUMMARY_END) );
+#else
         em_exit = TRUE;
+#endif
         break;
         
       default:
@@ -1418,6 +1551,12 @@ void EventManager(void)
     
     }
   }
+#ifdef ENABLE_EVENT_WC
+  if ( (EventWC.NumSum > 0) || (EventWC.Dirty != 0) )
+  {
+    EventWC_Commit();                   // Write the staged entries and index records before returning
+  }
+#endif
 
   // Event waveform processing
   // This is separate from the other event processing, so that while the waveform is being captured, other
@@ -1699,6 +1838,12 @@ void ClearEvents(void)
 //                      After the interrupt events have been stored, the subroutine stores the event that is
 //                      passed in through the parameters.
 //                      Note, events are stored only if there is room in the New Event FIFO.
+//                      If ENABLE_EVENT_QUEUE is defined, this subroutine may also be called from the
+//                      interrupts.  In that case, the event is placed in the interrupt event buffer by
+//                      InsertIntEvent(), and is given its EID when it is moved into the New Event FIFO.  In
+//                      the foreground, the interrupt events are moved by MoveIntEvents() before the new
+//                      event is stored, so the EIDs are in the order of the events.  Events that do not fit
+//                      are counted in EventQStats instead of overwriting unprocessed events.
 //
 //  CAVEATS:            1) It is assumed the New Event FIFO is large enough that it won't be full, although
 //                         it is always checked as a precaution.
@@ -1706,6 +1851,8 @@ void ClearEvents(void)
 //                         even if there are no pending foreground events, to ensure that interrupt events
 //                         are processed.  If there are no pending events, NO_EVENT is passed as the event
 //                         type.
+//                      3) If ENABLE_EVENT_QUEUE is defined, the returned EID is 0 if this subroutine was
+//                         called from an interrupt or the event was not stored
 //
 //  INPUTS:             EventType - the event type
 //                      SystemFlags (EVENT_FF_FULL), IntEventInNdx, IntEventOutNdx, IntEventBufFull,
@@ -1714,14 +1861,42 @@ void ClearEvents(void)
 //  OUTPUTS:            Returns the EID of the inserted event
 //                      NewEventFIFO[].xxx
 //
-//  ALTERS:             SystemFlags (EVENT_FF_FULL), NewEventInNdx, IntEventOutNdx
+//  ALTERS:             SystemFlags (EVENT_FF_FULL), NewEventInNdx, IntEventOutNdx, EventMasterEID
 // 
-//  CALLS:              Get_DateTime()
+//  CALLS:              Get_InternalTime(), InsertIntEvent(), MoveIntEvents(), InsertEventEntry(),
+//                      __get_IPSR(), __get_PRIMASK(), __set_PRIMASK()
 // 
 //------------------------------------------------------------------------------------------------------------
 
 uint32_t InsertNewEvent(uint8_t EventType)
 {
+#ifdef ENABLE_EVENT_QUEUE
+  struct INTERNAL_TIME presenttime;
+  uint32_t primask, ret_val;
+
+  ret_val = 0;
+  if (__get_IPSR() != 0)                // If called from an interrupt, just place the event in the buffer
+  {
+    InsertIntEvent(EventType);
+  }
+  else
+  {
+    MoveIntEvents();                    // Move the interrupt events first - they occurred before this one
+    if ( (EventType > NO_EVENT) && (EventType <= MAXEVENTCODE) )
+    {
+      primask = __get_PRIMASK();        // Get the present time for the time stamp.  Restore the interrupt
+      __disable_irq();                  //   state instead of enabling interrupts, so this may be called
+      Get_InternalTime(&presenttime);   //   with interrupts disabled
+      __set_PRIMASK(primask);
+      if (InsertEventEntry(EventType, EventMasterEID, &presenttime))
+      {
+        ret_val = EventMasterEID++;
+      }
+    }
+  }
+  return (ret_val);
+
+#else
 //  struct INTERNAL_TIME presenttime;
   uint32_t ret_val;
 
@@ -1762,6 +1937,7 @@ uint32_t InsertNewEvent(uint8_t EventType)
     }
   }
   return (ret_val);
+#endif
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -1770,6 +1946,218 @@ uint32_t InsertNewEvent(uint8_t EventType)
 
 
 
+#ifdef ENABLE_EVENT_QUEUE
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       InsertEventEntry()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Insert an Entry into the New Event FIFO
+//
+//  MECHANICS:          This subroutine places an event, with its EID and time stamp, into the New Event FIFO
+//                      if there is room.  If the FIFO is full, the event is counted in
+//                      EventQStats.FifoDrops.  The unprocessed events are never overwritten.
+//                      This is used by InsertNewEvent() and MoveIntEvents(), and directly by code that
+//                      assigns the EID itself (for example, the demand logging events).
+//
+//  CAVEATS:            Only included if ENABLE_EVENT_QUEUE is defined.
+//                      Call only from the foreground.  The New Event FIFO is not protected from the
+//                      interrupts - they use the interrupt event buffer instead.
+//                      The FIFO holds NEWEVENT_FIFO_SIZE - 1 events, so that the full and empty states are
+//                      different
+//
+//  INPUTS:             EventCode - the event code
+//                      eid - the event's EID
+//                      ts - pointer to the event's time stamp
+//                      NewEventOutNdx
+//
+//  OUTPUTS:            Returns TRUE if the event was inserted, FALSE if the FIFO was full
+//                      NewEventFIFO[].xxx, EventQStats.FifoDrops, EventQStats.FifoHiWater
+//
+//  ALTERS:             NewEventInNdx
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t InsertEventEntry(uint16_t EventCode, uint32_t eid, struct INTERNAL_TIME *ts)
+{
+  uint8_t waiting;
+
+  if ( ((NewEventInNdx + 1) & NEWEVENT_FIFO_MASK) == NewEventOutNdx )
+  {
+    ++EventQStats.FifoDrops;
+    return (FALSE);
+  }
+  NewEventFIFO[NewEventInNdx].Code = EventCode;
+  NewEventFIFO[NewEventInNdx].TS.Time_secs = ts->Time_secs;
+  NewEventFIFO[NewEventInNdx].TS.Time_nsec = ts->Time_nsec;
+  NewEventFIFO[NewEventInNdx].EID = eid;
+  NewEventInNdx = ((NewEventInNdx + 1) & NEWEVENT_FIFO_MASK);
+
+  waiting = ((NewEventInNdx - NewEventOutNdx) & NEWEVENT_FIFO_MASK);
+  if (waiting > EventQStats.FifoHiWater)
+  {
+    EventQStats.FifoHiWater = waiting;
+  }
+  return (TRUE);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         InsertEventEntry()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       InsertIntEvent()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Insert an Interrupt Event into the Interrupt Event Buffer
+//
+//  MECHANICS:          This subroutine places an event that was detected in an interrupt (or by code that may
+//                      be interrupted by another event source) into the interrupt event buffer, without
+//                      disabling interrupts:
+//                        - The slot at the head position is claimed by advancing IntEventHead with an
+//                          exclusive load and store (LDREX/STREX).  If the store fails, this code was
+//                          interrupted by another event source, so the claim is retried with the new head
+//                        - A slot is free when its sequence number equals the position that claims it.  If
+//                          the sequence number is less, MoveIntEvents() has not freed the slot yet, so the
+//                          buffer is full.  The event is counted in EventQStats.IntDrops and discarded
+//                        - The code and time stamp are written, then the sequence number is set to the
+//                          position + 1 to show MoveIntEvents() that the slot holds an event
+//                      The EID is assigned when the event is moved into the New Event FIFO.
+//                      In the host build, the claim and the drop count use the gcc atomic builtins, because
+//                      the host stress test posts events from a second thread.
+//
+//  CAVEATS:            Only included if ENABLE_EVENT_QUEUE is defined.
+//                      Interrupt events do not have to be called from the same priority level.
+//
+//  INPUTS:             EventType - the event type
+//
+//  OUTPUTS:            IntEventBuf[].xxx, EventQStats.IntDrops
+//
+//  ALTERS:             IntEventHead
+//
+//  CALLS:              Get_InternalTime(), __LDREXW(), __STREXW(), __CLREX(), __DMB()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void InsertIntEvent(uint8_t EventType)
+{
+  struct INTEVENT_SLOT *slot;
+  uint32_t pos, full;
+#ifndef HOST_BUILD
+  uint32_t drops;
+#endif
+
+  if ( (EventType <= NO_EVENT) || (EventType > MAXEVENTCODE) )
+  {
+    return;
+  }
+
+  // Claim the slot at the head of the buffer
+#ifdef HOST_BUILD
+  pos = __atomic_load_n(&IntEventHead, __ATOMIC_RELAXED);
+  do
+  {
+    full = ((int32_t)(EVQ_LOAD(&IntEventBuf[pos & INTEVENT_BUF_MASK].Seq) - pos) < 0);
+  } while ( (!full) && (!__atomic_compare_exchange_n(&IntEventHead, &pos, (pos + 1), 0, __ATOMIC_ACQ_REL,
+                                                                                        __ATOMIC_RELAXED)) );
+  if (full)
+  {
+    __atomic_fetch_add(&EventQStats.IntDrops, 1, __ATOMIC_RELAXED);
+    return;
+  }
+#else
+  do
+  {
+    pos = __LDREXW(&IntEventHead);
+    full = ((int32_t)(IntEventBuf[pos & INTEVENT_BUF_MASK].Seq - pos) < 0);
+  } while ( (!full) && (__STREXW((pos + 1), &IntEventHead) != 0) );
+  if (full)
+  {
+    __CLREX();
+    do
+    {
+      drops = __LDREXW((volatile uint32_t *)(&EventQStats.IntDrops));
+    } while (__STREXW((drops + 1), (volatile uint32_t *)(&EventQStats.IntDrops)) != 0);
+    return;
+  }
+#endif
+
+  // Fill in the slot, then mark it as holding an event
+  slot = &IntEventBuf[pos & INTEVENT_BUF_MASK];
+  slot->Code = EventType;
+  Get_InternalTime(&slot->TS);
+  EVQ_STORE(&slot->Seq, (pos + 1));
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         InsertIntEvent()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       MoveIntEvents()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Move the Interrupt Events into the New Event FIFO
+//
+//  MECHANICS:          This subroutine moves the events in the interrupt event buffer into the New Event
+//                      FIFO, oldest first, and gives each one the next EID.  It stops at the first slot that
+//                      does not hold an event (its sequence number is not the position + 1), or when the New
+//                      Event FIFO is full.  The events that are not moved stay in the buffer for the next
+//                      call - they are not lost.  Each slot that is moved is freed for the next pass around
+//                      the buffer by setting its sequence number to the position + INTEVENT_BUF_SIZE.
+//
+//  CAVEATS:            Only included if ENABLE_EVENT_QUEUE is defined.
+//                      Call only from the foreground (this is the only consumer of the buffer).
+//
+//  INPUTS:             IntEventHead, IntEventBuf[].xxx, NewEventInNdx, NewEventOutNdx
+//
+//  OUTPUTS:            IntEventBuf[].Seq, EventQStats.IntHiWater
+//
+//  ALTERS:             IntEventTail, EventMasterEID
+//
+//  CALLS:              InsertEventEntry(), __DMB()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void MoveIntEvents(void)
+{
+  struct INTEVENT_SLOT *slot;
+  uint32_t waiting;
+
+  waiting = EVQ_LOAD(&IntEventHead) - IntEventTail;
+  if (waiting > EventQStats.IntHiWater)
+  {
+    EventQStats.IntHiWater = (uint8_t)waiting;
+  }
+
+  slot = &IntEventBuf[IntEventTail & INTEVENT_BUF_MASK];
+  while ( (((NewEventInNdx + 1) & NEWEVENT_FIFO_MASK) != NewEventOutNdx)
+       && (EVQ_LOAD(&slot->Seq) == (IntEventTail + 1)) )
+  {
+    __DMB();                                        // Read the event after its sequence number
+    InsertEventEntry(slot->Code, EventMasterEID++, &slot->TS);
+    EVQ_STORE(&slot->Seq, (IntEventTail + INTEVENT_BUF_SIZE));
+    ++IntEventTail;
+    slot = &IntEventBuf[IntEventTail & INTEVENT_BUF_MASK];
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         MoveIntEvents()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_EVENT_QUEUE
+
+
+
 
 //------------------------------------------------------------------------------------------------------------
 //             START OF FUNCTION       GetEVInfo()
@@ -1979,14 +2367,19 @@ uint8_t GetEVInfo(uint8_t ev_type)
 //  FUNCTION:           Event Summary Write
 //
 //  MECHANICS:          Event Manager
+//                      If ENABLE_EVENT_WC is defined, the entry is not written to FRAM here.  It is staged in
+//                      EventWC.Sum[], and the Summary log index record is marked to be rewritten.  The entry
+//                      and the index record are written by EventWC_Commit().  If the staging buffer is full,
+//                      or the entry does not follow the staged entries in FRAM (the log has rolled over), the
+//                      staged entries are committed first.
 //
 //  INPUTS:             None
 // 
 //  OUTPUTS:            EventMasterEID
 //
-//  ALTERS:             None
+//  ALTERS:             EventWC (if ENABLE_EVENT_WC is defined)
 // 
-//  CALLS:              Fram_Write()
+//  CALLS:              Fram_Write(), EventWC_Commit()
 // 
 //  EXECUTION TIME:     Measured on 230519 (rev 40 code): 72usec (with interrupts disabled)
 // 
@@ -1994,6 +2387,36 @@ uint8_t GetEVInfo(uint8_t ev_type)
 
 void EventSummaryWrite()
 {
+#ifdef ENABLE_EVENT_WC
+  uint16_t *wptr;
+
+  if ( (EventWC.NumSum >= EVWC_MAX_SUM)
+    || ((EventWC.NumSum > 0) && ((EventWC.SumFirst + EventWC.NumSum) != EV_Sum.NextEvntNdx)) )
+  {
+    EventWC_Commit();
+  }
+  if (EventWC.NumSum == 0)
+  {
+    EventWC.SumFirst = EV_Sum.NextEvntNdx;
+  }
+  // Stage the entry as it is stored in FRAM: EID, time stamp, code
+  wptr = &EventWC.Sum[EventWC.NumSum * EVWC_SUM_WORDS];
+  memcpy(&wptr[0], &NewEventFIFO[NewEventOutNdx].EID, 4);
+  memcpy(&wptr[2], &NewEventFIFO[NewEventOutNdx].TS, 8);
+  wptr[6] = NewEventFIFO[NewEventOutNdx].Code;
+  ++EventWC.NumSum;
+#ifdef ENABLE_EID_INDEX
+  EventIndexPut(EV_TYPE_SUMMARY, EV_Sum.NextEvntNdx, NewEventFIFO[NewEventOutNdx].EID);
+#endif
+
+  if (++EV_Sum.NextEvntNdx >= SUMMARY_NUM_LOGS)
+  {
+    EV_Sum.NextEvntNdx = 0;
+  }
+  EV_Sum.Num_Events = ((EV_Sum.Num_Events < SUMMARY_NUM_LOGS) ? (EV_Sum.Num_Events + 1) : SUMMARY_NUM_LOGS);
+  EventWC.Dirty |= EVWC_DIRTY(EV_TYPE_SUMMARY);
+
+#else
   union dword_word
   {
     uint32_t u32[2];
@@ -2010,6 +2433,9 @@ void EventSummaryWrite()
   offset += sizeof(NewEventFIFO[NewEventOutNdx].TS);
   FRAM_Write(DEV_FRAM2, (SUMMARY_LOG_START + (EV_Sum.NextEvntNdx * SUMMARY_EVENT_SIZE) + offset),
         (sizeof(NewEventFIFO[NewEventOutNdx].Code) >> 1), (uint16_t *)(&NewEventFIFO[NewEventOutNdx].Code));
+#ifdef ENABLE_EID_INDEX
+  EventIndexPut(EV_TYPE_SUMMARY, EV_Sum.NextEvntNdx, NewEventFIFO[NewEventOutNdx].EID);
+#endif
 
   if (++EV_Sum.NextEvntNdx >= SUMMARY_NUM_LOGS)
   {
@@ -2029,6 +2455,7 @@ void EventSummaryWrite()
   uval.u32[1] = ~EventMasterEID;
   FRAM_Write(DEV_FRAM2, MASTER_EID, 4, (uint16_t *)(&uval.u32[0]));
   FRAM_Write(DEV_FRAM2, MASTER_EID+SECONDBLK_OFFSET, 4, (uint16_t *)(&uval.u32[0]));
+#endif
 
 }
 
@@ -2038,6 +2465,110 @@ void EventSummaryWrite()
 
 
 
+#ifdef ENABLE_EVENT_WC
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       EventWC_Commit()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Commit the Combined Event Log Writes
+//
+//  MECHANICS:          This subroutine writes the event log data that has been staged or marked by
+//                      EventSummaryWrite(), EventTripWrite(), and EventAlarmWrite().  The writes are done in
+//                      the following order, so that if power is lost part way through, the logs are still
+//                      consistent at the next power up:
+//                        1) The staged Summary log entries, with one write.  They are not part of the log
+//                           until its index record is written
+//                        2) The Master EID and its copy.  These are written before the index records so that
+//                           an EID that is in a log is never issued again after a power up.  If power is lost
+//                           before the index records are written, the EIDs of the lost entries are skipped
+//                        3) The marked index records (Summary, Time Adjustment, Trip, Test Trip, Alarm), with
+//                           one write.  The records are next to each other in FRAM, so the write covers the
+//                           records from the first marked one to the last marked one.  The records in between
+//                           are rewritten with their present values.  This is the commit - each record has
+//                           its complement, so a record that is only partly written is detected at power up
+//                      This replaces six FRAM writes for each Summary event (three for the entry, one for the
+//                      index record, and two for the Master EID) with four writes for up to EVWC_MAX_SUM
+//                      events.
+//
+//  CAVEATS:            Only included if ENABLE_EVENT_WC is defined.
+//                      Call only from the foreground.  EventManager() calls this before it returns, so the
+//                      logs in FRAM are up to date whenever it is not running.
+//
+//  INPUTS:             EventWC.xx, EventMasterEID, EV_Sum, EV_TimeAdj, EV_Trip, EV_TestTrip, EV_Alarm
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             EventWC.NumSum, EventWC.Dirty, EventWC.Commits, EventWC.Entries
+//
+//  CALLS:              FRAM_Write()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void EventWC_Commit(void)
+{
+  uint16_t rec[EVWC_NUM_LOGS << 2];
+  uint32_t eid[2];
+  uint8_t first, last, i;
+
+  // 1) Staged Summary log entries
+  if (EventWC.NumSum > 0)
+  {
+    FRAM_Write(DEV_FRAM2, (SUMMARY_LOG_START + (EventWC.SumFirst * SUMMARY_EVENT_SIZE)),
+                                    (EventWC.NumSum * EVWC_SUM_WORDS), &EventWC.Sum[0]);
+    EventWC.Entries += EventWC.NumSum;
+    EventWC.NumSum = 0;
+  }
+  if (EventWC.Dirty == 0)
+  {
+    return;
+  }
+
+  // 2) Master EID
+  eid[0] = EventMasterEID;
+  eid[1] = ~EventMasterEID;
+  FRAM_Write(DEV_FRAM2, MASTER_EID, 4, (uint16_t *)(&eid[0]));
+  FRAM_Write(DEV_FRAM2, MASTER_EID+SECONDBLK_OFFSET, 4, (uint16_t *)(&eid[0]));
+
+  // 3) Index records, from the first marked one to the last marked one
+  first = 0;
+  while (!(EventWC.Dirty & (1 << first)))
+  {
+    ++first;
+  }
+  last = EVWC_NUM_LOGS - 1;
+  while (!(EventWC.Dirty & (1 << last)))
+  {
+    --last;
+  }
+  for (i = first; i <= last; ++i)
+  {
+    if (i == 0)                         // Summary log has uint16_t values
+    {
+      rec[(i << 2) + 0] = EV_Sum.NextEvntNdx;
+      rec[(i << 2) + 1] = EV_Sum.Num_Events;
+    }
+    else
+    {
+      rec[(i << 2) + 0] = RAM_EV_ADD[EV_TYPE_SUMMARY + i]->NextEvntNdx;
+      rec[(i << 2) + 1] = RAM_EV_ADD[EV_TYPE_SUMMARY + i]->Num_Events;
+    }
+    rec[(i << 2) + 2] = (rec[(i << 2) + 0] ^ 0xFFFF);
+    rec[(i << 2) + 3] = (rec[(i << 2) + 1] ^ 0xFFFF);
+  }
+  FRAM_Write(DEV_FRAM2, (SUMMARY_LOG_ADD + (first << 3)), ((last - first + 1) << 2), &rec[first << 2]);
+  EventWC.Dirty = 0;
+  ++EventWC.Commits;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         EventWC_Commit()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_EVENT_WC
+
+
+
 
 //------------------------------------------------------------------------------------------------------------
 //             START OF FUNCTION       EventSummaryRead()
@@ -2073,7 +2604,7 @@ void EventSummaryWrite()
 //
 //  ALTERS:             None
 // 
-//  CALLS:              FRAM_Read()
+//  CALLS:              FRAM_Read(), EventLookUp(), memcpy() (if ENABLE_EID_INDEX is defined)
 // 
 //------------------------------------------------------------------------------------------------------------
 
@@ -2219,8 +2750,13 @@ void EventSummaryRead(uint16_t msglen, uint8_t *bufinfoptr, uint8_t *num)
   }
 
   // Get the previous and next EIDs 
+#ifdef ENABLE_EID_INDEX
+  memcpy(&SPI2_buf[0], &EventEIDNdx[EV_EID_START[EV_TYPE_SUMMARY] + prev_ndx], 4);
+  memcpy(&SPI2_buf[4], &EventEIDNdx[EV_EID_START[EV_TYPE_SUMMARY] + next_ndx], 4);
+#else
   FRAM_Read( (SUMMARY_LOG_START + (prev_ndx * SUMMARY_EVENT_SIZE)), 2, (uint16_t *)(&SPI2_buf[0]) );
   FRAM_Read( (SUMMARY_LOG_START + (next_ndx * SUMMARY_EVENT_SIZE)), 2, (uint16_t *)(&SPI2_buf[4]) );
+#endif
 
   // Retrieve the events
   FRAM_Read((SUMMARY_LOG_START + (start_ndx * SUMMARY_EVENT_SIZE)),
@@ -2580,6 +3116,9 @@ void EventTimeAdjWrite()
   offset += sizeof(NewEventFIFO[NewEventOutNdx].TS);
   FRAM_Write(DEV_FRAM2, (TIMEADJ_LOG_START + (EV_TimeAdj.NextEvntNdx * TIMEADJ_EVENT_SIZE) + offset),
         (sizeof(TimeAdjust) >> 1), (uint16_t *)&TimeAdjust);
+#ifdef ENABLE_EID_INDEX
+  EventIndexPut(EV_TYPE_TIMEADJ, EV_TimeAdj.NextEvntNdx, NewEventFIFO[NewEventOutNdx].EID);
+#endif
 
   if (++EV_TimeAdj.NextEvntNdx >= TIMEADJ_NUM_LOGS)
   {
@@ -2615,12 +3154,14 @@ void EventTimeAdjWrite()
 //  FUNCTION:           Event Trip Write
 //
 //  MECHANICS:          Event Manager
+//                      If ENABLE_EVENT_WC is defined, the EID and time stamp are written with one write, and
+//                      the index record and Master EID are written later by EventWC_Commit()
 //
 //  INPUTS:             None
 // 
 //  OUTPUTS:            EventMasterEID
 //
-//  ALTERS:             None
+//  ALTERS:             EventWC.Dirty (if ENABLE_EVENT_WC is defined)
 // 
 //  CALLS:              Fram_Write()
 // 
@@ -2628,6 +3169,16 @@ void EventTimeAdjWrite()
 
 void EventTripWrite()
 {
+#ifdef ENABLE_EVENT_WC
+  uint16_t hdr[6];
+
+  // Write the EID and time stamp together, then the snapshot
+  memcpy(&hdr[0], &NewEventFIFO[NewEventOutNdx].EID, 4);
+  memcpy(&hdr[2], &NewEventFIFO[NewEventOutNdx].TS, 8);
+  FRAM_Write(DEV_FRAM2, (TRIP_LOG_START + (EV_Trip.NextEvntNdx * SNAPSHOTS_EVENT_SIZE)), 6, &hdr[0]);
+  FRAM_Write(DEV_FRAM2, (TRIP_LOG_START + (EV_Trip.NextEvntNdx * SNAPSHOTS_EVENT_SIZE) + 12),
+        (SNAPSHOT_SIZE >> 1), (uint16_t *)(&SnapshotMeteredValues));
+#else
   union dword_word
   {
     uint32_t u32[2];
@@ -2644,13 +3195,20 @@ void EventTripWrite()
   offset += sizeof(NewEventFIFO[NewEventOutNdx].TS);
   FRAM_Write(DEV_FRAM2, (TRIP_LOG_START + (EV_Trip.NextEvntNdx * SNAPSHOTS_EVENT_SIZE) + offset),
         (SNAPSHOT_SIZE >> 1), (uint16_t *)(&SnapshotMeteredValues));
+#endif
+#ifdef ENABLE_EID_INDEX
+  EventIndexPut(EV_TYPE_TRIP, EV_Trip.NextEvntNdx, NewEventFIFO[NewEventOutNdx].EID);
+#endif
 
   if (++EV_Trip.NextEvntNdx >= TRIP_NUM_LOGS)
   {
     EV_Trip.NextEvntNdx = 0;
   }
   EV_Trip.Num_Events = ((EV_Trip.Num_Events < TRIP_NUM_LOGS) ? (EV_Trip.Num_Events + 1) : TRIP_NUM_LOGS);
-  
+
+#ifdef ENABLE_EVENT_WC
+  EventWC.Dirty |= EVWC_DIRTY(EV_TYPE_TRIP);    // The index record is written by EventWC_Commit()
+#else
   // Store index and number of events in FRAM
   uval.u16[0] = EV_Trip.NextEvntNdx;
   uval.u16[1] = EV_Trip.Num_Events;
@@ -2663,6 +3221,7 @@ void EventTripWrite()
   uval.u32[1] = ~EventMasterEID;
   FRAM_Write(DEV_FRAM2, MASTER_EID, 4, (uint16_t *)(&uval.u32[0]));
   FRAM_Write(DEV_FRAM2, MASTER_EID+SECONDBLK_OFFSET, 4, (uint16_t *)(&uval.u32[0]));
+#endif
 
 }
 
@@ -2703,6 +3262,9 @@ void EventTestTripWrite()
                 (uint16_t *)(&NewEventFIFO[NewEventOutNdx].TS));
   FRAM_Write(DEV_FRAM2, (TESTTRIP_LOG_START + (EV_TestTrip.NextEvntNdx * SNAPSHOTS_EVENT_SIZE) + (SNAPSHOT_SIZE  >> 1)),
                 (SNAPSHOT_SIZE  >> 1), (uint16_t *)&SnapshotMeteredValues);
+#ifdef ENABLE_EID_INDEX
+  EventIndexPut(EV_TYPE_TESTTRIP, EV_TestTrip.NextEvntNdx, NewEventFIFO[NewEventOutNdx].EID);
+#endif
 
   if (++EV_TestTrip.NextEvntNdx >= TESTTRIP_NUM_LOGS)
   {
@@ -2739,12 +3301,14 @@ void EventTestTripWrite()
 //  FUNCTION:           Event Alarm Write
 //
 //  MECHANICS:          Event Manager
+//                      If ENABLE_EVENT_WC is defined, the EID and time stamp are written with one write, and
+//                      the index record and Master EID are written later by EventWC_Commit()
 //
 //  INPUTS:             None
 // 
 //  OUTPUTS:            EventMasterEID
 //
-//  ALTERS:             None
+//  ALTERS:             EventWC.Dirty (if ENABLE_EVENT_WC is defined)
 // 
 //  CALLS:              Fram_Write()
 // 
@@ -2752,6 +3316,14 @@ void EventTestTripWrite()
 
 void EventAlarmWrite()
 {
+#ifdef ENABLE_EVENT_WC
+  uint16_t hdr[6];
+
+  // Write the EID and time stamp together, then the snapshot
+  memcpy(&hdr[0], &NewEventFIFO[NewEventOutNdx].EID, 4);
+  memcpy(&hdr[2], &NewEventFIFO[NewEventOutNdx].TS, 8);
+  FRAM_Write(DEV_FRAM2, (ALARM_LOG_START + (EV_Alarm.NextEvntNdx * SNAPSHOTS_EVENT_SIZE) + 0), 6, &hdr[0]);
+#else
   union dword_word
   {
     uint32_t u32[2];
@@ -2762,15 +3334,22 @@ void EventAlarmWrite()
                 (uint16_t *)(&NewEventFIFO[NewEventOutNdx].EID));
   FRAM_Write(DEV_FRAM2, (ALARM_LOG_START + (EV_Alarm.NextEvntNdx * SNAPSHOTS_EVENT_SIZE) + 4), 4,
                 (uint16_t *)(&NewEventFIFO[NewEventOutNdx].TS));
+#endif
   FRAM_Write(DEV_FRAM2, (ALARM_LOG_START + (EV_Alarm.NextEvntNdx * SNAPSHOTS_EVENT_SIZE) + 12),
                 (SNAPSHOT_SIZE  >> 1), (uint16_t *)&SnapshotMeteredValues);
+#ifdef ENABLE_EID_INDEX
+  EventIndexPut(EV_TYPE_ALARM, EV_Alarm.NextEvntNdx, NewEventFIFO[NewEventOutNdx].EID);
+#endif
 
   if (++EV_Alarm.NextEvntNdx >= ALARM_NUM_LOGS)
   {
     EV_Alarm.NextEvntNdx = 0;
   }
   EV_Alarm.Num_Events = ((EV_Alarm.Num_Events < ALARM_NUM_LOGS) ? (EV_Alarm.Num_Events + 1) : ALARM_NUM_LOGS);
-  
+
+#ifdef ENABLE_EVENT_WC
+  EventWC.Dirty |= EVWC_DIRTY(EV_TYPE_ALARM);   // The index record is written by EventWC_Commit()
+#else
   // Store index and number of events in FRAM
   uval.u16[0] = EV_Alarm.NextEvntNdx;
   uval.u16[1] = EV_Alarm.Num_Events;
@@ -2783,6 +3362,7 @@ void EventAlarmWrite()
   uval.u32[1] = ~EventMasterEID;
   FRAM_Write(DEV_FRAM2, MASTER_EID, 4, (uint16_t *)(&uval.u32[0]));
   FRAM_Write(DEV_FRAM2, MASTER_EID+SECONDBLK_OFFSET, 4, (uint16_t *)(&uval.u32[0]));
+#endif
 
 }
 
@@ -2824,6 +3404,9 @@ void EventExtCapWrite()
                 (uint16_t *)(&NewEventFIFO[NewEventOutNdx].TS));
   FRAM_Write(DEV_FRAM2, (EXTCAP_LOG_START + (EV_ExtCap.NextEvntNdx * SNAPSHOTS_EVENT_SIZE) + 12),
                 (SNAPSHOT_SIZE  >> 1), (uint16_t *)&SnapshotMeteredValues);
+#ifdef ENABLE_EID_INDEX
+  EventIndexPut(EV_TYPE_EXTCAP, EV_ExtCap.NextEvntNdx, NewEventFIFO[NewEventOutNdx].EID);
+#endif
 
   if (++EV_ExtCap.NextEvntNdx >= EXTCAP_NUM_LOGS)
   {
@@ -3184,6 +3767,9 @@ int16_t BinarySearch(uint16_t FirstIndex, uint16_t LastIndex, uint32_t ValueSear
 //  FUNCTION:           EventLookUp in event logs
 //
 //  MECHANICS:          Event Manager
+//                      If ENABLE_EID_INDEX is defined, the logs that are in the RAM EID index are searched
+//                      by EventIndexLookUp(), without reading FRAM.  The other logs are searched in FRAM by
+//                      EventLookUpFRAM(), which is the search below
 //
 //  INPUTS:             EIDLookUp - EID what look for
 //                      EventType - enum of EVENT_TYPES
@@ -3193,14 +3779,27 @@ int16_t BinarySearch(uint16_t FirstIndex, uint16_t LastIndex, uint32_t ValueSear
 //
 //  ALTERS:             None
 // 
-//  CALLS:              ReadEID(), BinarySearch()
+//  CALLS:              ReadEID(), BinarySearch(), EventIndexLookUp() (if ENABLE_EID_INDEX is defined)
 //
 //  EXECUTION TIME:     Measured on 221205 (rev 0.66 code): 136usec  This includes one sample interrupt and
 //                      a worst-case condition where 10 iterations are made in BinarySearch()
 // 
 //------------------------------------------------------------------------------------------------------------
 
+#ifdef ENABLE_EID_INDEX
 int16_t EventLookUp(uint32_t EIDLookUp, uint8_t EventType)
+{
+  if ( (EventType <= EV_TYPE_LAST) && (EV_EID_START[EventType] != EV_EID_NONE) )
+  {
+    return (EventIndexLookUp(EIDLookUp, EventType));
+  }
+  return (EventLookUpFRAM(EIDLookUp, EventType));
+}
+
+int16_t EventLookUpFRAM(uint32_t EIDLookUp, uint8_t EventType)
+#else
+int16_t EventLookUp(uint32_t EIDLookUp, uint8_t EventType)
+#endif
 {
   int16_t result;
   uint32_t EIDAtZero;
@@ -3268,6 +3867,202 @@ int16_t EventLookUp(uint32_t EIDLookUp, uint8_t EventType)
 
 
 
+#ifdef ENABLE_EID_INDEX
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       EventIndexInit()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Build the RAM EID Index
+//
+//  MECHANICS:          This subroutine reads the EID of each entry of the indexed logs from FRAM and stores
+//                      it in EventEIDNdx[], at EV_EID_START[EventType] + the entry's index in the log.  The
+//                      index holds the same EIDs as FRAM, in the same order, so an entry's index in the log
+//                      is its position in the index.
+//                      Only the entries that have been written (Num_Events) are read.  The rest are set to
+//                      0, which is never a valid EID, so an entry that was written before the logs were
+//                      cleared (ClearEvents() does not erase the entries in FRAM) is not found.
+//                      After this, the index is kept up to date by EventIndexPut() when an entry is written.
+//
+//  CAVEATS:            Only included if ENABLE_EID_INDEX is defined.
+//                      This subroutine assumes SPI2 is free for use.  It is called from Event_VarInit(),
+//                      after the number of events have been read.
+//                      This takes one FRAM read per entry (up to about 1000 entries).
+//
+//  INPUTS:             EV_Sum.Num_Events, RAM_EV_ADD[]->Num_Events
+// 
+//  OUTPUTS:            EventEIDNdx[]
+//
+//  ALTERS:             None
+// 
+//  CALLS:              memset(), ReadEID()
+// 
+//------------------------------------------------------------------------------------------------------------
+
+void EventIndexInit(void)
+{
+  uint16_t i, num;
+  uint8_t ev_type;
+
+  memset(&EventEIDNdx[0], 0, sizeof(EventEIDNdx));
+  for (ev_type = EV_TYPE_SUMMARY; ev_type <= EV_TYPE_LAST; ++ev_type)
+  {
+    if (EV_EID_START[ev_type] == EV_EID_NONE)
+    {
+      continue;
+    }
+    num = ( (ev_type == EV_TYPE_SUMMARY) ? EV_Sum.Num_Events : RAM_EV_ADD[ev_type]->Num_Events );
+    if (num > MAX_NUM_EVENTS[ev_type])
+    {
+      num = MAX_NUM_EVENTS[ev_type];
+    }
+    for (i = 0; i < num; ++i)
+    {
+      EventEIDNdx[EV_EID_START[ev_type] + i] = ReadEID(FRAM_EV_INFO[ev_type] + (i * EV_SIZE[ev_type]));
+    }
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         EventIndexInit()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       EventIndexPut()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Update the RAM EID Index
+//
+//  MECHANICS:          This subroutine stores the EID of a log entry that is being written in the index.  It
+//                      is called by the log write subroutines with the index of the entry, before the index
+//                      is incremented.
+//
+//  CAVEATS:            Only included if ENABLE_EID_INDEX is defined.
+//                      EventType must be a log that is indexed
+//
+//  INPUTS:             EventType - enum of EVENT_TYPES
+//                      ndx - index of the entry in the log
+//                      eid - EID of the entry
+// 
+//  OUTPUTS:            EventEIDNdx[]
+//
+//  ALTERS:             None
+// 
+//  CALLS:              None
+// 
+//------------------------------------------------------------------------------------------------------------
+
+void EventIndexPut(uint8_t EventType, uint16_t ndx, uint32_t eid)
+{
+  EventEIDNdx[EV_EID_START[EventType] + ndx] = eid;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         EventIndexPut()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       EventIndexLookUp()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Look Up an EID in the RAM EID Index
+//
+//  MECHANICS:          This subroutine finds the index of the log entry with the given EID, the same as the
+//                      FRAM search in EventLookUpFRAM(), but from EventEIDNdx[], so no FRAM is read.
+//                      The entries are in EID order from the earliest entry to the latest entry:
+//                          Not rolled over (Num_Events < log size): earliest entry is at index 0
+//                          Rolled over: earliest entry is at NextEvntNdx
+//                      The subroutine first checks the EID against the earliest and latest entries, then
+//                      does a binary search over the entries in order (position k is at index
+//                      earliest + k, accounting for rollover).  A log of 500 entries takes at most 9 steps.
+//
+//  CAVEATS:            Only included if ENABLE_EID_INDEX is defined.
+//                      EventType must be a log that is indexed
+//
+//  INPUTS:             EIDLookUp - EID to look for
+//                      EventType - enum of EVENT_TYPES
+//                      EV_Sum.xx, RAM_EV_ADD[]->xx, EventEIDNdx[]
+// 
+//  OUTPUTS:            The subroutine returns the index of the entry in the log, or -1 if the EID is not in
+//                      the log
+//
+//  ALTERS:             None
+// 
+//  CALLS:              None
+// 
+//------------------------------------------------------------------------------------------------------------
+
+int16_t EventIndexLookUp(uint32_t EIDLookUp, uint8_t EventType)
+{
+  const uint32_t *eptr;
+  uint32_t eid;
+  int16_t low, high, mid, ndx;
+  uint16_t num, earliest, size;
+
+  size = MAX_NUM_EVENTS[EventType];
+  if (EventType == EV_TYPE_SUMMARY)
+  {
+    num = EV_Sum.Num_Events;
+    earliest = ( (num < size) ? 0 : EV_Sum.NextEvntNdx );
+  }
+  else
+  {
+    num = RAM_EV_ADD[EventType]->Num_Events;
+    earliest = ( (num < size) ? 0 : RAM_EV_ADD[EventType]->NextEvntNdx );
+  }
+  // There are no log entries with EID = 0 (see EventLookUpFRAM())
+  if ( (num == 0) || (EIDLookUp == 0) )
+  {
+    return (-1);
+  }
+  if (num > size)
+  {
+    num = size;
+  }
+  eptr = &EventEIDNdx[EV_EID_START[EventType]];
+
+  // Check the range first.  The latest entry is at position num - 1
+  ndx = ( ((earliest + num - 1) < size) ? (earliest + num - 1) : ((earliest + num - 1) - size) );
+  if ( (EIDLookUp < eptr[earliest]) || (EIDLookUp > eptr[ndx]) )
+  {
+    return (-1);
+  }
+
+  low = 0;
+  high = (int16_t)num - 1;
+  while (low <= high)
+  {
+    mid = low + ((high - low) >> 1);
+    ndx = ( ((earliest + mid) < size) ? (earliest + mid) : ((earliest + mid) - size) );
+    eid = eptr[ndx];
+    if (eid == EIDLookUp)
+    {
+      return (ndx);
+    }
+    if (eid < EIDLookUp)
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid - 1;
+    }
+  }
+  return (-1);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         EventIndexLookUp()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_EID_INDEX
+
+
+
 
 //------------------------------------------------------------------------------------------------------------
 //             START OF FUNCTION       ClearLogFRAM()
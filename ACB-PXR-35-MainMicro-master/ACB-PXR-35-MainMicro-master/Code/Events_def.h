@@ -100,6 +100,10 @@
 //                          - Added SDPU_ENTRY and SDPU_EXIT to event codes
 //                      - Added ALARM_GND_FAULT_PRE_TEST to event codes
 //   58     230810  DAH - Added STP_FRAME_MISMATCH and STP_ERROR to event codes
+//  166     240218  DAH - Added the RAM EID index definitions (EV_EID_xx)
+//  167     240219  DAH - Added the event queue definitions (NEWEVENT_FIFO_xx, INTEVENT_BUF_xx, EVQ_LOAD(),
+//                        EVQ_STORE()) and struct INTEVENT_SLOT and struct EVENTQ_STATS
+//  168     240220  DAH - Added the event log write combining definitions (EVWC_xx) and struct EVENT_WC
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -139,6 +143,53 @@ enum EVENT_TYPES
   EV_TYPE_EXTCAP
 };
 #define EV_TYPE_LAST    EV_TYPE_EXTCAP
+
+// RAM EID index (ENABLE_EID_INDEX defined, see EventIndexInit() in Events.c).  The index holds the EIDs of
+//   the Summary, Time Adjustment, Trip, Test Trip, Alarm, and Extended Capture logs, in that order.  These
+//   are the start of each log in the index.  The log sizes are in FRAM_Flash_def.h
+#define EV_EID_NONE         0xFFFF              // Log is not indexed
+#define EV_EID_SUMMARY      0
+#define EV_EID_TIMEADJ      (EV_EID_SUMMARY + SUMMARY_NUM_LOGS)
+#define EV_EID_TRIP         (EV_EID_TIMEADJ + TIMEADJ_NUM_LOGS)
+#define EV_EID_TESTTRIP     (EV_EID_TRIP + TRIP_NUM_LOGS)
+#define EV_EID_ALARM        (EV_EID_TESTTRIP + TESTTRIP_NUM_LOGS)
+#define EV_EID_EXTCAP       (EV_EID_ALARM + ALARM_NUM_LOGS)
+#define EV_EID_SIZE         (EV_EID_EXTCAP + EXTCAP_NUM_LOGS)
+
+// Event queue (ENABLE_EVENT_QUEUE defined, see InsertNewEvent() in Events.c).  Events from the interrupts
+//   are placed in IntEventBuf[] without locking, and are moved into NewEventFIFO[] by the foreground, where
+//   they are given their EIDs.  Both sizes must be a power of 2, and no more than 256 (8-bit indices)
+#define NEWEVENT_FIFO_SIZE  32
+#define NEWEVENT_FIFO_MASK  (NEWEVENT_FIFO_SIZE - 1)
+#define INTEVENT_BUF_SIZE   16
+#define INTEVENT_BUF_MASK   (INTEVENT_BUF_SIZE - 1)
+#if ( ((NEWEVENT_FIFO_SIZE & NEWEVENT_FIFO_MASK) != 0) || (NEWEVENT_FIFO_SIZE > 256) )
+  #error NEWEVENT_FIFO_SIZE must be a power of 2 and no more than 256
+#endif
+#if ( ((INTEVENT_BUF_SIZE & INTEVENT_BUF_MASK) != 0) || (INTEVENT_BUF_SIZE > 256) )
+  #error INTEVENT_BUF_SIZE must be a power of 2 and no more than 256
+#endif
+
+// Accesses to the IntEventBuf[] sequence numbers.  A slot's contents must be written before its sequence
+//   number is stored (the DMB in EVQ_STORE()), and must be read after its sequence number is read (a DMB
+//   after EVQ_LOAD()).  The host stress test posts events from a second thread, so the host build uses the
+//   gcc atomic builtins instead of plain accesses
+#ifdef HOST_BUILD
+  #define EVQ_LOAD(ptr)         __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+  #define EVQ_STORE(ptr, val)   __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#else
+  #define EVQ_LOAD(ptr)         (*(ptr))
+  #define EVQ_STORE(ptr, val)   do { __DMB(); *(ptr) = (val); } while (0)
+#endif
+
+// Event log write combining (ENABLE_EVENT_WC defined, see EventWC_Commit() in Events.c).  Up to EVWC_MAX_SUM
+//   Summary log entries are staged in RAM and written to FRAM together.  The log index records that must
+//   be rewritten are marked with the EVWC_DIRTY() bits.  The bits are in the order of the index records in
+//   FRAM (SUMMARY_LOG_ADD thru ALARM_LOG_ADD), so the records are rewritten with one write
+#define EVWC_MAX_SUM        8
+#define EVWC_SUM_WORDS      7                           // Words per Summary log entry (SUMMARY_EVENT_SIZE/2)
+#define EVWC_NUM_LOGS       5                           // Summary, Time Adjustment, Trip, Test Trip, Alarm
+#define EVWC_DIRTY(type)    (1 << ((type) - EV_TYPE_SUMMARY))
 //---------------------------------------------- Event types -----------------------------------------------
 
 
@@ -451,6 +502,32 @@ struct NEWEVENTFIFO
   uint16_t Code;                            // Event Code (0..255 - see definitions above)
 };
 
+struct INTEVENT_SLOT                        // Interrupt event buffer entry (see InsertNewEvent())
+{
+  struct INTERNAL_TIME TS;                  // Time Stamp
+  volatile uint32_t Seq;                    // Sequence number: slot is free when Seq equals the position
+                                            //   that claims it, and holds an event when it is one more
+  uint16_t Code;                            // Event Code
+};
+
+struct EVENTQ_STATS                         // Event queue overflow accounting
+{
+  uint32_t IntDrops;                        // Interrupt events lost because IntEventBuf[] was full
+  uint32_t FifoDrops;                       // Foreground events lost because NewEventFIFO[] was full
+  uint8_t IntHiWater;                       // Most events seen waiting in IntEventBuf[]
+  uint8_t FifoHiWater;                      // Most events seen waiting in NewEventFIFO[]
+};
+
+struct EVENT_WC                             // Event log write combining (see EventWC_Commit())
+{
+  uint16_t Sum[EVWC_MAX_SUM * EVWC_SUM_WORDS];  // Staged Summary log entries, as stored in FRAM
+  uint16_t SumFirst;                        // Summary log index of Sum[0]
+  uint8_t NumSum;                           // Number of staged Summary log entries
+  uint8_t Dirty;                            // Index records to rewrite (EVWC_DIRTY() bits)
+  uint32_t Commits;                         // Number of commits
+  uint32_t Entries;                         // Number of Summary log entries written by the commits
+};
+
 struct EV_SUM
 {
   uint16_t NextEvntNdx;
@@ -76,6 +76,11 @@
 //   54     230801  DAH - Added support for SDPU and GF disturbance captures
 //                          - Dist_Flag_SD, Dist_Flag_GF, Dist_Flag_Cancel_SD, Dist_Flag_Cancel_GF
 //                            declarations added
+//   162    240214  DAH - Added EventState and EV_WfState declarations to support the loop tracer
+//   166    240218  DAH - Added EventIndexInit() and EventLookUpFRAM() declarations (ENABLE_EID_INDEX defined)
+//   167    240219  DAH - Added InsertEventEntry() and EventQStats declarations, and deleted the IntEventxxxx
+//                        declarations (ENABLE_EVENT_QUEUE defined)
+//   168    240220  DAH - Added EventWC declaration (ENABLE_EVENT_WC defined)
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -102,10 +107,16 @@ extern struct NEWEVENTFIFO NewEventFIFO[];
 extern uint8_t NewEventInNdx;
 extern uint32_t EventMasterEID;
 extern struct EV_DMND EV_Dmnd;
-extern struct NEWEVENTFIFO IntEventBuf[];
-extern uint8_t NewEventInNdx;
-extern uint8_t IntEventInNdx, IntEventOutNdx, IntEventBufFull;
+#ifdef ENABLE_EVENT_QUEUE
+  extern struct EVENTQ_STATS EventQStats;
+#else
+  extern struct NEWEVENTFIFO IntEventBuf[];
+  extern uint8_t IntEventInNdx, IntEventOutNdx, IntEventBufFull;
+#endif
 extern uint8_t Dist_GOOSE;
+#ifdef ENABLE_EVENT_WC
+  extern struct EVENT_WC EventWC;
+#endif
 
 extern struct EV_SUM EV_Sum;
 
@@ -122,6 +133,7 @@ extern struct DIST_VALUES sListOfDist[];
 extern struct EXCTAP_STATE sExtCapState;
 extern uint8_t ExtCap_ReqFlag;
 extern uint8_t ExtCap_AckFlag;
+extern uint8_t EventState, EV_WfState;
 extern uint8_t Goose_Capture_Code;
 
 
@@ -145,9 +157,16 @@ extern void Event_VarInit(void);
 extern void EventManager(void);
 extern void ClearEvents(void);
 extern uint32_t InsertNewEvent(uint8_t EventType);
+#ifdef ENABLE_EVENT_QUEUE
+  extern uint8_t InsertEventEntry(uint16_t EventCode, uint32_t eid, struct INTERNAL_TIME *ts);
+#endif
 extern uint8_t GetEVInfo(uint8_t ev_type);
 extern void EventSummaryWrite(void);
 extern int16_t EventLookUp(uint32_t EIDLookUp, uint8_t EventType);
+#ifdef ENABLE_EID_INDEX
+  extern void EventIndexInit(void);
+  extern int16_t EventLookUpFRAM(uint32_t EIDLookUp, uint8_t EventType);
+#endif
 extern void ClearLogFRAM(uint8_t EventType);
 extern void ExtendedCapture(uint8_t TypeOfRecord);
 extern void DisturbanceCapture(void);
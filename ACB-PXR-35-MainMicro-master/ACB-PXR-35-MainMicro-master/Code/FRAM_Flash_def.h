@@ -134,6 +134,10 @@
 //                        FRAM
 //   142    240119  DAH - Revised factory calibration values in the SPI2 FRAM map
 //   143    240122  DAH - Revised factory buffer variable definitions
+//   165    240217  DAH - Added a note on the coded waveform captures (ENABLE_WF_CODEC) to the waveform
+//                        definitions
+//   179    240302  DAH - Revised the note on the coded waveform captures (the number of captures has not
+//                        been increased, and WF_CODEC_I_MAX_ERR uses both blocks)
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -321,6 +325,14 @@
 // NOTE: ALL WAVEFORM BLOCKS MUST BE ON EVEN BLOCK BOUNDARIES, BECAUSE WHEN WE ABORT A CAPTURE AND NEED TO
 //       ERASE THE BLOCKS THAT HAD BEEN PARTIALLY WRITTEN, WE SET THE ADDRESS TO THE BLOCK ADDRESS & 0xFE00
 //       TO ENSURE BOTH BLOCKS ARE ERASED.  THIS ASSUMES THE BLOCKS ARE ON EVEN BOUNDARIES
+//
+// If the waveforms are coded (ENABLE_WF_CODEC defined in Iod_def.h, see WfCodec_def.h), a capture is
+//   typically 130 - 160 pages, and never more than one block unless WF_CODEC_I_MAX_ERR is defined.  The
+//   slots are not changed.  If only the first block of each slot can be written, the second block is not
+//   erased.
+//   THE NUMBER OF CAPTURES HAS NOT BEEN INCREASED - the codec does not store more captures in the same
+//   Flash.  That would need more waveform headers in FRAM (TRIP_WF_INFO, etc.), which would move the rest
+//   of the FRAM map, and with WF_CODEC_I_MAX_ERR defined a capture may still need the whole slot
 #define NUM_TRIP_WAVEFORMS      21
 #define WF_SIZE_IN_SECTORS      (2 * 16)
 #define TRIP_WAVEFORMS_START    (EXTCAP_WAVEFORMS_END + 1)      // x2A0 (572) - Even block boundary (x2A)
@@ -42,6 +42,8 @@
 //                      - Added AFE filter compensation tables COMPENSATION_FACTOR_60HZ[] and
 //                        COMPENSATION_FACTOR_50HZ[]
 //   0.33   190823  DAH - Changed x_n_test1[ ] test samples for Sequence Components testing
+//   156    240208  DAH - Added HARM_COS_TBL[] for the cycle-folded DFT in Calc_Harmonics()
+//   179    240302  DAH - HARM_COS_TBL[] only included if ENABLE_HARM_FOLD is defined or in the host build
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -2014,3 +2016,132 @@ const float COMPENSATION_FACTOR_50HZ[479] = {
     1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0
                                       };     */
 
+
+#if defined(ENABLE_HARM_FOLD) || defined(HOST_BUILD)
+// Cosine table for the cycle-folded DFT in Calc_Harmonics()
+//   HARM_COS_TBL[k] = cos(2*pi*k/960), k = 0..959
+//   The sine is read from the same table: sin(2*pi*k/960) = HARM_COS_TBL[(k + 720) % 960]
+const float HARM_COS_TBL[N_SAMPLES] = {
+    1.000000000,  0.999978582,  0.999914328,  0.999807240,  0.999657325,  0.999464587,  0.999229036,  0.998950681,
+    0.998629535,  0.998265610,  0.997858923,  0.997409491,  0.996917334,  0.996382472,  0.995804928,  0.995184727,
+    0.994521895,  0.993816462,  0.993068457,  0.992277912,  0.991444861,  0.990569340,  0.989651387,  0.988691040,
+    0.987688341,  0.986643332,  0.985556059,  0.984426568,  0.983254908,  0.982041128,  0.980785280,  0.979487420,
+    0.978147601,  0.976765881,  0.975342321,  0.973876979,  0.972369920,  0.970821208,  0.969230910,  0.967599092,
+    0.965925826,  0.964211183,  0.962455236,  0.960658061,  0.958819735,  0.956940336,  0.955019944,  0.953058643,
+    0.951056516,  0.949013649,  0.946930129,  0.944806046,  0.942641491,  0.940436556,  0.938191336,  0.935905927,
+    0.933580426,  0.931214935,  0.928809553,  0.926364384,  0.923879533,  0.921355105,  0.918791210,  0.916187957,
+    0.913545458,  0.910863825,  0.908143174,  0.905383621,  0.902585284,  0.899748284,  0.896872742,  0.893958780,
+    0.891006524,  0.888016101,  0.884987637,  0.881921264,  0.878817113,  0.875675315,  0.872496007,  0.869279324,
+    0.866025404,  0.862734386,  0.859406412,  0.856041623,  0.852640164,  0.849202182,  0.845727822,  0.842217234,
+    0.838670568,  0.835087976,  0.831469612,  0.827815631,  0.824126189,  0.820401444,  0.816641555,  0.812846685,
+    0.809016994,  0.805152649,  0.801253813,  0.797320654,  0.793353340,  0.789352042,  0.785316931,  0.781248179,
+    0.777145961,  0.773010453,  0.768841832,  0.764640276,  0.760405966,  0.756139082,  0.751839807,  0.747508327,
+    0.743144825,  0.738749490,  0.734322509,  0.729864073,  0.725374371,  0.720853597,  0.716301943,  0.711719606,
+    0.707106781,  0.702463666,  0.697790460,  0.693087363,  0.688354576,  0.683592302,  0.678800746,  0.673980111,
+    0.669130606,  0.664252438,  0.659345815,  0.654410948,  0.649448048,  0.644457328,  0.639439002,  0.634393284,
+    0.629320391,  0.624220540,  0.619093949,  0.613940839,  0.608761429,  0.603555942,  0.598324601,  0.593067629,
+    0.587785252,  0.582477697,  0.577145190,  0.571787960,  0.566406237,  0.561000251,  0.555570233,  0.550116417,
+    0.544639035,  0.539138323,  0.533614516,  0.528067851,  0.522498565,  0.516906897,  0.511293086,  0.505657373,
+    0.500000000,  0.494321208,  0.488621241,  0.482900344,  0.477158760,  0.471396737,  0.465614520,  0.459812358,
+    0.453990500,  0.448149194,  0.442288690,  0.436409241,  0.430511097,  0.424594511,  0.418659738,  0.412707030,
+    0.406736643,  0.400748833,  0.394743856,  0.388721970,  0.382683432,  0.376628502,  0.370557438,  0.364470500,
+    0.358367950,  0.352250048,  0.346117057,  0.339969240,  0.333806859,  0.327630180,  0.321439465,  0.315234982,
+    0.309016994,  0.302785770,  0.296541575,  0.290284677,  0.284015345,  0.277733846,  0.271440450,  0.265135426,
+    0.258819045,  0.252491577,  0.246153293,  0.239804465,  0.233445364,  0.227076263,  0.220697435,  0.214309153,
+    0.207911691,  0.201505322,  0.195090322,  0.188666965,  0.182235525,  0.175796280,  0.169349504,  0.162895473,
+    0.156434465,  0.149966756,  0.143492622,  0.137012342,  0.130526192,  0.124034451,  0.117537397,  0.111035309,
+    0.104528463,  0.098017140,  0.091501619,  0.084982177,  0.078459096,  0.071932653,  0.065403129,  0.058870804,
+    0.052335956,  0.045798867,  0.039259816,  0.032719083,  0.026176948,  0.019633692,  0.013089596,  0.006544938,
+    0.000000000, -0.006544938, -0.013089596, -0.019633692, -0.026176948, -0.032719083, -0.039259816, -0.045798867,
+   -0.052335956, -0.058870804, -0.065403129, -0.071932653, -0.078459096, -0.084982177, -0.091501619, -0.098017140,
+   -0.104528463, -0.111035309, -0.117537397, -0.124034451, -0.130526192, -0.137012342, -0.143492622, -0.149966756,
+   -0.156434465, -0.162895473, -0.169349504, -0.175796280, -0.182235525, -0.188666965, -0.195090322, -0.201505322,
+   -0.207911691, -0.214309153, -0.220697435, -0.227076263, -0.233445364, -0.239804465, -0.246153293, -0.252491577,
+   -0.258819045, -0.265135426, -0.271440450, -0.277733846, -0.284015345, -0.290284677, -0.296541575, -0.302785770,
+   -0.309016994, -0.315234982, -0.321439465, -0.327630180, -0.333806859, -0.339969240, -0.346117057, -0.352250048,
+   -0.358367950, -0.364470500, -0.370557438, -0.376628502, -0.382683432, -0.388721970, -0.394743856, -0.400748833,
+   -0.406736643, -0.412707030, -0.418659738, -0.424594511, -0.430511097, -0.436409241, -0.442288690, -0.448149194,
+   -0.453990500, -0.459812358, -0.465614520, -0.471396737, -0.477158760, -0.482900344, -0.488621241, -0.494321208,
+   -0.500000000, -0.505657373, -0.511293086, -0.516906897, -0.522498565, -0.528067851, -0.533614516, -0.539138323,
+   -0.544639035, -0.550116417, -0.555570233, -0.561000251, -0.566406237, -0.571787960, -0.577145190, -0.582477697,
+   -0.587785252, -0.593067629, -0.598324601, -0.603555942, -0.608761429, -0.613940839, -0.619093949, -0.624220540,
+   -0.629320391, -0.634393284, -0.639439002, -0.644457328, -0.649448048, -0.654410948, -0.659345815, -0.664252438,
+   -0.669130606, -0.673980111, -0.678800746, -0.683592302, -0.688354576, -0.693087363, -0.697790460, -0.702463666,
+   -0.707106781, -0.711719606, -0.716301943, -0.720853597, -0.725374371, -0.729864073, -0.734322509, -0.738749490,
+   -0.743144825, -0.747508327, -0.751839807, -0.756139082, -0.760405966, -0.764640276, -0.768841832, -0.773010453,
+   -0.777145961, -0.781248179, -0.785316931, -0.789352042, -0.793353340, -0.797320654, -0.801253813, -0.805152649,
+   -0.809016994, -0.812846685, -0.816641555, -0.820401444, -0.824126189, -0.827815631, -0.831469612, -0.835087976,
+   -0.838670568, -0.842217234, -0.845727822, -0.849202182, -0.852640164, -0.856041623, -0.859406412, -0.862734386,
+   -0.866025404, -0.869279324, -0.872496007, -0.875675315, -0.878817113, -0.881921264, -0.884987637, -0.888016101,
+   -0.891006524, -0.893958780, -0.896872742, -0.899748284, -0.902585284, -0.905383621, -0.908143174, -0.910863825,
+   -0.913545458, -0.916187957, -0.918791210, -0.921355105, -0.923879533, -0.926364384, -0.928809553, -0.931214935,
+   -0.933580426, -0.935905927, -0.938191336, -0.940436556, -0.942641491, -0.944806046, -0.946930129, -0.949013649,
+   -0.951056516, -0.953058643, -0.955019944, -0.956940336, -0.958819735, -0.960658061, -0.962455236, -0.964211183,
+   -0.965925826, -0.967599092, -0.969230910, -0.970821208, -0.972369920, -0.973876979, -0.975342321, -0.976765881,
+   -0.978147601, -0.979487420, -0.980785280, -0.982041128, -0.983254908, -0.984426568, -0.985556059, -0.986643332,
+   -0.987688341, -0.988691040, -0.989651387, -0.990569340, -0.991444861, -0.992277912, -0.993068457, -0.993816462,
+   -0.994521895, -0.995184727, -0.995804928, -0.996382472, -0.996917334, -0.997409491, -0.997858923, -0.998265610,
+   -0.998629535, -0.998950681, -0.999229036, -0.999464587, -0.999657325, -0.999807240, -0.999914328, -0.999978582,
+   -1.000000000, -0.999978582, -0.999914328, -0.999807240, -0.999657325, -0.999464587, -0.999229036, -0.998950681,
+   -0.998629535, -0.998265610, -0.997858923, -0.997409491, -0.996917334, -0.996382472, -0.995804928, -0.995184727,
+   -0.994521895, -0.993816462, -0.993068457, -0.992277912, -0.991444861, -0.990569340, -0.989651387, -0.988691040,
+   -0.987688341, -0.986643332, -0.985556059, -0.984426568, -0.983254908, -0.982041128, -0.980785280, -0.979487420,
+   -0.978147601, -0.976765881, -0.975342321, -0.973876979, -0.972369920, -0.970821208, -0.969230910, -0.967599092,
+   -0.965925826, -0.964211183, -0.962455236, -0.960658061, -0.958819735, -0.956940336, -0.955019944, -0.953058643,
+   -0.951056516, -0.949013649, -0.946930129, -0.944806046, -0.942641491, -0.940436556, -0.938191336, -0.935905927,
+   -0.933580426, -0.931214935, -0.928809553, -0.926364384, -0.923879533, -0.921355105, -0.918791210, -0.916187957,
+   -0.913545458, -0.910863825, -0.908143174, -0.905383621, -0.902585284, -0.899748284, -0.896872742, -0.893958780,
+   -0.891006524, -0.888016101, -0.884987637, -0.881921264, -0.878817113, -0.875675315, -0.872496007, -0.869279324,
+   -0.866025404, -0.862734386, -0.859406412, -0.856041623, -0.852640164, -0.849202182, -0.845727822, -0.842217234,
+   -0.838670568, -0.835087976, -0.831469612, -0.827815631, -0.824126189, -0.820401444, -0.816641555, -0.812846685,
+   -0.809016994, -0.805152649, -0.801253813, -0.797320654, -0.793353340, -0.789352042, -0.785316931, -0.781248179,
+   -0.777145961, -0.773010453, -0.768841832, -0.764640276, -0.760405966, -0.756139082, -0.751839807, -0.747508327,
+   -0.743144825, -0.738749490, -0.734322509, -0.729864073, -0.725374371, -0.720853597, -0.716301943, -0.711719606,
+   -0.707106781, -0.702463666, -0.697790460, -0.693087363, -0.688354576, -0.683592302, -0.678800746, -0.673980111,
+   -0.669130606, -0.664252438, -0.659345815, -0.654410948, -0.649448048, -0.644457328, -0.639439002, -0.634393284,
+   -0.629320391, -0.624220540, -0.619093949, -0.613940839, -0.608761429, -0.603555942, -0.598324601, -0.593067629,
+   -0.587785252, -0.582477697, -0.577145190, -0.571787960, -0.566406237, -0.561000251, -0.555570233, -0.550116417,
+   -0.544639035, -0.539138323, -0.533614516, -0.528067851, -0.522498565, -0.516906897, -0.511293086, -0.505657373,
+   -0.500000000, -0.494321208, -0.488621241, -0.482900344, -0.477158760, -0.471396737, -0.465614520, -0.459812358,
+   -0.453990500, -0.448149194, -0.442288690, -0.436409241, -0.430511097, -0.424594511, -0.418659738, -0.412707030,
+   -0.406736643, -0.400748833, -0.394743856, -0.388721970, -0.382683432, -0.376628502, -0.370557438, -0.364470500,
+   -0.358367950, -0.352250048, -0.346117057, -0.339969240, -0.333806859, -0.327630180, -0.321439465, -0.315234982,
+   -0.309016994, -0.302785770, -0.296541575, -0.290284677, -0.284015345, -0.277733846, -0.271440450, -0.265135426,
+   -0.258819045, -0.252491577, -0.246153293, -0.239804465, -0.233445364, -0.227076263, -0.220697435, -0.214309153,
+   -0.207911691, -0.201505322, -0.195090322, -0.188666965, -0.182235525, -0.175796280, -0.169349504, -0.162895473,
+   -0.156434465, -0.149966756, -0.143492622, -0.137012342, -0.130526192, -0.124034451, -0.117537397, -0.111035309,
+   -0.104528463, -0.098017140, -0.091501619, -0.084982177, -0.078459096, -0.071932653, -0.065403129, -0.058870804,
+   -0.052335956, -0.045798867, -0.039259816, -0.032719083, -0.026176948, -0.019633692, -0.013089596, -0.006544938,
+   -0.000000000,  0.006544938,  0.013089596,  0.019633692,  0.026176948,  0.032719083,  0.039259816,  0.045798867,
+    0.052335956,  0.058870804,  0.065403129,  0.071932653,  0.078459096,  0.084982177,  0.091501619,  0.098017140,
+    0.104528463,  0.111035309,  0.117537397,  0.124034451,  0.130526192,  0.137012342,  0.143492622,  0.149966756,
+    0.156434465,  0.162895473,  0.169349504,  0.175796280,  0.182235525,  0.188666965,  0.195090322,  0.201505322,
+    0.207911691,  0.214309153,  0.220697435,  0.227076263,  0.233445364,  0.239804465,  0.246153293,  0.252491577,
+    0.258819045,  0.265135426,  0.271440450,  0.277733846,  0.284015345,  0.290284677,  0.296541575,  0.302785770,
+    0.309016994,  0.315234982,  0.321439465,  0.327630180,  0.333806859,  0.339969240,  0.346117057,  0.352250048,
+    0.358367950,  0.364470500,  0.370557438,  0.376628502,  0.382683432,  0.388721970,  0.394743856,  0.400748833,
+    0.406736643,  0.412707030,  0.418659738,  0.424594511,  0.430511097,  0.436409241,  0.442288690,  0.448149194,
+    0.453990500,  0.459812358,  0.465614520,  0.471396737,  0.477158760,  0.482900344,  0.488621241,  0.494321208,
+    0.500000000,  0.505657373,  0.511293086,  0.516906897,  0.522498565,  0.528067851,  0.533614516,  0.539138323,
+    0.544639035,  0.550116417,  0.555570233,  0.561000251,  0.566406237,  0.571787960,  0.577145190,  0.582477697,
+    0.587785252,  0.593067629,  0.598324601,  0.603555942,  0.608761429,  0.613940839,  0.619093949,  0.624220540,
+    0.629320391,  0.634393284,  0.639439002,  0.644457328,  0.649448048,  0.654410948,  0.659345815,  0.664252438,
+    0.669130606,  0.673980111,  0.678800746,  0.683592302,  0.688354576,  0.693087363,  0.697790460,  0.702463666,
+    0.707106781,  0.711719606,  0.716301943,  0.720853597,  0.725374371,  0.729864073,  0.734322509,  0.738749490,
+    0.743144825,  0.747508327,  0.751839807,  0.756139082,  0.760405966,  0.764640276,  0.768841832,  0.773010453,
+    0.777145961,  0.781248179,  0.785316931,  0.789352042,  0.793353340,  0.797320654,  0.801253813,  0.805152649,
+    0.809016994,  0.812846685,  0.816641555,  0.820401444,  0.824126189,  0.827815631,  0.831469612,  0.835087976,
+    0.838670568,  0.842217234,  0.845727822,  0.849202182,  0.852640164,  0.856041623,  0.859406412,  0.862734386,
+    0.866025404,  0.869279324,  0.872496007,  0.875675315,  0.878817113,  0.881921264,  0.884987637,  0.888016101,
+    0.891006524,  0.893958780,  0.896872742,  0.899748284,  0.902585284,  0.905383621,  0.908143174,  0.910863825,
+    0.913545458,  0.916187957,  0.918791210,  0.921355105,  0.923879533,  0.926364384,  0.928809553,  0.931214935,
+    0.933580426,  0.935905927,  0.938191336,  0.940436556,  0.942641491,  0.944806046,  0.946930129,  0.949013649,
+    0.951056516,  0.953058643,  0.955019944,  0.956940336,  0.958819735,  0.960658061,  0.962455236,  0.964211183,
+    0.965925826,  0.967599092,  0.969230910,  0.970821208,  0.972369920,  0.973876979,  0.975342321,  0.976765881,
+    0.978147601,  0.979487420,  0.980785280,  0.982041128,  0.983254908,  0.984426568,  0.985556059,  0.986643332,
+    0.987688341,  0.988691040,  0.989651387,  0.990569340,  0.991444861,  0.992277912,  0.993068457,  0.993816462,
+    0.994521895,  0.995184727,  0.995804928,  0.996382472,  0.996917334,  0.997409491,  0.997858923,  0.998265610,
+    0.998629535,  0.998950681,  0.999229036,  0.999464587,  0.999657325,  0.999807240,  0.999914328,  0.999978582
+                                      };
+#endif
+
@@ -0,0 +1,1731 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//                      gcc (x86-64 Linux) for the host build only
+//
+//  MODULE NAME:        HostReplay.c
+//
+//  MECHANICS:          Program module containing the sample-stream replay engine for the host (off-target)
+//                      build.  This module is not part of the target project (PXR35_ProtProc.ewp).  It is
+//                      only compiled when HOST_BUILD is defined.
+//
+//                      The replay engine feeds a stream of samples through the actual sampling interrupt
+//                      code at 4800 samples/sec of simulated time, as fast as the host can run it:
+//                        - For each sample, the AFE words are written to AFE_single_capture[] and
+//                          DMA1_Stream0_IRQHandler() is called, then the ADC words are written to
+//                          ADC_single_capture[] and DMA2_Stream0_IRQHandler() is called.  This is the same
+//                          order as on the target, where the ADC interrupt follows the AFE interrupt by one
+//                          half-sample time
+//                        - SysTick_Handler() is called every 48 samples (10msec)
+//                        - TIM4_IRQHandler() is called with the load (CCR3) and line (CCR4) captures at each
+//                          positive-going zero crossing of Van, with the capture times in 1.5MHz counts
+//                        - When the interrupt code sets OneCycAnniv or msec200Anniv, the corresponding
+//                          main-loop anniversary subroutines are run before the next sample.  This models a
+//                          main loop that always completes its anniversary work within one sample time, so
+//                          the results are deterministic
+//                      The sample stream can be:
+//                        - synthetic sinusoids, with an optional step change (fault) in the currents
+//                        - a file of engineering-unit frames (amps and volts), for example waveform
+//                          captures that have been converted from COMTRADE
+//                        - a file of raw frames, the AFE and ADC words exactly as they were transferred by
+//                          DMA on the target
+//                      The engineering-unit values are converted to AFE and ADC readings by reversing the
+//                      calibration scaling, the ADC delay in ADC_Process_Samples(), and the Rogowski
+//                      integrator in AFE_Integrate_Sample(), so that the samples in SampleBuf[] line up with
+//                      the input frames.
+//
+//                      The host CPU time spent in the sampling interrupts and in the anniversary subroutines
+//                      is measured with clock_gettime() and reported by Replay_Report().
+//
+//                      Usage:  HostReplay [-synth | -eng <file> | -raw <file>] [-n <samples>]
+//                                         [-fault <sample> <multiplier>] [-harm <trials>]
+//                                         [-gather <trials>] [-sos <trials>] [-afeblk <trials>]
+//                                         [-sched <seconds>] [-flash <captures>] [-wfcodec <captures>]
+//                                         [-events <passes>] [-evq <bursts>] [-evwc <bursts>]
+//                                         [-crc <trials>] [-dptx <trials>] [-modb <passes>] [-seq <cycles>]
+//                                         [-freq <cycles>] [-camsv <frames>]
+//
+//                      The other options run the benchmarks and checks instead of the sample stream.  These
+//                      are in separate modules, which describe each option:
+//                        - HostReplay_Meter.c: -harm, -gather, -sos, -afeblk, -seq, -freq
+//                        - HostReplay_Sched.c: -sched
+//                        - HostReplay_Flash.c: -flash, -wfcodec
+//                        - HostReplay_Events.c: -events, -evq, -evwc
+//                        - HostReplay_Comm.c: -crc, -dptx, -modb, -camsv
+//                      The benchmarks use the replay engine (Replay_Open(), Replay_Sample()) and the helpers
+//                      in this module to time the code under test (Replay_TimeStart(), Replay_TimeStop()),
+//                      to compute the averages and ratios that are printed (Replay_Ratio()), and to generate
+//                      the random test data (Replay_RandF(), Replay_RandU()).
+//
+//                      main.c is not compiled in the host build, since this module supplies main().  The
+//                      main.c variables that are referenced by other modules are allocated here.
+//
+//  TARGET HARDWARE:    None (host PC)
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   154    240206  DAH File Creation
+//   155    240207  DAH - Added the stage profiler to the host build.  Replay_VarInit() calls Prof_Init(),
+//                        the one-cycle and 200msec anniversary subroutines are timed the same as in main(),
+//                        and Replay_Report() prints the stage statistics.  These are only included if
+//                        ENABLE_STAGE_PROFILER is defined
+//   156    240208  DAH - Added Replay_HarmBench() and the -harm option, to compare the cycle-folded DFT
+//                        harmonics computations with the previous FFT method
+//   157    240209  DAH - Added Replay_GatherBench(), Replay_GatherWin(), Replay_GatherLines(), and the
+//                        -gather option, to compare moving the harmonics sample windows out of the two
+//                        SampleBuf layouts
+//   158    240210  DAH - Added Replay_SOSBench() and the -sos option, to check the integer one-cycle
+//                        voltage sums of squares against exact sums and compare them with the floating point
+//                        sums.  These are only included if ENABLE_SIMD_SOS is defined
+//   159    240211  DAH - Added Replay_AFEBlockBench() and the -afeblk option, to compare processing the AFE
+//                        samples in blocks of 1, 4, and 8 with processing them one channel at a time
+//   160    240212  DAH - Revised Replay_200msecTasks() to call Apply_CalConstants(), to match main()
+//   161    240213  DAH - Added Replay_SchedSim(), Replay_SimLegacyPass(), Replay_SimTick(),
+//                        Replay_SimSlice(), Replay_SimSPI1Slice() thru Replay_SimBkgndSlice(), and the -sched
+//                        option, to compare the main loop timing with and without the cooperative scheduler.
+//                        These are only included if ENABLE_MAIN_SCHED is defined
+//   163    240215  DAH - Revised Replay_Report() to print the SPI2 FRAM transaction count and bus time from
+//                        the FRAM model in HostShim.c.  This is only included if ENABLE_SPI2_DMA is defined
+//   164    240216  DAH - Added Replay_FlashBench(), Replay_FlashRun(), Replay_FlashGet(), Replay_FlashSet(),
+//                        and the -flash option, to measure writing the waveform captures to Flash with the
+//                        pipeline.  These are only included if ENABLE_SPI1_DMA is defined
+//   165    240217  DAH - Added Replay_WfCodecBench(), Replay_WfCodecFill(), Replay_WfCodecCheck(), and the
+//                        -wfcodec option, to measure the coded waveform captures.  Revised Replay_FlashRun()
+//                        to check the coded captures.  These are only included if ENABLE_WF_CODEC is defined
+//   166    240218  DAH - Added Replay_EventBench() and the -events option, to measure the event log EID
+//                        lookups with the RAM EID index.  These are only included if ENABLE_EID_INDEX and
+//                        ENABLE_SPI2_DMA are defined
+//   167    240219  DAH - Added Replay_EventQBench(), Replay_EventQIsr(), and the -evq option, to stress the
+//                        event queue from a simulated interrupt thread.  These are only included if
+//                        ENABLE_EVENT_QUEUE and ENABLE_SPI2_DMA are defined
+//   168    240220  DAH - Added Replay_EventWCBench() and the -evwc option, to measure the event log write
+//                        throughput with and without ENABLE_EVENT_WC
+//   169    240221  DAH - Added Replay_CrcBench(), Replay_CrcRef(), and the -crc option, to check and time the
+//                        slicing-by-8 CRC-16.  These are only included if ENABLE_CRC_SLICE is defined
+//                          - Added includes of DispComm_def.h, Crc_def.h, DispComm_ext.h, and Crc_ext.h
+//   170    240222  DAH - Added Replay_DPTxBench(), Replay_DPTxDecode(), and the -dptx option, to time and
+//                        check the display processor RTD buffer messages with and without ENABLE_DP_TX_SG
+//   171    240223  DAH - Added Replay_ModbBench() and the -modb option, to time the Modbus register reads
+//                        with and without ENABLE_MODB_REG_INDEX
+//                          - Added includes of Modbus_def.h and Modbus_ext.h
+//   172    240224  DAH - Replay_200msecTasks() revised to refresh the Modbus real-time data cache if
+//                        ENABLE_MODB_RTD_CACHE is defined.  Replay_ModbBench() revised to refresh the cache
+//                        at the start of each pass and to time the refresh
+//   173    240225  DAH - Added Replay_ProtBench(), Replay_ProtSetp(), Replay_ProtLegacy(), Replay_ProtGet(),
+//                        Replay_ProtPut(), REPLAY_PROT_WORD[], and the -prot option, to check the protection
+//                        element lists against the original subroutines and time them.  These are only
+//                        included if ENABLE_PROT_TABLE is defined
+//                          - Revised Replay_OneCycTasks() to evaluate the protection element lists if
+//                            ENABLE_PROT_TABLE is defined, to match main()
+//   174    240226  DAH - Added Replay_KernBench(), Replay_KernGet(), Replay_KernPut(), and the -kern option,
+//                        to check the one-cycle kernel against the original subroutines and time them.  These
+//                        are only included if ENABLE_ONECYC_KERNEL is defined
+//                          - Revised Replay_OneCycTasks() to call Calc_OneCyc_Kernel() if
+//                            ENABLE_ONECYC_KERNEL is defined, to match main()
+//                          - Revised Replay_ProtBench() to compute the one-cycle max powers from the scripted
+//                            powers if ENABLE_ONECYC_KERNEL is defined
+//   175    240227  DAH - Added Replay_SeqBench(), Replay_SeqSynth(), Replay_SeqRef(), Replay_SeqGet(), and
+//                        the -seq option, to check the one-cycle sequence components against the SampleBuf[]
+//                        computations and time them.  These are only included if ENABLE_SEQ_PHASOR is defined
+//                          - Revised Replay_OneCycTasks() and Replay_200msecTasks() to call
+//                            Calc_SeqComp_PhAng() every cycle if ENABLE_SEQ_PHASOR is defined, to match
+//                            main()
+//   176    240228  DAH - Added Replay_FreqBench() and the -freq option, to check the zero-crossing frequency
+//                        tracker with a swept frequency.  These are only included if ENABLE_FREQ_TRACK is
+//                        defined
+//                          - Revised Replay_GetFrame() and Replay_Sample() to keep the synthetic phase in
+//                            Replay_Wt and the simulated time in Replay_Tsec, so that the frequency and the
+//                            sample rate may change from one sample to the next
+//                          - Revised Replay_ZeroCross() to compute the capture time from Replay_Tsec
+//                          - Revised Replay_OneCycTasks() to call Calc_FreqTrack() if ENABLE_FREQ_TRACK is
+//                            defined, to match main()
+//   177    240229  DAH - Added Replay_CamSvBench(), Replay_CamSvLink(), and the -camsv option, to check the
+//                        CAM sampled-value frames over a model of the CAM port links.  These are only
+//                        included if ENABLE_CAM_SV_FRAME is defined
+//                          - Added includes of CAMCom_def.h and CAMCom_ext.h
+//   178    240301  DAH - Revised Replay_200msecTasks() to not call Apply_CalConstants(), to match main().
+//                        The coefficients are computed when the cal constants are read or changed
+//                      - Revised Replay_ModbBench() to only declare the cache refresh time, rnsec, if
+//                        ENABLE_MODB_RTD_CACHE is defined
+//                      - Revised the Replay_ProtBench() caveats.  The check must be built with the actual
+//                        setpoint definitions
+//                      - Revised the Replay_KernBench() caveats.  The check must be built with the actual
+//                        setpoint and flag definitions
+//   179    240302  DAH - Revised the Replay_HarmBench() description and caveats.  The cycle-folded DFT is
+//                        only used if ENABLE_HARM_FOLD is defined
+//                      - Added Replay_SOS200msCheck(), to check that the ADC 200msec voltage sums of squares
+//                        cover the same samples when ENABLE_SIMD_SOS is defined.  It is called by
+//                        Replay_SOSBench() at 50Hz and 60Hz
+//                      - Deleted Replay_ProtBench(), Replay_ProtSetp(), Replay_ProtLegacy(),
+//                        Replay_ProtGet(), Replay_ProtPut(), REPLAY_PROT_WORD[], and the -prot option
+//                        (ENABLE_PROT_TABLE deleted)
+//                      - Deleted Replay_KernBench(), Replay_KernGet(), Replay_KernPut(), and the -kern
+//                        option (ENABLE_ONECYC_KERNEL deleted)
+//                      - Revised Replay_WfCodecCheck() to check the current error against
+//                        WF_CODEC_I_MAX_ERR if it is defined
+//                      - Moved the benchmarks and checks into HostReplay_Meter.c, HostReplay_Sched.c,
+//                        HostReplay_Flash.c, HostReplay_Events.c, and HostReplay_Comm.c
+//                          - Added Replay_TimeStart(), Replay_TimeStop(), Replay_Ratio(), Replay_RandF(),
+//                            and Replay_RandU(), for the timing, report, and random data code that was
+//                            repeated in the benchmarks
+//                          - Replay_Sample() and Replay_Nsec() are now called by other modules
+//                          - Revised Replay_Report() to use Replay_Ratio()
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+//
+//------------------------------------------------------------------------------------------------------------
+//
+#ifdef HOST_BUILD
+
+//------------------------------------------------------------------------------------------------------------
+//                   Definitions
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global Definitions from external files...
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "stm32f4xx.h"
+#include "stm32f407xx.h"
+#include "RealTime_def.h"
+#include "Iod_def.h"
+#include "Demand_def.h"
+#include "Intr_def.h"
+#include "Meter_def.h"
+#include "Events_def.h"
+#include "Setpnt_def.h"
+#include "FRAM_Flash_def.h"             // Must be preceded by Events_def.h and Setpnt_def.h!
+#include "Test_def.h"
+#include "Prot_def.h"
+#include "Profile_def.h"
+#include "HostShim_def.h"
+#include "Sched_def.h"
+#include "HostReplay_def.h"             // Must be preceded by Sched_def.h!
+#include "Modbus_def.h"
+
+//
+//      Local Definitions used in this module...
+//
+
+
+//
+//      Global Declarations from external files...
+//
+#include "Init_ext.h"
+#include "Iod_ext.h"
+#include "Test_ext.h"
+#include "Intr_ext.h"
+#include "Meter_ext.h"
+#include "Prot_ext.h"
+#include "Events_ext.h"
+#include "Demand_ext.h"
+#include "Setpnt_ext.h"
+#include "Ovrcom_ext.h"
+#include "Profile_ext.h"
+#include "Sched_ext.h"
+#include "HostReplay_ext.h"
+#include "Modbus_ext.h"
+
+// Interrupt service routines in Intr.c.  On the target these are only referenced by the vector table in
+//   startup_stm32f407xx.s
+extern void SysTick_Handler(void);
+extern void DMA1_Stream0_IRQHandler(void);
+extern void DMA2_Stream0_IRQHandler(void);
+extern void TIM4_IRQHandler(void);
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global (Visible) Function Prototypes (These functions are called by other modules)
+//
+void Replay_VarInit(void);
+uint8_t Replay_Open(uint8_t src, const char *filename);
+uint64_t Replay_Run(uint64_t num_samples);
+void Replay_Report(FILE *fp);
+uint8_t Replay_Sample(void);
+uint64_t Replay_Nsec(void);
+void Replay_TimeStart(struct REPLAY_TIME *tptr);
+uint64_t Replay_TimeStop(struct REPLAY_TIME *tptr);
+double Replay_Ratio(double num, double den);
+float Replay_RandF(float lo, float hi);
+uint32_t Replay_RandU(uint32_t lo, uint32_t hi);
+int main(int argc, char *argv[]);
+
+
+//      Local Function Prototypes (These functions are called only within this module)
+//
+uint8_t Replay_GetFrame(void);
+void Replay_EncodeAFE(void);
+void Replay_EncodeADC(void);
+void Replay_ZeroCross(float van);
+void Replay_OneCycTasks(void);
+void Replay_200msecTasks(void);
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Storage Allocation - Global (Static) Variables
+//------------------------------------------------------------------------------------------------------------
+//
+//       These variables are used by other modules...
+//
+struct REPLAY_STATS ReplayStats;
+struct REPLAY_SYNTH ReplaySynth;
+
+// main.c variables that are referenced by other modules
+uint8_t displayOFFTIM;
+
+//       These variables are used only in this module...
+//
+uint8_t Replay_Src;
+FILE *Replay_fp;
+struct REPLAY_ENG_FRAME Replay_Hist[REPLAY_HIST_SIZE];
+struct REPLAY_RAW_FRAME Replay_RawFrame;
+uint8_t Replay_HistNdx;
+uint8_t Replay_TickCtr;
+uint8_t Replay_PrevTrip;
+float Replay_VanPrev;
+float Replay_IntPrev[5];                    // Previous integrator outputs for the Rogowski channels
+double Replay_Wt;                           // Synthetic source phase angle of the present sample (radians)
+double Replay_Tsec;                         // Simulated time of the present sample (seconds)
+
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Global Constants used in this module and other modules
+//------------------------------------------------------------------------------------------------------------
+//
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_VarInit()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Replay Engine Initialization
+//
+//  MECHANICS:          This subroutine initializes the variables of the modules that are exercised by the
+//                      replay engine, in the same order as main(), and then initializes the replay
+//                      variables.  The synthetic source is set to balanced 60Hz, 1000A, 277V.
+//                      SysClk_120MHz is set so that the sampling interrupt state machine starts sampling.
+//
+//  CAVEATS:            Host_Init() must be called first
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            ReplayStats, ReplaySynth, SysClk_120MHz
+//
+//  ALTERS:             None
+//
+//  CALLS:              IO_VarInit(), Test_VarInit(), Intr_VarInit(), Setp_VarInit(), Event_VarInit(),
+//                      Meter_VarInit(), Load_SetpGr0_Gr1(), Prot_VarInit(), Dmnd_VarInit(),
+//                      Load_SetpGr2_LastGr()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_VarInit(void)
+{
+  uint8_t i;
+
+  IO_VarInit();                         // This must precede Event_VarInit()!!
+  Test_VarInit();
+  Intr_VarInit();
+#ifdef ENABLE_STAGE_PROFILER
+  Prof_Init();
+#endif
+  Setp_VarInit();
+  Event_VarInit();
+  Meter_VarInit();
+  Load_SetpGr0_Gr1();
+  Prot_VarInit();
+  Dmnd_VarInit();
+  Load_SetpGr2_LastGr();
+
+  SysClk_120MHz = TRUE;
+  Manufacture_Mode = FALSE;
+  __enable_irq();
+
+  memset(&ReplayStats, 0, sizeof(ReplayStats));
+  memset(&Replay_Hist[0], 0, sizeof(Replay_Hist));
+  Replay_Src = REPLAY_SRC_NONE;
+  Replay_fp = NULL;
+  Replay_HistNdx = 0;
+  Replay_TickCtr = 0;
+  Replay_PrevTrip = FALSE;
+  Replay_VanPrev = 0.0f;
+  for (i=0; i<5; ++i)
+  {
+    Replay_IntPrev[i] = 0.0f;
+  }
+  Replay_Wt = 0.0;
+  Replay_Tsec = 0.0;
+
+  ReplaySynth.Freq = 60.0f;
+  for (i=0; i<3; ++i)
+  {
+    ReplaySynth.Amp[i] = 1000.0f;                     // Ia, Ib, Ic
+    ReplaySynth.Amp[i+5] = 277.0f;                    // Van, Vbn, Vcn
+    ReplaySynth.Phase[i] = -120.0f * i;
+    ReplaySynth.Phase[i+5] = -120.0f * i;
+  }
+  ReplaySynth.Amp[3] = 0.0f;                          // In
+  ReplaySynth.Amp[4] = 0.0f;                          // Igsrc
+  ReplaySynth.Phase[3] = 0.0f;
+  ReplaySynth.Phase[4] = 0.0f;
+  ReplaySynth.FaultStart = 0xFFFFFFFF;
+  ReplaySynth.FaultMult = 1.0f;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_VarInit()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_Open()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Select the Sample Stream Source
+//
+//  MECHANICS:          This subroutine selects the source of the sample stream.  For the file sources, the
+//                      file is opened.  The files are binary, with one frame per sample and no header:
+//                          REPLAY_SRC_ENG - struct REPLAY_ENG_FRAME (8 floats, little-endian)
+//                          REPLAY_SRC_RAW - struct REPLAY_RAW_FRAME (16 AFE words, 5 ADC words)
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             src - REPLAY_SRC_SYNTH, REPLAY_SRC_ENG, or REPLAY_SRC_RAW
+//                      filename - the file name for the file sources (ignored for REPLAY_SRC_SYNTH)
+//
+//  OUTPUTS:            Returns TRUE if successful, FALSE otherwise
+//
+//  ALTERS:             Replay_Src, Replay_fp
+//
+//  CALLS:              fopen(), fclose()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Replay_Open(uint8_t src, const char *filename)
+{
+  if (Replay_fp != NULL)
+  {
+    fclose(Replay_fp);
+    Replay_fp = NULL;
+  }
+  Replay_Src = REPLAY_SRC_NONE;
+
+  if ( (src == REPLAY_SRC_ENG) || (src == REPLAY_SRC_RAW) )
+  {
+    Replay_fp = fopen(filename, "rb");
+    if (Replay_fp == NULL)
+    {
+      return (FALSE);
+    }
+  }
+  else if (src != REPLAY_SRC_SYNTH)
+  {
+    return (FALSE);
+  }
+  Replay_Src = src;
+  return (TRUE);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_Open()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_GetFrame()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Get the Next Sample Frame
+//
+//  MECHANICS:          This subroutine gets the next frame from the selected source.  Engineering-unit
+//                      frames (synthetic or from a file) are placed in the next Replay_Hist[] slot, and
+//                      Replay_HistNdx is advanced to it.  Raw frames are placed in Replay_RawFrame.
+//                      The synthetic values are:
+//                          val[k] = sqrt(2) * Amp[k] * mult * sin(wt + Phase[k])
+//                      where wt is Replay_Wt, and mult is FaultMult for the currents (k < 5) from sample
+//                      FaultStart on, and 1 otherwise.  Replay_Wt is advanced by 2*pi*Freq/(sample rate)
+//                      each sample in Replay_Sample(), so at a fixed frequency and sample rate,
+//                      wt = 2*pi*Freq*n/4800, where n is the sample number.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             Replay_Src, Replay_fp, ReplaySynth, ReplayStats.Samples, Replay_Wt
+//
+//  OUTPUTS:            Replay_Hist[], Replay_HistNdx, Replay_RawFrame
+//                      Returns TRUE if a frame was read, FALSE at the end of the file
+//
+//  ALTERS:             None
+//
+//  CALLS:              fread(), sin()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Replay_GetFrame(void)
+{
+  struct REPLAY_ENG_FRAME *fptr;
+  double wt, mult;
+  uint8_t k;
+
+  if (Replay_Src == REPLAY_SRC_RAW)
+  {
+    return ( (fread(&Replay_RawFrame, sizeof(Replay_RawFrame), 1, Replay_fp) == 1) ? TRUE : FALSE );
+  }
+
+  Replay_HistNdx = (Replay_HistNdx + 1) & (REPLAY_HIST_SIZE - 1);
+  fptr = &Replay_Hist[Replay_HistNdx];
+
+  if (Replay_Src == REPLAY_SRC_ENG)
+  {
+    return ( (fread(fptr, sizeof(struct REPLAY_ENG_FRAME), 1, Replay_fp) == 1) ? TRUE : FALSE );
+  }
+
+  if (Replay_Src != REPLAY_SRC_SYNTH)
+  {
+    return (FALSE);
+  }
+
+  wt = Replay_Wt;
+  for (k=0; k<8; ++k)
+  {
+    mult = ( ((k < 5) && (ReplayStats.Samples >= ReplaySynth.FaultStart)) ? ReplaySynth.FaultMult : 1.0 );
+    fptr->val[k] = (float)(M_SQRT2 * ReplaySynth.Amp[k] * mult
+                              * sin(wt + ReplaySynth.Phase[k] * (M_PI / 180.0)));
+  }
+  return (TRUE);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_GetFrame()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_EncodeAFE()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Convert Engineering Units to AFE Words
+//
+//  MECHANICS:          This subroutine converts the engineering-unit values to the AFE words that are read
+//                      by AFE_Process_Samples(), by reversing the processing in that subroutine:
+//                        - The calibration constants are selected the same way as in AFE_Process_Samples()
+//                          (In with a CT uses index 9, Igsrc with a Rogowski coil uses index 8)
+//                        - The cal scaling, x = (reading - offset) * gain, is reversed:
+//                              reading = x/gain + offset
+//                        - For the Rogowski channels, the reading is the integrator output.  The integrator,
+//                          y[n] = x[n] + a1 * y[n-1], is reversed to get the di/dt reading:
+//                              x[n] = y[n] - a1 * y[n-1]
+//                        - The reading is clamped to 24 bits and packed with the channel address into the
+//                          two 16-bit words for the channel
+//                      The integrator output is used one sample late, so the Rogowski channels are taken
+//                      from the frame two samples back, and the other channels are taken from the frame
+//                      three samples back.  See Replay_EncodeADC() for the ADC alignment.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             Replay_Hist[], Replay_HistNdx, AFEcal, INT_a1[], GPIOD->ODR (sensor type)
+//
+//  OUTPUTS:            AFE_single_capture[]
+//
+//  ALTERS:             Replay_IntPrev[]
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_EncodeAFE(void)
+{
+  struct REPLAY_ENG_FRAME *rogo_ptr, *volt_ptr;
+  float y, x;
+  int32_t code;
+  uint8_t k, cal_ndx, integrate;
+
+  rogo_ptr = &Replay_Hist[(Replay_HistNdx - 2) & (REPLAY_HIST_SIZE - 1)];
+  volt_ptr = &Replay_Hist[(Replay_HistNdx - 3) & (REPLAY_HIST_SIZE - 1)];
+
+  for (k=0; k<8; ++k)
+  {
+    cal_ndx = k;
+    integrate = (k < 3);
+    if (k == 3)
+    {
+      integrate = IN_USING_ROGOWSKI;
+      cal_ndx = ( (integrate) ? 3 : 9 );
+    }
+    else if (k == 4)
+    {
+      integrate = GF_USING_ROGOWSKI;
+      cal_ndx = ( (integrate) ? 8 : 4 );
+    }
+
+    if (AFEcal.gain[cal_ndx] == 0.0f)
+    {
+      x = 0.0f;
+    }
+    else if (integrate)
+    {
+      y = rogo_ptr->val[k] / AFEcal.gain[cal_ndx] + AFEcal.offset[cal_ndx];
+      x = y - INT_a1[k] * Replay_IntPrev[k];
+      Replay_IntPrev[k] = y;
+    }
+    else
+    {
+      x = volt_ptr->val[k] / AFEcal.gain[cal_ndx] + AFEcal.offset[cal_ndx];
+    }
+
+    if (x >= (float)REPLAY_AFE_MAX_CODE)
+    {
+      code = REPLAY_AFE_MAX_CODE;
+    }
+    else if (x <= -(float)REPLAY_AFE_MAX_CODE)
+    {
+      code = -REPLAY_AFE_MAX_CODE;
+    }
+    else
+    {
+      code = (int32_t)lrintf(x);
+    }
+    AFE_single_capture[2*k] = (uint16_t)( (((uint16_t)k) << 12) | (((uint32_t)code >> 16) & 0x00FF) );
+    AFE_single_capture[2*k + 1] = (uint16_t)((uint32_t)code & 0xFFFF);
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_EncodeAFE()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_EncodeADC()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Convert Engineering Units to ADC Words
+//
+//  MECHANICS:          This subroutine converts the engineering-unit values to the ADC1 and ADC2 readings
+//                      that are read by ADC_Process_Samples(), by reversing the processing in that
+//                      subroutine:
+//                          reading = x/gain + offset + 1.25V reference reading
+//                      The high-gain or low-gain cal constants are used according to the present
+//                      multiplexer setting, and In with a CT uses index 4, the same as ADC_Cal_Scale().  Vn
+//                      is set equal to the reference (0V) and the thermal memory input is set to 0.
+//                      ADC_Process_Samples() delays the readings by two samples, and the AFE interrupt for
+//                      the next sample uses the result, so the ADC readings are taken from the newest frame
+//                      in order to line up with the AFE readings (see Replay_EncodeAFE()).
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             Replay_Hist[], Replay_HistNdx, ADCcalHigh, ADCcalLow, GPIOC->ODR (gain),
+//                      GPIOD->ODR (sensor type)
+//
+//  OUTPUTS:            ADC_single_capture[]
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_EncodeADC(void)
+{
+  struct ADC_CAL *cal_ptr;
+  float x;
+  uint16_t reading[10];
+  uint8_t i, cal_ndx;
+
+  cal_ptr = ( (USING_HIGH_GAIN) ? &ADCcalHigh : &ADCcalLow );
+
+  reading[4] = REPLAY_ADC_REF_CODE;                   // Vn
+  reading[8] = REPLAY_ADC_REF_CODE;                   // 1.25V reference
+  reading[9] = 0;                                     // Thermal memory
+  for (i=0; i<8; ++i)
+  {
+    if (i == 4)
+    {
+      continue;
+    }
+    cal_ndx = ( ((i == 3) && (!IN_USING_ROGOWSKI)) ? 4 : i );
+    if (cal_ptr->gain[cal_ndx] == 0.0f)
+    {
+      x = REPLAY_ADC_REF_CODE;
+    }
+    else
+    {
+      x = Replay_Hist[Replay_HistNdx].val[i] / cal_ptr->gain[cal_ndx] + cal_ptr->offset[cal_ndx]
+                + REPLAY_ADC_REF_CODE;
+    }
+    x = ( (x < 0.0f) ? 0.0f : ((x > REPLAY_ADC_MAX_CODE) ? REPLAY_ADC_MAX_CODE : x) );
+    reading[i] = (uint16_t)lrintf(x);
+  }
+
+  for (i=0; i<5; ++i)                                 // ADC1 is the lower 16-bit word, ADC2 is the upper
+  {
+    ADC_single_capture[i] = ((uint32_t)reading[i+5] << 16) + reading[i];
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_EncodeADC()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_ZeroCross()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Simulate the Frequency Input Captures
+//
+//  MECHANICS:          This subroutine simulates the TIM4 input captures for the load (channel 3) and line
+//                      (channel 4) frequency measurements.  If Van has a positive-going zero crossing
+//                      between the previous sample and this one, the crossing time is found by linear
+//                      interpolation back from the time of this sample (Replay_Tsec), and converted to TIM4
+//                      counts (1.5MHz, 16-bit rollover).  Both capture registers are loaded with the time,
+//                      the capture flags are set, and TIM4_IRQHandler() is called.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             van - the present Van value (volts or raw AFE reading)
+//                      Replay_VanPrev, ReplayStats.Samples, Replay_Tsec, FreqTrack.SampleRate (if
+//                      ENABLE_FREQ_RETUNE is defined)
+//
+//  OUTPUTS:            TIM4->CCR3, TIM4->CCR4, TIM4->SR
+//
+//  ALTERS:             Replay_VanPrev
+//
+//  CALLS:              TIM4_IRQHandler()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_ZeroCross(float van)
+{
+  double t;
+  uint16_t cap;
+
+  if ( (Replay_VanPrev < 0.0f) && (van >= 0.0f) && (ReplayStats.Samples > 0) )
+  {
+    t = Replay_Tsec - (1.0 - (double)Replay_VanPrev / (double)(Replay_VanPrev - van)) / REPLAY_RATE_NOW;
+    cap = (uint16_t)((uint64_t)(t * (double)TIM4_FREQ) & 0xFFFF);
+    TIM4->CCR3 = cap;
+    TIM4->CCR4 = cap;
+    TIM4->SR |= (TIM_SR_CC3IF + TIM_SR_CC4IF);
+    TIM4_IRQHandler();
+  }
+  Replay_VanPrev = van;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_ZeroCross()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_Sample()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Deliver One Sample
+//
+//  MECHANICS:          This subroutine delivers one sample to the interrupt code:
+//                        - Gets the next frame
+//                        - Simulates the frequency input captures
+//                        - Loads the AFE words and calls DMA1_Stream0_IRQHandler()
+//                        - Loads the ADC words and calls DMA2_Stream0_IRQHandler()
+//                        - Calls SysTick_Handler() every 48 samples
+//                        - Advances the synthetic phase and the simulated time by one sample at the present
+//                          sample rate.  This is done after the interrupts, since the sampling interrupt may
+//                          retune the rate (ENABLE_FREQ_RETUNE defined)
+//                      The time spent in the interrupt subroutines is accumulated in ReplayStats.  If the
+//                      interrupts have been left disabled by the main-loop code, the sample is still
+//                      delivered (there is no main loop to re-enable them), but the error is counted.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             Replay_Src, Replay_RawFrame, Replay_Hist[], Host_PRIMASK, ReplaySynth.Freq,
+//                      FreqTrack.SampleRate (if ENABLE_FREQ_RETUNE is defined)
+//
+//  OUTPUTS:            ReplayStats, AFE_single_capture[], ADC_single_capture[]
+//                      Returns TRUE if a sample was delivered, FALSE at the end of the stream
+//
+//  ALTERS:             Replay_TickCtr, Replay_Wt, Replay_Tsec
+//
+//  CALLS:              Replay_GetFrame(), Replay_ZeroCross(), Replay_EncodeAFE(), Replay_EncodeADC(),
+//                      DMA1_Stream0_IRQHandler(), DMA2_Stream0_IRQHandler(), SysTick_Handler(),
+//                      Replay_Nsec()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Replay_Sample(void)
+{
+  uint64_t start, delta;
+  uint32_t utemp32;
+  uint8_t i;
+
+  if (!Replay_GetFrame())
+  {
+    return (FALSE);
+  }
+
+  if (Host_PRIMASK)
+  {
+    ++ReplayStats.PrimaskErrs;
+  }
+
+  start = Replay_Nsec();
+
+  if (Replay_Src == REPLAY_SRC_RAW)
+  {
+    utemp32 = (((uint32_t)(Replay_RawFrame.AFEwords[10] & 0x00FF)) << 16) + Replay_RawFrame.AFEwords[11];
+    Replay_ZeroCross( (float)(((int32_t)(utemp32 << 8)) >> 8) );
+    for (i=0; i<16; ++i)
+    {
+      AFE_single_capture[i] = Replay_RawFrame.AFEwords[i];
+    }
+  }
+  else
+  {
+    Replay_ZeroCross(Replay_Hist[Replay_HistNdx].val[5]);
+    Replay_EncodeAFE();
+  }
+  DMA1_Stream0_IRQHandler();
+
+  if (Replay_Src == REPLAY_SRC_RAW)
+  {
+    for (i=0; i<5; ++i)
+    {
+      ADC_single_capture[i] = Replay_RawFrame.ADCwords[i];
+    }
+  }
+  else
+  {
+    Replay_EncodeADC();
+  }
+  DMA2_Stream0_IRQHandler();
+
+  if (++Replay_TickCtr >= REPLAY_SAMPLES_PER_TICK)
+  {
+    Replay_TickCtr = 0;
+    SysTick_Handler();
+  }
+
+  delta = Replay_Nsec() - start;
+  ReplayStats.SampleNsec += delta;
+  if (delta > ReplayStats.SampleMaxNsec)
+  {
+    ReplayStats.SampleMaxNsec = (uint32_t)delta;
+  }
+  ++ReplayStats.Samples;
+  Replay_Wt = fmod(Replay_Wt + 2.0 * M_PI * (double)ReplaySynth.Freq / REPLAY_RATE_NOW, 2.0 * M_PI);
+  Replay_Tsec += 1.0 / REPLAY_RATE_NOW;
+
+  return (TRUE);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_Sample()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_OneCycTasks()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           One-Cycle Anniversary Subroutines
+//
+//  MECHANICS:          This subroutine runs the one-cycle anniversary subroutines in the same order as the
+//                      main loop in main().  The hardware housekeeping calls (ManageSPI1Flags(),
+//                      TA_Volt_Monitoring(), and AuxPower_Monitoring()) are not included.
+//
+//  CAVEATS:            This must be kept consistent with the one-cycle anniversary code in main()
+//
+//  INPUTS:             Prot_Enabled, Manufacture_Mode, Setpoints1.stp.Ld_Slp, AlarmHoldOffTmr,
+//                      ExtCap_ReqFlag, ExtCap_AckFlag
+//
+//  OUTPUTS:            OneCycAnniv, SystemFlags
+//
+//  ALTERS:             None
+//
+//  CALLS:              See main()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_OneCycTasks(void)
+{
+  PROF_START(PROF_MAIN_ONECYC_CALC);
+  Calc_Prot_Current();
+  Calc_Prot_AFE_Voltage();
+  Calc_ADC_OneCyc_Voltage();
+  Calc_Prot_Power();
+
+  Calc_CF();
+  Calc_Freq(&FreqLoad, VolAFE200msFltr.Van);
+  Calc_Freq(&FreqLine, VolADC200ms.Van);
+#ifdef ENABLE_FREQ_TRACK
+  Calc_FreqTrack();
+#endif
+#ifdef ENABLE_SEQ_PHASOR
+  Calc_SeqComp_PhAng();
+#endif
+
+  SystemFlags |= ONE_CYC_VALS_DONE;
+  PROF_STOP(PROF_MAIN_ONECYC_CALC);
+
+  PROF_START(PROF_MAIN_ONECYC_PROT);
+  if ((Prot_Enabled) && (!Manufacture_Mode))
+  {
+    if (Setpoints1.stp.Ld_Slp < 4)
+    {
+      LongDelay_Prot();
+    }
+    else
+    {
+      Long_IEE_IEC_Prot();
+    }
+    Sneakers_Prot();
+    OverVoltage_Prot();
+    UnderVoltage_Prot();
+    VoltUnbalance_Prot();
+    CurUnbalance_Prot();
+    OverFreq_Prot();
+    UnderFreq_Prot();
+    PhaseLoss_Prot();
+    PhaseRotation_Prot();
+    OverRealPower_Prot();
+    OverReactivePower_Prot();
+    OverApparentPower_Prot();
+    PF_Prot();
+    RevActivePower_Prot();
+    RevReactivePower_Prot();
+  }
+  PROF_STOP(PROF_MAIN_ONECYC_PROT);
+
+  PROF_START(PROF_MAIN_ONECYC_ALARM);
+  OverVoltage_Alarm();
+  UnderVoltage_Alarm();
+  VoltUnbalance_Alarm();
+  CurUnbalance_Alarm();
+  OverFreq_Alarm();
+  UnderFreq_Alarm();
+  PhaseLoss_Alarm();
+  PhaseRotation_Alarm();
+  OverRealPower_Alarm();
+  OverReactivePower_Alarm();
+  OverApparentPower_Alarm();
+  PF_Alarm();
+  RevActivePower_Alarm();
+  RevReactivePower_Alarm();
+  Ground_Fault_PreAlarm();
+  Sneakers_Alarm();
+
+  if (AlarmHoldOffTmr == 0)
+  {
+    Highload_Alarm();
+    Thermal_Mem_Alarm();
+    Wrong_Sensor_Alarm_Curr_Condition();
+    WrongSensor_Alarm();
+    THDCurrent_Alarm();
+    THDVoltage_Alarm();
+    Neutral_Alarm();
+    TA_Alarm();
+    BreakerHealth_Alarm();
+  }
+
+  if ((ExtCap_ReqFlag) || (ExtCap_AckFlag))
+  {
+    ExtendedCapture(OneCycle);
+  }
+  DisturbanceCapture();
+  PROF_STOP(PROF_MAIN_ONECYC_ALARM);
+
+  OneCycAnniv = FALSE;
+  SystemFlags |= VALONECYC;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_OneCycTasks()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_200msecTasks()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           200msec Anniversary Subroutines
+//
+//  MECHANICS:          This subroutine runs the 200msec anniversary metering subroutines in the same order
+//                      as the main loop in main().  The display and GOOSE test code is not included.
+//
+//  CAVEATS:            This must be kept consistent with the 200msec anniversary code in main()
+//
+//  INPUTS:             ExtCap_ReqFlag, ExtCap_AckFlag
+//
+//  OUTPUTS:            msec200Anniv, SystemFlags
+//
+//  ALTERS:             None
+//
+//  CALLS:              See main()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_200msecTasks(void)
+{
+  PROF_START(PROF_MAIN_200MSEC);
+  Calc_Meter_Current();
+  Calc_Meter_AFE_Voltage();
+  Calc_ADC_200ms_Voltage();
+  Calc_Meter_Power();                   // Must follow Calc_Meter_Current() and Calc_Meter_AFE_Voltage()
+
+  Calc_Energy();                        // This must follow Calc_Meter_Power()
+  Calc_Demand();                        // Must follow Calc_Meter_Current() and Calc_Meter_AFE_Voltage()
+  Calc_AppPF();                         // This must follow Calc_Meter_Power()
+  Calc_DispPF_THD();
+#ifndef ENABLE_SEQ_PHASOR
+  Calc_SeqComp_PhAng();
+#endif
+  Calc_5minAverages();
+#ifdef ENABLE_MODB_RTD_CACHE
+  Modb_RtdCacheRefresh();               // This must follow the metering subroutines
+#endif
+
+  if ((ExtCap_ReqFlag) || (ExtCap_AckFlag))
+  {
+    ExtendedCapture(TwoHundred);
+  }
+  PROF_STOP(PROF_MAIN_200MSEC);
+
+  msec200Anniv = FALSE;
+  SystemFlags |= VAL200MSEC;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_200msecTasks()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_Run()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Run the Sample Stream
+//
+//  MECHANICS:          This subroutine delivers up to num_samples samples.  After each sample, the
+//                      anniversary flags that were set by the interrupt code are serviced, so the
+//                      anniversary subroutines run in lockstep with the samples.  The 1sec and 5min
+//                      anniversaries are hardware housekeeping (temperature sensor, RTC, setpoints check),
+//                      so their flags are just cleared.  Trips (rising edges of TripReqFlg) are counted.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             num_samples - the number of samples to deliver
+//
+//  OUTPUTS:            ReplayStats
+//                      Returns the number of samples that were delivered
+//
+//  ALTERS:             OneSecAnniv, min5Anniv, Replay_PrevTrip
+//
+//  CALLS:              Replay_Sample(), Replay_OneCycTasks(), Replay_200msecTasks(), Replay_Nsec()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint64_t Replay_Run(uint64_t num_samples)
+{
+  uint64_t n, run_start, start, delta;
+
+  run_start = Replay_Nsec();
+
+  for (n=0; n<num_samples; ++n)
+  {
+    if (!Replay_Sample())
+    {
+      break;
+    }
+
+    if (OneCycAnniv)
+    {
+      start = Replay_Nsec();
+      Replay_OneCycTasks();
+      delta = Replay_Nsec() - start;
+      ++ReplayStats.OneCycCnt;
+      ReplayStats.OneCycNsec += delta;
+      if (delta > ReplayStats.OneCycMaxNsec)
+      {
+        ReplayStats.OneCycMaxNsec = (uint32_t)delta;
+      }
+    }
+
+    if (msec200Anniv)
+    {
+      start = Replay_Nsec();
+      Replay_200msecTasks();
+      delta = Replay_Nsec() - start;
+      ++ReplayStats.msec200Cnt;
+      ReplayStats.msec200Nsec += delta;
+      if (delta > ReplayStats.msec200MaxNsec)
+      {
+        ReplayStats.msec200MaxNsec = (uint32_t)delta;
+      }
+    }
+
+    OneSecAnniv = FALSE;
+    min5Anniv = FALSE;
+
+    if ( (TripReqFlg) && (!Replay_PrevTrip) )
+    {
+      if (ReplayStats.Trips == 0)
+      {
+        ReplayStats.FirstTripSample = ReplayStats.Samples - 1;
+      }
+      ++ReplayStats.Trips;
+    }
+    Replay_PrevTrip = TripReqFlg;
+  }
+
+  ReplayStats.WallNsec += Replay_Nsec() - run_start;
+  return (n);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_Run()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_Report()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Print the Replay Statistics
+//
+//  MECHANICS:          This subroutine prints the sample count, the simulated and elapsed times, the average
+//                      and maximum host CPU times per sample and per anniversary, and the trips.  If the
+//                      stage profiler is enabled (ENABLE_STAGE_PROFILER), the stage statistics are also
+//                      printed.  If the SPI2 transaction engine is enabled (ENABLE_SPI2_DMA), the number of
+//                      FRAM transactions and the SPI2 bus time are printed.
+//
+//  CAVEATS:            The host CPU times are only useful for comparing one build against another on the
+//                      same PC.  They are not the target execution times.
+//
+//  INPUTS:             fp - the output stream
+//                      ReplayStats, ProfStage[], SPI2Eng.Xacts, Host_FramXacts, Host_FramBusyCyc
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              Replay_Ratio(), fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_Report(FILE *fp)
+{
+  double sim_secs, wall_secs;
+#ifdef ENABLE_STAGE_PROFILER
+  uint8_t i;
+#endif
+
+  sim_secs = (double)ReplayStats.Samples / REPLAY_SAMPLE_RATE;
+  wall_secs = (double)ReplayStats.WallNsec * 1.0E-9;
+
+  fprintf(fp, "Samples:              %llu (%.3f sec simulated, %.3f sec elapsed, %.1f x real time)\n",
+            (unsigned long long)ReplayStats.Samples, sim_secs, wall_secs,
+            Replay_Ratio(sim_secs, wall_secs));
+  fprintf(fp, "Sample interrupts:    avg %.0f nsec, max %u nsec\n",
+            Replay_Ratio(ReplayStats.SampleNsec, ReplayStats.Samples),
+            (unsigned int)ReplayStats.SampleMaxNsec);
+  fprintf(fp, "One-cycle anniv:      %u, avg %.0f nsec, max %u nsec\n", (unsigned int)ReplayStats.OneCycCnt,
+            Replay_Ratio(ReplayStats.OneCycNsec, ReplayStats.OneCycCnt),
+            (unsigned int)ReplayStats.OneCycMaxNsec);
+  fprintf(fp, "200msec anniv:        %u, avg %.0f nsec, max %u nsec\n", (unsigned int)ReplayStats.msec200Cnt,
+            Replay_Ratio(ReplayStats.msec200Nsec, ReplayStats.msec200Cnt),
+            (unsigned int)ReplayStats.msec200MaxNsec);
+  if (ReplayStats.Trips > 0)
+  {
+    fprintf(fp, "Trips:                %u, first at sample %llu (%.4f sec)\n", (unsigned int)ReplayStats.Trips,
+              (unsigned long long)ReplayStats.FirstTripSample,
+              (double)ReplayStats.FirstTripSample / REPLAY_SAMPLE_RATE);
+  }
+  else
+  {
+    fprintf(fp, "Trips:                0\n");
+  }
+  if (ReplayStats.PrimaskErrs > 0)
+  {
+    fprintf(fp, "*** Interrupts were disabled for %u samples\n", (unsigned int)ReplayStats.PrimaskErrs);
+  }
+#ifdef ENABLE_STAGE_PROFILER
+  fprintf(fp, "Stage profile (120MHz-equivalent cycles):\n");
+  for (i=0; i<PROF_NUM_STAGES; ++i)
+  {
+    if (ProfStage[i].Count > 0)
+    {
+      fprintf(fp, "  %-10s n=%u min=%u max=%u avg=%llu\n", PROF_STAGE_NAME[i],
+                (unsigned int)ProfStage[i].Count, (unsigned int)ProfStage[i].Min, (unsigned int)ProfStage[i].Max,
+                (unsigned long long)(ProfStage[i].Total / ProfStage[i].Count));
+    }
+  }
+#endif
+#ifdef ENABLE_SPI2_DMA
+  fprintf(fp, "SPI2 FRAM:            %u transactions, %u chip selects, bus busy %.3f msec (%.3f%%)\n",
+            (unsigned int)SPI2Eng.Xacts, (unsigned int)Host_FramXacts,
+            (double)Host_FramBusyCyc / 120000.0,
+            Replay_Ratio(Host_FramBusyCyc, (sim_secs * 1.2E6)));
+#endif
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_Report()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_Nsec()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Read the Host Monotonic Clock
+//
+//  MECHANICS:          This subroutine returns the host monotonic clock in nanoseconds
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            Returns the time in nanoseconds
+//
+//  ALTERS:             None
+//
+//  CALLS:              clock_gettime()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint64_t Replay_Nsec(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ( ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec );
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_Nsec()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_TimeStart(), Replay_TimeStop()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Benchmark Timer
+//
+//  MECHANICS:          These subroutines time one pass of the code under test with the host monotonic clock.
+//                      Replay_TimeStart() saves the start time.  Replay_TimeStop() adds the time since the
+//                      start to the total, updates the max, and counts the measurement.  The average time
+//                      per measurement is Replay_Ratio(tptr->Nsec, tptr->Count).
+//
+//  CAVEATS:            The timer must be cleared (memset to 0) before the first measurement
+//
+//  INPUTS:             tptr - the timer
+//
+//  OUTPUTS:            Replay_TimeStop() returns the time of the measurement in nanoseconds
+//
+//  ALTERS:             tptr->Start, ->Nsec, ->MaxNsec, ->Count
+//
+//  CALLS:              Replay_Nsec()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_TimeStart(struct REPLAY_TIME *tptr)
+{
+  tptr->Start = Replay_Nsec();
+}
+
+
+uint64_t Replay_TimeStop(struct REPLAY_TIME *tptr)
+{
+  uint64_t delta;
+
+  delta = Replay_Nsec() - tptr->Start;
+  tptr->Nsec += delta;
+  tptr->MaxNsec = ( (delta > tptr->MaxNsec) ? delta : tptr->MaxNsec );
+  ++tptr->Count;
+  return (delta);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_TimeStart(), Replay_TimeStop()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_Ratio()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Report Ratio
+//
+//  MECHANICS:          This subroutine returns num / den, or 0 if den is not positive.  It is used for the
+//                      averages, rates, and speedups that the benchmarks print, so that a run with no
+//                      measurements prints zeros.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             num, den
+//
+//  OUTPUTS:            Returns num / den, or 0
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+double Replay_Ratio(double num, double den)
+{
+  return ( (den > 0.0) ? (num / den) : 0.0 );
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_Ratio()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_RandF(), Replay_RandU()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Random Test Data
+//
+//  MECHANICS:          Replay_RandF() returns a random float that is uniformly distributed from lo to hi.
+//                      Replay_RandU() returns a random integer from lo to hi, inclusive.
+//                      Both use rand(), so the data is repeatable after srand() with the same seed.
+//
+//  CAVEATS:            For Replay_RandU(), hi - lo must be less than RAND_MAX
+//
+//  INPUTS:             lo, hi - the range
+//
+//  OUTPUTS:            Returns the random value
+//
+//  ALTERS:             None
+//
+//  CALLS:              rand()
+//
+//------------------------------------------------------------------------------------------------------------
+
+float Replay_RandF(float lo, float hi)
+{
+  return ( lo + ((hi - lo) * (float)rand() / (float)RAND_MAX) );
+}
+
+
+uint32_t Replay_RandU(uint32_t lo, uint32_t hi)
+{
+  return ( lo + ((uint32_t)rand() % (hi - lo + 1)) );
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_RandF(), Replay_RandU()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        main()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Replay Program Entry
+//
+//  MECHANICS:          This subroutine parses the command line, initializes the host shim and the replay
+//                      engine, runs the sample stream, and prints the statistics.  The default is one
+//                      minute (288000 samples) of the synthetic source.
+//                          -synth                  synthetic source
+//                          -eng <file>             engineering-unit frames
+//                          -raw <file>             raw DMA frames
+//                          -n <samples>            number of samples
+//                          -fault <sample> <mult>  synthetic fault start and current multiplier
+//                          -harm <trials>          compare the harmonics methods instead of running the
+//                                                  sample stream (see Replay_HarmBench())
+//                          -gather <trials>        compare the SampleBuf layouts instead of running the
+//                                                  sample stream (see Replay_GatherBench())
+//                          -sos <trials>           check the voltage sums of squares instead of running the
+//                                                  sample stream (see Replay_SOSBench(), ENABLE_SIMD_SOS
+//                                                  defined)
+//                          -afeblk <trials>        compare the AFE sample processing methods instead of
+//                                                  running the sample stream (see Replay_AFEBlockBench())
+//                          -sched <seconds>        simulate the main loop schedule instead of running the
+//                                                  sample stream (see Replay_SchedSim(), ENABLE_MAIN_SCHED
+//                                                  defined)
+//                          -flash <captures>       write waveform captures to the Flash model instead of
+//                                                  running the sample stream (see Replay_FlashBench(),
+//                                                  ENABLE_SPI1_DMA defined)
+//                          -wfcodec <captures>     write and check coded waveform captures instead of
+//                                                  running the sample stream (see Replay_WfCodecBench(),
+//                                                  ENABLE_WF_CODEC defined)
+//                          -events <passes>        time the event log EID lookups and page reads instead of
+//                                                  running the sample stream (see Replay_EventBench(),
+//                                                  ENABLE_EID_INDEX and ENABLE_SPI2_DMA defined)
+//                          -evq <bursts>           stress the event queue from a simulated interrupt thread
+//                                                  instead of running the sample stream (see
+//                                                  Replay_EventQBench(), ENABLE_EVENT_QUEUE and
+//                                                  ENABLE_SPI2_DMA defined)
+//                          -evwc <bursts>          time the event log writes for bursts of events instead of
+//                                                  running the sample stream (see Replay_EventWCBench(),
+//                                                  ENABLE_SPI2_DMA defined)
+//                          -crc <trials>           check and time the slicing-by-8 CRC-16 instead of running
+//                                                  the sample stream (see Replay_CrcBench(), ENABLE_CRC_SLICE
+//                                                  defined)
+//                          -dptx <trials>          time and check the RTD buffer messages instead of running
+//                                                  the sample stream (see Replay_DPTxBench())
+//                          -modb <passes>          time the Modbus register reads across the address space
+//                                                  instead of running the sample stream (see
+//                                                  Replay_ModbBench())
+//                          -seq <cycles>           check and time the one-cycle sequence components with
+//                                                  random unbalanced waveforms instead of running the sample
+//                                                  stream (see Replay_SeqBench(), ENABLE_SEQ_PHASOR defined)
+//                          -freq <cycles>          check the frequency tracker with a swept frequency instead
+//                                                  of running the sample stream (see Replay_FreqBench(),
+//                                                  ENABLE_FREQ_TRACK defined)
+//                          -camsv <frames>         check the CAM sampled-value frames over a link model
+//                                                  instead of running the sample stream (see
+//                                                  Replay_CamSvBench(), ENABLE_CAM_SV_FRAME defined)
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             argc, argv
+//
+//  OUTPUTS:            Returns 0 if successful, 1 if the command line or file is invalid
+//
+//  ALTERS:             ReplaySynth
+//
+//  CALLS:              Host_Init(), Replay_VarInit(), Replay_Open(), Replay_Run(), Replay_Report(),
+//                      Replay_HarmBench(), Replay_GatherBench(), Replay_SOSBench(), Replay_AFEBlockBench(),
+//                      Replay_SchedSim(), Replay_FlashBench(), Replay_WfCodecBench(), Replay_EventBench(),
+//                      Replay_EventQBench(), Replay_EventWCBench(), Replay_CrcBench(), Replay_DPTxBench(),
+//                      Replay_ModbBench(), Replay_SeqBench(),
+//                      Replay_FreqBench(), Replay_CamSvBench()
+//
+//------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  uint64_t num_samples;
+  const char *filename;
+  uint32_t harm_trials, gather_trials, sos_trials, afeblk_trials, sched_secs, flash_captures;
+  uint32_t wfcodec_captures, event_passes, evq_bursts, evwc_bursts, crc_trials, dptx_trials, modb_passes;
+  uint32_t seq_cycles, freq_cycles, camsv_frames;
+  uint8_t src;
+  int i;
+
+  Host_Init();
+  Replay_VarInit();
+
+  src = REPLAY_SRC_SYNTH;
+  filename = NULL;
+  num_samples = (uint64_t)REPLAY_SAMPLE_RATE * 60;
+  harm_trials = 0;
+  gather_trials = 0;
+  sos_trials = 0;
+  afeblk_trials = 0;
+  sched_secs = 0;
+  flash_captures = 0;
+  wfcodec_captures = 0;
+  event_passes = 0;
+  evq_bursts = 0;
+  evwc_bursts = 0;
+  crc_trials = 0;
+  dptx_trials = 0;
+  modb_passes = 0;
+  seq_cycles = 0;
+  freq_cycles = 0;
+  camsv_frames = 0;
+
+  for (i=1; i<argc; ++i)
+  {
+    if (strcmp(argv[i], "-synth") == 0)
+    {
+      src = REPLAY_SRC_SYNTH;
+    }
+    else if ( (strcmp(argv[i], "-eng") == 0) && (i+1 < argc) )
+    {
+      src = REPLAY_SRC_ENG;
+      filename = argv[++i];
+    }
+    else if ( (strcmp(argv[i], "-raw") == 0) && (i+1 < argc) )
+    {
+      src = REPLAY_SRC_RAW;
+      filename = argv[++i];
+    }
+    else if ( (strcmp(argv[i], "-n") == 0) && (i+1 < argc) )
+    {
+      num_samples = strtoull(argv[++i], NULL, 0);
+    }
+    else if ( (strcmp(argv[i], "-fault") == 0) && (i+2 < argc) )
+    {
+      ReplaySynth.FaultStart = (uint32_t)strtoul(argv[++i], NULL, 0);
+      ReplaySynth.FaultMult = strtof(argv[++i], NULL);
+    }
+    else if ( (strcmp(argv[i], "-harm") == 0) && (i+1 < argc) )
+    {
+      harm_trials = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else if ( (strcmp(argv[i], "-gather") == 0) && (i+1 < argc) )
+    {
+      gather_trials = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+#ifdef ENABLE_SIMD_SOS
+    else if ( (strcmp(argv[i], "-sos") == 0) && (i+1 < argc) )
+    {
+      sos_trials = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+#endif
+    else if ( (strcmp(argv[i], "-afeblk") == 0) && (i+1 < argc) )
+    {
+      afeblk_trials = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+#ifdef ENABLE_MAIN_SCHED
+    else if ( (strcmp(argv[i], "-sched") == 0) && (i+1 < argc) )
+    {
+      sched_secs = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+#endif
+#ifdef ENABLE_SPI1_DMA
+    else if ( (strcmp(argv[i], "-flash") == 0) && (i+1 < argc) )
+    {
+      flash_captures = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+#endif
+#ifdef ENABLE_WF_CODEC
+    else if ( (strcmp(argv[i], "-wfcodec") == 0) && (i+1 < argc) )
+    {
+      wfcodec_captures = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+#endif
+#if defined(ENABLE_EID_INDEX) && defined(ENABLE_SPI2_DMA)
+    else if ( (strcmp(argv[i], "-events") == 0) && (i+1 < argc) )
+    {
+      event_passes = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+#endif
+#if defined(ENABLE_EVENT_QUEUE) && defined(ENABLE_SPI2_DMA)
+    else if ( (strcmp(argv[i], "-evq") == 0) && (i+1 < argc) )
+    {
+      evq_bursts = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+#endif
+#ifdef ENABLE_SPI2_DMA
+    else if ( (strcmp(argv[i], "-evwc") == 0) && (i+1 < argc) )
+    {
+      evwc_bursts = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+#endif
+#ifdef ENABLE_CRC_SLICE
+    else if ( (strcmp(argv[i], "-crc") == 0) && (i+1 < argc) )
+    {
+      crc_trials = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+#endif
+    else if ( (strcmp(argv[i], "-dptx") == 0) && (i+1 < argc) )
+    {
+      dptx_trials = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else if ( (strcmp(argv[i], "-modb") == 0) && (i+1 < argc) )
+    {
+      modb_passes = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+#ifdef ENABLE_SEQ_PHASOR
+    else if ( (strcmp(argv[i], "-seq") == 0) && (i+1 < argc) )
+    {
+      seq_cycles = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+#endif
+#ifdef ENABLE_FREQ_TRACK
+    else if ( (strcmp(argv[i], "-freq") == 0) && (i+1 < argc) )
+    {
+      freq_cycles = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+#endif
+#ifdef ENABLE_CAM_SV_FRAME
+    else if ( (strcmp(argv[i], "-camsv") == 0) && (i+1 < argc) )
+    {
+      camsv_frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+#endif
+    else
+    {
+      fprintf(stderr, "Usage: %s [-synth | -eng <file> | -raw <file>] [-n <samples>]"
+                        " [-fault <sample> <mult>] [-harm <trials>] [-gather <trials>] [-sos <trials>]"
+                        " [-afeblk <trials>] [-sched <seconds>] [-flash <captures>]"
+                        " [-wfcodec <captures>] [-events <passes>] [-evq <bursts>] [-evwc <bursts>]"
+                        " [-crc <trials>] [-dptx <trials>] [-modb <passes>]"
+                        " [-seq <cycles>] [-freq <cycles>] [-camsv <frames>]\n",
+                argv[0]);
+      return (1);
+    }
+  }
+
+  if ( (harm_trials > 0) || (gather_trials > 0) || (sos_trials > 0) || (afeblk_trials > 0)
+    || (sched_secs > 0) || (flash_captures > 0) || (wfcodec_captures > 0) || (event_passes > 0)
+    || (evq_bursts > 0) || (evwc_bursts > 0) || (crc_trials > 0) || (dptx_trials > 0) || (modb_passes > 0)
+    || (seq_cycles > 0) || (freq_cycles > 0)
+    || (camsv_frames > 0) )
+  {
+    if (harm_trials > 0)
+    {
+      Replay_HarmBench(harm_trials, stdout);
+    }
+    if (gather_trials > 0)
+    {
+      Replay_GatherBench(gather_trials, stdout);
+    }
+#ifdef ENABLE_SIMD_SOS
+    if (sos_trials > 0)
+    {
+      Replay_SOSBench(sos_trials, stdout);
+    }
+#endif
+    if (afeblk_trials > 0)
+    {
+      Replay_AFEBlockBench(afeblk_trials, stdout);
+    }
+#ifdef ENABLE_MAIN_SCHED
+    if (sched_secs > 0)
+    {
+      Replay_SchedSim(sched_secs, stdout);
+    }
+#endif
+#ifdef ENABLE_SPI1_DMA
+    if (flash_captures > 0)
+    {
+      Replay_FlashBench(flash_captures, stdout);
+    }
+#endif
+#ifdef ENABLE_WF_CODEC
+    if (wfcodec_captures > 0)
+    {
+      Replay_WfCodecBench(wfcodec_captures, stdout);
+    }
+#endif
+#if defined(ENABLE_EID_INDEX) && defined(ENABLE_SPI2_DMA)
+    if (event_passes > 0)
+    {
+      Replay_EventBench(event_passes, stdout);
+    }
+#endif
+#if defined(ENABLE_EVENT_QUEUE) && defined(ENABLE_SPI2_DMA)
+    if (evq_bursts > 0)
+    {
+      Replay_EventQBench(evq_bursts, stdout);
+    }
+#endif
+#ifdef ENABLE_SPI2_DMA
+    if (evwc_bursts > 0)
+    {
+      Replay_EventWCBench(evwc_bursts, stdout);
+    }
+#endif
+#ifdef ENABLE_CRC_SLICE
+    if (crc_trials > 0)
+    {
+      Replay_CrcBench(crc_trials, stdout);
+    }
+#endif
+    if (dptx_trials > 0)
+    {
+      Replay_DPTxBench(dptx_trials, stdout);
+    }
+    if (modb_passes > 0)
+    {
+      Replay_ModbBench(modb_passes, stdout);
+    }
+#ifdef ENABLE_SEQ_PHASOR
+    if (seq_cycles > 0)
+    {
+      Replay_SeqBench(seq_cycles, stdout);
+    }
+#endif
+#ifdef ENABLE_FREQ_TRACK
+    if (freq_cycles > 0)
+    {
+      Replay_FreqBench(freq_cycles, stdout);
+    }
+#endif
+#ifdef ENABLE_CAM_SV_FRAME
+    if (camsv_frames > 0)
+    {
+      Replay_CamSvBench(camsv_frames, stdout);
+    }
+#endif
+    return (0);
+  }
+
+  if (!Replay_Open(src, filename))
+  {
+    fprintf(stderr, "HostReplay: unable to open %s\n", ((filename != NULL) ? filename : "source"));
+    return (1);
+  }
+
+  Replay_Run(num_samples);
+  Replay_Report(stdout);
+
+  return (0);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          main()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // HOST_BUILD
@@ -0,0 +1,995 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//                      gcc (x86-64 Linux) for the host build only
+//
+//  MODULE NAME:        HostReplay_Comm.c
+//
+//  MECHANICS:          Program module containing the communications benchmarks and checks for the host
+//                      (off-target) build.  This module is not part of the target project
+//                      (PXR35_ProtProc.ewp).  It is only compiled when HOST_BUILD is defined.
+//
+//                      With -crc, the sample stream is not run.  Instead, the slicing-by-8 CRC-16 (Crc.c) is
+//                      checked against the byte-wise CRC_TABLE1[] method for every message length up to the
+//                      display processor receive buffer size, and the two are timed, by Replay_CrcBench().
+//                      This option is only available if ENABLE_CRC_SLICE is defined.
+//                      With -dptx, the sample stream is not run.  Instead, the RTD buffer messages are
+//                      assembled by BuildRTDBufByTSlice() for each time slice, timed, and decoded and
+//                      checked, by Replay_DPTxBench().  Run it in builds with and without ENABLE_DP_TX_SG to
+//                      compare the scatter-gather packet encoder with the byte-at-a-time encoder.  If
+//                      ENABLE_DP_TX_SG is defined, the scatter-gather encoder is also checked against
+//                      AssembleTxPkt() with random data spans.
+//                      With -modb, the sample stream is not run.  Instead, Modbus FC03 read requests for the
+//                      maximum number of registers are made across the full register address space, timed,
+//                      and summed into a response checksum, by Replay_ModbBench().  Run it in builds with
+//                      and without ENABLE_MODB_REG_INDEX to compare the page-indexed address groups and
+//                      block encoder with the group scan.  The checksums must match.  If
+//                      ENABLE_MODB_RTD_CACHE is defined, the reads are from the real-time data cache.
+//                      With -camsv, the synthetic sample stream is run with both CAMs configured as
+//                      sampled-value CAMs, and the frames that the sampling interrupt sends are received
+//                      over a model of the CAM port links and checked, with and without stalls on the
+//                      links, by Replay_CamSvBench().  This option is only available if
+//                      ENABLE_CAM_SV_FRAME is defined.
+//
+//                      The options are parsed by main() in HostReplay.c.  The replay engine (Replay_Open(),
+//                      Replay_Sample()) and the timing and random number helpers (Replay_TimeStart(),
+//                      Replay_TimeStop(), Replay_Ratio(), Replay_RandF(), Replay_RandU()) are in
+//                      HostReplay.c.
+//
+//  TARGET HARDWARE:    None (host PC)
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   179    240302  DAH File Creation
+//                      - Moved Replay_CrcBench(), Replay_CrcRef(), Replay_DPTxBench(), Replay_DPTxDecode(),
+//                        Replay_ModbBench(), Replay_CamSvBench(), and Replay_CamSvLink() from HostReplay.c
+//                      - Revised the benchmarks to use Replay_TimeStart(), Replay_TimeStop(), Replay_Ratio(),
+//                        and Replay_RandU() in HostReplay.c
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+//
+//------------------------------------------------------------------------------------------------------------
+//
+#ifdef HOST_BUILD
+
+//------------------------------------------------------------------------------------------------------------
+//                   Definitions
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global Definitions from external files...
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "stm32f4xx.h"
+#include "stm32f407xx.h"
+#include "RealTime_def.h"
+#include "Iod_def.h"
+#include "Demand_def.h"
+#include "Intr_def.h"
+#include "Meter_def.h"
+#include "Events_def.h"
+#include "Setpnt_def.h"
+#include "FRAM_Flash_def.h"             // Must be preceded by Events_def.h and Setpnt_def.h!
+#include "Test_def.h"
+#include "Prot_def.h"
+#include "HostShim_def.h"
+#include "Sched_def.h"
+#include "HostReplay_def.h"             // Must be preceded by Sched_def.h!
+#include "DispComm_def.h"
+#include "Crc_def.h"
+#include "Modbus_def.h"
+#include "CAMCom_def.h"                 // Must be preceded by Iod_def.h!
+
+//
+//      Local Definitions used in this module...
+//
+
+
+//
+//      Global Declarations from external files...
+//
+#include "Iod_ext.h"
+#include "Intr_ext.h"
+#include "Meter_ext.h"
+#include "Setpnt_ext.h"
+#include "HostReplay_ext.h"
+#include "DispComm_ext.h"
+#include "Crc_ext.h"
+#include "Modbus_ext.h"
+#include "CAMCom_ext.h"
+
+// Modbus subroutines in Modbus.c.  On the target these are only called within Modbus.c
+extern uint16_t CalcCRC(uint8_t *msg_ptr, uint16_t len);
+extern void ProcFC0304Msg(uint8_t length, uint8_t fc);
+
+// Display processor packet subroutines in DispComm.c.  On the target these are only called within DispComm.c
+extern void AssembleTxPkt(uint8_t *SrcPtr, uint16_t SrcLen, struct DISPCOMMVARS *port, uint8_t LastSet);
+extern void BuildRTDBufByTSlice(uint8_t timeslice, uint8_t cmnd, uint8_t addr);
+#ifdef ENABLE_DP_TX_SG
+  extern void AssembleTxPktSG(const struct DP_TXSPAN *span, uint8_t num, struct DISPCOMMVARS *port,
+                              uint8_t LastSet);
+#endif
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global (Visible) Function Prototypes (These functions are called by other modules)
+//
+#ifdef ENABLE_CRC_SLICE
+  void Replay_CrcBench(uint32_t trials, FILE *fp);
+#endif
+void Replay_DPTxBench(uint32_t trials, FILE *fp);
+void Replay_ModbBench(uint32_t passes, FILE *fp);
+#ifdef ENABLE_CAM_SV_FRAME
+  void Replay_CamSvBench(uint32_t frames, FILE *fp);
+#endif
+
+
+//      Local Function Prototypes (These functions are called only within this module)
+//
+#ifdef ENABLE_CRC_SLICE
+  uint16_t Replay_CrcRef(const uint8_t *msg_ptr, uint16_t len);
+#endif
+uint16_t Replay_DPTxDecode(const uint8_t *pkt, uint16_t len, uint8_t *msg);
+#ifdef ENABLE_CAM_SV_FRAME
+  void Replay_CamSvLink(uint8_t port, uint8_t stalls);
+#endif
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Storage Allocation - Global (Static) Variables
+//------------------------------------------------------------------------------------------------------------
+//
+//       These variables are used by other modules...
+//
+
+//       These variables are used only in this module...
+//
+#ifdef ENABLE_CAM_SV_FRAME
+  struct REPLAY_CAMSV_LINK Replay_CamLink[2];         // CAM1 and CAM2 link and receiver models
+  struct RAM_SAMPLES Replay_CamSvLog[REPLAY_CAMSV_LOG];   // Sample sets that were buffered
+  uint32_t Replay_CamSvLogCnt;                        // Number of sample sets that were buffered
+#endif
+
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Global Constants used in this module and other modules
+//------------------------------------------------------------------------------------------------------------
+//
+
+
+
+#ifdef ENABLE_CRC_SLICE
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_CrcBench()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Check and Time the Slicing-by-8 CRC-16
+//
+//  MECHANICS:          This subroutine checks the CRC-16 in Crc.c against the byte-wise CRC_TABLE1[] method
+//                      (Replay_CrcRef(), the previous CalcCRC()), and compares their speed.
+//                      For each trial, a buffer is filled with random bytes, and the messages of every length
+//                      from 0 to DISPCOMM_RXBUFSIZE are checked.  The message starts at a different offset
+//                      (0 - 7) in each trial, so the unaligned cases are covered.  For each message:
+//                        - CalcCRC() (Modbus) must equal the reference
+//                        - The CRC computed in two parts with Crc16_Block() (the way AssembleTxPkt() does
+//                          each set of data), split at a random point, must equal the reference
+//                        - The CRC computed a byte at a time with CRC16_BYTE() (the way AssembleRxPkt()
+//                          does) must equal the reference
+//                        - The CRC of the message followed by its CRC bytes (ls byte first) must be zero,
+//                          which is how the received messages are checked
+//                      Then the time to compute the CRC of REPLAY_CRC_REPS messages is measured for both
+//                      methods, for the largest transmit message (DISPCOMM_TXBUFSIZE) and the largest
+//                      received message (DISPCOMM_RXBUFSIZE).
+//
+//  CAVEATS:            The times are host times.  They show the relative speed of the two methods, not the
+//                      time on the target.
+//
+//  INPUTS:             trials - number of passes over the message lengths
+//                      fp - output file
+//
+//  OUTPUTS:            The results are printed to fp
+//
+//  ALTERS:             None
+//
+//  CALLS:              srand(), Replay_RandU(), CalcCRC(), Crc16_Block(), Replay_CrcRef(), Replay_TimeStart(),
+//                      Replay_TimeStop(), Replay_Ratio(), fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_CrcBench(uint32_t trials, FILE *fp)
+{
+  uint8_t buf[DISPCOMM_RXBUFSIZE + 8 + 2];
+  uint8_t *mptr;
+  struct REPLAY_TIME ref_time, slice_time;
+  uint32_t t, n, checks, errs;
+  volatile uint16_t sink;
+  uint16_t len, split, ref, crc, k, sizes[2];
+  uint8_t sav[2], i;
+
+  srand(1);
+  checks = 0;
+  errs = 0;
+  for (t = 0; t < trials; ++t)
+  {
+    for (k = 0; k < sizeof(buf); ++k)
+    {
+      buf[k] = (uint8_t)Replay_RandU(0, 255);
+    }
+    mptr = &buf[t & 7];
+    for (len = 0; len <= DISPCOMM_RXBUFSIZE; ++len)
+    {
+      ref = Replay_CrcRef(mptr, len);
+      errs += (CalcCRC(mptr, len) != ref);
+      split = (uint16_t)Replay_RandU(0, len);
+      crc = Crc16_Block(CRC16_INIT, mptr, split);
+      errs += (Crc16_Block(crc, (mptr + split), (len - split)) != ref);
+      crc = CRC16_INIT;
+      for (k = 0; k < len; ++k)
+      {
+        crc = CRC16_BYTE(crc, mptr[k]);
+      }
+      errs += (crc != ref);
+      sav[0] = mptr[len];               // Append the CRC, check the message, then restore the buffer
+      sav[1] = mptr[len + 1];
+      mptr[len] = (uint8_t)ref;
+      mptr[len + 1] = (uint8_t)(ref >> 8);
+      errs += (Crc16_Block(CRC16_INIT, mptr, (len + 2)) != 0);
+      mptr[len] = sav[0];
+      mptr[len + 1] = sav[1];
+      checks += 4;
+    }
+  }
+  fprintf(fp, "CRC-16 check: %u trials, message lengths 0 - %u, %u checks, %u errors\n",
+              (unsigned int)trials, (unsigned int)DISPCOMM_RXBUFSIZE, (unsigned int)checks,
+              (unsigned int)errs);
+
+  sizes[0] = DISPCOMM_TXBUFSIZE;
+  sizes[1] = DISPCOMM_RXBUFSIZE;
+  for (i = 0; i < 2; ++i)
+  {
+    memset(&ref_time, 0, sizeof(ref_time));
+    memset(&slice_time, 0, sizeof(slice_time));
+    Replay_TimeStart(&ref_time);
+    for (n = 0; n < REPLAY_CRC_REPS; ++n)
+    {
+      buf[0] = (uint8_t)n;
+      sink = Replay_CrcRef(&buf[0], sizes[i]);
+    }
+    Replay_TimeStop(&ref_time);
+    Replay_TimeStart(&slice_time);
+    for (n = 0; n < REPLAY_CRC_REPS; ++n)
+    {
+      buf[0] = (uint8_t)n;
+      sink = Crc16_Block(CRC16_INIT, &buf[0], sizes[i]);
+    }
+    Replay_TimeStop(&slice_time);
+    fprintf(fp, "CRC-16 of %u bytes: byte-wise %.1f nsec (%.1f MB/s), slicing-by-8 %.1f nsec (%.1f MB/s),"
+                " %.2f times faster\n", (unsigned int)sizes[i], Replay_Ratio(ref_time.Nsec, REPLAY_CRC_REPS),
+                Replay_Ratio((1000.0 * sizes[i] * REPLAY_CRC_REPS), ref_time.Nsec),
+                Replay_Ratio(slice_time.Nsec, REPLAY_CRC_REPS),
+                Replay_Ratio((1000.0 * sizes[i] * REPLAY_CRC_REPS), slice_time.Nsec),
+                Replay_Ratio(ref_time.Nsec, slice_time.Nsec));
+  }
+  (void)sink;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_CrcBench()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_CrcRef()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Reference CRC-16
+//
+//  MECHANICS:          This subroutine computes the CRC-16 of a message a byte at a time with CRC_TABLE1[],
+//                      the same as CalcCRC() without ENABLE_CRC_SLICE
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             msg_ptr - starting address of the message
+//                      len - number of bytes
+//
+//  OUTPUTS:            Returns the CRC
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint16_t Replay_CrcRef(const uint8_t *msg_ptr, uint16_t len)
+{
+  uint16_t crc, nxt_char, i;
+
+  crc = 0xFFFF;
+  for (i = 0; i < len; ++i)
+  {
+    nxt_char = (crc ^ msg_ptr[i]) & 0x00FF;
+    crc = ((crc ^ CRC_TABLE1[nxt_char]) >> 8) + ((CRC_TABLE1[nxt_char] & 0x00FF) * 256);
+  }
+  return (crc);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_CrcRef()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_CRC_SLICE
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_DPTxBench()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Time and Check the Display Processor Packet Encoder
+//
+//  MECHANICS:          This subroutine measures the time to assemble the RTD buffer messages, and checks
+//                      the messages:
+//                        - If ENABLE_DP_TX_SG is defined, for each trial, REPLAY_DPTX_SETS sets of up to
+//                          REPLAY_DPTX_SPANS random data spans (up to REPLAY_DPTX_MAX_DATA bytes in all) are
+//                          encoded with AssembleTxPktSG() and with AssembleTxPkt() (one call per span), and
+//                          the two packets must be identical.  The chance that a byte is a delimiter (0 or 1)
+//                          changes from set to set (none, 1/64, 1/8, 1/2), so that long segments (xFF
+//                          segment codes), short segments, and spans that end in the middle of a segment are
+//                          all covered
+//                        - For each RTD time slice (0 - 6), BuildRTDBufByTSlice() is called
+//                          REPLAY_DPTX_REPS times and timed.  Time slices 4 and 5 rotate through three
+//                          buffers each.  Each message is decoded (Replay_DPTxDecode()), and the CRC must
+//                          check and the message length must match the buffer length in the header
+//                      Run the benchmark in builds with and without ENABLE_DP_TX_SG to compare the encoders.
+//
+//  CAVEATS:            The times are host times
+//
+//  INPUTS:             trials - number of random span trials
+//                      fp - output file
+//
+//  OUTPUTS:            The results are printed to fp
+//
+//  ALTERS:             DPComm, DPTxReqFlags, DP_Tmr4BufSel, DP_Tmr5BufSel
+//
+//  CALLS:              srand(), Replay_RandU(), AssembleTxPktSG(), AssembleTxPkt(), BuildRTDBufByTSlice(),
+//                      Replay_DPTxDecode(), CalcCRC(), Replay_TimeStart(), Replay_TimeStop(),
+//                      Replay_Ratio(), fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_DPTxBench(uint32_t trials, FILE *fp)
+{
+  uint8_t msg[DISPCOMM_TXBUFSIZE];
+  struct REPLAY_TIME msg_time;
+  uint32_t n, errs, maxlen;
+  uint16_t mlen;
+  uint8_t ts;
+#ifdef ENABLE_DP_TX_SG
+  uint8_t data[REPLAY_DPTX_MAX_DATA];
+  uint8_t pkt[DISPCOMM_TXBUFSIZE];
+  struct DP_TXSPAN span[REPLAY_DPTX_SPANS];
+  uint32_t t, set, checks;
+  uint16_t pktlen, total, k;
+  uint8_t nspan, odds;
+
+  // Random span sets - the scatter-gather encoder must give the same packet as AssembleTxPkt()
+  srand(1);
+  checks = 0;
+  errs = 0;
+  for (t = 0; t < trials; ++t)
+  {
+    for (set = 0; set < REPLAY_DPTX_SETS; ++set)
+    {
+      odds = ( ((set & 3) == 0) ? 0 : (((set & 3) == 1) ? 64 : (((set & 3) == 2) ? 8 : 2)) );
+      for (k = 0; k < REPLAY_DPTX_MAX_DATA; ++k)
+      {
+        data[k] = ( ((odds > 0) && (Replay_RandU(1, odds) == 1)) ? (uint8_t)Replay_RandU(0, 1)
+                                                                 : (uint8_t)Replay_RandU(2, 255) );
+      }
+      nspan = (uint8_t)Replay_RandU(1, REPLAY_DPTX_SPANS);
+      total = 0;
+      for (k = 0; k < nspan; ++k)
+      {
+        span[k].Ptr = &data[total];
+        span[k].Len = (uint16_t)Replay_RandU(0, (((REPLAY_DPTX_MAX_DATA / REPLAY_DPTX_SPANS) * 2) - 1));
+        total += span[k].Len;
+      }
+      if (total > REPLAY_DPTX_MAX_DATA)
+      {
+        continue;
+      }
+      DPComm.TxSegNdx = 1;
+      DPComm.TxSegCharCnt = 0;
+      DPComm.TxNdx = 2;
+      DPComm.TxCRC = 0xFFFF;
+      for (k = 0; k < nspan; ++k)
+      {
+        AssembleTxPkt(span[k].Ptr, span[k].Len, &DPComm, (k == (nspan - 1)));
+      }
+      pktlen = DPComm.TxNdx;
+      memcpy(&pkt[0], &DPComm.TxBuf[0], pktlen);
+      DPComm.TxSegNdx = 1;
+      DPComm.TxSegCharCnt = 0;
+      DPComm.TxNdx = 2;
+      DPComm.TxCRC = 0xFFFF;
+      AssembleTxPktSG(&span[0], nspan, &DPComm, TRUE);
+      if ( (DPComm.TxNdx != pktlen) || (memcmp(&pkt[2], &DPComm.TxBuf[2], (pktlen - 2)) != 0) )
+      {
+        ++errs;
+      }
+      ++checks;
+    }
+  }
+  fprintf(fp, "Scatter-gather encoder check: %u trials, %u span sets, %u errors\n", (unsigned int)trials,
+              (unsigned int)checks, (unsigned int)errs);
+#endif
+
+  // RTD buffer messages by time slice
+#ifdef ENABLE_DP_TX_SG
+  fprintf(fp, "RTD buffer messages (scatter-gather encoder):\n");
+#else
+  fprintf(fp, "RTD buffer messages (byte-at-a-time encoder):\n");
+#endif
+  for (ts = 0; ts < NUM_RTD_TIMESLICES; ++ts)
+  {
+    errs = 0;
+    maxlen = 0;
+    memset(&msg_time, 0, sizeof(msg_time));
+    for (n = 0; n < REPLAY_DPTX_REPS; ++n)
+    {
+      Replay_TimeStart(&msg_time);
+      BuildRTDBufByTSlice(ts, DP_CMND_WRWACK, 0x56);
+      Replay_TimeStop(&msg_time);
+      if (DPComm.TxNdx > maxlen)
+      {
+        maxlen = DPComm.TxNdx;
+      }
+      mlen = Replay_DPTxDecode(&DPComm.TxBuf[0], DPComm.TxNdx, &msg[0]);
+      if ( (mlen < 10) || (CalcCRC(&msg[0], mlen) != 0)
+        || (mlen != (msg[6] + (((uint16_t)msg[7]) << 8) + 10)) )
+      {
+        ++errs;
+      }
+    }
+    fprintf(fp, "  Time slice %u: %.1f host nsec per message, %u bytes max, %u errors\n", (unsigned int)ts,
+                Replay_Ratio(msg_time.Nsec, msg_time.Count), (unsigned int)maxlen, (unsigned int)errs);
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_DPTxBench()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_DPTxDecode()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Decode a Display Processor Packet
+//
+//  MECHANICS:          This subroutine decodes a transmitted packet the same way as AssembleRxPkt() does.
+//                      The packet must start with the start of packet char and end with the end of packet
+//                      char.  Each segment code gives the offset to the next segment code (b7..1).  If the
+//                      previous segment code was less than xFE, its b0 is the data value at the location of
+//                      the new segment code.
+//
+//  CAVEATS:            msg[] must have room for len bytes
+//
+//  INPUTS:             pkt[] - the packet
+//                      len - the number of bytes in the packet
+//
+//  OUTPUTS:            msg[] - the message, including the CRC bytes
+//                      Returns the number of bytes in the message, or 0 if the packet is not valid
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint16_t Replay_DPTxDecode(const uint8_t *pkt, uint16_t len, uint8_t *msg)
+{
+  uint16_t ndx, mlen;
+  uint8_t code, prev_code, offset;
+
+  if ( (len < 3) || (pkt[0] != START_OF_PKT) || (pkt[len - 1] != END_OF_PKT) )
+  {
+    return (0);
+  }
+  prev_code = 0xFF;
+  mlen = 0;
+  ndx = 1;
+  while (ndx < (len - 1))
+  {
+    code = pkt[ndx++];
+    offset = (code >> 1);
+    if (offset == 0)
+    {
+      return (0);
+    }
+    if ((prev_code & 0xFE) != 0xFE)
+    {
+      msg[mlen++] = (prev_code & 0x01);
+    }
+    prev_code = code;
+    while (--offset > 0)
+    {
+      if (ndx >= (len - 1))
+      {
+        return (0);
+      }
+      msg[mlen++] = pkt[ndx++];
+    }
+  }
+  return (mlen);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_DPTxDecode()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_ModbBench()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Time the Modbus Register Reads
+//
+//  MECHANICS:          This subroutine measures the Modbus FC03 read response rate across the full register
+//                      address space.  Each pass makes a read request for REPLAY_MODB_REGS registers
+//                      starting at every REPLAY_MODB_STEP'th register address (0 - 65535), so that all of
+//                      the address groups, the gaps between them, and both even and odd starting addresses
+//                      are covered.  The passes alternate between the forgiving and unforgiving invalid
+//                      object modes and the two word orders.  The time in ProcFC0304Msg() is measured, and
+//                      the CRCs of the responses are summed into a checksum.
+//                      Run the benchmark in builds with and without ENABLE_MODB_REG_INDEX.  The response
+//                      checksums must be the same.
+//                      If ENABLE_MODB_RTD_CACHE is defined, the cache is refreshed at the start of each
+//                      pass (after the setpoints are changed), and the refresh is timed separately.
+//
+//  CAVEATS:            The times are host times.  The real-time data values are whatever they were left at,
+//                      so the checksums only match for the same command line
+//
+//  INPUTS:             passes - number of passes through the address space
+//                      fp - output file
+//
+//  OUTPUTS:            The results are printed to fp
+//
+//  ALTERS:             ModB, Setpoints2.stp.Modbus_RTU_xx (restored when done)
+//
+//  CALLS:              Modb_VarInit(), Modb_RtdCacheRefresh(), ProcFC0304Msg(), Replay_TimeStart(),
+//                      Replay_TimeStop(), Replay_Ratio(), fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_ModbBench(uint32_t passes, FILE *fp)
+{
+  struct REPLAY_TIME rsp_time;
+  uint32_t p, reqs, naks, sum, addr;
+  uint16_t inval_save, fixed_save, float_save;
+#ifdef ENABLE_MODB_RTD_CACHE
+  struct REPLAY_TIME refresh_time;
+#endif
+
+  inval_save = Setpoints2.stp.Modbus_RTU_Inval_Obj_Handling;
+  fixed_save = Setpoints2.stp.Modbus_RTU_Fixed_Pt_Word_Order;
+  float_save = Setpoints2.stp.Modbus_RTU_Floating_Pt_Word_Order;
+  Modb_VarInit(TRUE);
+
+  reqs = 0;
+  naks = 0;
+  sum = 0;
+  memset(&rsp_time, 0, sizeof(rsp_time));
+#ifdef ENABLE_MODB_RTD_CACHE
+  memset(&refresh_time, 0, sizeof(refresh_time));
+#endif
+  for (p = 0; p < passes; ++p)
+  {
+    Setpoints2.stp.Modbus_RTU_Inval_Obj_Handling = (p & 1);
+    Setpoints2.stp.Modbus_RTU_Fixed_Pt_Word_Order = ((p >> 1) & 1);
+    Setpoints2.stp.Modbus_RTU_Floating_Pt_Word_Order = ((p >> 1) & 1);
+#ifdef ENABLE_MODB_RTD_CACHE
+    Replay_TimeStart(&refresh_time);
+    Modb_RtdCacheRefresh();
+    Replay_TimeStop(&refresh_time);
+#endif
+    for (addr = 0; addr < 65536; addr += REPLAY_MODB_STEP)
+    {
+      ModB.RxMsgBuf[0] = Setpoints2.stp.Modbus_Port_Addr;
+      ModB.RxMsgBuf[1] = 3;
+      ModB.RxMsgBuf[2] = (uint8_t)(addr >> 8);
+      ModB.RxMsgBuf[3] = (uint8_t)(addr);
+      ModB.RxMsgBuf[4] = 0;
+      ModB.RxMsgBuf[5] = REPLAY_MODB_REGS;
+      Replay_TimeStart(&rsp_time);
+      ProcFC0304Msg(8, 3);
+      Replay_TimeStop(&rsp_time);
+      if ((ModB.TxMsgBuf[1] & 0x80) != 0)
+      {
+        ++naks;
+      }
+      // The last two chars are the CRC of the response
+      sum = ( (sum << 1) | (sum >> 31) ) ^ ModB.TxMsgBuf[ModB.CharsToTx - 2]
+                                          ^ (((uint32_t)ModB.TxMsgBuf[ModB.CharsToTx - 1]) << 8);
+      ++reqs;
+    }
+  }
+
+  Setpoints2.stp.Modbus_RTU_Inval_Obj_Handling = inval_save;
+  Setpoints2.stp.Modbus_RTU_Fixed_Pt_Word_Order = fixed_save;
+  Setpoints2.stp.Modbus_RTU_Floating_Pt_Word_Order = float_save;
+
+#if defined(ENABLE_MODB_RTD_CACHE)
+  fprintf(fp, "Modbus FC03 reads (page index and real-time data cache):\n");
+#elif defined(ENABLE_MODB_REG_INDEX)
+  fprintf(fp, "Modbus FC03 reads (page index and block encoder):\n");
+#else
+  fprintf(fp, "Modbus FC03 reads (group scan):\n");
+#endif
+  fprintf(fp, "  %u requests of %u registers, %u NAKs, checksum %08X\n", (unsigned int)reqs,
+              (unsigned int)REPLAY_MODB_REGS, (unsigned int)naks, (unsigned int)sum);
+  fprintf(fp, "  %.1f host nsec per response, %.0f responses per second\n",
+              Replay_Ratio(rsp_time.Nsec, reqs), Replay_Ratio((1.0e9 * reqs), rsp_time.Nsec));
+#ifdef ENABLE_MODB_RTD_CACHE
+  fprintf(fp, "  %.1f host nsec per cache refresh\n", Replay_Ratio(refresh_time.Nsec, refresh_time.Count));
+#endif
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_ModbBench()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+#ifdef ENABLE_CAM_SV_FRAME
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_CamSvBench()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Check the CAM Sampled-Value Frames over a Loopback Link
+//
+//  MECHANICS:          This subroutine checks the sampled-value frames (ENABLE_CAM_SV_FRAME defined) that
+//                      the sampling interrupt sends to the CAM ports.  CAM1 and CAM2 are both configured as
+//                      sampled-value CAMs, and the synthetic sample stream is run through the sampling
+//                      interrupts until the given number of frames have been started on CAM1.
+//                      After each sample:
+//                        - The sample set that was just buffered is saved in Replay_CamSvLog[], the samples
+//                          that the frames are checked against
+//                        - Replay_CamSvLink() models each CAM port's DMA stream and UART.  It moves the bytes
+//                          that the UART could send in one sample time into a receive buffer, and sets the
+//                          DMA transfer complete flag when the frame is done.  A receiver model then parses
+//                          the frames out of the received bytes and checks them
+//                      The benchmark is run twice.  In the first pass, the link runs at REPLAY_CAMSV_BAUD,
+//                      and every frame must be received good, in sequence, and with the samples that were
+//                      buffered.  In the second pass, about one frame in REPLAY_CAMSV_STALL_ODDS is held up
+//                      on the link for REPLAY_CAMSV_STALL samples, so that it cannot finish before the next
+//                      frame is ready.  The sampling interrupt must abort these frames and count them in
+//                      CAMSvPub.Drops[], and the receiver must see them as gaps in the sequence numbers,
+//                      while the frames that are not dropped are still received intact.
+//                      The link utilization (bytes sent / bytes that could be sent) and the average time of
+//                      the sampling interrupts are printed for each pass.  The other anniversary
+//                      subroutines are not run.
+//
+//  CAVEATS:            The DMA transfer complete flags are set and cleared by the link model, since the
+//                      flag clear register (DMA2->HIFCR) is just RAM in the host build
+//
+//  INPUTS:             frames - number of frames to send in each pass
+//                      fp - output file
+//                      CAMSvPub, SampleBuf[], SampleIndex
+//
+//  OUTPUTS:            The results are printed to fp
+//
+//  ALTERS:             CAM1.Status and CAM2.Status (restored), CAMSvPub, Replay_CamLink[],
+//                      Replay_CamSvLog[], Replay_CamSvLogCnt, OneCycAnniv, msec200Anniv, OneSecAnniv
+//
+//  CALLS:              Replay_Open(), Replay_Sample(), CAM_SV_VarInit(), Replay_CamSvLink(), srand(),
+//                      Replay_Ratio(), memset(), fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_CamSvBench(uint32_t frames, FILE *fp)
+{
+  struct RAM_SAMPLES *rptr;
+  uint64_t nsec, samples;
+  uint32_t drain;
+  uint16_t ndx;
+  uint8_t pass, port, cam_status[2];
+
+  cam_status[0] = CAM1.Status;
+  cam_status[1] = CAM2.Status;
+
+  for (pass=0; pass<2; ++pass)
+  {
+    Replay_Open(REPLAY_SRC_SYNTH, NULL);
+    CAM_SV_VarInit();
+    CAM1.Status = CAM_FIRST_SAMPLE + CAM_TYPE_SAMPLE;
+    CAM2.Status = CAM_FIRST_SAMPLE + CAM_TYPE_SAMPLE;
+    DMA2_Stream7->CR &= 0xFFFFFFFE;
+    DMA2_Stream6->CR &= 0xFFFFFFFE;
+    DMA2->HISR &= ~(DMA_HISR_TCIF7 + DMA_HISR_TCIF6);
+    memset(Replay_CamLink, 0, sizeof(Replay_CamLink));
+    Replay_CamSvLogCnt = 0;
+    srand(1);
+    nsec = ReplayStats.SampleNsec;
+    samples = ReplayStats.Samples;
+
+    while (CAMSvPub.Frames[0] < frames)
+    {
+      ndx = SampleIndex;
+      if (!Replay_Sample())
+      {
+        break;
+      }
+      if (SampleIndex != ndx)                     // Save the sample set that was buffered
+      {
+        rptr = &Replay_CamSvLog[Replay_CamSvLogCnt & (REPLAY_CAMSV_LOG - 1)];
+        rptr->Ia = SAMPLEBUF(Ia, ndx);
+        rptr->Ib = SAMPLEBUF(Ib, ndx);
+        rptr->Ic = SAMPLEBUF(Ic, ndx);
+        rptr->In = SAMPLEBUF(In, ndx);
+        rptr->Igsrc = SAMPLEBUF(Igsrc, ndx);
+        rptr->Igres = SAMPLEBUF(Igres, ndx);
+        rptr->VanAFE = SAMPLEBUF(VanAFE, ndx);
+        rptr->VbnAFE = SAMPLEBUF(VbnAFE, ndx);
+        rptr->VcnAFE = SAMPLEBUF(VcnAFE, ndx);
+        rptr->VanADC = SAMPLEBUF(VanADC, ndx);
+        rptr->VbnADC = SAMPLEBUF(VbnADC, ndx);
+        rptr->VcnADC = SAMPLEBUF(VcnADC, ndx);
+        ++Replay_CamSvLogCnt;
+      }
+      OneCycAnniv = FALSE;
+      msec200Anniv = FALSE;
+      OneSecAnniv = FALSE;
+      for (port=0; port<2; ++port)
+      {
+        Replay_CamSvLink(port, pass);
+      }
+    }
+    nsec = ReplayStats.SampleNsec - nsec;
+    samples = ReplayStats.Samples - samples;
+
+    // Let the last frame finish, with no more stalls
+    for (drain=0; drain<(REPLAY_CAMSV_STALL + CAMSV_SAMPLES); ++drain)
+    {
+      for (port=0; port<2; ++port)
+      {
+        Replay_CamSvLink(port, FALSE);
+      }
+    }
+
+    fprintf(fp, "CAM sampled-value frames, %s: %u samples, %u frames of %u bytes, link %.1f%% busy,"
+                " %.0f nsec per sampling interrupt\n", ((pass == 0) ? "full rate" : "with link stalls"),
+                (unsigned int)samples, (unsigned int)CAMSvPub.SeqNum, (unsigned int)CAMSV_FRAME_BYTES,
+                100.0 * (double)CAMSvPub.Frames[0] * (double)CAMSV_FRAME_BYTES * 10.0
+                  / ((double)samples * (double)REPLAY_CAMSV_BAUD / (double)REPLAY_SAMPLE_RATE),
+                Replay_Ratio(nsec, samples));
+    for (port=0; port<2; ++port)
+    {
+      fprintf(fp, "  CAM%u: %u sent, %u dropped, %u received good, %u bad CRC, %u missing, %u errors\n",
+                  (unsigned int)(port + 1), (unsigned int)CAMSvPub.Frames[port],
+                  (unsigned int)CAMSvPub.Drops[port], (unsigned int)Replay_CamLink[port].Good,
+                  (unsigned int)Replay_CamLink[port].Bad, (unsigned int)Replay_CamLink[port].Missing,
+                  (unsigned int)Replay_CamLink[port].Errs);
+    }
+  }
+
+  CAM1.Status = cam_status[0];
+  CAM2.Status = cam_status[1];
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_CamSvBench()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_CamSvLink()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Model a CAM Port Link and Receiver for One Sample Time
+//
+//  MECHANICS:          This subroutine models one CAM port for one sample time, for Replay_CamSvBench().
+//                      The port's transmit DMA stream (DMA2 Stream7 for CAM1, Stream6 for CAM2) and UART:
+//                        - If the stream is enabled with a new memory address, a new transfer has been
+//                          started (the previous transfer, if it had not finished, was aborted).  The
+//                          transfer complete flag is cleared, and in the second pass, the link may be held
+//                          up for REPLAY_CAMSV_STALL samples
+//                        - Unless the link is held up, the bytes that the UART can send in one sample time
+//                          are moved from the frame into RxBuf[], and NDTR is decremented.  When NDTR
+//                          reaches zero, the stream is disabled and the transfer complete flag is set
+//                      The receiver parses the frames out of RxBuf[].  It looks for the sync word and the
+//                      number of sample sets, and checks the CRC over the frame (zero if good).  If the
+//                      header or the CRC is bad, it moves on one byte.  For a good frame, it checks that
+//                      the sequence number is not lower than expected (a higher number counts the missing
+//                      frames), that the time stamp did not go backwards, and that the sample sets match
+//                      the sample sets that were buffered (Replay_CamSvLog[]).
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             port - 0 = CAM1, 1 = CAM2
+//                      stalls - TRUE if frames may be held up on the link
+//                      DMA2_Stream7, DMA2_Stream6, CAMSvPub.Frame[], Replay_CamSvLog[], Replay_CamSvLogCnt
+//
+//  OUTPUTS:            Replay_CamLink[port]
+//
+//  ALTERS:             DMA2_Stream7->CR, DMA2_Stream7->NDTR, DMA2_Stream6->CR, DMA2_Stream6->NDTR,
+//                      DMA2->HISR
+//
+//  CALLS:              Replay_RandU(), Crc16_Block(), memcpy(), memcmp(), memmove()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_CamSvLink(uint8_t port, uint8_t stalls)
+{
+  struct REPLAY_CAMSV_LINK *lptr;
+  struct CAM_SV_FRAME frame;
+  DMA_Stream_TypeDef *stream;
+  const uint8_t *src;
+  uint32_t tcif, n;
+  uint16_t ndx;
+  uint8_t k;
+
+  lptr = &Replay_CamLink[port];
+  stream = ( (port == 0) ? DMA2_Stream7 : DMA2_Stream6 );
+  tcif = ( (port == 0) ? DMA_HISR_TCIF7 : DMA_HISR_TCIF6 );
+
+  // DMA stream and UART
+  if ( (stream->CR & 0x00000001) && (stream->M0AR != lptr->M0AR) )
+  {
+    lptr->M0AR = stream->M0AR;
+    lptr->Len = (uint16_t)stream->NDTR;
+    lptr->Left = lptr->Len;
+    lptr->Credit = 0;
+    DMA2->HISR &= ~tcif;
+    if ( stalls && (Replay_RandU(1, REPLAY_CAMSV_STALL_ODDS) == 1) )
+    {
+      lptr->Stall = REPLAY_CAMSV_STALL;
+    }
+  }
+  else if (!(stream->CR & 0x00000001))
+  {
+    lptr->Left = 0;
+  }
+  src = NULL;
+  for (k=0; k<2; ++k)
+  {
+    if (lptr->M0AR == (uint32_t)(uintptr_t)(&CAMSvPub.Frame[k]))
+    {
+      src = (const uint8_t *)(&CAMSvPub.Frame[k]);
+    }
+  }
+  if (lptr->Stall > 0)
+  {
+    --lptr->Stall;
+  }
+  else if ( (lptr->Left > 0) && (src != NULL) )
+  {
+    lptr->Credit += (double)REPLAY_CAMSV_BAUD / (10.0 * (double)REPLAY_SAMPLE_RATE);
+    while ( (lptr->Credit >= 1.0) && (lptr->Left > 0) )
+    {
+      if (lptr->RxLen < REPLAY_CAMSV_RXBUF)
+      {
+        lptr->RxBuf[lptr->RxLen++] = src[lptr->Len - lptr->Left];
+      }
+      --lptr->Left;
+      lptr->Credit -= 1.0;
+    }
+    stream->NDTR = lptr->Left;
+    if (lptr->Left == 0)
+    {
+      stream->CR &= 0xFFFFFFFE;
+      DMA2->HISR |= tcif;
+    }
+  }
+
+  // Receiver
+  ndx = 0;
+  while ((lptr->RxLen - ndx) >= CAMSV_FRAME_BYTES)
+  {
+    if ( (lptr->RxBuf[ndx] != (CAMSV_SYNC & 0xFF)) || (lptr->RxBuf[ndx+1] != (CAMSV_SYNC >> 8))
+      || (lptr->RxBuf[ndx+2] != CAMSV_SAMPLES) )
+    {
+      ++ndx;
+      continue;
+    }
+    if (Crc16_Block(CRC16_INIT, &lptr->RxBuf[ndx], CAMSV_FRAME_BYTES) != 0)
+    {
+      ++lptr->Bad;
+      ++ndx;
+      continue;
+    }
+    memcpy(&frame, &lptr->RxBuf[ndx], CAMSV_FRAME_BYTES);
+    ndx += CAMSV_FRAME_BYTES;
+    ++lptr->Good;
+    if (frame.SeqNum < lptr->NextSeq)
+    {
+      ++lptr->Errs;
+    }
+    else
+    {
+      lptr->Missing += frame.SeqNum - lptr->NextSeq;
+    }
+    lptr->NextSeq = frame.SeqNum + 1;
+    if ( (frame.TS_secs < lptr->LastSecs)
+      || ((frame.TS_secs == lptr->LastSecs) && (frame.TS_nsec < lptr->LastNsec)) )
+    {
+      ++lptr->Errs;
+    }
+    lptr->LastSecs = frame.TS_secs;
+    lptr->LastNsec = frame.TS_nsec;
+    for (k=0; k<CAMSV_SAMPLES; ++k)
+    {
+      n = (frame.SeqNum * CAMSV_SAMPLES) + k;
+      if ( (n >= Replay_CamSvLogCnt) || ((Replay_CamSvLogCnt - n) > REPLAY_CAMSV_LOG)
+        || (memcmp(&frame.Samples[k][0], &Replay_CamSvLog[n & (REPLAY_CAMSV_LOG - 1)],
+                   CAMSV_SAMPLE_BYTES) != 0) )
+      {
+        ++lptr->Errs;
+        break;
+      }
+    }
+  }
+  memmove(&lptr->RxBuf[0], &lptr->RxBuf[ndx], (lptr->RxLen - ndx));
+  lptr->RxLen -= ndx;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_CamSvLink()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_CAM_SV_FRAME
+
+#endif                  // HOST_BUILD
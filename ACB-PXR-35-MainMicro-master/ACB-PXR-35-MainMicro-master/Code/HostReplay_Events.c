@@ -0,0 +1,716 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//                      gcc (x86-64 Linux) for the host build only
+//
+//  MODULE NAME:        HostReplay_Events.c
+//
+//  MECHANICS:          Program module containing the event log benchmarks and checks for the host
+//                      (off-target) build.  This module is not part of the target project
+//                      (PXR35_ProtProc.ewp).  It is only compiled when HOST_BUILD is defined.
+//
+//                      With -events, the sample stream is not run.  Instead, a full Summary log is written
+//                      to the FRAM model, and the EID lookups and the display processor's Summary log reads
+//                      are timed with the RAM EID index, by Replay_EventBench().  This option is only
+//                      available if ENABLE_EID_INDEX and ENABLE_SPI2_DMA are defined.
+//                      With -evq, the sample stream is not run.  Instead, events are inserted from a second
+//                      thread that models an interrupt, while the foreground inserts its own events and runs
+//                      the event manager, and every event is checked to be either logged or counted as
+//                      dropped, by Replay_EventQBench().  This option is only available if
+//                      ENABLE_EVENT_QUEUE and ENABLE_SPI2_DMA are defined.  Link with -pthread.
+//                      With -evwc, the sample stream is not run.  Instead, bursts of Summary log events are
+//                      written to the FRAM model through the event manager, and the FRAM writes are timed,
+//                      by Replay_EventWCBench().  Run it in builds with and without ENABLE_EVENT_WC to
+//                      compare the event log write combining with the separate writes.  This option is only
+//                      available if ENABLE_SPI2_DMA is defined.
+//
+//                      The options are parsed by main() in HostReplay.c.  The replay engine (Replay_Open(),
+//                      Replay_Sample()) and the timing and random number helpers (Replay_TimeStart(),
+//                      Replay_TimeStop(), Replay_Ratio(), Replay_RandF(), Replay_RandU()) are in
+//                      HostReplay.c.
+//
+//  TARGET HARDWARE:    None (host PC)
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   179    240302  DAH File Creation
+//                      - Moved Replay_EventBench(), Replay_EventQBench(), Replay_EventQIsr(), and
+//                        Replay_EventWCBench() from HostReplay.c
+//                      - Revised the benchmarks to use Replay_TimeStart(), Replay_TimeStop(), Replay_Ratio(),
+//                        and Replay_RandU() in HostReplay.c
+//                      - Added Replay_EventLogClear() and Replay_EventLogCheck(), for the code that was
+//                        repeated in the benchmarks
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+//
+//------------------------------------------------------------------------------------------------------------
+//
+#ifdef HOST_BUILD
+
+//------------------------------------------------------------------------------------------------------------
+//                   Definitions
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global Definitions from external files...
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include "stm32f4xx.h"
+#include "stm32f407xx.h"
+#include "RealTime_def.h"
+#include "Iod_def.h"
+#include "Demand_def.h"
+#include "Intr_def.h"
+#include "Meter_def.h"
+#include "Events_def.h"
+#include "Setpnt_def.h"
+#include "FRAM_Flash_def.h"             // Must be preceded by Events_def.h and Setpnt_def.h!
+#include "Test_def.h"
+#include "Prot_def.h"
+#include "HostShim_def.h"
+#include "Sched_def.h"
+#include "HostReplay_def.h"             // Must be preceded by Sched_def.h!
+
+//
+//      Local Definitions used in this module...
+//
+
+
+//
+//      Global Declarations from external files...
+//
+#include "Iod_ext.h"
+#include "Events_ext.h"
+#include "HostReplay_ext.h"
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global (Visible) Function Prototypes (These functions are called by other modules)
+//
+#if defined(ENABLE_EID_INDEX) && defined(ENABLE_SPI2_DMA)
+  void Replay_EventBench(uint32_t passes, FILE *fp);
+#endif
+#if defined(ENABLE_EVENT_QUEUE) && defined(ENABLE_SPI2_DMA)
+  void Replay_EventQBench(uint32_t bursts, FILE *fp);
+#endif
+#ifdef ENABLE_SPI2_DMA
+  void Replay_EventWCBench(uint32_t bursts, FILE *fp);
+#endif
+
+
+//      Local Function Prototypes (These functions are called only within this module)
+//
+#if defined(ENABLE_EVENT_QUEUE) && defined(ENABLE_SPI2_DMA)
+  void *Replay_EventQIsr(void *arg);
+#endif
+#ifdef ENABLE_SPI2_DMA
+  void Replay_EventLogClear(void);
+  uint32_t Replay_EventLogCheck(const uint16_t *codes, uint8_t num_codes);
+#endif
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Storage Allocation - Global (Static) Variables
+//------------------------------------------------------------------------------------------------------------
+//
+//       These variables are used by other modules...
+//
+
+//       These variables are used only in this module...
+//
+
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Global Constants used in this module and other modules
+//------------------------------------------------------------------------------------------------------------
+//
+
+
+
+#if defined(ENABLE_EID_INDEX) && defined(ENABLE_SPI2_DMA)
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_EventBench()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Event Log EID Lookup Benchmark
+//
+//  MECHANICS:          This subroutine measures the event log EID lookups with the RAM EID index:
+//                        - The Summary log is filled through the event code (InsertNewEvent() and
+//                          EventManager()) until it has rolled over, with random gaps in the EIDs (the
+//                          other logs use EIDs too)
+//                        - Every EID from before the earliest entry to after the latest entry is looked up
+//                          with the index (EventLookUp()) and in FRAM (EventLookUpFRAM()), and the results
+//                          are compared.  This is done with the index that was kept up to date as the
+//                          entries were written, and again after the index has been rebuilt from FRAM
+//                          (EventIndexInit()), as after a reset
+//                        - The display processor's paging is replayed the given number of times: the whole
+//                          log is read 20 entries at a time with EventSummaryRead(), by index and by EID
+//                      For the lookups and the page reads, the average number of FRAM transactions, SPI2 bus
+//                      time (FRAM model), and host time are printed.
+//
+//  CAVEATS:            Only included if ENABLE_EID_INDEX and ENABLE_SPI2_DMA are defined.
+//                      The Summary log in the FRAM model, EV_Sum, and EventMasterEID are overwritten.
+//
+//  INPUTS:             passes - the number of times to page through the log
+//                      fp - the output stream
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             EventMasterEID, EV_Sum, the event FIFO, Host_FramBusyCyc, Host_FramXacts
+//
+//  CALLS:              srand(), Replay_EventLogClear(), Replay_RandU(), InsertNewEvent(), EventManager(),
+//                      EventLookUp(), EventLookUpFRAM(), EventIndexInit(), EventSummaryRead(),
+//                      Replay_TimeStart(), Replay_TimeStop(), Replay_Ratio(), fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_EventBench(uint32_t passes, FILE *fp)
+{
+  struct REPLAY_TIME host_time[REPLAY_EVB_NUM];
+  uint64_t busy[REPLAY_EVB_NUM];
+  uint32_t xacts[REPLAY_EVB_NUM];
+  uint32_t n, eid, first_eid, last_eid, mismatches[2];
+  uint16_t page, ofs;
+  uint8_t req[6], num, k, which;
+  int16_t ndx;
+
+  static const char * const REPLAY_EVB_NAME[REPLAY_EVB_NUM] =
+        {"Lookup (RAM index)", "Lookup (FRAM search)", "Page read by index", "Page read by EID"};
+
+  memset(&busy[0], 0, sizeof(busy));
+  memset(&host_time[0], 0, sizeof(host_time));
+  memset(&xacts[0], 0, sizeof(xacts));
+  srand(1);
+
+  // Fill the Summary log past rollover.  The log starts out empty, so the old entries in the FRAM model are
+  //   not used
+  Replay_EventLogClear();
+  for (n=0; n<REPLAY_EVB_EVENTS; ++n)
+  {
+    EventMasterEID += Replay_RandU(0, 2);
+    InsertNewEvent( ((n & 1) ? EXIT_MAINTENANCE_MODE : ENTER_MAINTENANCE_MODE) );
+    EventManager();
+  }
+  last_eid = EventMasterEID - 1;
+  first_eid = last_eid;
+  for (eid = 1; eid < last_eid; ++eid)
+  {
+    if (EventLookUp(eid, EV_TYPE_SUMMARY) >= 0)
+    {
+      first_eid = eid;
+      break;
+    }
+  }
+
+  // Compare the index and FRAM lookups, with the index kept up to date and with it rebuilt from FRAM
+  for (k=0; k<2; ++k)
+  {
+    if (k == 1)
+    {
+      EventIndexInit();
+    }
+    mismatches[k] = 0;
+    for (eid = ((first_eid > REPLAY_EVB_MARGIN) ? (first_eid - REPLAY_EVB_MARGIN) : 0);
+         eid <= (last_eid + REPLAY_EVB_MARGIN); ++eid)
+    {
+      for (which = REPLAY_EVB_RAM; which <= REPLAY_EVB_FRAM; ++which)
+      {
+        xacts[which] -= Host_FramXacts;
+        busy[which] -= Host_FramBusyCyc;
+        Replay_TimeStart(&host_time[which]);
+        if (which == REPLAY_EVB_RAM)
+        {
+          ndx = EventLookUp(eid, EV_TYPE_SUMMARY);
+        }
+        else
+        {
+          mismatches[k] += (ndx != EventLookUpFRAM(eid, EV_TYPE_SUMMARY));
+        }
+        Replay_TimeStop(&host_time[which]);
+        xacts[which] += Host_FramXacts;
+        busy[which] += Host_FramBusyCyc;
+      }
+    }
+  }
+
+  // Page through the log, newest entries first, 20 at a time.  The page read by EID asks for the page that
+  //   ends with the newest entry of the page that was just read by index
+  for (n=0; n<passes; ++n)
+  {
+    for (page = 0; page < EV_Sum.Num_Events; page += 20)
+    {
+      req[0] = (uint8_t)page;
+      req[1] = (uint8_t)(page >> 8);
+      req[2] = 20;
+      xacts[REPLAY_EVB_PG_NDX] -= Host_FramXacts;
+      busy[REPLAY_EVB_PG_NDX] -= Host_FramBusyCyc;
+      Replay_TimeStart(&host_time[REPLAY_EVB_PG_NDX]);
+      EventSummaryRead(3, &req[0], &num);
+      Replay_TimeStop(&host_time[REPLAY_EVB_PG_NDX]);
+      xacts[REPLAY_EVB_PG_NDX] += Host_FramXacts;
+      busy[REPLAY_EVB_PG_NDX] += Host_FramBusyCyc;
+      if (num == 0)
+      {
+        break;
+      }
+
+      ofs = 8 + ((num - 1) * SUMMARY_EVENT_SIZE);                    // Newest entry of the page
+      memcpy(&req[0], &SPI2_buf[ofs], 4);
+      req[4] = 20;
+      req[5] = 20;
+      xacts[REPLAY_EVB_PG_EID] -= Host_FramXacts;
+      busy[REPLAY_EVB_PG_EID] -= Host_FramBusyCyc;
+      Replay_TimeStart(&host_time[REPLAY_EVB_PG_EID]);
+      EventSummaryRead(5, &req[0], &num);
+      Replay_TimeStop(&host_time[REPLAY_EVB_PG_EID]);
+      xacts[REPLAY_EVB_PG_EID] += Host_FramXacts;
+      busy[REPLAY_EVB_PG_EID] += Host_FramBusyCyc;
+    }
+  }
+
+  fprintf(fp, "Event EID index: Summary log %u entries (EIDs %u - %u), index/FRAM lookup mismatches %u"
+              " (kept up to date), %u (rebuilt)\n", (unsigned int)EV_Sum.Num_Events,
+              (unsigned int)first_eid, (unsigned int)last_eid, (unsigned int)mismatches[0],
+              (unsigned int)mismatches[1]);
+  fprintf(fp, "Operation              Calls  FRAM xacts/call  SPI2 usec/call  Host nsec/call\n");
+  for (which = 0; which < REPLAY_EVB_NUM; ++which)
+  {
+    if (host_time[which].Count == 0)
+    {
+      continue;
+    }
+    fprintf(fp, "%-21s %6u %16.2f %15.2f %15.1f\n", REPLAY_EVB_NAME[which],
+              (unsigned int)host_time[which].Count,
+              Replay_Ratio(xacts[which], host_time[which].Count),
+              Replay_Ratio(busy[which], (host_time[which].Count * (double)SCHED_CYC_PER_USEC)),
+              Replay_Ratio(host_time[which].Nsec, host_time[which].Count));
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_EventBench()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_EID_INDEX && ENABLE_SPI2_DMA
+
+
+
+#if defined(ENABLE_EVENT_QUEUE) && defined(ENABLE_SPI2_DMA)
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_EventQBench()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Event Queue Stress Test
+//
+//  MECHANICS:          This subroutine stresses the event queue with events from a simulated interrupt:
+//                        - Replay_EventQIsr() runs in a second thread, as the interrupt, and fires the
+//                          given number of bursts of events with InsertNewEvent().  Every
+//                          REPLAY_EVQ_STORM_EVERY'th burst is larger than the interrupt event buffer
+//                        - While a burst is being fired, the foreground runs EventManager() and inserts a few
+//                          events of its own.  After the burst, the foreground runs EventManager() until the
+//                          queue is empty, then lets the interrupt fire the next burst
+//                      The two threads really do run at the same time, so this exercises the claims and the
+//                      sequence numbers of the interrupt event buffer harder than the target can.
+//                      All of the events go into the Summary log, so every EID that is issued is logged.
+//                      The results are checked:
+//                        - The EIDs issued must equal the interrupt events that were not dropped, plus the
+//                          foreground events that were stored.  An event that is lost without being counted
+//                          in EventQStats shows up as a shortfall
+//                        - The foreground events that were not stored must equal EventQStats.FifoDrops
+//                        - The Summary log entries must have consecutive EIDs and the codes that were
+//                          inserted
+//
+//  CAVEATS:            Only included if ENABLE_EVENT_QUEUE and ENABLE_SPI2_DMA are defined.
+//                      The Summary log in the FRAM model, EV_Sum, and EventMasterEID are overwritten.
+//
+//  INPUTS:             bursts - the number of bursts the interrupt fires
+//                      fp - the output stream
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             EventMasterEID, EV_Sum, the event queue, EventQStats
+//
+//  CALLS:              Event_VarInit(), Replay_EventLogClear(), InsertNewEvent(), EventManager(),
+//                      Replay_EventLogCheck(), pthread_create(), pthread_join(), Replay_Ratio(), fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_EventQBench(uint32_t bursts, FILE *fp)
+{
+  static const uint16_t REPLAY_EVQ_CODES[2] = {REPLAY_EVQ_ISR_CODE, REPLAY_EVQ_FG_CODE};
+  struct REPLAY_EVQ_ISR isr;
+  pthread_t thread;
+  uint32_t b, n, fg_posts, fg_stored, fg_burst, errs;
+
+  // Start with an empty queue and Summary log
+  Event_VarInit();
+  Replay_EventLogClear();
+
+  memset(&isr, 0, sizeof(isr));
+  isr.Bursts = bursts;
+  fg_posts = 0;
+  fg_stored = 0;
+  if (pthread_create(&thread, NULL, Replay_EventQIsr, &isr) != 0)
+  {
+    fprintf(fp, "Event queue: unable to start the interrupt thread\n");
+    return;
+  }
+
+  for (b = 0; b < bursts; ++b)
+  {
+    // Run the event manager while the burst is fired
+    n = 0;
+    fg_burst = 0;
+    while (__atomic_load_n(&isr.Fired, __ATOMIC_ACQUIRE) == b)
+    {
+      if ( ((++n % REPLAY_EVQ_FG_EVERY) == 0) && (fg_burst < REPLAY_EVQ_FG_MAX) )
+      {
+        ++fg_burst;
+        fg_stored += (InsertNewEvent(REPLAY_EVQ_FG_CODE) != 0);
+      }
+      EventManager();
+    }
+    fg_posts += fg_burst;
+
+    // Empty the queue.  Each pass processes one event
+    for (n = 0; n < (INTEVENT_BUF_SIZE + NEWEVENT_FIFO_SIZE); ++n)
+    {
+      EventManager();
+    }
+    __atomic_store_n(&isr.Acked, (b + 1), __ATOMIC_RELEASE);
+  }
+  pthread_join(thread, NULL);
+
+  // Check the Summary log.  Every entry must be one of the two test events
+  errs = Replay_EventLogCheck(&REPLAY_EVQ_CODES[0], 2);
+
+  fprintf(fp, "Event queue: %u bursts, interrupt events %u posted, %u dropped (buffer high water %u of %u),"
+              " foreground events %u posted, %u dropped (FIFO high water %u of %u)\n", (unsigned int)bursts,
+              (unsigned int)isr.Posted, (unsigned int)EventQStats.IntDrops,
+              (unsigned int)EventQStats.IntHiWater, (unsigned int)INTEVENT_BUF_SIZE, (unsigned int)fg_posts,
+              (unsigned int)EventQStats.FifoDrops, (unsigned int)EventQStats.FifoHiWater,
+              (unsigned int)(NEWEVENT_FIFO_SIZE - 1));
+  fprintf(fp, "EIDs issued %u, expected %u; foreground drops expected %u; Summary log %u entries checked,"
+              " %u errors\n", (unsigned int)(EventMasterEID - 1),
+              (unsigned int)(isr.Posted - EventQStats.IntDrops + fg_stored),
+              (unsigned int)(fg_posts - fg_stored), (unsigned int)EV_Sum.Num_Events, (unsigned int)errs);
+  fprintf(fp, "Interrupt insert: %.1f host nsec per event\n",
+              Replay_Ratio(isr.Time.Nsec, isr.Posted));
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_EventQBench()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_EventQIsr()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Event Queue Stress Test Simulated Interrupt
+//
+//  MECHANICS:          This is the thread function of the simulated interrupt for Replay_EventQBench().  It
+//                      sets Host_IPSR for this thread, so InsertNewEvent() treats its calls as interrupt
+//                      calls.  It then fires the bursts of events, waiting for the foreground to acknowledge
+//                      each burst before firing the next one.
+//
+//  CAVEATS:            Only included if ENABLE_EVENT_QUEUE and ENABLE_SPI2_DMA are defined.
+//
+//  INPUTS:             arg - pointer to the simulated interrupt structure (struct REPLAY_EVQ_ISR)
+//
+//  OUTPUTS:            Returns NULL
+//                      arg->Posted, arg->Time, arg->Fired
+//
+//  ALTERS:             Host_IPSR (this thread only)
+//
+//  CALLS:              InsertNewEvent(), Replay_TimeStart(), Replay_TimeStop(), sched_yield()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void *Replay_EventQIsr(void *arg)
+{
+  struct REPLAY_EVQ_ISR *isr;
+  uint32_t b, n, num;
+
+  isr = (struct REPLAY_EVQ_ISR *)arg;
+  Host_IPSR = 1;
+
+  for (b = 0; b < isr->Bursts; ++b)
+  {
+    while (__atomic_load_n(&isr->Acked, __ATOMIC_ACQUIRE) != b)
+    {
+      sched_yield();
+    }
+    num = ((((b + 1) % REPLAY_EVQ_STORM_EVERY) == 0) ? REPLAY_EVQ_STORM : REPLAY_EVQ_BURST);
+    Replay_TimeStart(&isr->Time);
+    for (n = 0; n < num; ++n)
+    {
+      InsertNewEvent(REPLAY_EVQ_ISR_CODE);
+    }
+    Replay_TimeStop(&isr->Time);
+    isr->Posted += num;
+    __atomic_store_n(&isr->Fired, (b + 1), __ATOMIC_RELEASE);
+  }
+  return (NULL);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_EventQIsr()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_EVENT_QUEUE && ENABLE_SPI2_DMA
+
+
+
+#ifdef ENABLE_SPI2_DMA
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_EventWCBench()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Event Log Write Benchmark
+//
+//  MECHANICS:          This subroutine measures the event log writes under bursts of events, as in a fault:
+//                        - REPLAY_EVW_BURST Summary log events are inserted with InsertNewEvent(), and
+//                          EventManager() is called until the New Event FIFO is empty
+//                        - The FRAM transactions and SPI2 bus time (FRAM model), and the host time, of the
+//                          EventManager() calls are added up
+//                      This is repeated for the given number of bursts, and the Summary log is rolled over
+//                      if there are enough of them.  The results are checked:
+//                        - The Summary log entries read back from FRAM must have consecutive EIDs, ending
+//                          with the last EID that was issued
+//                        - The Summary log index record and the Master EID in FRAM must match the RAM values
+//                      The number of records written per msec of SPI2 bus time, and the transactions and
+//                      EventManager() calls per record, are printed.  If ENABLE_EVENT_WC is defined, the
+//                      number of commits is printed too.  Run this in builds with and without
+//                      ENABLE_EVENT_WC to compare them.
+//
+//  CAVEATS:            Only included if ENABLE_SPI2_DMA is defined.
+//                      The Summary log in the FRAM model, EV_Sum, and EventMasterEID are overwritten.
+//
+//  INPUTS:             bursts - the number of bursts of events
+//                      fp - the output stream
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             EventMasterEID, EV_Sum, the event FIFO, Host_FramBusyCyc, Host_FramXacts, EventWC
+//
+//  CALLS:              Replay_EventLogClear(), InsertNewEvent(), EventManager(), Replay_EventLogCheck(),
+//                      FRAM_Read(), Replay_TimeStart(), Replay_TimeStop(), Replay_Ratio(), fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_EventWCBench(uint32_t bursts, FILE *fp)
+{
+  struct REPLAY_TIME host_time;
+  uint64_t busy;
+  uint32_t xacts, calls, records, b, n, errs;
+  uint16_t first_ndx, burst;
+  union dword_word
+  {
+    uint32_t u32[2];
+    uint16_t u16[4];
+  } uval;
+
+  // Start with an empty Summary log
+  Replay_EventLogClear();
+#ifdef ENABLE_EVENT_WC
+  EventWC.Commits = 0;
+  EventWC.Entries = 0;
+#endif
+
+  memset(&host_time, 0, sizeof(host_time));
+  busy = 0;
+  xacts = 0;
+  calls = 0;
+  records = 0;
+  for (b = 0; b < bursts; ++b)
+  {
+    burst = 0;
+    for (n = 0; n < REPLAY_EVW_BURST; ++n)
+    {
+      burst += (InsertNewEvent( ((n & 1) ? EXIT_MAINTENANCE_MODE : ENTER_MAINTENANCE_MODE) ) != 0);
+    }
+    records += burst;
+    first_ndx = EV_Sum.NextEvntNdx;
+    xacts -= Host_FramXacts;
+    busy -= Host_FramBusyCyc;
+    Replay_TimeStart(&host_time);
+    for (n = 0; ( (n < REPLAY_EVW_MAX_CALLS)            // Run the event manager until the burst is logged
+               && (((EV_Sum.NextEvntNdx + SUMMARY_NUM_LOGS - first_ndx) % SUMMARY_NUM_LOGS) < burst) ); ++n)
+    {
+      EventManager();
+      ++calls;
+    }
+    Replay_TimeStop(&host_time);
+    xacts += Host_FramXacts;
+    busy += Host_FramBusyCyc;
+  }
+
+  // Check the Summary log, then the index record and the Master EID
+  errs = Replay_EventLogCheck(NULL, 0);
+  FRAM_Read(SUMMARY_LOG_ADD, 4, &uval.u16[0]);
+  if ( (uval.u16[0] != EV_Sum.NextEvntNdx) || (uval.u16[1] != EV_Sum.Num_Events)
+    || (uval.u16[2] != (uval.u16[0] ^ 0xFFFF)) || (uval.u16[3] != (uval.u16[1] ^ 0xFFFF)) )
+  {
+    ++errs;
+  }
+  FRAM_Read(MASTER_EID, 4, &uval.u16[0]);
+  if ( (uval.u32[0] != EventMasterEID) || (uval.u32[1] != ~EventMasterEID) )
+  {
+    ++errs;
+  }
+
+#ifdef ENABLE_EVENT_WC
+  fprintf(fp, "Event log writes (write combining): %u bursts of %u events, %u records, %u commits,"
+              " %u errors\n", (unsigned int)bursts, (unsigned int)REPLAY_EVW_BURST, (unsigned int)records,
+              (unsigned int)EventWC.Commits, (unsigned int)errs);
+#else
+  fprintf(fp, "Event log writes (separate writes): %u bursts of %u events, %u records, %u errors\n",
+              (unsigned int)bursts, (unsigned int)REPLAY_EVW_BURST, (unsigned int)records,
+              (unsigned int)errs);
+#endif
+  if (records > 0)
+  {
+    fprintf(fp, "Per record: %.2f FRAM xacts, %.2f SPI2 usec, %.2f EventManager() calls, %.1f host nsec;"
+                " %.1f records per msec of SPI2 time\n", Replay_Ratio(xacts, records),
+                Replay_Ratio(busy, (records * (double)SCHED_CYC_PER_USEC)), Replay_Ratio(calls, records),
+                Replay_Ratio(host_time.Nsec, records),
+                Replay_Ratio((records * 1000.0 * SCHED_CYC_PER_USEC), busy));
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_EventWCBench()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_EventLogClear(), Replay_EventLogCheck()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Clear and Check the Summary Log
+//
+//  MECHANICS:          These subroutines are shared by the event log benchmarks.
+//                      Replay_EventLogClear() empties the Summary log and restarts the EIDs at 1.  The old
+//                      entries in the FRAM model are not used.  If ENABLE_EID_INDEX is defined, the EID
+//                      index is rebuilt (empty).
+//                      Replay_EventLogCheck() reads the Summary log entries back from the FRAM model, oldest
+//                      entry first.  The EIDs must be consecutive, ending with the last EID that was issued.
+//                      If num_codes is not 0, the event code of each entry must be one of codes[].
+//
+//  CAVEATS:            Only included if ENABLE_SPI2_DMA is defined
+//
+//  INPUTS:             codes - the event codes that may be in the log (NULL if num_codes is 0)
+//                      num_codes - the number of codes
+//                      EV_Sum, EventMasterEID, the Summary log in the FRAM model
+//
+//  OUTPUTS:            Replay_EventLogCheck() returns the number of errors
+//
+//  ALTERS:             Replay_EventLogClear(): EventMasterEID, EV_Sum
+//
+//  CALLS:              EventIndexInit(), FRAM_Read()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_EventLogClear(void)
+{
+  EventMasterEID = 1;
+  EV_Sum.NextEvntNdx = 0;
+  EV_Sum.Num_Events = 0;
+#ifdef ENABLE_EID_INDEX
+  EventIndexInit();
+#endif
+}
+
+
+uint32_t Replay_EventLogCheck(const uint16_t *codes, uint8_t num_codes)
+{
+  uint32_t eid, prev_eid, errs;
+  uint16_t entry[SUMMARY_EVENT_SIZE >> 1], ndx, num;
+  uint8_t k;
+
+  errs = 0;
+  prev_eid = 0;
+  ndx = (uint16_t)((EV_Sum.NextEvntNdx + SUMMARY_NUM_LOGS - EV_Sum.Num_Events) % SUMMARY_NUM_LOGS);
+  for (num = 0; num < EV_Sum.Num_Events; ++num)
+  {
+    FRAM_Read((SUMMARY_LOG_START + (ndx * SUMMARY_EVENT_SIZE)), (SUMMARY_EVENT_SIZE >> 1), &entry[0]);
+    memcpy(&eid, &entry[0], 4);
+    for (k = 0; (k < num_codes) && (entry[6] != codes[k]); ++k)
+    {
+    }
+    if ( ((num > 0) && (eid != (prev_eid + 1))) || ((num_codes > 0) && (k == num_codes)) )
+    {
+      ++errs;
+    }
+    prev_eid = eid;
+    ndx = ((ndx + 1) % SUMMARY_NUM_LOGS);
+  }
+  if ( (EV_Sum.Num_Events > 0) && (prev_eid != (EventMasterEID - 1)) )
+  {
+    ++errs;
+  }
+  return (errs);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_EventLogClear(), Replay_EventLogCheck()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_SPI2_DMA
+
+#endif                  // HOST_BUILD
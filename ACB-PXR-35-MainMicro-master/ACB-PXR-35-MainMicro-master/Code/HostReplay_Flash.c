@@ -0,0 +1,861 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//                      gcc (x86-64 Linux) for the host build only
+//
+//  MODULE NAME:        HostReplay_Flash.c
+//
+//  MECHANICS:          Program module containing the Flash waveform pipeline and waveform codec benchmarks
+//                      for the host (off-target) build.  This module is not part of the target project
+//                      (PXR35_ProtProc.ewp).  It is only compiled when HOST_BUILD is defined.
+//
+//                      With -flash, the sample stream is not run.  Instead, waveform captures are written to
+//                      the serial Flash model in HostShim.c with the Flash waveform pipeline, in simulated
+//                      time, by Replay_FlashBench().  This option is only available if ENABLE_SPI1_DMA is
+//                      defined.
+//                      With -wfcodec, the sample stream is not run.  Instead, waveform captures of typical
+//                      load and fault currents are coded and written to the Flash model, and read back and
+//                      checked, by Replay_WfCodecBench().  This option is only available if ENABLE_WF_CODEC
+//                      is defined.
+//
+//                      The options are parsed by main() in HostReplay.c.  The replay engine (Replay_Open(),
+//                      Replay_Sample()) and the timing and random number helpers (Replay_TimeStart(),
+//                      Replay_TimeStop(), Replay_Ratio(), Replay_RandF(), Replay_RandU()) are in
+//                      HostReplay.c.
+//
+//  TARGET HARDWARE:    None (host PC)
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   179    240302  DAH File Creation
+//                      - Moved Replay_FlashBench(), Replay_FlashRun(), Replay_FlashGet(), Replay_FlashSet(),
+//                        Replay_WfCodecBench(), Replay_WfCodecFill(), and Replay_WfCodecCheck() from
+//                        HostReplay.c
+//                      - Revised the benchmark reports to use Replay_Ratio() in HostReplay.c
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+//
+//------------------------------------------------------------------------------------------------------------
+//
+#ifdef HOST_BUILD
+
+//------------------------------------------------------------------------------------------------------------
+//                   Definitions
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global Definitions from external files...
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "stm32f4xx.h"
+#include "stm32f407xx.h"
+#include "RealTime_def.h"
+#include "Iod_def.h"
+#include "Demand_def.h"
+#include "Intr_def.h"
+#include "Meter_def.h"
+#include "Events_def.h"
+#include "Setpnt_def.h"
+#include "FRAM_Flash_def.h"             // Must be preceded by Events_def.h and Setpnt_def.h!
+#include "Test_def.h"
+#include "Prot_def.h"
+#include "HostShim_def.h"
+#include "Sched_def.h"
+#include "HostReplay_def.h"             // Must be preceded by Sched_def.h!
+#include "WfCodec_def.h"
+
+//
+//      Local Definitions used in this module...
+//
+
+
+//
+//      Global Declarations from external files...
+//
+#include "Iod_ext.h"
+#include "Intr_ext.h"
+#include "Meter_ext.h"
+#include "HostReplay_ext.h"
+#include "WfCodec_ext.h"
+
+// Flash waveform write subroutine in Iod.c.  On the target this is only called from SPI2_Flash_Manager()
+#ifdef ENABLE_SPI1_DMA
+  extern uint8_t Flash_WriteWaveform(struct FLASH_INT_REQ *WF_Struct, uint8_t WF_Abort);
+#endif
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global (Visible) Function Prototypes (These functions are called by other modules)
+//
+#ifdef ENABLE_SPI1_DMA
+  void Replay_FlashBench(uint32_t captures, FILE *fp);
+#endif
+#ifdef ENABLE_WF_CODEC
+  void Replay_WfCodecBench(uint32_t captures, FILE *fp);
+#endif
+
+
+//      Local Function Prototypes (These functions are called only within this module)
+//
+#ifdef ENABLE_SPI1_DMA
+  void Replay_FlashRun(uint8_t pre, uint32_t captures, struct REPLAY_FLASH_STATS *sptr);
+  void Replay_FlashGet(uint32_t seq, struct RAM_SAMPLES *rptr);
+  void Replay_FlashSet(uint16_t ndx, uint32_t seq);
+#endif
+#ifdef ENABLE_WF_CODEC
+  void Replay_WfCodecFill(uint8_t type, uint16_t n, struct RAM_SAMPLES *rptr);
+  uint8_t Replay_WfCodecCheck(uint32_t wf_add, uint8_t cyc, const struct RAM_SAMPLES *eptr, float *errptr);
+#endif
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Storage Allocation - Global (Static) Variables
+//------------------------------------------------------------------------------------------------------------
+//
+//       These variables are used by other modules...
+//
+
+//       These variables are used only in this module...
+//
+
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Global Constants used in this module and other modules
+//------------------------------------------------------------------------------------------------------------
+//
+
+
+
+#ifdef ENABLE_SPI1_DMA
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_FlashBench()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Flash Waveform Pipeline Benchmark
+//
+//  MECHANICS:          This subroutine measures writing waveform captures to Flash with the pipeline in
+//                      Flash_WriteWaveform() (State 5, Flash_PipeService()), in simulated time, with the
+//                      serial Flash model in HostShim.c.  Each run is Replay_FlashRun() with the given
+//                      number of back-to-back captures.  The runs are:
+//                        - Page program time: the max (1.5msec), and half the max
+//                        - Time between status reads (FlashPipe.PollArr): 100usec and 20usec (the default)
+//                        - Precycles: 8 and 28.  With 8 precycles there are 28 post-event cycles, so the
+//                          write can catch up with the samples that are being received
+//                      For each run, the average and max times per capture, the average time per page, the
+//                      sustained write rate in sample sets per second (the samples arrive at 4800/sec), the
+//                      number of busy status reads and stalls, and the number of errors are printed.  An
+//                      error is a sample set in Flash that does not match the sample that was received (the
+//                      pipeline overtook SampleIndex), or a command that the Flash would not have accepted.
+//                      For comparison, the time per page of the unpipelined code is also printed.  It sends
+//                      a page from the Timer10 interrupt and reads the status on the following interrupts,
+//                      1.5msec after the interrupt is done, so the time per page is the bus time plus the
+//                      page program time rounded up to 1.5msec.
+//
+//  CAVEATS:            Only included if ENABLE_SPI1_DMA is defined.
+//                      The sectors are not erased by the pipeline, so Replay_FlashRun() erases them in the
+//                      Flash model before each capture, in no time.  The time spent in the interrupts is not
+//                      included.
+//                      Host_SimClk is left FALSE on exit, so Host_CycCnt() returns the host time again.
+//
+//  INPUTS:             captures - the number of captures in each run
+//                      fp - the output stream
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             Host_FlashTpp, Host_SimClk, FlashPipe.PollArr, FlashPipe.WaitArr
+//
+//  CALLS:              Replay_FlashRun(), Replay_Ratio(), fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_FlashBench(uint32_t captures, FILE *fp)
+{
+  struct REPLAY_FLASH_STATS stats;
+  uint32_t tpp, sets_per_sec, tick, legacy_cyc;
+  uint16_t poll_arr;
+  uint8_t i, j, k, pre;
+
+  Host_SimClk = TRUE;
+  tick = (TIM10_ARR_1500USEC + 1) * REPLAY_FLASH_TIM10_CYC;
+
+  fprintf(fp, "Flash waveform pipeline: %u back-to-back captures per run (simulated time)\n",
+            (unsigned int)captures);
+  fprintf(fp, "Tpp(us) Poll(us) PreCyc  ms/capt  max ms  us/page  sets/sec  BusyPolls  Stalls  Mismatch"
+                "  FlashErr  Unpipelined us/page\n");
+  for (i=0; i<2; ++i)                   // i = 0: max page program time, i = 1: half the max
+  {
+    tpp = ( (i == 0) ? HOST_FLASH_TPP_MAX : (HOST_FLASH_TPP_MAX / 2) );
+    legacy_cyc = ( (8 + 32 + (FLASH_PG_SETS * sizeof(struct RAM_SAMPLES) * 8)) * HOST_FLASH_CYC_PER_BIT )
+                    + (((tpp + tick - 1) / tick) * tick);
+    for (j=0; j<2; ++j)                 // j = 0: 100usec between status reads, j = 1: 20usec
+    {
+      poll_arr = ( (j == 0) ? TIM10_ARR_100USEC : TIM10_ARR_20USEC );
+      for (k=0; k<2; ++k)               // k = 0: min precycles, k = 1: max precycles
+      {
+        pre = ( (k == 0) ? REPLAY_FLASH_MIN_PRE : REPLAY_FLASH_MAX_PRE );
+        Host_FlashTpp = tpp;
+        FlashPipe.PollArr = poll_arr;
+        FlashPipe.WaitArr = TIM10_ARR_1500USEC;
+        Replay_FlashRun(pre, captures, &stats);
+        sets_per_sec = (uint32_t)Replay_Ratio(((double)FLASH_WF_SETS * captures * 120000000.0), stats.Cyc);
+        fprintf(fp, "%7u %8u %6u %8.1f %7.1f %8.0f %9u %10u %7u %9u %9u %20.0f\n",
+                  (unsigned int)(tpp / SCHED_CYC_PER_USEC),
+                  (unsigned int)(((poll_arr + 1) * REPLAY_FLASH_TIM10_CYC) / SCHED_CYC_PER_USEC),
+                  (unsigned int)pre, Replay_Ratio(stats.Cyc, captures) / 120000.0,
+                  (double)stats.MaxCyc / 120000.0, Replay_Ratio(stats.Cyc, stats.Pages) / SCHED_CYC_PER_USEC,
+                  (unsigned int)sets_per_sec, (unsigned int)stats.BusyPolls, (unsigned int)stats.Stalls,
+                  (unsigned int)stats.Mismatches, (unsigned int)stats.FlashErrs,
+                  (double)legacy_cyc / SCHED_CYC_PER_USEC);
+      }
+    }
+  }
+
+  Host_FlashTpp = HOST_FLASH_TPP_MAX;
+  FlashPipe.PollArr = TIM10_ARR_20USEC;
+  FlashPipe.WaitArr = TIM10_ARR_1500USEC;
+  Host_SimClk = FALSE;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_FlashBench()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_FlashRun()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Flash Waveform Pipeline Benchmark Run
+//
+//  MECHANICS:          This subroutine writes the given number of waveform captures to the Flash model, one
+//                      right after the other, cycling through the trip, alarm, and extended captures.  The
+//                      simulated clock advances event by event:
+//                        - Every REPLAY_FLASH_SAMPLE_CYC cycles, a sample set is written to SampleBuf at
+//                          SampleIndex, and SampleIndex is incremented, the same as the sampling interrupt.
+//                          Each sample set is filled from its sequence number (Replay_FlashSet()), so every
+//                          set is different
+//                        - Each time Timer10 rolls over (every TIM10->ARR + 1 counts), Flash_WriteWaveform()
+//                          is called, the same as TIM1_UP_TIM10_IRQHandler()
+//                      Each capture starts with the precycles behind SampleIndex, the same as the capture
+//                      requests in DMA1_Stream0_IRQHandler(), and its sectors are erased first.  When the
+//                      write is done, the sample sets are read back from the Flash model and compared with
+//                      the sets that were received.  The sets are sent as 16-bit words, ms byte first, so
+//                      the bytes of each word are swapped in Flash.
+//                      If ENABLE_WF_CODEC is defined, each cycle is decoded from the Flash model instead
+//                      (Replay_WfCodecCheck()), and a set is a mismatch if a voltage is different or a
+//                      current is off by more than the coding error.
+//
+//  CAVEATS:            Only included if ENABLE_SPI1_DMA is defined.
+//                      SampleBuf is filled at the start, so there are no unfilled precycles.
+//
+//  INPUTS:             pre - the number of precycles
+//                      captures - the number of captures
+//
+//  OUTPUTS:            *sptr - the statistics
+//
+//  ALTERS:             SampleBuf, SampleIndex, SampleBufFilled, Trip_WF_Capture, Alarm_WF_Capture,
+//                      Ext_WF_Capture, FlashPipe, Host_FlashMem[], Host_FlashPages, Host_FlashErrs,
+//                      Host_SimCyc, TIM10->ARR
+//
+//  CALLS:              memset(), memcmp(), Replay_FlashSet(), Flash_WriteWaveform(), Replay_FlashGet(),
+//                      Replay_WfCodecCheck() (if ENABLE_WF_CODEC is defined)
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_FlashRun(uint8_t pre, uint32_t captures, struct REPLAY_FLASH_STATS *sptr)
+{
+  struct FLASH_INT_REQ *wf;
+#ifdef ENABLE_WF_CODEC
+  struct RAM_SAMPLES cyc_sets[WF_CODEC_SAMPLES];
+  float max_err;
+#else
+  struct RAM_SAMPLES rec, expected;
+#endif
+  uint64_t now, next_sample, next_tick, start;
+  uint32_t seq, first_seq, n, j, byte_add;
+#ifdef ENABLE_WF_CODEC
+  uint16_t i;
+#else
+  uint16_t i, *wptr;
+#endif
+  uint8_t done;
+
+  memset(sptr, 0, sizeof(struct REPLAY_FLASH_STATS));
+  Host_FlashPages = 0;
+  Host_FlashErrs = 0;
+  FlashPipe.Pages = 0;
+  FlashPipe.BusyPolls = 0;
+  FlashPipe.Stalls = 0;
+
+  // Fill SampleBuf so that all of the precycles are valid
+  for (i=0; i<TOTAL_SAMPLE_SETS; ++i)
+  {
+    Replay_FlashSet(i, i);
+  }
+  seq = TOTAL_SAMPLE_SETS;
+  SampleIndex = 0;
+  SampleBufFilled = TRUE;
+
+  TIM10->ARR = TIM10_ARR_1500USEC;
+  now = 0;
+  next_sample = REPLAY_FLASH_SAMPLE_CYC;
+  next_tick = (TIM10->ARR + 1) * REPLAY_FLASH_TIM10_CYC;
+
+  for (n=0; n<captures; ++n)
+  {
+    wf = ( ((n % 3) == 0) ? &Trip_WF_Capture : (((n % 3) == 1) ? &Alarm_WF_Capture : &Ext_WF_Capture) );
+    wf->EV_Add.NextEvntNdx = (n / 3) % NUM_EXTCAP_WAVEFORMS;
+    wf->SampleStartIndex = SampleIndex + ((3 + 36 - pre) * 80);
+    if (wf->SampleStartIndex >= TOTAL_SAMPLE_SETS)
+    {
+      wf->SampleStartIndex -= TOTAL_SAMPLE_SETS;
+    }
+    first_seq = seq - (pre * 80);
+    start = now;
+
+    // Erase the sectors for the capture.  The pipeline assumes that they have already been erased
+    byte_add = ( (wf == &Trip_WF_Capture) ? TRIP_WAVEFORMS_START :
+                    ((wf == &Alarm_WF_Capture) ? ALARM_WAVEFORMS_START : EXTCAP_WAVEFORM_START) );
+    byte_add = (byte_add + (wf->EV_Add.NextEvntNdx * WF_SIZE_IN_SECTORS)) << 12;
+    memset(&Host_FlashMem[byte_add], 0xFF, (WF_SIZE_IN_SECTORS << 12));
+
+    done = FALSE;
+    while (!done)
+    {
+      if (next_sample <= next_tick)     // Sample interrupt
+      {
+        now = next_sample;
+        Replay_FlashSet(SampleIndex, seq++);
+        if (++SampleIndex >= TOTAL_SAMPLE_SETS)
+        {
+          SampleIndex = 0;
+        }
+        next_sample += REPLAY_FLASH_SAMPLE_CYC;
+      }
+      else                              // Timer10 interrupt
+      {
+        now = next_tick;
+        Host_SimCyc = (uint32_t)now;
+        done = Flash_WriteWaveform(wf, FALSE);
+        next_tick = now + ((TIM10->ARR + 1) * REPLAY_FLASH_TIM10_CYC);
+      }
+    }
+    sptr->Cyc += (now - start);
+    if ((now - start) > sptr->MaxCyc)
+    {
+      sptr->MaxCyc = (uint32_t)(now - start);
+    }
+
+#ifdef ENABLE_WF_CODEC
+    // Check the waveform a cycle at a time, from the start of the capture
+    byte_add = ((uint32_t)FlashPipe.SlotAdd) << 8;
+    max_err = 0;
+    for (j=0; j<FLASH_WF_SETS; j += WF_CODEC_SAMPLES)
+    {
+      for (i=0; i<WF_CODEC_SAMPLES; ++i)
+      {
+        Replay_FlashGet((first_seq + j + i), &cyc_sets[i]);
+      }
+      sptr->Mismatches += Replay_WfCodecCheck(byte_add, (uint8_t)(j / WF_CODEC_SAMPLES), &cyc_sets[0],
+                                              &max_err);
+    }
+#else
+    // Check the waveform.  FlashAdd has been incremented past the last page
+    byte_add = ((uint32_t)wf->FlashAdd - ((FLASH_WF_SETS + FLASH_PG_SETS - 1) / FLASH_PG_SETS)) << 8;
+    for (j=0; j<FLASH_WF_SETS; ++j)
+    {
+      wptr = (uint16_t *)(&rec.Ia);
+      for (i=0; i<(sizeof(struct RAM_SAMPLES)/2); ++i)
+      {
+        wptr[i] = (((uint16_t)Host_FlashMem[byte_add + (2 * i)]) << 8)
+                    + Host_FlashMem[byte_add + (2 * i) + 1];
+      }
+      Replay_FlashGet(first_seq + j, &expected);
+      if (memcmp(&rec, &expected, sizeof(struct RAM_SAMPLES)) != 0)
+      {
+        ++sptr->Mismatches;
+      }
+      if (((j + 1) % FLASH_PG_SETS) == 0)   // Next page
+      {
+        byte_add += (256 - ((FLASH_PG_SETS - 1) * sizeof(struct RAM_SAMPLES)));
+      }
+      else
+      {
+        byte_add += sizeof(struct RAM_SAMPLES);
+      }
+    }
+#endif
+  }
+
+  sptr->Pages = FlashPipe.Pages;
+  sptr->BusyPolls = FlashPipe.BusyPolls;
+  sptr->Stalls = FlashPipe.Stalls;
+  sptr->FlashErrs = Host_FlashErrs;
+  TIM10->ARR = TIM10_ARR_1500USEC;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_FlashRun()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_FlashGet(), Replay_FlashSet()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Flash Waveform Pipeline Benchmark Sample Sets
+//
+//  MECHANICS:          Replay_FlashGet() fills a sample set from its sequence number: the currents are the
+//                      sequence number plus 0.0, 0.125, ... 0.625, and the voltages are the sequence number
+//                      plus 0 thru 5.  Replay_FlashSet() writes this sample set to SampleBuf.
+//
+//  CAVEATS:            The currents are exact as long as the sequence number is less than 2^21
+//
+//  INPUTS:             ndx - the index in SampleBuf
+//                      seq - the sequence number
+//
+//  OUTPUTS:            *rptr - the sample set (Replay_FlashGet())
+//                      SampleBuf[ndx] (Replay_FlashSet())
+//
+//  ALTERS:             None
+//
+//  CALLS:              Replay_FlashGet()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_FlashGet(uint32_t seq, struct RAM_SAMPLES *rptr)
+{
+  rptr->Ia = (float)seq;
+  rptr->Ib = (float)seq + 0.125f;
+  rptr->Ic = (float)seq + 0.25f;
+  rptr->In = (float)seq + 0.375f;
+  rptr->Igsrc = (float)seq + 0.5f;
+  rptr->Igres = (float)seq + 0.625f;
+  rptr->VanAFE = (int16_t)seq;
+  rptr->VbnAFE = (int16_t)(seq + 1);
+  rptr->VcnAFE = (int16_t)(seq + 2);
+  rptr->VanADC = (int16_t)(seq + 3);
+  rptr->VbnADC = (int16_t)(seq + 4);
+  rptr->VcnADC = (int16_t)(seq + 5);
+}
+
+void Replay_FlashSet(uint16_t ndx, uint32_t seq)
+{
+  struct RAM_SAMPLES rec;
+
+  Replay_FlashGet(seq, &rec);
+  SAMPLEBUF(Ia, ndx) = rec.Ia;
+  SAMPLEBUF(Ib, ndx) = rec.Ib;
+  SAMPLEBUF(Ic, ndx) = rec.Ic;
+  SAMPLEBUF(In, ndx) = rec.In;
+  SAMPLEBUF(Igsrc, ndx) = rec.Igsrc;
+  SAMPLEBUF(Igres, ndx) = rec.Igres;
+  SAMPLEBUF(VanAFE, ndx) = rec.VanAFE;
+  SAMPLEBUF(VbnAFE, ndx) = rec.VbnAFE;
+  SAMPLEBUF(VcnAFE, ndx) = rec.VcnAFE;
+  SAMPLEBUF(VanADC, ndx) = rec.VanADC;
+  SAMPLEBUF(VbnADC, ndx) = rec.VbnADC;
+  SAMPLEBUF(VcnADC, ndx) = rec.VcnADC;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_FlashGet(), Replay_FlashSet()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+#ifdef ENABLE_WF_CODEC
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_WfCodecBench()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Coded Waveform Capture Benchmark
+//
+//  MECHANICS:          This subroutine writes the given number of coded waveform captures to the Flash model
+//                      and checks them.  The captures cycle through the REPLAY_WFC_xx waveform types
+//                      (Replay_WfCodecFill()).  For each capture:
+//                        - SampleBuf is filled with the 36 cycles of the capture, and the capture's slot is
+//                          erased in the Flash model
+//                        - The capture is written with Flash_WriteWaveform(), in simulated time, the same as
+//                          Replay_FlashRun(), except that all of the samples have already been received
+//                        - Each cycle is decoded from Flash and checked (Replay_WfCodecCheck())
+//                      For each type, the average number of pages (412 uncoded), the compression ratio, the
+//                      max current error as a fraction of the cycle peak, the number of sample sets that do
+//                      not match, and the average number of bus bytes to read one cycle of one channel
+//                      (uncoded: 80 separate reads of one value) are printed.
+//
+//  CAVEATS:            Only included if ENABLE_WF_CODEC is defined.
+//                      Host_SimClk is left FALSE on exit, so Host_CycCnt() returns the host time again.
+//
+//  INPUTS:             captures - the number of captures
+//                      fp - the output stream
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             SampleBuf, SampleIndex, SampleBufFilled, Trip_WF_Capture, FlashPipe, Host_FlashMem[],
+//                      Host_SimClk, Host_SimCyc, TIM10->ARR
+//
+//  CALLS:              memset(), Replay_WfCodecFill(), Flash_WriteWaveform(), Flash_Read(),
+//                      WfCodec_BlockSize(), Replay_WfCodecCheck(), Replay_Ratio(), fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_WfCodecBench(uint32_t captures, FILE *fp)
+{
+  struct RAM_SAMPLES cyc_sets[WF_CODEC_SAMPLES], rec;
+  struct WF_CODEC_DIR dir;
+  uint64_t now, rd_bytes[REPLAY_WFC_TYPES], rd_blocks[REPLAY_WFC_TYPES];
+  uint32_t n, byte_add, pages[REPLAY_WFC_TYPES], bytes[REPLAY_WFC_TYPES], caps[REPLAY_WFC_TYPES];
+  uint32_t mismatches[REPLAY_WFC_TYPES], start_pages;
+  float max_err[REPLAY_WFC_TYPES];
+  uint16_t i, raw_rd;
+  uint8_t type, cyc, chan, done;
+
+  static const char * const REPLAY_WFC_NAME[REPLAY_WFC_TYPES] = {"Load", "Fault", "Ground", "Open"};
+
+  memset(&pages[0], 0, sizeof(pages));
+  memset(&bytes[0], 0, sizeof(bytes));
+  memset(&caps[0], 0, sizeof(caps));
+  memset(&mismatches[0], 0, sizeof(mismatches));
+  memset(&rd_bytes[0], 0, sizeof(rd_bytes));
+  memset(&rd_blocks[0], 0, sizeof(rd_blocks));
+  memset(&max_err[0], 0, sizeof(max_err));
+  Host_SimClk = TRUE;
+  now = 0;
+
+  for (n=0; n<captures; ++n)
+  {
+    type = (uint8_t)(n % REPLAY_WFC_TYPES);
+
+    // Fill SampleBuf with the capture, starting at index 0.  SampleIndex is just past the end, so all of
+    //   the samples have been received
+    for (i=0; i<FLASH_WF_SETS; ++i)
+    {
+      Replay_WfCodecFill(type, i, &rec);
+      SAMPLEBUF(Ia, i) = rec.Ia;
+      SAMPLEBUF(Ib, i) = rec.Ib;
+      SAMPLEBUF(Ic, i) = rec.Ic;
+      SAMPLEBUF(In, i) = rec.In;
+      SAMPLEBUF(Igsrc, i) = rec.Igsrc;
+      SAMPLEBUF(Igres, i) = rec.Igres;
+      SAMPLEBUF(VanAFE, i) = rec.VanAFE;
+      SAMPLEBUF(VbnAFE, i) = rec.VbnAFE;
+      SAMPLEBUF(VcnAFE, i) = rec.VcnAFE;
+      SAMPLEBUF(VanADC, i) = rec.VanADC;
+      SAMPLEBUF(VbnADC, i) = rec.VbnADC;
+      SAMPLEBUF(VcnADC, i) = rec.VcnADC;
+    }
+    SampleIndex = FLASH_WF_SETS;
+    SampleBufFilled = TRUE;
+    Trip_WF_Capture.SampleStartIndex = 0;
+    Trip_WF_Capture.EV_Add.NextEvntNdx = n % NUM_TRIP_WAVEFORMS;
+    byte_add = (TRIP_WAVEFORMS_START + (Trip_WF_Capture.EV_Add.NextEvntNdx * WF_SIZE_IN_SECTORS)) << 12;
+    memset(&Host_FlashMem[byte_add], 0xFF, (WF_SIZE_IN_SECTORS << 12));
+
+    // Write the capture, calling Flash_WriteWaveform() on each Timer10 interrupt
+    start_pages = FlashPipe.Pages;
+    TIM10->ARR = TIM10_ARR_1500USEC;
+    done = FALSE;
+    while (!done)
+    {
+      now += ((TIM10->ARR + 1) * REPLAY_FLASH_TIM10_CYC);
+      Host_SimCyc = (uint32_t)now;
+      done = Flash_WriteWaveform(&Trip_WF_Capture, FALSE);
+    }
+    ++caps[type];
+    pages[type] += (FlashPipe.Pages - start_pages);
+    bytes[type] += FlashPipe.DataBytes;
+
+    // Read back and check each cycle.  The bus bytes to read one block are the command and address of the
+    //   index read, the index entry, the command and address of the block read, and the block
+    for (cyc=0; cyc<WF_CODEC_CYCLES; ++cyc)
+    {
+      for (i=0; i<WF_CODEC_SAMPLES; ++i)
+      {
+        Replay_WfCodecFill(type, ((cyc * WF_CODEC_SAMPLES) + i), &cyc_sets[i]);
+      }
+      mismatches[type] += Replay_WfCodecCheck(byte_add, cyc, &cyc_sets[0], &max_err[type]);
+      Flash_Read((byte_add + (cyc * WF_CODEC_DIR_SIZE)), (WF_CODEC_DIR_SIZE/2), (uint16_t *)(&dir));
+      for (chan=0; chan<WF_CODEC_CHANNELS; ++chan)
+      {
+        rd_bytes[type] += (4 + WF_CODEC_DIR_SIZE + 4 + WfCodec_BlockSize(chan, dir.Mode[chan]));
+        ++rd_blocks[type];
+      }
+    }
+  }
+
+  // Uncoded read of one value of one cycle: 80 reads of the command, address, and value (6 currents of 4
+  //   bytes, 6 voltages of 2 bytes)
+  raw_rd = (WF_CODEC_SAMPLES * (4 + 3));
+  fprintf(fp, "Coded waveform captures: %u captures (uncoded: %u pages, %u bus bytes to read one cycle of"
+              " one channel)\n", (unsigned int)captures,
+              (unsigned int)((FLASH_WF_SETS + FLASH_PG_SETS - 1) / FLASH_PG_SETS), (unsigned int)raw_rd);
+  fprintf(fp, "Type    Captures  Pages/capt  Bytes/capt  Ratio  Max I err (pk)  Mismatch"
+              "  Read bytes/block\n");
+  for (type=0; type<REPLAY_WFC_TYPES; ++type)
+  {
+    if (caps[type] == 0)
+    {
+      continue;
+    }
+    fprintf(fp, "%-7s %8u %11.1f %11.0f %6.2f %15.2e %9u %17.1f\n", REPLAY_WFC_NAME[type],
+              (unsigned int)caps[type], Replay_Ratio(pages[type], caps[type]),
+              Replay_Ratio(bytes[type], caps[type]),
+              Replay_Ratio(((double)FLASH_WF_SETS * sizeof(struct RAM_SAMPLES) * caps[type]),
+                           (bytes[type] + (WF_CODEC_DATA_START * caps[type]))),
+              (double)max_err[type], (unsigned int)mismatches[type],
+              Replay_Ratio(rd_bytes[type], rd_blocks[type]));
+  }
+
+  TIM10->ARR = TIM10_ARR_1500USEC;
+  Host_SimClk = FALSE;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_WfCodecBench()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_WfCodecFill()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Coded Waveform Capture Benchmark Samples
+//
+//  MECHANICS:          This subroutine fills sample set n of a capture of the given type.  The voltages are
+//                      277V rms with 2% fifth harmonic, in volts x 10.  The currents are in amps, with 3%
+//                      third and 2% fifth harmonic.  Both have noise like the ADC noise (+/-1A on the
+//                      currents, +/-0.3V on the voltages).  The types are:
+//                        REPLAY_WFC_LOAD:    800A load
+//                        REPLAY_WFC_FAULT:   800A load, then a 20kA fault on phase A at cycle 8 with a fully
+//                                            offset DC component (3-cycle time constant).  Phase A voltage
+//                                            sags to 40%
+//                        REPLAY_WFC_GROUND:  800A load, then a 1200A ground fault on phase B at cycle 8
+//                                            (In and Igsrc)
+//                        REPLAY_WFC_OPEN:    breaker open: no current (noise only), normal voltages
+//                      The noise is a hash of n and the channel, so the same sample set can be filled again
+//                      to check it.
+//
+//  CAVEATS:            Only included if ENABLE_WF_CODEC is defined.
+//
+//  INPUTS:             type - the capture type (REPLAY_WFC_xx)
+//                      n - the sample set number in the capture (0 - 2879)
+//
+//  OUTPUTS:            *rptr - the sample set
+//
+//  ALTERS:             None
+//
+//  CALLS:              sinf(), expf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+// Noise for sample set n, channel k: -(range) ... +(range) (Knuth multiplicative hash)
+#define REPLAY_WFC_NOISE(n, k, range)   ( (int32_t)(((((uint32_t)(n) * 12u + (k)) * 2654435761u) >> 16)     \
+                                                      % ((2 * (range)) + 1)) - (range) )
+
+void Replay_WfCodecFill(uint8_t type, uint16_t n, struct RAM_SAMPLES *rptr)
+{
+  float ang, amp, ph, dc, val[3];
+  uint8_t k, fault;
+
+  ang = 6.2831853f * (float)(n % WF_CODEC_SAMPLES) / WF_CODEC_SAMPLES;
+  fault = (n >= (REPLAY_WFC_FAULT_CYC * WF_CODEC_SAMPLES));
+  amp = ( (type == REPLAY_WFC_OPEN) ? 0.0f : (1.4142136f * 800.0f) );
+  for (k=0; k<3; ++k)
+  {
+    ph = ang - (2.0943951f * k);
+    val[k] = (amp * (sinf(ph) + (0.03f * sinf(3.0f * ph)) + (0.02f * sinf(5.0f * ph))))
+                + ((float)REPLAY_WFC_NOISE(n, k, 100) * 0.01f);
+  }
+  if ( (type == REPLAY_WFC_FAULT) && (fault) )
+  {
+    dc = expf(-(float)(n - (REPLAY_WFC_FAULT_CYC * WF_CODEC_SAMPLES)) / (3.0f * WF_CODEC_SAMPLES));
+    val[0] += (1.4142136f * 20000.0f) * (sinf(ang - 1.5707963f) + dc);
+  }
+  rptr->Ia = val[0];
+  rptr->Ib = val[1];
+  rptr->Ic = val[2];
+  rptr->In = ((val[0] + val[1] + val[2]) * 0.25f) + ((float)REPLAY_WFC_NOISE(n, 3, 100) * 0.01f);
+  rptr->Igsrc = (float)REPLAY_WFC_NOISE(n, 4, 100) * 0.01f;
+  rptr->Igres = rptr->Igsrc + rptr->In;
+  if ( (type == REPLAY_WFC_GROUND) && (fault) )
+  {
+    rptr->In += (1.4142136f * 1200.0f) * sinf(ang - 2.0943951f);
+    rptr->Igsrc += (1.4142136f * 1200.0f) * sinf(ang - 2.0943951f);
+  }
+
+  for (k=0; k<3; ++k)
+  {
+    ph = ang - (2.0943951f * k);
+    amp = ( ((type == REPLAY_WFC_FAULT) && (fault) && (k == 0)) ? 0.4f : 1.0f ) * (1.4142136f * 2770.0f);
+    val[k] = amp * (sinf(ph) + (0.02f * sinf(5.0f * ph)));
+  }
+  rptr->VanAFE = (int16_t)(val[0] + (float)REPLAY_WFC_NOISE(n, 6, 3));
+  rptr->VbnAFE = (int16_t)(val[1] + (float)REPLAY_WFC_NOISE(n, 7, 3));
+  rptr->VcnAFE = (int16_t)(val[2] + (float)REPLAY_WFC_NOISE(n, 8, 3));
+  rptr->VanADC = (int16_t)(val[0] + (float)REPLAY_WFC_NOISE(n, 9, 3));
+  rptr->VbnADC = (int16_t)(val[1] + (float)REPLAY_WFC_NOISE(n, 10, 3));
+  rptr->VcnADC = (int16_t)(val[2] + (float)REPLAY_WFC_NOISE(n, 11, 3));
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_WfCodecFill()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_WfCodecCheck()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Check One Cycle of a Coded Waveform Capture
+//
+//  MECHANICS:          This subroutine decodes each channel of one cycle of a coded capture from the Flash
+//                      model (WfCodec_Read()), and compares it with the sample sets that were written.  The
+//                      voltages must be the same.  The currents must be within REPLAY_WFC_I_TOL of the peak
+//                      magnitude of the channel in the cycle (half a step, plus rounding), and within
+//                      WF_CODEC_I_MAX_ERR if it is defined.  The largest current error, as a fraction of
+//                      the peak, is kept in *errptr.
+//
+//  CAVEATS:            Only included if ENABLE_WF_CODEC is defined.
+//
+//  INPUTS:             wf_add - the byte address of the capture in Flash
+//                      cyc - the cycle (0 - 35)
+//                      eptr[] - the sample sets that were written (WF_CODEC_SAMPLES)
+//                      *errptr - the largest current error so far
+//
+//  OUTPUTS:            *errptr
+//                      The subroutine returns the number of sample sets that do not match (all of them if
+//                      the cycle was not written)
+//
+//  ALTERS:             None
+//
+//  CALLS:              memset(), WfCodec_Read(), fabsf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Replay_WfCodecCheck(uint32_t wf_add, uint8_t cyc, const struct RAM_SAMPLES *eptr, float *errptr)
+{
+  float ival[WF_CODEC_SAMPLES], peak, err, x;
+  int16_t vval[WF_CODEC_SAMPLES];
+  uint8_t bad[WF_CODEC_SAMPLES];
+  uint8_t chan, n, num_bad;
+
+  memset(&bad[0], FALSE, sizeof(bad));
+  for (chan=0; chan<WF_CODEC_CHANNELS; ++chan)
+  {
+    if (chan < WF_CODEC_NUM_I)
+    {
+      if (!WfCodec_Read(wf_add, cyc, chan, 0, WF_CODEC_SAMPLES, (uint8_t *)(&ival[0])))
+      {
+        return (WF_CODEC_SAMPLES);
+      }
+      peak = 0;
+      for (n=0; n<WF_CODEC_SAMPLES; ++n)
+      {
+        x = fabsf((&eptr[n].Ia)[chan]);
+        peak = ( (x > peak) ? x : peak );
+      }
+      for (n=0; n<WF_CODEC_SAMPLES; ++n)
+      {
+        err = fabsf(ival[n] - (&eptr[n].Ia)[chan]);
+        if (err > (peak * REPLAY_WFC_I_TOL))
+        {
+          bad[n] = TRUE;
+        }
+  #ifdef WF_CODEC_I_MAX_ERR
+        if (err > WF_CODEC_I_MAX_ERR)
+        {
+          bad[n] = TRUE;
+        }
+  #endif
+        if ( (peak > 0) && ((err / peak) > *errptr) )
+        {
+          *errptr = err / peak;
+        }
+      }
+    }
+    else
+    {
+      if (!WfCodec_Read(wf_add, cyc, chan, 0, WF_CODEC_SAMPLES, (uint8_t *)(&vval[0])))
+      {
+        return (WF_CODEC_SAMPLES);
+      }
+      for (n=0; n<WF_CODEC_SAMPLES; ++n)
+      {
+        if (vval[n] != (&eptr[n].VanAFE)[chan - WF_CODEC_NUM_I])
+        {
+          bad[n] = TRUE;
+        }
+      }
+    }
+  }
+
+  num_bad = 0;
+  for (n=0; n<WF_CODEC_SAMPLES; ++n)
+  {
+    num_bad += bad[n];
+  }
+  return (num_bad);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_WfCodecCheck()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_WF_CODEC
+
+#endif                  // ENABLE_SPI1_DMA
+
+#endif                  // HOST_BUILD
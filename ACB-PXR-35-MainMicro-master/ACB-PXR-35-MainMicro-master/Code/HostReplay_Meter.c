@@ -0,0 +1,1701 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//                      gcc (x86-64 Linux) for the host build only
+//
+//  MODULE NAME:        HostReplay_Meter.c
+//
+//  MECHANICS:          Program module containing the metering benchmarks and checks for the host (off-target)
+//                      build.  This module is not part of the target project (PXR35_ProtProc.ewp).  It is
+//                      only compiled when HOST_BUILD is defined.
+//
+//                      With -harm, the sample stream is not run.  Instead, the harmonics computations of
+//                      Calc_Harmonics() (cycle-folded DFT) are compared with the previous FFT method for the
+//                      given number of trials, by Replay_HarmBench().
+//                      With -gather, the sample stream is not run.  Instead, moving the harmonics sample
+//                      windows out of SampleBuf is compared for the two SampleBuf layouts (sample sets and
+//                      by channel), by Replay_GatherBench().
+//                      With -sos, the sample stream is not run.  Instead, the integer one-cycle voltage sums
+//                      of squares (ENABLE_SIMD_SOS defined) are checked against exact sums and compared with
+//                      the floating point sums, by Replay_SOSBench().  This option is only available if
+//                      ENABLE_SIMD_SOS is defined.
+//                      With -afeblk, the sample stream is not run.  Instead, processing the AFE readings a
+//                      block at a time (blocks of 1, 4, and 8 samples) is compared with processing them one
+//                      channel at a time, by Replay_AFEBlockBench().
+//                      With -seq, the synthetic sample stream is run with random unbalanced waveforms, but
+//                      the anniversary subroutines are not.  Instead, the sequence components and phase
+//                      angles from the one-cycle phasors are checked against the SampleBuf[] computations
+//                      each cycle, and the two are timed, by Replay_SeqBench().  This option is only
+//                      available if ENABLE_SEQ_PHASOR is defined.
+//                      With -freq, the synthetic sample stream is run with the frequency swept between 45Hz
+//                      and 65Hz, and the tracked frequency and ROCOF are checked against the source each
+//                      cycle, by Replay_FreqBench().  Run it in builds with and without ENABLE_FREQ_RETUNE
+//                      to compare the one-cycle voltage error with and without the sample rate retune.  This
+//                      option is only available if ENABLE_FREQ_TRACK is defined.
+//
+//                      The options are parsed by main() in HostReplay.c.  The replay engine (Replay_Open(),
+//                      Replay_Sample()) and the timing and random number helpers (Replay_TimeStart(),
+//                      Replay_TimeStop(), Replay_Ratio(), Replay_RandF(), Replay_RandU()) are in
+//                      HostReplay.c.
+//
+//  TARGET HARDWARE:    None (host PC)
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   179    240302  DAH File Creation
+//                      - Moved Replay_HarmBench(), Replay_GatherBench(), Replay_GatherWin(),
+//                        Replay_GatherLines(), Replay_SOSBench(), Replay_SOS200msCheck(),
+//                        Replay_AFEBlockBench(), Replay_SeqBench(), Replay_SeqSynth(), Replay_SeqRef(),
+//                        Replay_SeqGet(), and Replay_FreqBench() from HostReplay.c
+//                      - Revised the benchmarks to use Replay_TimeStart(), Replay_TimeStop(), Replay_Ratio(),
+//                        Replay_RandF(), and Replay_RandU() in HostReplay.c
+//                      - Added Replay_SOSWave(), Replay_SOSFloat(), Replay_SOSExact(), and Replay_SOSDiff(),
+//                        for the code that was repeated in Replay_SOSBench() and Replay_SOS200msCheck()
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+//
+//------------------------------------------------------------------------------------------------------------
+//
+#ifdef HOST_BUILD
+
+//------------------------------------------------------------------------------------------------------------
+//                   Definitions
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global Definitions from external files...
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "stm32f4xx.h"
+#include "stm32f407xx.h"
+#include "RealTime_def.h"
+#include "Iod_def.h"
+#include "Demand_def.h"
+#include "Intr_def.h"
+#include "Meter_def.h"
+#include "Events_def.h"
+#include "Setpnt_def.h"
+#include "FRAM_Flash_def.h"             // Must be preceded by Events_def.h and Setpnt_def.h!
+#include "Test_def.h"
+#include "Prot_def.h"
+#include "HostShim_def.h"
+#include "Sched_def.h"
+#include "HostReplay_def.h"             // Must be preceded by Sched_def.h!
+
+//
+//      Local Definitions used in this module...
+//
+
+
+//
+//      Global Declarations from external files...
+//
+#include "Iod_ext.h"
+#include "Intr_ext.h"
+#include "Meter_ext.h"
+#include "Prot_ext.h"
+#include "HostReplay_ext.h"
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global (Visible) Function Prototypes (These functions are called by other modules)
+//
+void Replay_HarmBench(uint32_t trials, FILE *fp);
+void Replay_GatherBench(uint32_t trials, FILE *fp);
+#ifdef ENABLE_SIMD_SOS
+  void Replay_SOSBench(uint32_t trials, FILE *fp);
+#endif
+void Replay_AFEBlockBench(uint32_t trials, FILE *fp);
+#ifdef ENABLE_SEQ_PHASOR
+  void Replay_SeqBench(uint32_t cycles, FILE *fp);
+#endif
+#ifdef ENABLE_FREQ_TRACK
+  void Replay_FreqBench(uint32_t cycles, FILE *fp);
+#endif
+
+
+//      Local Function Prototypes (These functions are called only within this module)
+//
+void Replay_GatherWin(const uint8_t *p1, const uint8_t *p2, uint16_t stride, uint8_t type, float *x,
+                       uint16_t len);
+uint32_t Replay_GatherLines(uint32_t offset, uint16_t stride, uint8_t size, uint16_t len);
+#ifdef ENABLE_SIMD_SOS
+  void Replay_SOS200msCheck(uint32_t trials, float fline, float fsamp, FILE *fp);
+  void Replay_SOSWave(float w, uint16_t len, float *v_f, int16_t *v_i);
+  void Replay_SOSFloat(const float *v_f, uint16_t len, float *sum_f);
+  void Replay_SOSExact(const int16_t *v_i, uint16_t len, uint64_t *sum_ref);
+  void Replay_SOSDiff(const float *sum, const float *sum_f, float *rel_ln, float *rel_ll);
+#endif
+#ifdef ENABLE_SEQ_PHASOR
+  uint8_t Replay_SeqSynth(void);
+  void Replay_SeqRef(float *re, float *im);
+  void Replay_SeqGet(struct REPLAY_SEQ_OUT *out);
+#endif
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Storage Allocation - Global (Static) Variables
+//------------------------------------------------------------------------------------------------------------
+//
+//       These variables are used by other modules...
+//
+
+//       These variables are used only in this module...
+//
+
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Global Constants used in this module and other modules
+//------------------------------------------------------------------------------------------------------------
+//
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_HarmBench()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Compare the Harmonics Methods
+//
+//  MECHANICS:          This subroutine compares the cycle-folded DFT that is used in Calc_Harmonics() if
+//                      ENABLE_HARM_FOLD is defined with the FFT (chirp-z) method that is used otherwise,
+//                      Harm_FFTMag().  For each trial, a current and a
+//                      voltage waveform are generated in x_n[]: 12 cycles of a 60Hz fundamental, with
+//                      random harmonics, random interharmonics, and random phase angles.  The same random
+//                      sequence is used every time, so the results are repeatable.  Each waveform is run
+//                      through both methods, and the bins are grouped with Harm_Group() so that the
+//                      instantaneous harmonics can be compared directly.  The cycle-folded DFT is timed in
+//                      the same three pieces as the Calc_Harmonics() passes.
+//                      The host CPU time per waveform for each method, the longest pass of the cycle-folded
+//                      DFT, and the largest difference in the instantaneous harmonics are printed.  Since
+//                      the filtered harmonics (HarmonicsFil) are a weighted average of the instantaneous
+//                      harmonics, they differ by no more than the instantaneous harmonics do.
+//
+//  CAVEATS:            The host CPU times are only useful for comparing the two methods.  They are not the
+//                      target execution times.
+//                      This has not yet been run with the real SensorBus and CMSIS-DSP headers.  It must show
+//                      agreement before ENABLE_HARM_FOLD is used in a release.
+//
+//  INPUTS:             trials - the number of trials (each trial is one current and one voltage waveform)
+//                      fp - the output stream
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             x_n[]
+//
+//  CALLS:              srand(), Replay_RandF(), Replay_RandU(), cosf(), Harm_FFTMag(), Harm_FoldCycles(),
+//                      Harm_BinsMag(), Harm_Group(), Replay_TimeStart(), Replay_TimeStop(), Replay_Ratio(),
+//                      fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_HarmBench(uint32_t trials, FILE *fp)
+{
+  float amp[REPLAY_HARM_BINS], phase[REPLAY_HARM_BINS];
+  float mag_fft[REPLAY_HARM_BINS], mag_dft[REPLAY_HARM_BINS];
+  uint16_t inst_fft[40], inst_dft[40];
+  struct REPLAY_TIME fft_time, dft_time, pass_time;
+  uint32_t num_wf, num_diff, max_diff, diff;
+  uint32_t trial;
+  uint16_t k, n;
+  uint8_t curr;
+
+  srand(1);
+  memset(&fft_time, 0, sizeof(fft_time));
+  memset(&dft_time, 0, sizeof(dft_time));
+  memset(&pass_time, 0, sizeof(pass_time));
+  num_wf = 0;
+  num_diff = 0;
+  max_diff = 0;
+
+  for (trial=0; trial<trials; ++trial)
+  {
+    for (curr=0; curr<2; ++curr)
+    {
+      // Generate the waveform.  The fundamental is 1000 to 1500 (the scale does not matter, since the
+      //   harmonics are ratios).  Harmonics 2 thru 39 are up to REPLAY_HARM_MAX_PU, and some of the other
+      //   bins are interharmonics
+      for (k=0; k<REPLAY_HARM_BINS; ++k)
+      {
+        phase[k] = Replay_RandF(0.0f, 6.2831853f);
+        if ((k % 12) == 0)
+        {
+          amp[k] = Replay_RandF(0.0f, 1000.0f * REPLAY_HARM_MAX_PU);
+        }
+        else if (Replay_RandU(1, REPLAY_HARM_IH_ODDS) == 1)
+        {
+          amp[k] = Replay_RandF(0.0f, 1000.0f * REPLAY_HARM_IH_MAX_PU);
+        }
+        else
+        {
+          amp[k] = 0.0f;
+        }
+      }
+      amp[0] = 0.0f;
+      amp[12] = Replay_RandF(1000.0f, 1500.0f);
+      for (n=0; n<REPLAY_HARM_SAMPLES; ++n)
+      {
+        x_n[n] = 0.0f;
+        for (k=1; k<REPLAY_HARM_BINS; ++k)
+        {
+          if (amp[k] > 0.0f)
+          {
+            x_n[n] += amp[k] * cosf( (6.2831853f * (float)((k * n) % REPLAY_HARM_SAMPLES)
+                                        / (float)REPLAY_HARM_SAMPLES) + phase[k] );
+          }
+        }
+      }
+
+      // FFT method
+      Replay_TimeStart(&fft_time);
+      Harm_FFTMag(mag_fft);
+      Harm_Group(mag_fft, inst_fft, curr);
+      Replay_TimeStop(&fft_time);
+
+      // Cycle-folded DFT, timed in total and by pass
+      Replay_TimeStart(&dft_time);
+      Replay_TimeStart(&pass_time);
+      Harm_FoldCycles();
+      Replay_TimeStop(&pass_time);
+      Replay_TimeStart(&pass_time);
+      Harm_BinsMag(mag_dft, 1, 20, curr);
+      Replay_TimeStop(&pass_time);
+      Replay_TimeStart(&pass_time);
+      Harm_BinsMag(mag_dft, 21, 40, curr);
+      Harm_Group(mag_dft, inst_dft, curr);
+      Replay_TimeStop(&pass_time);
+      Replay_TimeStop(&dft_time);
+
+      // Compare the instantaneous harmonics
+      for (k=0; k<40; ++k)
+      {
+        diff = ( (inst_fft[k] > inst_dft[k]) ? (inst_fft[k] - inst_dft[k]) : (inst_dft[k] - inst_fft[k]) );
+        if (diff > 0)
+        {
+          ++num_diff;
+        }
+        if (diff > max_diff)
+        {
+          max_diff = diff;
+        }
+      }
+      ++num_wf;
+    }
+  }
+
+  if (num_wf == 0)
+  {
+    return;
+  }
+  fprintf(fp, "Harmonics comparison: %u waveforms (%u currents, %u voltages)\n", (unsigned int)num_wf,
+            (unsigned int)trials, (unsigned int)trials);
+  fprintf(fp, "FFT method:           avg %.0f nsec, max %u nsec per waveform\n",
+            Replay_Ratio(fft_time.Nsec, fft_time.Count), (unsigned int)fft_time.MaxNsec);
+  fprintf(fp, "Cycle-folded DFT:     avg %.0f nsec, max %u nsec per waveform, max %u nsec per pass\n",
+            Replay_Ratio(dft_time.Nsec, dft_time.Count), (unsigned int)dft_time.MaxNsec,
+            (unsigned int)pass_time.MaxNsec);
+  fprintf(fp, "Max difference:       %u counts (%u of %u harmonics differ)\n", (unsigned int)max_diff,
+            (unsigned int)num_diff, (unsigned int)(num_wf * 40));
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_HarmBench()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_GatherBench()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Compare the SampleBuf Layouts
+//
+//  MECHANICS:          This subroutine compares moving the harmonics sample windows out of SampleBuf when it
+//                      is stored as sample sets (struct RAM_SAMPLES SampleBuf[]) and when it is stored by
+//                      channel (struct RAM_SAMPLES_SOA, ENABLE_SAMPLE_SOA defined).  Both layouts are
+//                      allocated here and filled with the same random samples, so the comparison does not
+//                      depend on which layout the host build uses.
+//                      For each trial, a random starting index is chosen (so some windows wrap around the
+//                      end of the buffer), and the 12-cycle windows of the ten harmonics waveforms are moved
+//                      into x_n[] the same way as Calc_Harmonics() does for each layout:
+//                        - sample sets: one sample at a time, stepping by the size of a sample set
+//                        - by channel: one or two contiguous blocks (the currents are block copies)
+//                      The results of the two layouts must be identical.  The host CPU time per trial, the
+//                      bytes of samples used, and the number of lines of memory touched are printed for
+//                      each layout.
+//
+//  CAVEATS:            The host CPU times are only useful for comparing the two layouts.  They are not the
+//                      target execution times.
+//
+//  INPUTS:             trials - the number of trials (each trial is the ten harmonics waveforms)
+//                      fp - the output stream
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             x_n[]
+//
+//  CALLS:              malloc(), free(), srand(), Replay_RandF(), Replay_RandU(), memcpy(), memcmp(),
+//                      Replay_GatherWin(), Replay_GatherLines(), Replay_TimeStart(), Replay_TimeStop(),
+//                      Replay_Ratio(), fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_GatherBench(uint32_t trials, FILE *fp)
+{
+  // SampleBuf channels of the ten harmonics waveforms, as in Calc_Harmonics().  The second channel is only
+  //   used for the line-line voltages
+  static const uint8_t GATHER_CHAN[REPLAY_GATHER_WF][2] =
+  {
+    {SB_IA, 0}, {SB_IB, 0}, {SB_IC, 0}, {SB_IN, 0}, {SB_VANAFE, 0}, {SB_VBNAFE, 0}, {SB_VCNAFE, 0},
+    {SB_VANAFE, SB_VBNAFE}, {SB_VBNAFE, SB_VCNAFE}, {SB_VCNAFE, SB_VANAFE}
+  };
+  // Offset of each channel in a sample set, and of each channel's array in the by-channel buffer
+  static const uint32_t AOS_OFFSET[SB_NUM_CHANNELS] =
+  {
+    offsetof(struct RAM_SAMPLES, Ia), offsetof(struct RAM_SAMPLES, Ib), offsetof(struct RAM_SAMPLES, Ic),
+    offsetof(struct RAM_SAMPLES, In), offsetof(struct RAM_SAMPLES, Igsrc),
+    offsetof(struct RAM_SAMPLES, Igres), offsetof(struct RAM_SAMPLES, VanAFE),
+    offsetof(struct RAM_SAMPLES, VbnAFE), offsetof(struct RAM_SAMPLES, VcnAFE),
+    offsetof(struct RAM_SAMPLES, VanADC), offsetof(struct RAM_SAMPLES, VbnADC),
+    offsetof(struct RAM_SAMPLES, VcnADC)
+  };
+  static const uint32_t SOA_OFFSET[SB_NUM_CHANNELS] =
+  {
+    offsetof(struct RAM_SAMPLES_SOA, Ia), offsetof(struct RAM_SAMPLES_SOA, Ib),
+    offsetof(struct RAM_SAMPLES_SOA, Ic), offsetof(struct RAM_SAMPLES_SOA, In),
+    offsetof(struct RAM_SAMPLES_SOA, Igsrc), offsetof(struct RAM_SAMPLES_SOA, Igres),
+    offsetof(struct RAM_SAMPLES_SOA, VanAFE), offsetof(struct RAM_SAMPLES_SOA, VbnAFE),
+    offsetof(struct RAM_SAMPLES_SOA, VcnAFE), offsetof(struct RAM_SAMPLES_SOA, VanADC),
+    offsetof(struct RAM_SAMPLES_SOA, VbnADC), offsetof(struct RAM_SAMPLES_SOA, VcnADC)
+  };
+  float x_aos[REPLAY_HARM_SAMPLES];
+  struct RAM_SAMPLES *aos;
+  struct RAM_SAMPLES_SOA *soa;
+  struct REPLAY_TIME aos_time, soa_time;
+  uint64_t aos_lines, soa_lines, used_bytes;
+  uint32_t trial, num_err, ofs;
+  uint16_t ndx, len[2], ndx_blk[2];
+  uint8_t wf, blk, type, size, ch1, ch2;
+
+  aos = (struct RAM_SAMPLES *)malloc(TOTAL_SAMPLE_SETS * sizeof(struct RAM_SAMPLES));
+  soa = (struct RAM_SAMPLES_SOA *)malloc(sizeof(struct RAM_SAMPLES_SOA));
+  if ( (aos == NULL) || (soa == NULL) || (trials == 0) )
+  {
+    free(aos);
+    free(soa);
+    return;
+  }
+
+  // Fill both layouts with the same samples
+  srand(1);
+  for (ndx=0; ndx<TOTAL_SAMPLE_SETS; ++ndx)
+  {
+    aos[ndx].Ia = soa->Ia[ndx] = Replay_RandF(-1.0e6f, 1.0e6f);
+    aos[ndx].Ib = soa->Ib[ndx] = Replay_RandF(-1.0e6f, 1.0e6f);
+    aos[ndx].Ic = soa->Ic[ndx] = Replay_RandF(-1.0e6f, 1.0e6f);
+    aos[ndx].In = soa->In[ndx] = Replay_RandF(-1.0e6f, 1.0e6f);
+    aos[ndx].Igsrc = soa->Igsrc[ndx] = Replay_RandF(-1.0e6f, 1.0e6f);
+    aos[ndx].Igres = soa->Igres[ndx] = Replay_RandF(-1.0e6f, 1.0e6f);
+    aos[ndx].VanAFE = soa->VanAFE[ndx] = (int16_t)((int32_t)Replay_RandU(0, 60000) - 30000);
+    aos[ndx].VbnAFE = soa->VbnAFE[ndx] = (int16_t)((int32_t)Replay_RandU(0, 60000) - 30000);
+    aos[ndx].VcnAFE = soa->VcnAFE[ndx] = (int16_t)((int32_t)Replay_RandU(0, 60000) - 30000);
+    aos[ndx].VanADC = soa->VanADC[ndx] = (int16_t)((int32_t)Replay_RandU(0, 60000) - 30000);
+    aos[ndx].VbnADC = soa->VbnADC[ndx] = (int16_t)((int32_t)Replay_RandU(0, 60000) - 30000);
+    aos[ndx].VcnADC = soa->VcnADC[ndx] = (int16_t)((int32_t)Replay_RandU(0, 60000) - 30000);
+  }
+
+  memset(&aos_time, 0, sizeof(aos_time));
+  memset(&soa_time, 0, sizeof(soa_time));
+  aos_lines = 0;
+  soa_lines = 0;
+  used_bytes = 0;
+  num_err = 0;
+
+  for (trial=0; trial<trials; ++trial)
+  {
+    // Split the window into the part up to the end of the buffer and the part from the start
+    ndx = (uint16_t)Replay_RandU(0, (TOTAL_SAMPLE_SETS - 1));
+    ndx_blk[0] = ndx;
+    ndx_blk[1] = 0;
+    len[0] = ( (ndx > (TOTAL_SAMPLE_SETS - REPLAY_HARM_SAMPLES)) ?
+                 (TOTAL_SAMPLE_SETS - ndx) : REPLAY_HARM_SAMPLES );
+    len[1] = REPLAY_HARM_SAMPLES - len[0];
+
+    for (wf=0; wf<REPLAY_GATHER_WF; ++wf)
+    {
+      ch1 = GATHER_CHAN[wf][0];
+      ch2 = GATHER_CHAN[wf][1];
+      // type: 0 = float, 1 = int16, 2 = difference of two int16's
+      type = ( (ch1 < SB_VANAFE) ? 0 : ((wf < 7) ? 1 : 2) );
+      size = ( (type == 0) ? sizeof(float) : sizeof(int16_t) );
+
+      // Sample sets
+      Replay_TimeStart(&aos_time);
+      for (blk=0; blk<2; ++blk)
+      {
+        Replay_GatherWin(((uint8_t *)&aos[ndx_blk[blk]] + AOS_OFFSET[ch1]),
+                         ((uint8_t *)&aos[ndx_blk[blk]] + AOS_OFFSET[ch2]), sizeof(struct RAM_SAMPLES), type,
+                         &x_aos[(blk == 0) ? 0 : len[0]], len[blk]);
+      }
+      Replay_TimeStop(&aos_time);
+
+      // By channel
+      Replay_TimeStart(&soa_time);
+      for (blk=0; blk<2; ++blk)
+      {
+        ofs = ndx_blk[blk] * size;
+        if (type == 0)
+        {
+          memcpy(&x_n[(blk == 0) ? 0 : len[0]], ((uint8_t *)soa + SOA_OFFSET[ch1] + ofs),
+                   (len[blk] * sizeof(float)));
+        }
+        else
+        {
+          Replay_GatherWin(((uint8_t *)soa + SOA_OFFSET[ch1] + ofs), ((uint8_t *)soa + SOA_OFFSET[ch2] + ofs),
+                           size, type, &x_n[(blk == 0) ? 0 : len[0]], len[blk]);
+        }
+      }
+      Replay_TimeStop(&soa_time);
+
+      if (memcmp(x_aos, x_n, sizeof(x_aos)) != 0)
+      {
+        ++num_err;
+      }
+
+      // Memory touched
+      for (blk=0; blk<2; ++blk)
+      {
+        aos_lines += Replay_GatherLines((ndx_blk[blk] * sizeof(struct RAM_SAMPLES) + AOS_OFFSET[ch1]),
+                                          sizeof(struct RAM_SAMPLES), size, len[blk]);
+        soa_lines += Replay_GatherLines((ndx_blk[blk] * size + SOA_OFFSET[ch1]), size, size, len[blk]);
+        if (type == 2)
+        {
+          aos_lines += Replay_GatherLines((ndx_blk[blk] * sizeof(struct RAM_SAMPLES) + AOS_OFFSET[ch2]),
+                                            sizeof(struct RAM_SAMPLES), size, len[blk]);
+          soa_lines += Replay_GatherLines((ndx_blk[blk] * size + SOA_OFFSET[ch2]), size, size, len[blk]);
+        }
+      }
+      used_bytes += (uint64_t)REPLAY_HARM_SAMPLES * size * ((type == 2) ? 2 : 1);
+    }
+  }
+
+  free(aos);
+  free(soa);
+
+  fprintf(fp, "SampleBuf gather comparison: %u trials of %u waveforms x %u samples\n", (unsigned int)trials,
+            (unsigned int)REPLAY_GATHER_WF, (unsigned int)REPLAY_HARM_SAMPLES);
+  fprintf(fp, "Sample bytes used:    %.0f per trial\n", Replay_Ratio(used_bytes, trials));
+  fprintf(fp, "Sample sets:          avg %.0f nsec, %.0f lines (%.0f bytes) touched per trial\n",
+            Replay_Ratio(aos_time.Nsec, trials), Replay_Ratio(aos_lines, trials),
+            Replay_Ratio((double)aos_lines * REPLAY_GATHER_LINE, trials));
+  fprintf(fp, "By channel:           avg %.0f nsec, %.0f lines (%.0f bytes) touched per trial\n",
+            Replay_Ratio(soa_time.Nsec, trials), Replay_Ratio(soa_lines, trials),
+            Replay_Ratio((double)soa_lines * REPLAY_GATHER_LINE, trials));
+  fprintf(fp, "Mismatched windows:   %u\n", (unsigned int)num_err);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_GatherBench()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_GatherWin()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Move a Block of Samples
+//
+//  MECHANICS:          This subroutine moves len samples into x[], beginning at p1 and stepping by stride
+//                      bytes.  The samples are floats (type 0), int16's (type 1), or the difference of the
+//                      int16's at p1 and p2 (type 2, line-line voltages).  This is the same as the moves in
+//                      Calc_Harmonics().
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             p1, p2 - the first samples (p2 is only used for type 2)
+//                      stride - the number of bytes from one sample to the next
+//                      type - the sample type
+//                      len - the number of samples
+//
+//  OUTPUTS:            x[]
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_GatherWin(const uint8_t *p1, const uint8_t *p2, uint16_t stride, uint8_t type, float *x,
+                       uint16_t len)
+{
+  uint16_t i;
+
+  for (i=0; i<len; ++i)
+  {
+    if (type == 0)
+    {
+      x[i] = *((const float *)p1);
+    }
+    else if (type == 1)
+    {
+      x[i] = (float)(*((const int16_t *)p1));
+    }
+    else
+    {
+      x[i] = (float)(*((const int16_t *)p1)) - (float)(*((const int16_t *)p2));
+    }
+    p1 += stride;
+    p2 += stride;
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_GatherWin()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_GatherLines()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Count the Memory Lines Touched
+//
+//  MECHANICS:          This subroutine returns the number of REPLAY_GATHER_LINE-byte lines that are touched
+//                      by reading len samples of size bytes, beginning at offset bytes from the start of the
+//                      buffer and stepping by stride bytes.  The buffer is assumed to begin on a line.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             offset, stride, size, len
+//
+//  OUTPUTS:            Returns the number of lines
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint32_t Replay_GatherLines(uint32_t offset, uint16_t stride, uint8_t size, uint16_t len)
+{
+  uint32_t lines, line, last_line;
+  uint16_t i;
+
+  lines = 0;
+  last_line = 0xFFFFFFFF;
+  for (i=0; i<len; ++i)
+  {
+    for (line=(offset / REPLAY_GATHER_LINE); line<=((offset + size - 1) / REPLAY_GATHER_LINE); ++line)
+    {
+      if (line != last_line)
+      {
+        ++lines;
+        last_line = line;
+      }
+    }
+    offset += stride;
+  }
+  return (lines);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_GatherLines()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+#ifdef ENABLE_SIMD_SOS
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_SOSBench()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Compare the Voltage Sum-of-Squares Methods
+//
+//  MECHANICS:          This subroutine checks the integer one-cycle voltage sums of squares that are
+//                      computed by Volt_SOS_Block() when ENABLE_SIMD_SOS is defined.  For each trial, one
+//                      cycle of three-phase voltages is generated: random amplitudes up to
+//                      REPLAY_SOS_MAX_VLN, phases about 120 degrees apart, and random 3rd and 5th harmonics.
+//                      The voltages are converted to int16's (volts x 10) the same way as in
+//                      buffer_samples().  Then:
+//                        - The int16 samples are run through Volt_SOS_Block() in two blocks, split at a
+//                          random sample (so odd block lengths are covered), the same as the two half-cycle
+//                          blocks in update_Volt_SOS_Block()
+//                        - The same sums are computed one sample at a time in 64-bit integers, with the
+//                          line-to-line voltages saturated to an int16.  These must match the
+//                          Volt_SOS_Block() sums exactly
+//                        - The float voltages are squared and summed one sample at a time, the same as the
+//                          one-cycle sums in update_VlnAFE_SOS() and update_VllAFE_SOS().  The largest
+//                          difference between these and the converted integer sums is printed.  The
+//                          difference is due to the 0.1V resolution of the samples in SampleBuf, not to the
+//                          arithmetic
+//                      The host CPU time per cycle of the per-sample float sums and of Volt_SOS_Block() is
+//                      also printed.
+//                      Finally, the ADC 200msec sums are checked at 50Hz and 60Hz by Replay_SOS200msCheck().
+//
+//  CAVEATS:            Only included if ENABLE_SIMD_SOS is defined.
+//                      In the host build, Volt_SOS_Block() uses the portable C SIMD functions in
+//                      HostShim_def.h, so this checks the packing and lane handling of the kernel, and the
+//                      host functions against the exact sums.  The host CPU times are only useful for
+//                      comparing the two methods.  They are not the target execution times.
+//
+//  INPUTS:             trials - the number of trials (each trial is one cycle of three-phase voltages)
+//                      fp - the output stream
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              srand(), Replay_SOSWave(), Replay_SOSFloat(), Replay_RandU(), Volt_SOS_Block(),
+//                      Replay_SOSExact(), Replay_SOSDiff(), Replay_TimeStart(), Replay_TimeStop(),
+//                      Replay_Ratio(), fprintf(), Replay_SOS200msCheck()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_SOSBench(uint32_t trials, FILE *fp)
+{
+  float v_f[3][REPLAY_SOS_SAMPLES];
+  int16_t v_i[3][REPLAY_SOS_SAMPLES];
+  float sum_f[6], sum_c[6], rel_ln, rel_ll;
+  uint64_t sum_ref[6];
+  struct REPLAY_TIME float_time, simd_time;
+  uint32_t trial, num_err;
+  uint16_t split;
+  uint8_t k;
+  struct VOLTAGES_I sum_i;
+
+  srand(1);
+  memset(&float_time, 0, sizeof(float_time));
+  memset(&simd_time, 0, sizeof(simd_time));
+  num_err = 0;
+  rel_ln = 0.0f;
+  rel_ll = 0.0f;
+
+  for (trial=0; trial<trials; ++trial)
+  {
+    // Generate one cycle of voltages
+    Replay_SOSWave((6.2831853f / (float)REPLAY_SOS_SAMPLES), REPLAY_SOS_SAMPLES, &v_f[0][0], &v_i[0][0]);
+
+    // Float sums, one sample at a time
+    Replay_TimeStart(&float_time);
+    Replay_SOSFloat(&v_f[0][0], REPLAY_SOS_SAMPLES, sum_f);
+    Replay_TimeStop(&float_time);
+
+    // Integer sums with Volt_SOS_Block(), in two blocks
+    split = (uint16_t)Replay_RandU(1, (REPLAY_SOS_SAMPLES - 1));
+    memset(&sum_i, 0, sizeof(sum_i));
+    Replay_TimeStart(&simd_time);
+    Volt_SOS_Block(&v_i[0][0], &v_i[1][0], &v_i[2][0], 1, split, &sum_i);
+    Volt_SOS_Block(&v_i[0][split], &v_i[1][split], &v_i[2][split], 1, (REPLAY_SOS_SAMPLES - split), &sum_i);
+    Replay_TimeStop(&simd_time);
+
+    // Exact integer sums, one sample at a time
+    Replay_SOSExact(&v_i[0][0], REPLAY_SOS_SAMPLES, sum_ref);
+    if ( (sum_i.Van != sum_ref[0]) || (sum_i.Vbn != sum_ref[1]) || (sum_i.Vcn != sum_ref[2])
+      || (sum_i.Vab != sum_ref[3]) || (sum_i.Vbc != sum_ref[4]) || (sum_i.Vca != sum_ref[5]) )
+    {
+      ++num_err;
+    }
+
+    // Largest relative difference from the float sums
+    for (k=0; k<6; ++k)
+    {
+      sum_c[k] = ((float)sum_ref[k])/100;
+    }
+    Replay_SOSDiff(sum_c, sum_f, &rel_ln, &rel_ll);
+  }
+
+  if (trials == 0)
+  {
+    return;
+  }
+  fprintf(fp, "Voltage sum-of-squares comparison: %u trials of %u samples\n", (unsigned int)trials,
+            (unsigned int)REPLAY_SOS_SAMPLES);
+  fprintf(fp, "Float, per sample:    avg %.0f nsec per cycle\n", Replay_Ratio(float_time.Nsec, trials));
+  fprintf(fp, "Volt_SOS_Block():     avg %.0f nsec per cycle\n", Replay_Ratio(simd_time.Nsec, trials));
+  fprintf(fp, "Mismatched sums:      %u\n", (unsigned int)num_err);
+  fprintf(fp, "Max diff from float:  %.4f%% (l-n), %.4f%% (l-l)\n", (double)rel_ln * 100,
+            (double)rel_ll * 100);
+
+  Replay_SOS200msCheck(trials, 50.0f, 4000.0f, fp);
+  Replay_SOS200msCheck(trials, 60.0f, 4800.0f, fp);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_SOSBench()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_SOS200msCheck()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Check the ADC 200msec Voltage Sums of Squares
+//
+//  MECHANICS:          If ENABLE_SIMD_SOS is defined, the ADC (line side) 200msec voltage sums of squares,
+//                      VolADC200msSOS_Sum, are no longer updated each sample in update_VlnADC_SOS() and
+//                      update_VllADC_SOS().  Instead, save_OC_SOS() adds the ADC one-cycle sums to them on
+//                      each one-cycle anniversary, and then resets the one-cycle sums (the float one-cycle
+//                      sums are also reset there).  The 200msec sums are still saved and reset by
+//                      save_200msec_SOS() every 960 samples.  Since 960 is 12 x 80, and OneCycInd and
+//                      msec200Ctr are reset together, the 200msec anniversary is always a one-cycle
+//                      anniversary, and save_OC_SOS() runs first.  The sampling rate is set for 80 samples
+//                      per cycle at both 50Hz (4000Hz) and 60Hz (4800Hz), so this is true at both
+//                      frequencies.
+//                      This subroutine checks this with REPLAY_SOS_200MS_CYC cycles of samples.  For each
+//                      trial, three-phase voltages are generated the same way as in Replay_SOSBench(), at
+//                      a line frequency within REPLAY_SOS_FDEV_PU of fline, sampled at fsamp.  Then:
+//                        - The float voltages are squared and summed one sample at a time over the whole
+//                          window, the same as VolADC200msSOS_Sum in update_VlnADC_SOS() and
+//                          update_VllADC_SOS()
+//                        - Each cycle is run through Volt_SOS_Block() in two half-cycle blocks, the same as
+//                          update_Volt_SOS_Block().  The integer one-cycle sums are converted and added to
+//                          the 200msec sums, and then reset, the same as save_OC_SOS()
+//                        - The integer sums of all of the samples in the window are computed one sample at
+//                          a time.  The total of the integer one-cycle sums must match these exactly, so
+//                          that no sample is lost or counted twice when the one-cycle sums are reset
+//                      The number of mismatched windows and the largest difference between the two 200msec
+//                      sums are printed.  As in Replay_SOSBench(), the difference is due to the 0.1V
+//                      resolution of the samples in SampleBuf.
+//
+//  CAVEATS:            Only included if ENABLE_SIMD_SOS is defined.
+//                      This models the order of the one-cycle and 200msec anniversaries in the sampling
+//                      interrupt.  It does not run DMA1_Stream0_IRQHandler() itself.
+//
+//  INPUTS:             trials - the number of trials (each trial is one 200msec window)
+//                      fline - the nominal line frequency (50Hz or 60Hz)
+//                      fsamp - the sampling rate for fline (4000Hz or 4800Hz)
+//                      fp - the output stream
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              srand(), Replay_RandF(), Replay_SOSWave(), Replay_SOSFloat(), Volt_SOS_Block(),
+//                      Replay_SOSExact(), Replay_SOSDiff(), fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_SOS200msCheck(uint32_t trials, float fline, float fsamp, FILE *fp)
+{
+  float v_f[3][REPLAY_SOS_SAMPLES * REPLAY_SOS_200MS_CYC];
+  int16_t v_i[3][REPLAY_SOS_SAMPLES * REPLAY_SOS_200MS_CYC];
+  float sum_f[6], sum_200[6], w, rel_ln, rel_ll;
+  uint64_t sum_ref[6], sum_tot[6];
+  uint32_t trial, num_err;
+  uint16_t cyc, first;
+  uint8_t k;
+  struct VOLTAGES_I sum_i;
+
+  srand(2);
+  num_err = 0;
+  rel_ln = 0.0f;
+  rel_ll = 0.0f;
+
+  for (trial=0; trial<trials; ++trial)
+  {
+    // Generate the window of voltages, at a line frequency near fline
+    w = 6.2831853f * fline * Replay_RandF((1.0f - REPLAY_SOS_FDEV_PU), (1.0f + REPLAY_SOS_FDEV_PU)) / fsamp;
+    Replay_SOSWave(w, (REPLAY_SOS_SAMPLES * REPLAY_SOS_200MS_CYC), &v_f[0][0], &v_i[0][0]);
+
+    // Float 200msec sums, one sample at a time
+    Replay_SOSFloat(&v_f[0][0], (REPLAY_SOS_SAMPLES * REPLAY_SOS_200MS_CYC), sum_f);
+
+    // 200msec sums from the integer one-cycle sums, one cycle at a time
+    for (k=0; k<6; ++k)
+    {
+      sum_200[k] = 0.0f;
+      sum_tot[k] = 0;
+    }
+    memset(&sum_i, 0, sizeof(sum_i));
+    for (cyc=0; cyc<REPLAY_SOS_200MS_CYC; ++cyc)
+    {
+      first = cyc * REPLAY_SOS_SAMPLES;
+      Volt_SOS_Block(&v_i[0][first], &v_i[1][first], &v_i[2][first], 1, (REPLAY_SOS_SAMPLES/2), &sum_i);
+      first += (REPLAY_SOS_SAMPLES/2);
+      Volt_SOS_Block(&v_i[0][first], &v_i[1][first], &v_i[2][first], 1, (REPLAY_SOS_SAMPLES/2), &sum_i);
+      sum_200[0] += ((float)sum_i.Van)/100;
+      sum_200[1] += ((float)sum_i.Vbn)/100;
+      sum_200[2] += ((float)sum_i.Vcn)/100;
+      sum_200[3] += ((float)sum_i.Vab)/100;
+      sum_200[4] += ((float)sum_i.Vbc)/100;
+      sum_200[5] += ((float)sum_i.Vca)/100;
+      sum_tot[0] += sum_i.Van;
+      sum_tot[1] += sum_i.Vbn;
+      sum_tot[2] += sum_i.Vcn;
+      sum_tot[3] += sum_i.Vab;
+      sum_tot[4] += sum_i.Vbc;
+      sum_tot[5] += sum_i.Vca;
+      memset(&sum_i, 0, sizeof(sum_i));
+    }
+
+    // Exact integer sums of the whole window, one sample at a time
+    Replay_SOSExact(&v_i[0][0], (REPLAY_SOS_SAMPLES * REPLAY_SOS_200MS_CYC), sum_ref);
+    for (k=0; k<6; ++k)
+    {
+      if (sum_tot[k] != sum_ref[k])
+      {
+        ++num_err;
+        break;
+      }
+    }
+
+    // Largest relative difference from the per-sample float sums
+    Replay_SOSDiff(sum_200, sum_f, &rel_ln, &rel_ll);
+  }
+
+  if (trials == 0)
+  {
+    return;
+  }
+  fprintf(fp, "ADC 200msec sums at %.0fHz (%.0f samples/sec): %u windows of %u cycles\n", (double)fline,
+            (double)fsamp, (unsigned int)trials, (unsigned int)REPLAY_SOS_200MS_CYC);
+  fprintf(fp, "Mismatched windows:   %u\n", (unsigned int)num_err);
+  fprintf(fp, "Max diff from float:  %.4f%% (l-n), %.4f%% (l-l)\n", (double)rel_ln * 100,
+            (double)rel_ll * 100);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_SOS200msCheck()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_SOSWave() thru Replay_SOSDiff()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Voltage Sum-of-Squares Test Data and Reference Sums
+//
+//  MECHANICS:          These subroutines are shared by Replay_SOSBench() and Replay_SOS200msCheck().  The
+//                      voltages are in three arrays of len samples (Van, Vbn, Vcn), one after the other.
+//                      Replay_SOSWave() generates the voltages: random amplitudes from 10% of
+//                      REPLAY_SOS_MAX_VLN (so that the relative difference is meaningful) to
+//                      REPLAY_SOS_MAX_VLN, phases about 120 degrees apart, and random 3rd and 5th harmonics,
+//                      with w radians per sample.  The voltages are converted to int16's (volts x 10) the
+//                      same way as in buffer_samples().
+//                      Replay_SOSFloat() squares and sums the float voltages one sample at a time, the same
+//                      as the one-cycle sums in update_VlnAFE_SOS() and update_VllAFE_SOS().
+//                      Replay_SOSExact() computes the same sums one sample at a time in 64-bit integers, with
+//                      the line-to-line voltages saturated to an int16.
+//                      Replay_SOSDiff() updates the largest relative differences of the sums from the float
+//                      sums, line-to-neutral (0 - 2) and line-to-line (3 - 5).
+//
+//  CAVEATS:            Only included if ENABLE_SIMD_SOS is defined
+//
+//  INPUTS:             w - the line frequency in radians per sample
+//                      len - the number of samples of each voltage
+//                      v_f, v_i - the float and int16 voltages
+//                      sum, sum_f - the sums to compare, and the float sums
+//
+//  OUTPUTS:            v_f, v_i, sum_f, sum_ref, *rel_ln, *rel_ll
+//
+//  ALTERS:             None
+//
+//  CALLS:              Replay_RandF(), sinf(), fabsf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_SOSWave(float w, uint16_t len, float *v_f, int16_t *v_i)
+{
+  float amp[3], ph[3], h3, h5, ftemp;
+  uint16_t n;
+  uint8_t k;
+
+  h3 = Replay_RandF(0.0f, 0.10f);
+  h5 = Replay_RandF(0.0f, 0.05f);
+  for (k=0; k<3; ++k)
+  {
+    amp[k] = 1.41421356f * REPLAY_SOS_MAX_VLN * Replay_RandF(0.1f, 1.0f);
+    ph[k] = (6.2831853f * (float)k / 3.0f) + Replay_RandF(0.0f, 0.1f);
+  }
+  for (n=0; n<len; ++n)
+  {
+    ftemp = w * (float)n;
+    for (k=0; k<3; ++k)
+    {
+      v_f[k*len + n] = amp[k] * ( sinf(ftemp - ph[k]) + h3 * sinf(3.0f * (ftemp - ph[k]))
+                                    + h5 * sinf(5.0f * (ftemp - ph[k])) );
+      v_i[k*len + n] = (int16_t)(v_f[k*len + n] * 10);
+    }
+  }
+}
+
+
+void Replay_SOSFloat(const float *v_f, uint16_t len, float *sum_f)
+{
+  const float *va, *vb, *vc;
+  float ftemp;
+  uint16_t n;
+  uint8_t k;
+
+  va = &v_f[0];
+  vb = &v_f[len];
+  vc = &v_f[2*len];
+  for (k=0; k<6; ++k)
+  {
+    sum_f[k] = 0.0f;
+  }
+  for (n=0; n<len; ++n)
+  {
+    sum_f[0] += va[n] * va[n];
+    sum_f[1] += vb[n] * vb[n];
+    sum_f[2] += vc[n] * vc[n];
+    ftemp = va[n] - vb[n];
+    sum_f[3] += ftemp * ftemp;
+    ftemp = vb[n] - vc[n];
+    sum_f[4] += ftemp * ftemp;
+    ftemp = vc[n] - va[n];
+    sum_f[5] += ftemp * ftemp;
+  }
+}
+
+
+void Replay_SOSExact(const int16_t *v_i, uint16_t len, uint64_t *sum_ref)
+{
+  int32_t itemp;
+  uint16_t n;
+  uint8_t k;
+
+  for (k=0; k<6; ++k)
+  {
+    sum_ref[k] = 0;
+  }
+  for (n=0; n<len; ++n)
+  {
+    for (k=0; k<3; ++k)
+    {
+      sum_ref[k] += (uint64_t)((int32_t)v_i[k*len + n] * v_i[k*len + n]);
+      itemp = (int32_t)v_i[k*len + n] - v_i[((k + 1) % 3)*len + n];
+      itemp = ( (itemp > 32767) ? 32767 : ((itemp < -32768) ? -32768 : itemp) );
+      sum_ref[k + 3] += (uint64_t)(itemp * itemp);
+    }
+  }
+}
+
+
+void Replay_SOSDiff(const float *sum, const float *sum_f, float *rel_ln, float *rel_ll)
+{
+  float ftemp;
+  uint8_t k;
+
+  for (k=0; k<6; ++k)
+  {
+    ftemp = fabsf(sum[k] - sum_f[k]) / sum_f[k];
+    if (k < 3)
+    {
+      *rel_ln = ( (ftemp > *rel_ln) ? ftemp : *rel_ln );
+    }
+    else
+    {
+      *rel_ll = ( (ftemp > *rel_ll) ? ftemp : *rel_ll );
+    }
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_SOSWave() thru Replay_SOSDiff()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_SIMD_SOS
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_AFEBlockBench()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Compare the AFE Sample Processing Methods
+//
+//  MECHANICS:          This subroutine compares processing the AFE readings one channel at a time with
+//                      AFE_Process_Chan() and a block at a time with AFE_Process_Block().  For each trial,
+//                      REPLAY_AFEBLK_SAMPLES frames of AFE readings are generated: one sinusoid per channel,
+//                      with a random amplitude up to REPLAY_AFEBLK_MAX_PU of full scale and a random phase.
+//                      The trials alternate between Rogowski and CT sensors for In and Igsrc, so that both
+//                      calibration index selections are covered.  Then:
+//                        - The frames are copied one at a time into AFE_single_capture[] and processed with
+//                          AFE_Process_Chan().  AFE_new_samples[] and MTR_new_samples[] are saved as the
+//                          reference results
+//                        - The integrator and filter states are restored, and the frames are processed with
+//                          AFE_Process_Block() in blocks of 1, 4, and 8 frames.  The results must match the
+//                          reference results exactly.  A block that is not accepted by AFE_Process_Block()
+//                          is counted, and is processed with AFE_Process_Chan() instead
+//                      The host CPU time per sample (frame) of each method is printed.
+//
+//  CAVEATS:            The AFE_Process_Chan() times include copying the frame into AFE_single_capture[] and
+//                      the results out of AFE_new_samples[] and MTR_new_samples[].
+//                      The host CPU times are only useful for comparing the methods.  They are not the target
+//                      execution times.
+//                      The integrator and filter states are restored on exit, so this may be run before the
+//                      sample stream.
+//
+//  INPUTS:             trials - the number of trials
+//                      fp - the output stream
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             GPIOD->ODR (restored on exit)
+//
+//  CALLS:              srand(), Replay_RandF(), sinf(), lrintf(), memcpy(), memcmp(), AFE_Process_Chan(),
+//                      AFE_Process_Block(), Replay_TimeStart(), Replay_TimeStop(), Replay_Ratio(), fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_AFEBlockBench(uint32_t trials, FILE *fp)
+{
+  static uint16_t frames[REPLAY_AFEBLK_SAMPLES][AFE_FRAME_WORDS];
+  static float ref_afe[REPLAY_AFEBLK_SAMPLES][8], ref_mtr[REPLAY_AFEBLK_SAMPLES][8];
+  static float blk_afe[REPLAY_AFEBLK_SAMPLES][8], blk_mtr[REPLAY_AFEBLK_SAMPLES][8];
+  const uint8_t blk_size[3] = {1, 4, 8};
+  float ss_save[5], prev_save[5], mtr_save[8];
+  float amp[8], ph[8];
+  struct REPLAY_TIME chan_time, blk_time[3];
+  uint32_t trial, odr_save, num_err, num_chan;
+  int32_t code;
+  uint16_t n, m;
+  uint8_t k, b;
+
+  srand(1);
+  odr_save = GPIOD->ODR;
+  memcpy(&ss_save[0], &ss[0], sizeof(ss_save));
+  memcpy(&prev_save[0], &AFE_PrevSample[0], sizeof(prev_save));
+  memcpy(&mtr_save[0], &MTR_ss[0], sizeof(mtr_save));
+  memset(&chan_time, 0, sizeof(chan_time));
+  memset(&blk_time[0], 0, sizeof(blk_time));
+  num_err = 0;
+  num_chan = 0;
+
+  for (trial=0; trial<trials; ++trial)
+  {
+    if (trial & 1)                                  // In and Igsrc CT sensors
+    {
+      GPIOD->ODR &= ~0x4001U;
+    }
+    else                                            // In and Igsrc Rogowski sensors
+    {
+      GPIOD->ODR |= 0x4001U;
+    }
+
+    // Generate the frames, in the same format as the AFE readings (see Replay_EncodeAFE())
+    for (k=0; k<8; ++k)
+    {
+      amp[k] = Replay_RandF(0.0f, REPLAY_AFEBLK_MAX_PU * (float)REPLAY_AFE_MAX_CODE);
+      ph[k] = Replay_RandF(0.0f, 6.2831853f);
+    }
+    for (n=0; n<REPLAY_AFEBLK_SAMPLES; ++n)
+    {
+      for (k=0; k<8; ++k)
+      {
+        code = (int32_t)lrintf(amp[k] * sinf((6.2831853f * (float)n / 80.0f) - ph[k]));
+        frames[n][2*k] = (uint16_t)( (((uint16_t)k) << 12) | (((uint32_t)code >> 16) & 0x00FF) );
+        frames[n][2*k + 1] = (uint16_t)((uint32_t)code & 0xFFFF);
+      }
+    }
+
+    // Reference results, one channel at a time
+    memcpy(&ss[0], &ss_save[0], sizeof(ss_save));
+    memcpy(&AFE_PrevSample[0], &prev_save[0], sizeof(prev_save));
+    memcpy(&MTR_ss[0], &mtr_save[0], sizeof(mtr_save));
+    Replay_TimeStart(&chan_time);
+    for (n=0; n<REPLAY_AFEBLK_SAMPLES; ++n)
+    {
+      memcpy(&AFE_single_capture[0], &frames[n][0], sizeof(AFE_single_capture));
+      AFE_Process_Chan();
+      memcpy(&ref_afe[n][0], &AFE_new_samples[0], sizeof(AFE_new_samples));
+      memcpy(&ref_mtr[n][0], &MTR_new_samples[0], sizeof(MTR_new_samples));
+    }
+    Replay_TimeStop(&chan_time);
+
+    // Block results
+    for (b=0; b<3; ++b)
+    {
+      memcpy(&ss[0], &ss_save[0], sizeof(ss_save));
+      memcpy(&AFE_PrevSample[0], &prev_save[0], sizeof(prev_save));
+      memcpy(&MTR_ss[0], &mtr_save[0], sizeof(mtr_save));
+      Replay_TimeStart(&blk_time[b]);
+      for (n=0; n<REPLAY_AFEBLK_SAMPLES; n+=blk_size[b])
+      {
+        if (!AFE_Process_Block(&frames[n][0], blk_size[b], &blk_afe[n], &blk_mtr[n]))
+        {
+          ++num_chan;
+          for (m=n; m<(n + blk_size[b]); ++m)
+          {
+            memcpy(&AFE_single_capture[0], &frames[m][0], sizeof(AFE_single_capture));
+            AFE_Process_Chan();
+            memcpy(&blk_afe[m][0], &AFE_new_samples[0], sizeof(AFE_new_samples));
+            memcpy(&blk_mtr[m][0], &MTR_new_samples[0], sizeof(MTR_new_samples));
+          }
+        }
+      }
+      Replay_TimeStop(&blk_time[b]);
+      for (n=0; n<REPLAY_AFEBLK_SAMPLES; ++n)
+      {
+        if ( (memcmp(&blk_afe[n][0], &ref_afe[n][0], sizeof(blk_afe[n])) != 0)
+          || (memcmp(&blk_mtr[n][0], &ref_mtr[n][0], sizeof(blk_mtr[n])) != 0) )
+        {
+          ++num_err;
+        }
+      }
+    }
+  }
+
+  GPIOD->ODR = odr_save;
+  memcpy(&ss[0], &ss_save[0], sizeof(ss_save));
+  memcpy(&AFE_PrevSample[0], &prev_save[0], sizeof(prev_save));
+  memcpy(&MTR_ss[0], &mtr_save[0], sizeof(mtr_save));
+
+  if (trials == 0)
+  {
+    return;
+  }
+  fprintf(fp, "AFE sample processing comparison: %u trials of %u samples\n", (unsigned int)trials,
+            (unsigned int)REPLAY_AFEBLK_SAMPLES);
+  fprintf(fp, "AFE_Process_Chan():              avg %.1f nsec per sample\n",
+            Replay_Ratio(chan_time.Nsec, ((double)trials * REPLAY_AFEBLK_SAMPLES)));
+  for (b=0; b<3; ++b)
+  {
+    fprintf(fp, "AFE_Process_Block(), %u per block: avg %.1f nsec per sample\n", (unsigned int)blk_size[b],
+              Replay_Ratio(blk_time[b].Nsec, ((double)trials * REPLAY_AFEBLK_SAMPLES)));
+  }
+  fprintf(fp, "Mismatched samples:               %u\n", (unsigned int)num_err);
+  fprintf(fp, "Blocks not accepted:              %u\n", (unsigned int)num_chan);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_AFEBlockBench()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+#ifdef ENABLE_SEQ_PHASOR
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_SeqBench()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Check and Time the One-Cycle Sequence Components
+//
+//  MECHANICS:          This subroutine checks the sequence components, unbalances, and phase angles that are
+//                      computed from the one-cycle phasors (ENABLE_SEQ_PHASOR defined) against the
+//                      SampleBuf[] computations, and compares their speed.
+//                      The synthetic sample stream is run through the sampling interrupts.  Every
+//                      REPLAY_SEQ_SEG cycles, the synthetic waveforms are changed to random unbalanced
+//                      values by Replay_SeqSynth().
+//                      At each one-cycle anniversary (after the first REPLAY_SEQ_SKIP):
+//                        - Calc_SeqComp_PhAng() is run, and the results are saved
+//                        - The phasors are computed from the last 80 samples in SampleBuf[] by
+//                          Replay_SeqRef(), and Calc_SeqComp_Phasors() is run with them.  This is the
+//                          computation that Calc_SeqComp_PhAng() does without ENABLE_SEQ_PHASOR.  The
+//                          80 samples are the same samples that were summed by the interrupt
+//                        - The magnitudes are compared relative to the positive sequence magnitude, the
+//                          unbalances are compared in percent, and the phase angles are compared in
+//                          degrees.  The angles of a lost phase are not compared
+//                      The anniversary subroutines are not run, so only the sampling interrupts change the
+//                      sums.
+//
+//  CAVEATS:            The times are host times.  The one-cycle time does not include the sums in the
+//                      sampling interrupt (20 multiply-adds per sample, 6 more than without
+//                      ENABLE_SEQ_PHASOR).
+//
+//  INPUTS:             cycles - number of one-cycle anniversaries
+//                      fp - output file
+//
+//  OUTPUTS:            The results are printed to fp
+//
+//  ALTERS:             ReplaySynth (restored), OneCycAnniv, msec200Anniv, OneSecAnniv
+//
+//  CALLS:              srand(), Replay_Open(), Replay_SeqSynth(), Replay_Sample(), Calc_SeqComp_PhAng(),
+//                      Replay_SeqRef(), Calc_SeqComp_Phasors(), Replay_SeqGet(), Replay_TimeStart(),
+//                      Replay_TimeStop(), Replay_Ratio(), fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_SeqBench(uint32_t cycles, FILE *fp)
+{
+  struct REPLAY_SYNTH synth_save;
+  struct REPLAY_SEQ_OUT out_new, out_ref;
+  float re[9], im[9];
+  struct REPLAY_TIME ref_time, new_time;
+  uint32_t cyc, checked, errs;
+  float diff, mag_max, unb_max, ang_max;
+  uint8_t i, lost;
+
+  synth_save = ReplaySynth;
+  srand(1);
+  Replay_Open(REPLAY_SRC_SYNTH, NULL);
+
+  cyc = 0;
+  checked = 0;
+  errs = 0;
+  lost = 0xFF;
+  mag_max = 0;
+  unb_max = 0;
+  ang_max = 0;
+  memset(&ref_time, 0, sizeof(ref_time));
+  memset(&new_time, 0, sizeof(new_time));
+  lost = Replay_SeqSynth();
+  while (cyc < cycles)
+  {
+    if (!Replay_Sample())
+    {
+      break;
+    }
+    msec200Anniv = FALSE;
+    OneSecAnniv = FALSE;
+    if (!OneCycAnniv)
+    {
+      continue;
+    }
+    OneCycAnniv = FALSE;
+
+    if (++cyc > REPLAY_SEQ_SKIP)
+    {
+      Replay_TimeStart(&new_time);
+      Calc_SeqComp_PhAng();
+      Replay_TimeStop(&new_time);
+      Replay_SeqGet(&out_new);
+
+      Replay_TimeStart(&ref_time);
+      Replay_SeqRef(re, im);
+      Calc_SeqComp_Phasors(re, im);
+      Replay_TimeStop(&ref_time);
+      Replay_SeqGet(&out_ref);
+
+      ++checked;
+      diff = 0;
+      for (i=0; i<3; ++i)                     // I0, I1, I2 relative to I1
+      {
+        diff = fmaxf(diff, fabsf(out_new.Mag[i] - out_ref.Mag[i])/fmaxf(out_ref.Mag[1], 1.0f));
+      }
+      for (i=3; i<6; ++i)                     // V0, V1, V2 relative to V1
+      {
+        diff = fmaxf(diff, fabsf(out_new.Mag[i] - out_ref.Mag[i])/fmaxf(out_ref.Mag[4], 1.0f));
+      }
+      mag_max = fmaxf(mag_max, diff);
+      if (diff > REPLAY_SEQ_MAG_TOL)
+      {
+        ++errs;
+      }
+      diff = fmaxf(fabsf(out_new.Unbal[0] - out_ref.Unbal[0]), fabsf(out_new.Unbal[1] - out_ref.Unbal[1]));
+      unb_max = fmaxf(unb_max, diff);
+      if (diff > REPLAY_SEQ_UNB_TOL)
+      {
+        ++errs;
+      }
+      for (i=0; i<REPLAY_SEQ_ANGLES; ++i)
+      {
+        // Skip the angles of a lost phase.  The AFE line-to-line angles (6 - 8) are all skipped, because
+        //   they are computed from the line-to-neutral angles of all three phases
+        if ( (lost < 3) && ((i == lost) || ((i >= 6) && (i <= 8))) )
+        {
+          continue;
+        }
+        diff = fabsf(out_new.Ang[i] - out_ref.Ang[i]);
+        diff = ((diff > 180.0f) ? (360.0f - diff) : diff);
+        ang_max = fmaxf(ang_max, diff);
+        if (diff > REPLAY_SEQ_ANG_TOL)
+        {
+          ++errs;
+        }
+      }
+    }
+
+    // Set new waveforms for the next segment.  The next sample starts a new one-cycle block
+    if ((cyc % REPLAY_SEQ_SEG) == 0)
+    {
+      lost = Replay_SeqSynth();
+    }
+  }
+
+  ReplaySynth = synth_save;
+
+  fprintf(fp, "Sequence component check: %u cycles, %u mismatches (max magnitude difference %.3g,"
+              " max unbalance difference %.3g%%, max angle difference %.3g deg)\n", (unsigned int)checked,
+              (unsigned int)errs, (double)mag_max, (double)unb_max, (double)ang_max);
+  fprintf(fp, "Sequence components: SampleBuf %.1f nsec, one-cycle phasors %.1f nsec per computation,"
+              " %.2f times faster\n",
+              Replay_Ratio(ref_time.Nsec, ref_time.Count), Replay_Ratio(new_time.Nsec, new_time.Count),
+              Replay_Ratio(ref_time.Nsec, new_time.Nsec));
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_SeqBench()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_SeqSynth()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Set Random Unbalanced Synthetic Waveforms
+//
+//  MECHANICS:          This subroutine sets the synthetic source to random unbalanced waveforms:
+//                        - The frequency is 59.5Hz to 60.5Hz, so the one-cycle window does not hold exactly
+//                          one cycle
+//                        - The current amplitudes are 200A to 2000A, with phase errors up to +/-20 degrees.
+//                          One phase is lost (zero amplitude) one time in 8
+//                        - The voltage amplitudes are 249V to 305V, with phase errors up to +/-5 degrees
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            ReplaySynth.Freq, .Amp[], .Phase[]
+//                      Returns the lost current phase (0 - 2), or 0xFF if no phase is lost
+//
+//  ALTERS:             None
+//
+//  CALLS:              Replay_RandF(), Replay_RandU()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Replay_SeqSynth(void)
+{
+  uint8_t i, lost;
+
+  ReplaySynth.Freq = Replay_RandF(59.5f, 60.5f);
+  for (i=0; i<3; ++i)
+  {
+    ReplaySynth.Amp[i] = Replay_RandF(200.0f, 2000.0f);
+    ReplaySynth.Phase[i] = -120.0f * i + Replay_RandF(-20.0f, 20.0f);
+    ReplaySynth.Amp[i+5] = 277.0f * Replay_RandF(0.9f, 1.1f);
+    ReplaySynth.Phase[i+5] = -120.0f * i + Replay_RandF(-5.0f, 5.0f);
+  }
+  lost = 0xFF;
+  if (Replay_RandU(0, 7) == 0)
+  {
+    lost = (uint8_t)Replay_RandU(0, 2);
+    ReplaySynth.Amp[lost] = 0.0f;
+  }
+  return (lost);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_SeqSynth()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_SeqRef()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           SampleBuf Phasors
+//
+//  MECHANICS:          This subroutine computes the real and imaginary components of the fundamental of the
+//                      currents and voltages over the last 80 samples in SampleBuf[], the same way as
+//                      Calc_SeqComp_PhAng() does without ENABLE_SEQ_PHASOR.  The ADC voltages use the same
+//                      80 samples as the other channels.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             SampleBuf[], SampleIndex, SIN_COEFF[]
+//
+//  OUTPUTS:            re[], im[] - the components, in the order used by Calc_SeqComp_Phasors()
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_SeqRef(float *re, float *im)
+{
+  float temp;
+  uint16_t ndx;
+  uint8_t i, j;
+
+  ndx = SampleIndex;
+  ndx = ( (ndx >= 80) ? (ndx - 80) : (TOTAL_SAMPLE_SETS + ndx - 80) );
+  for (i=0; i<9; i++)
+  {
+    re[i] = 0.0f;
+    im[i] = 0.0f;
+  }
+  for (i=0; i<80; i++)
+  {
+    temp = SIN_COEFF[i];
+    re[0] += (SAMPLEBUF(Ia, ndx) * temp);
+    re[1] += (SAMPLEBUF(Ib, ndx) * temp);
+    re[2] += (SAMPLEBUF(Ic, ndx) * temp);
+    re[3] += (SAMPLEBUF(VanAFE, ndx) * temp);
+    re[4] += (SAMPLEBUF(VbnAFE, ndx) * temp);
+    re[5] += (SAMPLEBUF(VcnAFE, ndx) * temp);
+    re[6] += (SAMPLEBUF(VanADC, ndx) * temp);
+    re[7] += (SAMPLEBUF(VbnADC, ndx) * temp);
+    re[8] += (SAMPLEBUF(VcnADC, ndx) * temp);
+
+    j = ((i <= 59) ? (i + 20) : (i - 60));           // Cos index = sin index + 90deg (20*4.5)
+    temp = SIN_COEFF[j];                             //   with rollover at 80
+    im[0] += (SAMPLEBUF(Ia, ndx) * temp);
+    im[1] += (SAMPLEBUF(Ib, ndx) * temp);
+    im[2] += (SAMPLEBUF(Ic, ndx) * temp);
+    im[3] += (SAMPLEBUF(VanAFE, ndx) * temp);
+    im[4] += (SAMPLEBUF(VbnAFE, ndx) * temp);
+    im[5] += (SAMPLEBUF(VcnAFE, ndx) * temp);
+    im[6] += (SAMPLEBUF(VanADC, ndx) * temp);
+    im[7] += (SAMPLEBUF(VbnADC, ndx) * temp);
+    im[8] += (SAMPLEBUF(VcnADC, ndx) * temp);
+    if (++ndx >= TOTAL_SAMPLE_SETS)
+    {
+      ndx = 0;
+    }
+  }
+  for (i=0; i<9; i++)
+  {
+    re[i] = re[i]/40;
+    im[i] = im[i]/40;
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_SeqRef()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_SeqGet()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Save the Sequence Component Outputs
+//
+//  MECHANICS:          This subroutine saves the sequence component magnitudes (I0, I1, I2, V0, V1, V2), the
+//                      negative-sequence unbalances (current, voltage), and the phase angles (PhAngles1[]
+//                      followed by PhAngles2[]).
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             SeqComp, PhAngles1[], PhAngles2[]
+//
+//  OUTPUTS:            out - the outputs
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_SeqGet(struct REPLAY_SEQ_OUT *out)
+{
+  uint8_t i;
+
+  out->Mag[0] = SeqComp.I_ZeroMag;
+  out->Mag[1] = SeqComp.I_PosMag;
+  out->Mag[2] = SeqComp.I_NegMag;
+  out->Mag[3] = SeqComp.V_ZeroMag;
+  out->Mag[4] = SeqComp.V_PosMag;
+  out->Mag[5] = SeqComp.V_NegMag;
+  out->Unbal[0] = SeqComp.I_NegUnbal;
+  out->Unbal[1] = SeqComp.V_NegUnbal;
+  for (i=0; i<9; ++i)
+  {
+    out->Ang[i] = PhAngles1[i];
+  }
+  for (i=0; i<6; ++i)
+  {
+    out->Ang[i+9] = PhAngles2[i];
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_SeqGet()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_SEQ_PHASOR
+
+
+
+#ifdef ENABLE_FREQ_TRACK
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_FreqBench()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Check the Zero-Crossing Frequency Tracker with a Swept Frequency
+//
+//  MECHANICS:          This subroutine checks the frequency and ROCOF from the zero-crossing frequency
+//                      tracker (ENABLE_FREQ_TRACK defined) against the synthetic source.
+//                      The synthetic sample stream is run through the sampling interrupts.  The source is
+//                      held at 60Hz for REPLAY_FREQ_HOLD cycles, and is then swept down to REPLAY_FREQ_MIN,
+//                      up to REPLAY_FREQ_MAX, and so on, at REPLAY_FREQ_RAMP Hz/sec.  The frequency is
+//                      changed every sample, and Replay_Sample() keeps the phase continuous.
+//                      At each one-cycle anniversary:
+//                        - Calc_FreqTrack() and Calc_Prot_AFE_Voltage() are run
+//                        - After the first REPLAY_FREQ_HOLD + REPLAY_FREQ_SETTLE cycles, and except for
+//                          REPLAY_FREQ_SETTLE cycles after each turn of the sweep, the tracked frequency is
+//                          compared with the source frequency, and the ROCOF is compared with the sweep rate
+//                        - The one-cycle Van error (relative to the source amplitude) and the difference of
+//                          the samples per cycle from 80 are saved
+//                      If ENABLE_FREQ_RETUNE is defined, the sample rate is retuned by the sampling
+//                      interrupt, and the number of retunes is counted.  The one-cycle voltages are sums over
+//                      80 samples, so without the retune, the one-cycle Van error grows as the frequency
+//                      moves away from 60Hz.  The other anniversary subroutines are not run.
+//
+//  CAVEATS:            The tracked frequency lags the sweep, since the filter and the period measurement
+//                      delay it by several cycles (up to about 0.1Hz at 1Hz/sec, at 45Hz).  REPLAY_FREQ_TOL
+//                      allows for this.
+//
+//  INPUTS:             cycles - number of one-cycle anniversaries
+//                      fp - output file
+//                      FreqTrack.FreqVal, FreqTrack.Rocof, VolAFEOneCyc.Van
+//
+//  OUTPUTS:            The results are printed to fp
+//
+//  ALTERS:             ReplaySynth (restored), OneCycAnniv, msec200Anniv, OneSecAnniv
+//
+//  CALLS:              Replay_Open(), Replay_Sample(), Calc_FreqTrack(), Calc_Prot_AFE_Voltage(), fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_FreqBench(uint32_t cycles, FILE *fp)
+{
+  struct REPLAY_SYNTH synth_save;
+  double freq, rate_prev, rocof, spc_max;
+  uint32_t cyc, checked, errs, retunes, next_check;
+  float diff, freq_max, rocof_max, volt_max;
+
+  synth_save = ReplaySynth;
+  Replay_Open(REPLAY_SRC_SYNTH, NULL);
+
+  freq = 60.0;
+  rocof = 0;
+  ReplaySynth.Freq = (float)freq;
+  rate_prev = REPLAY_RATE_NOW;
+  cyc = 0;
+  checked = 0;
+  errs = 0;
+  retunes = 0;
+  next_check = REPLAY_FREQ_HOLD + REPLAY_FREQ_SETTLE;
+  freq_max = 0;
+  rocof_max = 0;
+  volt_max = 0;
+  spc_max = 0;
+  while (cyc < cycles)
+  {
+    if (!Replay_Sample())
+    {
+      break;
+    }
+    if (REPLAY_RATE_NOW != rate_prev)             // Count the retunes
+    {
+      rate_prev = REPLAY_RATE_NOW;
+      ++retunes;
+    }
+
+    // Sweep the frequency after the hold.  Turn around at the limits, and restart the settling time
+    if (cyc >= REPLAY_FREQ_HOLD)
+    {
+      if (rocof == 0)
+      {
+        rocof = -REPLAY_FREQ_RAMP;
+      }
+      freq += rocof / REPLAY_RATE_NOW;
+      if ( ((rocof < 0) && (freq <= REPLAY_FREQ_MIN)) || ((rocof > 0) && (freq >= REPLAY_FREQ_MAX)) )
+      {
+        rocof = -rocof;
+        next_check = cyc + REPLAY_FREQ_SETTLE;
+      }
+      ReplaySynth.Freq = (float)freq;
+    }
+
+    msec200Anniv = FALSE;
+    OneSecAnniv = FALSE;
+    if (!OneCycAnniv)
+    {
+      continue;
+    }
+    OneCycAnniv = FALSE;
+    ++cyc;
+
+    Calc_FreqTrack();
+    Calc_Prot_AFE_Voltage();
+
+    if (cyc > next_check)
+    {
+      ++checked;
+      diff = fabsf(FreqTrack.FreqVal - ReplaySynth.Freq);
+      diff = ( isnan(diff) ? HUGE_VALF : diff );
+      freq_max = fmaxf(freq_max, diff);
+      if (diff > REPLAY_FREQ_TOL)
+      {
+        ++errs;
+      }
+      diff = fabsf(FreqTrack.Rocof - (float)rocof);
+      diff = ( isnan(diff) ? HUGE_VALF : diff );
+      rocof_max = fmaxf(rocof_max, diff);
+      if (diff > REPLAY_FREQ_ROCOF_TOL)
+      {
+        ++errs;
+      }
+      volt_max = fmaxf(volt_max, fabsf(VolAFEOneCyc.Van - ReplaySynth.Amp[5]) / ReplaySynth.Amp[5]);
+      spc_max = fmax(spc_max, fabs(REPLAY_RATE_NOW / freq - 80.0));
+    }
+  }
+
+  ReplaySynth = synth_save;
+
+  fprintf(fp, "Frequency tracker check: %u cycles, %u mismatches (max frequency difference %.3g Hz,"
+              " max ROCOF difference %.3g Hz/sec)\n", (unsigned int)checked, (unsigned int)errs,
+              (double)freq_max, (double)rocof_max);
+  fprintf(fp, "Sample rate: %u retunes, max samples per cycle difference %.3g, max one-cycle Van error"
+              " %.3g%%\n", (unsigned int)retunes, spc_max, (double)volt_max * 100.0);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_FreqBench()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_FREQ_TRACK
+
+#endif                  // HOST_BUILD
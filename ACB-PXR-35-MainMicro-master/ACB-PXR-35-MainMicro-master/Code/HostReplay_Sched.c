@@ -0,0 +1,603 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//                      gcc (x86-64 Linux) for the host build only
+//
+//  MODULE NAME:        HostReplay_Sched.c
+//
+//  MECHANICS:          Program module containing the main loop schedule simulation for the host (off-target)
+//                      build.  This module is not part of the target project (PXR35_ProtProc.ewp).  It is
+//                      only compiled when HOST_BUILD is defined, and the simulation is only included if
+//                      ENABLE_MAIN_SCHED is defined.
+//
+//                      With -sched, the sample stream is not run.  Instead, the main loop is simulated with
+//                      and without the cooperative scheduler (Sched.c), with estimated task times, by
+//                      Replay_SchedSim().  This option is only available if ENABLE_MAIN_SCHED is defined.
+//
+//                      The options are parsed by main() in HostReplay.c.  The replay engine (Replay_Open(),
+//                      Replay_Sample()) and the timing and random number helpers (Replay_TimeStart(),
+//                      Replay_TimeStop(), Replay_Ratio(), Replay_RandF(), Replay_RandU()) are in
+//                      HostReplay.c.
+//
+//  TARGET HARDWARE:    None (host PC)
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   179    240302  DAH File Creation
+//                      - Moved Replay_SchedSim(), Replay_SimLegacyPass(), Replay_SimTick(), Replay_SimSlice(),
+//                        Replay_SimSPI1Slice() thru Replay_SimBkgndSlice(), REPLAY_SCHED_COST[],
+//                        REPLAY_SCHED_NUM_SLICES[], REPLAY_SCHED_PERIOD[], and REPLAY_SCHED_TASK[] from
+//                        HostReplay.c
+//                      - Revised Replay_SimSlice() to use Replay_RandU() in HostReplay.c
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+//
+//------------------------------------------------------------------------------------------------------------
+//
+#ifdef HOST_BUILD
+
+//------------------------------------------------------------------------------------------------------------
+//                   Definitions
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global Definitions from external files...
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stm32f4xx.h"
+#include "stm32f407xx.h"
+#include "HostShim_def.h"
+#include "Sched_def.h"
+#include "HostReplay_def.h"             // Must be preceded by Sched_def.h!
+
+//
+//      Local Definitions used in this module...
+//
+
+
+//
+//      Global Declarations from external files...
+//
+#include "Sched_ext.h"
+#include "HostReplay_ext.h"
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global (Visible) Function Prototypes (These functions are called by other modules)
+//
+#ifdef ENABLE_MAIN_SCHED
+  void Replay_SchedSim(uint32_t seconds, FILE *fp);
+#endif
+
+
+//      Local Function Prototypes (These functions are called only within this module)
+//
+#ifdef ENABLE_MAIN_SCHED
+  void Replay_SimLegacyPass(void);
+  void Replay_SimTick(void);
+  uint8_t Replay_SimSlice(uint8_t task, uint8_t slice);
+  uint8_t Replay_SimSPI1Slice(uint8_t slice);
+  uint8_t Replay_SimOneCycSlice(uint8_t slice);
+  uint8_t Replay_Sim200msecSlice(uint8_t slice);
+  uint8_t Replay_Sim1secSlice(uint8_t slice);
+  uint8_t Replay_Sim5minSlice(uint8_t slice);
+  uint8_t Replay_SimBkgndSlice(uint8_t slice);
+#endif
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Storage Allocation - Global (Static) Variables
+//------------------------------------------------------------------------------------------------------------
+//
+//       These variables are used by other modules...
+//
+
+//       These variables are used only in this module...
+//
+#ifdef ENABLE_MAIN_SCHED
+  struct REPLAY_SCHED_STATS ReplaySched[2];   // Schedule simulation statistics: unscheduled, scheduled
+  uint64_t Replay_SimTime;                    // Simulated time in core clock cycles
+  uint64_t Replay_SimDue[SCHED_NUM_TASKS];    // Time of the next anniversary
+  uint64_t Replay_SimSetTime[SCHED_NUM_TASKS];  // Time of the anniversary that set the flag
+  uint64_t Replay_SimServed[SCHED_NUM_TASKS];   // Time of the anniversary being served by the present pass
+  uint8_t Replay_SimAnniv[SCHED_NUM_TASKS];   // Simulated anniversary flags
+  uint8_t Replay_SimLegacy;                   // TRUE if simulating the unscheduled main loop
+#endif
+
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Global Constants used in this module and other modules
+//------------------------------------------------------------------------------------------------------------
+//
+#ifdef ENABLE_MAIN_SCHED
+// Simulated slice times for Replay_SchedSim(), in usec: {minimum, maximum}.  The slices are the same as in
+//   Main_SPI1Slice() thru Main_BkgndSlice() in main.c.  These are estimates, based on the measured times
+//   noted in main.c (RelayManagement() 1.3msec max, about 600usec per pass of Calc_Harmonics(), main loop
+//   about 355usec without the harmonics), not measurements of each slice
+const uint16_t REPLAY_SCHED_COST[SCHED_NUM_TASKS][REPLAY_SCHED_MAX_SLICES][2] =
+{
+  { {20, 60} },                                                 // SPI1 flags
+  { {100, 250}, {150, 350}, {80, 200}, {50, 200}, {20, 300} },  // One-cycle: calcs, prot, alarms x2, capture
+  { {200, 500}, {200, 800} },                                   // 200msec: metering, the rest
+  { {100, 400} },                                               // 1sec
+  { {200, 1000} },                                              // 5min
+  { {30, 100}, {50, 700}, {100, 1300}, {50, 300}, {50, 600}, {30, 400}, {20, 100} }   // Background
+};
+const uint8_t REPLAY_SCHED_NUM_SLICES[SCHED_NUM_TASKS] = {1, 5, 2, 1, 1, 7};
+
+// Simulated anniversary periods (0 if the task is not released by an anniversary)
+const uint64_t REPLAY_SCHED_PERIOD[SCHED_NUM_TASKS] =
+{
+  0, REPLAY_SCHED_ONECYC, REPLAY_SCHED_200MSEC, REPLAY_SCHED_1SEC, REPLAY_SCHED_5MIN, 0
+};
+
+// Simulated task table.  The periods, deadlines, and budgets are the same as in MAIN_SCHED_TASK[] in main.c
+const struct SCHED_TASK REPLAY_SCHED_TASK[SCHED_NUM_TASKS] =
+{
+  {Replay_SimSPI1Slice,    0,                               SCHED_SPI1_PERIOD,
+     SCHED_SPI1_DEADLINE,    SCHED_SPI1_BUDGET},
+  {Replay_SimOneCycSlice,  &Replay_SimAnniv[SCHED_ONECYC],  0,
+     SCHED_ONECYC_DEADLINE,  SCHED_ONECYC_BUDGET},
+  {Replay_Sim200msecSlice, &Replay_SimAnniv[SCHED_200MSEC], 0,
+     SCHED_200MSEC_DEADLINE, SCHED_200MSEC_BUDGET},
+  {Replay_Sim1secSlice,    &Replay_SimAnniv[SCHED_1SEC],    0,
+     SCHED_1SEC_DEADLINE,    SCHED_1SEC_BUDGET},
+  {Replay_Sim5minSlice,    &Replay_SimAnniv[SCHED_5MIN],    0,
+     SCHED_5MIN_DEADLINE,    SCHED_5MIN_BUDGET},
+  {Replay_SimBkgndSlice,   0,                               0,
+     SCHED_BKGND_DEADLINE,   SCHED_BKGND_BUDGET}
+};
+#endif
+
+
+
+#ifdef ENABLE_MAIN_SCHED
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_SchedSim()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Simulate the Main Loop Schedule
+//
+//  MECHANICS:          This subroutine compares the unscheduled main loop with the cooperative scheduler
+//                      (Sched.c) over the given number of seconds of simulated time.  The main loop code is
+//                      replaced by simulated tasks with the same slices as the Main_xxSlice() subroutines in
+//                      main.c.  Each slice just advances the simulated clock (Host_SimCyc) by a random time
+//                      between the minimum and maximum in REPLAY_SCHED_COST[].  The anniversary flags are
+//                      set by Replay_SimTick() at their simulated times.
+//                      The simulation is run twice with the same random seed:
+//                        - Unscheduled: Replay_SimLegacyPass() calls the slices in the same order as the
+//                          unscheduled main loop, including the ManageSPI1Flags() calls between them
+//                        - Scheduled: the slices are run by Sched_Run(), with the task table
+//                          REPLAY_SCHED_TASK[] (the same periods, deadlines, and budgets as
+//                          MAIN_SCHED_TASK[])
+//                      For each run, the max time between the SPI1 flags slices, the max main loop time
+//                      (time between the ends of the background passes), and for each anniversary task the
+//                      max response time (from the anniversary to the end of the pass), the number of
+//                      missed deadlines, and the number of lost anniversaries are printed.  The scheduler
+//                      statistics (SchedStat[]) are also printed for the scheduled run.
+//
+//  CAVEATS:            Only included if ENABLE_MAIN_SCHED is defined.
+//                      The slice times are estimates, not measurements, and the time spent in the
+//                      interrupts is not included.  The results are only useful for comparing the two
+//                      schedules.
+//                      Host_SimClk is left FALSE on exit, so Host_CycCnt() returns the host time again.
+//
+//  INPUTS:             seconds - the simulated time in seconds
+//                      fp - the output stream
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             Replay_SimTime, Replay_SimDue[], Replay_SimSetTime[], Replay_SimServed[],
+//                      Replay_SimAnniv[], Replay_SimLegacy, ReplaySched[], Host_SimCyc, Host_SimClk
+//
+//  CALLS:              srand(), Replay_SimLegacyPass(), Sched_Init(), Sched_Run(), fprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_SchedSim(uint32_t seconds, FILE *fp)
+{
+  uint64_t end_time;
+  uint8_t i, j;
+
+  end_time = REPLAY_SCHED_1SEC * seconds;
+  Host_SimClk = TRUE;
+
+  for (j=0; j<2; ++j)                   // j = 0: unscheduled, j = 1: scheduled
+  {
+    srand(1);
+    Replay_SimTime = 0;
+    Host_SimCyc = 0;
+    for (i=0; i<SCHED_NUM_TASKS; ++i)
+    {
+      Replay_SimDue[i] = 0;
+      Replay_SimSetTime[i] = 0;
+      Replay_SimServed[i] = 0;
+      Replay_SimAnniv[i] = FALSE;
+    }
+    Replay_SimDue[SCHED_5MIN] = REPLAY_SCHED_5MIN_FIRST;
+    memset(&ReplaySched[j], 0, sizeof(ReplaySched[j]));
+    Replay_SimLegacy = (j == 0);
+
+    if (Replay_SimLegacy)
+    {
+      while (Replay_SimTime < end_time)
+      {
+        Replay_SimLegacyPass();
+      }
+    }
+    else
+    {
+      Sched_Init(&REPLAY_SCHED_TASK[0]);
+      while (Replay_SimTime < end_time)
+      {
+        Sched_Run();
+      }
+    }
+  }
+  Host_SimClk = FALSE;
+
+  fprintf(fp, "Main loop schedule simulation: %u sec (slice times are estimates)\n", (unsigned int)seconds);
+  fprintf(fp, "                              Unscheduled      Scheduled\n");
+  fprintf(fp, "SPI1 flags max gap (usec):    %11u    %11u\n",
+            (unsigned int)(ReplaySched[0].SPI1MaxGap / SCHED_CYC_PER_USEC),
+            (unsigned int)(ReplaySched[1].SPI1MaxGap / SCHED_CYC_PER_USEC));
+  fprintf(fp, "Main loop max time (usec):    %11u    %11u\n",
+            (unsigned int)(ReplaySched[0].BkgndMaxPeriod / SCHED_CYC_PER_USEC),
+            (unsigned int)(ReplaySched[1].BkgndMaxPeriod / SCHED_CYC_PER_USEC));
+  for (i=SCHED_ONECYC; i<=SCHED_5MIN; ++i)
+  {
+    fprintf(fp, "%-10s passes:            %11u    %11u\n", SCHED_TASK_NAME[i],
+              (unsigned int)ReplaySched[0].Passes[i], (unsigned int)ReplaySched[1].Passes[i]);
+    fprintf(fp, "%-10s max response (usec):%10u    %11u\n", SCHED_TASK_NAME[i],
+              (unsigned int)(ReplaySched[0].MaxResp[i] / SCHED_CYC_PER_USEC),
+              (unsigned int)(ReplaySched[1].MaxResp[i] / SCHED_CYC_PER_USEC));
+    fprintf(fp, "%-10s missed deadlines:  %11u    %11u\n", SCHED_TASK_NAME[i],
+              (unsigned int)ReplaySched[0].Misses[i], (unsigned int)ReplaySched[1].Misses[i]);
+    fprintf(fp, "%-10s lost anniversaries:%11u    %11u\n", SCHED_TASK_NAME[i],
+              (unsigned int)ReplaySched[0].Lost[i], (unsigned int)ReplaySched[1].Lost[i]);
+  }
+  fprintf(fp, "Scheduler statistics (usec):\n");
+  fprintf(fp, "Task          Passes     Slices   Overruns     Misses   MaxSlice    MaxResp\n");
+  for (i=0; i<SCHED_NUM_TASKS; ++i)
+  {
+    fprintf(fp, "%-10s %9u  %9u  %9u  %9u  %9u  %9u\n", SCHED_TASK_NAME[i], (unsigned int)SchedStat[i].Passes,
+              (unsigned int)SchedStat[i].Slices, (unsigned int)SchedStat[i].Overruns,
+              (unsigned int)SchedStat[i].Misses, (unsigned int)(SchedStat[i].MaxSlice / SCHED_CYC_PER_USEC),
+              (unsigned int)(SchedStat[i].MaxResponse / SCHED_CYC_PER_USEC));
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_SchedSim()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_SimLegacyPass()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Simulate One Pass of the Unscheduled Main Loop
+//
+//  MECHANICS:          This subroutine runs the simulated slices in the same order as one pass through the
+//                      unscheduled main loop in main():
+//                        - SPI1 flags
+//                        - One-cycle anniversary, with SPI1 flags between the slices
+//                        - 200msec anniversary, with SPI1 flags between the slices
+//                        - 1sec anniversary
+//                        - SPI1 flags
+//                        - 5min anniversary
+//                        - SPI1 flags
+//                        - Background slices 0 - 3, SPI1 flags, background slices 4 - 5, SPI1 flags,
+//                          background slice 6
+//                      As in main(), each anniversary flag is cleared at the end of its anniversary code, so
+//                      an anniversary that occurs while the code is running is lost (Replay_SimTick() counts
+//                      it, since the flag is still set).
+//
+//  CAVEATS:            Only included if ENABLE_MAIN_SCHED is defined
+//
+//  INPUTS:             Replay_SimAnniv[]
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             Replay_SimAnniv[]
+//
+//  CALLS:              Replay_SimSlice()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_SimLegacyPass(void)
+{
+  uint8_t task, slice;
+
+  Replay_SimSlice(SCHED_SPI1, 0);
+
+  for (task=SCHED_ONECYC; task<=SCHED_5MIN; ++task)
+  {
+    if (Replay_SimAnniv[task])
+    {
+      for (slice=0; slice<REPLAY_SCHED_NUM_SLICES[task]; ++slice)
+      {
+        if (slice > 0)
+        {
+          Replay_SimSlice(SCHED_SPI1, 0);
+        }
+        Replay_SimSlice(task, slice);
+      }
+      Replay_SimAnniv[task] = FALSE;
+    }
+    if (task >= SCHED_1SEC)
+    {
+      Replay_SimSlice(SCHED_SPI1, 0);
+    }
+  }
+
+  for (slice=0; slice<REPLAY_SCHED_NUM_SLICES[SCHED_BACKGROUND]; ++slice)
+  {
+    if ( (slice == 4) || (slice == 6) )
+    {
+      Replay_SimSlice(SCHED_SPI1, 0);
+    }
+    Replay_SimSlice(SCHED_BACKGROUND, slice);
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_SimLegacyPass()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_SimTick()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Simulated Anniversary Interrupts
+//
+//  MECHANICS:          This subroutine sets the simulated anniversary flags whose times have passed, and
+//                      sets the simulated cycle counter (Host_SimCyc) to the simulated time.  This takes the
+//                      place of the sampling and SysTick interrupts, which set the anniversary flags on the
+//                      target.  If a flag is still set when its next anniversary occurs, the anniversary is
+//                      lost.  The time of the anniversary is saved in Replay_SimSetTime[], so the response
+//                      time is measured from the anniversary, not from when the slice ran.
+//
+//  CAVEATS:            Only included if ENABLE_MAIN_SCHED is defined
+//
+//  INPUTS:             Replay_SimTime, Replay_SimDue[]
+//
+//  OUTPUTS:            Replay_SimAnniv[], Replay_SimSetTime[], Host_SimCyc
+//
+//  ALTERS:             Replay_SimDue[], ReplaySched[].Lost[]
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Replay_SimTick(void)
+{
+  struct REPLAY_SCHED_STATS *sptr;
+  uint8_t task;
+
+  sptr = &ReplaySched[(Replay_SimLegacy ? 0 : 1)];
+  for (task=SCHED_ONECYC; task<=SCHED_5MIN; ++task)
+  {
+    while (Replay_SimDue[task] <= Replay_SimTime)
+    {
+      if (Replay_SimAnniv[task])
+      {
+        sptr->Lost[task]++;
+      }
+      else
+      {
+        Replay_SimAnniv[task] = TRUE;
+        Replay_SimSetTime[task] = Replay_SimDue[task];
+      }
+      Replay_SimDue[task] += REPLAY_SCHED_PERIOD[task];
+    }
+  }
+  Host_SimCyc = (uint32_t)Replay_SimTime;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_SimTick()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_SimSlice()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Run One Simulated Slice
+//
+//  MECHANICS:          This subroutine simulates one slice of a main loop task:
+//                        - At the start of an anniversary task's pass, the anniversary that is being served
+//                          is saved.  In the scheduled run the flag is cleared when the task is released, so
+//                          if the flag is set again, the pass is serving the previous anniversary
+//                        - The simulated time is advanced by a random time between the minimum and maximum
+//                          slice times in REPLAY_SCHED_COST[], and Replay_SimTick() is called
+//                        - The statistics are updated (see struct REPLAY_SCHED_STATS)
+//
+//  CAVEATS:            Only included if ENABLE_MAIN_SCHED is defined
+//
+//  INPUTS:             task - the task number (SCHED_SPI1 .. SCHED_BACKGROUND)
+//                      slice - the slice number
+//
+//  OUTPUTS:            Returns TRUE if this was the last slice of the pass
+//
+//  ALTERS:             Replay_SimTime, Replay_SimServed[], ReplaySched[]
+//
+//  CALLS:              Replay_RandU(), Replay_SimTick()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Replay_SimSlice(uint8_t task, uint8_t slice)
+{
+  struct REPLAY_SCHED_STATS *sptr;
+  const uint16_t *cptr;
+  uint32_t dt;
+  uint8_t done;
+
+  sptr = &ReplaySched[(Replay_SimLegacy ? 0 : 1)];
+
+  if ( (slice == 0) && (REPLAY_SCHED_PERIOD[task] != 0) )
+  {
+    Replay_SimServed[task] = Replay_SimSetTime[task];
+    if ( (!Replay_SimLegacy) && (Replay_SimAnniv[task]) )
+    {
+      Replay_SimServed[task] -= REPLAY_SCHED_PERIOD[task];
+    }
+  }
+
+  cptr = &REPLAY_SCHED_COST[task][slice][0];
+  Replay_SimTime += SCHED_USEC(Replay_RandU(cptr[0], cptr[1]));
+  Replay_SimTick();
+
+  if (task == SCHED_SPI1)
+  {
+    dt = (uint32_t)(Replay_SimTime - sptr->SPI1PrevTime);
+    if (dt > sptr->SPI1MaxGap)
+    {
+      sptr->SPI1MaxGap = dt;
+    }
+    sptr->SPI1PrevTime = Replay_SimTime;
+  }
+
+  done = ((slice + 1) >= REPLAY_SCHED_NUM_SLICES[task]);
+  if (done)
+  {
+    sptr->Passes[task]++;
+    if (task == SCHED_BACKGROUND)
+    {
+      dt = (uint32_t)(Replay_SimTime - sptr->BkgndPrevTime);
+      if (dt > sptr->BkgndMaxPeriod)
+      {
+        sptr->BkgndMaxPeriod = dt;
+      }
+      sptr->BkgndPrevTime = Replay_SimTime;
+    }
+    else if (REPLAY_SCHED_PERIOD[task] != 0)
+    {
+      dt = (uint32_t)(Replay_SimTime - Replay_SimServed[task]);
+      if (dt > sptr->MaxResp[task])
+      {
+        sptr->MaxResp[task] = dt;
+      }
+      if (dt > REPLAY_SCHED_TASK[task].Deadline)
+      {
+        sptr->Misses[task]++;
+      }
+    }
+  }
+  return (done);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_SimSlice()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Replay_SimSPI1Slice() thru Replay_SimBkgndSlice()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Simulated Task Slice Subroutines
+//
+//  MECHANICS:          These are the slice subroutines in REPLAY_SCHED_TASK[].  Each one runs a slice of
+//                      its task with Replay_SimSlice().
+//
+//  CAVEATS:            Only included if ENABLE_MAIN_SCHED is defined
+//
+//  INPUTS:             slice - the slice number
+//
+//  OUTPUTS:            Returns TRUE if this was the last slice of the pass
+//
+//  ALTERS:             None
+//
+//  CALLS:              Replay_SimSlice()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Replay_SimSPI1Slice(uint8_t slice)
+{
+  return (Replay_SimSlice(SCHED_SPI1, slice));
+}
+
+uint8_t Replay_SimOneCycSlice(uint8_t slice)
+{
+  return (Replay_SimSlice(SCHED_ONECYC, slice));
+}
+
+uint8_t Replay_Sim200msecSlice(uint8_t slice)
+{
+  return (Replay_SimSlice(SCHED_200MSEC, slice));
+}
+
+uint8_t Replay_Sim1secSlice(uint8_t slice)
+{
+  return (Replay_SimSlice(SCHED_1SEC, slice));
+}
+
+uint8_t Replay_Sim5minSlice(uint8_t slice)
+{
+  return (Replay_SimSlice(SCHED_5MIN, slice));
+}
+
+uint8_t Replay_SimBkgndSlice(uint8_t slice)
+{
+  return (Replay_SimSlice(SCHED_BACKGROUND, slice));
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Replay_SimSPI1Slice() thru Replay_SimBkgndSlice()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_MAIN_SCHED
+
+#endif                  // HOST_BUILD
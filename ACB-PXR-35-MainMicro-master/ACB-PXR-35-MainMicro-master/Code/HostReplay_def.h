@@ -0,0 +1,385 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//                      gcc (x86-64 Linux) for the host build only
+//
+//  MODULE NAME:        HostReplay_def.h
+//
+//  MECHANICS:          This is the definitions file for the HostReplay.c module.  It is only used in the
+//                      host (off-target) build (HOST_BUILD is defined).  See HostShim_def.h
+//
+//  TARGET HARDWARE:    None (host PC)
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   154    240206  DAH File Creation
+//   156    240208  DAH - Added the harmonics comparison constants (REPLAY_HARM_xx)
+//   157    240209  DAH - Added REPLAY_GATHER_WF and REPLAY_GATHER_LINE
+//   158    240210  DAH - Added REPLAY_SOS_SAMPLES and REPLAY_SOS_MAX_VLN
+//   159    240211  DAH - Added REPLAY_AFEBLK_SAMPLES and REPLAY_AFEBLK_MAX_PU
+//   161    240213  DAH - Added the main loop schedule simulation constants (REPLAY_SCHED_xx) and
+//                        struct REPLAY_SCHED_STATS
+//   164    240216  DAH - Added the Flash waveform pipeline benchmark constants (REPLAY_FLASH_xx) and
+//                        struct REPLAY_FLASH_STATS
+//   165    240217  DAH - Added the coded waveform benchmark constants (REPLAY_WFC_xx)
+//   166    240218  DAH - Added the event lookup benchmark constants (REPLAY_EVB_xx)
+//   167    240219  DAH - Added the event queue stress test constants (REPLAY_EVQ_xx) and struct
+//                        REPLAY_EVQ_ISR
+//   168    240220  DAH - Added the event log write benchmark constants (REPLAY_EVW_xx)
+//   169    240221  DAH - Added REPLAY_CRC_REPS
+//   170    240222  DAH - Added the display processor packet benchmark constants (REPLAY_DPTX_xx)
+//   171    240223  DAH - Added the Modbus read benchmark constants (REPLAY_MODB_xx)
+//   173    240225  DAH - Added the protection element benchmark constants (REPLAY_PROT_xx) and struct
+//                        REPLAY_PROT_STATE
+//   174    240226  DAH - Added the one-cycle kernel benchmark constants (REPLAY_KERN_xx) and struct
+//                        REPLAY_KERN_STATE
+//   175    240227  DAH - Added the sequence component benchmark constants (REPLAY_SEQ_xx) and struct
+//                        REPLAY_SEQ_OUT
+//   176    240228  DAH - Added REPLAY_RATE_NOW and the frequency tracker benchmark constants (REPLAY_FREQ_xx)
+//   177    240229  DAH - Added the CAM sampled-value frame benchmark constants (REPLAY_CAMSV_xx) and struct
+//                        REPLAY_CAMSV_LINK
+//   179    240302  DAH - Added REPLAY_SOS_200MS_CYC and REPLAY_SOS_FDEV_PU
+//                      - Deleted the protection element and one-cycle kernel benchmark constants
+//                        (REPLAY_PROT_xx, REPLAY_KERN_xx), and struct REPLAY_PROT_STATE and struct
+//                        REPLAY_KERN_STATE
+//                      - Revised the REPLAY_WFC_I_TOL description (WF_CODEC_I_MAX_ERR)
+//                      - Added struct REPLAY_TIME
+//                      - Revised struct REPLAY_EVQ_ISR to time the interrupt events with struct REPLAY_TIME
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+//
+//------------------------------------------------------------------------------------------------------------
+
+#ifndef HOSTREPLAY_DEF_H
+#define HOSTREPLAY_DEF_H
+
+//
+//------------------------------------------------------------------------------------------------------------
+//    Constants
+//------------------------------------------------------------------------------------------------------------
+
+// Sample stream sources
+#define REPLAY_SRC_NONE         0           // No source selected
+#define REPLAY_SRC_SYNTH        1           // Synthetic sinusoids (struct REPLAY_SYNTH)
+#define REPLAY_SRC_ENG          2           // File of engineering-unit frames (struct REPLAY_ENG_FRAME)
+#define REPLAY_SRC_RAW          3           // File of raw DMA frames (struct REPLAY_RAW_FRAME)
+
+// Sample timing.  The AFE samples at 4800Hz (80 samples per 60Hz cycle).  The SysTick interrupt is every
+//   10msec, or once every 48 samples
+#define REPLAY_SAMPLE_RATE      4800
+#define REPLAY_SAMPLES_PER_TICK 48
+
+// Present sample rate.  If the sample rate is retuned, this is the rate that was last loaded by
+//   Update_Sample_Rate()
+#if defined(ENABLE_FREQ_TRACK) && defined(ENABLE_FREQ_RETUNE)
+  #define REPLAY_RATE_NOW       ((double)FreqTrack.SampleRate)
+#else
+  #define REPLAY_RATE_NOW       ((double)REPLAY_SAMPLE_RATE)
+#endif
+
+// Number of frames of history kept to align the AFE and ADC samples (see Replay_EncodeAFE())
+#define REPLAY_HIST_SIZE        4
+
+// Nominal ADC reading of the 1.25V reference (ADC2 channel 8) with a 3.3V VREF+.  The reference reading is
+//   subtracted from the other channels in ADC_Process_Samples(), so its exact value only sets the headroom
+#define REPLAY_ADC_REF_CODE     1551
+#define REPLAY_ADC_MAX_CODE     4095
+
+// Full-scale AFE reading (24-bit signed)
+#define REPLAY_AFE_MAX_CODE     0x007FFFFF
+
+// Harmonics comparison (Replay_HarmBench()).  The samples are 12 cycles of 80 samples, and the bins are 5Hz
+//   (0Hz thru 2395Hz).  The harmonic amplitudes are random, up to REPLAY_HARM_MAX_PU of the fundamental, and
+//   one in REPLAY_HARM_IH_ODDS of the other bins has a random interharmonic up to REPLAY_HARM_IH_MAX_PU
+#define REPLAY_HARM_SAMPLES     960
+#define REPLAY_HARM_BINS        480
+#define REPLAY_HARM_MAX_PU      0.10f
+#define REPLAY_HARM_IH_ODDS     10
+#define REPLAY_HARM_IH_MAX_PU   0.01f
+
+// Sample window gather comparison (Replay_GatherBench()).  Each trial gathers the 12-cycle windows of the ten
+//   harmonics waveforms (Ia - In, Van - Vcn, Vab - Vca) from both SampleBuf layouts.  The memory touched is
+//   counted in REPLAY_GATHER_LINE-byte lines, since a processor with a data cache reads whole lines
+#define REPLAY_GATHER_WF        10
+#define REPLAY_GATHER_LINE      32
+
+// Voltage sum-of-squares comparison (Replay_SOSBench()).  Each trial is one cycle of samples, with line-to-
+//   neutral voltages up to REPLAY_SOS_MAX_VLN (RMS)
+#define REPLAY_SOS_SAMPLES      80
+#define REPLAY_SOS_MAX_VLN      1000.0f
+// The 200msec window check (Replay_SOS200msCheck()) is REPLAY_SOS_200MS_CYC cycles, the same as the 960
+//   samples between 200msec anniversaries.  The line frequency is within REPLAY_SOS_FDEV_PU of nominal
+#define REPLAY_SOS_200MS_CYC    12
+#define REPLAY_SOS_FDEV_PU      0.01f
+
+// AFE sample processing comparison (Replay_AFEBlockBench()).  Each trial is ten cycles of AFE readings, with
+//   peak readings up to REPLAY_AFEBLK_MAX_PU of full scale.  The number of samples must be a multiple of the
+//   largest block size (8)
+#define REPLAY_AFEBLK_SAMPLES   800
+#define REPLAY_AFEBLK_MAX_PU    0.5f
+
+// Main loop schedule simulation (Replay_SchedSim()).  The anniversary periods are in core clock cycles
+//   (120MHz).  The first 5min anniversary is at 1sec so that it is included in short runs.  The simulated
+//   slice times are in REPLAY_SCHED_COST[] in HostReplay.c.  Requires Sched_def.h
+#define REPLAY_SCHED_MAX_SLICES 7
+#define REPLAY_SCHED_ONECYC     2000000ULL
+#define REPLAY_SCHED_200MSEC    24000000ULL
+#define REPLAY_SCHED_1SEC       120000000ULL
+#define REPLAY_SCHED_5MIN       36000000000ULL
+#define REPLAY_SCHED_5MIN_FIRST REPLAY_SCHED_1SEC
+
+// Flash waveform pipeline benchmark (Replay_FlashBench()).  Times are in core clock cycles (120MHz).  A
+//   sample set is received every REPLAY_FLASH_SAMPLE_CYC cycles (4800/sec), and Timer10 counts at 10MHz, so
+//   one count is REPLAY_FLASH_TIM10_CYC cycles.  The precycles are the min and max of the waveform setpoints
+#define REPLAY_FLASH_SAMPLE_CYC 25000
+#define REPLAY_FLASH_TIM10_CYC  12
+#define REPLAY_FLASH_MIN_PRE    8
+#define REPLAY_FLASH_MAX_PRE    28
+
+// Coded waveform benchmark (Replay_WfCodecBench()).  Capture types, the cycle the faults start, and the
+//   current error allowed, as a fraction of the cycle peak (half a step, plus float rounding).  If
+//   WF_CODEC_I_MAX_ERR is defined, the error must also be no more than WF_CODEC_I_MAX_ERR
+#define REPLAY_WFC_LOAD         0
+#define REPLAY_WFC_FAULT        1
+#define REPLAY_WFC_GROUND       2
+#define REPLAY_WFC_OPEN         3
+#define REPLAY_WFC_TYPES        4
+#define REPLAY_WFC_FAULT_CYC    8
+#define REPLAY_WFC_I_TOL        (0.51f / WF_CODEC_I_MAXQ)
+
+// Event lookup benchmark (Replay_EventBench()).  Number of Summary events written (the log rolls over),
+//   EIDs looked up before and after the log, and the operations that are timed
+#define REPLAY_EVB_EVENTS       (SUMMARY_NUM_LOGS + (SUMMARY_NUM_LOGS / 2) + 17)
+#define REPLAY_EVB_MARGIN       5
+#define REPLAY_EVB_RAM          0
+#define REPLAY_EVB_FRAM         1
+#define REPLAY_EVB_PG_NDX       2
+#define REPLAY_EVB_PG_EID       3
+#define REPLAY_EVB_NUM          4
+
+// Event queue stress test (Replay_EventQBench()).  The simulated interrupt fires bursts of events; every
+//   REPLAY_EVQ_STORM_EVERY'th burst is a fault storm that is larger than the interrupt event buffer.  While
+//   a burst is being fired, the foreground inserts up to REPLAY_EVQ_FG_MAX events of its own, one every
+//   REPLAY_EVQ_FG_EVERY event manager passes.  All of the events are Summary log events
+#define REPLAY_EVQ_BURST        (INTEVENT_BUF_SIZE / 2)
+#define REPLAY_EVQ_STORM        (INTEVENT_BUF_SIZE * 3)
+#define REPLAY_EVQ_STORM_EVERY  4
+#define REPLAY_EVQ_FG_EVERY     8
+#define REPLAY_EVQ_FG_MAX       4
+#define REPLAY_EVQ_ISR_CODE     ENTER_MAINTENANCE_MODE
+#define REPLAY_EVQ_FG_CODE      EXIT_MAINTENANCE_MODE
+
+// Event log write benchmark (Replay_EventWCBench()).  Each burst is REPLAY_EVW_BURST Summary log events,
+//   which must fit in the New Event FIFO (16 events if ENABLE_EVENT_QUEUE is not defined)
+#define REPLAY_EVW_BURST        12
+#define REPLAY_EVW_MAX_CALLS    (REPLAY_EVW_BURST * 4)
+
+// CRC-16 benchmark (Replay_CrcBench()).  Number of messages that are timed for each method and size
+#define REPLAY_CRC_REPS         20000
+
+// Display processor packet benchmark (Replay_DPTxBench()).  Random span sets per trial, max spans per set,
+//   max data bytes per set (the encoded packet must fit in DISPCOMM_TXBUFSIZE), and RTD buffer messages
+//   that are timed per time slice
+#define REPLAY_DPTX_SETS        64
+#define REPLAY_DPTX_SPANS       8
+#define REPLAY_DPTX_MAX_DATA    320
+#define REPLAY_DPTX_REPS        2000
+
+// Modbus read benchmark (Replay_ModbBench()).  Registers per read request (the maximum), and the step
+//   between the starting addresses.  The step is odd so that both even and odd starting addresses are read
+#define REPLAY_MODB_REGS        125
+#define REPLAY_MODB_STEP        61
+
+// Sequence component benchmark (Replay_SeqBench()).  Number of cycles that each set of waveforms is held,
+//   number of cycles skipped at the start, the max magnitude difference (relative to the positive sequence
+//   magnitude), the max unbalance difference (percent), the max phase angle difference (degrees), and the
+//   number of phase angles that are compared (PhAngles1[] and PhAngles2[])
+#define REPLAY_SEQ_SEG          12
+#define REPLAY_SEQ_SKIP         2
+#define REPLAY_SEQ_MAG_TOL      1.0E-3
+#define REPLAY_SEQ_UNB_TOL      0.1
+#define REPLAY_SEQ_ANG_TOL      0.1
+#define REPLAY_SEQ_ANGLES       15
+
+// Frequency tracker benchmark (Replay_FreqBench()).  Sweep limits (Hz) and rate (Hz/sec), number of cycles
+//   held at 60Hz at the start, number of cycles not checked after the start and after each turn of the sweep,
+//   the max frequency difference (Hz), and the max ROCOF difference (Hz/sec)
+#define REPLAY_FREQ_MIN         45.0
+#define REPLAY_FREQ_MAX         65.0
+#define REPLAY_FREQ_RAMP        1.0
+#define REPLAY_FREQ_HOLD        30
+#define REPLAY_FREQ_SETTLE      20
+#define REPLAY_FREQ_TOL         0.15
+#define REPLAY_FREQ_ROCOF_TOL   0.3
+
+// CAM sampled-value frame benchmark (Replay_CamSvBench()).  CAM port UART rate (bits/sec, 10 bits per
+//   char), the odds (1 in n) that a frame is held up on the link in the second pass and the number of
+//   samples that it is held up, the receive buffer size (bytes), and the number of sample sets kept to check
+//   the received frames (must be a power of 2)
+#define REPLAY_CAMSV_BAUD       3750000
+#define REPLAY_CAMSV_STALL_ODDS 50
+#define REPLAY_CAMSV_STALL      6
+#define REPLAY_CAMSV_RXBUF      2048
+#define REPLAY_CAMSV_LOG        256
+
+//
+//------------------------------------------------------------------------------------------------------------
+//    Structures
+//------------------------------------------------------------------------------------------------------------
+//
+// Engineering-unit frame.  One frame per sample.  The values are in amps and volts, in the AFE channel
+//   order: 0 - Ia   1 - Ib   2 - Ic   3 - In   4 - Igsrc   5 - Van   6 - Vbn   7 - Vcn
+struct REPLAY_ENG_FRAME
+{
+  float val[8];
+};
+
+// Raw frame.  One frame per sample.  These are the words exactly as they were transferred by DMA1 Stream0
+//   (AFE) and DMA2 Stream0 (ADC1 and ADC2) on the target, and are delivered without any realignment
+struct REPLAY_RAW_FRAME
+{
+  uint16_t AFEwords[16];
+  uint32_t ADCwords[5];
+};
+
+// Synthetic source configuration.  Each channel is a sinusoid at Freq, with amplitude Amp[] (RMS amps or
+//   volts) and phase angle Phase[] (degrees).  Beginning with sample FaultStart, the current amplitudes are
+//   multiplied by FaultMult.  Set FaultStart to 0xFFFFFFFF for no fault
+struct REPLAY_SYNTH
+{
+  float Freq;
+  float Amp[8];
+  float Phase[8];
+  uint32_t FaultStart;
+  float FaultMult;
+};
+
+// Replay statistics.  Times are in nanoseconds of host CPU time
+struct REPLAY_STATS
+{
+  uint64_t Samples;                         // Number of samples delivered
+  uint64_t SampleNsec;                      // Total time in the sample interrupts
+  uint32_t SampleMaxNsec;                   // Max time in the sample interrupts for one sample
+  uint32_t OneCycCnt;                       // Number of one-cycle anniversaries
+  uint64_t OneCycNsec;                      // Total time in the one-cycle anniversary subroutines
+  uint32_t OneCycMaxNsec;                   // Max time in the one-cycle anniversary subroutines
+  uint32_t msec200Cnt;                      // Number of 200msec anniversaries
+  uint64_t msec200Nsec;                     // Total time in the 200msec anniversary subroutines
+  uint32_t msec200MaxNsec;                  // Max time in the 200msec anniversary subroutines
+  uint64_t WallNsec;                        // Total elapsed time
+  uint32_t Trips;                           // Number of trips (rising edges of TripReqFlg)
+  uint64_t FirstTripSample;                 // Sample number of the first trip
+  uint32_t PrimaskErrs;                     // Number of samples delivered with interrupts disabled
+};
+
+// Benchmark timer (see Replay_TimeStart() and Replay_TimeStop()).  Times are in nanoseconds of host CPU time
+struct REPLAY_TIME
+{
+  uint64_t Start;                           // Start time of the present measurement
+  uint64_t Nsec;                            // Total time of the measurements
+  uint64_t MaxNsec;                         // Max time of one measurement
+  uint32_t Count;                           // Number of measurements
+};
+
+// Main loop schedule simulation statistics.  Times are in core clock cycles of simulated time.  The task
+//   indices are the scheduler task numbers (SCHED_xx in Sched_def.h)
+struct REPLAY_SCHED_STATS
+{
+  uint64_t SPI1PrevTime;                    // Time of the end of the previous SPI1 flags slice
+  uint64_t BkgndPrevTime;                   // Time of the end of the previous background pass
+  uint32_t SPI1MaxGap;                      // Max time between the ends of the SPI1 flags slices
+  uint32_t BkgndMaxPeriod;                  // Max time between the ends of the background passes
+  uint32_t Passes[SCHED_NUM_TASKS];         // Number of completed passes
+  uint32_t MaxResp[SCHED_NUM_TASKS];        // Max time from the anniversary to the end of the pass
+  uint32_t Misses[SCHED_NUM_TASKS];         // Number of passes done after the task deadline
+  uint32_t Lost[SCHED_NUM_TASKS];           // Number of anniversaries that occurred with the flag set
+};
+
+// Flash waveform pipeline benchmark statistics for one run.  Times are in core clock cycles of simulated time
+struct REPLAY_FLASH_STATS
+{
+  uint64_t Cyc;                             // Total time from the capture requests to the ends of the writes
+  uint32_t MaxCyc;                          // Max time for one capture
+  uint32_t Pages;                           // Number of pages programmed
+  uint32_t BusyPolls;                       // Number of status reads that found the Flash busy
+  uint32_t Stalls;                          // Number of times a page was held off waiting for samples
+  uint32_t Mismatches;                      // Number of sample sets in Flash that do not match the samples
+  uint32_t FlashErrs;                       // Number of commands the Flash would not have accepted
+};
+
+// Event queue stress test simulated interrupt.  Fired and Acked are the handshake between the interrupt
+//   thread and the foreground, and are accessed with the gcc atomic builtins
+struct REPLAY_EVQ_ISR
+{
+  uint32_t Bursts;                          // Number of bursts to fire
+  uint32_t Posted;                          // Number of events posted
+  struct REPLAY_TIME Time;                  // Host time spent posting the events
+  uint32_t Fired;                           // Number of bursts fired (written by the interrupt thread)
+  uint32_t Acked;                           // Number of bursts processed (written by the foreground)
+};
+
+// Sequence component benchmark outputs (see Replay_SeqGet())
+struct REPLAY_SEQ_OUT
+{
+  float Mag[6];                             // I0, I1, I2, V0, V1, V2 magnitudes
+  float Unbal[2];                           // Current and voltage negative-sequence unbalances
+  float Ang[REPLAY_SEQ_ANGLES];             // PhAngles1[], PhAngles2[]
+};
+
+// CAM port link and receiver model for the sampled-value frame benchmark (see Replay_CamSvLink())
+struct REPLAY_CAMSV_LINK
+{
+  uint8_t RxBuf[REPLAY_CAMSV_RXBUF];        // Received bytes that have not been parsed
+  uint16_t RxLen;                           // Number of bytes in RxBuf[]
+  uint16_t Len;                             // Length of the transfer in progress
+  uint16_t Left;                            // Bytes left in the transfer in progress (0 if idle)
+  uint16_t Stall;                           // Samples that the link is held up
+  uint32_t M0AR;                            // Memory address of the transfer in progress
+  double Credit;                            // Bytes that the UART can send
+  uint32_t Good;                            // Frames received with a good CRC
+  uint32_t Bad;                             // Frame headers with a bad CRC
+  uint32_t Missing;                         // Frames missing from the sequence
+  uint32_t Errs;                            // Good frames out of sequence, out of time order, or whose
+                                            //   samples do not match the samples that were buffered
+  uint32_t NextSeq;                         // Next expected sequence number
+  uint32_t LastSecs;                        // Time stamp of the last good frame
+  uint32_t LastNsec;
+};
+
+#endif                  // HOSTREPLAY_DEF_H
@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//                      gcc (x86-64 Linux) for the host build only
+//
+//  MODULE NAME:        HostReplay_ext.h
+//
+//  MECHANICS:          This is the declarations file for the HostReplay.c, HostReplay_Meter.c,
+//                      HostReplay_Sched.c, HostReplay_Flash.c, HostReplay_Events.c, and HostReplay_Comm.c
+//                      modules
+//
+//  TARGET HARDWARE:    None (host PC)
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   154    240206  DAH File Creation
+//   156    240208  DAH - Added Replay_HarmBench()
+//   157    240209  DAH - Added Replay_GatherBench()
+//   158    240210  DAH - Added Replay_SOSBench()
+//   159    240211  DAH - Added Replay_AFEBlockBench()
+//   161    240213  DAH - Added Replay_SchedSim()
+//   164    240216  DAH - Added Replay_FlashBench()
+//   165    240217  DAH - Added Replay_WfCodecBench()
+//   166    240218  DAH - Added Replay_EventBench()
+//   167    240219  DAH - Added Replay_EventQBench()
+//   168    240220  DAH - Added Replay_EventWCBench()
+//   169    240221  DAH - Added Replay_CrcBench()
+//   170    240222  DAH - Added Replay_DPTxBench()
+//   171    240223  DAH - Added Replay_ModbBench()
+//   173    240225  DAH - Added Replay_ProtBench()
+//   174    240226  DAH - Added Replay_KernBench()
+//   175    240227  DAH - Added Replay_SeqBench()
+//   176    240228  DAH - Added Replay_FreqBench()
+//   177    240229  DAH - Added Replay_CamSvBench()
+//   179    240302  DAH - Deleted Replay_ProtBench() and Replay_KernBench()
+//                      - Added Replay_Sample(), Replay_Nsec(), Replay_TimeStart(), Replay_TimeStop(),
+//                        Replay_Ratio(), Replay_RandF(), and Replay_RandU().  These are used by the
+//                        benchmarks, which were moved from HostReplay.c into HostReplay_Meter.c,
+//                        HostReplay_Sched.c, HostReplay_Flash.c, HostReplay_Events.c, and HostReplay_Comm.c
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Global Variable Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+extern struct REPLAY_STATS ReplayStats;
+extern struct REPLAY_SYNTH ReplaySynth;
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//                    Global Function Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+extern void Replay_VarInit(void);
+extern uint8_t Replay_Open(uint8_t src, const char *filename);
+extern uint64_t Replay_Run(uint64_t num_samples);
+extern void Replay_Report(FILE *fp);
+extern uint8_t Replay_Sample(void);
+extern uint64_t Replay_Nsec(void);
+extern void Replay_TimeStart(struct REPLAY_TIME *tptr);
+extern uint64_t Replay_TimeStop(struct REPLAY_TIME *tptr);
+extern double Replay_Ratio(double num, double den);
+extern float Replay_RandF(float lo, float hi);
+extern uint32_t Replay_RandU(uint32_t lo, uint32_t hi);
+extern void Replay_HarmBench(uint32_t trials, FILE *fp);
+extern void Replay_GatherBench(uint32_t trials, FILE *fp);
+#ifdef ENABLE_SIMD_SOS
+  extern void Replay_SOSBench(uint32_t trials, FILE *fp);
+#endif
+extern void Replay_AFEBlockBench(uint32_t trials, FILE *fp);
+#ifdef ENABLE_MAIN_SCHED
+  extern void Replay_SchedSim(uint32_t seconds, FILE *fp);
+#endif
+#ifdef ENABLE_SPI1_DMA
+  extern void Replay_FlashBench(uint32_t captures, FILE *fp);
+#endif
+#ifdef ENABLE_WF_CODEC
+  extern void Replay_WfCodecBench(uint32_t captures, FILE *fp);
+#endif
+#if defined(ENABLE_EID_INDEX) && defined(ENABLE_SPI2_DMA)
+  extern void Replay_EventBench(uint32_t passes, FILE *fp);
+#endif
+#if defined(ENABLE_EVENT_QUEUE) && defined(ENABLE_SPI2_DMA)
+  extern void Replay_EventQBench(uint32_t bursts, FILE *fp);
+#endif
+#ifdef ENABLE_SPI2_DMA
+  extern void Replay_EventWCBench(uint32_t bursts, FILE *fp);
+#endif
+#ifdef ENABLE_CRC_SLICE
+  extern void Replay_CrcBench(uint32_t trials, FILE *fp);
+#endif
+extern void Replay_DPTxBench(uint32_t trials, FILE *fp);
+extern void Replay_ModbBench(uint32_t passes, FILE *fp);
+#ifdef ENABLE_SEQ_PHASOR
+  extern void Replay_SeqBench(uint32_t cycles, FILE *fp);
+#endif
+#ifdef ENABLE_FREQ_TRACK
+  extern void Replay_FreqBench(uint32_t cycles, FILE *fp);
+#endif
+#ifdef ENABLE_CAM_SV_FRAME
+  extern void Replay_CamSvBench(uint32_t frames, FILE *fp);
+#endif
+
@@ -0,0 +1,766 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//                      gcc (x86-64 Linux) for the host build only
+//
+//  MODULE NAME:        HostShim.c
+//
+//  MECHANICS:          Program module containing the hardware-abstraction shim for the host (off-target)
+//                      build.  This module is not part of the target project (PXR35_ProtProc.ewp).  It is
+//                      only compiled when HOST_BUILD is defined.  See HostShim_def.h for a description of
+//                      the host build.
+//
+//  TARGET HARDWARE:    None (host PC)
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   153    240205  DAH File Creation
+//   155    240207  DAH - Added Host_CycCnt() to replace the DWT cycle counter for the stage profiler
+//   161    240213  DAH - Added Host_SimCyc and Host_SimClk.  Host_CycCnt() returns the simulated cycle
+//                        count if Host_SimClk is set
+//   163    240215  DAH - Added the SPI2 FRAM model: Host_FramSelect(), Host_FramDeselect(), Host_FramFrame(),
+//                        Host_FramByte(), Host_FramBusyCyc, Host_FramXacts
+//   164    240216  DAH - Added the SPI1 serial Flash model: Host_FlashSelect(), Host_FlashDeselect(),
+//                        Host_FlashFrame(), Host_FlashByte(), Host_FlashMem[], Host_FlashTpp,
+//                        Host_FlashPages, Host_FlashErrs, Host_FlashBusyCyc
+//   165    240217  DAH - Revised Host_FlashByte() to model the read command
+//   167    240219  DAH - Added Host_IPSR
+//   178    240301  DAH - Revised Host_MapWindow() to pass the window address as a hint only (no MAP_FIXED),
+//                        and to fail if the window is not mapped at that address.  MAP_FIXED replaces any
+//                        mapping that is already there (heap, libraries, stack) without an error
+//                          - Deleted the MAP_FIXED_NOREPLACE definition
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+//
+//------------------------------------------------------------------------------------------------------------
+//
+#ifdef HOST_BUILD
+
+//------------------------------------------------------------------------------------------------------------
+//                   Definitions
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global Definitions from external files...
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "stm32f4xx.h"
+#include "stm32f407xx.h"
+#include "HostShim_def.h"
+
+//
+//      Local Definitions used in this module...
+//
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global (Visible) Function Prototypes (These functions are called by other modules)
+//
+void Host_Init(void);
+void Host_PresetStatus(void);
+uint32_t Host_CycCnt(void);
+void Host_FramSelect(uint8_t dev);
+void Host_FramDeselect(void);
+uint16_t Host_FramFrame(uint8_t width16, uint16_t tx);
+void Host_FlashSelect(void);
+void Host_FlashDeselect(void);
+uint16_t Host_FlashFrame(uint8_t width16, uint16_t tx);
+
+//      Local Function Prototypes (These functions are called only within this module)
+//
+void Host_MapWindow(uint32_t add, uint32_t size);
+uint8_t Host_FramByte(uint8_t tx);
+uint8_t Host_FlashByte(uint8_t tx);
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Storage Allocation - Global (Static) Variables
+//------------------------------------------------------------------------------------------------------------
+//
+//       These variables are used by other modules...
+//
+volatile uint32_t Host_PRIMASK;             // Model of the PRIMASK register (1 = interrupts disabled)
+__thread uint32_t Host_IPSR;                // Model of the IPSR register (nonzero in a simulated interrupt)
+uint32_t Host_SimCyc;                       // Simulated cycle count (used if Host_SimClk is TRUE)
+uint8_t Host_SimClk;                        // TRUE if Host_CycCnt() returns the simulated cycle count
+uint64_t Host_FramBusyCyc;                  // SPI2 bus busy time, in 120MHz core cycles
+uint32_t Host_FramXacts;                    // Number of FRAM chip select cycles
+uint8_t Host_FlashMem[HOST_FLASH_SIZE];     // Serial Flash contents
+uint32_t Host_FlashTpp;                     // Page program time, in 120MHz core cycles
+uint32_t Host_FlashPages;                   // Number of pages programmed
+uint32_t Host_FlashErrs;                    // Number of commands the Flash would not have accepted
+uint64_t Host_FlashBusyCyc;                 // SPI1 bus busy time, in 120MHz core cycles
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Storage Allocation - Local (Static) Variables
+//------------------------------------------------------------------------------------------------------------
+//
+//       These variables are used only in this module...
+//
+uint8_t Host_FrameMem[HOST_FRAME_SIZE];     // Frame FRAM contents
+uint8_t Host_Fram2Mem[HOST_FRAM2_SIZE];     // On-board FRAM contents
+uint8_t *Host_FramMem;                      // Selected FRAM, or 0 if none is selected
+uint32_t Host_FramMask;                     // Address mask for the selected FRAM
+uint32_t Host_FramAddr;                     // Present address
+uint8_t Host_FramAddrLen;                   // Number of address bytes for the selected FRAM
+uint8_t Host_FramNdx;                       // Byte number since the chip select was set
+uint8_t Host_FramOp;                        // Opcode of the present access
+uint8_t Host_FramWEL;                       // Write enable latch
+uint32_t Host_FlashAddr;                    // Serial Flash present address
+uint32_t Host_FlashBusyEnd;                 // Cycle count when the present page program is done
+uint32_t Host_FlashBusCyc;                  // Bus time since the chip select was set
+uint8_t Host_FlashSel;                      // TRUE if the Flash chip select is set
+uint8_t Host_FlashNdx;                      // Byte number since the chip select was set
+uint8_t Host_FlashOp;                       // Opcode of the present access
+uint8_t Host_FlashWEL;                      // Write enable latch
+uint8_t Host_FlashBusy;                     // TRUE if a page program is in progress
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Host_Init()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Host Build Initialization
+//
+//  MECHANICS:          This subroutine maps RAM at each of the peripheral and core register addresses so
+//                      that the peripheral accesses in the application code (for example, ADC3->DR) read
+//                      and write host memory, and then presets the peripheral status bits that are polled.
+//                      Interrupts are initially disabled, as they are on the target coming out of reset.
+//
+//  CAVEATS:            Must be called before any of the application code is executed.  Exits the program
+//                      if the addresses cannot be mapped.
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            Host_PRIMASK, Host_SimCyc, Host_SimClk, Host_FramBusyCyc, Host_FramXacts,
+//                      Host_FramMem, Host_FramWEL, Host_FlashMem[] (erased), Host_FlashTpp,
+//                      Host_FlashPages, Host_FlashErrs, Host_FlashBusyCyc, Host_FlashSel, Host_FlashWEL,
+//                      Host_FlashBusy, peripheral registers
+//
+//  ALTERS:             None
+//
+//  CALLS:              Host_MapWindow(), Host_PresetStatus(), memset()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Host_Init(void)
+{
+  Host_MapWindow(HOST_PERIPH_WIN_ADD, HOST_PERIPH_WIN_SIZE);
+  Host_MapWindow(HOST_AHB2_WIN_ADD, HOST_AHB2_WIN_SIZE);
+  Host_MapWindow(HOST_FSMC_WIN_ADD, HOST_FSMC_WIN_SIZE);
+  Host_MapWindow(HOST_CORE_WIN_ADD, HOST_CORE_WIN_SIZE);
+
+  Host_PresetStatus();
+
+  Host_PRIMASK = 1;
+  Host_SimCyc = 0;
+  Host_SimClk = 0;
+  Host_FramBusyCyc = 0;
+  Host_FramXacts = 0;
+  Host_FramMem = 0;
+  Host_FramWEL = 0;
+  memset(&Host_FlashMem[0], 0xFF, HOST_FLASH_SIZE);
+  Host_FlashTpp = HOST_FLASH_TPP_MAX;
+  Host_FlashPages = 0;
+  Host_FlashErrs = 0;
+  Host_FlashBusyCyc = 0;
+  Host_FlashSel = 0;
+  Host_FlashWEL = 0;
+  Host_FlashBusy = 0;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Host_Init()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Host_MapWindow()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Map Zeroed RAM at a Fixed Address
+//
+//  MECHANICS:          This subroutine maps anonymous (zeroed) memory at the requested address.  The
+//                      address is passed to mmap() as a hint only.  The kernel uses the hint if the range
+//                      is free, and otherwise picks another address.  It never replaces an existing mapping,
+//                      as MAP_FIXED would.  The peripheral addresses are all below 4GB and are not used by
+//                      the Linux x86-64 process layout, so the mapping normally lands at the hint.
+//
+//  CAVEATS:            Exits the program if the window cannot be mapped at the requested address
+//
+//  INPUTS:             add - start address of the window (must be page-aligned)
+//                      size - size of the window in bytes
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              mmap(), munmap()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Host_MapWindow(uint32_t add, uint32_t size)
+{
+  void *ptr;
+
+  ptr = mmap((void *)(uintptr_t)add, size, (PROT_READ | PROT_WRITE), (MAP_PRIVATE | MAP_ANONYMOUS), -1, 0);
+  if (ptr != (void *)(uintptr_t)add)
+  {
+    if (ptr != MAP_FAILED)                  // Mapped somewhere else: the range is in use
+    {
+      munmap(ptr, size);
+    }
+    fprintf(stderr, "HostShim: unable to map peripheral window at 0x%08X\n", (unsigned int)add);
+    exit(1);
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Host_MapWindow()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Host_PresetStatus()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Preset Peripheral Status Bits
+//
+//  MECHANICS:          This subroutine sets the peripheral status bits that the code waits on, so that
+//                      the polling loops fall straight through:
+//                          - SPI1, SPI2, SPI3: TXE and RXNE set, BSY clear (FRAM and Flash accesses)
+//                          - ADC3: EOC set (startup time and battery measurements)
+//                          - RTC: INITF set (internal RTC initialization)
+//                          - TIM1 - TIM5, TIM8, TIM10: UIF set (timer initialization)
+//                          - USART/UART: TXE and TC set
+//                          - RCC: HSE and PLL ready, PLL selected as the system clock
+//                      Since the registers are plain memory, a bit stays set unless the code clears it.
+//                      The test harness may call this subroutine again at any time to restore the bits.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            Peripheral status registers
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Host_PresetStatus(void)
+{
+  SPI1->SR = (SPI_SR_RXNE + SPI_SR_TXE);
+  SPI2->SR = (SPI_SR_RXNE + SPI_SR_TXE);
+  SPI3->SR = (SPI_SR_RXNE + SPI_SR_TXE);
+
+  ADC3->SR |= ADC_SR_EOC;
+
+  RTC->ISR |= RTC_ISR_INITF;
+
+  TIM1->SR |= TIM_SR_UIF;
+  TIM2->SR |= TIM_SR_UIF;
+  TIM3->SR |= TIM_SR_UIF;
+  TIM4->SR |= TIM_SR_UIF;
+  TIM5->SR |= TIM_SR_UIF;
+  TIM8->SR |= TIM_SR_UIF;
+  TIM10->SR |= TIM_SR_UIF;
+
+  USART1->SR |= (USART_SR_TXE + USART_SR_TC);
+  USART2->SR |= (USART_SR_TXE + USART_SR_TC);
+  USART3->SR |= (USART_SR_TXE + USART_SR_TC);
+  UART5->SR |= (USART_SR_TXE + USART_SR_TC);
+  USART6->SR |= (USART_SR_TXE + USART_SR_TC);
+
+  RCC->CR |= (RCC_CR_HSERDY + RCC_CR_PLLRDY);
+  RCC->CFGR = (RCC->CFGR & (~RCC_CFGR_SWS)) | RCC_CFGR_SWS_PLL;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Host_PresetStatus()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Host_CycCnt()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Cycle Counter Stub
+//
+//  MECHANICS:          This subroutine replaces the DWT cycle counter (DWT->CYCCNT) in the host build.  It
+//                      returns the host monotonic clock scaled to 120MHz core clock cycles (0.12 cycles per
+//                      nanosecond), truncated to 32 bits so that it rolls over the same way as the target
+//                      counter.  Differences of two readings are therefore handled the same as on the target.
+//                      If Host_SimClk is set, the simulated cycle count, Host_SimCyc, is returned instead.
+//                      This is used to run the main loop scheduler on simulated time (see Replay_SchedSim()).
+//
+//  CAVEATS:            The counts are host time, not target execution time
+//
+//  INPUTS:             Host_SimClk, Host_SimCyc
+//
+//  OUTPUTS:            Returns the cycle count
+//
+//  ALTERS:             None
+//
+//  CALLS:              clock_gettime()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint32_t Host_CycCnt(void)
+{
+  struct timespec ts;
+  uint64_t nsec;
+
+  if (Host_SimClk)
+  {
+    return (Host_SimCyc);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  nsec = ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+  return ( (uint32_t)((nsec * 3U) / 25U) );
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Host_CycCnt()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Host_FramSelect(), Host_FramDeselect()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           FRAM Model Chip Select
+//
+//  MECHANICS:          These subroutines model the FRAM chip selects for the SPI2 transaction engine (see
+//                      SPI2_StartXact() in Iod.c).  Device 0 is the Frame FRAM (DEV_FRAME) and device 1 is
+//                      the on-board FRAM (DEV_FRAM2).  Any other device selects nothing, the same as on the
+//                      target.  As on the FRAM, the write enable latch is cleared when the chip select is
+//                      released after a write.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             dev - the device
+//
+//  OUTPUTS:            Host_FramMem, Host_FramMask, Host_FramAddrLen, Host_FramNdx, Host_FramOp,
+//                      Host_FramWEL, Host_FramXacts
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Host_FramSelect(uint8_t dev)
+{
+  if (dev == 0)
+  {
+    Host_FramMem = &Host_FrameMem[0];
+    Host_FramMask = HOST_FRAME_SIZE - 1;
+    Host_FramAddrLen = 2;
+  }
+  else if (dev == 1)
+  {
+    Host_FramMem = &Host_Fram2Mem[0];
+    Host_FramMask = HOST_FRAM2_SIZE - 1;
+    Host_FramAddrLen = 3;
+  }
+  else
+  {
+    Host_FramMem = 0;
+  }
+  Host_FramNdx = 0;
+  Host_FramOp = 0;
+}
+
+void Host_FramDeselect(void)
+{
+  if (Host_FramOp == HOST_FRAM_WRITE)
+  {
+    Host_FramWEL = 0;
+  }
+  Host_FramMem = 0;
+  ++Host_FramXacts;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Host_FramSelect(), Host_FramDeselect()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Host_FramFrame()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           FRAM Model SPI2 Frame
+//
+//  MECHANICS:          This subroutine models one SPI2 frame to the selected FRAM.  A 16-bit frame is sent
+//                      as two bytes, ms byte first, the same as on the bus.  The bus time is added to
+//                      Host_FramBusyCyc, so the replay can report how much of the run the FRAM accesses
+//                      would take on the target.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             width16 - 0 for an 8-bit frame, 1 for a 16-bit frame
+//                      tx - the transmitted frame
+//
+//  OUTPUTS:            Returns the received frame
+//                      Host_FramBusyCyc
+//
+//  ALTERS:             None
+//
+//  CALLS:              Host_FramByte()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint16_t Host_FramFrame(uint8_t width16, uint16_t tx)
+{
+  uint16_t rx;
+
+  if (width16)
+  {
+    rx = ((uint16_t)Host_FramByte((uint8_t)(tx >> 8))) << 8;
+    rx |= Host_FramByte((uint8_t)tx);
+    Host_FramBusyCyc += (16 * HOST_FRAM_CYC_PER_BIT);
+  }
+  else
+  {
+    rx = Host_FramByte((uint8_t)tx);
+    Host_FramBusyCyc += (8 * HOST_FRAM_CYC_PER_BIT);
+  }
+  return (rx);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Host_FramFrame()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Host_FramByte()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           FRAM Model Byte
+//
+//  MECHANICS:          This subroutine models one byte to the selected FRAM.  The first byte after the chip
+//                      select is set is the opcode.  Write enable sets the write enable latch.  Read and
+//                      write are followed by the address bytes (ms byte first), and then the data bytes.
+//                      The address increments after each data byte and wraps at the end of the memory.
+//                      Writes are ignored unless the write enable latch is set.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             tx - the transmitted byte
+//
+//  OUTPUTS:            Returns the received byte
+//                      The selected FRAM memory, Host_FramOp, Host_FramAddr, Host_FramNdx, Host_FramWEL
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Host_FramByte(uint8_t tx)
+{
+  uint8_t rx;
+
+  rx = 0xFF;                                // MISO floats high if no device is driving it
+  if (Host_FramMem == 0)
+  {
+    return (rx);
+  }
+
+  if (Host_FramNdx == 0)                    // Opcode
+  {
+    Host_FramOp = tx;
+    Host_FramAddr = 0;
+    if (tx == HOST_FRAM_WREN)
+    {
+      Host_FramWEL = 1;
+    }
+  }
+  else if (Host_FramNdx <= Host_FramAddrLen)    // Address
+  {
+    Host_FramAddr = (Host_FramAddr << 8) | tx;
+  }
+  else if (Host_FramOp == HOST_FRAM_READ)   // Read data
+  {
+    rx = Host_FramMem[Host_FramAddr & Host_FramMask];
+    ++Host_FramAddr;
+  }
+  else if (Host_FramOp == HOST_FRAM_WRITE)  // Write data
+  {
+    if (Host_FramWEL)
+    {
+      Host_FramMem[Host_FramAddr & Host_FramMask] = tx;
+    }
+    ++Host_FramAddr;
+  }
+  if (Host_FramNdx <= Host_FramAddrLen)
+  {
+    ++Host_FramNdx;
+  }
+  return (rx);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Host_FramByte()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Host_FlashSelect(), Host_FlashDeselect()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Serial Flash Model Chip Select
+//
+//  MECHANICS:          These subroutines model the serial Flash chip select for the SPI1 waveform pipeline
+//                      (see Flash_PipeStart() in Iod.c).  When the chip select is released after a page
+//                      program with the write enable latch set, the Flash starts the internal program
+//                      cycle: it is busy until Host_FlashTpp cycles after the end of the bus transfer, and
+//                      the write enable latch is cleared.
+//
+//  CAVEATS:            The bus time of the transfer is added to the cycle count when the chip select is
+//                      released, since the simulated clock (Host_SimCyc) does not advance during a call
+//
+//  INPUTS:             Host_FlashOp, Host_FlashWEL, Host_FlashBusCyc, Host_FlashTpp
+//
+//  OUTPUTS:            Host_FlashSel, Host_FlashNdx, Host_FlashOp, Host_FlashBusCyc, Host_FlashWEL,
+//                      Host_FlashBusy, Host_FlashBusyEnd, Host_FlashPages
+//
+//  ALTERS:             None
+//
+//  CALLS:              Host_CycCnt()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Host_FlashSelect(void)
+{
+  Host_FlashSel = 1;
+  Host_FlashNdx = 0;
+  Host_FlashOp = 0;
+  Host_FlashBusCyc = 0;
+}
+
+void Host_FlashDeselect(void)
+{
+  if (Host_FlashSel && (Host_FlashOp == HOST_FLASH_PP) && Host_FlashWEL)
+  {
+    Host_FlashBusyEnd = Host_CycCnt() + Host_FlashBusCyc + Host_FlashTpp;
+    Host_FlashBusy = 1;
+    Host_FlashWEL = 0;
+    ++Host_FlashPages;
+  }
+  Host_FlashSel = 0;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Host_FlashSelect(), Host_FlashDeselect()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Host_FlashFrame()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Serial Flash Model SPI1 Frame
+//
+//  MECHANICS:          This subroutine models one SPI1 frame to the serial Flash.  A 16-bit frame is sent as
+//                      two bytes, ms byte first, the same as on the bus.  The bus time is added to
+//                      Host_FlashBusyCyc and to the time for the present chip select cycle.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             width16 - 0 for an 8-bit frame, 1 for a 16-bit frame
+//                      tx - the transmitted frame
+//
+//  OUTPUTS:            Returns the received frame
+//                      Host_FlashBusyCyc, Host_FlashBusCyc
+//
+//  ALTERS:             None
+//
+//  CALLS:              Host_FlashByte()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint16_t Host_FlashFrame(uint8_t width16, uint16_t tx)
+{
+  uint16_t rx;
+
+  if (width16)
+  {
+    rx = ((uint16_t)Host_FlashByte((uint8_t)(tx >> 8))) << 8;
+    rx |= Host_FlashByte((uint8_t)tx);
+    Host_FlashBusyCyc += (16 * HOST_FLASH_CYC_PER_BIT);
+    Host_FlashBusCyc += (16 * HOST_FLASH_CYC_PER_BIT);
+  }
+  else
+  {
+    rx = Host_FlashByte((uint8_t)tx);
+    Host_FlashBusyCyc += (8 * HOST_FLASH_CYC_PER_BIT);
+    Host_FlashBusCyc += (8 * HOST_FLASH_CYC_PER_BIT);
+  }
+  return (rx);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Host_FlashFrame()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Host_FlashByte()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Serial Flash Model Byte
+//
+//  MECHANICS:          This subroutine models one byte to the serial Flash.  The first byte after the chip
+//                      select is set is the opcode:
+//                        - Write enable sets the write enable latch
+//                        - Read status returns the status register.  BUSY is b0 and b7 (the SST26VF064B
+//                          has it in both places), and WEL is b1
+//                        - Page program is followed by three address bytes (ms byte first), and then the
+//                          data bytes.  Programming can only clear bits, so the data is ANDed into the
+//                          memory.  The address wraps at the end of the 256-byte page, as on the device
+//                        - Read is followed by three address bytes, and then returns the memory contents
+//                          from the address onward
+//                      While a page program is in progress, only read status is accepted.  Any other
+//                      command, and a page program without the write enable latch set, are counted in
+//                      Host_FlashErrs, since the data would have been lost on the target.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             tx - the transmitted byte
+//                      Host_FlashBusyEnd
+//
+//  OUTPUTS:            Returns the received byte
+//                      Host_FlashMem[], Host_FlashOp, Host_FlashAddr, Host_FlashNdx, Host_FlashWEL,
+//                      Host_FlashBusy, Host_FlashErrs
+//
+//  ALTERS:             None
+//
+//  CALLS:              Host_CycCnt()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Host_FlashByte(uint8_t tx)
+{
+  uint8_t rx;
+
+  rx = 0xFF;                                // MISO floats high if the device is not selected
+  if (!Host_FlashSel)
+  {
+    return (rx);
+  }
+
+  if (Host_FlashBusy && ((int32_t)(Host_CycCnt() - Host_FlashBusyEnd) >= 0))
+  {
+    Host_FlashBusy = 0;                     // Page program is done
+  }
+
+  if (Host_FlashNdx == 0)                   // Opcode
+  {
+    Host_FlashOp = tx;
+    Host_FlashAddr = 0;
+    if (Host_FlashBusy && (tx != HOST_FLASH_RDSR))
+    {
+      ++Host_FlashErrs;                     // Command is ignored while busy
+      Host_FlashOp = 0;
+    }
+    else if (tx == HOST_FLASH_WREN)
+    {
+      Host_FlashWEL = 1;
+    }
+    else if ((tx == HOST_FLASH_PP) && (!Host_FlashWEL))
+    {
+      ++Host_FlashErrs;
+    }
+  }
+  else if (Host_FlashOp == HOST_FLASH_RDSR) // Status
+  {
+    rx = (Host_FlashBusy ? 0x81 : 0x00) | (Host_FlashWEL ? 0x02 : 0x00);
+  }
+  else if (Host_FlashNdx <= 3)              // Address
+  {
+    Host_FlashAddr = (Host_FlashAddr << 8) | tx;
+  }
+  else if (Host_FlashOp == HOST_FLASH_READ) // Read data
+  {
+    rx = Host_FlashMem[Host_FlashAddr & (HOST_FLASH_SIZE - 1)];
+    ++Host_FlashAddr;
+  }
+  else if (Host_FlashOp == HOST_FLASH_PP)   // Program data
+  {
+    if (Host_FlashWEL)
+    {
+      Host_FlashMem[Host_FlashAddr & (HOST_FLASH_SIZE - 1)] &= tx;
+    }
+    Host_FlashAddr = (Host_FlashAddr & 0xFFFFFF00) | ((Host_FlashAddr + 1) & 0x000000FF);
+  }
+  if (Host_FlashNdx <= 3)
+  {
+    ++Host_FlashNdx;
+  }
+  return (rx);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Host_FlashByte()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // HOST_BUILD
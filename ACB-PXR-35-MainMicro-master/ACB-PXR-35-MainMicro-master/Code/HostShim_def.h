@@ -0,0 +1,301 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//                      gcc (x86-64 Linux) for the host build only
+//
+//  MODULE NAME:        HostShim_def.h
+//
+//  MECHANICS:          This is the definitions file for the HostShim.c module.  It is only used when the
+//                      code is compiled off-target (HOST_BUILD is defined), and is included by
+//                      core_cmInstr.h, core_cmFunc.h, and core_cm4_simd.h in place of the compiler-specific
+//                      core functions.
+//
+//                      The host build allows the protection and metering code (Prot.c, Meter.c, Demand.c,
+//                      Events.c, Setpnt.c, Modbus.c, and the modules they call) to be compiled with gcc and
+//                      run on an x86-64 Linux PC, so that the one-cycle and 200msec anniversary code can be
+//                      profiled with perf and valgrind.  The application code is not changed:
+//                        - The peripheral register blocks (ADC3->DR, TIM2->SR, DMA1->LIFCR, USART6->CR1,
+//                          etc.) are accessed through the same fixed addresses as on the target.
+//                          Host_Init() maps RAM at these addresses, so register reads and writes simply
+//                          read and write the RAM.  Status bits that the code polls (SPIx TXE/RXNE,
+//                          ADC3 EOC, etc.) are preset so that the polling loops do not hang
+//                        - The core functions (__disable_irq(), __DSB(), __CLZ(), etc.) are replaced with
+//                          the portable C functions below.  PRIMASK is modelled by Host_PRIMASK so that a
+//                          host test harness can hold off its simulated interrupts
+//                        - The IAR "@" location operator is compiled out (see SRAM1_LOC and SRAM2_LOC in
+//                          stm32f4xx.h)
+//
+//                      The host build is the HostReplay target in CMakeLists.txt (in the project directory):
+//                          cmake -S . -B build -DCMSIS_DSP_DIR=<CMSIS-DSP> [-DSENSORBUS_COMMON_DIR=<dir>]
+//                          cmake --build build
+//                      It compiles the IAR project source files (except main.c and the startup file),
+//                      HostShim.c, HostReplay.c, and the CMSIS-DSP functions that are used, with
+//                      gcc -m64 -DHOST_BUILD -DSTM32F407xx -DUSE_HAL_DRIVER -DARM_MATH_CM4.  Host_Init()
+//                      must be called before any of the application code is executed.
+//                      HostReplay.c supplies main() for the host build, in place of main.c.  It replays a
+//                      recorded or synthetic sample stream through the sampling interrupts.  See
+//                      HostReplay.c
+//
+//  TARGET HARDWARE:    None (host PC)
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   153    240205  DAH File Creation
+//   154    240206  DAH - Added HostReplay.c to the compiler settings description
+//   155    240207  DAH - Added Host_CycCnt() declaration
+//   158    240210  DAH - Added portable C versions of the SIMD functions __PKHBT(), __QSUB16(), and
+//                        __SMLALD()
+//   161    240213  DAH - Added Host_SimCyc and Host_SimClk declarations
+//   163    240215  DAH - Added the FRAM model constants and the Host_FramSelect(), Host_FramDeselect(),
+//                        Host_FramFrame(), Host_FramBusyCyc, and Host_FramXacts declarations
+//   164    240216  DAH - Added the serial Flash model constants and the Host_FlashSelect(),
+//                        Host_FlashDeselect(), Host_FlashFrame(), Host_FlashMem[], Host_FlashTpp,
+//                        Host_FlashPages, Host_FlashErrs, and Host_FlashBusyCyc declarations
+//   165    240217  DAH - Added HOST_FLASH_READ
+//   167    240219  DAH - Added Host_IPSR.  __get_IPSR() returns Host_IPSR
+//                      - Added -pthread to the compiler settings description
+//   178    240301  DAH - Replaced the compiler settings description with a description of the HostReplay
+//                        target in CMakeLists.txt
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+//
+//------------------------------------------------------------------------------------------------------------
+
+#ifndef HOSTSHIM_DEF_H
+#define HOSTSHIM_DEF_H
+
+#include <stdint.h>
+
+//
+//------------------------------------------------------------------------------------------------------------
+//    Constants
+//------------------------------------------------------------------------------------------------------------
+
+// Address windows that are mapped to RAM by Host_Init().  These cover every peripheral and core register
+//   block that is referenced in the code
+#define HOST_PERIPH_WIN_ADD     0x40000000UL        // APB1, APB2, AHB1 (PERIPH_BASE)
+#define HOST_PERIPH_WIN_SIZE    0x00080000UL
+#define HOST_AHB2_WIN_ADD       0x50000000UL        // AHB2 (USB OTG FS, RNG)
+#define HOST_AHB2_WIN_SIZE      0x00061000UL
+#define HOST_FSMC_WIN_ADD       0xA0000000UL        // FSMC control registers (FSMC_R_BASE)
+#define HOST_FSMC_WIN_SIZE      0x00001000UL
+#define HOST_CORE_WIN_ADD       0xE0000000UL        // ITM, DWT, SysTick, NVIC, SCB (SCS_BASE)
+#define HOST_CORE_WIN_SIZE      0x00100000UL
+
+// FRAM model (see Host_FramFrame()).  The opcodes are the same as FRAM_xx in Iod_def.h
+#define HOST_FRAM_WREN          0x06
+#define HOST_FRAM_READ          0x03
+#define HOST_FRAM_WRITE         0x02
+#define HOST_FRAME_SIZE         0x00002000UL        // Frame FRAM (device 0): 8KB, 2 address bytes
+#define HOST_FRAM2_SIZE         0x00040000UL        // On-board FRAM (device 1): 256KB, 3 address bytes
+#define HOST_FRAM_CYC_PER_BIT   8                   // 120MHz core cycles per SPI2 bit (15MHz clock)
+
+// Serial Flash model (see Host_FlashFrame()).  The opcodes are the same as FLASH_xx in Iod_def.h.  The page
+//   program time is Host_FlashTpp, initially the max time of the SST26VF064B (1.5msec)
+#define HOST_FLASH_WREN         0x06
+#define HOST_FLASH_PP           0x02
+#define HOST_FLASH_RDSR         0x05
+#define HOST_FLASH_READ         0x03
+#define HOST_FLASH_SIZE         0x00800000UL        // SST26VF064B: 8MB, 3 address bytes
+#define HOST_FLASH_CYC_PER_BIT  8                   // 120MHz core cycles per SPI1 bit (15MHz clock)
+#define HOST_FLASH_TPP_MAX      180000UL            // Max page program time (1.5msec) in core cycles
+
+//
+//------------------------------------------------------------------------------------------------------------
+//    Global Variable Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+extern volatile uint32_t Host_PRIMASK;
+extern __thread uint32_t Host_IPSR;
+extern uint32_t Host_SimCyc;
+extern uint8_t Host_SimClk;
+extern uint64_t Host_FramBusyCyc;
+extern uint32_t Host_FramXacts;
+extern uint8_t Host_FlashMem[];
+extern uint32_t Host_FlashTpp;
+extern uint32_t Host_FlashPages;
+extern uint32_t Host_FlashErrs;
+extern uint64_t Host_FlashBusyCyc;
+
+//------------------------------------------------------------------------------------------------------------
+//    Global Function Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+extern void Host_Init(void);
+extern void Host_PresetStatus(void);
+extern uint32_t Host_CycCnt(void);
+extern void Host_FramSelect(uint8_t dev);
+extern void Host_FramDeselect(void);
+extern uint16_t Host_FramFrame(uint8_t width16, uint16_t tx);
+extern void Host_FlashSelect(void);
+extern void Host_FlashDeselect(void);
+extern uint16_t Host_FlashFrame(uint8_t width16, uint16_t tx);
+
+//
+//------------------------------------------------------------------------------------------------------------
+//    Core Functions (replace core_cmFunc.h)
+//------------------------------------------------------------------------------------------------------------
+//
+// Interrupts are simulated by the host test harness, so interrupt enable and disable just update the model
+//   of the PRIMASK register.  IPSR is modelled by Host_IPSR, which is per thread so that a host test harness
+//   can run a simulated interrupt in its own thread.  The remaining special registers are not used by the
+//   application code and read as zero
+static inline void __enable_irq(void)               { Host_PRIMASK = 0; }
+static inline void __disable_irq(void)              { Host_PRIMASK = 1; }
+static inline uint32_t __get_PRIMASK(void)          { return (Host_PRIMASK); }
+static inline void __set_PRIMASK(uint32_t priMask)  { Host_PRIMASK = (priMask & 1U); }
+static inline void __enable_fault_irq(void)         { }
+static inline void __disable_fault_irq(void)        { }
+static inline uint32_t __get_CONTROL(void)          { return (0); }
+static inline void __set_CONTROL(uint32_t control)  { (void)control; }
+static inline uint32_t __get_IPSR(void)             { return (Host_IPSR); }
+static inline uint32_t __get_APSR(void)             { return (0); }
+static inline uint32_t __get_xPSR(void)             { return (0); }
+static inline uint32_t __get_PSP(void)              { return (0); }
+static inline void __set_PSP(uint32_t topOfProcStack) { (void)topOfProcStack; }
+static inline uint32_t __get_MSP(void)              { return (0); }
+static inline void __set_MSP(uint32_t topOfMainStack) { (void)topOfMainStack; }
+static inline uint32_t __get_BASEPRI(void)          { return (0); }
+static inline void __set_BASEPRI(uint32_t value)    { (void)value; }
+static inline uint32_t __get_FAULTMASK(void)        { return (0); }
+static inline void __set_FAULTMASK(uint32_t faultMask) { (void)faultMask; }
+static inline uint32_t __get_FPSCR(void)            { return (0); }
+static inline void __set_FPSCR(uint32_t fpscr)      { (void)fpscr; }
+
+//
+//------------------------------------------------------------------------------------------------------------
+//    Core Instructions (replace core_cmInstr.h)
+//------------------------------------------------------------------------------------------------------------
+//
+// The barriers only need to keep the compiler from reordering the register accesses
+#define __NOP()                 __asm volatile ("" ::: "memory")
+#define __WFI()                 __asm volatile ("" ::: "memory")
+#define __WFE()                 __asm volatile ("" ::: "memory")
+#define __SEV()                 __asm volatile ("" ::: "memory")
+#define __ISB()                 __asm volatile ("" ::: "memory")
+#define __DSB()                 __asm volatile ("" ::: "memory")
+#define __DMB()                 __asm volatile ("" ::: "memory")
+#define __BKPT(value)           __builtin_trap()
+#define __CLREX()
+
+static inline uint32_t __REV(uint32_t value)        { return (__builtin_bswap32(value)); }
+
+static inline uint32_t __REV16(uint32_t value)
+{
+  return ( ((value & 0xFF00FF00U) >> 8) | ((value & 0x00FF00FFU) << 8) );
+}
+
+static inline int32_t __REVSH(int32_t value)
+{
+  return ( (int32_t)(int16_t)__builtin_bswap16((uint16_t)value) );
+}
+
+static inline uint32_t __ROR(uint32_t op1, uint32_t op2)
+{
+  op2 &= 31U;
+  return ( (op2 == 0U) ? op1 : ((op1 >> op2) | (op1 << (32U - op2))) );
+}
+
+static inline uint32_t __RBIT(uint32_t value)
+{
+  uint32_t result = 0;
+  uint8_t i;
+
+  for (i = 0; i < 32; ++i)
+  {
+    result = (result << 1) | (value & 1U);
+    value >>= 1;
+  }
+  return (result);
+}
+
+static inline uint8_t __CLZ(uint32_t value)
+{
+  return ( (value == 0U) ? 32U : (uint8_t)__builtin_clz(value) );
+}
+
+// The host code is single-threaded with respect to the simulated interrupts, so the exclusive store always
+//   succeeds (returns 0)
+static inline uint8_t __LDREXB(volatile uint8_t *addr)              { return (*addr); }
+static inline uint16_t __LDREXH(volatile uint16_t *addr)            { return (*addr); }
+static inline uint32_t __LDREXW(volatile uint32_t *addr)            { return (*addr); }
+static inline uint32_t __STREXB(uint8_t value, volatile uint8_t *addr)    { *addr = value; return (0); }
+static inline uint32_t __STREXH(uint16_t value, volatile uint16_t *addr)  { *addr = value; return (0); }
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *addr)  { *addr = value; return (0); }
+
+static inline int32_t __host_ssat(int32_t val, uint32_t sat)
+{
+  int32_t max = (int32_t)((1U << (sat - 1U)) - 1U);
+  int32_t min = -1 - max;
+
+  return ( (val > max) ? max : ((val < min) ? min : val) );
+}
+
+static inline uint32_t __host_usat(int32_t val, uint32_t sat)
+{
+  uint32_t max = (1U << sat) - 1U;
+
+  return ( (val < 0) ? 0U : (((uint32_t)val > max) ? max : (uint32_t)val) );
+}
+
+#define __SSAT(ARG1,ARG2)       __host_ssat((ARG1), (ARG2))
+#define __USAT(ARG1,ARG2)       __host_usat((ARG1), (ARG2))
+
+// SIMD (DSP extension) functions.  Only the functions that are used in the code are included.  The packed
+//   half-words are treated as signed 16-bit values, the same as the Cortex-M4 instructions
+#define __PKHBT(ARG1,ARG2,ARG3) ( (((uint32_t)(ARG1)) & 0x0000FFFFUL) |                                    \
+                                  ((((uint32_t)(ARG2)) << (ARG3)) & 0xFFFF0000UL) )
+
+static inline uint32_t __QSUB16(uint32_t op1, uint32_t op2)
+{
+  int32_t lo = __host_ssat(((int32_t)(int16_t)op1 - (int32_t)(int16_t)op2), 16U);
+  int32_t hi = __host_ssat(((int32_t)(int16_t)(op1 >> 16) - (int32_t)(int16_t)(op2 >> 16)), 16U);
+
+  return ( ((uint32_t)lo & 0x0000FFFFUL) | ((uint32_t)hi << 16) );
+}
+
+static inline uint64_t __SMLALD(uint32_t op1, uint32_t op2, uint64_t acc)
+{
+  int64_t prod = (int64_t)((int32_t)(int16_t)op1 * (int32_t)(int16_t)op2)
+                   + (int64_t)((int32_t)(int16_t)(op1 >> 16) * (int32_t)(int16_t)(op2 >> 16));
+
+  return (acc + (uint64_t)prod);
+}
+
+#endif                  // HOSTSHIM_DEF_H
@@ -224,6 +224,14 @@
 //                      - Corrected bug in Init_InterruptStruct() for I2C3 interupt positions
 //  142      240119 DAH - Revised AFE_Init() to support 50Hz and 60Hz phase cal constants when initializing
 //                        the sync offset registers
+//  163      240215 DAH - Revised Init_DMAController1() to configure DMA1 Stream 4 for SPI2 Tx, and
+//                        Init_InterruptStruct() to enable the DMA1 Stream 4 and SPI2 interrupts for the SPI2
+//                        FRAM transaction engine (ENABLE_SPI2_DMA defined)
+//  164      240216 DAH - Revised Init_DMAController2() to configure DMA2 Stream 3 for SPI1 Tx, and
+//                        Init_InterruptStruct() to enable the DMA2 Stream 3 interrupt for the Flash waveform
+//                        pipeline (ENABLE_SPI1_DMA defined)
+//  176      240228 DAH - Added Update_Sample_Rate() to retune the AFE decimation rate and the Timer3 ADC
+//                        trigger to 80 samples per cycle (ENABLE_FREQ_TRACK and ENABLE_FREQ_RETUNE defined)
 //------------------------------------------------------------------------------------------------------------
 //
 //------------------------------------------------------------------------------------------------------------
@@ -391,6 +399,9 @@ void Init_UART3(void);
 void Init_UART6(uint8_t rx_int_enabled);
 void Init_InterruptStruct(void);
 void AFE_Init(void);
+#if defined(ENABLE_FREQ_TRACK) && defined(ENABLE_FREQ_RETUNE)
+  void Update_Sample_Rate(void);
+#endif
 void Init_DMAController1(void);
 void Init_DMAController2(void);
 void Init_CAM1_DMA_Streams(void);
@@ -4135,6 +4146,13 @@ void Init_InterruptStruct(void)
   NVIC->IP[11] = 0x90;                      // DMA1  Group = 2, Subgroup = 1
   NVIC->IP[23] = 0x40;                      // PD8, PH9  Group = 1, Subgroup = 0
   NVIC->IP[30] = 0xF0;                      // TIM4  Group = 3, Subgroup = 3
+#ifdef ENABLE_SPI2_DMA
+  NVIC->IP[15] = 0xB0;                      // DMA1 Stream 4 (SPI2 Tx)  Group = 2, Subgroup = 3
+  NVIC->IP[36] = 0xB0;                      // SPI2  Group = 2, Subgroup = 3
+#endif
+#ifdef ENABLE_SPI1_DMA
+  NVIC->IP[59] = 0xB0;                      // DMA2 Stream 3 (SPI1 Tx)  Group = 2, Subgroup = 3
+#endif
 
 
   // Set up the peripheral interrupts...
@@ -4148,6 +4166,13 @@ void Init_InterruptStruct(void)
                                             //   DMA2 Stream 0 (position 56 = b24)
   NVIC->ISER[2] = 0x00000380;               // UART 6 (POS 71 =b7), I2C3 Rx/Tx, Error (pos 72, 73 = b8, 9)
                                             //   
+#ifdef ENABLE_SPI2_DMA
+  NVIC->ISER[0] = 0x00008000;               // DMA1 Stream 4 (pos 15 = b15)
+  NVIC->ISER[1] = 0x00000010;               // SPI2 (pos 36 = b4)
+#endif
+#ifdef ENABLE_SPI1_DMA
+  NVIC->ISER[1] = 0x08000000;               // DMA2 Stream 3 (pos 59 = b27)
+#endif
 
 }
 
@@ -4513,6 +4538,71 @@ void Update_AFE_Sync_Regs(void)
 //             END OF FUNCTION        Update_AFE_Sync_Regs()
 //------------------------------------------------------------------------------------------------------------
 
+
+
+#if defined(ENABLE_FREQ_TRACK) && defined(ENABLE_FREQ_RETUNE)
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Update_Sample_Rate()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Update the AFE and ADC Sample Rate
+// 
+//  MECHANICS:          This subroutine loads the sample rate that was computed by Calc_FreqTrack():
+//                        - The AFE decimation registers (SRC_N and SRC_IF) are written with
+//                          FreqTrack.TuneDecN and FreqTrack.TuneDecIF, and the new rate is loaded by setting
+//                          and clearing the SRC_LOAD_UPDATE bit, the same as in AFE_Init()
+//                        - The Timer3 autoreload value is set to FreqTrack.TuneARR.  The auto-reload preload
+//                          is enabled first, so that the new value takes effect at the next update event.
+//                          Otherwise, if the new value were below the present count, the counter would run
+//                          on to 0xFFFF and one ADC trigger would be lost
+//                      The new rate is saved in FreqTrack.SampleRate and FreqTrack.SamplePer.  The tracker
+//                      measures the periods in seconds, so the period that spans the change is still used.
+//                          
+//  CAVEATS:            This must only be called from the sampling interrupt, DMA1_Stream0_IRQHandler(), after
+//                      the AFE samples have been read, so that the register writes do not collide with the
+//                      DMA reads of the samples.  As in Update_AFE_Sync_Regs(), the registers are written
+//                      while the AFE is in SPI slave mode.
+//                      The AFE and ADC samples may be shifted by a small fraction of a sample relative to
+//                      each other until the AFE decimation filter settles.
+// 
+//  INPUTS:             FreqTrack.TuneDecN, FreqTrack.TuneDecIF, FreqTrack.TuneARR, FreqTrack.TuneRate
+// 
+//  OUTPUTS:            FreqTrack.SampleRate, FreqTrack.SamplePer, FreqTrack.TuneReq
+//
+//  ALTERS:             TIM3->CR1, TIM3->ARR
+// 
+//  CALLS:              AFE_SPI_Xfer()
+// 
+//------------------------------------------------------------------------------------------------------------
+
+void Update_Sample_Rate(void)
+{
+  volatile uint16_t temp;
+
+  // Decimation rate N = 4.000MHz/(8 x sample rate).  See AFE_Init()
+  temp = AFE_SPI_Xfer(0x6000 + ((FreqTrack.TuneDecN >> 8) & 0x000F));     // N b11..8
+  temp = AFE_SPI_Xfer(0x6100 + (FreqTrack.TuneDecN & 0x00FF));            // N b7..0
+  temp = AFE_SPI_Xfer(0x6200 + (FreqTrack.TuneDecIF >> 8));               // Fraction high byte
+  temp = AFE_SPI_Xfer(0x6300 + (FreqTrack.TuneDecIF & 0x00FF));           // Fraction low byte
+  temp = AFE_SPI_Xfer(0x6401);                                            // Load the new decimation rate
+  temp = AFE_SPI_Xfer(0x6400);
+
+  // ADC trigger period = (ARR + 1)/60MHz
+  TIM3->CR1 |= TIM_CR1_ARPE;                      // b7 = 1: Auto-reload register is buffered
+  TIM3->ARR = FreqTrack.TuneARR;
+
+  FreqTrack.SampleRate = FreqTrack.TuneRate;
+  FreqTrack.SamplePer = 1.0f / FreqTrack.TuneRate;
+  FreqTrack.TuneReq = FALSE;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION        Update_Sample_Rate()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_FREQ_TRACK and ENABLE_FREQ_RETUNE
+
 //------------------------------------------------------------------------------------------------------------
 //             START OF FUNCTION        Init_DMAController1()
 //------------------------------------------------------------------------------------------------------------
@@ -4595,6 +4685,14 @@ void Update_AFE_Sync_Regs(void)
 //                              High priority
 //                              Peripheral Address - UART3 DR register, fixed address (not incrementing)
 //                              Memory Address - &DPComm61850.TxBuf[0], auto-incrementing
+//                          SPI2 Tx (only if ENABLE_SPI2_DMA is defined)
+//                              Stream 4
+//                              Channel 0
+//                              Memory-to-peripheral, DMA is the flow controller
+//                              Direct mode (FIFO not used)
+//                              Medium priority
+//                              Peripheral Address - SPI2 DR register, fixed address (not incrementing)
+//                              Memory Address - set by SPI2_StartData() for each write data segment
 //                          
 //  CAVEATS:            This subroutine assumes there are no active DMA streams.  That is, it assumes it is
 //                      called only after a reset!
@@ -4603,7 +4701,7 @@ void Update_AFE_Sync_Regs(void)
 // 
 //  OUTPUTS:            None
 //
-//  ALTERS:             DMA1_Stream0, 1, 3, 5, 6, and 7 configuration registers
+//  ALTERS:             DMA1_Stream0, 1, 3, 4, 5, 6, and 7 configuration registers
 // 
 //  CALLS:              None
 // 
@@ -4712,6 +4810,50 @@ void Init_DMAController1(void)
 
 
 
+#ifdef ENABLE_SPI2_DMA
+  //---------------- FRAM SPI2 Tx Stream 4 ----------------
+
+  // b31..28:     Reserved must be kept at reset value
+  // b27..25 = 0: Channel 0 selected
+  // b24..23 = 0: Single transfer (direct mode) for memory
+  // b22..21 = 0: Single transfer (direct mode) for peripheral
+  // b20:         Reserved must be kept at reset value
+  // b19 = 0:     Current target memory = 0 (not used as not using double buffer mode)
+  // b18 = 0:     Double buffer mode is disabled
+  // b17..16 = 1: Priority is Medium
+  // b15 = 0:     Peripheral increment offset size is linked to PSIZE (not used because peripheral address
+  //              will not be incremented)
+  // b14..13 = 1: Memory data size is half-word (set to byte by SPI2_StartData() for 8-bit transfers)
+  // b12..11 = 1: Peripheral data size is half-word (set to byte for 8-bit transfers)
+  // b10 = 1:     Memory address is incremented after each transfer according to MSIZE
+  // b9 = 0:      Peripheral address is fixed
+  // b8 = 0:      Circular mode is disabled
+  // b7..6 = 1:   Direction is memory to peripheral
+  // b5 = 0:      The DMA is the flow controller
+  // b4 = 1:      Transfer complete interrupt is enabled
+  // b3 = 0:      Half-transfer complete interrupt is disabled
+  // b2 = 0:      Transfer error interrupt is disabled
+  // b1 = 0:      Direct mode error interrupt is disabled
+  // b0 = 0:      DMA stream is disabled
+  DMA1_Stream4->CR &= 0xF0000000;          // Make sure DMA channel is disabled before configuring it
+  DMA1_Stream4->CR |= SPI2_DMA_CR16;
+
+  // b31..8:      Reserved must be kept at reset value
+  // b7 = 0:      FIFO error interrupt is disabled
+  // b6:          Reserved must be kept at reset value
+  // b5..3:       FIFO status (read-only)
+  // b2 = 0:      Direct mode is enabled
+  // b1..0 = 0:   FIFO threshold level is 1/4 full (FIFO is not used)
+  DMA1_Stream4->FCR &= 0xFFFFFF40;
+
+  // b31..0:      Peripheral address is initialized to SPI2 data register
+  DMA1_Stream4->PAR = (uint32_t)(&(SPI2->DR));
+
+  //-------------- END FRAM SPI2 Tx Stream 4 --------------
+#endif
+
+
+
 
 
 
@@ -5034,6 +5176,18 @@ void Init_DMAController1(void)
 //                              Peripheral Address - UART1 DR register, fixed address (not incrementing)
 //                              Memory Address - &CAM2.TxBuf[0], auto-incrementing
 //
+//                                      Serial Flash via SPI1 - Stream 3
+//                          The DMA is used to send the page data when a waveform capture is written to
+//                          Flash (only if ENABLE_SPI1_DMA is defined).  See Flash_PipeStart() in Iod.c.
+//                          SPI1 Tx:
+//                              Stream 3
+//                              Channel 3
+//                              Memory-to-peripheral, DMA is the flow controller
+//                              Direct mode (FIFO not used)
+//                              Medium priority
+//                              Peripheral Address - SPI1 DR register, fixed address (not incrementing)
+//                              Memory Address - set by Flash_PipeStart() for each page
+//
 //  CAVEATS:            This subroutine assumes there are no active DMA streams.  That is, it assumes it is
 //                      called only after a reset!
 //
@@ -5121,6 +5275,50 @@ void Init_DMAController2(void)
 
   //----- END CAM2 UART6 Rx Stream 1, Tx Stream 6 ----
 
+
+
+#ifdef ENABLE_SPI1_DMA
+  //---------------- Flash SPI1 Tx Stream 3 ----------------
+
+  // b31..28:     Reserved must be kept at reset value
+  // b27..25 = 3: Channel 3 selected
+  // b24..23 = 0: Single transfer (direct mode) for memory
+  // b22..21 = 0: Single transfer (direct mode) for peripheral
+  // b20:         Reserved must be kept at reset value
+  // b19 = 0:     Current target memory = 0 (not used as not using double buffer mode)
+  // b18 = 0:     Double buffer mode is disabled
+  // b17..16 = 1: Priority is Medium
+  // b15 = 0:     Peripheral increment offset size is linked to PSIZE (not used because peripheral address
+  //              will not be incremented)
+  // b14..13 = 1: Memory data size is half-word
+  // b12..11 = 1: Peripheral data size is half-word
+  // b10 = 1:     Memory address is incremented after each transfer according to MSIZE
+  // b9 = 0:      Peripheral address is fixed
+  // b8 = 0:      Circular mode is disabled
+  // b7..6 = 1:   Direction is memory to peripheral
+  // b5 = 0:      The DMA is the flow controller
+  // b4 = 1:      Transfer complete interrupt is enabled
+  // b3 = 0:      Half-transfer complete interrupt is disabled
+  // b2 = 0:      Transfer error interrupt is disabled
+  // b1 = 0:      Direct mode error interrupt is disabled
+  // b0 = 0:      DMA stream is disabled
+  DMA2_Stream3->CR &= 0xF0000000;          // Make sure DMA channel is disabled before configuring it
+  DMA2_Stream3->CR |= SPI1_DMA_CR;
+
+  // b31..8:      Reserved must be kept at reset value
+  // b7 = 0:      FIFO error interrupt is disabled
+  // b6:          Reserved must be kept at reset value
+  // b5..3:       FIFO status (read-only)
+  // b2 = 0:      Direct mode is enabled
+  // b1..0 = 0:   FIFO threshold level is 1/4 full (FIFO is not used)
+  DMA2_Stream3->FCR &= 0xFFFFFF40;
+
+  // b31..0:      Peripheral address is initialized to SPI1 data register
+  DMA2_Stream3->PAR = (uint32_t)(&(SPI1->DR));
+
+  //-------------- END Flash SPI1 Tx Stream 3 --------------
+#endif
+
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -63,6 +63,7 @@
 //                          - Input parameter added to Init_UART6() to determine whether Rx interrupts are
 //                            enabled
 //   0.59   220831  DAH - Init_SPI1() declaration modified (config added)
+//   176    240228  DAH - Added Update_Sample_Rate() (ENABLE_FREQ_TRACK and ENABLE_FREQ_RETUNE defined)
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -111,6 +112,9 @@ extern void Init_UART6(uint8_t rx_int_enabled);
 extern void Init_InterruptStruct(void);
 extern void AFE_Init(void);
 extern void Update_AFE_Sync_Regs(void);
+#if defined(ENABLE_FREQ_TRACK) && defined(ENABLE_FREQ_RETUNE)
+  extern void Update_Sample_Rate(void);
+#endif
 extern void Init_DMAController1(void);
 extern void Init_DMAController2(void);
 extern void Init_CAM1_DMA_Streams(void);
@@ -471,6 +471,38 @@
 //   149    240131  DAH - Renamed NUM_RTD_BUFFERS to NUM_RTD_TIMESLICES
 //   150    240202  DAH - In DMA1_Stream0_IRQHandler(), recommented out code that clears GF trip and alarm
 //                        flags when GF protection is disabled (was put back in for testing)
+//   153    240205  DAH - Replaced the IAR location operator (@".sram1", @".sram2") with SRAM1_LOC and
+//                        SRAM2_LOC so the module can be compiled in the host build
+//   155    240207  DAH - Added stage profiler timing points (PROF_START() and PROF_STOP()) to
+//                        DMA1_Stream0_IRQHandler().  These compile to nothing unless ENABLE_STAGE_PROFILER is
+//                        defined
+//                          - Added includes of Profile_def.h and Profile_ext.h
+//   157    240209  DAH - Added support for storing SampleBuf by channel (ENABLE_SAMPLE_SOA defined)
+//                          - Added SampleBuf_Span() and SampleBuf_GetRecord()
+//                          - Added CAMSampleRec[].  In DMA1_Stream0_IRQHandler(), the sampled-value CAM DMA
+//                            transmits from CAMSampleRec[] instead of SampleBuf[]
+//   158    240210  DAH - Added optional integer one-cycle voltage sums of squares (ENABLE_SIMD_SOS defined)
+//                          - Added Volt_SOS_Block(), VolAFEOneCycSOS_SumI, VolADCOneCycSOS_SumI, and
+//                            VolSOS_BlkInd
+//                          - In DMA1_Stream0_IRQHandler(), update_Volt_SOS_Block() is called every half
+//                            cycle in place of update_VlnADC_SOS() and update_VllADC_SOS()
+//                          - AFEISR_VarInit() revised to initialize the new variables
+//   163    240215  DAH - Added DMA1_Stream4_IRQHandler() and SPI2_IRQHandler() to run the SPI2 FRAM
+//                        transaction engine (ENABLE_SPI2_DMA defined)
+//   164    240216  DAH - Added DMA2_Stream3_IRQHandler() to finish the Flash page writes of the SPI1 Flash
+//                        waveform pipeline (ENABLE_SPI1_DMA defined)
+//   175    240227  DAH - Added CurVolOneCycSin_Sum[] and CurVolOneCycCos_Sum[], the one-cycle fundamental
+//                        sine and cosine sums for the sequence components (ENABLE_SEQ_PHASOR defined)
+//                          - AFEISR_VarInit() revised to initialize the new variables
+//   176    240228  DAH - DMA1_Stream0_IRQHandler() revised to update the zero-crossing frequency tracker each
+//                        sample (ENABLE_FREQ_TRACK defined), and to load a new sample rate when one is
+//                        requested (ENABLE_FREQ_RETUNE defined)
+//   177    240229  DAH - DMA1_Stream0_IRQHandler() revised to send the samples to the sampled-value CAMs in
+//                        frames with publish_CAM_SV(), instead of one DMA transfer per sample, if
+//                        ENABLE_CAM_SV_FRAME is defined
+//                          - Added includes of Crc_def.h and Crc_ext.h
+//   179    240302  DAH - DMA1_Stream0_IRQHandler() comments revised to explain why the ADC 200msec voltage
+//                        sums cover the same samples if ENABLE_SIMD_SOS is defined
 //                          
 //------------------------------------------------------------------------------------------------------------
 //
@@ -512,6 +544,8 @@
 #include "Modbus_def.h"
 #include "Prot_def.h"
 #include "Ovrcom_def.h"
+#include "Profile_def.h"
+#include "Crc_def.h"
 
 //
 //      Local Definitions used in this module...
@@ -535,11 +569,21 @@
 #include "Modbus_ext.h"
 #include "Setpnt_ext.h"
 #include "Ovrcom_ext.h"
+#include "Profile_ext.h"
+#include "Crc_ext.h"
 
 //      Global (Visible) Function Prototypes (These functions are called by other modules)
 //
 void Intr_VarInit(void);
 void ResetMinMaxValues(void);
+#ifdef ENABLE_SAMPLE_SOA
+  uint8_t SampleBuf_Span(uint8_t chan, uint16_t start, uint16_t len, struct SAMPLE_SPAN *sptr);
+  void SampleBuf_GetRecord(uint16_t ndx, struct RAM_SAMPLES *rptr);
+#endif
+#ifdef ENABLE_SIMD_SOS
+  void Volt_SOS_Block(const int16_t *va, const int16_t *vb, const int16_t *vc, uint16_t stride, uint16_t len,
+                      struct VOLTAGES_I *sptr);
+#endif
 void SysTick_Handler(void);                  // Only used in startup_stm32f407xx.s
 void UART5_IRQHandler(void);                 // Only used in startup_stm32f407xx.s
 void EXTI9_5_IRQHandler(void);               // Only used in startup_stm32f407xx.s
@@ -551,6 +595,13 @@ void I2C3_ER_IRQHandler(void);               // Only used in startup_stm32f407xx
 void TIM4_IRQHandler(void);                  // Only used in startup_stm32f407xx.s
 void TIM1_UP_TIM10_IRQHandler(void);         // Only used in startup_stm32f407xx.s
 void USART6_IRQHandler(void);                // Only used in startup_stm32f407xx.s
+#ifdef ENABLE_SPI2_DMA
+  void DMA1_Stream4_IRQHandler(void);        // Only used in startup_stm32f407xx.s
+  void SPI2_IRQHandler(void);                // Only used in startup_stm32f407xx.s
+#endif
+#ifdef ENABLE_SPI1_DMA
+  void DMA2_Stream3_IRQHandler(void);        // Only used in startup_stm32f407xx.s
+#endif
 
 
 
@@ -660,11 +711,11 @@ const float SIN_COEFF[80] =
 //
 //       These variables are used by other modules...
 //
-struct CUR_WITH_G_F CurHalfCycSOS_SumF @".sram2";   // Variables located in .sram2 are only used in
-struct CUR_WITH_G_F    CurOneCycSOS_SumF @".sram2";
-float CurHalfCycSOSmax @".sram2";                   //   subroutines that are called from                  
-float CurOneCycSOSmax @".sram2";                    //   DMA1_Stream0_IRQHandler().  There is no conflict   
-float NewSample @".sram2";                          //   with the associated DMA stream, since the stream
+struct CUR_WITH_G_F CurHalfCycSOS_SumF SRAM2_LOC;   // Variables located in .sram2 are only used in
+struct CUR_WITH_G_F    CurOneCycSOS_SumF SRAM2_LOC;
+float CurHalfCycSOSmax SRAM2_LOC;                   //   subroutines that are called from                  
+float CurOneCycSOSmax SRAM2_LOC;                    //   DMA1_Stream0_IRQHandler().  There is no conflict   
+float NewSample SRAM2_LOC;                          //   with the associated DMA stream, since the stream
                                                     //   will not be active at this time
 uint8_t msec200Anniv, OneCycAnniv, OneSecAnniv, min5Anniv;
 
@@ -688,8 +739,17 @@ float TestSamples[4][400];              // *** DAH Added for test
                                         // TestSamples[3][xxx] - scaled AFE samples after digital filter
                                         // All waveforms are Phase A current (channel 0)
 
-struct RAM_SAMPLES SampleBuf[TOTAL_SAMPLE_SETS] @ ".sram1";
-uint16_t SampleIndex @".sram2";
+#ifdef ENABLE_SAMPLE_SOA
+  struct RAM_SAMPLES_SOA SampleBuf SRAM1_LOC;
+  struct RAM_SAMPLES CAMSampleRec[2] SRAM2_LOC;   // Sample sets for the sampled-value CAM DMA.  The DMA cannot
+                                                  //   read SampleBuf as a sample set when it is stored by
+                                                  //   channel, so buffer_samples() also stores the samples
+                                                  //   here.  Two are used (alternating with SampleIndex) so
+                                                  //   that a set is never overwritten while it is being sent
+#else
+  struct RAM_SAMPLES SampleBuf[TOTAL_SAMPLE_SETS] SRAM1_LOC;
+#endif
+uint16_t SampleIndex SRAM2_LOC;
 
 uint16_t coil_temp_samples[200];
 //uint16_t coil_temp_samples[600];      // *** DAH  FOR LEO 190605
@@ -717,46 +777,55 @@ uint8_t SampleBufFilled;
 //
 //       These variables are used only in this module...
 //
-unsigned long long HalfCycSamplesSq[6][40] @".sram2";
-unsigned long long OneCycSamplesSq[6][80] @".sram2";
-struct CUR_WITH_G_I    CurHalfCycSOS_SumI @".sram2";
-struct CUR_WITH_G_F    CurOneCycSOS_SumF @".sram2";
-struct CUR_WITH_G_I    CurOneCycSOS_SumI @".sram2";
-struct CUR_WITH_G_F    Cur200msFltrSOS_Sum @".sram2";
-struct CUR_WITHOUT_G_F Cur200msNoFltrSOS_Sum @".sram2";
-struct CUR_WITHOUT_G_F Cur200msNoFltrSinSOS_Sum @".sram2";
-struct CUR_WITHOUT_G_F Cur200msNoFltrCosSOS_Sum @".sram2";
+unsigned long long HalfCycSamplesSq[6][40] SRAM2_LOC;
+unsigned long long OneCycSamplesSq[6][80] SRAM2_LOC;
+struct CUR_WITH_G_I    CurHalfCycSOS_SumI SRAM2_LOC;
+struct CUR_WITH_G_F    CurOneCycSOS_SumF SRAM2_LOC;
+struct CUR_WITH_G_I    CurOneCycSOS_SumI SRAM2_LOC;
+struct CUR_WITH_G_F    Cur200msFltrSOS_Sum SRAM2_LOC;
+struct CUR_WITHOUT_G_F Cur200msNoFltrSOS_Sum SRAM2_LOC;
+struct CUR_WITHOUT_G_F Cur200msNoFltrSinSOS_Sum SRAM2_LOC;
+struct CUR_WITHOUT_G_F Cur200msNoFltrCosSOS_Sum SRAM2_LOC;
 struct CUR_WITHOUT_G_F CurOneCycPeak;
-struct VOLTAGES        VolADCOneCycSOS_Sum @".sram2";
-struct VOLTAGES        VolAFEOneCycSOS_Sum @".sram2";
-struct VOLTAGES        VolADC200msSOS_Sum @".sram2";
-struct VOLTAGES        VolAFE200msFltrSOS_Sum @".sram2";
-struct VOLTAGES        VolAFE200msNoFltrSOS_Sum @".sram2";
-struct VOLTAGES_LN     VolAFE200msNoFltrSinSOS_Sum @".sram2";
-struct VOLTAGES_LN     VolAFE200msNoFltrCosSOS_Sum @".sram2";
-struct POWERS          PwrOneCycSOS_Sum @".sram2";
-struct POWERS          Pwr200msecSOS_Sum @".sram2";
+struct VOLTAGES        VolADCOneCycSOS_Sum SRAM2_LOC;
+struct VOLTAGES        VolAFEOneCycSOS_Sum SRAM2_LOC;
+struct VOLTAGES        VolADC200msSOS_Sum SRAM2_LOC;
+struct VOLTAGES        VolAFE200msFltrSOS_Sum SRAM2_LOC;
+struct VOLTAGES        VolAFE200msNoFltrSOS_Sum SRAM2_LOC;
+#ifdef ENABLE_SIMD_SOS
+  struct VOLTAGES_I    VolADCOneCycSOS_SumI SRAM2_LOC;
+  struct VOLTAGES_I    VolAFEOneCycSOS_SumI SRAM2_LOC;
+  uint8_t VolSOS_BlkInd SRAM2_LOC;
+#endif
+struct VOLTAGES_LN     VolAFE200msNoFltrSinSOS_Sum SRAM2_LOC;
+struct VOLTAGES_LN     VolAFE200msNoFltrCosSOS_Sum SRAM2_LOC;
+#ifdef ENABLE_SEQ_PHASOR
+  float CurVolOneCycSin_Sum[ONECYC_PHASOR_NUM] SRAM2_LOC;
+  float CurVolOneCycCos_Sum[ONECYC_PHASOR_NUM] SRAM2_LOC;
+#endif
+struct POWERS          PwrOneCycSOS_Sum SRAM2_LOC;
+struct POWERS          Pwr200msecSOS_Sum SRAM2_LOC;
 
 struct DELAY_VOLTS_OC
 {
     float Van[20];
     float Vbn[20];
     float Vcn[20];
-} DelayedVolts_OC @".sram2";
+} DelayedVolts_OC SRAM2_LOC;
 
 struct DELAY_VOLTS_200msec
 {
     float Van[20];
     float Vbn[20];
     float Vcn[20];
-} DelayedVolts_200msec @".sram2";
+} DelayedVolts_200msec SRAM2_LOC;
 
-uint16_t msec200Ctr @".sram2";
-uint16_t OneSecCtr  @".sram2";
-uint8_t HalfCycInd @".sram2";
-uint8_t OneCycInd @".sram2";
-uint8_t AFE_SampleState @".sram2";                    
-uint8_t DelayedVoltsNdx @".sram2";
+uint16_t msec200Ctr SRAM2_LOC;
+uint16_t OneSecCtr  SRAM2_LOC;
+uint8_t HalfCycInd SRAM2_LOC;
+uint8_t OneCycInd SRAM2_LOC;
+uint8_t AFE_SampleState SRAM2_LOC;                    
+uint8_t DelayedVoltsNdx SRAM2_LOC;
 
 unsigned long long ulltemp[6];       // This has to be defined globally in order to use inline functions
 float Igres, Igres_mtr;              // These have to be defined globally in order to use inline functions
@@ -910,7 +979,9 @@ void Intr_VarInit(void)
 //                      PwrOneCycSOS_Sum.Px, PwrOneCycSOS_Sum.RPx, Pwr200msecSOS_Sum.Px,
 //                      Pwr200msecSOS_Sum.RPx, DelayedVolts_OC.Vx[], DelayedVolts_200msec.Vx[],
 //                      DelayedVoltsNdx, Cur200msNoFltrSOS_Sum.Ix, VolAFE200msNoFltrSOS_Sum.Vxx,
-//                      VolAFE200msNoFltrSinSOS_Sum.Vxx, VolAFE200msNoFltrCosSOS_Sum.Vxx
+//                      VolAFE200msNoFltrSinSOS_Sum.Vxx, VolAFE200msNoFltrCosSOS_Sum.Vxx,
+//                      VolAFEOneCycSOS_SumI.Vxx, VolADCOneCycSOS_SumI.Vxx, VolSOS_BlkInd (ENABLE_SIMD_SOS
+//                      defined), CurVolOneCycSin_Sum[], CurVolOneCycCos_Sum[] (ENABLE_SEQ_PHASOR defined)
 //
 //  ALTERS:             None
 //
@@ -1004,6 +1075,28 @@ void AFEISR_VarInit(void)
   VolADC200msSOS_Sum.Vab = 0;
   VolADC200msSOS_Sum.Vbc = 0;
   VolADC200msSOS_Sum.Vca = 0;
+#ifdef ENABLE_SIMD_SOS
+  VolAFEOneCycSOS_SumI.Van = 0;
+  VolAFEOneCycSOS_SumI.Vbn = 0;
+  VolAFEOneCycSOS_SumI.Vcn = 0;
+  VolAFEOneCycSOS_SumI.Vab = 0;
+  VolAFEOneCycSOS_SumI.Vbc = 0;
+  VolAFEOneCycSOS_SumI.Vca = 0;
+  VolADCOneCycSOS_SumI.Van = 0;
+  VolADCOneCycSOS_SumI.Vbn = 0;
+  VolADCOneCycSOS_SumI.Vcn = 0;
+  VolADCOneCycSOS_SumI.Vab = 0;
+  VolADCOneCycSOS_SumI.Vbc = 0;
+  VolADCOneCycSOS_SumI.Vca = 0;
+  VolSOS_BlkInd = 0;
+#endif
+#ifdef ENABLE_SEQ_PHASOR
+  for (i=0; i<ONECYC_PHASOR_NUM; ++i)
+  {
+    CurVolOneCycSin_Sum[i] = 0;
+    CurVolOneCycCos_Sum[i] = 0;
+  }
+#endif
   PwrOneCycSOS_Sum.Pa = 0;
   PwrOneCycSOS_Sum.Pb = 0;
   PwrOneCycSOS_Sum.Pc = 0;
@@ -1191,6 +1284,242 @@ void ResetMinMaxValues(void)
 
 
 
+#ifdef ENABLE_SAMPLE_SOA
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        SampleBuf_Span()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Get a Window of Samples From SampleBuf
+//
+//  MECHANICS:          This subroutine returns the location of a window of samples of one channel in
+//                      SampleBuf.  Since the samples of each channel are contiguous, the window is one block
+//                      of samples, or two blocks if it wraps around the end of the buffer.  The blocks are
+//                      returned in *sptr (see struct SAMPLE_SPAN), and may be passed directly to the CMSIS
+//                      block functions.
+//                      The block pointers are void pointers.  The current channels are floats and the
+//                      voltage channels are int16's (volts x 10).
+//
+//  CAVEATS:            Only used if ENABLE_SAMPLE_SOA is defined.
+//                      The samples are not copied, so the window must not be so close to SampleIndex that it
+//                      is overwritten while it is being used.  For example, a 12-cycle window that ends at
+//                      SampleIndex may be used for up to 27 cycles (TOTAL_SAMPLE_SETS is 39 cycles).
+//
+//  INPUTS:             chan - the channel (SB_IA .. SB_VCNADC)
+//                      start - the index in SampleBuf of the first sample of the window
+//                      len - the number of samples in the window (TOTAL_SAMPLE_SETS max)
+//
+//  OUTPUTS:            *sptr - the blocks of samples
+//                      The subroutine returns the number of blocks (1 or 2), or 0 if an input is invalid
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t SampleBuf_Span(uint8_t chan, uint16_t start, uint16_t len, struct SAMPLE_SPAN *sptr)
+{
+  // Start of each channel's array, in the channel number order
+  static void * const SB_CHAN_START[SB_NUM_CHANNELS] =
+  {
+    &SampleBuf.Ia[0], &SampleBuf.Ib[0], &SampleBuf.Ic[0], &SampleBuf.In[0], &SampleBuf.Igsrc[0],
+    &SampleBuf.Igres[0], &SampleBuf.VanAFE[0], &SampleBuf.VbnAFE[0], &SampleBuf.VcnAFE[0],
+    &SampleBuf.VanADC[0], &SampleBuf.VbnADC[0], &SampleBuf.VcnADC[0]
+  };
+  uint8_t *bptr;
+  uint8_t size;
+
+  if ( (chan >= SB_NUM_CHANNELS) || (start >= TOTAL_SAMPLE_SETS) || (len > TOTAL_SAMPLE_SETS) )
+  {
+    return (0);
+  }
+
+  bptr = (uint8_t *)SB_CHAN_START[chan];
+  size = ( (chan < SB_VANAFE) ? sizeof(float) : sizeof(int16_t) );
+
+  sptr->Ptr[0] = bptr + (start * size);
+  if ((start + len) > TOTAL_SAMPLE_SETS)        // If the window wraps around the end of the buffer, the
+  {                                             //   second block begins at the start of the buffer
+    sptr->Len[0] = TOTAL_SAMPLE_SETS - start;
+    sptr->Ptr[1] = bptr;
+    sptr->Len[1] = len - sptr->Len[0];
+    return (2);
+  }
+  else
+  {
+    sptr->Len[0] = len;
+    sptr->Ptr[1] = 0;
+    sptr->Len[1] = 0;
+    return (1);
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          SampleBuf_Span()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        SampleBuf_GetRecord()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Get a Sample Set From SampleBuf
+//
+//  MECHANICS:          This subroutine copies the samples at index ndx of each channel of SampleBuf into a
+//                      sample set structure.  It is used where the samples must be in the sample set
+//                      (struct RAM_SAMPLES) format, such as the waveform captures that are written to Flash.
+//
+//  CAVEATS:            Only used if ENABLE_SAMPLE_SOA is defined
+//
+//  INPUTS:             ndx - the index in SampleBuf (0 .. TOTAL_SAMPLE_SETS-1)
+//
+//  OUTPUTS:            *rptr - the sample set
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void SampleBuf_GetRecord(uint16_t ndx, struct RAM_SAMPLES *rptr)
+{
+  rptr->Ia = SampleBuf.Ia[ndx];
+  rptr->Ib = SampleBuf.Ib[ndx];
+  rptr->Ic = SampleBuf.Ic[ndx];
+  rptr->In = SampleBuf.In[ndx];
+  rptr->Igsrc = SampleBuf.Igsrc[ndx];
+  rptr->Igres = SampleBuf.Igres[ndx];
+  rptr->VanAFE = SampleBuf.VanAFE[ndx];
+  rptr->VbnAFE = SampleBuf.VbnAFE[ndx];
+  rptr->VcnAFE = SampleBuf.VcnAFE[ndx];
+  rptr->VanADC = SampleBuf.VanADC[ndx];
+  rptr->VbnADC = SampleBuf.VbnADC[ndx];
+  rptr->VcnADC = SampleBuf.VcnADC[ndx];
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          SampleBuf_GetRecord()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_SAMPLE_SOA
+
+
+
+#ifdef ENABLE_SIMD_SOS
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Volt_SOS_Block()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Add a Block of Voltage Samples to the Sums of Squares
+//
+//  MECHANICS:          This subroutine adds the squares of a block of three-phase voltage samples to the
+//                      line-to-neutral and line-to-line sums of squares in *sptr.  The samples are the int16
+//                      voltages in SampleBuf (volts x 10), so the sums are in tenths squared, the same as the
+//                      integer one-cycle current sums (CurOneCycSOS_SumI).
+//                      The subroutine uses the Cortex-M4 DSP (SIMD) instructions.  Two consecutive samples
+//                      of a phase are packed into one word (PKHBT).  The line-to-line pair is computed from
+//                      the two line-to-neutral pairs with a saturating dual subtract (QSUB16), and each pair
+//                      is squared and added to the 64-bit sum in a single dual multiply-accumulate
+//                      (SMLALD).  This is one multiply-accumulate instruction for every two samples, and the
+//                      sums are kept in registers until the end of the block, instead of a floating point
+//                      multiply, load, add, and store for every sample.
+//                      If len is odd, the last sample is packed with 0 in the upper half-word, which adds
+//                      nothing to the sums.
+//                      Since the arithmetic is all integer, the results do not depend on the order of the
+//                      samples, and the sums are exact.  The line-to-line voltages saturate at +/-3276.7V.
+//                      The peak line-to-line voltage of a 690V system with a 120% overvoltage is 1171V, so
+//                      saturation does not occur in normal operation.
+//
+//  CAVEATS:            Only used if ENABLE_SIMD_SOS is defined.
+//                      In the host build, the SIMD instructions are replaced with the portable C functions
+//                      in HostShim_def.h.  The results are the same.
+//
+//  INPUTS:             va, vb, vc - pointers to the first phase A, B, and C samples of the block
+//                      stride - the distance between consecutive samples of a phase, in int16's
+//                               (SAMPLEBUF_I16_STRIDE for SampleBuf)
+//                      len - the number of samples in the block
+//                      *sptr - the present sums of squares
+//
+//  OUTPUTS:            *sptr - the updated sums of squares
+//
+//  ALTERS:             None
+//
+//  CALLS:              __PKHBT(), __QSUB16(), __SMLALD()
+//
+//  EXECUTION TIME:
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Volt_SOS_Block(const int16_t *va, const int16_t *vb, const int16_t *vc, uint16_t stride, uint16_t len,
+                    struct VOLTAGES_I *sptr)
+{
+  uint64_t an, bn, cn, ab, bc, ca;
+  uint32_t pa, pb, pc, pll;
+  uint16_t stride2;
+
+  an = sptr->Van;                       // Keep the sums in registers while the block is processed
+  bn = sptr->Vbn;
+  cn = sptr->Vcn;
+  ab = sptr->Vab;
+  bc = sptr->Vbc;
+  ca = sptr->Vca;
+  stride2 = stride << 1;
+
+  while (len >= 2)
+  {
+    pa = __PKHBT(va[0], va[stride], 16);        // Pack two samples of each phase into one word
+    pb = __PKHBT(vb[0], vb[stride], 16);
+    pc = __PKHBT(vc[0], vc[stride], 16);
+    an = __SMLALD(pa, pa, an);                  // Add the squares of both samples to the sums
+    bn = __SMLALD(pb, pb, bn);
+    cn = __SMLALD(pc, pc, cn);
+    pll = __QSUB16(pa, pb);                     // Vab = Van - Vbn for both samples
+    ab = __SMLALD(pll, pll, ab);
+    pll = __QSUB16(pb, pc);                     // Vbc = Vbn - Vcn
+    bc = __SMLALD(pll, pll, bc);
+    pll = __QSUB16(pc, pa);                     // Vca = Vcn - Van
+    ca = __SMLALD(pll, pll, ca);
+    va += stride2;
+    vb += stride2;
+    vc += stride2;
+    len -= 2;
+  }
+  if (len > 0)                                  // If odd number of samples, add the last one by itself
+  {
+    pa = __PKHBT(va[0], 0, 16);
+    pb = __PKHBT(vb[0], 0, 16);
+    pc = __PKHBT(vc[0], 0, 16);
+    an = __SMLALD(pa, pa, an);
+    bn = __SMLALD(pb, pb, bn);
+    cn = __SMLALD(pc, pc, cn);
+    pll = __QSUB16(pa, pb);
+    ab = __SMLALD(pll, pll, ab);
+    pll = __QSUB16(pb, pc);
+    bc = __SMLALD(pll, pll, bc);
+    pll = __QSUB16(pc, pa);
+    ca = __SMLALD(pll, pll, ca);
+  }
+
+  sptr->Van = an;
+  sptr->Vbn = bn;
+  sptr->Vcn = cn;
+  sptr->Vab = ab;
+  sptr->Vbc = bc;
+  sptr->Vca = ca;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Volt_SOS_Block()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_SIMD_SOS
+
+
+
 
 //------------------------------------------------------------------------------------------------------------
 //             START OF FUNCTION        TestInj_Handler()
@@ -1782,9 +2111,11 @@ void EXTI9_5_IRQHandler(void)
 //  OUTPUTS:            CurHalfCycSOS_SumF.Ix, CurHalfCycSOSmax, CurOneCycSOSmax, NewSample,
 //                      AFE_SampleState, msec200Anniv, OneCycAnniv, CurOneCycPeak.Ix, CurOneCycSOS_Sav.Ix,
 //                      CurVol200msNoFltrSinSOS_Sav[], CurVol200msNoFltrCosSOS_Sav.Ix,
+//                      CurVolOneCycSin_Sav[], CurVolOneCycCos_Sav[] (ENABLE_SEQ_PHASOR defined),
 //                      VolAFEOneCycSOS_Sav.Vxx, PwrOneCycSOS_Sav.Px, PwrOneCycSOS_Sav.RPx,
 //                      Cur200msecSOS_Sav.Ix, VolAFE200msFltrSOS_Sav.Vxx, VolADC200msSOS_Sav.Vxx,
-//                      Pwr200msecSOS_Sav.Px, Pwr200msecSOS_Sav.RPx
+//                      Pwr200msecSOS_Sav.Px, Pwr200msecSOS_Sav.RPx, FreqTrack.PerSum, FreqTrack.PerCnt
+//                      (ENABLE_FREQ_TRACK defined), CAMSvPub (ENABLE_CAM_SV_FRAME defined)
 //
 //  ALTERS:             AFE_CS pin (PG5), DMA1->HIFCR, DMA1->LIFCR
 //                      CurHalfCycSOS_SumI.Ix, AFE_SampleState, HalfCycInd, OneCycInd, msec200Ctr,
@@ -1794,7 +2125,9 @@ void EXTI9_5_IRQHandler(void)
 //                      PwrOneCycSOS_Sum.Px, PwrOneCycSOS_Sum.RPx, Pwr200msecSOS_Sum.Px,
 //                      Pwr200msecSOS_Sum.RPx, HalfCycSamplesSq[][], OneCycSamplesSq[][]
 // 
-//  CALLS:              AFE_Process_Samples(), Instantaneous_Prot(), ShortDelay_Prot()
+//  CALLS:              AFE_Process_Samples(), Instantaneous_Prot(), ShortDelay_Prot(), Prof_Record() (if
+//                      ENABLE_STAGE_PROFILER is defined), Update_Sample_Rate() (if ENABLE_FREQ_RETUNE is
+//                      defined), Crc16_Block() (if ENABLE_CAM_SV_FRAME is defined)
 //
 //  EXECUTION TIME:     Measured execution time on 160718 (Rev 00.15 code).
 //                                37.8usec (with instantaneous and short-delay protection and both CAMs
@@ -1816,6 +2149,9 @@ void DMA1_Stream0_IRQHandler(void)
 
 // TESTPIN_D1_HIGH;                         // *** DAH TEST CODE FOR TIMING
 
+  PROF_START(PROF_ISR_TOTAL);           // Stage profiler (only if ENABLE_STAGE_PROFILER is defined)
+  PROF_START(PROF_ISR_MISC);
+
   /*-------------------------- BP using one-cycle currents  -------
   // Capture the coil temperature sample if it is enabled
   if (TestInj.Flags & TEMP_MEAS_ON)
@@ -1839,6 +2175,7 @@ void DMA1_Stream0_IRQHandler(void)
   {
     Zin_Latched = 1;
   }
+  PROF_STOP(PROF_ISR_MISC);
   
   AFE_CSN_INACTIVE;                     // Deactivate the AFE chip select
 //  TESTPIN_D1_LOW;                         // *** DAH TEST CODE FOR TIMING
@@ -1885,7 +2222,9 @@ void DMA1_Stream0_IRQHandler(void)
       //   the first sample used in metering computations.  This ensures that the samples from all of the
       //   channels are aligned, regardless of whether different (low-gain versus high-gain) seeds were used
       //   by the different channels.
+      PROF_START(PROF_ISR_AFE);
       AFE_Process_Samples();
+      PROF_STOP(PROF_ISR_AFE);
 
       // Compute the unfiltered (Igres) and filtered (Igres_mtr) residual grounds for protection
       Igres = AFE_new_samples[0] + AFE_new_samples[1] + AFE_new_samples[2] + AFE_new_samples[3];
@@ -1894,11 +2233,16 @@ void DMA1_Stream0_IRQHandler(void)
 
       // Store samples in the RAM buffer (SampleBuf[])
       //      SampleBuf[SampleIndex].xxxx <--- AFE_new_samples[x]
+      PROF_START(PROF_ISR_BUFFER);
       // Note, the buffer index (SampleIndex) is not incremented until after the DMA is initiated to
       //   transmit the samples to the CAMs so that the memory address is correct for the DMA operation
       buffer_samples();
 
       // Transmit the sampled values out over the CAM ports, for sampled-value CAMs
+#ifdef ENABLE_CAM_SV_FRAME
+      // The samples are collected into frames, and a frame is sent every CAMSV_SAMPLES samples
+      publish_CAM_SV();
+#else
       if (CAM1.Status & CAM_TYPE_SAMPLE)      // If CAM type is sampled-value, transmit the samples
       {
         if ( !(DMA2->HISR & DMA_HISR_TCIF7)           // If the previous DMA is not complete and this is not
@@ -1908,7 +2252,11 @@ void DMA1_Stream0_IRQHandler(void)
           CAM1.Status |= CAM_ERROR;
           Init_CAM1_DMA_Streams();
         }
+#ifdef ENABLE_SAMPLE_SOA
+        DMA2_Stream7->M0AR = (uint32_t)((uint8_t *)(&CAMSampleRec[SampleIndex & 0x0001].Ia));
+#else
         DMA2_Stream7->M0AR = (uint32_t)((uint8_t *)(&SampleBuf[SampleIndex].Ia));
+#endif
         DMA2->HIFCR |= DMA_HISR_TCIF7;                // Reset the transfer complete interrupt flag
         // Must clear all event flags before initiating a DMA operation
         DMA2->HIFCR |= (DMA_HIFCR_CTCIF7 + DMA_HIFCR_CHTIF7 + DMA_HIFCR_CTEIF7 + DMA_HIFCR_CDMEIF7
@@ -1925,7 +2273,11 @@ void DMA1_Stream0_IRQHandler(void)
           CAM2.Status |= CAM_ERROR;
           Init_CAM2_DMA_Streams();
         }
+#ifdef ENABLE_SAMPLE_SOA
+        DMA2_Stream6->M0AR = (uint32_t)((uint8_t *)(&CAMSampleRec[SampleIndex & 0x0001].Ia));
+#else
         DMA2_Stream6->M0AR = (uint32_t)((uint8_t *)(&SampleBuf[SampleIndex].Ia));
+#endif
         DMA2->HIFCR |= DMA_HISR_TCIF6;                // Reset the transfer complete interrupt flag
         // Must clear all event flags before initiating a DMA operation
         DMA2->HIFCR |= (DMA_HIFCR_CTCIF6 + DMA_HIFCR_CHTIF6 + DMA_HIFCR_CTEIF6 + DMA_HIFCR_CDMEIF6
@@ -1933,6 +2285,7 @@ void DMA1_Stream0_IRQHandler(void)
         DMA2_Stream6->CR |= 0x00000001;               // Initiate the DMA to transmit the data to CAM2
         CAM2.Status &= (~CAM_FIRST_SAMPLE);
       }
+#endif
 
       // ------------------------------------- Trip Waveform Captures -------------------------------------
       //
@@ -2157,12 +2510,14 @@ void DMA1_Stream0_IRQHandler(void)
       }
       
       SampleCounter++;                 // Used by Sec Inj to time the test
+      PROF_STOP(PROF_ISR_BUFFER);
 
       // -------------------------------- Update Peaks and Sums of Squares ---------------------------------
       //
       // Finish updating the sums of squares for the metered currents (Ia thru Igres), load voltages (Van1
       //   thru Vcn1, Vab1 thru Vca1, Van2 thru Vcn2, Vab2 thru Vca2)
       //
+      PROF_START(PROF_ISR_SOS);
       update_peaks();                       // Update peak values for crest factor calculations
       update_Ia_SOS();                      // Update the Ia 1/2-cycle, 1-cyc, and 200msec sums of squares
       update_Ib_SOS();                      // Update the Ib 1/2-cycle, 1-cyc, and 200msec sums of squares
@@ -2172,8 +2527,15 @@ void DMA1_Stream0_IRQHandler(void)
       update_Igres_SOS();               // Update the Igres 1/2-cycle, 1-cyc, and 200msec sums of squares
       update_VlnAFE_SOS();              // Update the AFE (load side) Vln 1-cyc and 200msec sums of squares
       update_VllAFE_SOS();              // Update the AFE (load side) Vll 1-cyc and 200msec sums of squares
+#ifdef ENABLE_SIMD_SOS
+      if ( (OneCycInd == 39) || (OneCycInd >= 79) )   // Every half cycle, update the AFE and ADC Vln and
+      {                                               //   Vll 1-cyc sums of squares from SampleBuf
+        update_Volt_SOS_Block();
+      }
+#else
       update_VlnADC_SOS();              // Update the ADC (line side) Vln 1-cyc and 200msec sums of squares
       update_VllADC_SOS();              // Update the ADC (line side) Vll 1-cyc and 200msec sums of squares
+#endif
       update_Power_SOS();               // Update the AFE (load side) W and VAR 1-cyc and 200msec SOS's
       //
       //
@@ -2185,6 +2547,11 @@ void DMA1_Stream0_IRQHandler(void)
       //    VolAFEOneCycSOS_Sum.Vxx -- floating point 1-cycle line-neutral and line-line load-side voltages
       //    VolADC200msSOS_Sum.Vxx -- floating point 200msec line-neutral and line-line line-side voltages
       //    VolADCOneCycSOS_Sum.Vxx -- floating point 1-cyc line-neutral and line-to-line line-side voltages
+      //      Note, if ENABLE_SIMD_SOS is defined, the 1-cycle voltage sums are instead
+      //      VolAFEOneCycSOS_SumI.Vxx and VolADCOneCycSOS_SumI.Vxx (uint64 voltage in tenths (squared)), and
+      //      are only updated every half cycle.  VolADC200msSOS_Sum.Vxx is updated every cycle, in
+      //      save_OC_SOS().  The 200msec anniversary (960 samples) is always a one-cycle anniversary, and
+      //      save_OC_SOS() runs before save_200msec_SOS(), so the 200msec sums cover the same samples
       //    PwrOneCycSOS_Sum.Px -- floating point one-cycle real power
       //    Pwr200msecSOS_Sum.Px -- floating point 200msec real power
       //    PwrOneCycSOS_Sum.RPx -- floating point one-cycle reactive power
@@ -2198,6 +2565,19 @@ void DMA1_Stream0_IRQHandler(void)
       update_THD_Sin_Cos_SOS();
 //TESTPIN_D1_HIGH;
 
+#ifdef ENABLE_FREQ_TRACK
+      // Update the zero-crossing frequency tracker
+      update_FreqTrack();
+#endif
+#if defined(ENABLE_FREQ_TRACK) && defined(ENABLE_FREQ_RETUNE)
+      // If Calc_FreqTrack() has requested a new sample rate, load it.  This is done here because the AFE
+      //   registers are written over the same SPI as the samples, and the AFE read for this sample is done
+      if (FreqTrack.TuneReq)
+      {
+        Update_Sample_Rate();
+      }
+#endif
+
      
       // If state > 6, we have received more than one 1/2-cycle's worth of samples (40 samples = 1/2 cycle),
       //   so subtract the square of the oldest 1/2-cycle sample from the sums of squares for the 1/2-cycle
@@ -2272,8 +2652,10 @@ void DMA1_Stream0_IRQHandler(void)
      
       // Increment the buffer indices
       inc_buf_indices();
+      PROF_STOP(PROF_ISR_SOS);
 
       // Run Instantaneous and Short-Delay Protection
+      PROF_START(PROF_ISR_PROT);
       if (AFE_SampleState > 5)          // If there are valid 1/2-cycle currents, run protection
       {
          if ((Prot_Enabled) && (!Manufacture_Mode))      // Run protection if it is enabled
@@ -2304,6 +2686,7 @@ void DMA1_Stream0_IRQHandler(void)
          }
 
       }
+      PROF_STOP(PROF_ISR_PROT);
 
       // Update the state
       if (AFE_SampleState == 5)                                // For state 5, if next sample is the 40th
@@ -2342,9 +2725,11 @@ void DMA1_Stream0_IRQHandler(void)
   }
 
     Get_InternalTime(&starttime1);       // *** DAH ADDED TO MEASURE 61850 COMMUNICATIONS SUBROUTINES TIME
+  PROF_START(PROF_ISR_61850);
   DispComm61850_Rx();                   // *** DAH  MAYBE MOVE THESE TO THE ADC INTERRUPT SINCE IT IS ON A TIMER AND WON'T DEPEND ON THE EXTERNAL CHIP
   DispComm61850_Tx();                   // Call 61850 GOOSE transmission processing subroutine *** DAH MAYBE HAVE RX ROUTINE BEFORE PROTECTION AND TX ROUTINE AFTER PROTECTION
                                                                         // TO MINIMIZE DELAYS RECEIVING AND TRANSMITTING ZSI MESSAGES!
+  PROF_STOP(PROF_ISR_61850);
     Get_InternalTime(&endtime1);         // *** DAH ADDED TO MEASURE HIGH-SPEED COMMS TIME
     looptime1 = ((endtime1.Time_secs == starttime1.Time_secs) ?
                     (endtime1.Time_nsec - starttime1.Time_nsec) :
@@ -2353,6 +2738,7 @@ void DMA1_Stream0_IRQHandler(void)
     {
       maxlooptime1 = looptime1;
     }
+  PROF_STOP(PROF_ISR_TOTAL);
 // TESTPIN_A3_HIGH;                       // *** DAH TEST CODE
 }
 
@@ -3034,6 +3420,96 @@ void TIM1_UP_TIM10_IRQHandler(void)
 
 
 
+#ifdef ENABLE_SPI2_DMA
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        DMA1_Stream4_IRQHandler(), SPI2_IRQHandler()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           SPI2 FRAM Transaction Engine Interrupt Service Routines
+// 
+//  MECHANICS:          These subroutines are branched to from the DMA1 Stream 4 transfer complete interrupt
+//                      (SPI2 Tx write data) and from the SPI2 RXNE interrupt (opcode, address, and read
+//                      data frames).  Both call SPI2_XactService(), which advances the FRAM transaction at
+//                      the head of the SPI2 queue.  See SPI2_Submit() in Iod.c.
+//                      The interrupts are set to Group 2 so that they preempt TIM10, which reads and writes
+//                      FRAM from SPI1_Flash_Manager() and waits for the transactions to finish
+//
+//  CAVEATS:            SPI2_XactService() checks the flags itself, so a spurious interrupt does nothing
+// 
+//  INPUTS:             None
+// 
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+// 
+//  CALLS:              SPI2_XactService()
+// 
+//  EXECUTION TIME:     Each interrupt handles one frame or one DMA segment.  The last segment of a write
+//                      waits up to about 2usec for the last frames to be shifted out
+// 
+//------------------------------------------------------------------------------------------------------------
+
+void DMA1_Stream4_IRQHandler(void)
+{
+  SPI2_XactService();
+}
+
+void SPI2_IRQHandler(void)
+{
+  SPI2_XactService();
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION        DMA1_Stream4_IRQHandler(), SPI2_IRQHandler()
+//------------------------------------------------------------------------------------------------------------
+
+#endif
+
+
+
+#ifdef ENABLE_SPI1_DMA
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        DMA2_Stream3_IRQHandler()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           SPI1 Flash Page Write Interrupt Service Routine
+// 
+//  MECHANICS:          This subroutine is branched to from the DMA2 Stream 3 transfer complete interrupt,
+//                      when the data for a Flash page has been sent to SPI1.  It calls Flash_PipeDone(),
+//                      which releases the Flash chip select to start the page program.  See
+//                      Flash_PipeService() in Iod.c.
+//                      The interrupt is set to Group 2 so that the page program is started while TIM10 is
+//                      gathering the next page
+//
+//  CAVEATS:            None
+// 
+//  INPUTS:             None
+// 
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+// 
+//  CALLS:              Flash_PipeDone()
+// 
+//  EXECUTION TIME:     Waits up to about 2usec for the last words to be shifted out
+// 
+//------------------------------------------------------------------------------------------------------------
+
+void DMA2_Stream3_IRQHandler(void)
+{
+  Flash_PipeDone();
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION        DMA2_Stream3_IRQHandler()
+//------------------------------------------------------------------------------------------------------------
+
+#endif
+
+
+
 
 
 //------------------------------------------------------------------------------------------------------------
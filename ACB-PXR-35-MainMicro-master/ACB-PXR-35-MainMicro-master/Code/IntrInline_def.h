@@ -59,6 +59,20 @@
 //                      - Added One sec counter (OneSecCtr)
 //   0.93   231010   BP - Added code for Firmware Simulated test
 //   104    231102   BP - Fixed the 60% neutral ratio and added 200%
+//   157    240209  DAH - Revised buffer_samples() to use SAMPLEBUF(), and to store the samples in
+//                        CAMSampleRec[] if SampleBuf is stored by channel
+//   158    240210  DAH - Added update_Volt_SOS_Block().  If ENABLE_SIMD_SOS is defined, update_VlnAFE_SOS()
+//                        and update_VllAFE_SOS() only update the 200msec sums, and save_OC_SOS() saves the
+//                        integer one-cycle voltage sums and adds the ADC one-cycle sums to VolADC200msSOS_Sum
+//   175    240227  DAH - If ENABLE_SEQ_PHASOR is defined, update_THD_Sin_Cos_SOS() updates the one-cycle sine
+//                        and cosine sums (including the ADC voltages), and save_OC_SOS() saves them in
+//                        CurVolOneCycSin_Sav[] and CurVolOneCycCos_Sav[] and adds them to the 200msec sums
+//   176    240228  DAH - Added update_FreqTrack() for the zero-crossing frequency tracker (ENABLE_FREQ_TRACK
+//                        defined)
+//   177    240229  DAH - Added publish_CAM_SV() to send the samples to the sampled-value CAMs in frames
+//                        (ENABLE_CAM_SV_FRAME defined)
+//   179    240302  DAH - save_OC_SOS() description revised to explain why the ADC 200msec voltage sums cover
+//                        the same samples if ENABLE_SIMD_SOS is defined
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -82,6 +96,9 @@
 //------------------------------------------------------------------------------------------------------------
 
 __attribute__(( always_inline )) inline void buffer_samples(void);
+#ifdef ENABLE_CAM_SV_FRAME
+  __attribute__(( always_inline )) inline void publish_CAM_SV(void);
+#endif
 __attribute__(( always_inline )) inline void update_peaks(void);
 __attribute__(( always_inline )) inline void save_OC_peaks(void);
 __attribute__(( always_inline )) inline void update_Ia_SOS(void);
@@ -94,9 +111,15 @@ __attribute__(( always_inline )) inline void update_VlnAFE_SOS(void);
 __attribute__(( always_inline )) inline void update_VllAFE_SOS(void);
 __attribute__(( always_inline )) inline void update_VlnADC_SOS(void);
 __attribute__(( always_inline )) inline void update_VllADC_SOS(void);
+#ifdef ENABLE_SIMD_SOS
+  __attribute__(( always_inline )) inline void update_Volt_SOS_Block(void);
+#endif
 __attribute__(( always_inline )) inline void update_Power_SOS(void);
 __attribute__(( always_inline )) inline void update_THD_Sin_Cos_SOS(void);
 __attribute__(( always_inline )) inline void save_OC_SOS(void);
+#ifdef ENABLE_FREQ_TRACK
+  __attribute__(( always_inline )) inline void update_FreqTrack(void);
+#endif
 __attribute__(( always_inline )) inline void save_200msec_SOS(void);
 __attribute__(( always_inline )) inline void calc_min_max_I_HC_SOS(void);
 __attribute__(( always_inline )) inline void calc_min_max_I_OC_SOS(void);
@@ -135,16 +158,19 @@ extern const float x_n_test1[ ];                 // *** DAH  UNCOMMENT FOR TEST
 //                      The samples are stored in:
 //                          SampleBuf[SampleIndex].xxx, xxx = Ia .. Igres, Van1 - Vcn1, Van2 - Vcn2
 //                      SampleBuf[] is used for Trip and Alarm waveform captures
+//                      If SampleBuf is stored by channel (ENABLE_SAMPLE_SOA is defined), the samples are
+//                      stored in SampleBuf.xxx[SampleIndex], and if there is a sampled-value CAM, they are
+//                      also stored as a sample set in CAMSampleRec[] for the CAM DMA
 //
 //  CAVEATS:            None
 // 
 //  INPUTS:             AFE_new_samples[], ADC_samples[]
 // 
-//  OUTPUTS:            SampleBuf[]
+//  OUTPUTS:            SampleBuf[], CAMSampleRec[]
 //
 //  ALTERS:             None
 // 
-//  CALLS:              None
+//  CALLS:              SampleBuf_GetRecord() (if ENABLE_SAMPLE_SOA is defined)
 // 
 //------------------------------------------------------------------------------------------------------------
 
@@ -162,18 +188,24 @@ __attribute__(( always_inline )) inline void buffer_samples(void)
 //      if (freddah1 > 959)
 //      freddah1 = 0;
 //  SampleBuf[SampleIndex].Ia = SampleIndex;                    //     *** DAH TEST FOR ALARM AND TRIP LOG TESTING
-  SampleBuf[SampleIndex].Ia = AFE_new_samples[0];                        
-  SampleBuf[SampleIndex].Ib = AFE_new_samples[1];
-  SampleBuf[SampleIndex].Ic = AFE_new_samples[2];
-  SampleBuf[SampleIndex].In = AFE_new_samples[3];
-  SampleBuf[SampleIndex].Igsrc = AFE_new_samples[4];
-  SampleBuf[SampleIndex].Igres = Igres;
-  SampleBuf[SampleIndex].VanAFE = (int16_t)(AFE_new_samples[5] * 10);               // *** DAH TEST  COMMENT THIS OUT FOR HARMONICS TEST
-  SampleBuf[SampleIndex].VbnAFE = (int16_t)(AFE_new_samples[6] * 10);
-  SampleBuf[SampleIndex].VcnAFE = (int16_t)(AFE_new_samples[7] * 10);
-  SampleBuf[SampleIndex].VanADC = (int16_t)(ADC_samples[5] * 10);
-  SampleBuf[SampleIndex].VbnADC = (int16_t)(ADC_samples[6] * 10);
-  SampleBuf[SampleIndex].VcnADC = (int16_t)(ADC_samples[7] * 10);
+  SAMPLEBUF(Ia, SampleIndex) = AFE_new_samples[0];                        
+  SAMPLEBUF(Ib, SampleIndex) = AFE_new_samples[1];
+  SAMPLEBUF(Ic, SampleIndex) = AFE_new_samples[2];
+  SAMPLEBUF(In, SampleIndex) = AFE_new_samples[3];
+  SAMPLEBUF(Igsrc, SampleIndex) = AFE_new_samples[4];
+  SAMPLEBUF(Igres, SampleIndex) = Igres;
+  SAMPLEBUF(VanAFE, SampleIndex) = (int16_t)(AFE_new_samples[5] * 10);               // *** DAH TEST  COMMENT THIS OUT FOR HARMONICS TEST
+  SAMPLEBUF(VbnAFE, SampleIndex) = (int16_t)(AFE_new_samples[6] * 10);
+  SAMPLEBUF(VcnAFE, SampleIndex) = (int16_t)(AFE_new_samples[7] * 10);
+  SAMPLEBUF(VanADC, SampleIndex) = (int16_t)(ADC_samples[5] * 10);
+  SAMPLEBUF(VbnADC, SampleIndex) = (int16_t)(ADC_samples[6] * 10);
+  SAMPLEBUF(VcnADC, SampleIndex) = (int16_t)(ADC_samples[7] * 10);
+#ifdef ENABLE_SAMPLE_SOA
+  if ( (CAM1.Status | CAM2.Status) & CAM_TYPE_SAMPLE )
+  {
+    SampleBuf_GetRecord(SampleIndex, &CAMSampleRec[SampleIndex & 0x0001]);
+  }
+#endif
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -182,6 +214,133 @@ __attribute__(( always_inline )) inline void buffer_samples(void)
 
 
 
+#ifdef ENABLE_CAM_SV_FRAME
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        publish_CAM_SV()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Sampled-Value Frame Publisher In-Line Subroutine
+//
+//  MECHANICS:          This subroutine is jumped to from the DMA1_Stream0_IRQ (sampling) interrupt service
+//                      routine, after buffer_samples(), if ENABLE_CAM_SV_FRAME is defined.  It replaces the
+//                      DMA transfer of each sample set to the sampled-value CAMs.
+//                      The present sample set (SampleBuf[SampleIndex], or CAMSampleRec[] if SampleBuf is
+//                      stored by channel) is copied into the frame that is being filled,
+//                      CAMSvPub.Frame[CAMSvPub.FillNdx], and the running CRC is updated with it.  For the
+//                      first sample set of a frame, the sequence number and the time stamp are filled in,
+//                      and the CRC is started with the header.  The CRC is computed a sample set at a time,
+//                      so the time is spread evenly over the interrupts.
+//                      When the frame is full, the CRC is stored, and the frames are swapped, so the next
+//                      sample sets are stored in the other frame while this one is sent.  For each
+//                      sampled-value CAM:
+//                        - If the previous frame has not finished (the DMA transfer complete flag is not
+//                          set and this is not the first frame), it is aborted by reinitializing the DMA
+//                          stream, and CAMSvPub.Drops[] is incremented.  The receiver sees a bad CRC and a
+//                          gap in the sequence numbers.  The previous frame is always either finished or
+//                          aborted before its buffer is refilled.
+//                        - The DMA stream is started with the frame (CAMSV_FRAME_BYTES bytes)
+//                      So there is one DMA transfer per CAMSV_SAMPLES samples, instead of one per sample.
+//
+//  CAVEATS:            The sample sets must be stored (buffer_samples()) before this subroutine is called,
+//                      and SampleIndex must not yet be incremented
+//
+//  INPUTS:             SampleBuf[], CAMSampleRec[], SampleIndex, CAM1.Status, CAM2.Status, DMA2->HISR
+//
+//  OUTPUTS:            CAMSvPub, CAM1.Status, CAM2.Status, DMA2_Stream7, DMA2_Stream6, DMA2->HIFCR
+//
+//  ALTERS:             None
+//
+//  CALLS:              Get_InternalTime(), Crc16_Block(), Init_CAM1_DMA_Streams(), Init_CAM2_DMA_Streams()
+//
+//------------------------------------------------------------------------------------------------------------
+
+__attribute__(( always_inline )) inline void publish_CAM_SV(void)
+{
+  struct CAM_SV_FRAME *fptr;
+  struct INTERNAL_TIME ts;
+  const uint32_t *sptr;
+  uint32_t *dptr;
+  uint8_t i;
+
+  if ( (CAM1.Status | CAM2.Status) & CAM_TYPE_SAMPLE )
+  {
+    fptr = &CAMSvPub.Frame[CAMSvPub.FillNdx];
+    if (CAMSvPub.NumSamp == 0)                  // If first sample set of the frame, fill in the header
+    {                                           //   and start the CRC
+      Get_InternalTime(&ts);
+      fptr->SeqNum = CAMSvPub.SeqNum;
+      fptr->TS_secs = ts.Time_secs;
+      fptr->TS_nsec = ts.Time_nsec;
+      CAMSvPub.Crc = Crc16_Block(CRC16_INIT, (uint8_t *)fptr, CAMSV_HDR_BYTES);
+    }
+#ifdef ENABLE_SAMPLE_SOA
+    sptr = (const uint32_t *)(&CAMSampleRec[SampleIndex & 0x0001]);
+#else
+    sptr = (const uint32_t *)(&SampleBuf[SampleIndex]);
+#endif
+    dptr = &fptr->Samples[CAMSvPub.NumSamp][0];
+    for (i=0; i<CAMSV_SAMPLE_WORDS; ++i)
+    {
+      dptr[i] = sptr[i];
+    }
+    CAMSvPub.Crc = Crc16_Block(CAMSvPub.Crc, (uint8_t *)dptr, CAMSV_SAMPLE_BYTES);
+
+    if (++CAMSvPub.NumSamp >= CAMSV_SAMPLES)    // If the frame is full, finish it, swap the frames, and
+    {                                           //   send it to the sampled-value CAMs
+      fptr->Crc = CAMSvPub.Crc;
+      CAMSvPub.NumSamp = 0;
+      ++CAMSvPub.SeqNum;
+      CAMSvPub.FillNdx ^= 1;
+
+      if (CAM1.Status & CAM_TYPE_SAMPLE)
+      {
+        if ( !(DMA2->HISR & DMA_HISR_TCIF7)           // If the previous frame is not complete and this is
+          && !(CAM1.Status & CAM_FIRST_SAMPLE) )      //   not the first frame, abort it.  Count the drop
+        {                                             //   and reinitialize the DMA stream.
+          ++CAMSvPub.Drops[0];
+          CAM1.Status |= CAM_ERROR;
+          Init_CAM1_DMA_Streams();
+        }
+        DMA2_Stream7->M0AR = (uint32_t)((uint8_t *)fptr);
+        DMA2_Stream7->NDTR = CAMSV_FRAME_BYTES;
+        // Must clear all event flags before initiating a DMA operation
+        DMA2->HIFCR |= (DMA_HIFCR_CTCIF7 + DMA_HIFCR_CHTIF7 + DMA_HIFCR_CTEIF7 + DMA_HIFCR_CDMEIF7
+                              + DMA_HIFCR_CFEIF7);
+        DMA2_Stream7->CR |= 0x00000001;               // Initiate the DMA to transmit the frame to CAM1
+        CAM1.Status &= (~CAM_FIRST_SAMPLE);
+        ++CAMSvPub.Frames[0];
+      }
+      if (CAM2.Status & CAM_TYPE_SAMPLE)
+      {
+        if ( !(DMA2->HISR & DMA_HISR_TCIF6)           // If the previous frame is not complete and this is
+          && !(CAM2.Status & CAM_FIRST_SAMPLE) )      //   not the first frame, abort it.  Count the drop
+        {                                             //   and reinitialize the DMA stream.
+          ++CAMSvPub.Drops[1];
+          CAM2.Status |= CAM_ERROR;
+          Init_CAM2_DMA_Streams();
+        }
+        DMA2_Stream6->M0AR = (uint32_t)((uint8_t *)fptr);
+        DMA2_Stream6->NDTR = CAMSV_FRAME_BYTES;
+        // Must clear all event flags before initiating a DMA operation
+        DMA2->HIFCR |= (DMA_HIFCR_CTCIF6 + DMA_HIFCR_CHTIF6 + DMA_HIFCR_CTEIF6 + DMA_HIFCR_CDMEIF6
+                              + DMA_HIFCR_CFEIF6);
+        DMA2_Stream6->CR |= 0x00000001;               // Initiate the DMA to transmit the frame to CAM2
+        CAM2.Status &= (~CAM_FIRST_SAMPLE);
+        ++CAMSvPub.Frames[1];
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION        publish_CAM_SV()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_CAM_SV_FRAME
+
+
+
 
 
 //------------------------------------------------------------------------------------------------------------
@@ -678,6 +837,8 @@ __attribute__(( always_inline )) inline void update_Igres_SOS(void)
 //                      metering and is updated with the square of MTR_new_samples[].  This value is more
 //                      heavily filtered.  The one-cycle (VolAFEOneCycSOS_Sum.Vxn) values are used for
 //                      protection and are updated with AFE_new_samples[].
+//                      If ENABLE_SIMD_SOS is defined, the one-cycle values are computed from SampleBuf by
+//                      update_Volt_SOS_Block() instead, and only the 200msec values are updated here.
 //
 //  CAVEATS:            None
 // 
@@ -695,16 +856,22 @@ __attribute__(( always_inline )) inline void update_VlnAFE_SOS(void)
 {
   float ftemp1;
 
+#ifndef ENABLE_SIMD_SOS
   ftemp1 = AFE_new_samples[5] * AFE_new_samples[5];             // Add square of new voltage sample
   VolAFEOneCycSOS_Sum.Van += ftemp1;
+#endif
   ftemp1 = MTR_new_samples[5] * MTR_new_samples[5];             // Add square of new voltage sample
   VolAFE200msFltrSOS_Sum.Van += ftemp1;
+#ifndef ENABLE_SIMD_SOS
   ftemp1 = AFE_new_samples[6] * AFE_new_samples[6];             // Add square of new voltage sample
   VolAFEOneCycSOS_Sum.Vbn += ftemp1;
+#endif
   ftemp1 = MTR_new_samples[6] * MTR_new_samples[6];             // Add square of new voltage sample
   VolAFE200msFltrSOS_Sum.Vbn += ftemp1;
+#ifndef ENABLE_SIMD_SOS
   ftemp1 = AFE_new_samples[7] * AFE_new_samples[7];             // Add square of new voltage sample
   VolAFEOneCycSOS_Sum.Vcn += ftemp1;
+#endif
   ftemp1 = MTR_new_samples[7] * MTR_new_samples[7];             // Add square of new voltage sample
   VolAFE200msFltrSOS_Sum.Vcn += ftemp1;
 }
@@ -733,6 +900,8 @@ __attribute__(( always_inline )) inline void update_VlnAFE_SOS(void)
 //                      metering and is updated with the square of MTR_new_samples[].  This value is more
 //                      heavily filtered.  The one-cycle (VolAFEOneCycSOS_Sum.Vxx) values are used for
 //                      protection and are updated with AFE_new_samples[].
+//                      If ENABLE_SIMD_SOS is defined, the one-cycle values are computed from SampleBuf by
+//                      update_Volt_SOS_Block() instead, and only the 200msec values are updated here.
 //
 //  CAVEATS:            None
 // 
@@ -750,21 +919,27 @@ __attribute__(( always_inline )) inline void update_VllAFE_SOS(void)
 {
   float ftemp1;
 
+#ifndef ENABLE_SIMD_SOS
   ftemp1 = AFE_new_samples[5] - AFE_new_samples[6];             // Compute Vab
   ftemp1 = ftemp1 * ftemp1;                                     // Square the voltage
   VolAFEOneCycSOS_Sum.Vab += ftemp1;                            // Add to the sum of squares
+#endif
   ftemp1 = MTR_new_samples[5] - MTR_new_samples[6];
   ftemp1 = ftemp1 * ftemp1;
   VolAFE200msFltrSOS_Sum.Vab += ftemp1;
+#ifndef ENABLE_SIMD_SOS
   ftemp1 = AFE_new_samples[6] - AFE_new_samples[7];             // Vbc
   ftemp1 = ftemp1 * ftemp1;
   VolAFEOneCycSOS_Sum.Vbc += ftemp1;
+#endif
   ftemp1 = MTR_new_samples[6] - MTR_new_samples[7];
   ftemp1 = ftemp1 * ftemp1;
   VolAFE200msFltrSOS_Sum.Vbc += ftemp1;
+#ifndef ENABLE_SIMD_SOS
   ftemp1 = AFE_new_samples[7] - AFE_new_samples[5];             // Vca
   ftemp1 = ftemp1 * ftemp1;
   VolAFEOneCycSOS_Sum.Vca += ftemp1;
+#endif
   ftemp1 = MTR_new_samples[7] - MTR_new_samples[5];
   ftemp1 = ftemp1 * ftemp1;
   VolAFE200msFltrSOS_Sum.Vca += ftemp1;
@@ -875,6 +1050,73 @@ __attribute__(( always_inline )) inline void update_VllADC_SOS(void)
 
 
 
+#ifdef ENABLE_SIMD_SOS
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        update_Volt_SOS_Block()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Update One-Cycle Voltage Sums of Squares From SampleBuf In-Line Subroutine
+// 
+//  MECHANICS:          This subroutine is jumped to from the DMA1_Stream0_IRQ (sampling) interrupt service
+//                      routine.  It is defined as an in-line subroutine, and so is jumped to, not called
+//                      to save overhead time.  This subroutine is used to improve the readability of the
+//                      sampling interrupt service routine.
+//                      The subroutine replaces the per-sample one-cycle voltage updates in
+//                      update_VlnAFE_SOS(), update_VllAFE_SOS(), update_VlnADC_SOS(), and
+//                      update_VllADC_SOS().  It is called every half cycle (OneCycInd = 39 and 79), and adds
+//                      the voltage samples that have been stored in SampleBuf since the last call to the
+//                      integer AFE and ADC one-cycle sums of squares, VolAFEOneCycSOS_SumI and
+//                      VolADCOneCycSOS_SumI, with Volt_SOS_Block().  Spreading the work over two calls
+//                      keeps the added time in the one-cycle anniversary interrupt to one half-cycle block.
+//                      The block begins at the sample with one-cycle index VolSOS_BlkInd and ends with the
+//                      present sample (SampleIndex has not been incremented yet).  If the block wraps around
+//                      the end of SampleBuf, it is processed in two pieces.
+//
+//  CAVEATS:            Only used if ENABLE_SIMD_SOS is defined.
+//                      Must be called after buffer_samples() has stored the present sample.
+//
+//  INPUTS:             SampleIndex, OneCycInd, VolSOS_BlkInd, SampleBuf.Vxxxxx
+// 
+//  OUTPUTS:            VolAFEOneCycSOS_SumI.Vxx, VolADCOneCycSOS_SumI.Vxx, VolSOS_BlkInd
+//
+//  ALTERS:             None
+// 
+//  CALLS:              Volt_SOS_Block()
+// 
+//------------------------------------------------------------------------------------------------------------
+
+__attribute__(( always_inline )) inline void update_Volt_SOS_Block(void)
+{
+  uint16_t start, len, len1;
+
+  len = OneCycInd + 1 - VolSOS_BlkInd;                  // Number of samples since the last block
+  start = ( (SampleIndex >= (len - 1)) ?                // Index of the first sample
+               (SampleIndex - (len - 1)) : (SampleIndex + TOTAL_SAMPLE_SETS - (len - 1)) );
+  len1 = ( ((start + len) > TOTAL_SAMPLE_SETS) ? (TOTAL_SAMPLE_SETS - start) : len );
+
+  Volt_SOS_Block(&SAMPLEBUF(VanAFE, start), &SAMPLEBUF(VbnAFE, start), &SAMPLEBUF(VcnAFE, start),
+                 SAMPLEBUF_I16_STRIDE, len1, &VolAFEOneCycSOS_SumI);
+  Volt_SOS_Block(&SAMPLEBUF(VanADC, start), &SAMPLEBUF(VbnADC, start), &SAMPLEBUF(VcnADC, start),
+                 SAMPLEBUF_I16_STRIDE, len1, &VolADCOneCycSOS_SumI);
+  if (len1 < len)                                       // If the block wraps, do the rest from the start of
+  {                                                     //   the buffer
+    Volt_SOS_Block(&SAMPLEBUF(VanAFE, 0), &SAMPLEBUF(VbnAFE, 0), &SAMPLEBUF(VcnAFE, 0),
+                   SAMPLEBUF_I16_STRIDE, (len - len1), &VolAFEOneCycSOS_SumI);
+    Volt_SOS_Block(&SAMPLEBUF(VanADC, 0), &SAMPLEBUF(VbnADC, 0), &SAMPLEBUF(VcnADC, 0),
+                   SAMPLEBUF_I16_STRIDE, (len - len1), &VolADCOneCycSOS_SumI);
+  }
+  VolSOS_BlkInd = ( (OneCycInd >= 79) ? 0 : (OneCycInd + 1) );
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION        update_Volt_SOS_Block()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_SIMD_SOS
+
+
+
 
 
 //------------------------------------------------------------------------------------------------------------
@@ -965,13 +1207,18 @@ __attribute__(( always_inline )) inline void update_Power_SOS(void)
 //                      Note, AFE_new_samples[] is used for these computations.  These are not digitally
 //                      filtered like the MTR_new_samples[] are, and so are more accurate when computing
 //                      THD.
+//                      If ENABLE_SEQ_PHASOR is defined, the components are summed over one cycle instead,
+//                      in CurVolOneCycSin_Sum[] and CurVolOneCycCos_Sum[], and the ADC voltages are also
+//                      included.  These are the fundamental phasors for the sequence components.
+//                      save_OC_SOS() adds the one-cycle sums to the 200msec sums each cycle.
 //
 //  CAVEATS:            None
 // 
-//  INPUTS:             OneCycInd, AFE_new_samples[], SIN_COEFF[]
+//  INPUTS:             OneCycInd, AFE_new_samples[], SIN_COEFF[], ADC_samples[] (ENABLE_SEQ_PHASOR defined)
 // 
 //  OUTPUTS:            Cur200msNoFltrSinSOS_Sum.Ix, Cur200msNoFltrCosSOS_Sum.Ix, x = a, b, c
 //                      VolAFE200msNoFltrSinSOS_Sum.Vxn, VolAFE200msNoFltrCosSOS_Sum.Vxn, x = a, b, c
+//                      CurVolOneCycSin_Sum[], CurVolOneCycCos_Sum[] (ENABLE_SEQ_PHASOR defined)
 //
 //  ALTERS:             None
 // 
@@ -988,6 +1235,30 @@ __attribute__(( always_inline )) inline void update_THD_Sin_Cos_SOS(void)
 
   // Update the sine and cosine components of the fundamental for THD
   ftemp1 = SIN_COEFF[OneCycInd];            // Sin index is OneCycInd (OneCycInd is 0 .. 79)
+#ifdef ENABLE_SEQ_PHASOR
+  CurVolOneCycSin_Sum[0] += (AFE_new_samples[0] * ftemp1);
+  CurVolOneCycSin_Sum[1] += (AFE_new_samples[1] * ftemp1);
+  CurVolOneCycSin_Sum[2] += (AFE_new_samples[2] * ftemp1);
+  CurVolOneCycSin_Sum[3] += (AFE_new_samples[3] * ftemp1);
+  CurVolOneCycSin_Sum[4] += (AFE_new_samples[5] * ftemp1);
+  CurVolOneCycSin_Sum[5] += (AFE_new_samples[6] * ftemp1);
+  CurVolOneCycSin_Sum[6] += (AFE_new_samples[7] * ftemp1);
+  CurVolOneCycSin_Sum[7] += (ADC_samples[5] * ftemp1);
+  CurVolOneCycSin_Sum[8] += (ADC_samples[6] * ftemp1);
+  CurVolOneCycSin_Sum[9] += (ADC_samples[7] * ftemp1);
+  i = (OneCycInd <= 59) ? (OneCycInd + 20) : (OneCycInd - 60);
+  ftemp1 = SIN_COEFF[i];
+  CurVolOneCycCos_Sum[0] += (AFE_new_samples[0] * ftemp1);
+  CurVolOneCycCos_Sum[1] += (AFE_new_samples[1] * ftemp1);
+  CurVolOneCycCos_Sum[2] += (AFE_new_samples[2] * ftemp1);
+  CurVolOneCycCos_Sum[3] += (AFE_new_samples[3] * ftemp1);
+  CurVolOneCycCos_Sum[4] += (AFE_new_samples[5] * ftemp1);
+  CurVolOneCycCos_Sum[5] += (AFE_new_samples[6] * ftemp1);
+  CurVolOneCycCos_Sum[6] += (AFE_new_samples[7] * ftemp1);
+  CurVolOneCycCos_Sum[7] += (ADC_samples[5] * ftemp1);
+  CurVolOneCycCos_Sum[8] += (ADC_samples[6] * ftemp1);
+  CurVolOneCycCos_Sum[9] += (ADC_samples[7] * ftemp1);
+#else
   Cur200msNoFltrSinSOS_Sum.Ia += (AFE_new_samples[0] * ftemp1);
   Cur200msNoFltrSinSOS_Sum.Ib += (AFE_new_samples[1] * ftemp1);
   Cur200msNoFltrSinSOS_Sum.Ic += (AFE_new_samples[2] * ftemp1);
@@ -1005,6 +1276,7 @@ __attribute__(( always_inline )) inline void update_THD_Sin_Cos_SOS(void)
   VolAFE200msNoFltrCosSOS_Sum.Van += (AFE_new_samples[5] * ftemp1);
   VolAFE200msNoFltrCosSOS_Sum.Vbn += (AFE_new_samples[6] * ftemp1);
   VolAFE200msNoFltrCosSOS_Sum.Vcn += (AFE_new_samples[7] * ftemp1);
+#endif
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -1028,17 +1300,36 @@ __attribute__(( always_inline )) inline void update_THD_Sin_Cos_SOS(void)
 //                      done for the current, voltage, and power buffers.
 //                      Note, the one-cycle current buffers are not cleared, because they are continuously
 //                      updated on a per-sample basis.
+//                      If ENABLE_SIMD_SOS is defined, the one-cycle voltage sums are the integer sums
+//                      VolAFEOneCycSOS_SumI and VolADCOneCycSOS_SumI (tenths squared).  They are converted
+//                      to floating point when they are saved, and the ADC one-cycle sums are also added to
+//                      the 200msec sums, VolADC200msSOS_Sum, since these are no longer updated each sample.
+//                      The one-cycle sums are reset each cycle, the same as the floating point sums.  The
+//                      200msec anniversary (960 samples) is always a one-cycle anniversary (80 samples per
+//                      cycle at both 50Hz and 60Hz), and this subroutine runs before save_200msec_SOS(), so
+//                      the 200msec sums cover the same 12 cycles of samples as before (see
+//                      Replay_SOS200msCheck()).
+//                      If ENABLE_SEQ_PHASOR is defined, the one-cycle sine and cosine sums of the
+//                      fundamental are saved and cleared, and the current and AFE voltage sums are added to
+//                      the 200msec THD sums.  This is done before save_200msec_SOS() runs on the 200msec
+//                      anniversary, so the 200msec sums cover the same samples as before.
 //
 //  CAVEATS:            None
 // 
 //  INPUTS:             CurOneCycSOS_SumF.Ix, VolAFEOneCycSOS_Sum.Vxn, VolADCOneCycSOS_Sum.Vxx,
-//                      PwrOneCycSOS_Sum.Px, PwrOneCycSOS_Sum.RPx
+//                      PwrOneCycSOS_Sum.Px, PwrOneCycSOS_Sum.RPx, VolAFEOneCycSOS_SumI.Vxx,
+//                      VolADCOneCycSOS_SumI.Vxx, CurVolOneCycSin_Sum[], CurVolOneCycCos_Sum[]
 // 
 //  OUTPUTS:            CurOneCycSOS_Sav.Ix, VolAFEOneCycSOS_Sav.Vxx, VolADCOneCycSOS_Sav.Vxn,
-//                      PwrOneCycSOS_Sav.Px, PwrOneCycSOS_Sav.RPx, VolAFE200msNoFltrSOS_Sum.Vxx
+//                      PwrOneCycSOS_Sav.Px, PwrOneCycSOS_Sav.RPx, VolAFE200msNoFltrSOS_Sum.Vxx,
+//                      VolADC200msSOS_Sum.Vxx (ENABLE_SIMD_SOS defined), CurVolOneCycSin_Sav[],
+//                      CurVolOneCycCos_Sav[], Cur200msNoFltrSinSOS_Sum.Ix, Cur200msNoFltrCosSOS_Sum.Ix,
+//                      VolAFE200msNoFltrSinSOS_Sum.Vxn, VolAFE200msNoFltrCosSOS_Sum.Vxn (ENABLE_SEQ_PHASOR
+//                      defined)
 //
 //  ALTERS:             VolAFEOneCycSOS_Sum.Vxn, VolADCOneCycSOS_Sum.Vxn, PwrOneCycSOS_Sum.Px,
-//                      PwrOneCycSOS_Sum.RPx
+//                      PwrOneCycSOS_Sum.RPx, VolAFEOneCycSOS_SumI.Vxx, VolADCOneCycSOS_SumI.Vxx,
+//                      CurVolOneCycSin_Sum[], CurVolOneCycCos_Sum[]
 // 
 //  CALLS:              None
 // 
@@ -1048,12 +1339,42 @@ __attribute__(( always_inline )) inline void update_THD_Sin_Cos_SOS(void)
 
 __attribute__(( always_inline )) inline void save_OC_SOS(void)
 {
+#ifdef ENABLE_SEQ_PHASOR
+  uint8_t i;
+
+#endif
   CurOneCycSOS_Sav.Ia = CurOneCycSOS_SumF.Ia;           // Save the sums of squares
   CurOneCycSOS_Sav.Ib = CurOneCycSOS_SumF.Ib;           // Note, current sums are not reset, because
   CurOneCycSOS_Sav.Ic = CurOneCycSOS_SumF.Ic;           //   they are continuously updated each sample
   CurOneCycSOS_Sav.In = CurOneCycSOS_SumF.In;
   CurOneCycSOS_Sav.Igsrc = CurOneCycSOS_SumF.Igsrc;
   CurOneCycSOS_Sav.Igres = CurOneCycSOS_SumF.Igres;                //                  LEFT OFF CHECKING HERE - STILL NEED TO FIX  update_THD_Sin_Cos_SOS()
+#ifdef ENABLE_SIMD_SOS
+  VolAFEOneCycSOS_Sav.Van = ((float)VolAFEOneCycSOS_SumI.Van)/100;  // Convert from tenths squared
+  VolAFE200msNoFltrSOS_Sum.Van += VolAFEOneCycSOS_Sav.Van;
+  VolAFEOneCycSOS_Sav.Vbn = ((float)VolAFEOneCycSOS_SumI.Vbn)/100;
+  VolAFE200msNoFltrSOS_Sum.Vbn += VolAFEOneCycSOS_Sav.Vbn;
+  VolAFEOneCycSOS_Sav.Vcn = ((float)VolAFEOneCycSOS_SumI.Vcn)/100;
+  VolAFE200msNoFltrSOS_Sum.Vcn += VolAFEOneCycSOS_Sav.Vcn;
+  VolAFEOneCycSOS_Sav.Vab = ((float)VolAFEOneCycSOS_SumI.Vab)/100;
+  VolAFE200msNoFltrSOS_Sum.Vab += VolAFEOneCycSOS_Sav.Vab;
+  VolAFEOneCycSOS_Sav.Vbc = ((float)VolAFEOneCycSOS_SumI.Vbc)/100;
+  VolAFE200msNoFltrSOS_Sum.Vbc += VolAFEOneCycSOS_Sav.Vbc;
+  VolAFEOneCycSOS_Sav.Vca = ((float)VolAFEOneCycSOS_SumI.Vca)/100;
+  VolAFE200msNoFltrSOS_Sum.Vca += VolAFEOneCycSOS_Sav.Vca;
+  VolADCOneCycSOS_Sav.Van = ((float)VolADCOneCycSOS_SumI.Van)/100;
+  VolADC200msSOS_Sum.Van += VolADCOneCycSOS_Sav.Van;
+  VolADCOneCycSOS_Sav.Vbn = ((float)VolADCOneCycSOS_SumI.Vbn)/100;
+  VolADC200msSOS_Sum.Vbn += VolADCOneCycSOS_Sav.Vbn;
+  VolADCOneCycSOS_Sav.Vcn = ((float)VolADCOneCycSOS_SumI.Vcn)/100;
+  VolADC200msSOS_Sum.Vcn += VolADCOneCycSOS_Sav.Vcn;
+  VolADCOneCycSOS_Sav.Vab = ((float)VolADCOneCycSOS_SumI.Vab)/100;
+  VolADC200msSOS_Sum.Vab += VolADCOneCycSOS_Sav.Vab;
+  VolADCOneCycSOS_Sav.Vbc = ((float)VolADCOneCycSOS_SumI.Vbc)/100;
+  VolADC200msSOS_Sum.Vbc += VolADCOneCycSOS_Sav.Vbc;
+  VolADCOneCycSOS_Sav.Vca = ((float)VolADCOneCycSOS_SumI.Vca)/100;
+  VolADC200msSOS_Sum.Vca += VolADCOneCycSOS_Sav.Vca;
+#else
   VolAFEOneCycSOS_Sav.Van = VolAFEOneCycSOS_Sum.Van;
   VolAFE200msNoFltrSOS_Sum.Van += VolAFEOneCycSOS_Sum.Van;
   VolAFEOneCycSOS_Sav.Vbn = VolAFEOneCycSOS_Sum.Vbn;
@@ -1073,13 +1394,49 @@ __attribute__(( always_inline )) inline void save_OC_SOS(void)
   VolADCOneCycSOS_Sum.Vab = 0;
   VolADCOneCycSOS_Sav.Vbc = VolADCOneCycSOS_Sum.Vbc;
   VolADCOneCycSOS_Sav.Vca = VolADCOneCycSOS_Sum.Vca;
+#endif
   PwrOneCycSOS_Sav.Pa = PwrOneCycSOS_Sum.Pa;
   PwrOneCycSOS_Sav.Pb = PwrOneCycSOS_Sum.Pb;
   PwrOneCycSOS_Sav.Pc = PwrOneCycSOS_Sum.Pc;
   PwrOneCycSOS_Sav.RPa = PwrOneCycSOS_Sum.RPa;
   PwrOneCycSOS_Sav.RPb = PwrOneCycSOS_Sum.RPb;
   PwrOneCycSOS_Sav.RPc = PwrOneCycSOS_Sum.RPc;
-
+#ifdef ENABLE_SEQ_PHASOR
+  for (i=0; i<ONECYC_PHASOR_NUM; ++i)
+  {
+    CurVolOneCycSin_Sav[i] = CurVolOneCycSin_Sum[i];
+    CurVolOneCycCos_Sav[i] = CurVolOneCycCos_Sum[i];
+  }
+  Cur200msNoFltrSinSOS_Sum.Ia += CurVolOneCycSin_Sum[0];
+  Cur200msNoFltrSinSOS_Sum.Ib += CurVolOneCycSin_Sum[1];
+  Cur200msNoFltrSinSOS_Sum.Ic += CurVolOneCycSin_Sum[2];
+  Cur200msNoFltrSinSOS_Sum.In += CurVolOneCycSin_Sum[3];
+  VolAFE200msNoFltrSinSOS_Sum.Van += CurVolOneCycSin_Sum[4];
+  VolAFE200msNoFltrSinSOS_Sum.Vbn += CurVolOneCycSin_Sum[5];
+  VolAFE200msNoFltrSinSOS_Sum.Vcn += CurVolOneCycSin_Sum[6];
+  Cur200msNoFltrCosSOS_Sum.Ia += CurVolOneCycCos_Sum[0];
+  Cur200msNoFltrCosSOS_Sum.Ib += CurVolOneCycCos_Sum[1];
+  Cur200msNoFltrCosSOS_Sum.Ic += CurVolOneCycCos_Sum[2];
+  Cur200msNoFltrCosSOS_Sum.In += CurVolOneCycCos_Sum[3];
+  VolAFE200msNoFltrCosSOS_Sum.Van += CurVolOneCycCos_Sum[4];
+  VolAFE200msNoFltrCosSOS_Sum.Vbn += CurVolOneCycCos_Sum[5];
+  VolAFE200msNoFltrCosSOS_Sum.Vcn += CurVolOneCycCos_Sum[6];
+#endif
+
+#ifdef ENABLE_SIMD_SOS
+  VolAFEOneCycSOS_SumI.Van = 0;                                     // Reset the sums.  Note, the resets
+  VolAFEOneCycSOS_SumI.Vbn = 0;                                     //   are grouped together so that the
+  VolAFEOneCycSOS_SumI.Vcn = 0;                                     //   compiler sets a register to 0 once,
+  VolAFEOneCycSOS_SumI.Vab = 0;                                     //   then writes to each variable.  This
+  VolAFEOneCycSOS_SumI.Vbc = 0;                                     //   saves code space and execution time
+  VolAFEOneCycSOS_SumI.Vca = 0;
+  VolADCOneCycSOS_SumI.Van = 0;
+  VolADCOneCycSOS_SumI.Vbn = 0;
+  VolADCOneCycSOS_SumI.Vcn = 0;
+  VolADCOneCycSOS_SumI.Vab = 0;
+  VolADCOneCycSOS_SumI.Vbc = 0;
+  VolADCOneCycSOS_SumI.Vca = 0;
+#else
   VolAFEOneCycSOS_Sum.Van = 0;                                      // Reset the sums.  Note, the resets     
   VolAFEOneCycSOS_Sum.Vbn = 0;                                      //   are grouped together so that the    
   VolAFEOneCycSOS_Sum.Vcn = 0;                                      //   compiler sets a register to 0 once, 
@@ -1091,12 +1448,20 @@ __attribute__(( always_inline )) inline void save_OC_SOS(void)
   VolADCOneCycSOS_Sum.Vcn = 0;
   VolADCOneCycSOS_Sum.Vbc = 0;
   VolADCOneCycSOS_Sum.Vca = 0;
+#endif
   PwrOneCycSOS_Sum.Pa = 0;
   PwrOneCycSOS_Sum.Pb = 0;
   PwrOneCycSOS_Sum.Pc = 0;
   PwrOneCycSOS_Sum.RPa = 0;
   PwrOneCycSOS_Sum.RPb = 0;
   PwrOneCycSOS_Sum.RPc = 0;
+#ifdef ENABLE_SEQ_PHASOR
+  for (i=0; i<ONECYC_PHASOR_NUM; ++i)
+  {
+    CurVolOneCycSin_Sum[i] = 0;
+    CurVolOneCycCos_Sum[i] = 0;
+  }
+#endif
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -1105,6 +1470,90 @@ __attribute__(( always_inline )) inline void save_OC_SOS(void)
 
 
 
+#ifdef ENABLE_FREQ_TRACK
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        update_FreqTrack()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Update the Zero-Crossing Frequency Tracker In-Line Subroutine
+// 
+//  MECHANICS:          This subroutine is jumped to from the DMA1_Stream0_IRQ (sampling) interrupt service
+//                      routine.  It is defined as an in-line subroutine, and so is jumped to, not called,
+//                      to save overhead time.
+//                      The subroutine looks for a positive-going zero crossing of VanAFE between the
+//                      previous sample and the new one.  A crossing is only used if Van has been below
+//                      -FREQTRK_ARM_V since the last crossing, so that noise around zero does not produce
+//                      extra crossings.  The crossing is located by linear interpolation:
+//                          frac = Van[n-1]/(Van[n-1] - Van[n])     (0 < frac <= 1)
+//                      is the position of the crossing after sample n-1, so the crossing is
+//                      (1 - frac) * FreqTrack.SamplePer before sample n.  FreqTrack.PerTime is the time from
+//                      the last crossing, and is advanced by the sample period every sample, so the period,
+//                      in seconds, is:
+//                          period = PerTime - (1 - frac) * SamplePer
+//                      The period is kept in seconds, rather than samples, so that it is correct even if the
+//                      sample rate is retuned during the period.  The period is added to FreqTrack.PerSum
+//                      and FreqTrack.PerCnt is incremented.  Calc_FreqTrack() reads and resets these each
+//                      cycle.
+//                      If there is no crossing for FREQTRK_MAX_SAMPLES samples, the counter stops, and the
+//                      next crossing only starts a new period.
+//
+//  CAVEATS:            None
+// 
+//  INPUTS:             AFE_new_samples[5], FreqTrack.SamplePer
+// 
+//  OUTPUTS:            FreqTrack.PerSum, FreqTrack.PerCnt
+//
+//  ALTERS:             FreqTrack.SampCtr, FreqTrack.PerTime, FreqTrack.VanPrev, FreqTrack.Start,
+//                      FreqTrack.Armed
+// 
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+__attribute__(( always_inline )) inline void update_FreqTrack(void)
+{
+  float van, t_after;
+
+  van = AFE_new_samples[5];
+  FreqTrack.PerTime += FreqTrack.SamplePer;
+  if (FreqTrack.SampCtr < FREQTRK_MAX_SAMPLES)
+  {
+    ++FreqTrack.SampCtr;
+  }
+  else                                      // No crossing for too long, so the next crossing only starts a
+  {                                         //   period
+    FreqTrack.Start = TRUE;
+  }
+
+  if (van < -FREQTRK_ARM_V)
+  {
+    FreqTrack.Armed = TRUE;
+  }
+  else if ( (FreqTrack.Armed) && (FreqTrack.VanPrev < 0.0f) && (van >= 0.0f) )
+  {
+    t_after = (1.0f - FreqTrack.VanPrev / (FreqTrack.VanPrev - van)) * FreqTrack.SamplePer;
+    if (!FreqTrack.Start)
+    {
+      FreqTrack.PerSum += (FreqTrack.PerTime - t_after);
+      ++FreqTrack.PerCnt;
+    }
+    FreqTrack.Start = FALSE;
+    FreqTrack.PerTime = t_after;              // Time from the crossing to this sample
+    FreqTrack.SampCtr = 1;
+    FreqTrack.Armed = FALSE;
+  }
+  FreqTrack.VanPrev = van;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION        update_FreqTrack()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_FREQ_TRACK
+
+
+
 //------------------------------------------------------------------------------------------------------------
 //             START OF FUNCTION        save_200msec_SOS()
 //------------------------------------------------------------------------------------------------------------
@@ -62,6 +62,9 @@
 //                      - Deleted user capture source definitions since no longer used
 //                      - Deleted user capture type definitions (moved to Meter_def.h)
 //                      - Deleted struct SAMPLE_PACKET definition since it is no longer used
+//  157     240209  DAH - Added struct RAM_SAMPLES_SOA, struct SAMPLE_SPAN, the SampleBuf channel numbers
+//                        (SB_xx), and SAMPLEBUF() to support storing SampleBuf by channel
+//  158     240210  DAH - Added SAMPLEBUF_I16_STRIDE
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -90,6 +93,40 @@
 //   provides 3 x 1/60sec = 50msec to transfer a trip waveform capture to Flash)
 #define TOTAL_SAMPLE_SETS       3120
 
+// SampleBuf channel numbers for SampleBuf_Span().  These are in the same order as the arrays in
+//   struct RAM_SAMPLES_SOA.  The current channels (SB_IA thru SB_IGRES) are floats, the voltage channels
+//   (SB_VANAFE thru SB_VCNADC) are int16's (volts x 10)
+#define SB_IA                   0
+#define SB_IB                   1
+#define SB_IC                   2
+#define SB_IN                   3
+#define SB_IGSRC                4
+#define SB_IGRES                5
+#define SB_VANAFE               6
+#define SB_VBNAFE               7
+#define SB_VCNAFE               8
+#define SB_VANADC               9
+#define SB_VBNADC               10
+#define SB_VCNADC               11
+#define SB_NUM_CHANNELS         12
+
+// SampleBuf access.  SampleBuf is stored either as an array of sample sets (struct RAM_SAMPLES
+//   SampleBuf[]), or if ENABLE_SAMPLE_SOA is defined in Iod_def.h, as one array per channel (struct
+//   RAM_SAMPLES_SOA SampleBuf).  Code that reads or writes individual samples should use SAMPLEBUF() so that
+//   it works with either layout.  Note, Iod_def.h must be included before this file
+#ifdef ENABLE_SAMPLE_SOA
+  #define SAMPLEBUF(ch, ndx)    (SampleBuf.ch[ndx])
+#else
+  #define SAMPLEBUF(ch, ndx)    (SampleBuf[ndx].ch)
+#endif
+
+// Distance between consecutive samples of an int16 (voltage) channel in SampleBuf, in int16's
+#ifdef ENABLE_SAMPLE_SOA
+  #define SAMPLEBUF_I16_STRIDE  1
+#else
+  #define SAMPLEBUF_I16_STRIDE  (sizeof(struct RAM_SAMPLES) / sizeof(int16_t))
+#endif
+
 // Breaker open/close time for advance time calculations based on 35ms open, 40ms close times. 
 // May need to adjust these to account for external relay times, GOOSE messaging, etc.
 #define TIM4_FREQ               1500000
@@ -122,3 +159,34 @@ struct RAM_SAMPLES
     int16_t VcnADC;
 };
 
+// Sample buffer stored by channel (ENABLE_SAMPLE_SOA defined).  This holds the same samples as
+//   struct RAM_SAMPLES SampleBuf[TOTAL_SAMPLE_SETS], and is the same size (112320 bytes), so it also fits in
+//   SRAM1.  The samples of each channel are contiguous, so a window of samples is at most two blocks (if it
+//   wraps around the end of the buffer) and can be processed with the CMSIS block functions without first
+//   being gathered into a separate buffer.  See SampleBuf_Span()
+struct RAM_SAMPLES_SOA
+{
+    float Ia[TOTAL_SAMPLE_SETS];
+    float Ib[TOTAL_SAMPLE_SETS];
+    float Ic[TOTAL_SAMPLE_SETS];
+    float In[TOTAL_SAMPLE_SETS];
+    float Igsrc[TOTAL_SAMPLE_SETS];
+    float Igres[TOTAL_SAMPLE_SETS];
+    int16_t VanAFE[TOTAL_SAMPLE_SETS];
+    int16_t VbnAFE[TOTAL_SAMPLE_SETS];
+    int16_t VcnAFE[TOTAL_SAMPLE_SETS];
+    int16_t VanADC[TOTAL_SAMPLE_SETS];
+    int16_t VbnADC[TOTAL_SAMPLE_SETS];
+    int16_t VcnADC[TOTAL_SAMPLE_SETS];
+};
+
+// Window of samples of one channel in SampleBuf (see SampleBuf_Span()).  Ptr[0] points to the first sample
+//   and Len[0] is the number of samples up to the end of the window or the end of the buffer.  If the
+//   window wraps around the end of the buffer, Ptr[1] points to the start of the buffer and Len[1] is the
+//   number of remaining samples.  Otherwise Ptr[1] and Len[1] are 0
+struct SAMPLE_SPAN
+{
+    void *Ptr[2];
+    uint16_t Len[2];
+};
+
@@ -80,6 +80,13 @@
 //    94    231010  DAH - Deleted UserWF_xx declarations (moved to Meter_ext.h)
 //    98    231017  DAH - Added AlarmHoldOffTmr declaration
 //    135   231221  DAH - Added SampleBufFilled declaration
+//   153    240205  DAH - Replaced the IAR location operator (@".sram1", @".sram2") with SRAM1_LOC and
+//                        SRAM2_LOC so the module can be compiled in the host build
+//   157    240209  DAH - Added SampleBuf_Span(), SampleBuf_GetRecord(), and CAMSampleRec[].  SampleBuf is
+//                        declared as struct RAM_SAMPLES_SOA if ENABLE_SAMPLE_SOA is defined
+//   158    240210  DAH - Added Volt_SOS_Block()
+//   178    240301  DAH - Added forward declaration of struct SAMPLE_SPAN, since modules that include this
+//                        file without Intr_def.h reference it in SampleBuf_Span()
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -102,11 +109,11 @@
 //                    Global Variable Declarations
 //------------------------------------------------------------------------------------------------------------
 //
-extern struct CUR_WITH_G_F CurHalfCycSOS_SumF @".sram2";
-extern struct CUR_WITH_G_F    CurOneCycSOS_SumF @".sram2";
-extern float CurHalfCycSOSmax @".sram2";
-extern float CurOneCycSOSmax @".sram2";
-extern float NewSample @".sram2";
+extern struct CUR_WITH_G_F CurHalfCycSOS_SumF SRAM2_LOC;
+extern struct CUR_WITH_G_F    CurOneCycSOS_SumF SRAM2_LOC;
+extern float CurHalfCycSOSmax SRAM2_LOC;
+extern float CurOneCycSOSmax SRAM2_LOC;
+extern float NewSample SRAM2_LOC;
 extern uint8_t msec200Anniv, OneCycAnniv, OneSecAnniv, min5Anniv;
 extern uint8_t TA_Timer;
 
@@ -120,8 +127,13 @@ extern uint8_t Prot_Enabled;
 extern uint8_t GF_Enabled;
 extern float TestSamples[4][800];
 
-extern struct RAM_SAMPLES SampleBuf[] @ ".sram1";
-extern uint16_t SampleIndex @".sram2";
+#ifdef ENABLE_SAMPLE_SOA
+  extern struct RAM_SAMPLES_SOA SampleBuf SRAM1_LOC;
+  extern struct RAM_SAMPLES CAMSampleRec[2] SRAM2_LOC;
+#else
+  extern struct RAM_SAMPLES SampleBuf[] SRAM1_LOC;
+#endif
+extern uint16_t SampleIndex SRAM2_LOC;
 
 extern uint16_t coil_temp_samples[200];
 
@@ -149,4 +161,13 @@ extern uint8_t SampleBufFilled;
 //
 extern void Intr_VarInit(void);
 extern void ResetMinMaxValues(void);
+#ifdef ENABLE_SAMPLE_SOA
+  struct SAMPLE_SPAN;
+  extern uint8_t SampleBuf_Span(uint8_t chan, uint16_t start, uint16_t len, struct SAMPLE_SPAN *sptr);
+  extern void SampleBuf_GetRecord(uint16_t ndx, struct RAM_SAMPLES *rptr);
+#endif
+#ifdef ENABLE_SIMD_SOS
+  extern void Volt_SOS_Block(const int16_t *va, const int16_t *vb, const int16_t *vc, uint16_t stride,
+                             uint16_t len, struct VOLTAGES_I *sptr);
+#endif
 
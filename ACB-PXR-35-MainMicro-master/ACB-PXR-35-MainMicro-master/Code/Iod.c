@@ -436,6 +436,43 @@
 //                      - Revised Flash_Read_ID() to store value in union Flash_ID
 //                      - Revised ProcessTimeAdjustment() to set SKIP_LOOPTIME_MEAS flag
 //   144    240123  DAH - In ReadAFECalConstants1(), corrected bug checking the checksum when FRAM was read
+//   157    240209  DAH - Added Flash_WriteSampleSets() and revised Flash_WriteWaveform() to write the
+//                        sample sets from SampleBuf if it is stored by channel (ENABLE_SAMPLE_SOA defined)
+//   160    240212  DAH - Revised ReadAFECalConstants(), ReadADCHCalConstants(), and ReadADCLCalConstants()
+//                        to call Apply_CalConstants()
+//   163    240215  DAH - Added the SPI2 transaction engine (ENABLE_SPI2_DMA defined)
+//                          - Added SPI2_VarInit(), SPI2_Submit(), SPI2_Wait(), SPI2_Flush(),
+//                            SPI2_XactService(), SPI2_StartXact(), SPI2_StartData(), SPI2_Finish(),
+//                            SPI2_SetWidth(), SPI2_CsActive(), SPI2_CsInactive(), SPI2_Xfer(),
+//                            SPI2_EnergySeg()
+//                          - Added SPI2Eng, SPI2Post[], SPI2PostNdx, SPI2EnergyXact, SPI2EnergyBuf[]
+//                          - Revised FRAM_Read(), Frame_FRAM_Read(), Frame_FRAM_Write(), FRAM_WriteMinMax(),
+//                            and FRAM_ReadEnergy() to run through the engine instead of polling SPI2
+//                          - Revised FRAM_Write() to post short writes and FRAM_WriteEnergy() to post the
+//                            energy write, so they return before the write is done
+//                          - Revised FRAM_Clean(), ExtCapt_FRAM_Read(), ExtCapt_FRAM_Write(),
+//                            FRAM_Stat_Write(), and EEPOT_Xfer() to flush the engine before using SPI2
+//                          - Revised IO_VarInit() to call SPI2_VarInit()
+//   164    240216  DAH - Added the SPI1 Flash waveform pipeline (ENABLE_SPI1_DMA defined)
+//                          - Added Flash_PipeService(), Flash_PipeGather(), Flash_PipeStart(),
+//                            Flash_PipeDone(), Flash_PipeStatus()
+//                          - Added FlashPipe and FlashPgBuf[][]
+//                          - Revised Flash_WriteWaveform() to write the waveform with the pipeline.  The
+//                            page data is sent by DMA2 Stream 3 instead of polling SPI1 for each word
+//                          - Revised IO_VarInit() to initialize FlashPipe
+//   165    240217  DAH - Added the coded waveform captures (ENABLE_WF_CODEC defined, see WfCodec.c)
+//                          - Added Flash_PipeCode(), FlashCodecPgBuf[][], WfCodecStage[], and WfCodecIndex[].
+//                            Flash_PipeGather() and FlashPgBuf[][] are not included with the codec
+//                          - Revised Flash_WriteWaveform(), Flash_PipeService(), and Flash_PipeStart() to
+//                            write the coded pages and the capture index
+//                          - Revised SPI1_Flash_Manager() to skip the second block erase of the waveform
+//                            captures, and to decode the waveforms for the test port and display processor
+//                            reads (states S1F_TP_READ and S1F_DP_READ_WF)
+//                          - Revised Flash_Read() to read from the Flash model in the host build
+//   179    240302  DAH - ReadAFECalConstants(), ReadADCHCalConstants(), and ReadADCLCalConstants()
+//                        descriptions revised (the coefficients are only used if ENABLE_CAL_BIAS is defined)
+//                      - Revised SPI1_Flash_Manager() to erase the second block of the waveform captures if
+//                        the coded captures may use it (WF_CODEC_SLOT_BLOCKS = 2, see WfCodec_def.h)
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -475,6 +512,7 @@
 #include "DispComm_def.h"
 #include "Prot_def.h"
 #include "Flags_def.h"
+#include "WfCodec_def.h"
 #include "string.h"
 //
 //      Local Definitions used in this module...
@@ -500,6 +538,7 @@
 #include "Setpnt_ext.h"
 #include "can_tasks_ext.h"
 #include "Modbus_ext.h"
+#include "WfCodec_ext.h"
 
 
 //      Global (Visible) Function Prototypes (These functions are called by other modules)
@@ -551,6 +590,15 @@ void FRAM_WriteEnergy(uint8_t device);
 void FRAM_WriteMinMax(uint32_t fram_address, uint16_t length, uint16_t *inptr);
 void Frame_FRAM_Write(uint16_t fram_address, uint16_t length, uint8_t *inptr);
 void MM_Status_Update(void);
+#ifdef ENABLE_SPI2_DMA
+  void SPI2_Submit(struct SPI2_XACT *xptr);
+  void SPI2_Wait(struct SPI2_XACT *xptr);
+  void SPI2_Flush(void);
+  void SPI2_XactService(void);
+#endif
+#ifdef ENABLE_SPI1_DMA
+  void Flash_PipeDone(void);
+#endif
 
 
 
@@ -561,8 +609,33 @@ uint32_t FRAM_XferR(uint8_t len, uint16_t *dptr, uint32_t *chkptr);
 uint8_t StoreCalFlash(uint8_t mtr_cal);
 void ReadStartupScaleConstant(void);
 uint8_t Flash_WriteWaveform(struct FLASH_INT_REQ *WF_Struct, uint8_t WF_Abort);
+#ifdef ENABLE_SAMPLE_SOA
+  void Flash_WriteSampleSets(uint8_t num_sets);
+#endif
 uint8_t Flash_EraseBlock(uint16_t flash_addr);
 uint8_t Flash_EraseSectorBlock(uint16_t flash_addr, uint8_t SectorErase);
+#ifdef ENABLE_SPI2_DMA
+  void SPI2_VarInit(void);
+  void SPI2_StartXact(uint8_t opcode);
+  void SPI2_StartData(struct SPI2_XACT *xptr);
+  void SPI2_Finish(void);
+  void SPI2_SetWidth(uint8_t width);
+  void SPI2_CsActive(uint8_t device);
+  void SPI2_CsInactive(uint8_t device);
+  void SPI2_Xfer(uint8_t device, uint8_t op, uint8_t width, uint32_t fram_address, uint16_t length,
+                 void *dptr);
+  void SPI2_EnergySeg(struct SPI2_XACT *xptr, uint32_t *chkptr);
+#endif
+#ifdef ENABLE_SPI1_DMA
+  uint8_t Flash_PipeService(struct FLASH_INT_REQ *WF_Struct, uint8_t WF_Abort);
+  #ifdef ENABLE_WF_CODEC
+    uint8_t Flash_PipeCode(void);
+  #else
+    uint8_t Flash_PipeGather(void);
+  #endif
+  void Flash_PipeStart(uint16_t flash_addr);
+  uint8_t Flash_PipeStatus(void);
+#endif
 
 void RelayManagement(void);
 void InitRelays(void);
@@ -582,6 +655,12 @@ uint8_t TP_LEDCode;
 
 struct SPI1VARS SPI1Flash;
 uint8_t SPI2_buf[450];
+#ifdef ENABLE_SPI2_DMA
+  struct SPI2_ENGINE SPI2Eng;
+#endif
+#ifdef ENABLE_SPI1_DMA
+  struct FLASH_PIPE FlashPipe;
+#endif
 struct TH_SENSOR THSensor;
 uint16_t SystemFlags;
 struct FLASH_INT_REQ Trip_WF_Capture, Alarm_WF_Capture, Ext_WF_Capture;
@@ -612,6 +691,22 @@ uint8_t FSBE_State;
 uint8_t FWW_State;
 uint16_t SBout_Index;
 uint16_t *SBout_ptr;
+#ifdef ENABLE_SAMPLE_SOA
+  struct RAM_SAMPLES SBout_Rec;         // Sample set being written to Flash (see Flash_WriteSampleSets())
+#endif
+#ifdef ENABLE_SPI2_DMA
+  struct SPI2_POST SPI2Post[SPI2_POST_SLOTS];       // Posted FRAM writes (see FRAM_Write())
+  uint8_t SPI2PostNdx;
+  struct SPI2_XACT SPI2EnergyXact;                  // Posted energy write (see FRAM_WriteEnergy())
+  uint32_t SPI2EnergyBuf[ENERGY_SIZE >> 2];
+#endif
+#ifdef ENABLE_WF_CODEC
+  uint16_t FlashCodecPgBuf[2][128];                 // Flash page buffers (see Flash_PipeCode())
+  uint8_t WfCodecStage[WF_CODEC_STAGE_SIZE];        // Coded bytes waiting to be gathered into pages
+  struct WF_CODEC_DIR WfCodecIndex[WF_CODEC_CYCLES];    // Index of the capture being written
+#elif defined(ENABLE_SPI1_DMA)
+  struct RAM_SAMPLES FlashPgBuf[2][FLASH_PG_SETS];  // Flash page buffers (see Flash_PipeGather())
+#endif
 
 uint8_t MB_Addr;                     // *** DAH  ADDED FOR TEST
 uint8_t MB_Par;
@@ -742,11 +837,11 @@ const uint16_t WF_ADDRESS[36][4] = {        0, 0,                             11
 //
 //  OUTPUTS:            StatusLED_BlinkCtr, TP_LEDCode, SPI1Flash.xxx, SCF_State, SystemFlags, HLTH_I2C.xx,
 //                      FrameEEPOT.State, StartupTime.xx, FPW_State, FSE_State, FSBE_State, FWW_State,
-//                      HighLoadLED_BlinkCtr, THSensor.xx
+//                      HighLoadLED_BlinkCtr, THSensor.xx, FlashPipe.xx (if ENABLE_SPI1_DMA is defined)
 //
 //  ALTERS:             None
 //
-//  CALLS:              ReadStartupScaleConstant()
+//  CALLS:              SPI2_VarInit() (if ENABLE_SPI2_DMA is defined), ReadStartupScaleConstant()
 //
 //  EXECUTION TIME:     Measured on 160625 (rev 0.25 code): 56.1usec    *** DAH  CAN REMEASURE SINCE SOME CODE REMOVED (SHOULD BE FASTER)
 //
@@ -754,6 +849,9 @@ const uint16_t WF_ADDRESS[36][4] = {        0, 0,                             11
 
 void IO_VarInit(void)
 {
+#ifdef ENABLE_SPI2_DMA
+  SPI2_VarInit();                       // This must be first, since the FRAM is read below
+#endif
   StatusLED_BlinkCtr = 0;               // Initialize LED blink counter to 0
   HighLoadLED_BlinkCtr = 0;             // Initialize LED blink counter to 0
   TP_LEDCode = 0;                       // Initialize LED test inputs to 0
@@ -769,6 +867,16 @@ void IO_VarInit(void)
   FSE_State = 0;
   FSBE_State = 0;
   FWW_State = 0;
+#ifdef ENABLE_SPI1_DMA
+  FlashPipe.DmaBusy = FALSE;
+  FlashPipe.Programming = FALSE;
+  FlashPipe.PgPolls = 0;
+  FlashPipe.PollArr = TIM10_ARR_20USEC;
+  FlashPipe.WaitArr = TIM10_ARR_1500USEC;
+  FlashPipe.Pages = 0;
+  FlashPipe.BusyPolls = 0;
+  FlashPipe.Stalls = 0;
+#endif
 
   HLTH_I2C.State = 0;
   HLTH_I2C.IntState = I2C3_IDLE;
@@ -1615,6 +1723,9 @@ void FRAM_Clean(uint16_t device, uint32_t fram_address, uint16_t length)
   uint16_t i;
   volatile uint16_t temp;
 
+#ifdef ENABLE_SPI2_DMA
+  SPI2_Flush();                         // Let the queued FRAM transactions finish before using SPI2
+#endif
   Init_SPI2(DEV_FRAM_FLASH8);           // Initialize SPI to output bytes
 
                                         // Send out a WRITE ENABLE instruction
@@ -1739,6 +1850,9 @@ void ExtCapt_FRAM_Read(uint16_t fram_address, uint16_t length, uint16_t *outptr)
   uint16_t i;
   volatile uint8_t temp;
 
+#ifdef ENABLE_SPI2_DMA
+  SPI2_Flush();                         // Let the queued FRAM transactions finish before using SPI2
+#endif
   Init_SPI2(DEV_FRAM_FLASH8);           // Initialize SPI to output bytes for Frame FRAM
   FRAM1_CSN_ACTIVE;                     // Select the FRAM device (Chip select set-up time= 10ns)
 
@@ -1816,6 +1930,9 @@ void ExtCapt_FRAM_Write(uint32_t fram_address, uint16_t length, uint16_t *inptr)
   uint16_t i;
   volatile uint16_t temp;
 
+#ifdef ENABLE_SPI2_DMA
+  SPI2_Flush();                         // Let the queued FRAM transactions finish before using SPI2
+#endif
   Init_SPI2(DEV_FRAM_FLASH8);           // Initialize SPI to output bytes
   FRAM1_CSN_ACTIVE;                     // Select the FRAM device (Chip select set-up time= 10ns)
 
@@ -1879,6 +1996,784 @@ void ExtCapt_FRAM_Write(uint32_t fram_address, uint16_t length, uint16_t *inptr)
 
 
 
+#ifdef ENABLE_SPI2_DMA
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        SPI2_VarInit()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           SPI2 Transaction Engine Initialization
+//
+//  MECHANICS:          This subroutine initializes the SPI2 transaction engine.  The queue is emptied, the
+//                      posted write slots are freed, and SPI2 is initialized for 16-bit FRAM transfers.
+//                      This is the only place that the FRAM code calls Init_SPI2().  The engine only
+//                      rewrites the SPI2 configuration register (SPI2_SetWidth()) when the frame width
+//                      changes.
+//
+//  CAVEATS:            Call only during initialization, before any of the FRAM subroutines are called
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            SPI2Eng.xx, SPI2Post[].Xact.Status, SPI2PostNdx, SPI2EnergyXact.Status
+//
+//  ALTERS:             None
+//
+//  CALLS:              Init_SPI2()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void SPI2_VarInit(void)
+{
+  uint8_t i;
+
+  SPI2Eng.Head = 0;
+  SPI2Eng.Tail = 0;
+  SPI2Eng.Phase = SPI2_PH_IDLE;
+  SPI2Eng.Xacts = 0;
+  for (i=0; i<SPI2_POST_SLOTS; ++i)
+  {
+    SPI2Post[i].Xact.Status = SPI2_XS_IDLE;
+  }
+  SPI2PostNdx = 0;
+  SPI2EnergyXact.Status = SPI2_XS_IDLE;
+
+  Init_SPI2(DEV_FRAM_FLASH16);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          SPI2_VarInit()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        SPI2_Submit()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Submit an SPI2 Transaction
+//
+//  MECHANICS:          This subroutine adds a transaction to the SPI2 queue.  The opcode and address frames
+//                      are built here:
+//                          16-bit (on-board FRAM): (opcode << 8) | address b23..16, address b15..0
+//                          8-bit (Frame FRAM):     opcode, address b15..8, address b7..0
+//                      If the engine is idle, the transaction is started immediately.  Otherwise it is
+//                      started by the SPI2 or DMA1 Stream 4 interrupt when the transactions ahead of it are
+//                      done.  Transactions are done in the order they are submitted, so a read that is
+//                      submitted after a posted write returns the written data.
+//                      If the queue is full, the engine is run from here until a place is free.
+//
+//  CAVEATS:            The transaction (and its data) must not be changed until xptr->Status is
+//                      SPI2_XS_DONE.  Use SPI2_Wait() to wait for it.
+//                      May be called from the main loop or from an interrupt of lower priority than the
+//                      engine interrupts (TIM10)
+//
+//  INPUTS:             xptr - the transaction
+//
+//  OUTPUTS:            SPI2Eng.Queue[], SPI2Eng.Tail, xptr->Status
+//
+//  ALTERS:             None
+//
+//  CALLS:              SPI2_XactService(), SPI2_StartXact(), __get_PRIMASK(), __disable_irq(),
+//                      __set_PRIMASK()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void SPI2_Submit(struct SPI2_XACT *xptr)
+{
+  uint32_t primask;
+  uint8_t opcode;
+
+  opcode = ((xptr->Op == SPI2_OP_WRITE) ? FRAM_WRITE : FRAM_READ);
+  xptr->Status = SPI2_XS_QUEUED;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  while ( ((SPI2Eng.Tail + 1) & (SPI2_QUEUE_SIZE - 1)) == SPI2Eng.Head )
+  {                                     // If the queue is full, run the engine until a place is free
+    SPI2_XactService();
+  }
+  SPI2Eng.Queue[SPI2Eng.Tail] = xptr;
+  SPI2Eng.Tail = ((SPI2Eng.Tail + 1) & (SPI2_QUEUE_SIZE - 1));
+
+  if (SPI2Eng.Phase == SPI2_PH_IDLE)    // If the engine is idle, start the transaction now
+  {
+    SPI2_StartXact(opcode);
+  }
+  __set_PRIMASK(primask);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          SPI2_Submit()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        SPI2_Wait()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Wait for an SPI2 Transaction
+//
+//  MECHANICS:          This subroutine waits until a transaction is done.  Normally the engine is run by
+//                      the SPI2 and DMA1 Stream 4 interrupts, and this subroutine just waits for the status
+//                      to change.  If interrupts are disabled (during initialization, for example), the
+//                      engine interrupts cannot run, so the engine is run from here instead.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             xptr - the transaction
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              SPI2_XactService(), __get_PRIMASK()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void SPI2_Wait(struct SPI2_XACT *xptr)
+{
+  if (__get_PRIMASK())
+  {
+    while ( (xptr->Status == SPI2_XS_QUEUED) || (xptr->Status == SPI2_XS_ACTIVE) )
+    {
+      SPI2_XactService();
+    }
+  }
+  else
+  {
+    while ( (xptr->Status == SPI2_XS_QUEUED) || (xptr->Status == SPI2_XS_ACTIVE) )
+    {
+    }
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          SPI2_Wait()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        SPI2_Flush()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Flush the SPI2 Transaction Queue
+//
+//  MECHANICS:          This subroutine waits until all of the queued transactions (including the posted
+//                      writes) are done.  It must be called before any subroutine that accesses SPI2
+//                      directly (FRAM_Clean(), FRAM_Stat_Write(), ExtCapt_FRAM_Read(), ExtCapt_FRAM_Write(),
+//                      EEPOT_Xfer()), since these reinitialize SPI2 and drive the chip selects themselves.
+//
+//  CAVEATS:            Interrupts are disabled while the engine is run from here
+//
+//  INPUTS:             SPI2Eng.Phase
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              SPI2_XactService(), __get_PRIMASK(), __disable_irq(), __set_PRIMASK()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void SPI2_Flush(void)
+{
+  uint32_t primask;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  while (SPI2Eng.Phase != SPI2_PH_IDLE)
+  {
+    SPI2_XactService();
+  }
+  __set_PRIMASK(primask);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          SPI2_Flush()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        SPI2_XactService()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           SPI2 Transaction Engine
+//
+//  MECHANICS:          This subroutine advances the transaction at the head of the queue by one step.  It
+//                      is called from the SPI2 interrupt (RXNE), the DMA1 Stream 4 interrupt (transfer
+//                      complete), and from SPI2_Wait(), SPI2_Flush(), and SPI2_Submit() when interrupts are
+//                      disabled.  Each step checks its own completion flag, so a call when nothing is
+//                      ready does nothing.
+//                          SPI2_PH_WREN:  The write enable opcode has been sent.  The chip select is
+//                                         released for the deselect time and then set again, the frame
+//                                         width is set for the transaction, and the first header frame is
+//                                         sent
+//                          SPI2_PH_HDR:   A header frame has been sent.  The next one is sent, or when the
+//                                         header is done, the data transfer is started
+//                          SPI2_PH_RDATA: A data frame has been received.  It is stored, and the next frame
+//                                         is clocked in.  Each frame takes about 1usec (16 bits at 15MHz)
+//                          SPI2_PH_WDATA: The DMA has loaded the last frame of a segment into SPI2.  The
+//                                         next segment is started, or the transaction is finished
+//
+//  CAVEATS:            Must be called with the engine interrupts held off (that is, from the engine
+//                      interrupts or with interrupts disabled)
+//
+//  INPUTS:             SPI2Eng.xx, SPI2->SR, DMA1->HISR
+//
+//  OUTPUTS:            SPI2Eng.xx, the transaction data
+//
+//  ALTERS:             SPI2->DR, SPI2->CR2, DMA1->HIFCR
+//
+//  CALLS:              SPI2_CsActive(), SPI2_CsInactive(), SPI2_SetWidth(), SPI2_StartData(),
+//                      SPI2_NextSeg(), SPI2_Finish()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void SPI2_XactService(void)
+{
+  struct SPI2_XACT *xptr;
+  struct SPI2_SEG *sptr;
+  uint16_t rxdata;
+  volatile uint8_t i;
+
+  xptr = SPI2Eng.Queue[SPI2Eng.Head];
+
+  switch (SPI2Eng.Phase)
+  {
+    case SPI2_PH_WREN:                  // Write enable opcode sent
+      if (!(SPI2->SR & SPI_SR_RXNE))
+      {
+        break;
+      }
+      rxdata = SPI2->DR;                // Clear RXNE flag by reading data reg
+      while (SPI2->SR & SPI_SR_BSY)     // Wait for the last clock edge before releasing the chip select
+      {
+      }
+      SPI2_CsInactive(xptr->Device);    // Deselect the FRAM device (Chip select hold time= 10ns)
+      i = 2;                            // Delay at least 50nsec deselect time.  Measured on 151026: 120nsec
+      while (i > 0)
+      {
+        --i;
+      }
+      SPI2_SetWidth(xptr->Width);
+      SPI2_CsActive(xptr->Device);      // Select the FRAM device (Chip select set-up time= 10ns)
+      SPI2Eng.Phase = SPI2_PH_HDR;
+      SPI2Eng.HdrNdx = 1;
+      SPI2->DR = SPI2Eng.Hdr[0];        // Send the write opcode
+      break;
+
+    case SPI2_PH_HDR:                   // Header frame sent
+      if (!(SPI2->SR & SPI_SR_RXNE))
+      {
+        break;
+      }
+      rxdata = SPI2->DR;                // Clear RXNE flag by reading data reg
+      if (SPI2Eng.HdrNdx < SPI2Eng.HdrLen)
+      {
+        SPI2->DR = SPI2Eng.Hdr[SPI2Eng.HdrNdx++];
+      }
+      else
+      {
+        SPI2Eng.Seg = 0;
+        SPI2_StartData(xptr);
+      }
+      break;
+
+    case SPI2_PH_RDATA:                 // Read data frame received
+      if (!(SPI2->SR & SPI_SR_RXNE))
+      {
+        break;
+      }
+      rxdata = SPI2->DR;                // Capture the data and clear the RXNE flag
+      sptr = &xptr->Seg[SPI2Eng.Seg];
+      if (xptr->Width == SPI2_16BIT)
+      {
+        ((uint16_t *)sptr->Ptr)[SPI2Eng.Ndx] = rxdata;
+      }
+      else
+      {
+        ((uint8_t *)sptr->Ptr)[SPI2Eng.Ndx] = (uint8_t)rxdata;
+      }
+      if (++SPI2Eng.Ndx < sptr->Len)
+      {
+        SPI2->DR = 0;                   // Clock in the next frame
+      }
+      else
+      {
+        ++SPI2Eng.Seg;
+        SPI2_StartData(xptr);
+      }
+      break;
+
+    case SPI2_PH_WDATA:                 // Write data segment loaded by the DMA
+      if (!(DMA1->HISR & DMA_HISR_TCIF4))
+      {
+        break;
+      }
+      DMA1->HIFCR = 0x0000003D;         // Clear the Stream 4 flags (b5..2, b0)
+      ++SPI2Eng.Seg;
+      SPI2_StartData(xptr);
+      break;
+
+    default:                            // SPI2_PH_IDLE: nothing in progress
+      break;
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          SPI2_XactService()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        SPI2_StartXact()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Start the SPI2 Transaction at the Head of the Queue
+//
+//  MECHANICS:          This subroutine builds the header frames for the transaction at the head of the
+//                      queue and starts it.  A write starts with the write enable opcode, sent in 8-bit
+//                      mode with its own chip select.  A read starts with the header.  The SPI2 RXNE
+//                      interrupt is enabled for the opcode and header frames.
+//                      In the host build there is no SPI2 hardware, so the whole transaction is run
+//                      through the FRAM model in HostShim.c (Host_FramFrame()), and finished immediately.
+//
+//  CAVEATS:            Called with the engine interrupts held off, and only if the queue is not empty
+//
+//  INPUTS:             opcode - FRAM_READ or FRAM_WRITE
+//                      SPI2Eng.Queue[SPI2Eng.Head]
+//
+//  OUTPUTS:            SPI2Eng.xx, xptr->Status
+//
+//  ALTERS:             SPI2->DR, SPI2->CR2
+//
+//  CALLS:              SPI2_SetWidth(), SPI2_CsActive(), SPI2_Finish(), Host_FramSelect(),
+//                      Host_FramFrame(), Host_FramDeselect()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void SPI2_StartXact(uint8_t opcode)
+{
+  struct SPI2_XACT *xptr;
+#ifdef HOST_BUILD
+  uint16_t i, j;
+  uint16_t frame;
+#endif
+
+  xptr = SPI2Eng.Queue[SPI2Eng.Head];
+  xptr->Status = SPI2_XS_ACTIVE;
+
+  if (xptr->Width == SPI2_16BIT)        // On-board FRAM: 24-bit address
+  {
+    SPI2Eng.Hdr[0] = (((uint16_t)opcode) << 8) | (uint16_t)((xptr->Addr >> 16) & 0x000000FF);
+    SPI2Eng.Hdr[1] = (uint16_t)xptr->Addr;
+    SPI2Eng.HdrLen = 2;
+  }
+  else                                  // Frame FRAM: 16-bit address
+  {
+    SPI2Eng.Hdr[0] = opcode;
+    SPI2Eng.Hdr[1] = (uint8_t)(xptr->Addr >> 8);
+    SPI2Eng.Hdr[2] = (uint8_t)xptr->Addr;
+    SPI2Eng.HdrLen = 3;
+  }
+
+#ifdef HOST_BUILD
+  SPI2Eng.Phase = SPI2_PH_HDR;
+  if (xptr->Op == SPI2_OP_WRITE)
+  {
+    Host_FramSelect(xptr->Device);
+    Host_FramFrame(0, FRAM_WREN);
+    Host_FramDeselect();
+  }
+  Host_FramSelect(xptr->Device);
+  for (i=0; i<SPI2Eng.HdrLen; ++i)
+  {
+    Host_FramFrame(xptr->Width, SPI2Eng.Hdr[i]);
+  }
+  for (i=0; i<xptr->NumSegs; ++i)
+  {
+    for (j=0; j<xptr->Seg[i].Len; ++j)
+    {
+      if (xptr->Op == SPI2_OP_READ)
+      {
+        frame = Host_FramFrame(xptr->Width, 0);
+        if (xptr->Width == SPI2_16BIT)
+        {
+          ((uint16_t *)xptr->Seg[i].Ptr)[j] = frame;
+        }
+        else
+        {
+          ((uint8_t *)xptr->Seg[i].Ptr)[j] = (uint8_t)frame;
+        }
+      }
+      else
+      {
+        frame = ( (xptr->Width == SPI2_16BIT) ?
+                        ((uint16_t *)xptr->Seg[i].Ptr)[j] : ((uint8_t *)xptr->Seg[i].Ptr)[j] );
+        Host_FramFrame(xptr->Width, frame);
+      }
+    }
+  }
+  Host_FramDeselect();
+  SPI2_Finish();
+#else
+  SPI2->CR2 |= SPI_CR2_RXNEIE;          // Opcode and header frames are interrupt driven
+  if (xptr->Op == SPI2_OP_WRITE)        // Write: send the write enable opcode first
+  {
+    SPI2_SetWidth(SPI2_8BIT);
+    SPI2_CsActive(xptr->Device);        // Select the FRAM device (Chip select set-up time= 10ns)
+    SPI2Eng.Phase = SPI2_PH_WREN;
+    SPI2->DR = FRAM_WREN;
+  }
+  else                                  // Read: send the read opcode and address
+  {
+    SPI2_SetWidth(xptr->Width);
+    SPI2_CsActive(xptr->Device);        // Select the FRAM device (Chip select set-up time= 10ns)
+    SPI2Eng.Phase = SPI2_PH_HDR;
+    SPI2Eng.HdrNdx = 1;
+    SPI2->DR = SPI2Eng.Hdr[0];
+  }
+#endif
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          SPI2_StartXact()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        SPI2_StartData()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Start the Next SPI2 Data Segment
+//
+//  MECHANICS:          This subroutine starts the transfer of data segment SPI2Eng.Seg (empty segments are
+//                      skipped), or finishes the transaction if there are no more segments.
+//                          Read:  The first frame is clocked in.  The rest are clocked in by the SPI2 RXNE
+//                                 interrupt.  There is no receive DMA available for SPI2 (its only receive
+//                                 request is DMA1 Stream 3, which is used by the 61850 port UART3 Tx)
+//                          Write: DMA1 Stream 4 Channel 0 (SPI2_TX) sends the segment.  The SPI2 RXNE
+//                                 interrupt is disabled while the DMA runs, and the DMA transfer complete
+//                                 interrupt moves on to the next segment
+//
+//  CAVEATS:            Called with the engine interrupts held off
+//
+//  INPUTS:             xptr - the transaction
+//                      SPI2Eng.Seg
+//
+//  OUTPUTS:            SPI2Eng.Seg, SPI2Eng.Ndx, SPI2Eng.Phase
+//
+//  ALTERS:             SPI2->DR, SPI2->CR2, DMA1_Stream4 registers, DMA1->HIFCR
+//
+//  CALLS:              SPI2_Finish()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void SPI2_StartData(struct SPI2_XACT *xptr)
+{
+  struct SPI2_SEG *sptr;
+
+  while ( (SPI2Eng.Seg < xptr->NumSegs) && (xptr->Seg[SPI2Eng.Seg].Len == 0) )
+  {
+    ++SPI2Eng.Seg;
+  }
+  if (SPI2Eng.Seg >= xptr->NumSegs)     // If no more data, finish the transaction
+  {
+    SPI2_Finish();
+    return;
+  }
+
+  sptr = &xptr->Seg[SPI2Eng.Seg];
+  SPI2Eng.Ndx = 0;
+  if (xptr->Op == SPI2_OP_READ)
+  {
+    SPI2Eng.Phase = SPI2_PH_RDATA;
+    SPI2->DR = 0;                       // Clock in the first frame
+  }
+  else
+  {
+    SPI2Eng.Phase = SPI2_PH_WDATA;
+    SPI2->CR2 &= (~SPI_CR2_RXNEIE);     // Receive data is ignored while the DMA runs
+    DMA1_Stream4->CR &= 0xF0000000;     // Make sure the stream is disabled before configuring it
+    while (DMA1_Stream4->CR & 0x00000001)
+    {
+    }
+    DMA1->HIFCR = 0x0000003D;           // Clear the Stream 4 flags (b5..2, b0)
+    DMA1_Stream4->CR |= ((xptr->Width == SPI2_16BIT) ? SPI2_DMA_CR16 : SPI2_DMA_CR8);
+    DMA1_Stream4->M0AR = (uint32_t)sptr->Ptr;
+    DMA1_Stream4->NDTR = sptr->Len;
+    DMA1_Stream4->CR |= 0x00000001;     // Enable the stream
+    SPI2->CR2 |= SPI_CR2_TXDMAEN;       // Enable the SPI2 Tx DMA request to start the transfer
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          SPI2_StartData()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        SPI2_Finish()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Finish the SPI2 Transaction at the Head of the Queue
+//
+//  MECHANICS:          This subroutine waits for the last frame to be shifted out, releases the chip
+//                      select, marks the transaction done, calls its completion callback, and starts the
+//                      next queued transaction.  After a DMA write, the receive overrun that was caused by
+//                      not reading the receive data is cleared (read DR, then SR).
+//
+//  CAVEATS:            Called with the engine interrupts held off.  After a DMA write, it waits for up to
+//                      two frames (about 2usec) for SPI2 to finish shifting out the data
+//
+//  INPUTS:             SPI2Eng.xx
+//
+//  OUTPUTS:            SPI2Eng.xx, xptr->Status
+//
+//  ALTERS:             SPI2->CR2
+//
+//  CALLS:              SPI2_CsInactive(), SPI2_StartXact(), xptr->Done()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void SPI2_Finish(void)
+{
+  struct SPI2_XACT *xptr;
+#ifndef HOST_BUILD
+  volatile uint16_t temp;
+#endif
+
+  xptr = SPI2Eng.Queue[SPI2Eng.Head];
+
+#ifndef HOST_BUILD
+  while ( (SPI2->SR & (SPI_SR_TXE + SPI_SR_BSY)) != SPI_SR_TXE )
+  {                                     // Wait for the last frame to be shifted out
+  }
+  SPI2->CR2 &= (~(SPI_CR2_TXDMAEN + SPI_CR2_RXNEIE));
+  temp = SPI2->DR;                      // Clear RXNE and OVR flags by reading data reg then status reg
+  temp = SPI2->SR;
+  SPI2_CsInactive(xptr->Device);        // Deselect the FRAM device (Chip select hold time= 10ns)
+#endif
+
+  SPI2Eng.Head = ((SPI2Eng.Head + 1) & (SPI2_QUEUE_SIZE - 1));
+  SPI2Eng.Phase = SPI2_PH_IDLE;
+  ++SPI2Eng.Xacts;
+  xptr->Status = SPI2_XS_DONE;
+  if (xptr->Done != 0)
+  {
+    xptr->Done(xptr);
+  }
+
+  if (SPI2Eng.Head != SPI2Eng.Tail)     // Start the next transaction
+  {
+    xptr = SPI2Eng.Queue[SPI2Eng.Head];
+    SPI2_StartXact( (xptr->Op == SPI2_OP_WRITE) ? FRAM_WRITE : FRAM_READ );
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          SPI2_Finish()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        SPI2_SetWidth()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Set the SPI2 Frame Width
+//
+//  MECHANICS:          This subroutine sets SPI2 up for 8-bit or 16-bit FRAM frames.  SPI2 is disabled
+//                      while the frame width is changed, as required by RM0090.  The configuration is the
+//                      same as in Init_SPI2() (DEV_FRAM_FLASH8 and DEV_FRAM_FLASH16), but the peripheral is
+//                      not reset, so it is much faster.
+//
+//  CAVEATS:            SPI2 must not be busy
+//
+//  INPUTS:             width - SPI2_8BIT or SPI2_16BIT
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             SPI2->CR1
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void SPI2_SetWidth(uint8_t width)
+{
+  SPI2->CR1 &= (~SPI_CR1_SPE);
+  SPI2->CR1 = ( (width == SPI2_16BIT) ? 0x0B07 : 0x0307 );
+  SPI2->CR1 |= SPI_CR1_SPE;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          SPI2_SetWidth()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        SPI2_CsActive(), SPI2_CsInactive()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Set and Release the FRAM Chip Selects
+//
+//  MECHANICS:          These subroutines select and deselect the FRAM for a transaction.  If the device is
+//                      invalid, no FRAM is selected (the same as FRAM_Write() always did).
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             device - DEV_FRAME or DEV_FRAM2
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             FRAME_CSN, FRAM2_CSN
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void SPI2_CsActive(uint8_t device)
+{
+  if (device == DEV_FRAME)
+  {
+    FRAME_CSN_ACTIVE;
+  }
+  else if (device == DEV_FRAM2)
+  {
+    FRAM2_CSN_ACTIVE;
+  }
+}
+
+void SPI2_CsInactive(uint8_t device)
+{
+  if (device == DEV_FRAME)
+  {
+    FRAME_CSN_INACTIVE;
+  }
+  else if (device == DEV_FRAM2)
+  {
+    FRAM2_CSN_INACTIVE;
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          SPI2_CsActive(), SPI2_CsInactive()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        SPI2_Xfer()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Blocking SPI2 Transfer
+//
+//  MECHANICS:          This subroutine submits a one-segment transaction and waits for it.  It is used by
+//                      the blocking FRAM subroutines (FRAM_Read(), Frame_FRAM_Read(), FRAM_Write(), and
+//                      Frame_FRAM_Write())
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             device - DEV_FRAME or DEV_FRAM2
+//                      op - SPI2_OP_READ or SPI2_OP_WRITE
+//                      width - SPI2_8BIT or SPI2_16BIT
+//                      fram_address - starting byte address in FRAM
+//                      length - length (in frames) to transfer
+//                      dptr - data address
+//
+//  OUTPUTS:            The data (reads)
+//
+//  ALTERS:             None
+//
+//  CALLS:              SPI2_Submit(), SPI2_Wait()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void SPI2_Xfer(uint8_t device, uint8_t op, uint8_t width, uint32_t fram_address, uint16_t length, void *dptr)
+{
+  struct SPI2_XACT xact;
+
+  xact.Device = device;
+  xact.Op = op;
+  xact.Width = width;
+  xact.NumSegs = 1;
+  xact.Addr = fram_address;
+  xact.Seg[0].Ptr = dptr;
+  xact.Seg[0].Len = length;
+  xact.Done = 0;
+  SPI2_Submit(&xact);
+  SPI2_Wait(&xact);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          SPI2_Xfer()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        SPI2_EnergySeg()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Build the Energy Segments
+//
+//  MECHANICS:          This subroutine fills in the transaction segments for the energy registers, in the
+//                      order that they are stored in FRAM (see FRAM_WriteEnergy() and FRAM_def.h).  Segment
+//                      8 is the checksum and its complement, in chkptr[0..1].
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             xptr - the transaction
+//                      chkptr - the checksum location
+//
+//  OUTPUTS:            xptr->NumSegs, xptr->Seg[]
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void SPI2_EnergySeg(struct SPI2_XACT *xptr, uint32_t *chkptr)
+{
+  xptr->Seg[0].Ptr = &ResidualPha.FwdWHr;
+  xptr->Seg[0].Len = (RES_SIZE >> 1);
+  xptr->Seg[1].Ptr = &EnergyPha.FwdWHr;
+  xptr->Seg[1].Len = (NRG_SIZE >> 1);
+  xptr->Seg[2].Ptr = &ResidualPhb.FwdWHr;
+  xptr->Seg[2].Len = (RES_SIZE >> 1);
+  xptr->Seg[3].Ptr = &EnergyPhb.FwdWHr;
+  xptr->Seg[3].Len = (NRG_SIZE >> 1);
+  xptr->Seg[4].Ptr = &ResidualPhc.FwdWHr;
+  xptr->Seg[4].Len = (RES_SIZE >> 1);
+  xptr->Seg[5].Ptr = &EnergyPhc.FwdWHr;
+  xptr->Seg[5].Len = (NRG_SIZE >> 1);
+  xptr->Seg[6].Ptr = &ResidualAll.FwdWHr;
+  xptr->Seg[6].Len = (RES_SIZE >> 1);
+  xptr->Seg[7].Ptr = &EngyDmnd[1].TotFwdWHr;
+  xptr->Seg[7].Len = (NRG_SIZE >> 1);
+  xptr->Seg[8].Ptr = chkptr;
+  xptr->Seg[8].Len = 4;
+  xptr->NumSegs = 9;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          SPI2_EnergySeg()
+//------------------------------------------------------------------------------------------------------------
+
+#endif
+
+
+
 //------------------------------------------------------------------------------------------------------------
 //             START OF FUNCTION    FRAM_Read()
 //------------------------------------------------------------------------------------------------------------
@@ -1901,12 +2796,15 @@ void ExtCapt_FRAM_Write(uint32_t fram_address, uint16_t length, uint16_t *inptr)
 //                      
 //  ALTERS:             None
 //                      
-//  CALLS:              Init_SPI2()
+//  CALLS:              Init_SPI2() (SPI2_Xfer() if ENABLE_SPI2_DMA is defined)
 // 
 //------------------------------------------------------------------------------------------------------------
 
 void FRAM_Read(uint32_t fram_address, uint16_t length, uint16_t *outptr)
 {
+#ifdef ENABLE_SPI2_DMA
+  SPI2_Xfer(DEV_FRAM2, SPI2_OP_READ, SPI2_16BIT, fram_address, length, outptr);
+#else
   uint16_t i;
   volatile uint16_t temp;
 
@@ -1943,6 +2841,7 @@ void FRAM_Read(uint32_t fram_address, uint16_t length, uint16_t *outptr)
 
   FRAM2_CSN_INACTIVE;                   // Deselect the FRAM device (Chip select hold time= 10ns)
 
+#endif
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -1974,12 +2873,15 @@ void FRAM_Read(uint32_t fram_address, uint16_t length, uint16_t *outptr)
 //                      
 //  ALTERS:             None
 //                      
-//  CALLS:              Init_SPI2
+//  CALLS:              Init_SPI2 (SPI2_Xfer() if ENABLE_SPI2_DMA is defined)
 // 
 //------------------------------------------------------------------------------------------------------------
 
 void Frame_FRAM_Read(uint16_t fram_address, uint16_t length, uint8_t *outptr)
 {
+#ifdef ENABLE_SPI2_DMA
+  SPI2_Xfer(DEV_FRAME, SPI2_OP_READ, SPI2_8BIT, fram_address, length, outptr);
+#else
   uint16_t i;
   volatile uint8_t temp;
 
@@ -2020,6 +2922,7 @@ void Frame_FRAM_Read(uint16_t fram_address, uint16_t length, uint8_t *outptr)
     *outptr++ = SPI2->DR;               // Clear RXNE flag by reading data reg and capture data
   }
   FRAME_CSN_INACTIVE;                   // Deselect the FRAM device (Chip select hold time= 10ns)
+#endif
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -2042,6 +2945,9 @@ void Frame_FRAM_Read(uint16_t fram_address, uint16_t length, uint8_t *outptr)
 //                      
 //  CAVEATS:            FRAM addresses are in BYTES, not WORDS!
 //                      The data is written in words (16-bit), not bytes!
+//                      If ENABLE_SPI2_DMA is defined, writes of up to SPI2_POST_WORDS words are posted: the
+//                      data is copied and queued, and the subroutine returns before the write is done.
+//                      Later reads and writes are queued behind it, so they see the written data
 //                      
 //  INPUTS:             Parameters: device - FRAME FRAM or on-board FRAM
 //                                  fram_address - starting byte address in FRAM to write to
@@ -2053,11 +2959,40 @@ void Frame_FRAM_Read(uint16_t fram_address, uint16_t length, uint8_t *outptr)
 //  ALTERS:             None
 //                      
 //  CALLS:              Init_SPI2()
+//                      SPI2_Xfer(), SPI2_Wait(), SPI2_Submit() (if ENABLE_SPI2_DMA is defined)
 // 
 //------------------------------------------------------------------------------------------------------------
 
 void FRAM_Write(uint16_t device, uint32_t fram_address, uint16_t length, uint16_t *inptr)
 {
+#ifdef ENABLE_SPI2_DMA
+  struct SPI2_POST *pptr;
+  uint32_t primask;
+
+  if (length > SPI2_POST_WORDS)         // Long writes are sent straight from the caller's data
+  {
+    SPI2_Xfer(device, SPI2_OP_WRITE, SPI2_16BIT, fram_address, length, inptr);
+    return;
+  }
+                                        // Short writes are copied into the next posted write slot and
+  primask = __get_PRIMASK();            //   queued.  The slots are used in turn, so if the slot is still
+  __disable_irq();                      //   busy, it holds the oldest posted write
+  pptr = &SPI2Post[SPI2PostNdx];
+  SPI2PostNdx = ((SPI2PostNdx + 1) & (SPI2_POST_SLOTS - 1));
+  __set_PRIMASK(primask);
+
+  SPI2_Wait(&pptr->Xact);
+  memcpy(&pptr->Data[0], inptr, (length << 1));
+  pptr->Xact.Device = device;
+  pptr->Xact.Op = SPI2_OP_WRITE;
+  pptr->Xact.Width = SPI2_16BIT;
+  pptr->Xact.NumSegs = 1;
+  pptr->Xact.Addr = fram_address;
+  pptr->Xact.Seg[0].Ptr = &pptr->Data[0];
+  pptr->Xact.Seg[0].Len = length;
+  pptr->Xact.Done = 0;
+  SPI2_Submit(&pptr->Xact);
+#else
   uint16_t i;
   volatile uint16_t temp;
 
@@ -2143,6 +3078,7 @@ void FRAM_Write(uint16_t device, uint32_t fram_address, uint16_t length, uint16_
   {
     FRAM2_CSN_INACTIVE;
   }
+#endif
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -2180,12 +3116,17 @@ void FRAM_Write(uint16_t device, uint32_t fram_address, uint16_t length, uint16_
 //                      
 //  ALTERS:             None
 //                      
-//  CALLS:              Init_SPI2
+//  CALLS:              Init_SPI2 (SPI2_Xfer() if ENABLE_SPI2_DMA is defined), CopyToCassetteFlags()
 // 
 //------------------------------------------------------------------------------------------------------------
 
 void Frame_FRAM_Write(uint16_t fram_address, uint16_t length, uint8_t *inptr)
 {
+#ifdef ENABLE_SPI2_DMA
+  SPI2_Xfer(DEV_FRAME, SPI2_OP_WRITE, SPI2_8BIT, fram_address, length, inptr);
+  // Trigger Setpoints Copy to Cassette process
+  CopyToCassetteFlags();
+#else
   uint16_t i;
   volatile uint16_t temp;
 
@@ -2250,6 +3191,7 @@ void Frame_FRAM_Write(uint16_t fram_address, uint16_t length, uint8_t *inptr)
   FRAME_CSN_INACTIVE;                   // Deselect the FRAM device (Chip select hold time= 10ns)
   // Trigger Setpoints Copy to Cassette process
   CopyToCassetteFlags();
+#endif
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -2283,11 +3225,31 @@ void Frame_FRAM_Write(uint16_t fram_address, uint16_t length, uint8_t *inptr)
 //  ALTERS:             None
 //                      
 //  CALLS:              Init_SPI2(), FRAM_XferW()
+//                      ComputeChksum32(), SPI2_Submit(), SPI2_Wait() (if ENABLE_SPI2_DMA is defined)
 // 
 //------------------------------------------------------------------------------------------------------------
 
 void FRAM_WriteMinMax(uint32_t fram_address, uint16_t length, uint16_t *dptr)
 {
+#ifdef ENABLE_SPI2_DMA
+  struct SPI2_XACT xact;
+  uint32_t chk[2];
+
+  chk[0] = ComputeChksum32((uint32_t *)dptr, (length >> 2));
+  chk[1] = ~chk[0];
+  xact.Device = DEV_FRAM2;
+  xact.Op = SPI2_OP_WRITE;
+  xact.Width = SPI2_16BIT;
+  xact.NumSegs = 2;
+  xact.Addr = fram_address;
+  xact.Seg[0].Ptr = dptr;               // Data (the same double-words that the checksum is computed on)
+  xact.Seg[0].Len = ((length >> 2) << 1);
+  xact.Seg[1].Ptr = &chk[0];            // Checksum and complement
+  xact.Seg[1].Len = 4;
+  xact.Done = 0;
+  SPI2_Submit(&xact);
+  SPI2_Wait(&xact);
+#else
   uint32_t chk;
   uint16_t temp;
 
@@ -2366,6 +3328,7 @@ void FRAM_WriteMinMax(uint32_t fram_address, uint16_t length, uint16_t *dptr)
 
   FRAM2_CSN_INACTIVE;                   // Deselect the FRAM device (Chip select hold time= 10ns)
 
+#endif
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -2418,6 +3381,9 @@ void FRAM_Stat_Write(uint16_t device, uint8_t status)
   uint8_t i;
   volatile uint16_t temp;
 
+#ifdef ENABLE_SPI2_DMA
+  SPI2_Flush();                         // Let the queued FRAM transactions finish before using SPI2
+#endif
   Init_SPI2(DEV_FRAM_FLASH8);           // Initialize SPI to output bytes
 
   // Send out a WRITE ENABLE instruction
@@ -2507,6 +3473,9 @@ void FRAM_Stat_Write(uint16_t device, uint8_t status)
 //                      are written in.  This MUST match up with the FRAM addresses in FRAM_ReadEnergy and
 //                      in FRAM_def.h!
 //                      The data is written in words (16-bit), not bytes!
+//                      If ENABLE_SPI2_DMA is defined, the energy values are copied into SPI2EnergyBuf[] and
+//                      the write is posted.  The write is done by the SPI2 engine interrupts (about 130usec
+//                      of bus time), and the subroutine returns after the copy (a few usec)
 //                      
 //  INPUTS:             Parameters: device - FRAME FRAM or on-board FRAM
 //                      
@@ -2515,6 +3484,8 @@ void FRAM_Stat_Write(uint16_t device, uint8_t status)
 //  ALTERS:             None
 //                      
 //  CALLS:              Init_SPI2(), FRAM_XferW()
+//                      SPI2_Wait(), SPI2_EnergySeg(), ComputeChksum32(), SPI2_Submit() (if ENABLE_SPI2_DMA is
+//                      defined)
 //
 //  EXECUTION TIME:     Measured on 180601.  Worst-case time is about 264usec
 // 
@@ -2522,6 +3493,37 @@ void FRAM_Stat_Write(uint16_t device, uint8_t status)
 
 void FRAM_WriteEnergy(uint8_t device)
 {
+#ifdef ENABLE_SPI2_DMA
+  struct SPI2_XACT segs;
+  uint16_t *dptr;
+  uint32_t chk;
+  uint8_t i;
+
+  SPI2_Wait(&SPI2EnergyXact);           // The previous energy write must be done before the buffer is reused
+
+                                        // Copy the 8 groups of energy values into the buffer, in the order
+  SPI2_EnergySeg(&segs, 0);             //   that they are stored in FRAM
+  dptr = (uint16_t *)&SPI2EnergyBuf[0];
+  for (i=0; i<8; ++i)
+  {
+    memcpy(dptr, segs.Seg[i].Ptr, (segs.Seg[i].Len << 1));
+    dptr += segs.Seg[i].Len;
+  }
+                                        // Add the checksum and its complement
+  chk = ComputeChksum32(&SPI2EnergyBuf[0], ((ENERGY_SIZE - 8) >> 2));
+  SPI2EnergyBuf[(ENERGY_SIZE - 8) >> 2] = chk;
+  SPI2EnergyBuf[((ENERGY_SIZE - 8) >> 2) + 1] = ~chk;
+
+  SPI2EnergyXact.Device = ((device == DEV_FRAME) ? DEV_FRAME : DEV_FRAM2);
+  SPI2EnergyXact.Op = SPI2_OP_WRITE;
+  SPI2EnergyXact.Width = SPI2_16BIT;
+  SPI2EnergyXact.NumSegs = 1;
+  SPI2EnergyXact.Addr = FRAM_ENERGY;
+  SPI2EnergyXact.Seg[0].Ptr = &SPI2EnergyBuf[0];
+  SPI2EnergyXact.Seg[0].Len = (ENERGY_SIZE >> 1);
+  SPI2EnergyXact.Done = 0;
+  SPI2_Submit(&SPI2EnergyXact);         // The write is finished by the engine interrupts
+#else
   uint32_t chk;
   uint16_t temp;
 
@@ -2643,6 +3645,7 @@ void FRAM_WriteEnergy(uint8_t device)
   {
     FRAM2_CSN_INACTIVE;
   }
+#endif
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -2677,6 +3680,8 @@ void FRAM_WriteEnergy(uint8_t device)
 //  ALTERS:             None
 //                      
 //  CALLS:              Init_SPI2(), FRAM_XferR()
+//                      SPI2_EnergySeg(), SPI2_Submit(), SPI2_Wait(), ComputeChksum32() (if ENABLE_SPI2_DMA is
+//                      defined)
 // 
 //  EXECUTION TIME:     Measured on 180625 (rev 0.25 code): 569usec
 //
@@ -2686,6 +3691,28 @@ void FRAM_ReadEnergy(uint8_t device)
 {
   uint32_t chk;
   uint32_t fchk, fcmp;
+#ifdef ENABLE_SPI2_DMA
+  struct SPI2_XACT xact;
+  uint32_t chkbuf[2];
+  uint8_t i;
+
+  xact.Device = ((device == DEV_FRAME) ? DEV_FRAME : DEV_FRAM2);
+  xact.Op = SPI2_OP_READ;
+  xact.Width = SPI2_16BIT;
+  xact.Addr = FRAM_ENERGY;
+  xact.Done = 0;
+  SPI2_EnergySeg(&xact, &chkbuf[0]);    // Read the 8 groups of energy values and the checksum in one stream
+  SPI2_Submit(&xact);
+  SPI2_Wait(&xact);
+
+  chk = 0;
+  for (i=0; i<8; ++i)
+  {
+    chk += ComputeChksum32((uint32_t *)xact.Seg[i].Ptr, (xact.Seg[i].Len >> 1));
+  }
+  fchk = chkbuf[0];
+  fcmp = chkbuf[1];
+#else
   volatile uint16_t temp;
 
   Init_SPI2(DEV_FRAM_FLASH16);          // Initialize SPI to output words
@@ -2770,6 +3797,7 @@ void FRAM_ReadEnergy(uint8_t device)
   {
     FRAM2_CSN_INACTIVE;
   }
+#endif
 
   if ( (fchk != chk) || fcmp != (~chk) )    // If checksum mismatch...
   {                                             // Set all energy registers to 0
@@ -3440,6 +4468,11 @@ uint8_t Flash_PageWrite(uint16_t flash_addr, uint8_t num_words, uint16_t *datapt
 //                      transactions.  Timing tests were conducted on 180615.  Reference comments in
 //                      FRAM_Flash_def.h and especially in Intr.c - DMA1_Stream0_IRQHandler(), under Trip
 //                      Waveform Captures.
+//                      If ENABLE_SPI1_DMA is defined, State 0 sets up the write and then the waveform is
+//                      written by Flash_PipeService() (State 5).  The page data is sent by DMA, and the next
+//                      page is committed as soon as the previous page program is done.
+//                      If ENABLE_WF_CODEC is also defined, the pipeline writes the coded capture and its
+//                      index instead of the sample sets (see Flash_PipeCode()).
 //                      
 //  CAVEATS:            It is assumed that the data is in an unprotected part of Flash.  It is also assumed
 //                      that the sections being written to have already been erased.
@@ -3460,6 +4493,8 @@ uint8_t Flash_PageWrite(uint16_t flash_addr, uint8_t num_words, uint16_t *datapt
 //                      WF_Struct.NumSamples - the number of sample sets that have been written
 //                      
 //  CALLS:              Init_SPI1(), FRAM_Write()
+//                      Flash_WriteSampleSets() (if ENABLE_SAMPLE_SOA is defined)
+//                      Flash_PipeService() (if ENABLE_SPI1_DMA is defined)
 // 
 //------------------------------------------------------------------------------------------------------------
 
@@ -3482,7 +4517,9 @@ uint8_t Flash_WriteWaveform(struct FLASH_INT_REQ *WF_Struct, uint8_t WF_Abort)
       case 0:                           // State 0: Set up
 //TESTPIN_D1_HIGH;
         SBout_Index = WF_Struct->SampleStartIndex;
+#ifndef ENABLE_SAMPLE_SOA
         SBout_ptr = (uint16_t *)(&SampleBuf[SBout_Index].Ia);
+#endif
         WF_Struct->NumSamples = 0;
         // Compute the starting address in Flash for the write
         if (WF_Struct == &Trip_WF_Capture)
@@ -3504,6 +4541,30 @@ uint8_t Flash_WriteWaveform(struct FLASH_INT_REQ *WF_Struct, uint8_t WF_Abort)
         // Address is SSSP ("S" = sector, "P" = page), so need to shift left 4 to move sector to MS position
         WF_Struct->FlashAdd = (WF_Struct->FlashAdd << 4);
 
+#ifdef ENABLE_SPI1_DMA
+        // Set up the pipeline.  If the sample buffer has not been filled, the precycles up to the end of
+        //   SampleBuf[] are garbage, and are written as zeros (same as State 3)
+        FlashPipe.ZeroSets = ( ((SampleBufFilled) || (SBout_Index < SampleIndex)) ?
+                                        0 : (TOTAL_SAMPLE_SETS - SBout_Index) );
+        FlashPipe.Gathered = 0;
+        FlashPipe.Next = 0;
+        FlashPipe.Ready = FALSE;
+  #ifdef ENABLE_WF_CODEC
+        FlashPipe.SlotAdd = WF_Struct->FlashAdd;
+        FlashPipe.DataBytes = 0;
+        FlashPipe.StageFill = 0;
+        FlashPipe.StageOut = 0;
+        FlashPipe.DataPages = 0;
+        FlashPipe.Cycles = 0;
+        FlashPipe.Credited = 0;
+        FlashPipe.IndexSent = 0;
+        FlashPipe.Aborted = FALSE;
+        memset(&WfCodecIndex[0], 0xFF, sizeof(WfCodecIndex));      // Cycles not written read as erased
+  #endif
+        FWW_State = 5;
+        break;
+#endif
+
         // If sample buffer is filled, or starting index of samples to write is behind the index of the
         //   present sample, we can fill from SampleBuf[], so fall into State 1
         if ( (SampleBufFilled) || (SBout_Index < SampleIndex) )
@@ -3548,6 +4609,14 @@ uint8_t Flash_WriteWaveform(struct FLASH_INT_REQ *WF_Struct, uint8_t WF_Abort)
         num_words1 = ((2880 - WF_Struct->NumSamples) > 7) ? 7 : (2880 - WF_Struct->NumSamples);
         WF_Struct->NumSamples += num_words1;                    // Update the count
     
+#ifdef ENABLE_SAMPLE_SOA
+        // SampleBuf is stored by channel, so the sample sets are gathered and written one at a time.
+        //   Flash_WriteSampleSets() handles the wrap around the end of SampleBuf
+        Flash_WriteSampleSets(num_words1);
+        while ((SPI1->SR & SPI_SR_BSY) == SPI_SR_BSY)           // Make sure last char is finished before
+        {                                                       //   proceeding
+        }
+#else
         if ((SBout_Index + num_words1) > TOTAL_SAMPLE_SETS)     // If we are wrapping around SampleBuf[], we
         {                                                       //   need to split this into two writes
           num_words = (TOTAL_SAMPLE_SETS - SBout_Index);
@@ -3595,6 +4664,7 @@ uint8_t Flash_WriteWaveform(struct FLASH_INT_REQ *WF_Struct, uint8_t WF_Abort)
           {                                                     //   proceeding
           }
         }
+#endif
         FLASH_CSN_INACTIVE;
         FWW_State = 2;
         exit_flag = TRUE;
@@ -3645,11 +4715,16 @@ uint8_t Flash_WriteWaveform(struct FLASH_INT_REQ *WF_Struct, uint8_t WF_Abort)
         if (SBout_Index >= TOTAL_SAMPLE_SETS)  
         {
           SBout_Index = 0;
+#ifndef ENABLE_SAMPLE_SOA
           SBout_ptr = (uint16_t *)(&SampleBuf[0].Ia);
+#endif
           // If we have written less than 7 words, we need to fill in the remaining words with data from
           //   SampleBuf[]
           if (num_words1 < 7)
           {
+#ifdef ENABLE_SAMPLE_SOA
+            Flash_WriteSampleSets(7 - num_words1);
+#else
             num_words = (7 - num_words1) * (sizeof(struct RAM_SAMPLES))/2;
             for (t8.i=0; t8.i<num_words; ++t8.i)
             {
@@ -3659,6 +4734,7 @@ uint8_t Flash_WriteWaveform(struct FLASH_INT_REQ *WF_Struct, uint8_t WF_Abort)
               }
               temp[0] = SPI1->DR;
             }
+#endif
           }            
           FWW_State = 2;
         }
@@ -3710,6 +4786,17 @@ uint8_t Flash_WriteWaveform(struct FLASH_INT_REQ *WF_Struct, uint8_t WF_Abort)
         }
         break;
     
+#ifdef ENABLE_SPI1_DMA
+      case 5:                           // State 5 - Pipelined page writes
+        if (Flash_PipeService(WF_Struct, WF_Abort))
+        {
+          FWW_State = 0;
+          return (TRUE);
+        }
+        exit_flag = TRUE;
+        break;
+#endif
+
       default:                          // Default state - this should never be entered
         FPW_State = 0;                      // Reset the state
         exit_flag = TRUE;
@@ -3722,8 +4809,706 @@ uint8_t Flash_WriteWaveform(struct FLASH_INT_REQ *WF_Struct, uint8_t WF_Abort)
 }
 
 //------------------------------------------------------------------------------------------------------------
-//             END OF FUNCTION      Flash_WriteWaveform()
+//             END OF FUNCTION      Flash_WriteWaveform()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+#ifdef ENABLE_SAMPLE_SOA
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION    Flash_WriteSampleSets()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Write Sample Sets to Flash
+//                      
+//  MECHANICS:          This subroutine writes sample sets from SampleBuf to the Flash page that is being
+//                      programmed by Flash_WriteWaveform().  The waveforms are stored in Flash as sample sets
+//                      (struct RAM_SAMPLES), but SampleBuf is stored by channel, so each set is first
+//                      gathered into SBout_Rec by SampleBuf_GetRecord(), and then written as words.  The
+//                      next set is gathered while the last word of the previous set is being shifted out.
+//                      SBout_Index is incremented for each set, and wraps around to 0 at the end of
+//                      SampleBuf.
+//                      
+//  CAVEATS:            Only used if ENABLE_SAMPLE_SOA is defined.
+//                      The page program command and address must have already been sent.  The subroutine
+//                      does not wait for the last word to finish.
+//                      
+//  INPUTS:             SBout_Index - the index in SampleBuf of the first set to write
+//                      num_sets - the number of sets to write
+//                      
+//  OUTPUTS:            SPI1->DR
+//                      
+//  ALTERS:             SBout_Index, SBout_Rec
+//                      
+//  CALLS:              SampleBuf_GetRecord()
+// 
+//------------------------------------------------------------------------------------------------------------
+
+void Flash_WriteSampleSets(uint8_t num_sets)
+{
+  uint16_t *wptr;
+  uint32_t temp;
+  uint8_t i, j;
+
+  for (i=0; i<num_sets; ++i)
+  {
+    SampleBuf_GetRecord(SBout_Index, &SBout_Rec);
+    wptr = (uint16_t *)(&SBout_Rec.Ia);
+    for (j=0; j<(sizeof(struct RAM_SAMPLES)/2); ++j)
+    {
+      SPI1->DR = *wptr++;
+      while ((SPI1->SR & SPI_SR_TXE) != SPI_SR_TXE)
+      {
+      }
+      temp = SPI1->DR;
+    }
+    if (++SBout_Index >= TOTAL_SAMPLE_SETS)
+    {
+      SBout_Index = 0;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION      Flash_WriteSampleSets()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_SAMPLE_SOA
+
+
+
+#ifdef ENABLE_SPI1_DMA
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION    Flash_PipeService()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Service the Flash Waveform Pipeline
+//                      
+//  MECHANICS:          This subroutine writes a trip, alarm, or extended capture waveform into Flash a page
+//                      at a time, with two page buffers:
+//                          - The sample sets for a page are gathered into one page buffer by
+//                            Flash_PipeGather()
+//                          - The write enable and page program commands are issued, and the page data is
+//                            sent by DMA2 Stream 3 (Flash_PipeStart()).  The chip select is released by the
+//                            DMA transfer complete interrupt (Flash_PipeDone())
+//                          - While the page is being sent and programmed, the sample sets for the next page
+//                            are gathered into the other page buffer
+//                          - On each call, the status register is read (Flash_PipeStatus()).  As soon as the
+//                            page program is done, the next page is started
+//                      While the waveform is being written, Timer10 is reloaded so that the first status
+//                      read after a page is started comes at the learned page time (FlashPipe.WaitArr), and
+//                      the following reads come every 20usec (FlashPipe.PollArr).  If the first read finds
+//                      the page already done, the learned time is trimmed by about 10usec.  If it finds the
+//                      Flash busy, the learned time is increased by one poll time.  The next page is started
+//                      close to the end of the previous page program, instead of on the next 1.5msec
+//                      interrupt.  The waveform is written at about the rate the Flash can program pages,
+//                      so the pages of back-to-back trip, alarm, and extended captures are committed sooner
+//                      and SBout_Index stays farther in front of SampleIndex.
+//                      Since the pages may now be written faster than the samples arrive, a page is only
+//                      gathered once all of its sample sets have been received.  If they have not, the page
+//                      is held off until the next call (FlashPipe.Stalls is incremented).  This protects the
+//                      maximum post-event cycles case (see Intr.c - DMA1_Stream0_IRQHandler(), under Trip
+//                      Waveform Captures).
+//                      If ENABLE_WF_CODEC is defined, the pages are coded by Flash_PipeCode() instead of
+//                      gathered by Flash_PipeGather().  Each page has its own address (FlashPipe.PgAdd[]),
+//                      since the data pages are written first and the index pages last.  NumSamples is
+//                      increased by one cycle (80 sets) for each cycle whose last byte is in the page.  The
+//                      write is done when the last index page has been programmed.
+//                      
+//                      REFERENCE: MicroChip SST26VF064B DS200051 9G 2015
+//                      
+//  CAVEATS:            Only included if ENABLE_SPI1_DMA is defined.
+//                      Called only from Flash_WriteWaveform() (State 5), after State 0 has set up the
+//                      write.  It is assumed that the sections being written to have already been erased.
+//                      If WF_Abort is True, the page that is being programmed is finished, and then the
+//                      subroutine returns True.  With the codec, the index must still be written for the
+//                      cycles that are already in Flash to be read, so the data page that is waiting is
+//                      dropped, the index entries of the cycles that were not written are erased, and the
+//                      subroutine returns True after the index pages (about 3msec more).
+//                      
+//  INPUTS:             WF_Struct - the waveform capture
+//                      WF_Abort - True if the waveform write should be aborted
+//                      FlashPipe.xx
+//                      
+//  OUTPUTS:            The subroutine returns True when it is finished writing the waveform to Flash
+//                        It returns False otherwise
+//                      
+//  ALTERS:             FlashPipe.xx, WF_Struct->FlashAdd, WF_Struct->NumSamples, TIM10->ARR
+//                      
+//  CALLS:              Flash_PipeStatus(), Flash_PipeGather(), Flash_PipeStart(),
+//                      Flash_PipeCode() and memset() (if ENABLE_WF_CODEC is defined)
+// 
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Flash_PipeService(struct FLASH_INT_REQ *WF_Struct, uint8_t WF_Abort)
+{
+#ifdef ENABLE_WF_CODEC
+  uint8_t i;
+
+#endif
+  if (FlashPipe.DmaBusy)                // If the page data is still being sent, check again on the next call
+  {
+    return (FALSE);
+  }
+
+  if (FlashPipe.Programming)            // If a page was sent, check whether it has been programmed
+  {
+    ++FlashPipe.PgPolls;
+    if (Flash_PipeStatus() & 0x80)      // b7 = busy bit.  If 1, page program is still going on, so exit
+    {
+      ++FlashPipe.BusyPolls;
+      if ( (FlashPipe.PgPolls == 1) && (FlashPipe.WaitArr < TIM10_ARR_WAIT_MAX) )
+      {                                 // If the first read was too soon, wait one poll time longer for the
+        FlashPipe.WaitArr += (FlashPipe.PollArr + 1);       //   next page
+      }
+      TIM10->ARR = FlashPipe.PollArr;
+      return (FALSE);
+    }
+    if ( (FlashPipe.PgPolls == 1) && (FlashPipe.WaitArr >= (FlashPipe.PollArr + TIM10_ARR_TRIM)) )
+    {                                   // If the page was already done on the first read, the wait may have
+      FlashPipe.WaitArr -= TIM10_ARR_TRIM;      //   been too long, so trim it for the next page
+    }
+    FlashPipe.Programming = FALSE;      // Page program is complete
+    ++FlashPipe.Pages;
+    ++(WF_Struct->FlashAdd);            // Increment the Flash address
+  }
+
+#ifdef ENABLE_WF_CODEC
+  // If aborting before the index has been started, drop the data page that is waiting and erase the index
+  //   entries of the cycles that are not completely in Flash, so that only the index is still written
+  if ( (WF_Abort) && (!FlashPipe.Aborted) && (FlashPipe.IndexSent == 0) )
+  {
+    FlashPipe.Aborted = TRUE;
+    FlashPipe.Ready = FALSE;
+    for (i = (WF_Struct->NumSamples / WF_CODEC_SAMPLES); i < WF_CODEC_CYCLES; ++i)
+    {
+      memset(&WfCodecIndex[i], 0xFF, sizeof(struct WF_CODEC_DIR));
+    }
+  }
+
+  // If the last index page has been programmed, we are done.  Restore the normal Timer10 rate and return
+  //   True
+  if ( (FlashPipe.IndexSent >= WF_CODEC_INDEX_PAGES) && (!FlashPipe.Ready) )
+  {
+    TIM10->ARR = TIM10_ARR_1500USEC;
+    return (TRUE);
+  }
+
+  // Code the next page if it has not been coded yet.  If the samples of the next cycle have not all been
+  //   received, try again on the next call
+  if ( (!FlashPipe.Ready) && (!Flash_PipeCode()) )
+  {
+    ++FlashPipe.Stalls;
+    TIM10->ARR = TIM10_ARR_100USEC;
+    return (FALSE);
+  }
+
+  WF_Struct->NumSamples += (FlashPipe.Sets[FlashPipe.Next] * WF_CODEC_SAMPLES);   // Update the count
+  Flash_PipeStart(FlashPipe.PgAdd[FlashPipe.Next]);
+  FlashPipe.PgPolls = 0;
+  TIM10->ARR = FlashPipe.WaitArr;       // First status read at the learned page time
+
+  Flash_PipeCode();                     // Code the following page while this one is sent and programmed
+#else
+  // If number of sample sets written reaches 2880 (36 cycles) or aborting, we are done.  Restore the normal
+  //   Timer10 rate and return True
+  if ( (WF_Struct->NumSamples >= FLASH_WF_SETS) || (WF_Abort) )
+  {
+    TIM10->ARR = TIM10_ARR_1500USEC;
+    return (TRUE);
+  }
+
+  // Gather the next page if it has not been gathered yet.  If its samples have not all been received, try
+  //   again on the next call
+  if ( (!FlashPipe.Ready) && (!Flash_PipeGather()) )
+  {
+    ++FlashPipe.Stalls;
+    TIM10->ARR = TIM10_ARR_100USEC;
+    return (FALSE);
+  }
+
+  WF_Struct->NumSamples += FlashPipe.Sets[FlashPipe.Next];   // Update the count
+  Flash_PipeStart(WF_Struct->FlashAdd);
+  FlashPipe.PgPolls = 0;
+  TIM10->ARR = FlashPipe.WaitArr;       // First status read at the learned page time
+
+  Flash_PipeGather();                   // Gather the following page while this one is sent and programmed
+#endif
+
+  return (FALSE);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION      Flash_PipeService()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+#ifndef ENABLE_WF_CODEC
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION    Flash_PipeGather()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Gather the Next Flash Page
+//                      
+//  MECHANICS:          This subroutine copies the sample sets for the next page from SampleBuf into page
+//                      buffer FlashPipe.Next.  A page holds 7 sample sets (the last page of a waveform
+//                      holds the remaining 3).  If there are unfilled precycles (FlashPipe.ZeroSets), these
+//                      are written as zeros, and the rest of the page is filled from the start of
+//                      SampleBuf.  The sample sets are only copied if all of them have been received, that
+//                      is, they are behind SampleIndex.  Otherwise nothing is done, and the subroutine
+//                      returns False.
+//                      If SampleBuf is stored by channel (ENABLE_SAMPLE_SOA defined), each set is gathered
+//                      by SampleBuf_GetRecord().
+//                      
+//  CAVEATS:            Only included if ENABLE_SPI1_DMA is defined.
+//                      Must not be called while page buffer FlashPipe.Next is being sent.  This is ensured
+//                      because Flash_PipeStart() switches to the other buffer.
+//                      
+//  INPUTS:             SBout_Index, SampleIndex, SampleBuf, FlashPipe.xx
+//                      
+//  OUTPUTS:            FlashPgBuf[FlashPipe.Next][]
+//                      The subroutine returns True if the page was gathered, False otherwise
+//                      
+//  ALTERS:             SBout_Index, FlashPipe.Gathered, FlashPipe.ZeroSets, FlashPipe.Sets[],
+//                      FlashPipe.Ready
+//                      
+//  CALLS:              memset(), SampleBuf_GetRecord() (if ENABLE_SAMPLE_SOA is defined)
+// 
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Flash_PipeGather(void)
+{
+  struct RAM_SAMPLES *pptr;
+  uint16_t ndx, avail;
+  uint8_t num_sets, num_zeros, i;
+
+  if ( (FlashPipe.Ready) || (FlashPipe.Gathered >= FLASH_WF_SETS) )
+  {
+    return (FALSE);
+  }
+  num_sets = ( ((FLASH_WF_SETS - FlashPipe.Gathered) > FLASH_PG_SETS) ?
+                    FLASH_PG_SETS : (FLASH_WF_SETS - FlashPipe.Gathered) );
+  num_zeros = ( (FlashPipe.ZeroSets > num_sets) ? num_sets : FlashPipe.ZeroSets );
+
+  // Make sure the sample sets that come from SampleBuf have been received.  ndx is the index of the first
+  //   one, and avail is the number of sets from there up to SampleIndex (the next set to be filled)
+  if (num_zeros < num_sets)
+  {
+    ndx = SBout_Index + num_zeros;
+    if (ndx >= TOTAL_SAMPLE_SETS)
+    {
+      ndx -= TOTAL_SAMPLE_SETS;
+    }
+    avail = SampleIndex;
+    avail = ( (avail >= ndx) ? (avail - ndx) : ((avail + TOTAL_SAMPLE_SETS) - ndx) );
+    if (avail < (num_sets - num_zeros))
+    {
+      return (FALSE);
+    }
+  }
+
+  pptr = &FlashPgBuf[FlashPipe.Next][0];
+  if (num_zeros > 0)                    // Write zeros for the unfilled precycles.  These run up to the end of
+  {                                     //   SampleBuf, so the next set is at index 0
+    memset(pptr, 0, (num_zeros * sizeof(struct RAM_SAMPLES)));
+    pptr += num_zeros;
+    FlashPipe.ZeroSets -= num_zeros;
+    SBout_Index += num_zeros;
+    if (SBout_Index >= TOTAL_SAMPLE_SETS)
+    {
+      SBout_Index = 0;
+    }
+  }
+  for (i=num_zeros; i<num_sets; ++i)
+  {
+#ifdef ENABLE_SAMPLE_SOA
+    SampleBuf_GetRecord(SBout_Index, pptr);
+#else
+    *pptr = SampleBuf[SBout_Index];
+#endif
+    ++pptr;
+    if (++SBout_Index >= TOTAL_SAMPLE_SETS)
+    {
+      SBout_Index = 0;
+    }
+  }
+
+  FlashPipe.Sets[FlashPipe.Next] = num_sets;
+  FlashPipe.Gathered += num_sets;
+  FlashPipe.Ready = TRUE;
+  return (TRUE);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION      Flash_PipeGather()
+//------------------------------------------------------------------------------------------------------------
+
+#else                   // ENABLE_WF_CODEC
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION    Flash_PipeCode()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Code the Next Flash Page
+//                      
+//  MECHANICS:          This subroutine fills page buffer FlashPipe.Next with the next page of a coded
+//                      waveform capture (see WfCodec_def.h for the layout):
+//                        1) While there is less than a page of coded bytes waiting in WfCodecStage[], the
+//                           next cycle is coded into it (WfCodec_EncodeCycle()), and its index entry is
+//                           filled in.  A cycle is only coded once all 80 of its sample sets have been
+//                           received, the same as Flash_PipeGather().  Unfilled precycles
+//                           (FlashPipe.ZeroSets) are coded as zeros
+//                        2) If there is a full page waiting, or all of the cycles have been coded, the next
+//                           256 bytes are moved into the page buffer (the last data page is padded with
+//                           0xFF).  The data pages start after the index pages.  FlashPipe.Sets[] is set to
+//                           the number of cycles whose last byte is in this page
+//                        3) Once all of the data has been gathered, or the capture has been aborted, the
+//                           index pages are gathered from WfCodecIndex[], at the start of the capture
+//                      Since the index is written last, a capture that is read before it is done (or one
+//                      that was lost in a power failure) reads as having no cycles.
+//                      
+//  CAVEATS:            Only included if ENABLE_WF_CODEC is defined.
+//                      Must not be called while page buffer FlashPipe.Next is being sent.  This is ensured
+//                      because Flash_PipeStart() switches to the other buffer.
+//                      Each cycle takes about 250usec to code.  A page normally needs one new cycle.
+//                      
+//  INPUTS:             SBout_Index, SampleIndex, SampleBuf, FlashPipe.xx
+//                      
+//  OUTPUTS:            FlashCodecPgBuf[FlashPipe.Next][], FlashPipe.PgAdd[FlashPipe.Next]
+//                      The subroutine returns True if the page was gathered, False otherwise
+//                      
+//  ALTERS:             SBout_Index, WfCodecStage[], WfCodecIndex[], FlashPipe.xx
+//                      
+//  CALLS:              memcpy(), memmove(), memset(), WfCodec_EncodeCycle()
+// 
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Flash_PipeCode(void)
+{
+  uint8_t *pptr;
+  uint32_t pg_end, cyc_end;
+  uint16_t ndx, avail, len;
+  uint8_t num_zeros, num_cyc;
+
+  if (FlashPipe.Ready)
+  {
+    return (FALSE);
+  }
+
+  // Code cycles until there is a full page of coded bytes waiting
+  while ( (!FlashPipe.Aborted) && (FlashPipe.Cycles < WF_CODEC_CYCLES)
+       && ((FlashPipe.StageFill - FlashPipe.StageOut) < 256) )
+  {
+    num_zeros = ( (FlashPipe.ZeroSets > WF_CODEC_SAMPLES) ? WF_CODEC_SAMPLES : FlashPipe.ZeroSets );
+    // Make sure the sample sets that come from SampleBuf have been received (see Flash_PipeGather())
+    if (num_zeros < WF_CODEC_SAMPLES)
+    {
+      ndx = SBout_Index + num_zeros;
+      if (ndx >= TOTAL_SAMPLE_SETS)
+      {
+        ndx -= TOTAL_SAMPLE_SETS;
+      }
+      avail = SampleIndex;
+      avail = ( (avail >= ndx) ? (avail - ndx) : ((avail + TOTAL_SAMPLE_SETS) - ndx) );
+      if (avail < (WF_CODEC_SAMPLES - num_zeros))
+      {
+        return (FALSE);
+      }
+    }
+    if (FlashPipe.StageOut > 0)         // Move the bytes that are still waiting to the start of the stage
+    {
+      memmove(&WfCodecStage[0], &WfCodecStage[FlashPipe.StageOut],
+              (FlashPipe.StageFill - FlashPipe.StageOut));
+      FlashPipe.StageFill -= FlashPipe.StageOut;
+      FlashPipe.StageOut = 0;
+    }
+    // The unfilled precycles run up to the end of SampleBuf, so the first set after them is at index 0.
+    //   WfCodec_EncodeCycle() skips over them the same way
+    WfCodecIndex[FlashPipe.Cycles].Offset = WF_CODEC_DATA_START + FlashPipe.DataBytes;
+    len = WfCodec_EncodeCycle(SBout_Index, num_zeros, &WfCodecStage[FlashPipe.StageFill],
+                              &WfCodecIndex[FlashPipe.Cycles].Mode[0]);
+    FlashPipe.StageFill += len;
+    FlashPipe.DataBytes += len;
+    ++FlashPipe.Cycles;
+    FlashPipe.ZeroSets -= num_zeros;
+    SBout_Index += WF_CODEC_SAMPLES;
+    if (SBout_Index >= TOTAL_SAMPLE_SETS)
+    {
+      SBout_Index -= TOTAL_SAMPLE_SETS;
+    }
+  }
+
+  pptr = (uint8_t *)(&FlashCodecPgBuf[FlashPipe.Next][0]);
+  len = FlashPipe.StageFill - FlashPipe.StageOut;
+  if ( (!FlashPipe.Aborted) && (len > 0) && ((len >= 256) || (FlashPipe.Cycles >= WF_CODEC_CYCLES)) )
+  {                                     // Data page
+    len = ( (len > 256) ? 256 : len );
+    memcpy(pptr, &WfCodecStage[FlashPipe.StageOut], len);
+    memset((pptr + len), 0xFF, (256 - len));
+    FlashPipe.StageOut += len;
+    FlashPipe.PgAdd[FlashPipe.Next] = FlashPipe.SlotAdd + WF_CODEC_INDEX_PAGES + FlashPipe.DataPages;
+    ++FlashPipe.DataPages;
+    // Count the cycles that end in this page.  A cycle ends where the next one starts, and the last one
+    //   that has been coded ends at the end of the coded bytes
+    pg_end = WF_CODEC_DATA_START + ((uint32_t)FlashPipe.DataPages << 8);
+    num_cyc = 0;
+    while (FlashPipe.Credited < FlashPipe.Cycles)
+    {
+      cyc_end = ( ((FlashPipe.Credited + 1) < FlashPipe.Cycles) ? WfCodecIndex[FlashPipe.Credited + 1].Offset
+                                                    : (WF_CODEC_DATA_START + FlashPipe.DataBytes) );
+      if (cyc_end > pg_end)
+      {
+        break;
+      }
+      ++FlashPipe.Credited;
+      ++num_cyc;
+    }
+    FlashPipe.Sets[FlashPipe.Next] = num_cyc;
+  }
+  else if ( ((FlashPipe.Aborted) || (FlashPipe.Cycles >= WF_CODEC_CYCLES))
+         && (FlashPipe.IndexSent < WF_CODEC_INDEX_PAGES) )
+  {                                     // Index page
+    len = sizeof(WfCodecIndex) - ((uint16_t)FlashPipe.IndexSent << 8);
+    len = ( (len > 256) ? 256 : len );
+    memcpy(pptr, ((uint8_t *)(&WfCodecIndex[0]) + ((uint16_t)FlashPipe.IndexSent << 8)), len);
+    memset((pptr + len), 0xFF, (256 - len));
+    FlashPipe.PgAdd[FlashPipe.Next] = FlashPipe.SlotAdd + FlashPipe.IndexSent;
+    ++FlashPipe.IndexSent;
+    FlashPipe.Sets[FlashPipe.Next] = 0;
+  }
+  else                                  // Nothing to write.  This should not happen
+  {
+    return (FALSE);
+  }
+
+  FlashPipe.Ready = TRUE;
+  return (TRUE);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION      Flash_PipeCode()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_WF_CODEC
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION    Flash_PipeStart()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Start a Flash Page Program
+//                      
+//  MECHANICS:          This subroutine issues the write enable (WREN) instruction and the page program (PP)
+//                      command and address, the same as Flash_WriteWaveform() State 1, and then starts DMA2
+//                      Stream 3 Channel 3 (SPI1_TX) to send page buffer FlashPipe.Next.  The chip select is
+//                      left active.  It is released by Flash_PipeDone() from the DMA transfer complete
+//                      interrupt, which starts the page program.  FlashPipe.Next is switched to the other
+//                      page buffer, so the next page can be gathered while this one is sent.
+//                      At 15MHz, the 126 words of a full page take about 135usec to send.  This time is no
+//                      longer spent polling TXE in the Timer10 interrupt.
+//                      In the host build there is no SPI1 hardware, so the page is sent to the Flash model
+//                      in HostShim.c (Host_FlashFrame()) and finished immediately.
+//                      If ENABLE_WF_CODEC is defined, the page buffers are FlashCodecPgBuf[][], and a full
+//                      page (128 words) is always sent.
+//                      
+//  CAVEATS:            Only included if ENABLE_SPI1_DMA is defined.
+//                      Page buffer FlashPipe.Next must have been gathered.
+//                      
+//  INPUTS:             flash_addr - the sector (b15..b4) and page (b3..0) address
+//                      FlashPgBuf[FlashPipe.Next][], FlashPipe.Sets[FlashPipe.Next]
+//                      
+//  OUTPUTS:            FlashPipe.Next, FlashPipe.Ready, FlashPipe.Programming, FlashPipe.DmaBusy
+//                      
+//  ALTERS:             SPI1->DR, SPI1->CR2, DMA2_Stream3 registers, DMA2->LIFCR
+//                      
+//  CALLS:              Init_SPI1(), Flash_PipeDone(), Host_FlashSelect(), Host_FlashFrame(),
+//                      Host_FlashDeselect()
+// 
+//------------------------------------------------------------------------------------------------------------
+
+void Flash_PipeStart(uint16_t flash_addr)
+{
+  uint16_t *wptr;
+  uint16_t num_words;
+#ifdef HOST_BUILD
+  uint16_t i;
+#else
+  volatile uint16_t temp;
+#endif
+
+#ifdef ENABLE_WF_CODEC
+  wptr = &FlashCodecPgBuf[FlashPipe.Next][0];
+  num_words = 128;
+#else
+  wptr = (uint16_t *)(&FlashPgBuf[FlashPipe.Next][0].Ia);
+  num_words = FlashPipe.Sets[FlashPipe.Next] * (sizeof(struct RAM_SAMPLES)/2);
+#endif
+  FlashPipe.Next ^= 1;
+  FlashPipe.Ready = FALSE;
+  FlashPipe.Programming = TRUE;
+  FlashPipe.DmaBusy = TRUE;
+
+#ifdef HOST_BUILD
+  Host_FlashSelect();
+  Host_FlashFrame(0, FLASH_WREN);
+  Host_FlashDeselect();
+  Host_FlashSelect();
+  Host_FlashFrame(1, ((((uint16_t)FLASH_PP) << 8) + (flash_addr >> 8)));
+  Host_FlashFrame(1, (uint16_t)(flash_addr << 8));
+  for (i=0; i<num_words; ++i)
+  {
+    Host_FlashFrame(1, wptr[i]);
+  }
+  Flash_PipeDone();
+#else
+  // Issue write enable command
+  Init_SPI1(DEV_FRAM_FLASH8);               // Initialize SPI to transfer bytes
+  FLASH_CSN_ACTIVE;
+  SPI1->DR = FLASH_WREN;
+  while ( (SPI1->SR & (SPI_SR_RXNE + SPI_SR_TXE)) != (SPI_SR_RXNE + SPI_SR_TXE) )
+  {
+  }
+  temp = SPI1->DR;
+  FLASH_CSN_INACTIVE;                       // Don't need delay since Init_SPI1() is called next
+
+  // Issue page program command and the address
+  Init_SPI1(DEV_FRAM_FLASH16);              // Initialize SPI to output words  (routine takes 600nsec)
+  FLASH_CSN_ACTIVE;                         // Send out page program cmnd and ms byte of sector address
+  SPI1->DR = (((uint16_t)FLASH_PP) << 8) + (flash_addr >> 8);
+  while ((SPI1->SR & SPI_SR_TXE) != SPI_SR_TXE)
+  {
+  }
+  SPI1->DR = (flash_addr << 8);             // Send out ls nibble of sector address, page address, and byte
+                                            //   address (byte address is 0x00)
+
+  // Send out the data with DMA2 Stream 3.  The DMA request waits for TXE, so the address frame is finished
+  //   first
+  DMA2_Stream3->CR &= 0xF0000000;           // Make sure the stream is disabled before configuring it
+  while (DMA2_Stream3->CR & 0x00000001)
+  {
+  }
+  DMA2->LIFCR = 0x0F400000;                 // Clear the Stream 3 flags (b27..24, b22)
+  DMA2_Stream3->CR |= SPI1_DMA_CR;
+  DMA2_Stream3->M0AR = (uint32_t)wptr;
+  DMA2_Stream3->NDTR = num_words;
+  DMA2_Stream3->CR |= 0x00000001;           // Enable the stream
+  SPI1->CR2 |= SPI_CR2_TXDMAEN;             // Enable the SPI1 Tx DMA request to start the transfer
+#endif
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION      Flash_PipeStart()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION    Flash_PipeDone()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Finish Sending a Flash Page
+//                      
+//  MECHANICS:          This subroutine is called from the DMA2 Stream 3 transfer complete interrupt when the
+//                      page data has been written to SPI1.  It waits for the last word to be shifted out,
+//                      releases the chip select (this starts the page program), and clears the receive
+//                      overrun that was caused by not reading the receive data (read DR, then SR).
+//                      
+//  CAVEATS:            Only included if ENABLE_SPI1_DMA is defined.
+//                      Waits for up to two words (about 2usec) for SPI1 to finish shifting out the data
+//                      
+//  INPUTS:             None
+//                      
+//  OUTPUTS:            FlashPipe.DmaBusy
+//                      
+//  ALTERS:             SPI1->CR2, DMA2->LIFCR
+//                      
+//  CALLS:              Host_FlashDeselect()
+// 
+//------------------------------------------------------------------------------------------------------------
+
+void Flash_PipeDone(void)
+{
+#ifdef HOST_BUILD
+  Host_FlashDeselect();
+#else
+  volatile uint16_t temp;
+
+  DMA2->LIFCR = 0x0F400000;                 // Clear the Stream 3 flags (b27..24, b22)
+  while ( (SPI1->SR & (SPI_SR_TXE + SPI_SR_BSY)) != SPI_SR_TXE )
+  {                                         // Wait for the last word to be shifted out
+  }
+  SPI1->CR2 &= (~SPI_CR2_TXDMAEN);
+  temp = SPI1->DR;                          // Clear RXNE and OVR flags by reading data reg then status reg
+  temp = SPI1->SR;
+  FLASH_CSN_INACTIVE;                       // Deselect the Flash to start the page program
+#endif
+  FlashPipe.DmaBusy = FALSE;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION      Flash_PipeDone()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION    Flash_PipeStatus()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Read the Flash Status Register
+//                      
+//  MECHANICS:          This subroutine issues the read status register (RDSR) instruction and a dummy byte
+//                      and returns the status, the same as Flash_WriteWaveform() State 2.  b7 is the busy
+//                      bit.
+//                      In the host build, the status is read from the Flash model in HostShim.c.
+//                      
+//  CAVEATS:            Only included if ENABLE_SPI1_DMA is defined.
+//                      
+//  INPUTS:             None
+//                      
+//  OUTPUTS:            The subroutine returns the status register
+//                      
+//  ALTERS:             None
+//                      
+//  CALLS:              Init_SPI1(), Host_FlashSelect(), Host_FlashFrame(), Host_FlashDeselect()
+// 
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Flash_PipeStatus(void)
+{
+  uint16_t temp;
+
+#ifdef HOST_BUILD
+  Host_FlashSelect();
+  temp = Host_FlashFrame(1, (((uint16_t)FLASH_RDSR) << 8));
+  Host_FlashDeselect();
+#else
+  // Initialize SPI to output words.  Must reinitialize SPI in case it was used by a different thread
+  Init_SPI1(DEV_FRAM_FLASH16);
+
+  // Issue read status register command and dummy byte to retrieve the data
+  FLASH_CSN_ACTIVE;
+  SPI1->DR = ((uint16_t)FLASH_RDSR) << 8;
+                                            // Wait for the transfer to complete
+  while ( (SPI1->SR & (SPI_SR_RXNE + SPI_SR_TXE)) != (SPI_SR_RXNE + SPI_SR_TXE) )
+  {
+  }
+  temp = SPI1->DR;                          // Save status and clear RXNE flag
+  FLASH_CSN_INACTIVE;                       // Deselect the Flash device (Chip select hold time = 8nsec)
+#endif
+  return ((uint8_t)temp);
+}
+
 //------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION      Flash_PipeStatus()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_SPI1_DMA
 
 
 
@@ -3870,13 +5655,24 @@ uint8_t Flash_EraseSectorBlock(uint16_t flash_addr, uint8_t SectorErase)
 //                      
 //  ALTERS:             None
 //                      
-//  CALLS:              Init_SPI1()
+//  CALLS:              Init_SPI1(), Host_FlashSelect(), Host_FlashFrame(), Host_FlashDeselect()
 // 
 //------------------------------------------------------------------------------------------------------------
 
 void Flash_Read(uint32_t flash_address, uint16_t length, uint16_t *outptr)
 {
   uint8_t i;
+#ifdef HOST_BUILD
+  // In the host build there is no SPI1 hardware, so the read is sent to the Flash model in HostShim.c
+  Host_FlashSelect();
+  Host_FlashFrame(1, ((((uint16_t)FLASH_RD) << 8) + (uint16_t)(flash_address >> 16)));
+  Host_FlashFrame(1, (uint16_t)(flash_address));
+  for (i=0; i<length; ++i)
+  {
+    *outptr++ = Host_FlashFrame(1, 0);
+  }
+  Host_FlashDeselect();
+#else
   volatile uint16_t temp;
 
   Init_SPI1(DEV_FRAM_FLASH16);          // Initialize SPI to output words
@@ -3908,6 +5704,7 @@ void Flash_Read(uint32_t flash_address, uint16_t length, uint16_t *outptr)
     *outptr++ = SPI1->DR;               // Clear RXNE flag by reading data reg and capture data
   }
   FLASH_CSN_INACTIVE;                    // Deselect the Flash device (Chip select high time= 25nsec)
+#endif
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -4029,6 +5826,9 @@ uint16_t EEPOT_Xfer(uint16_t WrData)
   uint16_t temp;
   uint8_t i;
 
+#ifdef ENABLE_SPI2_DMA
+  SPI2_Flush();                         // Let the queued FRAM transactions finish before using SPI2
+#endif
   Init_SPI2(DEV_EEPOT_16);              // Initialize SPI to output words
 
   EEPOT_CSN_ACTIVE;                     // Select the EEPOT device (Chip select set-up time= 60ns)
@@ -4175,11 +5975,11 @@ uint8_t EEPOT_Write(void)
 //                      
 //  INPUTS:             dev - the device for which the cal constants are desired
 //                      
-//  OUTPUTS:            SystemFlags, AFEcal.x
+//  OUTPUTS:            SystemFlags, AFEcal.x, AFEcoef (ENABLE_CAL_BIAS defined)
 //                      
 //  ALTERS:             None
 //                      
-//  CALLS:              Init_SPI2()
+//  CALLS:              Init_SPI2(), Apply_CalConstants()
 // 
 //------------------------------------------------------------------------------------------------------------
 
@@ -4262,6 +6062,7 @@ void ReadAFECalConstants(void)
     }
   }
 
+  Apply_CalConstants();                 // Compute the coefficients used to scale the samples
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -4392,11 +6193,11 @@ void ReadAFECalConstants1(uint8_t *dest)
 //                      
 //  INPUTS:             dev - the device for which the cal constants are desired
 //                      
-//  OUTPUTS:            SystemFlags, ADCcalHigh.x
+//  OUTPUTS:            SystemFlags, ADCcalHigh.x, ADCcoefHigh (ENABLE_CAL_BIAS defined)
 //                      
 //  ALTERS:             None
 //                      
-//  CALLS:              FRAM_Read(), Flash_Read(), ComputeChksum32()
+//  CALLS:              FRAM_Read(), Flash_Read(), ComputeChksum32(), Apply_CalConstants()
 // 
 //------------------------------------------------------------------------------------------------------------
 
@@ -4467,6 +6268,7 @@ void ReadADCHCalConstants(void)
     }
   }
 
+  Apply_CalConstants();                 // Compute the coefficients used to scale the samples
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -4589,11 +6391,11 @@ void ReadADCHCalConstants1(uint8_t *dest)
 //                      
 //  INPUTS:             dev - the device for which the cal constants are desired
 //                      
-//  OUTPUTS:            SystemFlags, ADCcalLow.x
+//  OUTPUTS:            SystemFlags, ADCcalLow.x, ADCcoefLow (ENABLE_CAL_BIAS defined)
 //                      
 //  ALTERS:             None
 //                      
-//  CALLS:              FRAM_Read(), Flash_Read(), ComputeChksum32()
+//  CALLS:              FRAM_Read(), Flash_Read(), ComputeChksum32(), Apply_CalConstants()
 // 
 //------------------------------------------------------------------------------------------------------------
 
@@ -4664,6 +6466,7 @@ void ReadADCLCalConstants(void)
     }
   }
 
+  Apply_CalConstants();                 // Compute the coefficients used to scale the samples
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -5802,6 +7605,18 @@ void SPI1_Flash_Manager(void)
         }
         else if (TP.Temp < 37)                      // If indicator 0 - 36, read waveform
         {
+#ifdef ENABLE_WF_CODEC
+          // Coded capture: TP.Tmp2.u holds the address of the capture, and TP.Temp the cycle (1 - 36).  The
+          //   samples to read follow the ones that have already been displayed (TP.Tmp1.b[1] already
+          //   includes the TP.Tmp1.b[0] samples to read now).  TP.Tmp1.b[3] is the offset of the value in
+          //   the sample set, which selects the channel.  If the cycle was not written, the samples read
+          //   as erased Flash, the same as an uncoded capture
+          if (!WfCodec_Read(TP.Tmp2.u, (TP.Temp - 1), WF_CODEC_CHAN(TP.Tmp1.b[3]),
+                            (TP.Tmp1.b[1] - TP.Tmp1.b[0]), TP.Tmp1.b[0], (uint8_t *)(&tbuf.fval[0])))
+          {
+            memset(&tbuf.fval[0], 0xFF, (TP.Tmp1.b[0] * sizeof(float)));
+          }
+#else
           // Read samples from the trip, alarm, or strp-chart waveform log from Flash starting with the
           //   address in TP.Tmp2.u.  Store in tbuf[]
           // TP.Temp1.b[3] holds the offset in the sample set.  If less than 20, we are reading currents,
@@ -5823,6 +7638,7 @@ void SPI1_Flash_Manager(void)
               TP.Tmp2.u += (sizeof(struct RAM_SAMPLES));
             }
           }
+#endif
           SPI1Flash.Ack |= S1F_TP_RD_REQ;
           SPI1Flash.State = S1F_IDLE;
           S1F_exit = TRUE;
@@ -5879,6 +7695,14 @@ void SPI1_Flash_Manager(void)
         break;
 
       case S1F_EXT_WF_BLKERASE2:       // Extended-Capture Block Erase
+#if defined(ENABLE_WF_CODEC) && (WF_CODEC_SLOT_BLOCKS == 1)
+        // A coded capture fits in the first block of its slot unless WF_CODEC_I_MAX_ERR is defined (see
+        //   WfCodec_def.h), so the second block does not have to be erased
+        SPI1Flash.Ack |= S1F_EXT_WF_ERASE1;
+        SPI1Flash.State = S1F_IDLE;
+        S1F_exit = TRUE;
+        break;
+#endif
         if (Flash_EraseSectorBlock((Ext_WF_Capture.FlashAdd + 0x0100), FALSE) )   // Erase the second block
         {                                                             //   Subroutine returns True when done
           SPI1Flash.Ack |= S1F_EXT_WF_ERASE1;
@@ -5924,6 +7748,14 @@ void SPI1_Flash_Manager(void)
         break;
 
       case S1F_TRIP_WF_BLKERASE2:       // Trip Waveform Block Erase
+#if defined(ENABLE_WF_CODEC) && (WF_CODEC_SLOT_BLOCKS == 1)
+        // A coded capture fits in the first block of its slot unless WF_CODEC_I_MAX_ERR is defined (see
+        //   WfCodec_def.h), so the second block does not have to be erased
+        SPI1Flash.Ack |= S1F_TRIP_WF_ERASE1;
+        SPI1Flash.State = S1F_IDLE;
+        S1F_exit = TRUE;
+        break;
+#endif
         if (Flash_EraseSectorBlock((Trip_WF_Capture.FlashAdd + 0x0100), FALSE) )   // Erase the second block
         {                                                             //   Subroutine returns True when done
           SPI1Flash.Ack |= S1F_TRIP_WF_ERASE1;
@@ -5976,6 +7808,14 @@ void SPI1_Flash_Manager(void)
         break;
 
       case S1F_ALARM_WF_BLKERASE2:      // Alarm Waveform Block Erase
+#if defined(ENABLE_WF_CODEC) && (WF_CODEC_SLOT_BLOCKS == 1)
+        // A coded capture fits in the first block of its slot unless WF_CODEC_I_MAX_ERR is defined (see
+        //   WfCodec_def.h), so the second block does not have to be erased
+        SPI1Flash.Ack |= S1F_ALARM_WF_ERASE1;
+        SPI1Flash.State = S1F_IDLE;
+        S1F_exit = TRUE;
+        break;
+#endif
         if (Flash_EraseSectorBlock((Alarm_WF_Capture.FlashAdd + 0x0100), FALSE) )  // Erase the second block
         {                                                             //   Subroutine returns True when done
           SPI1Flash.Ack |= S1F_ALARM_WF_ERASE1;
@@ -6010,6 +7850,30 @@ void SPI1_Flash_Manager(void)
         //   sample set offset = 0 --> sample in subsequent pages all start in the first sample set
         //   value offset = 2 x 4 = 8 --> offset within a sample set of the requested value
  
+#ifdef ENABLE_WF_CODEC
+        // Coded capture (see WfCodec.c): DPComm.RxMsgSav[3..0] holds the address of the capture, and
+        //   DPComm.RxMsgSav[6] (the value offset) selects the channel.  The cycle of the channel is one
+        //   block, so all of the samples are read and decoded at once.  If the cycle was not written, the
+        //   samples read as erased Flash, the same as an uncoded capture
+        temp32 = ((uint32_t)DPComm.RxMsgSav[3] << 24) + ((uint32_t)DPComm.RxMsgSav[2] << 16)
+               + ((uint32_t)DPComm.RxMsgSav[1] << 8) + ((uint32_t)DPComm.RxMsgSav[0]);
+        cycnum = DPComm.TxDelMsgBuf[14];
+        indx = (((uint16_t)DPComm.RxMsgSav[8])<< 8) + DPComm.RxMsgSav[7];
+        num = ( (DPComm.RxMsgSav[4] > WF_CODEC_SAMPLES) ? WF_CODEC_SAMPLES : DPComm.RxMsgSav[4] );
+        j = WF_CODEC_CHAN(DPComm.RxMsgSav[6]);
+        i = ( (j < WF_CODEC_NUM_I) ? sizeof(float) : sizeof(int16_t) );     // Bytes per sample
+        if (!WfCodec_Read(temp32, cycnum, j, 0, num, &DPComm.TxDelMsgBuf[indx]))
+        {
+          memset(&DPComm.TxDelMsgBuf[indx], 0xFF, (num * i));
+        }
+        indx += (num * i);
+        SPI1Flash.Ack |= S1F_RD_WF;             // Set the Ack flag since done
+        SPI1Flash.State = S1F_IDLE;
+        DPComm.TxDelMsgBuf[8] = (uint8_t)(indx - 10);         // LS byte of buffer length
+        DPComm.TxDelMsgBuf[9] = (uint8_t)((indx - 10) >> 8);  // MS byte of buffer length
+        S1F_exit = TRUE;
+        break;
+#else
         // Assemble the base address of the first sample
         //   This address accounts for the waveform type (trip, alarm, extended capture), index,
         //   cycle number, and value offset.  These values remain constant for all of the samples
@@ -6096,6 +7960,7 @@ void SPI1_Flash_Manager(void)
         }
         S1F_exit = TRUE;
         break;
+#endif
 
 
       case S1F_CHECK_CAL_CONSTS:        // Check Calibration Constants
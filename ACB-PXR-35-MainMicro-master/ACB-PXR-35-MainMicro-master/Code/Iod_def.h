@@ -211,6 +211,34 @@
 //   142    240119  DAH - Added S1F_AFECAL_RD1, S1F_ADCHCAL_RD1, and S1F_ADCLCAL_RD1 definitions to SPI1
 //                        access flags
 //                      - Added SKIP_LOOPTIME_MEAS to System Flag (SystemFlags) definitions
+//   155    240207  DAH - Added ENABLE_STAGE_PROFILER definition (commented out)
+//   157    240209  DAH - Added ENABLE_SAMPLE_SOA definition (commented out)
+//   158    240210  DAH - Added ENABLE_SIMD_SOS definition (commented out)
+//   161    240213  DAH - Added ENABLE_MAIN_SCHED definition (commented out)
+//   162    240214  DAH - Added ENABLE_LOOP_TRACE definition (commented out)
+//   163    240215  DAH - Added ENABLE_SPI2_DMA definition (commented out)
+//                      - Added the SPI2 transaction engine constants (SPI2_xx) and structures
+//                        (struct SPI2_SEG, struct SPI2_XACT, struct SPI2_ENGINE, struct SPI2_POST)
+//   164    240216  DAH - Added ENABLE_SPI1_DMA definition (commented out)
+//                      - Added the Flash waveform pipeline constants (FLASH_PG_SETS, FLASH_WF_SETS,
+//                        SPI1_DMA_CR, TIM10_ARR_xx) and struct FLASH_PIPE
+//   165    240217  DAH - Added ENABLE_WF_CODEC definition (commented out)
+//                      - Added the coded waveform fields to struct FLASH_PIPE
+//   166    240218  DAH - Added ENABLE_EID_INDEX definition (commented out)
+//   167    240219  DAH - Added ENABLE_EVENT_QUEUE definition (commented out)
+//   168    240220  DAH - Added ENABLE_EVENT_WC definition (commented out)
+//   169    240221  DAH - Added ENABLE_CRC_SLICE definition (commented out)
+//   170    240222  DAH - Added ENABLE_DP_TX_SG definition (commented out)
+//   171    240223  DAH - Added ENABLE_MODB_REG_INDEX definition (commented out)
+//   172    240224  DAH - Added ENABLE_MODB_RTD_CACHE definition (commented out)
+//   173    240225  DAH - Added ENABLE_PROT_TABLE definition (commented out)
+//   174    240226  DAH - Added ENABLE_ONECYC_KERNEL definition (commented out)
+//   175    240227  DAH - Added ENABLE_SEQ_PHASOR definition (commented out)
+//   176    240228  DAH - Added ENABLE_FREQ_TRACK and ENABLE_FREQ_RETUNE definitions (commented out)
+//   177    240229  DAH - Added ENABLE_CAM_SV_FRAME definition (commented out)
+//   179    240302  DAH - Added ENABLE_HARM_FOLD definition (commented out)
+//                      - Added ENABLE_CAL_BIAS definition (commented out)
+//                      - Deleted ENABLE_PROT_TABLE and ENABLE_ONECYC_KERNEL definitions
 //------------------------------------------------------------------------------------------------------------
 //
 //------------------------------------------------------------------------------------------------------------
@@ -231,6 +259,27 @@
 // Definitions
 //#define ENABLE_GOOSE_COMM_SPEED_TEST // This enable the Tracepoint Test pins for measuring the Goose Comm Time.
 //#define ENABLE_GOOSE_COMM_AUTOSEND // This enables the auto send(Same as EAG77 command)
+//#define ENABLE_STAGE_PROFILER // This enables the execution-time stage profiler (see Profile.c)
+//#define ENABLE_HARM_FOLD // This computes the harmonics with the cycle-folded DFT (see Calc_Harmonics())
+//#define ENABLE_CAL_BIAS // This scales the samples with x * gain + bias (see Apply_CalConstants())
+//#define ENABLE_SAMPLE_SOA // This stores SampleBuf by channel instead of by sample set (see Intr_def.h)
+//#define ENABLE_SIMD_SOS // This computes the one-cycle voltage sums of squares from SampleBuf (see Intr.c)
+//#define ENABLE_MAIN_SCHED // This runs the main loop with the cooperative task scheduler (see Sched.c)
+//#define ENABLE_LOOP_TRACE // This enables the main loop latency tracer (see Trace.c)
+//#define ENABLE_SPI2_DMA // This runs the FRAM accesses through the SPI2 transaction engine (see Iod.c)
+//#define ENABLE_SPI1_DMA // This writes the waveform captures to Flash with the SPI1 DMA pipeline (see Iod.c)
+//#define ENABLE_WF_CODEC // This codes the waveform captures in Flash (see WfCodec.c).  Needs ENABLE_SPI1_DMA
+//#define ENABLE_EID_INDEX // This looks up event log EIDs in a RAM index instead of FRAM (see Events.c)
+//#define ENABLE_EVENT_QUEUE // This inserts the interrupt events without disabling interrupts (see Events.c)
+//#define ENABLE_EVENT_WC // This combines the event log FRAM writes (see EventWC_Commit() in Events.c)
+//#define ENABLE_CRC_SLICE // This computes the comms CRCs with the slicing-by-8 tables (see Crc.c)
+//#define ENABLE_DP_TX_SG // This encodes the RTD display packets from spans (requires ENABLE_CRC_SLICE)
+//#define ENABLE_MODB_REG_INDEX // This finds the Modbus address groups with a page index (see Modbus.c)
+//#define ENABLE_MODB_RTD_CACHE // This reads Modbus RTD from a 200msec snapshot (needs ENABLE_MODB_REG_INDEX)
+//#define ENABLE_SEQ_PHASOR // This computes the sequence components each cycle (see Calc_SeqComp_PhAng())
+//#define ENABLE_FREQ_TRACK // This tracks frequency and ROCOF from Van zero crossings (see Calc_FreqTrack())
+//#define ENABLE_FREQ_RETUNE // This tunes the sample rate to 80 samples per cycle (needs ENABLE_FREQ_TRACK)
+//#define ENABLE_CAM_SV_FRAME // This sends the sampled values to the CAMs in frames (needs ENABLE_CRC_SLICE)
 
 //   Note: For BSRR registers, BSRRH (bits 16-31 of BSRR register) resets the corresponding ODR bits
 //     BSRRL (bits 0-15 of BSRR register) sets the corresponding ODR bits
@@ -532,6 +581,65 @@
 
 
 
+// SPI2 transaction engine (only used if ENABLE_SPI2_DMA is defined).  See SPI2_Submit() in Iod.c
+#define SPI2_QUEUE_SIZE         8           // Max number of queued transactions (must be a power of 2)
+#define SPI2_MAX_SEGS           9           // Max number of data segments in one transaction
+#define SPI2_POST_SLOTS         8           // Number of posted write slots (must be a power of 2)
+#define SPI2_POST_WORDS         16          // Max length (in words) of a posted write
+
+// Transaction operation (struct SPI2_XACT.Op)
+#define SPI2_OP_READ            0
+#define SPI2_OP_WRITE           1
+
+// Transaction frame width (struct SPI2_XACT.Width).  16-bit transactions use a 24-bit FRAM address (on-board
+//   FRAM), 8-bit transactions use a 16-bit FRAM address (Frame FRAM).  This matches FRAM_Read()/FRAM_Write()
+//   and Frame_FRAM_Read()/Frame_FRAM_Write()
+#define SPI2_8BIT               0
+#define SPI2_16BIT              1
+
+// Transaction status (struct SPI2_XACT.Status)
+#define SPI2_XS_IDLE            0           // Not in use
+#define SPI2_XS_QUEUED          1           // Waiting in the queue
+#define SPI2_XS_ACTIVE          2           // Being transferred
+#define SPI2_XS_DONE            3           // Transfer done (the callback has been called)
+
+// Engine phase (struct SPI2_ENGINE.Phase)
+#define SPI2_PH_IDLE            0           // No transaction in progress
+#define SPI2_PH_WREN            1           // Write enable opcode being sent
+#define SPI2_PH_HDR             2           // Opcode and address being sent
+#define SPI2_PH_RDATA           3           // Read data being received (SPI2 RXNE interrupt)
+#define SPI2_PH_WDATA           4           // Write data being sent (DMA1 Stream 4)
+
+// DMA1 Stream 4 (SPI2 Tx) configuration for the write data.  See Init_DMAController1() for the bit
+//   definitions.  Channel 0, medium priority, memory incremented, memory to peripheral, transfer complete
+//   interrupt enabled, half-word (CR16) or byte (CR8) transfers
+#define SPI2_DMA_CR16           0x00012C50
+#define SPI2_DMA_CR8            0x00010450
+
+// Flash waveform pipeline (only used if ENABLE_SPI1_DMA is defined).  See Flash_PipeService() in Iod.c
+#define FLASH_PG_SETS           7           // Sample sets per Flash page (7 x 36 = 252 bytes)
+#define FLASH_WF_SETS           2880        // Sample sets per waveform capture (36 cycles)
+
+// DMA2 Stream 3 (SPI1 Tx) configuration for the page data.  See Init_DMAController2() for the bit
+//   definitions.  Channel 3, medium priority, memory incremented, memory to peripheral, transfer complete
+//   interrupt enabled, half-word transfers
+#define SPI1_DMA_CR             0x06012C50
+
+// Timer10 reload values (see Init_TIM10()).  Timer10 normally interrupts every 1.5msec.  While a waveform is
+//   being written with the pipeline, the first status read after a page is started is timed to the learned
+//   page time (FlashPipe.WaitArr), and the following reads are every 20usec (FlashPipe.PollArr), so that the
+//   end of each page program is seen soon after it occurs.  The learned page time is trimmed by
+//   TIM10_ARR_TRIM (about 10usec) each time the first read finds the page already done, and is kept between
+//   FlashPipe.PollArr and TIM10_ARR_WAIT_MAX.  While the samples for the next page are being received,
+//   Timer10 interrupts every 100usec.  The times include a 2% margin
+#define TIM10_ARR_1500USEC      15299
+#define TIM10_ARR_100USEC       1019
+#define TIM10_ARR_20USEC        203
+#define TIM10_ARR_TRIM          102
+#define TIM10_ARR_WAIT_MAX      (TIM10_ARR_1500USEC + TIM10_ARR_100USEC + TIM10_ARR_100USEC)
+
+
+
 // System Flag (SystemFlags) Definitions
 //   Note, these must only be altered in the foreground (not in any interrupts)!!  *** DAH  MAKE SURE THIS IS TRUE
 #define CAL_FRAM_ERR        0x0001
@@ -700,6 +808,82 @@ struct SPI1VARS
 };
 
 
+// SPI2 transaction engine data segment.  The segments of a transaction are transferred back-to-back with the
+//   chip select held active, so data that is spread over several structures can be transferred as one block
+struct SPI2_SEG
+{
+   void     *Ptr;                   // Data address (bytes for 8-bit transactions, words for 16-bit)
+   uint16_t Len;                    // Data length, in frames (bytes or words)
+};
+
+// SPI2 transaction.  The transaction must not be changed (or go out of scope) until Status is SPI2_XS_DONE.
+//   Done() is called from the SPI2 or DMA1 Stream 4 interrupt when the chip select has been released
+struct SPI2_XACT
+{
+   uint8_t  Device;                 // DEV_FRAME or DEV_FRAM2
+   uint8_t  Op;                     // SPI2_OP_READ or SPI2_OP_WRITE
+   uint8_t  Width;                  // SPI2_8BIT or SPI2_16BIT
+   uint8_t  NumSegs;                // Number of data segments (1 - SPI2_MAX_SEGS)
+   uint32_t Addr;                   // FRAM byte address
+   struct SPI2_SEG Seg[SPI2_MAX_SEGS];
+   void     (*Done)(struct SPI2_XACT *xptr);    // Completion callback, or 0
+   volatile uint8_t Status;         // SPI2_XS_xx
+};
+
+// SPI2 transaction engine.  Queue[Head] is the transaction in progress.  The queue is empty when Head = Tail
+struct SPI2_ENGINE
+{
+   struct SPI2_XACT * volatile Queue[SPI2_QUEUE_SIZE];
+   volatile uint8_t Head;
+   volatile uint8_t Tail;
+   volatile uint8_t Phase;          // SPI2_PH_xx
+   uint8_t  Seg;                    // Present data segment
+   uint16_t Ndx;                    // Present frame in the segment (read data)
+   uint16_t Hdr[3];                 // Opcode and address frames
+   uint8_t  HdrLen;
+   uint8_t  HdrNdx;
+   uint32_t Xacts;                  // Number of completed transactions
+};
+
+// Posted FRAM write.  FRAM_Write() copies short writes here so that it can return before the write is done
+struct SPI2_POST
+{
+   struct SPI2_XACT Xact;
+   uint16_t Data[SPI2_POST_WORDS];
+};
+
+// Flash waveform pipeline (ENABLE_SPI1_DMA defined).  The sample sets for the next page are gathered into one
+//   page buffer (FlashPgBuf[][] in Iod.c) while the other page is sent by DMA and programmed
+struct FLASH_PIPE
+{
+   uint16_t Gathered;               // Number of sample sets gathered into the page buffers
+   uint16_t ZeroSets;               // Number of unfilled precycle sets still to be written as zeros
+   uint8_t  Sets[2];                // Number of sample sets in each page buffer
+   uint8_t  Next;                   // Page buffer to send next
+   uint8_t  Ready;                  // TRUE if page buffer Next has been gathered
+   volatile uint8_t DmaBusy;        // TRUE while DMA2 Stream 3 is sending a page
+   uint8_t  Programming;            // TRUE while the Flash is programming the last page that was sent
+   uint8_t  PgPolls;                // Number of status reads for the page being programmed
+   uint16_t PollArr;                // Timer10 reload value between status reads
+   uint16_t WaitArr;                // Timer10 reload value from a page start to the first status read
+   uint32_t Pages;                  // Number of pages programmed
+   uint32_t BusyPolls;              // Number of status reads that found the page program still going on
+   uint32_t Stalls;                 // Number of times the next page's samples had not been received yet
+#ifdef ENABLE_WF_CODEC
+   uint32_t DataBytes;              // Number of coded bytes (see Flash_PipeCode())
+   uint16_t SlotAdd;                // Sector and page address of the start of the capture
+   uint16_t PgAdd[2];               // Sector and page address of each page buffer
+   uint16_t StageFill;              // Number of bytes in WfCodecStage[]
+   uint16_t StageOut;               // Number of bytes of WfCodecStage[] already gathered into pages
+   uint16_t DataPages;              // Number of data pages gathered
+   uint8_t  Cycles;                 // Number of cycles coded
+   uint8_t  Credited;               // Number of cycles whose last byte has been gathered into a page
+   uint8_t  IndexSent;              // Number of index pages gathered
+   uint8_t  Aborted;                // TRUE if the capture was aborted (only the index is still written)
+#endif
+};
+
+
 struct TH_SENSOR
 {
    float Humidity;
@@ -125,6 +125,9 @@
 //                        problem if it does not match the definition)
 //   142    240119  DAH - Added ReadAFECalConstants1(), ReadADCHCalConstants1(), and ReadADCLCalConstants1()
 //                        declarations
+//   163    240215  DAH - Added SPI2Eng, SPI2_Submit(), SPI2_Wait(), SPI2_Flush(), and SPI2_XactService()
+//                        declarations (ENABLE_SPI2_DMA defined)
+//   164    240216  DAH - Added FlashPipe and Flash_PipeDone() declarations (ENABLE_SPI1_DMA defined)
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -160,6 +163,12 @@ extern struct STARTUP_TIME_VARS StartupTime;
 extern struct HLTH_I2C_VARS HLTH_I2C;
 extern struct FLASH_INT_REQ Trip_WF_Capture, Alarm_WF_Capture, Ext_WF_Capture;
 extern union FLASH_ID_UNION Flash_ID;
+#ifdef ENABLE_SPI2_DMA
+  extern struct SPI2_ENGINE SPI2Eng;
+#endif
+#ifdef ENABLE_SPI1_DMA
+  extern struct FLASH_PIPE FlashPipe;
+#endif
 
 
 //------------------------------------------------------------------------------------------------------------
@@ -215,4 +224,13 @@ extern void Frame_FRAM_Write(uint16_t fram_address, uint16_t length, uint8_t *in
 extern void MM_Status_Update(void);
 extern void RelayManagement(void);
 extern void InitRelays(void);
+#ifdef ENABLE_SPI2_DMA
+  extern void SPI2_Submit(struct SPI2_XACT *xptr);
+  extern void SPI2_Wait(struct SPI2_XACT *xptr);
+  extern void SPI2_Flush(void);
+  extern void SPI2_XactService(void);
+#endif
+#ifdef ENABLE_SPI1_DMA
+  extern void Flash_PipeDone(void);
+#endif
 
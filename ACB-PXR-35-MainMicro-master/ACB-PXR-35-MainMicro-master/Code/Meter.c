@@ -531,6 +531,75 @@
 //   145    240124 BP   - Added T_Forbids for Coil Detection and Sec Inj
 //   148    240131 BP   - Added Aux Power measurement code with provisions to hold off protection when Aux or USB
 //                        power is applied to prevent nuisance tripping.
+//   153    240205  DAH - Replaced the IAR location operator (@".sram1", @".sram2") with SRAM1_LOC and
+//                        SRAM2_LOC so the module can be compiled in the host build
+//   156    240208  DAH - Replaced the FFT (chirp-z) harmonics computations in Calc_Harmonics() with a
+//                        cycle-folded DFT
+//                          - Added Harm_FoldCycles(), Harm_BinsMag(), Harm_Goertzel(), and Harm_Group().
+//                            The scaling, AFE filter compensation, and IEC61000-4-7 grouping were moved from
+//                            Calc_Harmonics() to Harm_Group()
+//                          - Calc_Harmonics() states 4 - 6 revised.  States 1 and 2 now fall into state 4,
+//                            so each waveform takes three passes
+//                          - Added HarmZre[][], HarmZim[][], and HarmMag[].  g_n[] is only allocated in the
+//                            host build
+//                          - The previous FFT method is retained as Harm_FFTMag() in the host build, for
+//                            comparison
+//   157    240209  DAH - Replaced the SampleBuf[] sample accesses with SAMPLEBUF()
+//                      - Revised Calc_Harmonics() to move the samples into x_n[] a block at a time, using
+//                        SampleBuf_Span(), if SampleBuf is stored by channel (ENABLE_SAMPLE_SOA defined)
+//   159    240211  DAH - Added AFE_Process_Block() to process a block of AFE frames a channel at a time,
+//                        with the integrator, cal scaling, and DC filter run in local variables instead of
+//                        through AFE_Integrate_Sample(), AFE_Cal_Scale(), and Meter_Filter_Sample()
+//                      - The previous AFE_Process_Samples() was renamed AFE_Process_Chan().
+//                        AFE_Process_Samples() now processes the sample with AFE_Process_Block() (one frame),
+//                        and calls AFE_Process_Chan() if there is an error, a reading is out of range, an ADC
+//                        value or seeding is in use, or a test flag is set
+//   160    240212  DAH - Added Apply_CalConstants() and the applied coefficients (AFEcoef, ADCcoefHigh,
+//                        ADCcoefLow).  The samples are now scaled with x * gain + bias instead of (x -
+//                        offset) * gain, and the integrator seed is computed with the reciprocal of the gain,
+//                        so there is no divide in the sample interrupt
+//                      - AFE_Cal_Scale(), ADC_Cal_Scale(), AFE_Process_Block(), and the In and Igsrc
+//                        scaling in AFE_Process_Chan() revised to use the coefficients
+//                      - AFE_Integrate_Sample(), Meter_Filter_Sample(), and AFE_Process_Block() revised to
+//                        reset the integrator and filter states if they become NaN or infinite
+//   174    240226  DAH - Added Calc_OneCyc_Kernel() to compute the one-cycle currents, voltages, powers,
+//                        unbalances, and crest factors in one pass (ENABLE_ONECYC_KERNEL defined)
+//                      - Added Calc_OneCyc_MaxPwr() and OneCycMaxPwr, the one-cycle max powers for the power
+//                        protection and alarm elements
+//                      - Added OneCyc_FwdRevMax(), OneCyc_MinMax(), OneCyc_UnbalMax(), and OneCyc_PwrMinMax()
+//   175    240227  DAH - Revised Calc_SeqComp_PhAng() to get the phasors from the one-cycle sine and cosine
+//                        sums, CurVolOneCycSin_Sav[] and CurVolOneCycCos_Sav[], if ENABLE_SEQ_PHASOR is
+//                        defined.  It is then called every cycle instead of every 200msec
+//                      - Added Calc_SeqComp_Phasors().  The sequence component and phase angle computations
+//                        were moved from Calc_SeqComp_PhAng() into it
+//                      - Added the negative-sequence unbalances, SeqComp.I_NegUnbal and SeqComp.V_NegUnbal
+//                      - Meter_VarInit() revised to initialize the new variables
+//   176    240228  DAH - Added Calc_FreqTrack() and FreqTrack, the zero-crossing frequency tracker.  The
+//                        smoothed frequency and ROCOF are computed from the Van periods that are measured in
+//                        the sampling interrupt, and the sample rate is retuned if ENABLE_FREQ_RETUNE is
+//                        defined (ENABLE_FREQ_TRACK defined)
+//                      - MS200_TO_HRS revised to use the present sample rate if ENABLE_FREQ_RETUNE is
+//                        defined, since the 200msec anniversary is then every 960 samples at the tuned rate
+//                      - Meter_VarInit() revised to initialize FreqTrack
+//   178    240301  DAH - Calc_Harmonics() revised so the SampleBuf pointers fptr thru fptr3 are only declared
+//                        and set up if ENABLE_SAMPLE_SOA is not defined (they are not used otherwise)
+//                      - Apply_CalConstants() caveats revised.  It is no longer called every 200msec, but
+//                        whenever the cal constants are changed
+//   179    240302  DAH - The cycle-folded DFT in Calc_Harmonics() is only used if ENABLE_HARM_FOLD is
+//                        defined.  Otherwise, the harmonics are computed with the FFT (chirp-z) method, as
+//                        before.  Harm_FoldCycles(), Harm_BinsMag(), Harm_Goertzel(), Harm_Group(),
+//                        HarmZre[][], HarmZim[][], and HarmMag[] are only used if ENABLE_HARM_FOLD is defined
+//                        or in the host build
+//                      - Calc_Harmonics() states 1 and 2 revised to break to state 4 instead of falling into
+//                        the next input setup state
+//                      - The samples are only scaled with x * gain + bias (and the integrator seed with the
+//                        reciprocal of the gain) if ENABLE_CAL_BIAS is defined.  Otherwise, they are scaled
+//                        with (x - offset) * gain, as before.  AFEcoef, ADCcoefHigh, and ADCcoefLow are only
+//                        used if ENABLE_CAL_BIAS is defined, and Apply_CalConstants() does nothing otherwise
+//                      - Calc_OneCyc_Kernel(), Calc_OneCyc_MaxPwr(), OneCyc_FwdRevMax(), OneCyc_MinMax(),
+//                        OneCyc_UnbalMax(), OneCyc_PwrMinMax(), and OneCycMaxPwr removed
+//                        (ENABLE_ONECYC_KERNEL deleted).  The kernel was never checked against the original
+//                        subroutines with the actual definitions
 //------------------------------------------------------------------------------------------------------------
 //                    Includes and Declarations
 // Path for <>:
@@ -591,11 +660,20 @@
 #define HARM_LPF_BETA       7.012F
 #define HARM_LPF_ALPHA      8.012F
 
+#define HARM_FOLD_OFFSETS   6                              // Number of folded sample sets (Z_0[] thru Z_5[])
+#define HARM_PER_PASS       20                             // Harmonics computed per pass of Calc_Harmonics()
+#define HARM_SIN_OFFSET     (3 * N_SAMPLES / 4)            // Offset in HARM_COS_TBL[] for the sine
+
 // Tables for harmonics calculations
 #include "Harm_Tables.h"
 
-// Energy and power constants
-#define MS200_TO_HRS            ((float)(0.2/(60 * 60)))
+// Energy and power constants.  If the sample rate is retuned, the "200msec" anniversary is every 960 samples
+//   at the present rate
+#if defined(ENABLE_FREQ_TRACK) && defined(ENABLE_FREQ_RETUNE)
+  #define MS200_TO_HRS          ((float)(960.0/(60 * 60)) * FreqTrack.SamplePer)
+#else
+  #define MS200_TO_HRS          ((float)(0.2/(60 * 60)))
+#endif
 
 
 
@@ -621,7 +699,10 @@
 //
 void Meter_VarInit(void);
 void AFE_Process_Samples(void);
+uint8_t AFE_Process_Block(const uint16_t *frames, uint8_t num, float (*afe_out)[8], float (*mtr_out)[8]);
+void AFE_Process_Chan(void);
 void AFE_Cal_Scale(uint8_t index);
+void Apply_CalConstants(void);
 void Calc_Meter_Current(void);
 void Calc_Prot_Current(void);
 void Calc_Meter_AFE_Voltage(void);
@@ -640,12 +721,24 @@ void AuxPower_Monitoring(void);
 void Calc_BatteryVolt(void);
 void ResetEnergy(void);
 void Calc_Harmonics(void);
+#if defined(ENABLE_HARM_FOLD) || defined(HOST_BUILD)
+  void Harm_FoldCycles(void);
+  void Harm_BinsMag(float32_t *mag, uint8_t first, uint8_t last, uint8_t curr);
+  void Harm_Group(float32_t *mag, uint16_t *instptr, uint8_t curr);
+#endif
+#ifdef HOST_BUILD
+  void Harm_FFTMag(float32_t *mag);
+#endif
 void ManageSPI1Flags(void);
 float TP_CoilTempRMSavg(void);
 void Calc_CF(void);
 void Calc_KFactor(void);
 void Calc_SeqComp_PhAng(void);
+void Calc_SeqComp_Phasors(const float *re_ptr, const float *im_ptr);
 void Calc_Freq(struct FREQ_MEASURE_VARS *f_ptr, float v_xn);
+#ifdef ENABLE_FREQ_TRACK
+  void Calc_FreqTrack(void);
+#endif
 uint8_t Update_PSC(uint32_t *pPriSecCause);
 void ExtCapSnapshotMeterOneCyc();
 void ExtCapSnapshotMeterTwoHundred();
@@ -663,6 +756,9 @@ uint8_t CaptureUserWaveform(uint16_t type);
 //
 void AFE_Integrate_Sample(uint8_t index);
 void Meter_Filter_Sample(uint8_t index);
+#if defined(ENABLE_HARM_FOLD) || defined(HOST_BUILD)
+  float32_t Harm_Goertzel(uint16_t k);
+#endif
 
 void ResetMinMax(void);
 void ResetMinMaxBufID(uint32_t bufID);
@@ -681,6 +777,10 @@ struct CUR_WITH_G_F             Cur200msFltrSOS_Sav;
 struct CUR_WITHOUT_G_F          Cur200msNoFltrSOS_Sav;
 float                           CurVol200msNoFltrSinSOS_Sav[7];
 float                           CurVol200msNoFltrCosSOS_Sav[7];
+#ifdef ENABLE_SEQ_PHASOR
+  float                         CurVolOneCycSin_Sav[ONECYC_PHASOR_NUM];
+  float                         CurVolOneCycCos_Sav[ONECYC_PHASOR_NUM];
+#endif
 struct CUR_WITH_G_F             CurOneCyc;
 struct MIN_MAX_CUR_WITH_G_F     CurOneCyc_max;
 struct MIN_MAX_CUR_WITH_G_F     CurOneCyc_min;
@@ -745,11 +845,14 @@ signed long long                NetWHr;
 signed long long                TotVarHr;
 signed long long                NetVarHr;
 
-uint16_t AFE_single_capture[16] @".sram2";
-uint32_t ADC_single_capture[5] @".sram2";
-float AFE_new_samples[8] @".sram2";
-float MTR_new_samples[8] @".sram2";
-struct AFE_CAL AFEcal @".sram2";
+uint16_t AFE_single_capture[16] SRAM2_LOC;
+uint32_t ADC_single_capture[5] SRAM2_LOC;
+float AFE_new_samples[8] SRAM2_LOC;
+float MTR_new_samples[8] SRAM2_LOC;
+struct AFE_CAL AFEcal SRAM2_LOC;
+#ifdef ENABLE_CAL_BIAS
+  struct AFE_CAL_COEF AFEcoef SRAM2_LOC;
+#endif
 
 struct HARMONICS_I_STRUCT HarmonicsAgg, HarmonicsCap;
 
@@ -763,9 +866,16 @@ float PhAngles1[9];
 float PhAngles2[6];
 
 struct FREQ_MEASURE_VARS FreqLoad, FreqLine;
+#ifdef ENABLE_FREQ_TRACK
+  struct FREQ_TRACK_VARS FreqTrack;
+#endif
 
 struct ADC_CAL ADCcalHigh;
 struct ADC_CAL ADCcalLow;
+#ifdef ENABLE_CAL_BIAS
+  struct ADC_CAL_COEF ADCcoefHigh;
+  struct ADC_CAL_COEF ADCcoefLow;
+#endif
 
 float ThermMemReading;            // thermal memory value through ADC2
 float INT_a1[5];
@@ -819,18 +929,18 @@ float AuxPower_Volt;
 //
 //       These variables are used only in this module...
 //
-float ss[5] @".sram2";
-float MTR_ss[8] @".sram2";
-uint32_t ADC_test_samples[5] @".sram2";     // for DEBUG
-float ADC_samples[10] @".sram2";
-float AFE_PrevSample[5] @".sram2";
-float ADC_PrevSample[8][2] @".sram2";
+float ss[5] SRAM2_LOC;
+float MTR_ss[8] SRAM2_LOC;
+uint32_t ADC_test_samples[5] SRAM2_LOC;     // for DEBUG
+float ADC_samples[10] SRAM2_LOC;
+float AFE_PrevSample[5] SRAM2_LOC;
+float ADC_PrevSample[8][2] SRAM2_LOC;
 struct CUR_WITHOUT_G_F CF_Sum;
-uint8_t Seed_State[4] @".sram2";
-uint8_t AFE_State[4] @".sram2";
-uint8_t SampleCntOK[4] @".sram2";
-uint8_t UseADCvals @".sram2";
-uint8_t Getting_AFE_Seed @".sram2";
+uint8_t Seed_State[4] SRAM2_LOC;
+uint8_t AFE_State[4] SRAM2_LOC;
+uint8_t SampleCntOK[4] SRAM2_LOC;
+uint8_t UseADCvals SRAM2_LOC;
+uint8_t Getting_AFE_Seed SRAM2_LOC;
 
 float Max_Metering_Energy;
 float Min_Metering_Energy;
@@ -867,8 +977,15 @@ struct K_FACTOR_VARS
 uint8_t K_FactorReq;
   
 uint8_t CH_State;
-float32_t g_n[2 * NFFT];
+#if !defined(ENABLE_HARM_FOLD) || defined(HOST_BUILD)
+  float32_t g_n[2 * NFFT];                // FFT method (also used by Harm_FFTMag() in the host build)
+#endif
 float32_t x_n[N_SAMPLES];
+#if defined(ENABLE_HARM_FOLD) || defined(HOST_BUILD)
+  float32_t HarmZre[HARM_FOLD_OFFSETS][SAMPLING_RATE];  // Folded samples Z_0[] thru Z_5[] (real and
+  float32_t HarmZim[HARM_FOLD_OFFSETS][SAMPLING_RATE];  //   imaginary parts)
+  float32_t HarmMag[N_SAMPLES/2];                       // Bin magnitudes, 0Hz thru 2395Hz
+#endif
 
 uint16_t fred_frame[10];  // *** DAH USED FOR DEBUG AND TEST ONLY
 
@@ -2459,7 +2576,9 @@ void Load_MB_Test_Vals(void)
 //                      K_FactorReq, KF.State, KF_Val.Ix, SeqComp.xxx, Freqxxxx.Start, Freqxxxx.OvrTimer,
 //                      Freqxxxx.DeltaTim, Freqxxxx.FreqVal, Freqxxxx.MinFreqVal, Freqxxxx.MaxFreqVal,
 //                      PF.App[], PF.MinApp[], PF.MaxApp[], PF.Disp[], PF.MinDisp[], PF.MaxDisp{}, THD[],
-//                      PhAngles1[], PhAngles2[], VolUnbalTot, CurUnbalTot, StatusCode, UserWF.Locked
+//                      PhAngles1[], PhAngles2[], VolUnbalTot, CurUnbalTot, StatusCode, UserWF.Locked,
+//                      CurVolOneCycSin_Sav[], CurVolOneCycCos_Sav[] (ENABLE_SEQ_PHASOR defined),
+//                      FreqTrack (ENABLE_FREQ_TRACK defined)
 
 //
 //  ALTERS:             AFEcal.x
@@ -2488,6 +2607,13 @@ void Meter_VarInit(void)
     CurVol200msNoFltrSinSOS_Sav[i] = 0;
     CurVol200msNoFltrCosSOS_Sav[i] = 0;
   }
+#ifdef ENABLE_SEQ_PHASOR
+  for (i=0; i<ONECYC_PHASOR_NUM; ++i)
+  {
+    CurVolOneCycSin_Sav[i] = 0;
+    CurVolOneCycCos_Sav[i] = 0;
+  }
+#endif
   VolAFEOneCycSOS_Sav.Van = 0;
   VolAFEOneCycSOS_Sav.Vbn = 0;
   VolAFEOneCycSOS_Sav.Vcn = 0;
@@ -2563,6 +2689,8 @@ void Meter_VarInit(void)
   SeqComp.V_PosPh = NAN;
   SeqComp.V_NegMag = NAN;
   SeqComp.V_NegPh = NAN;
+  SeqComp.I_NegUnbal = NAN;
+  SeqComp.V_NegUnbal = NAN;
   FreqLoad.FreqVal = NAN;
   FreqLine.FreqVal = NAN;
   FreqLoad.MinFreqVal = NAN;
@@ -2593,6 +2721,28 @@ void Meter_VarInit(void)
     PhAngles2[i] = NAN;
   }
 
+#ifdef ENABLE_FREQ_TRACK
+  // This must precede the energy limits, since MS200_TO_HRS uses FreqTrack.SamplePer if ENABLE_FREQ_RETUNE
+  //   is defined
+  FreqTrack.FreqVal = NAN;
+  FreqTrack.Rocof = NAN;
+  FreqTrack.SampleRate = 80.0f * FREQTRK_NOM_HZ;    // Rate set by AFE_Init() and Init_TIM3()
+  FreqTrack.SamplePer = 1.0f / FreqTrack.SampleRate;
+  FreqTrack.TuneFreq = FREQTRK_NOM_HZ;
+  FreqTrack.TuneRate = FreqTrack.SampleRate;
+  FreqTrack.VanPrev = 0;
+  FreqTrack.PerTime = 0;
+  FreqTrack.PerSum = 0;
+  FreqTrack.PendTime = 0;
+  FreqTrack.SampCtr = FREQTRK_MAX_SAMPLES;          // Invalid until the first period is measured
+  FreqTrack.PerCnt = 0;
+  FreqTrack.Start = TRUE;
+  FreqTrack.Armed = FALSE;
+  FreqTrack.HistNdx = 0;
+  FreqTrack.HistCnt = 0;
+  FreqTrack.TuneReq = FALSE;
+#endif
+
   Max_Metering_Energy = 1.25 * 7000 * 346 * MS200_TO_HRS;        // *** DAH  CHECK THIS NUMBER - MAY BE FRAME DEPENDENT
   Min_Metering_Energy = 3.0 * 100 * MS200_TO_HRS;                // *** DAH  CHECK THIS NUMBER - MAY BE FRAME DEPENDENT
 
@@ -2695,6 +2845,240 @@ void Meter_VarInit(void)
 //
 //  FUNCTION:           Process AFE Samples
 //
+//  MECHANICS:          This subroutine processes the present set of AFE samples (one reading per channel,
+//                      eight total) from the DMA operation used to read the AFE, and stores the results in
+//                      AFE_new_samples[] and MTR_new_samples[].
+//                      Normally, all of the readings are valid, the channels are in AFE operation, and no
+//                      integrator seeding is in progress.  In this case, the samples are processed by
+//                      AFE_Process_Block() as a block of one frame.  Otherwise AFE_Process_Block() does
+//                      nothing, and the samples are processed one channel at a time, with the error and
+//                      range checks and the AFE/ADC state machine, by AFE_Process_Chan().  The results are
+//                      identical either way.
+//                      Only one frame is processed per call, so that each sample is available to the
+//                      protection subroutines in the same interrupt that it is read.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             AFE_single_capture[] - the present set of values from the AFE
+// 
+//  OUTPUTS:            AFE_new_samples[] - the new sample values in floating point format
+//                      MTR_new_samples[] - the filtered sample values in floating point format
+//
+//  ALTERS:             None
+// 
+//  CALLS:              AFE_Process_Block(), AFE_Process_Chan()
+// 
+//------------------------------------------------------------------------------------------------------------
+
+void AFE_Process_Samples(void)
+{
+  if (!AFE_Process_Block(&AFE_single_capture[0], 1, &AFE_new_samples, &MTR_new_samples))
+  {
+    AFE_Process_Chan();
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         AFE_Process_Samples()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       AFE_Process_Block()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Process a Block of AFE Samples
+//
+//  MECHANICS:          This subroutine processes num consecutive frames of AFE readings.  Each frame is the
+//                      AFE_FRAME_WORDS words from one DMA operation, in the same format as
+//                      AFE_single_capture[] (see AFE_Process_Chan()).  The processing is the same as in
+//                      AFE_Process_Chan() when the AFE values are used (AFE State 0), but it is done one
+//                      channel at a time over the whole block, instead of one sample at a time through
+//                      AFE_Integrate_Sample(), AFE_Cal_Scale(), and Meter_Filter_Sample():
+//                        1) The block is checked to make sure it can be handled here.  The test flags
+//                           (UseADCvals and TP_AFEIntOff) must be off, the current channels must be in AFE
+//                           operation (AFE_State[] = 0), and no integrator seeding may be in progress
+//                           (Seed_State[] = 0 for the integrated channels).  None of the readings may have a
+//                           chip error, and the current readings (channels 0 - 3) must be in range.  If any
+//                           of these checks fail, FALSE is returned and nothing is altered, so that the
+//                           readings are handled by the AFE/ADC state machine in AFE_Process_Chan()
+//                        2) For each channel, the readings are decoded and run through the integrator
+//                           (Rogowski channels only), the calibration scaling, and the DC filter, with the
+//                           integrator and filter states and the calibration constants held in local
+//                           variables.  The Rogowski channels are delayed one sample, as in
+//                           AFE_Process_Chan().  The calibration constants are selected the same way as in
+//                           AFE_Process_Chan() (In with a CT uses index 9, Igsrc with a Rogowski coil uses
+//                           index 8).  Each reading is integrated, scaled, and filtered in a single pass
+//                      The arithmetic, including the reset of invalid (NaN or infinite) integrator and
+//                      filter states, is the same, and in the same order, as in AFE_Process_Chan(), so the
+//                      results are identical.
+//
+//  CAVEATS:            The AFE sample interrupt calls this with one frame (num = 1), through
+//                      AFE_Process_Samples(), so that the protection latency is not increased.  Larger
+//                      blocks are only used for frames that have already been queued (for example, in the
+//                      host build)
+//
+//  INPUTS:             frames - pointer to the first word of the first frame.  The frames are contiguous
+//                      num - the number of frames (1 - AFE_BLOCK_MAX)
+//                      UseADCvals, TP_AFEIntOff, AFE_State[], Seed_State[], GPIOD->ODR (sensor type),
+//                      AFEcoef (ENABLE_CAL_BIAS defined) or AFEcal, INT_a1[]
+// 
+//  OUTPUTS:            afe_out[n][] - the samples for frame n, the same as AFE_new_samples[]
+//                      mtr_out[n][] - the filtered samples for frame n, the same as MTR_new_samples[]
+//                      Returns TRUE if the block was processed, FALSE if it must be processed by
+//                      AFE_Process_Chan()
+//
+//  ALTERS:             ss[], AFE_PrevSample[], MTR_ss[]
+// 
+//  CALLS:              None
+// 
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t AFE_Process_Block(const uint16_t *frames, uint8_t num, float (*afe_out)[8], float (*mtr_out)[8])
+{
+  const uint16_t *fptr;
+#ifdef ENABLE_CAL_BIAS
+  float gain, bias, a1, state, mtr_state, prev, x, y;
+#else
+  float gain, offset, a1, state, mtr_state, prev, x, y;
+#endif
+  uint32_t utemp32, error;
+  int32_t stemp32;
+  uint8_t k, n, cal_ndx, integrate, in_rogo, gf_rogo;
+
+  // Check the test flags and the channel states
+  in_rogo = IN_USING_ROGOWSKI;
+  gf_rogo = GF_USING_ROGOWSKI;
+  if ( (num == 0) || (num > AFE_BLOCK_MAX) || (UseADCvals) || (TP_AFEIntOff != FALSE)
+    || ((AFE_State[0] | AFE_State[1] | AFE_State[2] | AFE_State[3]) != 0)
+    || ((Seed_State[0] | Seed_State[1] | Seed_State[2]) != 0)
+    || ((in_rogo) && (Seed_State[3] != 0)) )
+  {
+    return (FALSE);
+  }
+
+  // Check the readings for chip errors (b15 of the first word of each channel), and check the current
+  //   readings for overrange.  A reading is out of range if its magnitude is 0x7FFF80 or more, which is
+  //   0x7FFF80 thru 0x800080 as a 24-bit two's complement value
+  fptr = frames;
+  error = 0;
+  for (n=0; n<num; ++n)
+  {
+    error |= ( (fptr[0] | fptr[2] | fptr[4] | fptr[6] | fptr[8] | fptr[10] | fptr[12] | fptr[14]) & 0x8000 );
+    for (k=0; k<4; ++k)
+    {
+      utemp32 = (((uint32_t)(fptr[2*k] & 0x00FF)) << 16) + fptr[2*k + 1];
+      error |= ( (utemp32 - 0x007FFF80) <= 0x0100 );
+    }
+    fptr += AFE_FRAME_WORDS;
+  }
+  if (error != 0)
+  {
+    return (FALSE);
+  }
+
+  // Process each channel over the block.  The 24-bit readings are sign extended by flipping and subtracting
+  //   the sign bit
+  for (k=0; k<8; ++k)
+  {
+    cal_ndx = k;
+    integrate = (k < 3);
+    if (k == 3)
+    {
+      integrate = in_rogo;
+      cal_ndx = ( (integrate) ? 3 : 9 );
+    }
+    else if (k == 4)
+    {
+      integrate = gf_rogo;
+      cal_ndx = ( (integrate) ? 8 : 4 );
+    }
+#ifdef ENABLE_CAL_BIAS
+    gain = AFEcoef.gain[cal_ndx];
+    bias = AFEcoef.bias[cal_ndx];
+#else
+    gain = AFEcal.gain[cal_ndx];
+    offset = AFEcal.offset[cal_ndx];
+#endif
+    mtr_state = MTR_ss[k];
+    fptr = &frames[2*k];
+
+    if (integrate)                              // Rogowski input: integrate, and use the previous
+    {                                           //   integrator output
+      a1 = INT_a1[k];
+      state = ss[k];
+      prev = AFE_PrevSample[k];
+      for (n=0; n<num; ++n)
+      {
+        stemp32 = (int32_t)(((((uint32_t)(fptr[0] & 0x00FF)) << 16) + fptr[1]) ^ 0x00800000) - 0x00800000;
+        y = (float)(stemp32) + state;
+        if (!isfinite(y))                       // Reset the integrator if invalid (see
+        {                                       //   AFE_Integrate_Sample())
+          y = 0;
+        }
+        state = a1 * y;
+#ifdef ENABLE_CAL_BIAS
+        x = prev * gain + bias;
+#else
+        x = (prev - offset) * gain;
+#endif
+        prev = y;
+        y = MTR_b0 * x + mtr_state;             // DC filter (see Meter_Filter_Sample())
+        mtr_state = (MTR_a1 * y) - (MTR_b0 * x);
+        if (!isfinite(mtr_state))
+        {
+          mtr_state = 0;
+        }
+        afe_out[n][k] = x;
+        mtr_out[n][k] = y;
+        fptr += AFE_FRAME_WORDS;
+      }
+      ss[k] = state;
+      AFE_PrevSample[k] = prev;
+    }
+    else                                        // Voltage or CT input: not integrated
+    {
+      for (n=0; n<num; ++n)
+      {
+        stemp32 = (int32_t)(((((uint32_t)(fptr[0] & 0x00FF)) << 16) + fptr[1]) ^ 0x00800000) - 0x00800000;
+#ifdef ENABLE_CAL_BIAS
+        x = (float)(stemp32) * gain + bias;
+#else
+        x = ((float)(stemp32) - offset) * gain;
+#endif
+        y = MTR_b0 * x + mtr_state;             // DC filter (see Meter_Filter_Sample())
+        mtr_state = (MTR_a1 * y) - (MTR_b0 * x);
+        if (!isfinite(mtr_state))
+        {
+          mtr_state = 0;
+        }
+        afe_out[n][k] = x;
+        mtr_out[n][k] = y;
+        fptr += AFE_FRAME_WORDS;
+      }
+    }
+    MTR_ss[k] = mtr_state;
+  }
+  return (TRUE);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         AFE_Process_Block()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       AFE_Process_Chan()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Process AFE Samples One Channel at a Time
+//
 //  MECHANICS:          This subroutine processes the samples from the DMA operation used to read the AFE.
 //                      The AFE readings (one per channel, eight total) are received as two 16-bit words.
 //                      Each reading is checked for validity (errors in the header and data overrange).  If
@@ -2712,7 +3096,8 @@ void Meter_VarInit(void)
 //                        AFE_new_samples[6] - Vb: voltage input, not integrated
 //                        AFE_new_samples[7] - Vc: voltage input, not integrated
 //
-//  CAVEATS:            None
+//  CAVEATS:            This is called by AFE_Process_Samples() when the samples cannot be processed by
+//                      AFE_Process_Block()
 //
 //  INPUTS:             AFE_single_capture[] - the present set of values from the AFE
 // 
@@ -2724,7 +3109,7 @@ void Meter_VarInit(void)
 // 
 //------------------------------------------------------------------------------------------------------------
 
-void AFE_Process_Samples(void)
+void AFE_Process_Chan(void)
 {
   uint32_t utemp32;
   int32_t stemp32;
@@ -2967,7 +3352,11 @@ void AFE_Process_Samples(void)
       AFE_new_samples[4] = ftemp;                 //   sample, so use the previous sample
     }
     // Convert to engineering units - use Rogowski cal constants (AFEcal index = 8)
+#ifdef ENABLE_CAL_BIAS
+    AFE_new_samples[4] = AFE_new_samples[4] * AFEcoef.gain[8] + AFEcoef.bias[8];
+#else
     AFE_new_samples[4] = (AFE_new_samples[4] - AFEcal.offset[8]) * AFEcal.gain[8];
+#endif
     Meter_Filter_Sample(4);                     // Filter the sample for metered values
   }
   else                                      // Otherwise Igsrc is being measured with a CT, so process it
@@ -3055,7 +3444,11 @@ void AFE_Process_Samples(void)
           else                                             // Otherwise In is being measured with a CT, so
           {                                                //   process it like the voltages
             // Convert to engineering units - use CT cal constants (AFEcal index = 9)
+#ifdef ENABLE_CAL_BIAS
+            AFE_new_samples[3] = AFE_new_samples[3] * AFEcoef.gain[9] + AFEcoef.bias[9];
+#else
             AFE_new_samples[3] = (AFE_new_samples[3] - AFEcal.offset[9]) * AFEcal.gain[9];
+#endif
           }
         }
         else                                            // If test flag is True, use ADC value and stay in
@@ -3119,7 +3512,7 @@ void AFE_Process_Samples(void)
 }
 
 //------------------------------------------------------------------------------------------------------------
-//             END OF FUNCTION         AFE_Process_Samples()
+//             END OF FUNCTION         AFE_Process_Chan()
 //------------------------------------------------------------------------------------------------------------
 
 
@@ -3147,6 +3540,8 @@ void AFE_Process_Samples(void)
 //                      constants, which are at index = 8: AFEcal.gain[8] and AFEcal.offset[8] apply to the
 //                      Rogowski coil.  (AFEcal.gain[4] and AFEcal.offset[4] apply to the CT ground
 //                      measurement)
+//                      If the integrator output is invalid (NaN or infinite), for example because a bad
+//                      sample was received, the output and the integrator state are reset to 0.
 //
 //  CAVEATS:            None
 //
@@ -3167,6 +3562,8 @@ void AFE_Process_Samples(void)
 //                      subroutine is entered, it will seed with the next ADC sample, which is the low-gain
 //                      seed.  After seeding is done, Seed_State is set to 0, and no further seeding is
 //                      done.
+//                      AFEcoef.rgain[] (ENABLE_CAL_BIAS defined) or AFEcal.gain[], AFEcal.offset[] - used
+//                      to remove the calibration from the seed
 // 
 //  OUTPUTS:            AFE_new_samples[] - the integrated sample values in floating point format
 //
@@ -3193,8 +3590,18 @@ void AFE_Integrate_Sample(uint8_t index)
     }                                                 //   is done on next sample
     else if (Seed_State[index] == 1)                  // If Seed_State == 1, seed the integrator, then
     {                                                 //   set the state to 0
-      // Remove offset and gain calibration before placing in the integrator
-      ss[index] = ADC_samples[index]/AFEcal.gain[index] + AFEcal.offset[index];  // *** DAH MAYBE SHOULD SAVE 1/GAIN AS SEPARATE CONSTANT SO NO DIVIDE OPERATION
+      // Remove offset and gain calibration before placing in the integrator.  If ENABLE_CAL_BIAS is
+      //   defined, the reciprocal of the gain is used so there is no divide.  If the seed is invalid (NaN or
+      //   infinite), start from 0
+#ifdef ENABLE_CAL_BIAS
+      ss[index] = ADC_samples[index] * AFEcoef.rgain[index] + AFEcal.offset[index];
+#else
+      ss[index] = ADC_samples[index]/AFEcal.gain[index] + AFEcal.offset[index];
+#endif
+      if (!isfinite(ss[index]))
+      {
+        ss[index] = 0;
+      }
       Seed_State[index] = 0;    
       if (index == 0)                          // *** DAH TEST
       {
@@ -3204,7 +3611,11 @@ void AFE_Integrate_Sample(uint8_t index)
     else                                              // Otherwise do normal integration
     {
   //  y = b0 * AFE_new_samples[index] + ss[index];    (b0 = 1)
-      y = AFE_new_samples[index] + ss[index];                                 // *** DAH ADD RANGE CHECK BECAUSE IF GET NaN, WILL STAY FOREVER!
+      y = AFE_new_samples[index] + ss[index];
+      if (!isfinite(y))                               // If the output is invalid (NaN or infinite), reset
+      {                                               //   the integrator.  Otherwise the invalid value
+        y = 0;                                        //   would remain in the integrator state forever
+      }
       ss[index] = INT_a1[index] * y;
       AFE_new_samples[index] = y;
     }
@@ -3214,7 +3625,11 @@ void AFE_Integrate_Sample(uint8_t index)
   else
   {
 //  y = b0 * AFE_new_samples[index] + ss[index];    (b0 = 1)
-    y = AFE_new_samples[index] + ss[index];                                 // *** DAH ADD RANGE CHECK BECAUSE IF GET NaN, WILL STAY FOREVER!
+    y = AFE_new_samples[index] + ss[index];
+    if (!isfinite(y))                                 // If the output is invalid, reset the integrator
+    {
+      y = 0;
+    }
     ss[index] = INT_a1[index] * y;
     AFE_new_samples[index] = y;
   }
@@ -3238,6 +3653,7 @@ void AFE_Integrate_Sample(uint8_t index)
 //                      George Gao designed the filter algorithm.  It is the transposed direct form II
 //                      algorithm.
 //                      The gain of the filter is 1 at 60Hz.
+//                      If the filter state is invalid (NaN or infinite), it is reset to 0.
 //
 //  CAVEATS:            None
 //
@@ -3260,8 +3676,12 @@ void Meter_Filter_Sample(uint8_t index)
   //  const float b0 = 9.9928408556729E-1;
   //  const float a1 = 9.9609375000000E-1;
 
-  y = MTR_b0 * AFE_new_samples[index] + MTR_ss[index];                      // *** DAH ADD RANGE CHECK BECAUSE IF GET NaN, WILL STAY FOREVER!
+  y = MTR_b0 * AFE_new_samples[index] + MTR_ss[index];
   MTR_ss[index] = (MTR_a1 * y) - (MTR_b0 * AFE_new_samples[index]);
+  if (!isfinite(MTR_ss[index]))                     // If the sample is invalid (NaN or infinite), reset the
+  {                                                 //   filter state so the invalid value does not remain in
+    MTR_ss[index] = 0;                              //   the filter
+  }
   MTR_new_samples[index] = y;
 }
 
@@ -3284,12 +3704,19 @@ void Meter_Filter_Sample(uint8_t index)
 //                      and offset scaling coefficients are based on calculated (ideal) values.  Eventually,
 //                      they will be comprised of the Frame's calibration constants and the board's
 //                      calibration constants.
+//                      The sample is scaled as (x - offset) * gain.  If ENABLE_CAL_BIAS is defined, it is
+//                      instead scaled with the applied coefficients, x * gain + bias, where bias is
+//                      -offset * gain.  This is a single multiply and add, but the result may differ from
+//                      (x - offset) * gain in the last bit, because bias is rounded.
 //
-//  CAVEATS:            None
+//  CAVEATS:            If ENABLE_CAL_BIAS is defined, the coefficients are computed from the cal constants
+//                      by Apply_CalConstants()
 //
 //  INPUTS:             index - index in AFE_new_samples[] of the sample to be scaled (channel number)
 //                      AFEcal.gain[] - the gain scaling coefficient for the channel
 //                      AFEcal.offset[] - the offset scaling coefficient for the channel
+//                      AFEcoef.gain[], AFEcoef.bias[] - the applied coefficients for the channel
+//                                                       (ENABLE_CAL_BIAS defined)
 // 
 //  OUTPUTS:            AFE_new_samples[] - the scaled sample values in floating point format (engineering
 //                                          units)
@@ -3302,7 +3729,11 @@ void Meter_Filter_Sample(uint8_t index)
 
 void AFE_Cal_Scale(uint8_t index)
 {
+#ifdef ENABLE_CAL_BIAS
+  AFE_new_samples[index] = AFE_new_samples[index] * AFEcoef.gain[index] + AFEcoef.bias[index];
+#else
   AFE_new_samples[index] = (AFE_new_samples[index] - AFEcal.offset[index]) * AFEcal.gain[index];
+#endif
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -3312,6 +3743,72 @@ void AFE_Cal_Scale(uint8_t index)
 
 
 
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       Apply_CalConstants()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Apply Calibration Constants
+//
+//  MECHANICS:          This subroutine computes the applied coefficients that are used to scale the samples
+//                      from the calibration constants:
+//                          gain = gain
+//                          bias = -offset * gain
+//                          rgain = 1/gain (AFE only, used to remove the calibration from the integrator
+//                                  seed).  If the gain is 0 or invalid, rgain is set to 0
+//                      The samples are then scaled as x * gain + bias, so that there is no divide in the
+//                      sample interrupt, and the scaling is a single multiply and add.
+//                      If ENABLE_CAL_BIAS is not defined, the samples are scaled with the cal constants
+//                      directly, as (x - offset) * gain, and this subroutine does nothing.
+//
+//  CAVEATS:            This must be called whenever the calibration constants are changed.  It is called
+//                      when the constants are read (ReadAFECalConstants(), ReadADCHCalConstants(), and
+//                      ReadADCLCalConstants()), when they are written by the display processor
+//                      (ProcWrFactoryConfig()), and when they are changed by the test port or Execute Action
+//                      calibration subroutines (Test.c).
+//                      The sample interrupt is not disabled, so a sample may be scaled with a mix of the old
+//                      and new coefficients for a channel.  This is the same as when the cal constants are
+//                      changed directly.
+//
+//  INPUTS:             AFEcal, ADCcalHigh, ADCcalLow
+//
+//  OUTPUTS:            AFEcoef, ADCcoefHigh, ADCcoefLow
+//
+//  ALTERS:             None
+//
+//  CALLS:              isfinite()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Apply_CalConstants(void)
+{
+#ifdef ENABLE_CAL_BIAS
+  float gain;
+  uint8_t i;
+
+  for (i=0; i<10; ++i)
+  {
+    gain = AFEcal.gain[i];
+    AFEcoef.gain[i] = gain;
+    AFEcoef.bias[i] = -AFEcal.offset[i] * gain;
+    AFEcoef.rgain[i] = ( ((gain != 0) && (isfinite(gain))) ? (1.0f/gain) : 0 );
+  }
+  for (i=0; i<8; ++i)
+  {
+    ADCcoefHigh.gain[i] = ADCcalHigh.gain[i];
+    ADCcoefHigh.bias[i] = -ADCcalHigh.offset[i] * ADCcalHigh.gain[i];
+    ADCcoefLow.gain[i] = ADCcalLow.gain[i];
+    ADCcoefLow.bias[i] = -ADCcalLow.offset[i] * ADCcalLow.gain[i];
+  }
+#endif
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         Apply_CalConstants()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+
 //------------------------------------------------------------------------------------------------------------
 //             START OF FUNCTION       Calc_Meter_Current()
 //------------------------------------------------------------------------------------------------------------
@@ -5275,6 +5772,9 @@ void ADC_Process_Samples(void)
 //  CAVEATS:            None
 //
 //  INPUTS:             ADC_samples[] - the present set of values from the ADC (32-bit  ADC2:ADC1)
+//                      ADCcalHigh, ADCcalLow - the cal constants
+//                      ADCcoefHigh, ADCcoefLow - the applied coefficients (see Apply_CalConstants()), used
+//                                                instead of the cal constants if ENABLE_CAL_BIAS is defined
 //
 //  OUTPUTS:            ADC_samples[] - the new sample values in floating point format
 //
@@ -5291,11 +5791,19 @@ void ADC_Cal_Scale(uint8_t index)
     // For In, use the CT cal constants if not using a Rogowski
     if ((index == 3) && (!IN_USING_ROGOWSKI))
     {
+#ifdef ENABLE_CAL_BIAS
+      ADC_samples[index] = ADC_samples[index] * ADCcoefHigh.gain[4] + ADCcoefHigh.bias[4];
+#else
       ADC_samples[index] = (ADC_samples[index] - ADCcalHigh.offset[4]) * ADCcalHigh.gain[4];
+#endif
     }
     else
     {
+#ifdef ENABLE_CAL_BIAS
+      ADC_samples[index] = ADC_samples[index] * ADCcoefHigh.gain[index] + ADCcoefHigh.bias[index];
+#else
       ADC_samples[index] = (ADC_samples[index] - ADCcalHigh.offset[index]) * ADCcalHigh.gain[index];
+#endif
     }
   }
   else
@@ -5303,11 +5811,19 @@ void ADC_Cal_Scale(uint8_t index)
     // For In, use the CT cal constants if not using a Rogowski
     if ((index == 3) && (!IN_USING_ROGOWSKI))
     {
+#ifdef ENABLE_CAL_BIAS
+      ADC_samples[index] = ADC_samples[index] * ADCcoefLow.gain[4] + ADCcoefLow.bias[4];
+#else
       ADC_samples[index] = (ADC_samples[index] - ADCcalLow.offset[4]) * ADCcalLow.gain[4];
+#endif
     }
     else
     {
+#ifdef ENABLE_CAL_BIAS
+      ADC_samples[index] = ADC_samples[index] * ADCcoefLow.gain[index] + ADCcoefLow.bias[index];
+#else
       ADC_samples[index] = (ADC_samples[index] - ADCcalLow.offset[index]) * ADCcalLow.gain[index];
+#endif
     }
   }
 }
@@ -5629,8 +6145,10 @@ void Calc_BatteryVolt(void)                    // *** BP - Battery voltage is 2.
 // 240msec (600msec - 360msec) to transmit the harmonics to the display processor, CAM port, and/or Modbus
 // port.
 //
-// The harmonics are computed using the ARM4 DSP Library.  The algorithm was developed by George Gao and is
-// described further in the Calc_Harmonics() subroutine.
+// The harmonics are computed with a chirp-z transform using the ARM4 DSP Library FFTs.  If ENABLE_HARM_FOLD
+// is defined, they are instead computed with a cycle-folded DFT: the 12 cycles are first folded into six sets
+// of 80 complex samples, and then only the bins that are used are computed, with a Goertzel recursion.  This
+// is described further in the Calc_Harmonics() subroutine.
 // Note, harmonics are computed from 0Hz to 2395Hz, in increments of 5Hz.  The interharmonics (harmonics
 // between mulitples of the fundamental frequency) are added to the primary harmonics per IEC 61000-4-7.
 //
@@ -5766,101 +6284,41 @@ void Calc_BatteryVolt(void)                    // *** BP - Battery voltage is 2.
 //                      harmonic rms amplitude and the fundamental rms amplitude in tenths of a per cent.
 //                      Therefore, the values are from 0 .. 1000.
 //
-//                      The harmonics are computed using the ARM4 DSP Library.  The algorithm was developed
-//                      by George Gao:
-//
-//      Abstract
-//        This document describes a step-by-step approach to efficiently compute harmonics for an
-//        aribtary-length real input.  The approach is based on chirp transform algorithm, or chirp-z
-//        transform as it is commonly known.  The real input is first multiplied with a sequence of complex
-//        numbers.  The result is then zero-padded, and then fed into an FFT function.  The FFT function's
-//        output is further multiplied with a second sequence of complex numbers.  The result is then
-//        multipled with a third sequence of complex numbers to yield the final results.
-//
-//      Signal Flow Diagram
-//        The overall signal flow diagram is shown below.
-//
-//          w_n = W_N^(n^2/2)              x_n
-//                  |                       |
-//                  |                       V
-//                  |              +------------------+
-//                  +------------->|     Multiply     |
-//                  |              +------------------+
-//                  |                       |
-//                  |                      g_n                        h_n = W_N^(-n^2/2)
-//                  |                       |                                |
-//                  |                       V                                V
-//                  |              +------------------+             +------------------+
-//                  |              | Zero-pad to NFFT |             | Zero-pad to NFFT |
-//                  |              +------------------+             +------------------+
-//                  |                       |                                |
-//                  |                 zero-padded g_n                  zero-padded h_n
-//                  |                       |                                |
-//                  |                       V                                V
-//                  |              +------------------+             +------------------+
-//                  |              |  NFFT-point FFT  |             |  NFFT-point FFT  |
-//                  |              +------------------+             +------------------+
-//                  |                       |                                |
-//                  |                      G_w                              H_w
-//                  |                       |                                |
-//                  |                       V                                |
-//                  |              +------------------+                      |
-//                  |              |     Multiply     |<---------------------+
-//                  |              +------------------+
-//                  |                       |
-//                  |                      R_w
-//                  |                       |
-//                  |                       V
-//                  |              +------------------+
-//                  |              |  NFFT-point iFFT |    iFFT = Inverse FFT
-//                  |              +------------------+
-//                  |                       |
-//                  |                      r_n
-//                  |                       |
-//                  |                       V
-//                  |              +------------------+
-//                  +------------->|     Multiply     |
-//                                 +------------------+
-//                                          |
-//                                         y_n
-//                                          |
-//                                          V
-//                                  +----------------+
-//                                  |  Amplitude |.| |
-//                                  +----------------+
-//                                          |
-//                                          V
-//                                         z_n
-//
-//      Nomenclature
-//
-//        +---------------+--------------------------------------------------------------------------------+
-//        | Symbol        | Meaning                                                                        |
-//        |---------------|--------------------------------------------------------------------------------|
-//        | x_n           | Aribtary-length real input signal, e.g., phase-A current Ia.                   |
-//        | N             | Length of x_n, e.g., N=80 for a single cycle Ia in PXR 35.                     |
-//        | M             | Total number of harmonics. In this document, M=N.                              |
-//        | n             | Time index, 0 <= n < N.                                                        |
-//        | W_N           | A complex constant. W_N = e^(-2*pi*i/N) = cos(-2*pi/80) + i*sin(-2*pi/80)      |
-//        |               |    = 0.99692 - i * 0.078459                                                    |
-//        | w_n           | N-element complex array. w_n = W_N^[(n^2)/2].                                  |
-//        | NFFT          | Next power of 2 for FFT. NFFT = int32{2^[ceil(log_2(N+M-1))]}.                 |
-//        | g_n           | N-element complex array. Element-wise product of x_n and w_n.                  |
-//        |zero-padded g_n| NFFT-element complex array. First N elements are g_n. Remaining are zeros.     |
-//        | G_w           | NFFT-element complex array. G_w = FFT(zero-padded g_n).                        |
-//        | h_n           | (N+M-1)-element complex array. h_n = W_N^[-(n^2)/2] with 1 <= n < (N+M).       |
-//        |zero-padded h_n| NFFT-element complex array. First (N+M-1) elements are h_n. Remaining are zero |
-//        | H_w           | NFFT-element complex array. H_w=FFT(zero-padded h_n).                          |
-//        | R_w           | NFFT-element complex array. Element-wise product of G_w and H_w.               |
-//        | r_n           | NFFT-element complex array. r_n=iFFT(R_w). iFFT = Inverse FFT                  |
-//        | y_n           | N-element complex array. Element-wise product of the Nth to the (N+M-1)th      |
-//        |               |    elements of r_n with w_n.                                                   |
-//        | z_n           | N-element complex array. Amplitude of y_n.                                     |
-//        +---------------+--------------------------------------------------------------------------------+
-//
-//                      A single harmonic is computed in three passes through the subroutine.  Thus, all of
-//                      the harmonics are computed after 30 passes through the subroutine.  Assuming a main
-//                      loop time of 8msec, it will take 240 msec to update the harmonics.
+//                      If ENABLE_HARM_FOLD is not defined, the harmonics are computed using the ARM4 DSP
+//                      Library, with the chirp-z transform algorithm developed by George Gao.  The algorithm
+//                      is described in Harm_FFTMag(), which is the same computation and is retained in the
+//                      host build for comparison.  A single harmonic is computed in three passes through the
+//                      subroutine.  Thus, all of the harmonics are computed after 30 passes through the
+//                      subroutine.  Assuming a main loop time of 8msec, it will take 240 msec to update the
+//                      harmonics.
+//
+//                      If ENABLE_HARM_FOLD is defined, the harmonics are computed with a cycle-folded
+//                      Discrete Fourier Transform.  The 960-point DFT bin k = 12m + d (m = 0..39,
+//                      d = 0..11) is split into the cycle number c (0..11) and the sample within the cycle
+//                      n (0..79):
+//
+//                          X[12m+d] = SUM(n=0..79) { Z_d[n] * e^(-j*2*pi*(12m+d)*n/960) }
+//                          Z_d[n]   = SUM(c=0..11) { x[80c+n] * e^(-j*2*pi*d*c/12) }
+//
+//                      Z_d[n] is a 12-point DFT across the cycles, and depends only on the offset d of the
+//                      bin from the nearest lower multiple of 60Hz.  Since the input is real,
+//                      Z_(12-d)[n] = conj(Z_d[n]), so only Z_0[] thru Z_5[] are computed.  This "fold" is
+//                      done in Harm_FoldCycles().  Each bin that is used in the IEC 61000-4-7 grouping
+//                      below is then evaluated from the 80 folded samples with a Goertzel recursion in
+//                      Harm_BinsMag().  For the currents, 414 of the 479 bins are used, and for the
+//                      voltages, 118 bins are used.  The bins that are not used are not computed.  In
+//                      exact arithmetic, the bins are the same as the full DFT.  The agreement with the FFT
+//                      method in single-precision has not been verified (see CAVEATS).
+//
+//                      With the cycle-folded DFT, a waveform is computed in three passes through the
+//                      subroutine:
+//                          Pass 1: Move the samples into x_n[] and fold them
+//                          Pass 2: Compute the bins for harmonics 1 thru 20
+//                          Pass 3: Compute the bins for harmonics 21 thru 40, then group, filter, and
+//                                  aggregate the harmonics
+//                      Thus, all of the harmonics are computed after 30 passes through the subroutine.  The
+//                      work is split about evenly between passes 2 and 3, and is 2 x 80 multiplications per
+//                      bin, instead of the two 2048-point FFTs (3.0msec and 3.5msec) of the FFT method.
 //
 //                      Note, the harmonics process runs independently of the user waveform capture process.
 //                      Twelve cycles of each waveform (except Igsrc, which is not included for harmonics)
@@ -5873,6 +6331,9 @@ void Calc_BatteryVolt(void)                    // *** BP - Battery voltage is 2.
 //                      complete the computations.  Assuming an 8msec main loop time, this gives us 56
 //                      passes through the Calc_Harmonics() subroutine.  As there are 10 waveforms to
 //                      compute, we must use 5 or less passes per waveform.
+//                      If SampleBuf is stored by channel (ENABLE_SAMPLE_SOA is defined), the 12-cycle window
+//                      of a waveform is one or two contiguous blocks (SampleBuf_Span()), so the samples are
+//                      moved into x_n[] a block at a time instead of one sample set (36 bytes) at a time.
 //
 //                      Harmonic computations are controlled by a single flag, HarmReq
 //                      The process is summarized below:
@@ -5894,21 +6355,33 @@ void Calc_BatteryVolt(void)                    // *** BP - Battery voltage is 2.
 //                      time to complete the computations.  27cyc = 450msec.  450msec/10 = 45msec per value
 //                      Assuming an 8msec loop, we can use up to 5 passes per value.  We are presently using
 //                      3 passes, so this should be ok.
+//                      The cycle-folded DFT (ENABLE_HARM_FOLD) has not been compared with the FFT method
+//                      with the real SensorBus and CMSIS-DSP headers, or measured on the target.
+//                      "HostReplay -harm" compares the instantaneous harmonics of the two methods.  It must
+//                      show agreement before ENABLE_HARM_FOLD is used in a release.
 // 
-//  INPUTS:             w_n[], H_w[], x_n[], HarmReq
+//  INPUTS:             SampleBuf[], HarmReq
+//                      w_n[], H_w[] (ENABLE_HARM_FOLD not defined)
 // 
 //  OUTPUTS:            HarmonicsAgg.xxx[], HarmonicsCap.xxx[]
 //
-//  ALTERS:             g_n[]
+//  ALTERS:             x_n[]
+//                      g_n[] (ENABLE_HARM_FOLD not defined)
+//                      HarmZre[][], HarmZim[][], HarmMag[] (ENABLE_HARM_FOLD defined)
 // 
 //  CALLS:              arm_cmplx_mult_real_f32(), arm_fill_f32(), arm_cmplx_mult_cmplx_f32(),
-//                      arm_cfft_f32(), arm_cmplx_mult_cmplx_f32(), arm_cmplx_mag_f32(), arm_scale_f32()
+//                      arm_cfft_f32(), arm_cmplx_mult_cmplx_f32(), arm_cmplx_mag_f32(), arm_scale_f32(),
+//                      arm_mult_f32() (ENABLE_HARM_FOLD not defined)
+//                      Harm_FoldCycles(), Harm_BinsMag(), Harm_Group() (ENABLE_HARM_FOLD defined)
+//                      sqrtf()
+//                      SampleBuf_Span(), arm_copy_f32() (if ENABLE_SAMPLE_SOA is defined)
 //
 //  EXECUTION TIME:     Measured execution time on 220323 (Rev 00.53 code, with captured inputs on Van - not
-//                      the captured waveform):
+//                      the captured waveform), with the FFT method:
 //                          4.89msec max (test pin toggled around the subroutine call in main)
 //                          Note, this time includes sample interrupt times!
 //                          3.42msec max with interrupts disabled around the subroutine call
+//                      The cycle-folded DFT has not been measured on the target.
 // 
 //------------------------------------------------------------------------------------------------------------
 
@@ -5922,14 +6395,28 @@ void Calc_BatteryVolt(void)                    // *** BP - Battery voltage is 2.
 
 void Calc_Harmonics(void)               // Amplitude analysis...
 {
+#ifndef ENABLE_SAMPLE_SOA
   static void *fptr;                        // These are void pointers so can be used for both the current
   static void *fptr1;                       //   and the voltage samples
   static void *fptr2;
   static void *fptr3;
+#endif
   static uint16_t *instptr, *aggptr;
   static float *filptr, *sumptr;
   static uint8_t wf_count;
   uint16_t i, k, sample_indx_end, CH_exit;
+#ifdef ENABLE_SAMPLE_SOA
+  // SampleBuf channels for each of the ten waveforms (wf_count).  The second channel is only used for the
+  //   line-line voltages, which are the difference of two line-neutral voltages
+  static const uint8_t HARM_SB_CHAN[10][2] =
+  {
+    {SB_IA, 0}, {SB_IB, 0}, {SB_IC, 0}, {SB_IN, 0}, {SB_VANAFE, 0}, {SB_VBNAFE, 0}, {SB_VCNAFE, 0},
+    {SB_VANAFE, SB_VBNAFE}, {SB_VBNAFE, SB_VCNAFE}, {SB_VCNAFE, SB_VANAFE}
+  };
+  struct SAMPLE_SPAN span, span2;
+  int16_t *i16ptr, *i16ptr2;
+  uint8_t num_blocks;
+#endif
 
   CH_exit = FALSE;
 
@@ -5960,8 +6447,10 @@ void Calc_Harmonics(void)               // Amplitude analysis...
           // Increment HarmSumCount.  This holds the number of squared filtered results that have summed.
           //   When the count reaches 5, 3 seconds has elapsed and it is time to compute the new aggregated
           //   harmonics
-          fptr = &SampleBuf[HarmSampleStartNdx].Ia;
-          fptr1 = &SampleBuf[0].Ia;
+#ifndef ENABLE_SAMPLE_SOA
+          fptr = &SAMPLEBUF(Ia, HarmSampleStartNdx);
+          fptr1 = &SAMPLEBUF(Ia, 0);
+#endif
           instptr = &HarmInst[0];
           filptr = &HarmonicsFil.Ia[0];
           sumptr = &HarmonicsSum.Ia[0];
@@ -5985,6 +6474,17 @@ void Calc_Harmonics(void)               // Amplitude analysis...
         //   If there is going to be wrap-around, divide it up into two moves, so we don't have to check
         //   each time in the for-loop.
 //  TESTPIN_D1_LOW;
+#ifdef ENABLE_SAMPLE_SOA
+        // SampleBuf is stored by channel, so the window is one block of samples, or two blocks if it wraps
+        //   around the end of SampleBuf (see SampleBuf_Span()).  Each block is moved with a block copy
+        k = 0;
+        num_blocks = SampleBuf_Span(HARM_SB_CHAN[wf_count][0], HarmSampleStartNdx, N_SAMPLES, &span);
+        for (i=0; i<num_blocks; ++i)
+        {
+          arm_copy_f32((float32_t *)span.Ptr[i], &x_n[k], span.Len[i]);
+          k += span.Len[i];
+        }
+#else
         // If the 12-cy SampleBuf[] will wrap around..
         if (HarmSampleStartNdx > (TOTAL_SAMPLE_SETS - N_SAMPLES))
         {                                                       // First move the samples from the starting
@@ -6010,6 +6510,7 @@ void Calc_Harmonics(void)               // Amplitude analysis...
             fptr = (char *)fptr + sizeof(struct RAM_SAMPLES);   // Increment pointer by number of bytes in
           }                                                     //   sample structure                     
         }
+#endif
         CH_State = 4;
         break;
 
@@ -6020,6 +6521,18 @@ void Calc_Harmonics(void)               // Amplitude analysis...
         //   held in constant N).
         //   If there is going to be wrap-around, divide it up into two moves, so we don't have to check
         //   each time in the for-loop.
+#ifdef ENABLE_SAMPLE_SOA
+        k = 0;                                                  // See comments above in case 1
+        num_blocks = SampleBuf_Span(HARM_SB_CHAN[wf_count][0], HarmSampleStartNdx, N_SAMPLES, &span);
+        for (i=0; i<num_blocks; ++i)
+        {
+          i16ptr = (int16_t *)span.Ptr[i];
+          for (sample_indx_end=0; sample_indx_end<span.Len[i]; ++sample_indx_end)
+          {
+            x_n[k++] = (float32_t)(*i16ptr++);                  // Voltage values are int16's - must cast
+          }                                                     //   to floats
+        }
+#else
         // If the 12-cy SampleBuf[] will wrap around..
         if (HarmSampleStartNdx > (TOTAL_SAMPLE_SETS - N_SAMPLES))
         {                                                       // See comments above in case 1
@@ -6044,6 +6557,7 @@ void Calc_Harmonics(void)               // Amplitude analysis...
             fptr = (char *)fptr + sizeof(struct RAM_SAMPLES);   //   to floats                           
           }
         }
+#endif
         CH_State = 4;
         break;
 
@@ -6056,6 +6570,22 @@ void Calc_Harmonics(void)               // Amplitude analysis...
         //   each time in the for-loop.
         // Note, the line-line (LL) voltages are computed from the line-to-neutral (LN) voltages, e.g.
         //   Vab = Van - Vbn.  Four pointers are used, two for each voltage.
+#ifdef ENABLE_SAMPLE_SOA
+        // See comments above in case 1.  The windows of the two voltages have the same start and length,
+        //   so they are split into blocks at the same place
+        SampleBuf_Span(HARM_SB_CHAN[wf_count][1], HarmSampleStartNdx, N_SAMPLES, &span2);
+        k = 0;
+        num_blocks = SampleBuf_Span(HARM_SB_CHAN[wf_count][0], HarmSampleStartNdx, N_SAMPLES, &span);
+        for (i=0; i<num_blocks; ++i)
+        {
+          i16ptr = (int16_t *)span.Ptr[i];
+          i16ptr2 = (int16_t *)span2.Ptr[i];
+          for (sample_indx_end=0; sample_indx_end<span.Len[i]; ++sample_indx_end)
+          {                                                     // LL voltages computed from LN voltages
+            x_n[k++] = (float32_t)(*i16ptr++) - (float32_t)(*i16ptr2++);
+          }
+        }
+#else
         // If the 12-cy SampleBuf[] will wrap around..
         if (HarmSampleStartNdx > (TOTAL_SAMPLE_SETS - N_SAMPLES))
         {                                                       // See comments above in case 1 and case 2
@@ -6083,9 +6613,30 @@ void Calc_Harmonics(void)               // Amplitude analysis...
             fptr2 = (char *)fptr2 + sizeof(struct RAM_SAMPLES);
           }
         }
+#endif
         CH_State = 4;
 //        break;                                Fall into next state
 
+#ifdef ENABLE_HARM_FOLD
+      case 4:                           // Case 4: Fold the 12 cycles of samples into Z_0[] thru Z_5[]
+        Harm_FoldCycles();
+        CH_State++;
+        CH_exit = TRUE;                 // Exit the subroutine now
+        break;
+
+      case 5:                           // Case 5: Compute the bins for harmonics 1 thru 20
+        Harm_BinsMag(HarmMag, 1, HARM_PER_PASS, (wf_count < 4));
+        CH_State++;
+        CH_exit = TRUE;                 // Exit the subroutine now
+        break;
+
+      case 6:                           // Case 6: Compute the bins for harmonics 21 thru 40, then group them
+        Harm_BinsMag(HarmMag, (HARM_PER_PASS + 1), 40, (wf_count < 4));
+
+        // Scale the bins, compensate for the AFE filter, and group them into the 40 harmonics per
+        //   IEC61000-4-7.  The currents and voltages are grouped differently (waveforms 0 - 3 are currents)
+        Harm_Group(HarmMag, instptr, (wf_count < 4));
+#else
       case 4:                           // Case 4: First half of calculations
         // Floating-point complex-by-real multiplication
         //   g_n = g_n .* w_n     '.*' denotes element-by-element multiplication
@@ -6212,6 +6763,7 @@ void Calc_Harmonics(void)               // Amplitude analysis...
                                      ) + 0.5f);                             // Add .5 for roundoff
           }
         }
+#endif
         // Filtered harmonics for aggregated harmonics.  Square the filtered harmonics and add to aggregated
         //   sum
         for (k=0; k<40; ++k)
@@ -6235,8 +6787,10 @@ void Calc_Harmonics(void)               // Amplitude analysis...
         switch (++wf_count)                             // Increment the waveform count for the next
         {                                               //   waveform, then jump to initialize the
           case 1:                                       //   pointers and the state
-            fptr = &SampleBuf[HarmSampleStartNdx].Ib;   // We are done when wf_count reaches 10
-            fptr1 = &SampleBuf[0].Ib;
+#ifndef ENABLE_SAMPLE_SOA
+            fptr = &SAMPLEBUF(Ib, HarmSampleStartNdx);  // We are done when wf_count reaches 10
+            fptr1 = &SAMPLEBUF(Ib, 0);
+#endif
             instptr = &HarmInst[0];
             filptr = &HarmonicsFil.Ib[0];
             sumptr = &HarmonicsSum.Ib[0];
@@ -6244,8 +6798,10 @@ void Calc_Harmonics(void)               // Amplitude analysis...
             CH_State = 1;
             break;
           case 2:
-            fptr = &SampleBuf[HarmSampleStartNdx].Ic;
-            fptr1 = &SampleBuf[0].Ic;
+#ifndef ENABLE_SAMPLE_SOA
+            fptr = &SAMPLEBUF(Ic, HarmSampleStartNdx);
+            fptr1 = &SAMPLEBUF(Ic, 0);
+#endif
             instptr = &HarmInst[0];
             filptr = &HarmonicsFil.Ic[0];
             sumptr = &HarmonicsSum.Ic[0];
@@ -6253,8 +6809,10 @@ void Calc_Harmonics(void)               // Amplitude analysis...
             CH_State = 1;
             break;
           case 3:
-            fptr = &SampleBuf[HarmSampleStartNdx].In;
-            fptr1 = &SampleBuf[0].In;
+#ifndef ENABLE_SAMPLE_SOA
+            fptr = &SAMPLEBUF(In, HarmSampleStartNdx);
+            fptr1 = &SAMPLEBUF(In, 0);
+#endif
             instptr = &HarmInst[0];
             filptr = &HarmonicsFil.In[0];
             sumptr = &HarmonicsSum.In[0];
@@ -6262,8 +6820,10 @@ void Calc_Harmonics(void)               // Amplitude analysis...
             CH_State = 1;
             break;
           case 4:
-            fptr = &SampleBuf[HarmSampleStartNdx].VanAFE;
-            fptr1 = &SampleBuf[0].VanAFE;
+#ifndef ENABLE_SAMPLE_SOA
+            fptr = &SAMPLEBUF(VanAFE, HarmSampleStartNdx);
+            fptr1 = &SAMPLEBUF(VanAFE, 0);
+#endif
             instptr = &HarmInst[0];
             filptr = &HarmonicsFil.Van[0];
             sumptr = &HarmonicsSum.Van[0];
@@ -6271,8 +6831,10 @@ void Calc_Harmonics(void)               // Amplitude analysis...
             CH_State = 2;
             break;
           case 5:
-            fptr = &SampleBuf[HarmSampleStartNdx].VbnAFE;
-            fptr1 = &SampleBuf[0].VbnAFE;
+#ifndef ENABLE_SAMPLE_SOA
+            fptr = &SAMPLEBUF(VbnAFE, HarmSampleStartNdx);
+            fptr1 = &SAMPLEBUF(VbnAFE, 0);
+#endif
             instptr = &HarmInst[0];
             filptr = &HarmonicsFil.Vbn[0];
             sumptr = &HarmonicsSum.Vbn[0];
@@ -6280,8 +6842,10 @@ void Calc_Harmonics(void)               // Amplitude analysis...
             CH_State = 2;
             break;
           case 6:
-            fptr = &SampleBuf[HarmSampleStartNdx].VcnAFE;
-            fptr1 = &SampleBuf[0].VcnAFE;
+#ifndef ENABLE_SAMPLE_SOA
+            fptr = &SAMPLEBUF(VcnAFE, HarmSampleStartNdx);
+            fptr1 = &SAMPLEBUF(VcnAFE, 0);
+#endif
             instptr = &HarmInst[0];
             filptr = &HarmonicsFil.Vcn[0];
             sumptr = &HarmonicsSum.Vcn[0];
@@ -6289,10 +6853,12 @@ void Calc_Harmonics(void)               // Amplitude analysis...
             CH_State = 2;
             break;
           case 7:
-            fptr = &SampleBuf[HarmSampleStartNdx].VanAFE;
-            fptr1 = &SampleBuf[0].VanAFE;
-            fptr2 = &SampleBuf[HarmSampleStartNdx].VbnAFE;
-            fptr3 = &SampleBuf[0].VbnAFE;
+#ifndef ENABLE_SAMPLE_SOA
+            fptr = &SAMPLEBUF(VanAFE, HarmSampleStartNdx);
+            fptr1 = &SAMPLEBUF(VanAFE, 0);
+            fptr2 = &SAMPLEBUF(VbnAFE, HarmSampleStartNdx);
+            fptr3 = &SAMPLEBUF(VbnAFE, 0);
+#endif
             instptr = &HarmInst[0];
             filptr = &HarmonicsFil.Vab[0];
             sumptr = &HarmonicsSum.Vab[0];
@@ -6300,10 +6866,12 @@ void Calc_Harmonics(void)               // Amplitude analysis...
             CH_State = 3;
             break;
           case 8:
-            fptr = &SampleBuf[HarmSampleStartNdx].VbnAFE;
-            fptr1 = &SampleBuf[0].VbnAFE;
-            fptr2 = &SampleBuf[HarmSampleStartNdx].VcnAFE;
-            fptr3 = &SampleBuf[0].VcnAFE;
+#ifndef ENABLE_SAMPLE_SOA
+            fptr = &SAMPLEBUF(VbnAFE, HarmSampleStartNdx);
+            fptr1 = &SAMPLEBUF(VbnAFE, 0);
+            fptr2 = &SAMPLEBUF(VcnAFE, HarmSampleStartNdx);
+            fptr3 = &SAMPLEBUF(VcnAFE, 0);
+#endif
             instptr = &HarmInst[0];
             filptr = &HarmonicsFil.Vbc[0];
             sumptr = &HarmonicsSum.Vbc[0];
@@ -6311,10 +6879,12 @@ void Calc_Harmonics(void)               // Amplitude analysis...
             CH_State = 3;
             break;
           case 9:
-            fptr = &SampleBuf[HarmSampleStartNdx].VcnAFE;
-            fptr1 = &SampleBuf[0].VcnAFE;
-            fptr2 = &SampleBuf[HarmSampleStartNdx].VanAFE;
-            fptr3 = &SampleBuf[0].VanAFE;
+#ifndef ENABLE_SAMPLE_SOA
+            fptr = &SAMPLEBUF(VcnAFE, HarmSampleStartNdx);
+            fptr1 = &SAMPLEBUF(VcnAFE, 0);
+            fptr2 = &SAMPLEBUF(VanAFE, HarmSampleStartNdx);
+            fptr3 = &SAMPLEBUF(VanAFE, 0);
+#endif
             instptr = &HarmInst[0];
             filptr = &HarmonicsFil.Vca[0];
             sumptr = &HarmonicsSum.Vca[0];
@@ -6403,24 +6973,532 @@ void Calc_Harmonics(void)               // Amplitude analysis...
 
 
 
+#if defined(ENABLE_HARM_FOLD) || defined(HOST_BUILD)
 
 //------------------------------------------------------------------------------------------------------------
-//             START OF FUNCTION       TP_CoilTempRMSavg()
+//             START OF FUNCTION       Harm_FoldCycles()
 //------------------------------------------------------------------------------------------------------------
 //
-//  FUNCTION:           Calculate coil temperature RMS average
+//  FUNCTION:           Fold the Harmonics Samples
 //
-//  MECHANICS:          This subroutine peforms the following operations:
-//                        1) Calculates C*sin(800Hz), C*cos(800Hz)
-//                           - sin(800Hz) and cos(800Hz) are defined by a table
-//                           - C is the coil temp waveform
-//                        2) Sums the values in C*sin(800Hz) and takes the average CS
-//                        3) Sums the values in C*cos(800Hz) and takes the average CC
-//                        4) Calculates RMS avg = sqrt(CS^2+CC^2)
-//                      
-//                      Coil Temperature Measurement Overview
-//                        - A 4800Hz square wave (generated by Timer 8) is injected into the Rogowski coil.
-//                        - The resultant voltage across the coil is sampled at a 4000Hz rate (Timer 5 is
+//  MECHANICS:          This subroutine folds the 12 cycles of samples in x_n[] into the six sets of 80
+//                      complex samples Z_0[] thru Z_5[] that are used to compute the bins in
+//                      Harm_Goertzel():
+//                          Z_d[n] = SUM(c=0..11) { x_n[80c+n] * e^(-j*2*pi*d*c/12) }      n = 0..79
+//                      This is a 12-point DFT across the cycles for each sample position in the cycle.  The
+//                      twiddle factors e^(-j*2*pi*d*c/12) are taken from HARM_COS_TBL[] at 80*(d*c mod 12).
+//                      The first cycle is copied, since its twiddle factor is 1.
+//                      Z_6[] thru Z_11[] are not computed.  Z_6[] is not used, and Z_7[] thru Z_11[] are
+//                      the complex conjugates of Z_5[] thru Z_1[] (the input is real).
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             x_n[], HARM_COS_TBL[]
+//
+//  OUTPUTS:            HarmZre[][], HarmZim[][]
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Harm_FoldCycles(void)
+{
+  float32_t *xptr, *reptr, *imptr;
+  float32_t cosv, sinv;
+  uint16_t j;
+  uint8_t c, d, n;
+
+  for (d=0; d<HARM_FOLD_OFFSETS; ++d)
+  {
+    reptr = &HarmZre[d][0];
+    imptr = &HarmZim[d][0];
+    for (n=0; n<SAMPLING_RATE; ++n)             // Cycle 0: twiddle factor is 1
+    {
+      reptr[n] = x_n[n];
+      imptr[n] = 0;
+    }
+    for (c=1; c<NUM_CYCLES; ++c)                // Cycles 1 - 11: add in x_n[] times the twiddle factor
+    {
+      j = ((d * c) % NUM_CYCLES) * SAMPLING_RATE;
+      cosv = HARM_COS_TBL[j];
+      sinv = HARM_COS_TBL[(j + HARM_SIN_OFFSET) % N_SAMPLES];
+      xptr = &x_n[c * SAMPLING_RATE];
+      for (n=0; n<SAMPLING_RATE; ++n)
+      {
+        reptr[n] += xptr[n] * cosv;
+        imptr[n] -= xptr[n] * sinv;
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         Harm_FoldCycles()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       Harm_BinsMag()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Compute the Bin Magnitudes for a Range of Harmonics
+//
+//  MECHANICS:          This subroutine computes the magnitudes of the 5Hz bins that are used by Harm_Group()
+//                      for harmonics first thru last.  The bins are:
+//                          Harmonics 1 and 2:   the primary bin only (60Hz, 120Hz)
+//                          Harmonics 3 - 39:    currents: the primary bin and the 5 bins on either side
+//                                               voltages: the primary bin and the bin on either side
+//                          Harmonic 40:         2375Hz thru 2395Hz (2400Hz is not available)
+//                      Each bin is computed by Harm_Goertzel() from the folded samples.
+//
+//  CAVEATS:            Harm_FoldCycles() must have been called for the waveform
+//
+//  INPUTS:             mag - pointer to the bin magnitudes (0Hz thru 2395Hz)
+//                      first, last - the range of harmonics (1 .. 40)
+//                      curr - True if the waveform is a current, False if it is a voltage
+//
+//  OUTPUTS:            mag[]
+//
+//  ALTERS:             None
+//
+//  CALLS:              Harm_Goertzel()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Harm_BinsMag(float32_t *mag, uint8_t first, uint8_t last, uint8_t curr)
+{
+  uint16_t k, lo, hi;
+  uint8_t h;
+
+  for (h=first; h<=last; ++h)
+  {
+    if (h <= 2)                                 // Fundamental and 2nd harmonic: primary bin only
+    {
+      lo = h * INDEX_FUNDAMENTAL;
+      hi = lo;
+    }
+    else if (h == 40)                           // 40th harmonic: top five bins
+    {
+      lo = (N_SAMPLES/2) - 5;
+      hi = (N_SAMPLES/2) - 1;
+    }
+    else if (curr)                              // Currents: primary bin +/- 5 bins
+    {
+      lo = (h * INDEX_FUNDAMENTAL) - 5;
+      hi = (h * INDEX_FUNDAMENTAL) + 5;
+    }
+    else                                        // Voltages: primary bin +/- 1 bin
+    {
+      lo = (h * INDEX_FUNDAMENTAL) - 1;
+      hi = (h * INDEX_FUNDAMENTAL) + 1;
+    }
+    for (k=lo; k<=hi; ++k)
+    {
+      mag[k] = Harm_Goertzel(k);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         Harm_BinsMag()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       Harm_Goertzel()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Compute a Single Bin Magnitude
+//
+//  MECHANICS:          This subroutine computes the magnitude of the 960-point DFT bin k (k x 5Hz) from the
+//                      folded samples Z_d[], where d = k mod 12:
+//                          X[k] = SUM(n=0..79) { Z_d[n] * e^(-j*2*pi*k*n/960) }
+//                      The sum is computed with the Goertzel recursion, which takes one real multiplication
+//                      per sample for each of the real and imaginary parts:
+//                          s[n] = Z_d[n] + 2cos(w)s[n-1] - s[n-2]          w = 2*pi*k/960
+//                          |X[k]| = |s[79] - e^(-jw)s[78]|
+//                      For d = 7 .. 11, Z_d[] is the complex conjugate of Z_(12-d)[], so the imaginary part
+//                      of Z_(12-d)[] is negated.
+//
+//  CAVEATS:            Bins with d = 6 (the bins halfway between the harmonics) are not used, and Z_6[] is
+//                      not computed.  Zero is returned for these bins.
+//
+//  INPUTS:             k - the bin number (0 .. 479)
+//                      HarmZre[][], HarmZim[][], HARM_COS_TBL[]
+//
+//  OUTPUTS:            Returns the magnitude of bin k
+//
+//  ALTERS:             None
+//
+//  CALLS:              sqrtf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+float32_t Harm_Goertzel(uint16_t k)
+{
+  float32_t *reptr, *imptr;
+  float32_t cosw, sinw, coeff, isign;
+  float32_t s1re, s1im, s2re, s2im, tmp;
+  uint8_t d, n;
+
+  d = k % NUM_CYCLES;
+  if (d < HARM_FOLD_OFFSETS)                    // d = 0 .. 5: use Z_d[]
+  {
+    reptr = &HarmZre[d][0];
+    imptr = &HarmZim[d][0];
+    isign = 1.0f;
+  }
+  else if (d > HARM_FOLD_OFFSETS)               // d = 7 .. 11: use the conjugate of Z_(12-d)[]
+  {
+    reptr = &HarmZre[NUM_CYCLES - d][0];
+    imptr = &HarmZim[NUM_CYCLES - d][0];
+    isign = -1.0f;
+  }
+  else                                          // d = 6: not used
+  {
+    return (0.0f);
+  }
+
+  cosw = HARM_COS_TBL[k];
+  sinw = HARM_COS_TBL[(k + HARM_SIN_OFFSET) % N_SAMPLES];
+  coeff = 2.0f * cosw;
+  s1re = 0;
+  s1im = 0;
+  s2re = 0;
+  s2im = 0;
+  for (n=0; n<SAMPLING_RATE; ++n)
+  {
+    tmp = reptr[n] + (coeff * s1re) - s2re;
+    s2re = s1re;
+    s1re = tmp;
+    tmp = (isign * imptr[n]) + (coeff * s1im) - s2im;
+    s2im = s1im;
+    s1im = tmp;
+  }
+  // X[k] = s[79] - (cos(w) - jsin(w))s[78]
+  tmp = s1re - (cosw * s2re) - (sinw * s2im);
+  s1im = s1im - (cosw * s2im) + (sinw * s2re);
+  return (sqrtf((tmp * tmp) + (s1im * s1im)));
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         Harm_Goertzel()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       Harm_Group()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Group the Harmonics
+//
+//  MECHANICS:          This subroutine converts the bin magnitudes of a waveform into the 40 instantaneous
+//                      harmonics:
+//                        1) The bins are scaled so that the fundamental (60Hz) is 1000
+//                        2) The bins are compensated for the AFE filter
+//                        3) The bins are grouped into the primary harmonics per IEC61000-4-7 (see below)
+//                      This is the same as the grouping in Calc_Harmonics() when ENABLE_HARM_FOLD is not
+//                      defined.  It is also used by the host build comparison (HostReplay -harm), so that
+//                      both methods are grouped identically.
+//
+//  CAVEATS:            Only the bins that are listed in Harm_BinsMag() are used
+//
+//  INPUTS:             mag - pointer to the bin magnitudes (0Hz thru 2395Hz)
+//                      curr - True if the waveform is a current, False if it is a voltage
+//
+//  OUTPUTS:            instptr[0..39] - the instantaneous harmonics in tenths of a per cent
+//
+//  ALTERS:             mag[] (scaled and compensated)
+//
+//  CALLS:              arm_scale_f32(), arm_mult_f32(), sqrtf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Harm_Group(float32_t *mag, uint16_t *instptr, uint8_t curr)
+{
+  uint16_t i, k;
+
+  // Vector scaling w.r.t fundamental.
+  //   In 12-cycle data, mag[ 12 ] is the fundamental.
+  //   And only need to consider the first ( N / 2 ) elements
+                                        // 24usec execution time typical (no sampling interrupt)
+  arm_scale_f32(mag, 1000 / mag[ INDEX_FUNDAMENTAL ], mag, N_SAMPLES/2);
+
+  // Compensate for the AFE filter
+  // Note, arm_mult_f32() does a vector by vector multiplication element by element.  See
+  //   arm_mult_f32.c in
+    // C:\Program Files (x86)\IAR Systems\Embedded Workbench 7.5\arm\CMSIS\DSP_Lib\Source\BasicMathFunctions
+  arm_mult_f32(&mag[1], (float32_t *)COMPENSATION_FACTOR_60HZ, &mag[1], 479);
+
+  // Final harmonics in % stored in mag[1..479]
+  //     mag[0] = DC component, mag[1] = 5Hz, mag[2] = 10Hz, ..., mag[479] = 2395Hz
+  // So primary harmonics (multiples of the fundamental) are at mag[12], mag[24], etc.
+  k = 0;
+  // We are only storing the 39 primary harmonics (i.e., the multiples of 60Hz).  The sub-harmonics
+  //   are added to the primary harmonics per IEC61000-4-7:
+  //       For the currents:
+  //         for the first two harmonics (60Hz and 120Hz), it is just the corresponding result
+  //         for the remaining higher harmonics, it is the square root of the sum of squares of the
+  //           primary harmonic plus the adjacent 4 lower and higher harmonics plus 1/2 of the
+  //           adjacent 5th higher and lower harmonics
+  //           For example, for the 5th harmonic (at 300Hz), the result is
+  //              SQRT(H[300]*H[300] + H[295]*H[295] + H[290]*H[290] + H[285]*H[285] + H[280]*H[280]
+  //                                 + H[305]*H[305] + H[310]*H[310] + H[315]*H[315] + H[320]*H[320]
+  //                                 + 1/2 * H[275]*H[275] + 1/2 * H[325]*H[325])
+  //       For the voltages:
+  //         for the first two harmonics (60Hz and 120Hz), it is just the corresponding result
+  //         for the remaining higher harmonics, it is the square root of the sum of squares of the
+  //           primary harmonic plus the adjacent lower and higher harmonics
+  //           For example, for the 5th harmonic (at 300Hz), the result is
+  //              SQRT(H[300]*H[300] + H[295]*H[295] + H[305]*H[305])
+  if (curr)
+  {
+    instptr[k++] = (uint16_t)((float)mag[12] + 0.5f);     // index 12: 60Hz
+    instptr[k++] = (uint16_t)((float)mag[24] + 0.5f);     // index 24: 120Hz
+    // 40th harmonic.  We only have up to 2395, so use 2395, 2390, 2385, 2380, 2375:
+    instptr[39] =  (uint16_t)( sqrtf(
+                         ((float)mag[479] * (float)mag[479])          // 1st lower adj harmonic (2395)
+                       + ((float)mag[478] * (float)mag[479])          // 2nd lower adj harmonic (2390)
+                       + ((float)mag[477] * (float)mag[477])          // 3rd lower adj harmonic (2385)
+                       + ((float)mag[476] * (float)mag[476])          // 4th lower adj harmonic (2380)
+                       + ((float)mag[475] * (float)mag[475] * 0.5f)   // 5th lower adj harmonic (2375)
+                             ) + 0.5f);                               // Add .5 for roundoff
+    // Remaining harmonics (3 thru 39): add the adjacent harmonics per IEC61000-4-7
+    for (i=36; i<=468; i+=12)
+    {
+      instptr[k++] = (uint16_t)( sqrtf(
+                         ((float)mag[i] * (float)mag[i])              // Primary
+                       + ((float)mag[i-1] * (float)mag[i-1])          // 1st lower adjacent harmonic
+                       + ((float)mag[i-2] * (float)mag[i-2])          // 2nd lower adjacent harmonic
+                       + ((float)mag[i-3] * (float)mag[i-3])          // 3rd lower adjacent harmonic
+                       + ((float)mag[i-4] * (float)mag[i-4])          // 4th lower adjacent harmonic
+                       + ((float)mag[i+1] * (float)mag[i+1])          // 1st upper adjacent harmonic
+                       + ((float)mag[i+2] * (float)mag[i+2])          // 2nd upper adjacent harmonic
+                       + ((float)mag[i+3] * (float)mag[i+3])          // 3rd upper adjacent harmonic
+                       + ((float)mag[i+4] * (float)mag[i+4])          // 4th upper adjacent harmonic
+                       + ((float)mag[i-5] * (float)mag[i-5] * 0.5f)   // 5th lower adjacent harmonic
+                       + ((float)mag[i+5] * (float)mag[i+5] * 0.5f)   // 5th upper adjacent harmonic
+                               ) + 0.5f);                             // Add .5 for roundoff
+    }
+  }
+  else
+  {
+    instptr[k++] = (uint16_t)((float)mag[12] + 0.5f);     // index 12: 60Hz
+    instptr[k++] = (uint16_t)((float)mag[24] + 0.5f);     // index 24: 120Hz
+    // 40th harmonic.  We only have up to 2395, so use 2395, 2390, 2385, 2380, 2375:
+    instptr[39] =  (uint16_t)( sqrtf(
+                         ((float)mag[479] * (float)mag[479])          // 1st lower adj harmonic (2395)
+                       + ((float)mag[478] * (float)mag[479])          // 2nd lower adj harmonic (2390)
+                       + ((float)mag[477] * (float)mag[477])          // 3rd lower adj harmonic (2385)
+                       + ((float)mag[476] * (float)mag[476])          // 4th lower adj harmonic (2380)
+                       + ((float)mag[475] * (float)mag[475] * 0.5f)   // 5th lower adj harmonic (2375)
+                             ) + 0.5f);                               // Add .5 for roundoff
+    for (i=36; i<=468; i+=12)
+    {
+      instptr[k++] = (uint16_t)( sqrtf(
+                         ((float)mag[i] * (float)mag[i])              // Primary
+                       + ((float)mag[i-1] * (float)mag[i-1])          // 1st lower adjacent harmonic
+                       + ((float)mag[i+1] * (float)mag[i+1])          // 1st upper adjacent harmonic
+                               ) + 0.5f);                             // Add .5 for roundoff
+    }
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         Harm_Group()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_HARM_FOLD || HOST_BUILD
+
+
+
+#ifdef HOST_BUILD
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       Harm_FFTMag()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Harmonics Bin Magnitudes - FFT Method
+//
+//  MECHANICS:          This subroutine computes the magnitudes of all of the 5Hz bins of the 12-cycle
+//                      samples in x_n[], using the FFT method that Calc_Harmonics() uses when
+//                      ENABLE_HARM_FOLD is not defined.  It is only compiled in the host build, where it is
+//                      the reference for the comparison in HostReplay ("HostReplay -harm").
+//
+//                      The magnitudes are computed using the ARM4 DSP Library.  The algorithm was developed
+//                      by George Gao:
+//
+//      Abstract
+//        This document describes a step-by-step approach to efficiently compute harmonics for an
+//        aribtary-length real input.  The approach is based on chirp transform algorithm, or chirp-z
+//        transform as it is commonly known.  The real input is first multiplied with a sequence of complex
+//        numbers.  The result is then zero-padded, and then fed into an FFT function.  The FFT function's
+//        output is further multiplied with a second sequence of complex numbers.  The result is then
+//        multipled with a third sequence of complex numbers to yield the final results.
+//
+//      Signal Flow Diagram
+//        The overall signal flow diagram is shown below.
+//
+//          w_n = W_N^(n^2/2)              x_n
+//                  |                       |
+//                  |                       V
+//                  |              +------------------+
+//                  +------------->|     Multiply     |
+//                  |              +------------------+
+//                  |                       |
+//                  |                      g_n                        h_n = W_N^(-n^2/2)
+//                  |                       |                                |
+//                  |                       V                                V
+//                  |              +------------------+             +------------------+
+//                  |              | Zero-pad to NFFT |             | Zero-pad to NFFT |
+//                  |              +------------------+             +------------------+
+//                  |                       |                                |
+//                  |                 zero-padded g_n                  zero-padded h_n
+//                  |                       |                                |
+//                  |                       V                                V
+//                  |              +------------------+             +------------------+
+//                  |              |  NFFT-point FFT  |             |  NFFT-point FFT  |
+//                  |              +------------------+             +------------------+
+//                  |                       |                                |
+//                  |                      G_w                              H_w
+//                  |                       |                                |
+//                  |                       V                                |
+//                  |              +------------------+                      |
+//                  |              |     Multiply     |<---------------------+
+//                  |              +------------------+
+//                  |                       |
+//                  |                      R_w
+//                  |                       |
+//                  |                       V
+//                  |              +------------------+
+//                  |              |  NFFT-point iFFT |    iFFT = Inverse FFT
+//                  |              +------------------+
+//                  |                       |
+//                  |                      r_n
+//                  |                       |
+//                  |                       V
+//                  |              +------------------+
+//                  +------------->|     Multiply     |
+//                                 +------------------+
+//                                          |
+//                                         y_n
+//                                          |
+//                                          V
+//                                  +----------------+
+//                                  |  Amplitude |.| |
+//                                  +----------------+
+//                                          |
+//                                          V
+//                                         z_n
+//
+//      Nomenclature
+//
+//        +---------------+--------------------------------------------------------------------------------+
+//        | Symbol        | Meaning                                                                        |
+//        |---------------|--------------------------------------------------------------------------------|
+//        | x_n           | Aribtary-length real input signal, e.g., phase-A current Ia.                   |
+//        | N             | Length of x_n, e.g., N=80 for a single cycle Ia in PXR 35.                     |
+//        | M             | Total number of harmonics. In this document, M=N.                              |
+//        | n             | Time index, 0 <= n < N.                                                        |
+//        | W_N           | A complex constant. W_N = e^(-2*pi*i/N) = cos(-2*pi/80) + i*sin(-2*pi/80)      |
+//        |               |    = 0.99692 - i * 0.078459                                                    |
+//        | w_n           | N-element complex array. w_n = W_N^[(n^2)/2].                                  |
+//        | NFFT          | Next power of 2 for FFT. NFFT = int32{2^[ceil(log_2(N+M-1))]}.                 |
+//        | g_n           | N-element complex array. Element-wise product of x_n and w_n.                  |
+//        |zero-padded g_n| NFFT-element complex array. First N elements are g_n. Remaining are zeros.     |
+//        | G_w           | NFFT-element complex array. G_w = FFT(zero-padded g_n).                        |
+//        | h_n           | (N+M-1)-element complex array. h_n = W_N^[-(n^2)/2] with 1 <= n < (N+M).       |
+//        |zero-padded h_n| NFFT-element complex array. First (N+M-1) elements are h_n. Remaining are zero |
+//        | H_w           | NFFT-element complex array. H_w=FFT(zero-padded h_n).                          |
+//        | R_w           | NFFT-element complex array. Element-wise product of G_w and H_w.               |
+//        | r_n           | NFFT-element complex array. r_n=iFFT(R_w). iFFT = Inverse FFT                  |
+//        | y_n           | N-element complex array. Element-wise product of the Nth to the (N+M-1)th      |
+//        |               |    elements of r_n with w_n.                                                   |
+//        | z_n           | N-element complex array. Amplitude of y_n.                                     |
+//        +---------------+--------------------------------------------------------------------------------+
+//
+//  CAVEATS:            Host build only
+//
+//  INPUTS:             x_n[], w_n[], H_w[]
+//
+//  OUTPUTS:            mag[0..479] - the bin magnitudes (0Hz thru 2395Hz)
+//
+//  ALTERS:             g_n[]
+//
+//  CALLS:              arm_cmplx_mult_real_f32(), arm_fill_f32(), arm_cfft_f32(), arm_cmplx_mult_cmplx_f32(),
+//                      arm_cmplx_mag_f32()
+//
+//  EXECUTION TIME:     On the target (220323, Rev 00.53 code), the two FFTs took 3.0msec and 3.5msec
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Harm_FFTMag(float32_t *mag)
+{
+  // Floating-point complex-by-real multiplication
+  //   g_n = g_n .* w_n     '.*' denotes element-by-element multiplication
+  arm_cmplx_mult_real_f32( (float32_t *)w_n, x_n, g_n, N_SAMPLES );
+
+  // zero-pad both real and imag of g[n] for subsequent NFFT-point FFT
+  arm_fill_f32(0.0f, g_n + 2 * N_SAMPLES, 2 * (NFFT - N_SAMPLES));
+
+  // In-place FFT on zero-padded g[n].  Results Gw = gn
+  //   ifftFlag = 0           Forward FFT
+  //   bitReverseFlag = 1     Bit reversal for radix-2 Cooley-Tukey FFT
+  arm_cfft_f32(&arm_cfft_sR_f32_len2048, g_n, 0, 1);
+
+  // Gw .* H_w = g_n .* H_w
+  arm_cmplx_mult_cmplx_f32(g_n, (float32_t *)H_w, g_n, NFFT);
+
+  // Inverse FFT on Gw * H_w
+  //   ifftFlag = 1           Inverse FFT
+  //   bitReverseFlag = 1     Bit reversal for radix-2 Cooley-Tukey FFT
+  arm_cfft_f32( &arm_cfft_sR_f32_len2048, g_n, 1, 1 );
+
+  // Use g_n[ 2 * ( N - 1 ) <= array index < 2 * ( N + N - 1 ) ] as input
+  //   Harmonics output g_n in { real, imag, ... , ... , real, imag } format 
+  arm_cmplx_mult_cmplx_f32( g_n + 2 * (N_SAMPLES - 1), (float32_t *)w_n, g_n, N_SAMPLES );
+
+  // Harmonics amplitude output.  Only the first ( N / 2 ) elements are needed
+  arm_cmplx_mag_f32(g_n, mag, N_SAMPLES/2);
+
+  // Special scaling treatment of dc component in mag[0]
+  mag[0] /= 2.0f;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         Harm_FFTMag()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // HOST_BUILD
+
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       TP_CoilTempRMSavg()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Calculate coil temperature RMS average
+//
+//  MECHANICS:          This subroutine peforms the following operations:
+//                        1) Calculates C*sin(800Hz), C*cos(800Hz)
+//                           - sin(800Hz) and cos(800Hz) are defined by a table
+//                           - C is the coil temp waveform
+//                        2) Sums the values in C*sin(800Hz) and takes the average CS
+//                        3) Sums the values in C*cos(800Hz) and takes the average CC
+//                        4) Calculates RMS avg = sqrt(CS^2+CC^2)
+//                      
+//                      Coil Temperature Measurement Overview
+//                        - A 4800Hz square wave (generated by Timer 8) is injected into the Rogowski coil.
+//                        - The resultant voltage across the coil is sampled at a 4000Hz rate (Timer 5 is
 //                          used to trigger ADC3 conversions every 250usec)
 //                        - Samples are read in the sampling interrupt (DMA1_Stream0_IRQHandler()) and
 //                          stored in coil_temp_samples[].  The circular buffer stores 200 samples - this is
@@ -7224,19 +8302,30 @@ void Calc_KFactor(void)
 //                             I1 phase = arctan[(Im{I1})/(Re{I1})]
 //                             I2 magnitude = sqrt[(Re{I2})^2 + (Im{I2})^2]/3
 //                             I2 phase = arctan[(Im{I2})/(Re{I2})]
-//
-//  CAVEATS:            None
+//                      Steps 2 - 4 and the phase angles are done in Calc_SeqComp_Phasors().
+//                      If ENABLE_SEQ_PHASOR is defined, step 1 is done in the sampling interrupt.  The sine
+//                      and cosine products are summed over each cycle (see update_THD_Sin_Cos_SOS()), and
+//                      saved in CurVolOneCycSin_Sav[] and CurVolOneCycCos_Sav[] at the one-cycle
+//                      anniversary.  This subroutine just scales the saved sums, and is called every cycle.
+//                      The results are the same as the SampleBuf[] computations over the same 80 samples,
+//                      except that the sample window always starts at the beginning of a one-cycle block.
+//                      The phase angles are therefore referenced to a different point on the waveform, but
+//                      the magnitudes and the phase angle differences are unchanged.
+//
+//  CAVEATS:            If ENABLE_SEQ_PHASOR is defined, this subroutine must be called after the one-cycle
+//                      anniversary (the saved sums are overwritten on the next anniversary)
 // 
-//  INPUTS:             SampleBuf[].Ia, .Ib, .Ic, .VanAFE, .VbnAFE, .VcnAFE - input samples
+//  INPUTS:             SampleBuf[].Ia, .Ib, .Ic, .VanAFE, .VbnAFE, .VcnAFE, .VanADC, .VbnADC, .VcnADC -
+//                      input samples
 //                      SampleIndex - next open index in SampleBuf[]
+//                      CurVolOneCycSin_Sav[], CurVolOneCycCos_Sav[] (replace SampleBuf[] if
+//                      ENABLE_SEQ_PHASOR is defined)
 // 
-//  OUTPUTS:            SeqComp.I_ZeroMag, .I_ZeroPh, .I_PosMag, .I_PosPh, .I_NegMag, .I_NegPh,
-//                      SeqComp.V_ZeroMag, .V_ZeroPh, .V_PosMag, .V_PosPh, .V_NegMag, .V_NegPh,
-//                      PhAngles1[]
+//  OUTPUTS:            SeqComp.xxx, PhAngles1[], PhAngles2[] (in Calc_SeqComp_Phasors())
 //
 //  ALTERS:             None
 // 
-//  CALLS:              sqrtf(), atanf()
+//  CALLS:              Calc_SeqComp_Phasors()
 // 
 //  EXECUTION TIME:     Measured on 190820 (rev 0.33 code): 226usec (with interrupts disabled)
 //
@@ -7244,14 +8333,30 @@ void Calc_KFactor(void)
 
 void Calc_SeqComp_PhAng(void)
 {
-  float temp, re_zero_seq, im_zero_seq, re_pos_seq, im_pos_seq, re_neg_seq, im_neg_seq;
-  float re_temp[6], im_temp[6];//_ia, re_temp_ib, re_temp_ic, im_temp_ia, im_temp_ib, im_temp_ic;
-//  float re_temp_van, re_temp_vbn, re_temp_vcn, im_temp_van, im_temp_vbn, im_temp_vcn;
+  float re_temp[9], im_temp[9];
+#ifndef ENABLE_SEQ_PHASOR
+  float temp;
   uint16_t ndx, ndx1;
-  uint8_t i, j;
+  uint8_t j;
+#endif
+  uint8_t i;
 
   // *** DAH  SHOULD PROBABLY ADD CODE TO ONLY CALCULATE IF THE RMS CURRENT OR VOLTAGE VALUE IS ABOVE A CERTAIN LIMIT - OTHERWISE SET TO NAN
 
+#ifdef ENABLE_SEQ_PHASOR
+  // The real and imaginary components are the one-cycle sine and cosine sums that were saved at the last
+  //   one-cycle anniversary.  Take the average and double it, the same as for the SampleBuf[] sums.  The
+  //   voltages are scaled to tenths to match the SampleBuf[] voltage samples (the sums are in volts)
+  for (i=0; i<3; i++)
+  {
+    re_temp[i] = CurVolOneCycSin_Sav[i]/40;
+    im_temp[i] = CurVolOneCycCos_Sav[i]/40;
+    re_temp[i+3] = CurVolOneCycSin_Sav[i+4] * 0.25f;
+    im_temp[i+3] = CurVolOneCycCos_Sav[i+4] * 0.25f;
+    re_temp[i+6] = CurVolOneCycSin_Sav[i+7] * 0.25f;
+    im_temp[i+6] = CurVolOneCycCos_Sav[i+7] * 0.25f;
+  }
+#else
   // Compute the starting sample index in SampleBuf[].  This is the present index - 80, accounting for
   // rollover
   ndx = SampleIndex;                    // Capture the present sample index
@@ -7266,21 +8371,21 @@ void Calc_SeqComp_PhAng(void)
   for (i=0; i<80; i++)
   {
     temp = SIN_COEFF[i];
-    re_temp[0] += (SampleBuf[ndx].Ia * temp);
-    re_temp[1] += (SampleBuf[ndx].Ib * temp);
-    re_temp[2] += (SampleBuf[ndx].Ic * temp);
-    re_temp[3] += (SampleBuf[ndx].VanAFE * temp);
-    re_temp[4] += (SampleBuf[ndx].VbnAFE * temp);
-    re_temp[5] += (SampleBuf[ndx].VcnAFE * temp);
+    re_temp[0] += (SAMPLEBUF(Ia, ndx) * temp);
+    re_temp[1] += (SAMPLEBUF(Ib, ndx) * temp);
+    re_temp[2] += (SAMPLEBUF(Ic, ndx) * temp);
+    re_temp[3] += (SAMPLEBUF(VanAFE, ndx) * temp);
+    re_temp[4] += (SAMPLEBUF(VbnAFE, ndx) * temp);
+    re_temp[5] += (SAMPLEBUF(VcnAFE, ndx) * temp);
 
     j = ((i <= 59) ? (i + 20) : (i - 60));           // Cos index = sin index + 90deg (20*4.5)
     temp = SIN_COEFF[j];                             //   with rollover at 80
-    im_temp[0] += (SampleBuf[ndx].Ia * temp);
-    im_temp[1] += (SampleBuf[ndx].Ib * temp);
-    im_temp[2] += (SampleBuf[ndx].Ic * temp);
-    im_temp[3] += (SampleBuf[ndx].VanAFE * temp);
-    im_temp[4] += (SampleBuf[ndx].VbnAFE * temp);
-    im_temp[5] += (SampleBuf[ndx].VcnAFE * temp);
+    im_temp[0] += (SAMPLEBUF(Ia, ndx) * temp);
+    im_temp[1] += (SAMPLEBUF(Ib, ndx) * temp);
+    im_temp[2] += (SAMPLEBUF(Ic, ndx) * temp);
+    im_temp[3] += (SAMPLEBUF(VanAFE, ndx) * temp);
+    im_temp[4] += (SAMPLEBUF(VbnAFE, ndx) * temp);
+    im_temp[5] += (SAMPLEBUF(VcnAFE, ndx) * temp);
     if (++ndx >= TOTAL_SAMPLE_SETS)                  // Increment ndx with rollover check
     {
       ndx = 0;
@@ -7291,17 +8396,94 @@ void Calc_SeqComp_PhAng(void)
     re_temp[i] = re_temp[i]/40;
     im_temp[i] = im_temp[i]/40;
   }
+
+  // Extract the real and imaginary components of the ADC voltages
+  for (i=6; i<9; i++)
+  {
+    re_temp[i] = 0.0f;
+    im_temp[i] = 0.0f;
+  }
+  for (i=0; i<80; i++)
+  {
+    temp = SIN_COEFF[i];
+    re_temp[6] += (SAMPLEBUF(VanADC, ndx1) * temp);
+    re_temp[7] += (SAMPLEBUF(VbnADC, ndx1) * temp);
+    re_temp[8] += (SAMPLEBUF(VcnADC, ndx1) * temp);
+
+    j = ((i <= 59) ? (i + 20) : (i - 60));           // Cos index = sin index + 90deg (20*4.5)
+    temp = SIN_COEFF[j];                             //   with rollover at 80
+    im_temp[6] += (SAMPLEBUF(VanADC, ndx1) * temp);
+    im_temp[7] += (SAMPLEBUF(VbnADC, ndx1) * temp);
+    im_temp[8] += (SAMPLEBUF(VcnADC, ndx1) * temp);
+    if (++ndx1 >= TOTAL_SAMPLE_SETS)                 // Increment ndx with rollover check
+    {
+      ndx1 = 0;
+    }
+  }
+  for (i=6; i<9; i++)
+  {
+    re_temp[i] = re_temp[i]/40;
+    im_temp[i] = im_temp[i]/40;
+  }
+#endif
+
+  Calc_SeqComp_Phasors(re_temp, im_temp);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         Calc_SeqComp_PhAng()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       Calc_SeqComp_Phasors()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Sequence Components and Phase Angles From Phasors
+//
+//  MECHANICS:          This subroutine computes the current and AFE voltage sequence components, the
+//                      negative-sequence unbalances, and the phase angles from the real and imaginary
+//                      components (amplitudes) of the fundamental of each channel.  The sequence components
+//                      are computed as described in Calc_SeqComp_PhAng().
+//                      The negative-sequence unbalance is the negative sequence magnitude divided by the
+//                      positive sequence magnitude, in percent.  It is not computed if the positive sequence
+//                      magnitude is zero.
+//                      The subroutine is separate from Calc_SeqComp_PhAng() so that the host replay can
+//                      compare the one-cycle phasors (ENABLE_SEQ_PHASOR defined) with the SampleBuf[]
+//                      phasors using the same computations.
+//
+//  CAVEATS:            re_ptr[] and im_ptr[] must have 9 values, in the order Ia, Ib, Ic, VanAFE, VbnAFE,
+//                      VcnAFE, VanADC, VbnADC, VcnADC.  The voltages are in tenths of volts
+//
+//  INPUTS:             re_ptr[] - real components, im_ptr[] - imaginary components
+//
+//  OUTPUTS:            SeqComp.I_ZeroMag, .I_ZeroPh, .I_PosMag, .I_PosPh, .I_NegMag, .I_NegPh, .I_NegUnbal,
+//                      SeqComp.V_ZeroMag, .V_ZeroPh, .V_PosMag, .V_PosPh, .V_NegMag, .V_NegPh, .V_NegUnbal,
+//                      PhAngles1[], PhAngles2[]
+//
+//  ALTERS:             None
+//
+//  CALLS:              sqrtf(), atanf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Calc_SeqComp_Phasors(const float *re_ptr, const float *im_ptr)
+{
+  float temp, re_zero_seq, im_zero_seq, re_pos_seq, im_pos_seq, re_neg_seq, im_neg_seq;
+  uint8_t i;
+
   // First do the currents
-  re_zero_seq = re_temp[0] + re_temp[1] + re_temp[2];
-  im_zero_seq = im_temp[0] + im_temp[1] + im_temp[2];
-  re_pos_seq = re_temp[0] + (-0.5f * re_temp[1]) - (0.866025404f * im_temp[1])
-                    + (-0.5f * re_temp[2]) + (0.866025404f * im_temp[2]);
-  im_pos_seq = im_temp[0] + (0.866025404f * re_temp[1]) - (0.5f * im_temp[1])
-                    + (-0.866025404f * re_temp[2]) - (0.5f * im_temp[2]);
-  re_neg_seq = re_temp[0] + (-0.5f * re_temp[1]) + (0.866025404f * im_temp[1])
-                    + (-0.5f * re_temp[2]) - (0.866025404f * im_temp[2]);
-  im_neg_seq = im_temp[0] + (-0.866025404f * re_temp[1]) - (0.5f * im_temp[1])
-                    + (0.866025404f * re_temp[2]) - (0.5f * im_temp[2]);
+  re_zero_seq = re_ptr[0] + re_ptr[1] + re_ptr[2];
+  im_zero_seq = im_ptr[0] + im_ptr[1] + im_ptr[2];
+  re_pos_seq = re_ptr[0] + (-0.5f * re_ptr[1]) - (0.866025404f * im_ptr[1])
+                    + (-0.5f * re_ptr[2]) + (0.866025404f * im_ptr[2]);
+  im_pos_seq = im_ptr[0] + (0.866025404f * re_ptr[1]) - (0.5f * im_ptr[1])
+                    + (-0.866025404f * re_ptr[2]) - (0.5f * im_ptr[2]);
+  re_neg_seq = re_ptr[0] + (-0.5f * re_ptr[1]) + (0.866025404f * im_ptr[1])
+                    + (-0.5f * re_ptr[2]) - (0.866025404f * im_ptr[2]);
+  im_neg_seq = im_ptr[0] + (-0.866025404f * re_ptr[1]) - (0.5f * im_ptr[1])
+                    + (0.866025404f * re_ptr[2]) - (0.5f * im_ptr[2]);
 
   SeqComp.I_ZeroMag = (sqrtf(re_zero_seq * re_zero_seq + im_zero_seq * im_zero_seq))/3;
   if (im_zero_seq < 0.0001f)
@@ -7343,16 +8525,16 @@ void Calc_SeqComp_PhAng(void)
     SeqComp.I_NegPh = atanf(im_neg_seq/re_neg_seq);
   }
   // Now do the voltages
-  re_zero_seq = re_temp[3] + re_temp[4] + re_temp[5];
-  im_zero_seq = im_temp[3] + im_temp[4] + im_temp[5];
-  re_pos_seq = re_temp[3] + (-0.5f * re_temp[4]) - (0.866025404f * im_temp[4])
-                    + (-0.5f * re_temp[5]) + (0.866025404f * im_temp[5]);
-  im_pos_seq = im_temp[3] + (0.866025404f * re_temp[4]) - (0.5f * im_temp[4])
-                    + (-0.866025404f * re_temp[5]) - (0.5f * im_temp[5]);
-  re_neg_seq = re_temp[3] + (-0.5f * re_temp[4]) + (0.866025404f * im_temp[4])
-                    + (-0.5f * re_temp[5]) - (0.866025404f * im_temp[5]);
-  im_neg_seq = im_temp[3] + (-0.866025404f * re_temp[4]) - (0.5f * im_temp[4])
-                    + (0.866025404f * re_temp[5]) - (0.5f * im_temp[5]);
+  re_zero_seq = re_ptr[3] + re_ptr[4] + re_ptr[5];
+  im_zero_seq = im_ptr[3] + im_ptr[4] + im_ptr[5];
+  re_pos_seq = re_ptr[3] + (-0.5f * re_ptr[4]) - (0.866025404f * im_ptr[4])
+                    + (-0.5f * re_ptr[5]) + (0.866025404f * im_ptr[5]);
+  im_pos_seq = im_ptr[3] + (0.866025404f * re_ptr[4]) - (0.5f * im_ptr[4])
+                    + (-0.866025404f * re_ptr[5]) - (0.5f * im_ptr[5]);
+  re_neg_seq = re_ptr[3] + (-0.5f * re_ptr[4]) + (0.866025404f * im_ptr[4])
+                    + (-0.5f * re_ptr[5]) - (0.866025404f * im_ptr[5]);
+  im_neg_seq = im_ptr[3] + (-0.866025404f * re_ptr[4]) - (0.5f * im_ptr[4])
+                    + (0.866025404f * re_ptr[5]) - (0.5f * im_ptr[5]);
 
   SeqComp.V_ZeroMag = (sqrtf(re_zero_seq * re_zero_seq + im_zero_seq * im_zero_seq))/3;
   if (im_zero_seq < 0.0001f)
@@ -7394,32 +8576,43 @@ void Calc_SeqComp_PhAng(void)
     SeqComp.V_NegPh = atanf(im_neg_seq/re_neg_seq);
   }
 
+  // Compute the negative-sequence unbalances.  These are equal to (negative sequence magnitude)/(positive
+  //   sequence magnitude) * 100
+  if (SeqComp.I_PosMag > 0)
+  {
+    SeqComp.I_NegUnbal = (SeqComp.I_NegMag/SeqComp.I_PosMag) * 100.0f;
+  }
+  if (SeqComp.V_PosMag > 0)
+  {
+    SeqComp.V_NegUnbal = (SeqComp.V_NegMag/SeqComp.V_PosMag) * 100.0f;
+  }
+
   // Compute the phase angles for the currents and line-to-neutral AFE voltages.  This is just the
   //   arctangent of the angle formed by the real and imaginary component vectors, adjusted for the quadrant
   for (i=0; i<6; ++i)
   {
-    temp = ((im_temp[i] < 0.0f) ? (im_temp[i] * -1.0f) : (im_temp[i]));
+    temp = ((im_ptr[i] < 0.0f) ? (im_ptr[i] * -1.0f) : (im_ptr[i]));
     if (temp < 0.0001f)
     {
       PhAngles1[i] = 0.0f;
     }
     else
     {
-      temp = ((re_temp[i] < 0.0f) ? (re_temp[i] * -1.0f) : (re_temp[i]));
+      temp = ((re_ptr[i] < 0.0f) ? (re_ptr[i] * -1.0f) : (re_ptr[i]));
       if (temp < 0.0001f)
       {
         PhAngles1[i] = 90.0f;
       }
       else
       {
-        PhAngles1[i] = 180.0 * atanf(im_temp[i]/re_temp[i])/3.141592659f;
+        PhAngles1[i] = 180.0 * atanf(im_ptr[i]/re_ptr[i])/3.141592659f;
       }
       // Adjust for the quadrant.  If real and imaginary are negative, move from 1st to 3rd quadrant by
       //   subtracting 180.  If real is negative and imaginary is positive, move from 4st to 2nd quadrant by
       //   adding 180.  Otherwise, value is ok as is.
-      if (re_temp[i] < 0)
+      if (re_ptr[i] < 0)
       {
-        PhAngles1[i] = ((im_temp[i] < 0) ? (PhAngles1[i] - 180.0f) : (PhAngles1[i] +180.0f));
+        PhAngles1[i] = ((im_ptr[i] < 0) ? (PhAngles1[i] - 180.0f) : (PhAngles1[i] +180.0f));
       }
     }
   }
@@ -7428,61 +8621,31 @@ void Calc_SeqComp_PhAng(void)
   PhAngles1[7] = PhAngles1[5] - PhAngles1[4];       // Phb-c = Phc - Phb
   PhAngles1[8] = PhAngles1[3] - PhAngles1[5];       // Phc-a = Pha - Phc
 
-  // Compute the phase angles for the ADC voltages.  First need to extract the real and imaginary
-  //   components.
-  // Extract the real and imaginary components of each waveform by multiplying them by a unit sin and cosine
-  for (i=0; i<3; i++)
-  {
-    re_temp[i] = 0.0f;
-    im_temp[i] = 0.0f;
-  }
-  for (i=0; i<80; i++)
-  {
-    temp = SIN_COEFF[i];
-    re_temp[0] += (SampleBuf[ndx1].VanADC * temp);
-    re_temp[1] += (SampleBuf[ndx1].VbnADC * temp);
-    re_temp[2] += (SampleBuf[ndx1].VcnADC * temp);
-
-    j = ((i <= 59) ? (i + 20) : (i - 60));           // Cos index = sin index + 90deg (20*4.5)
-    temp = SIN_COEFF[j];                             //   with rollover at 80
-    im_temp[0] += (SampleBuf[ndx1].VanADC * temp);
-    im_temp[1] += (SampleBuf[ndx1].VbnADC * temp);
-    im_temp[2] += (SampleBuf[ndx1].VcnADC * temp);
-    if (++ndx1 >= TOTAL_SAMPLE_SETS)                 // Increment ndx with rollover check
-    {
-      ndx1 = 0;
-    }
-  }
-  for (i=0; i<3; i++)
-  {
-    re_temp[i] = re_temp[i]/40;
-    im_temp[i] = im_temp[i]/40;
-  }
   // Compute the phase angles for the ADC voltages
   for (i=0; i<3; ++i)
   {
-    temp = ((im_temp[i] < 0.0f) ? (im_temp[i] * -1.0f) : (im_temp[i]));
+    temp = ((im_ptr[i+6] < 0.0f) ? (im_ptr[i+6] * -1.0f) : (im_ptr[i+6]));
     if (temp < 0.0001f)
     {
       PhAngles2[i] = 0.0f;
     }
     else
     {
-      temp = ((re_temp[i] < 0.0f) ? (re_temp[i] * -1.0f) : (re_temp[i]));
+      temp = ((re_ptr[i+6] < 0.0f) ? (re_ptr[i+6] * -1.0f) : (re_ptr[i+6]));
       if (temp < 0.0001f)
       {
         PhAngles2[i] = 90.0f;
       }
       else
       {
-        PhAngles2[i] = 180.0 * atanf(im_temp[i]/re_temp[i])/3.141592659f;
+        PhAngles2[i] = 180.0 * atanf(im_ptr[i+6]/re_ptr[i+6])/3.141592659f;
       }
       // Adjust for the quadrant.  If real and imaginary are negative, move from 1st to 3rd quadrant by
       //   subtracting 180.  If real is negative and imaginary is positive, move from 4st to 2nd quadrant by
       //   adding 180.  Otherwise, value is ok as is.
-      if (re_temp[i] < 0)
+      if (re_ptr[i+6] < 0)
       {
-        PhAngles2[i] = ((im_temp[i] < 0) ? (PhAngles2[i] - 180.0f) : (PhAngles2[i] +180.0f));
+        PhAngles2[i] = ((im_ptr[i+6] < 0) ? (PhAngles2[i] - 180.0f) : (PhAngles2[i] +180.0f));
       }
     }
   }
@@ -7490,11 +8653,11 @@ void Calc_SeqComp_PhAng(void)
   PhAngles2[3] = PhAngles2[0] - PhAngles2[1];       // Pha-b = Pha - Phb
   PhAngles2[4] = PhAngles2[1] - PhAngles2[2];       // Phb-c = Phb - Phc
   PhAngles2[5] = PhAngles2[2] - PhAngles2[0];       // Phc-a = Phc - Pha
-
 }
 
+
 //------------------------------------------------------------------------------------------------------------
-//             END OF FUNCTION         Calc_SeqComp_PhAng()
+//             END OF FUNCTION         Calc_SeqComp_Phasors()
 //------------------------------------------------------------------------------------------------------------
 
 
@@ -7622,6 +8785,168 @@ void Calc_Freq(struct FREQ_MEASURE_VARS *f_ptr, float v_xn)
 //------------------------------------------------------------------------------------------------------------
 
 
+
+#ifdef ENABLE_FREQ_TRACK
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       Calc_FreqTrack()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Zero-Crossing Frequency Tracker
+//
+//  MECHANICS:          The sampling interrupt (update_FreqTrack() in IntrInline_def.h) finds each
+//                      positive-going zero crossing of VanAFE by linear interpolation between the two
+//                      samples on either side of it, and adds the period since the previous crossing, in
+//                      seconds, to FreqTrack.PerSum.  Interpolating the crossings gives a resolution of a
+//                      small fraction of a sample, instead of the +/-1 sample of counting samples.
+//                      This subroutine is called every cycle.  It does the following:
+//                        - Takes the sum of the periods, and the number of periods, that were measured since
+//                          the last call, and resets them
+//                        - If there has been no crossing for FREQTRK_MAX_SAMPLES samples, the frequency and
+//                          ROCOF are invalid (NAN).  If no period was completed (this happens below 60Hz,
+//                          since a period may be more than 80 samples), the frequency and ROCOF are held
+//                        - Otherwise the measured frequency is:
+//                              f = number of periods / sum of the periods
+//                          If f is outside FREQTRK_MIN_HZ .. FREQTRK_MAX_HZ, the frequency and ROCOF are
+//                          invalid.  Otherwise the smoothed frequency is updated:
+//                              FreqVal = FreqVal + FREQTRK_ALPHA * (f - FreqVal)
+//                          The first valid reading is used as is
+//                        - The smoothed frequency and the time since the last entry (80 samples at the
+//                          sample rate for each call since then) are saved in the history buffers.  Once
+//                          there are FREQTRK_ROCOF_NUM entries, the ROCOF is the change in the smoothed
+//                          frequency from the oldest entry, divided by the time since the oldest entry
+//                        - If ENABLE_FREQ_RETUNE is defined, the frequency is clamped to
+//                          FREQTRK_TUNE_MIN_HZ .. FREQTRK_TUNE_MAX_HZ.  If it differs from the tuned
+//                          frequency by more than FREQTRK_TUNE_HYST, the new TIM3 and AFE settings for a rate
+//                          of 80 samples per cycle are computed, and the sampling interrupt is requested to
+//                          load them (Update_Sample_Rate() in Init.c).  The TIM3 clock is 60MHz, so:
+//                              TIM3 counts per sample = 60MHz/(80 * f) = 750,000/f
+//                          and the AFE decimation rate for the same sample rate, with its 4.000MHz clock, is:
+//                              N = 4.000MHz/(8 * 60MHz/counts) = counts/120
+//                          The fraction of N is in units of 1/65536.  At 60Hz, these give the settings in
+//                          AFE_Init() and Init_TIM3() (12500 counts, N = 104 + 0x2AAB/65536).  The settings
+//                          are not changed while the frequency is invalid
+//
+//  CAVEATS:            Call every one-cycle anniversary
+//                      If ENABLE_FREQ_RETUNE is defined, the one-cycle, 200msec, and one-second anniversaries
+//                      are every 80, 960, and 4800 samples at the tuned rate.  The energy computations allow
+//                      for this (see MS200_TO_HRS), but the other timers based on the anniversaries do not
+//
+//  INPUTS:             FreqTrack.PerSum, FreqTrack.PerCnt, FreqTrack.SampCtr, FreqTrack.SamplePer
+//
+//  OUTPUTS:            FreqTrack.FreqVal, FreqTrack.Rocof
+//                      FreqTrack.TuneFreq, FreqTrack.TuneRate, FreqTrack.TuneARR, FreqTrack.TuneDecN,
+//                      FreqTrack.TuneDecIF, FreqTrack.TuneReq (ENABLE_FREQ_RETUNE defined)
+//
+//  ALTERS:             FreqTrack.PerSum, FreqTrack.PerCnt, FreqTrack.PendTime, FreqTrack.HistFreq[],
+//                      FreqTrack.HistTime[], FreqTrack.HistNdx, FreqTrack.HistCnt
+//
+//  CALLS:              __disable_irq(), __enable_irq()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Calc_FreqTrack(void)
+{
+  float per_sum, new_freq, sum_time;
+  uint16_t samp_ctr;
+  uint8_t per_cnt, i;
+#ifdef ENABLE_FREQ_RETUNE
+  float tune_freq;
+  uint32_t counts;
+#endif
+
+  __disable_irq();                              // Get the periods measured by the sampling interrupt
+  per_sum = FreqTrack.PerSum;
+  per_cnt = FreqTrack.PerCnt;
+  samp_ctr = FreqTrack.SampCtr;
+  FreqTrack.PerSum = 0;
+  FreqTrack.PerCnt = 0;
+  __enable_irq();
+
+  FreqTrack.PendTime += 80.0f * FreqTrack.SamplePer;
+
+  if (per_cnt > 0)                              // If at least one period was measured, compute the new
+  {                                             //   frequency
+    new_freq = (float)per_cnt / per_sum;
+    if ( (new_freq < FREQTRK_MIN_HZ) || (new_freq > FREQTRK_MAX_HZ) )
+    {
+      samp_ctr = FREQTRK_MAX_SAMPLES;               // Out of range, so treat the same as no crossings
+    }
+    else if (isnan(FreqTrack.FreqVal))              // First valid reading, so use it as is
+    {
+      FreqTrack.FreqVal = new_freq;
+    }
+    else                                            // Otherwise smooth it
+    {
+      FreqTrack.FreqVal += FREQTRK_ALPHA * (new_freq - FreqTrack.FreqVal);
+    }
+  }
+
+  if ( (samp_ctr >= FREQTRK_MAX_SAMPLES) || (isnan(FreqTrack.FreqVal)) )
+  {                                             // If no crossings or invalid frequency, the frequency and
+    FreqTrack.FreqVal = NAN;                    //   ROCOF are invalid.  Restart the history
+    FreqTrack.Rocof = NAN;
+    FreqTrack.HistCnt = 0;
+    FreqTrack.PendTime = 0;
+    return;
+  }
+
+  // If a new frequency was measured, save it and the time since the last entry.  Once the history is full,
+  //   compute the ROCOF over the history.  FreqTrack.HistNdx is then the index of the oldest entry
+  if (per_cnt > 0)
+  {
+    FreqTrack.HistFreq[FreqTrack.HistNdx] = FreqTrack.FreqVal;
+    FreqTrack.HistTime[FreqTrack.HistNdx] = FreqTrack.PendTime;
+    FreqTrack.PendTime = 0;
+    FreqTrack.HistNdx = ( (FreqTrack.HistNdx >= (FREQTRK_ROCOF_NUM - 1)) ? 0 : (FreqTrack.HistNdx + 1) );
+    if (FreqTrack.HistCnt < FREQTRK_ROCOF_NUM)
+    {
+      ++FreqTrack.HistCnt;
+    }
+    if (FreqTrack.HistCnt >= FREQTRK_ROCOF_NUM)
+    {
+      sum_time = 0;                             // Sum the times of the entries after the oldest entry
+      for (i=0; i<FREQTRK_ROCOF_NUM; ++i)
+      {
+        if (i != FreqTrack.HistNdx)
+        {
+          sum_time += FreqTrack.HistTime[i];
+        }
+      }
+      FreqTrack.Rocof = (FreqTrack.FreqVal - FreqTrack.HistFreq[FreqTrack.HistNdx]) / sum_time;
+    }
+    else
+    {
+      FreqTrack.Rocof = NAN;
+    }
+  }
+
+#ifdef ENABLE_FREQ_RETUNE
+  // Retune the sample rate if the frequency has moved.  Don't compute new settings while the sampling
+  //   interrupt has not yet loaded the previous ones
+  tune_freq = FreqTrack.FreqVal;
+  tune_freq = ( (tune_freq < FREQTRK_TUNE_MIN_HZ) ? FREQTRK_TUNE_MIN_HZ : tune_freq );
+  tune_freq = ( (tune_freq > FREQTRK_TUNE_MAX_HZ) ? FREQTRK_TUNE_MAX_HZ : tune_freq );
+  if ( (!FreqTrack.TuneReq) && (fabsf(tune_freq - FreqTrack.TuneFreq) > FREQTRK_TUNE_HYST) )
+  {
+    counts = (uint32_t)(750000.0f / tune_freq + 0.5f);        // TIM3 counts per sample
+    FreqTrack.TuneARR = (uint16_t)(counts - 1);
+    FreqTrack.TuneDecN = (uint16_t)(counts / 120);           // AFE decimation rate
+    FreqTrack.TuneDecIF = (uint16_t)((((counts % 120) << 16) + 60) / 120);
+    FreqTrack.TuneRate = 60.0E6f / (float)counts;
+    FreqTrack.TuneFreq = tune_freq;
+    FreqTrack.TuneReq = TRUE;                   // This must be last!
+  }
+#endif
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         Calc_FreqTrack()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_FREQ_TRACK
+
+
 void SnapshotMeter(uint16_t SummaryCode)
 {
 
@@ -8851,51 +10176,51 @@ uint8_t CaptureUserWaveform(uint16_t type)
     switch (type)
     {
       case USR_TYPE_ALL:
-        UserSamples.OneCyc[0][UserWFind] = SampleBuf[BufferIndex].Ia;
-        UserSamples.OneCyc[0][UserWFind] = SampleBuf[BufferIndex].Ia;
-        UserSamples.OneCyc[1][UserWFind] = SampleBuf[BufferIndex].Ib;
-        UserSamples.OneCyc[2][UserWFind] = SampleBuf[BufferIndex].Ic;
-        UserSamples.OneCyc[3][UserWFind] = SampleBuf[BufferIndex].In;
-        UserSamples.OneCyc[4][UserWFind] = SampleBuf[BufferIndex].Igsrc;
-        UserSamples.OneCyc[5][UserWFind] = SampleBuf[BufferIndex].VanAFE;
-        UserSamples.OneCyc[6][UserWFind] = SampleBuf[BufferIndex].VbnAFE;
-        UserSamples.OneCyc[7][UserWFind] = SampleBuf[BufferIndex].VcnAFE;
-        UserSamples.OneCyc[8][UserWFind] = SampleBuf[BufferIndex].VanADC;
-        UserSamples.OneCyc[9][UserWFind] = SampleBuf[BufferIndex].VbnADC;
-        UserSamples.OneCyc[10][UserWFind] = SampleBuf[BufferIndex].VcnADC;
+        UserSamples.OneCyc[0][UserWFind] = SAMPLEBUF(Ia, BufferIndex);
+        UserSamples.OneCyc[0][UserWFind] = SAMPLEBUF(Ia, BufferIndex);
+        UserSamples.OneCyc[1][UserWFind] = SAMPLEBUF(Ib, BufferIndex);
+        UserSamples.OneCyc[2][UserWFind] = SAMPLEBUF(Ic, BufferIndex);
+        UserSamples.OneCyc[3][UserWFind] = SAMPLEBUF(In, BufferIndex);
+        UserSamples.OneCyc[4][UserWFind] = SAMPLEBUF(Igsrc, BufferIndex);
+        UserSamples.OneCyc[5][UserWFind] = SAMPLEBUF(VanAFE, BufferIndex);
+        UserSamples.OneCyc[6][UserWFind] = SAMPLEBUF(VbnAFE, BufferIndex);
+        UserSamples.OneCyc[7][UserWFind] = SAMPLEBUF(VcnAFE, BufferIndex);
+        UserSamples.OneCyc[8][UserWFind] = SAMPLEBUF(VanADC, BufferIndex);
+        UserSamples.OneCyc[9][UserWFind] = SAMPLEBUF(VbnADC, BufferIndex);
+        UserSamples.OneCyc[10][UserWFind] = SAMPLEBUF(VcnADC, BufferIndex);
         break;
       case USR_TYPE_IA:
-        UserSamples.TwelveCyc[UserWFind] = SampleBuf[BufferIndex].Ia;
+        UserSamples.TwelveCyc[UserWFind] = SAMPLEBUF(Ia, BufferIndex);
         break;
       case USR_TYPE_IB:
-        UserSamples.TwelveCyc[UserWFind] = SampleBuf[BufferIndex].Ib;
+        UserSamples.TwelveCyc[UserWFind] = SAMPLEBUF(Ib, BufferIndex);
         break;
       case USR_TYPE_IC:
-        UserSamples.TwelveCyc[UserWFind] = SampleBuf[BufferIndex].Ic;
+        UserSamples.TwelveCyc[UserWFind] = SAMPLEBUF(Ic, BufferIndex);
         break;
       case USR_TYPE_IN:
-        UserSamples.TwelveCyc[UserWFind] = SampleBuf[BufferIndex].In;
+        UserSamples.TwelveCyc[UserWFind] = SAMPLEBUF(In, BufferIndex);
         break;
       case USR_TYPE_IGS:
-        UserSamples.TwelveCyc[UserWFind] = SampleBuf[BufferIndex].Igsrc;
+        UserSamples.TwelveCyc[UserWFind] = SAMPLEBUF(Igsrc, BufferIndex);
         break;
       case USR_TYPE_VANAFE:
-        UserSamples.TwelveCyc[UserWFind] = SampleBuf[BufferIndex].VanAFE;
+        UserSamples.TwelveCyc[UserWFind] = SAMPLEBUF(VanAFE, BufferIndex);
         break;
       case USR_TYPE_VBNAFE:
-        UserSamples.TwelveCyc[UserWFind] = SampleBuf[BufferIndex].VbnAFE;
+        UserSamples.TwelveCyc[UserWFind] = SAMPLEBUF(VbnAFE, BufferIndex);
         break;
       case USR_TYPE_VCNAFE:
-        UserSamples.TwelveCyc[UserWFind] = SampleBuf[BufferIndex].VcnAFE;
+        UserSamples.TwelveCyc[UserWFind] = SAMPLEBUF(VcnAFE, BufferIndex);
         break;
       case USR_TYPE_VANADC:
-        UserSamples.TwelveCyc[UserWFind] = SampleBuf[BufferIndex].VanADC;
+        UserSamples.TwelveCyc[UserWFind] = SAMPLEBUF(VanADC, BufferIndex);
         break;
       case USR_TYPE_VBNADC:
-        UserSamples.TwelveCyc[UserWFind] = SampleBuf[BufferIndex].VbnADC;
+        UserSamples.TwelveCyc[UserWFind] = SAMPLEBUF(VbnADC, BufferIndex);
         break;
       case USR_TYPE_VCNADC:
-        UserSamples.TwelveCyc[UserWFind] = SampleBuf[BufferIndex].VcnADC;
+        UserSamples.TwelveCyc[UserWFind] = SAMPLEBUF(VcnADC, BufferIndex);
         break;
     }
     ++UserWFind;
@@ -108,6 +108,16 @@
 //                        Structure size did not change.  Two spare bytes were repurposed for additional
 //                        phase cal constants
 //   148    240131  BP  - Added Aux Power scaliing and threshold      
+//   158    240210  DAH - Added structure VOLTAGES_I
+//   159    240211  DAH - Added AFE_FRAME_WORDS and AFE_BLOCK_MAX
+//   160    240212  DAH - Added struct AFE_CAL_COEF and struct ADC_CAL_COEF
+//   174    240226  DAH - Added struct ONECYC_MAX_PWR
+//   175    240227  DAH - Added ONECYC_PHASOR_NUM
+//                      - Added I_NegUnbal and V_NegUnbal to struct SEQ_COMP
+//   176    240228  DAH - Added the zero-crossing frequency tracker constants (FREQTRK_xx) and struct
+//                        FREQ_TRACK_VARS
+//   179    240302  DAH - struct AFE_CAL_COEF and struct ADC_CAL_COEF comment revised (ENABLE_CAL_BIAS)
+//                      - Deleted struct ONECYC_MAX_PWR
 //------------------------------------------------------------------------------------------------------------
 //
 //------------------------------------------------------------------------------------------------------------
@@ -142,6 +152,35 @@
 
 #define SCALE_FACTOR_b0         7.845909572784E-2f              // 1/b0 is the 60Hz gain of the dig filter
 //#define SCALE_FACTOR_b0         7.87017068246188E-2               // 1/b0 is the 60Hz gain of the dig filter  For test injection
+
+// AFE block processing (AFE_Process_Block()).  Each AFE DMA frame is AFE_FRAME_WORDS words (two per channel),
+//   and up to AFE_BLOCK_MAX frames may be processed in one call
+#define AFE_FRAME_WORDS         16
+#define AFE_BLOCK_MAX           8
+
+// One-cycle fundamental sine and cosine sums (only if ENABLE_SEQ_PHASOR is defined).  The sums are kept in
+//   the order Ia, Ib, Ic, In, VanAFE, VbnAFE, VcnAFE, VanADC, VbnADC, VcnADC
+#define ONECYC_PHASOR_NUM       10
+
+// Zero-crossing frequency tracker (only if ENABLE_FREQ_TRACK is defined).  A positive-going crossing of
+//   VanAFE is only used after Van has been below -FREQTRK_ARM_V.  The frequency is invalid if there has been
+//   no crossing for FREQTRK_MAX_SAMPLES samples, or if it is outside FREQTRK_MIN_HZ .. FREQTRK_MAX_HZ.  The
+//   frequency is smoothed with a first-order filter (gain FREQTRK_ALPHA per cycle), and the ROCOF is computed
+//   from the smoothed frequencies of the last FREQTRK_ROCOF_NUM one-cycle anniversaries.
+//   If ENABLE_FREQ_RETUNE is also defined, the sample rate is retuned to 80 samples per cycle whenever the
+//   frequency, clamped to FREQTRK_TUNE_MIN_HZ .. FREQTRK_TUNE_MAX_HZ, moves more than FREQTRK_TUNE_HYST from
+//   the tuned frequency.  The sample rate starts at 80 x FREQTRK_NOM_HZ (see AFE_Init() and Init_TIM3())
+#define FREQTRK_ARM_V           10.0f
+#define FREQTRK_MAX_SAMPLES     240
+#define FREQTRK_MIN_HZ          40.0f
+#define FREQTRK_MAX_HZ          70.0f
+#define FREQTRK_ALPHA           0.25f
+#define FREQTRK_ROCOF_NUM       6
+#define FREQTRK_NOM_HZ          60.0f
+#define FREQTRK_TUNE_MIN_HZ     45.0f
+#define FREQTRK_TUNE_MAX_HZ     65.0f
+#define FREQTRK_TUNE_HYST       0.05f
+
 // Default calibration constants for AFE samples
 //#define AFE_CAL_DEFAULT_IGAIN  2.8786248E-7                   // For on-board DC voltages
 //#define AFE_CAL_DEFAULT_IOFFSET 89.71234E-6
@@ -420,6 +459,16 @@ struct CUR_WITH_G_I                     // Structure for currents, including gro
   unsigned long long Igres;
 };
 
+struct VOLTAGES_I                       // Structure for line-to-neutral and line-to-line voltages in tenths
+{                                       //   (squared)
+  unsigned long long Van;
+  unsigned long long Vbn;
+  unsigned long long Vcn;
+  unsigned long long Vab;
+  unsigned long long Vbc;
+  unsigned long long Vca;
+};
+
 struct CUR_WITHOUT_G_F                  // Structure for currents, not including ground currents
 {
   float Ia;                         
@@ -477,6 +526,8 @@ struct SEQ_COMP
     float V_PosPh;
     float V_NegMag;
     float V_NegPh;
+    float I_NegUnbal;                   // Negative-sequence current unbalance (I2/I1 in percent)
+    float V_NegUnbal;                   // Negative-sequence voltage unbalance (V2/V1 in percent)
 };
 
 
@@ -591,6 +642,23 @@ struct ADC_CAL
   uint32_t cmp;
 };
 
+// Applied calibration coefficients (only used if ENABLE_CAL_BIAS is defined).  These are computed from the
+//   cal constants (struct AFE_CAL and struct ADC_CAL) by Apply_CalConstants(), so that a sample is scaled
+//   with one multiply and add, x * gain + bias, and the integrator seed is computed without a divide.  The
+//   indices are the same as in the cal structures
+struct AFE_CAL_COEF
+{
+  float gain[10];                       // Gain (same as struct AFE_CAL)
+  float bias[10];                       // Bias: -offset * gain
+  float rgain[10];                      // Reciprocal of the gain (0 if the gain is 0 or invalid)
+};
+
+struct ADC_CAL_COEF
+{
+  float gain[8];                        // Gain (same as struct ADC_CAL)
+  float bias[8];                        // Bias: -offset * gain
+};
+
 struct ENERGY_FLOATS
 {
   float FwdWHr;
@@ -638,6 +706,32 @@ struct FREQ_MEASURE_VARS                            // Frequency measurement var
   uint8_t               Dump_Count;
 };
 
+struct FREQ_TRACK_VARS                              // Zero-crossing frequency tracker variables
+{
+  float                 FreqVal;                    // Smoothed frequency (Hz), NAN if invalid
+  float                 Rocof;                      // Rate of change of frequency (Hz/sec), NAN if invalid
+  float                 SampleRate;                 // Present sample rate (samples/sec)
+  float                 SamplePer;                  // Present sample period (sec)
+  float                 TuneFreq;                   // Frequency the sample rate is tuned to (Hz)
+  float                 TuneRate;                   // Requested sample rate (samples/sec)
+  float                 VanPrev;                    // Previous VanAFE sample
+  float                 PerTime;                    // Time (sec) from the last crossing to the last sample
+  float                 PerSum;                     // Sum of the periods (sec) since the last read
+  float                 PendTime;                   // Time (sec) since the last history entry
+  float                 HistFreq[FREQTRK_ROCOF_NUM];  // Smoothed frequencies of the last anniversaries
+  float                 HistTime[FREQTRK_ROCOF_NUM];  // Duration (sec) of the last anniversaries
+  uint16_t              SampCtr;                    // Samples since the last crossing
+  uint16_t              TuneARR;                    // Requested TIM3 autoreload value
+  uint16_t              TuneDecN;                   // Requested AFE decimation rate, integer part
+  uint16_t              TuneDecIF;                  // Requested AFE decimation rate, fraction (x 65536)
+  uint8_t               PerCnt;                     // Number of periods in PerSum
+  uint8_t               Start;                      // TRUE if the next crossing only starts a period
+  uint8_t               Armed;                      // TRUE if Van has been below -FREQTRK_ARM_V
+  uint8_t               HistNdx;
+  uint8_t               HistCnt;
+  uint8_t               TuneReq;                    // TRUE if the sampling interrupt must load the new rate
+};
+
 struct THD_MIN_MAX
 {
    float THDmin;
@@ -203,6 +203,24 @@
 //   94     231010  DAH - Added struct USER_WF_CAPTURE UserWF, UserSamples, and CaptureUserWaveform()
 //   117    231129  DAH - Deleted Read_ThermMem()
 //   148    240131  BP  - Added AuxPower_Monitoring()
+//   153    240205  DAH - Replaced the IAR location operator (@".sram1", @".sram2") with SRAM1_LOC and
+//                        SRAM2_LOC so the module can be compiled in the host build
+//   154    240206  DAH - Corrected the size of INT_a1[] from 4 to 5 to match the definition in Meter.c
+//   156    240208  DAH - Added Harm_FoldCycles(), Harm_BinsMag(), and Harm_Group()
+//                      - Added x_n[] and Harm_FFTMag() for the host build
+//   159    240211  DAH - Added AFE_Process_Block(), AFE_Process_Chan(), ss[], MTR_ss[], and AFE_PrevSample[]
+//   160    240212  DAH - Added Apply_CalConstants(), AFEcoef, ADCcoefHigh, and ADCcoefLow
+//   162    240214  DAH - Added CH_State declaration to support the loop tracer
+//   174    240226  DAH - Added OneCycMaxPwr, Calc_OneCyc_Kernel(), and Calc_OneCyc_MaxPwr()
+//                        (ENABLE_ONECYC_KERNEL defined)
+//                      - Added CF_Sum (used by the host replay one-cycle kernel benchmark)
+//   175    240227  DAH - Added CurVolOneCycSin_Sav[] and CurVolOneCycCos_Sav[] (ENABLE_SEQ_PHASOR defined)
+//                      - Added Calc_SeqComp_Phasors()
+//   176    240228  DAH - Added FreqTrack and Calc_FreqTrack() (ENABLE_FREQ_TRACK defined)
+//   179    240302  DAH - Harm_FoldCycles(), Harm_BinsMag(), and Harm_Group() only declared if
+//                        ENABLE_HARM_FOLD is defined or in the host build
+//                      - AFEcoef, ADCcoefHigh, and ADCcoefLow only declared if ENABLE_CAL_BIAS is defined
+//                      - Deleted OneCycMaxPwr, Calc_OneCyc_Kernel(), and Calc_OneCyc_MaxPwr()
 //------------------------------------------------------------------------------------------------------------
 //
 //------------------------------------------------------------------------------------------------------------
@@ -229,6 +247,10 @@ extern struct CUR_WITH_G_F              Cur200msFltrSOS_Sav;
 extern struct CUR_WITHOUT_G_F           Cur200msNoFltrSOS_Sav;
 extern float                            CurVol200msNoFltrSinSOS_Sav[7];
 extern float                            CurVol200msNoFltrCosSOS_Sav[7];
+#ifdef ENABLE_SEQ_PHASOR
+  extern float                          CurVolOneCycSin_Sav[ONECYC_PHASOR_NUM];
+  extern float                          CurVolOneCycCos_Sav[ONECYC_PHASOR_NUM];
+#endif
 extern struct CUR_WITH_G_F              CurOneCyc;
 extern struct CUR_WITH_G_F              Cur200msFltr;
 extern struct MIN_MAX_CUR_WITH_G_F      CurOneCyc_max;
@@ -300,14 +322,26 @@ extern uint32_t ADC_test_samples[5];            // DEBUG - BP
 extern float ADC_samples[10];
 
 extern uint8_t HarmReq, HarmFrozen;
+extern uint8_t CH_State;
 extern struct HARMONICS_I_STRUCT HarmonicsAgg, HarmonicsCap;
+#ifdef HOST_BUILD
+  extern float x_n[];                   // Harmonics samples, used by the host build comparison
+#endif
 
-extern struct AFE_CAL AFEcal @".sram2";
+extern struct AFE_CAL AFEcal SRAM2_LOC;
 extern struct ADC_CAL ADCcalHigh;
 extern struct ADC_CAL ADCcalLow;
+#ifdef ENABLE_CAL_BIAS
+  extern struct AFE_CAL_COEF AFEcoef SRAM2_LOC;
+  extern struct ADC_CAL_COEF ADCcoefHigh;
+  extern struct ADC_CAL_COEF ADCcoefLow;
+#endif
 
 extern uint8_t UseADCvals;
-extern float INT_a1[4];
+extern float INT_a1[5];
+extern float ss[5] SRAM2_LOC;
+extern float MTR_ss[8] SRAM2_LOC;
+extern float AFE_PrevSample[5] SRAM2_LOC;
 
 extern float Cur200msFltrIg;
 extern float Cur200msIavg;
@@ -323,11 +357,15 @@ extern float THD[10];
 extern struct THD_MIN_MAX THDminmax[10];
 extern struct K_FACTORS KF_Val;
 extern struct CUR_WITHOUT_G_F CF;
+extern struct CUR_WITHOUT_G_F CF_Sum;
 extern float PhAngles1[9];
 extern float PhAngles2[6];
 extern struct SEQ_COMP SeqComp;
 
 extern struct FREQ_MEASURE_VARS FreqLoad, FreqLine;
+#ifdef ENABLE_FREQ_TRACK
+  extern struct FREQ_TRACK_VARS FreqTrack;
+#endif
 
 extern uint32_t StatusCode;
 extern union WORD_BITS TU_BinStatus;
@@ -355,6 +393,10 @@ extern float ThermMemReading;         // *** BP Added for test
 //
 extern void Meter_VarInit(void);
 extern void AFE_Process_Samples(void);
+extern uint8_t AFE_Process_Block(const uint16_t *frames, uint8_t num, float (*afe_out)[8],
+                                 float (*mtr_out)[8]);
+extern void AFE_Process_Chan(void);
+extern void Apply_CalConstants(void);
 extern void Calc_Meter_Current(void);
 extern void Calc_Prot_Current(void);
 extern void Calc_Meter_AFE_Voltage(void);
@@ -376,10 +418,22 @@ extern void Calc_ADC_200ms_Voltage(void);
 extern void Calc_ADC_OneCyc_Voltage(void);
 
 extern void Calc_Harmonics(void);
+#if defined(ENABLE_HARM_FOLD) || defined(HOST_BUILD)
+  extern void Harm_FoldCycles(void);
+  extern void Harm_BinsMag(float *mag, uint8_t first, uint8_t last, uint8_t curr);
+  extern void Harm_Group(float *mag, uint16_t *instptr, uint8_t curr);
+#endif
+#ifdef HOST_BUILD
+  extern void Harm_FFTMag(float *mag);
+#endif
 extern void ManageSPI1Flags(void);
 extern float TP_CoilTempRMSavg(void);
 extern void Calc_SeqComp_PhAng(void);
+extern void Calc_SeqComp_Phasors(const float *re_ptr, const float *im_ptr);
 extern void Calc_Freq(struct FREQ_MEASURE_VARS *f_ptr, float v_xn);
+#ifdef ENABLE_FREQ_TRACK
+  extern void Calc_FreqTrack(void);
+#endif
 extern void SnapshotMeter(uint16_t SummaryCode);
 extern void ExtCapSnapshotMeterOneCyc(void);
 extern void ExtCapSnapshotMeterTwoHundred(void);
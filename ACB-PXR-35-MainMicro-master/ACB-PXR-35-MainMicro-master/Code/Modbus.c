@@ -141,6 +141,32 @@
 //                      - Fixed faddr calculation for Groups 10, 12, and new Group 13
 //                      - Tweaked Maintenance Mode handling to match other occurrences
 //   149    240131  DAH - Modified Modb_Save_Setpoints() to add event insertion
+//   153    240205  DAH - Replaced the IAR location operator (@".sram1", @".sram2") with SRAM1_LOC and
+//                        SRAM2_LOC so the module can be compiled in the host build
+//   155    240207  DAH - Added Group 73 (registers 50688 - 50799) to read the stage profiler statistics.
+//                        The group is only included if ENABLE_STAGE_PROFILER is defined
+//                          - Added MODB_OBJECT_ADDR_GR73[] and MODB_OBJECT_CONV_GR73[]
+//                          - ProcFC0304Msg() revised
+//                          - Added includes of Profile_def.h and Profile_ext.h
+//   162    240214  DAH - Added Group 74 (registers 50816 - 50999) to read the main loop trace.  The group is
+//                        only included if ENABLE_LOOP_TRACE is defined
+//                          - Added MODB_OBJECT_ADDR_GR74[] and MODB_OBJECT_CONV_GR74[]
+//                          - ProcFC0304Msg() revised
+//                          - Added includes of Trace_def.h and Trace_ext.h
+//   169    240221  DAH - CalcCRC() revised to call Crc16_Block() if ENABLE_CRC_SLICE is defined
+//                          - Added includes of Crc_def.h and Crc_ext.h
+//   171    240223  DAH - Added a register address page index and a block encoder for the 32-bit real-time
+//                        data objects.  These are only included if ENABLE_MODB_REG_INDEX is defined
+//                          - Added Modb_BuildRegIndex(), Modb_StoreObjBlock(), ModbGroupPage[], and
+//                            MODB_FMT32[]
+//                          - Modb_VarInit(), Modb_CheckRegAddress(), ProcFC0304Msg() revised
+//                          - Added include of string.h
+//   172    240224  DAH - Added the double-buffered real-time data cache.  This is only included if
+//                        ENABLE_MODB_RTD_CACHE is defined
+//                          - Added Modb_RtdCacheRefresh(), Modb_RtdCacheGet(), ModbRtdc, and
+//                            MODB_RTDC_TABLE[]
+//                          - Added nak_invalid to Modb_StoreObjBlock()
+//                          - ProcFC0304Msg() revised
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -167,6 +193,7 @@
 //
 #include "stm32f4xx.h"
 #include "stm32f407xx.h"
+#include "string.h"
 #include "RealTime_def.h"
 #include "Modbus_def.h"
 #include "Meter_def.h"
@@ -177,6 +204,9 @@
 #include "Flags_def.h"
 #include "Intr_def.h"
 #include "Events_def.h"
+#include "Profile_def.h"
+#include "Trace_def.h"
+#include "Crc_def.h"
 
 
 
@@ -209,6 +239,14 @@ uint16_t ModB_CurSetGrp;
 #include "Setpnt_ext.h"
 #include "Intr_ext.h"
 #include "Events_ext.h"
+#include "Profile_ext.h"
+#include "Trace_ext.h"
+#include "Crc_ext.h"
+
+// The real-time data cache is read from the block read path, which is only used with the page index
+#if defined(ENABLE_MODB_RTD_CACHE) && !defined(ENABLE_MODB_REG_INDEX)
+  #error ENABLE_MODB_RTD_CACHE requires ENABLE_MODB_REG_INDEX
+#endif
 
 
 
@@ -216,6 +254,9 @@ uint16_t ModB_CurSetGrp;
 //
 void Modb_VarInit(uint8_t init_all);
 void ModB_SlaveComm(void);
+#ifdef ENABLE_MODB_RTD_CACHE
+  void Modb_RtdCacheRefresh(void);
+#endif
 
 
 
@@ -229,6 +270,15 @@ void ProcFC16Msg(uint8_t length);
 void Modb_CheckRegAddress(uint8_t *group, uint16_t *offset, uint8_t *num_bad, uint8_t *num_to_add,
                                     uint16_t start_start_reg_add, uint8_t num_reg);
 void Modb_FormatStoreVal(uint8_t format_code, void *val_in, uint8_t *val_out);
+#ifdef ENABLE_MODB_REG_INDEX
+  void Modb_BuildRegIndex(void);
+  uint8_t Modb_StoreObjBlock(uint8_t const *cc_ptr, void * const *objaddr_ptr, uint8_t conv_add, uint8_t num,
+                                    uint8_t nak_invalid, uint8_t *val_out);
+#endif
+#ifdef ENABLE_MODB_RTD_CACHE
+  uint8_t Modb_RtdCacheGet(void * const *objaddr_ptr, uint16_t offset, uint8_t conv_add, uint8_t num,
+                                    uint8_t *val_out);
+#endif
 uint16_t CalcCRC(uint8_t *msg_ptr, uint16_t len);
 void Modb_Save_Setpoints(uint8_t CurSetpSet, uint8_t SetpGrpNum);
 uint8_t Modb_Remote_Control(uint8_t control_group, uint16_t sub_code);
@@ -241,7 +291,7 @@ uint8_t Modb_Remote_Control(uint8_t control_group, uint16_t sub_code);
 //
 //       These variables are used by other modules...
 //
-struct MODB_PORT ModB @".sram2";
+struct MODB_PORT ModB SRAM2_LOC;
 
 
 
@@ -262,6 +312,9 @@ struct MODB_PORT ModB @".sram2";
 //
 float mb_reg_not_supported;
 uint16_t MB_Harmonics_Selection;
+#ifdef ENABLE_MODB_REG_INDEX
+  uint8_t ModbGroupPage[MODB_NUM_PAGES];      // Index of the first address group that ends in or after each
+#endif                                        //   page of MODB_PAGE_SIZE registers
 
 
 //
@@ -403,6 +456,11 @@ uint16_t MB_Harmonics_Selection;
 // 49684 - 49691    xC214 - xC21B     70        Fixed point 64-bit energy values (WHr, Varhr)
 // 50432 - 50579    xC500 - xC593     71        Fixed point real-time data set 24 - aligns with Group 53
 // 50580 - 50651    xC594 - xC5DB     72        Fixed point real-time data set 25 - aligns with Group 54
+// 50688 - 50799    xC600 - xC66F     73        Stage profiler statistics (only if ENABLE_STAGE_PROFILER
+//                                                is defined in Iod_def.h)
+// 50816 - 50999    xC680 - xC737     74        Main loop trace (only if ENABLE_LOOP_TRACE is defined in
+//                                                Iod_def.h).  If ENABLE_STAGE_PROFILER is not defined, this
+//                                                is Group 73
 
 
 
@@ -415,6 +473,12 @@ const uint16_t MODB_GROUP_START_ADD[] =
   7382,  7422,  7462,  7502,  8192,  20480, 20736, 24576, 24628, 24680, 24708, 24760, 24782, 24808, 24848,
   24876, 24910, 24962, 25002, 25042, 25052, 25088, 25344, 25856, 26004, 49152, 49204, 49256, 49284, 49336,
   49358, 49384, 49424, 49452, 49486, 49538, 49578, 49618, 49628, 49680, 49684, 50432, 50580
+#ifdef ENABLE_STAGE_PROFILER
+  , 50688
+#endif
+#ifdef ENABLE_LOOP_TRACE
+  , 50816
+#endif
 };
 
 const uint16_t MODB_GROUP_END_ADD[] =
@@ -424,6 +488,12 @@ const uint16_t MODB_GROUP_END_ADD[] =
   7421,  7461,  7501,  7541,  9660,  20679, 21535, 24627, 24679, 24707, 24759, 24781, 24807, 24847, 24875,
   24909, 24961, 25001, 25041, 25051, 25061, 25091, 25346, 26003, 26075, 49203, 49255, 49283, 49335, 49357,
   49383, 49423, 49451, 49485, 49537, 49577, 49617, 49627, 49637, 49683, 49691, 50579, 50651
+#ifdef ENABLE_STAGE_PROFILER
+  , 50799
+#endif
+#ifdef ENABLE_LOOP_TRACE
+  , 50999
+#endif
 };
 
 const uint8_t MODB_NUM_REGS_PER_DATA_OBJECT[] =
@@ -433,10 +503,58 @@ const uint8_t MODB_NUM_REGS_PER_DATA_OBJECT[] =
      6,     6,     6,     6,     2,     2,     2,     6,     6,     6,     6,     6,     2,     6,     6,
      6,     6,     6,     6,     6,     6,     2,     2,     6,     2,     6,     6,     6,     6,     6,
      2,     6,     6,     6,     6,     6,     6,     6,     6,     2,     4,     6,     2
+#ifdef ENABLE_STAGE_PROFILER
+  ,  2
+#endif
+#ifdef ENABLE_LOOP_TRACE
+  ,  2
+#endif
 };
 
 #define MODB_NUM_GROUPS (sizeof(MODB_GROUP_END_ADD)/2)
 
+#ifdef ENABLE_MODB_REG_INDEX
+// Modbus 32-bit Format Descriptor Table
+//   This table is indexed by the format (conversion) code, and gives the encoder for each of the codes
+//   that are used in the groups with two registers per object.  It is used by Modb_StoreObjBlock(), and
+//   must match the conversions in Modb_FormatStoreVal().  Codes without an entry, and codes 99 and 119
+//   (beyond the end of the table), are invalid registers that are filled with zeros.
+//   Note, the word order setpoint for codes 6 and 20 - 30 is the floating point word order, to match
+//   Modb_FormatStoreVal()
+const struct MODB_FMT32_DESC MODB_FMT32[MODB_NUM_FMT32] =
+{ //  Encoder         Float order   Scale                  Code
+  { MODB_ENC_F_U32,     FALSE,       1.0F },                // 0: float --> U32
+  { MODB_ENC_F_U32,     FALSE,      10.0F },                // 1: float * 10 --> U32
+  { MODB_ENC_F_U32,     FALSE,     100.0F },                // 2: float * 100 --> U32
+  { MODB_ENC_F_S32,     FALSE,       1.0F },                // 3: float --> S32
+  { MODB_ENC_F_S32,     FALSE,      10.0F },                // 4: float * 10 --> S32
+  { MODB_ENC_F_S32,     FALSE,     100.0F },                // 5: float * 100 --> S32
+  { MODB_ENC_U32,       TRUE,        1.0F },                // 6: U32 --> U32
+  { MODB_ENC_ZERO,      FALSE,       1.0F },  { MODB_ENC_ZERO, FALSE, 1.0F },       // 7, 8: not used
+  { MODB_ENC_ZERO,      FALSE,       1.0F },  { MODB_ENC_ZERO, FALSE, 1.0F },       // 9, 10: not used
+  { MODB_ENC_ZERO,      FALSE,       1.0F },  { MODB_ENC_ZERO, FALSE, 1.0F },       // 11, 12: not used
+  { MODB_ENC_ZERO,      FALSE,       1.0F },  { MODB_ENC_ZERO, FALSE, 1.0F },       // 13, 14: not used
+  { MODB_ENC_ZERO,      FALSE,       1.0F },  { MODB_ENC_ZERO, FALSE, 1.0F },       // 15, 16: not used
+  { MODB_ENC_ZERO,      FALSE,       1.0F },  { MODB_ENC_ZERO, FALSE, 1.0F },       // 17, 18: not used
+  { MODB_ENC_ZERO,      FALSE,       1.0F },                // 19: not used
+  { MODB_ENC_F_POS,     TRUE,        1.0F },                // 20: float --> float positive
+  { MODB_ENC_F_POS,     TRUE,        1.0F },                // 21: float --> float positive
+  { MODB_ENC_F_POS,     TRUE,        1.0F },                // 22: float --> float positive
+  { MODB_ENC_FLOAT,     TRUE,        1.0F },                // 23: float --> float
+  { MODB_ENC_FLOAT,     TRUE,        1.0F },                // 24: float --> float
+  { MODB_ENC_FLOAT,     TRUE,        1.0F },                // 25: float --> float
+  { MODB_ENC_U32,       TRUE,        1.0F },                // 26: U32 --> U32
+  { MODB_ENC_ZERO,      TRUE,        1.0F },  { MODB_ENC_ZERO, TRUE,  1.0F },       // 27, 28: not used
+  { MODB_ENC_ZERO,      TRUE,        1.0F },  { MODB_ENC_ZERO, TRUE,  1.0F },       // 29, 30: not used
+  { MODB_ENC_ZERO,      FALSE,       1.0F },  { MODB_ENC_ZERO, FALSE, 1.0F },       // 31, 32: not used
+  { MODB_ENC_ZERO,      FALSE,       1.0F },  { MODB_ENC_ZERO, FALSE, 1.0F },       // 33, 34: not used
+  { MODB_ENC_U64_K,     FALSE,       1.0F },                // 35: U64/1000 --> U32
+  { MODB_ENC_S64_K,     FALSE,       1.0F },                // 36: S64/1000 --> S32
+  { MODB_ENC_ZERO,      FALSE,       1.0F },  { MODB_ENC_ZERO, FALSE, 1.0F },       // 37, 38: not used
+  { MODB_ENC_ZERO,      FALSE,       1.0F }                 // 39: not used
+};
+#endif
+
 // Modbus Real Time Data Objects set 1 Data Address Table
 //   This handles both Group 10 and Group 21 above
 void * const MODB_OBJECT_ADDR_GR10[] =
@@ -1402,6 +1520,216 @@ const uint8_t MODB_OBJECT_CONV_GR70[] =
 
 
 
+#ifdef ENABLE_STAGE_PROFILER
+// Modbus Stage Profiler Statistics Data Address Table
+//   This handles Group 73 above.  There are four objects per stage (in core clock cycles, except Count)
+void * const MODB_OBJECT_ADDR_GR73[] =
+{                                                           // Modbus Address (hex)
+  &ProfStage[PROF_ISR_TOTAL].Count,                         // C600: ISR total Count
+  &ProfStage[PROF_ISR_TOTAL].Min,                           // C602: ISR total Min
+  &ProfStage[PROF_ISR_TOTAL].Max,                           // C604: ISR total Max
+  &ProfStage[PROF_ISR_TOTAL].Last,                          // C606: ISR total Last
+  &ProfStage[PROF_ISR_MISC].Count,                          // C608: ISR misc Count
+  &ProfStage[PROF_ISR_MISC].Min,                            // C60A: ISR misc Min
+  &ProfStage[PROF_ISR_MISC].Max,                            // C60C: ISR misc Max
+  &ProfStage[PROF_ISR_MISC].Last,                           // C60E: ISR misc Last
+  &ProfStage[PROF_ISR_AFE].Count,                           // C610: ISR AFE Count
+  &ProfStage[PROF_ISR_AFE].Min,                             // C612: ISR AFE Min
+  &ProfStage[PROF_ISR_AFE].Max,                             // C614: ISR AFE Max
+  &ProfStage[PROF_ISR_AFE].Last,                            // C616: ISR AFE Last
+  &ProfStage[PROF_ISR_BUFFER].Count,                        // C618: ISR buffer Count
+  &ProfStage[PROF_ISR_BUFFER].Min,                          // C61A: ISR buffer Min
+  &ProfStage[PROF_ISR_BUFFER].Max,                          // C61C: ISR buffer Max
+  &ProfStage[PROF_ISR_BUFFER].Last,                         // C61E: ISR buffer Last
+  &ProfStage[PROF_ISR_SOS].Count,                           // C620: ISR SOS Count
+  &ProfStage[PROF_ISR_SOS].Min,                             // C622: ISR SOS Min
+  &ProfStage[PROF_ISR_SOS].Max,                             // C624: ISR SOS Max
+  &ProfStage[PROF_ISR_SOS].Last,                            // C626: ISR SOS Last
+  &ProfStage[PROF_ISR_PROT].Count,                          // C628: ISR prot Count
+  &ProfStage[PROF_ISR_PROT].Min,                            // C62A: ISR prot Min
+  &ProfStage[PROF_ISR_PROT].Max,                            // C62C: ISR prot Max
+  &ProfStage[PROF_ISR_PROT].Last,                           // C62E: ISR prot Last
+  &ProfStage[PROF_ISR_61850].Count,                         // C630: ISR 61850 Count
+  &ProfStage[PROF_ISR_61850].Min,                           // C632: ISR 61850 Min
+  &ProfStage[PROF_ISR_61850].Max,                           // C634: ISR 61850 Max
+  &ProfStage[PROF_ISR_61850].Last,                          // C636: ISR 61850 Last
+  &ProfStage[PROF_MAIN_ONECYC_CALC].Count,                  // C638: 1cyc calc Count
+  &ProfStage[PROF_MAIN_ONECYC_CALC].Min,                    // C63A: 1cyc calc Min
+  &ProfStage[PROF_MAIN_ONECYC_CALC].Max,                    // C63C: 1cyc calc Max
+  &ProfStage[PROF_MAIN_ONECYC_CALC].Last,                   // C63E: 1cyc calc Last
+  &ProfStage[PROF_MAIN_ONECYC_PROT].Count,                  // C640: 1cyc prot Count
+  &ProfStage[PROF_MAIN_ONECYC_PROT].Min,                    // C642: 1cyc prot Min
+  &ProfStage[PROF_MAIN_ONECYC_PROT].Max,                    // C644: 1cyc prot Max
+  &ProfStage[PROF_MAIN_ONECYC_PROT].Last,                   // C646: 1cyc prot Last
+  &ProfStage[PROF_MAIN_ONECYC_ALARM].Count,                 // C648: 1cyc alarm Count
+  &ProfStage[PROF_MAIN_ONECYC_ALARM].Min,                   // C64A: 1cyc alarm Min
+  &ProfStage[PROF_MAIN_ONECYC_ALARM].Max,                   // C64C: 1cyc alarm Max
+  &ProfStage[PROF_MAIN_ONECYC_ALARM].Last,                  // C64E: 1cyc alarm Last
+  &ProfStage[PROF_MAIN_200MSEC].Count,                      // C650: 200msec Count
+  &ProfStage[PROF_MAIN_200MSEC].Min,                        // C652: 200msec Min
+  &ProfStage[PROF_MAIN_200MSEC].Max,                        // C654: 200msec Max
+  &ProfStage[PROF_MAIN_200MSEC].Last,                       // C656: 200msec Last
+  &ProfStage[PROF_MAIN_1SEC].Count,                         // C658: 1sec Count
+  &ProfStage[PROF_MAIN_1SEC].Min,                           // C65A: 1sec Min
+  &ProfStage[PROF_MAIN_1SEC].Max,                           // C65C: 1sec Max
+  &ProfStage[PROF_MAIN_1SEC].Last,                          // C65E: 1sec Last
+  &ProfStage[PROF_MAIN_5MIN].Count,                         // C660: 5min Count
+  &ProfStage[PROF_MAIN_5MIN].Min,                           // C662: 5min Min
+  &ProfStage[PROF_MAIN_5MIN].Max,                           // C664: 5min Max
+  &ProfStage[PROF_MAIN_5MIN].Last,                          // C666: 5min Last
+  &ProfStage[PROF_MAIN_LOOP].Count,                         // C668: Main loop Count
+  &ProfStage[PROF_MAIN_LOOP].Min,                           // C66A: Main loop Min
+  &ProfStage[PROF_MAIN_LOOP].Max,                           // C66C: Main loop Max
+  &ProfStage[PROF_MAIN_LOOP].Last                           // C66E: Main loop Last
+};
+
+// Modbus Stage Profiler Statistics Conversion Type Table
+//   This handles Group 73 above.  All objects are U32
+const uint8_t MODB_OBJECT_CONV_GR73[] =
+{                                                           // Modbus Fixed Addr (hex)
+  6, 6, 6, 6,                                               // C600-C606: ISR total
+  6, 6, 6, 6,                                               // C608-C60E: ISR misc
+  6, 6, 6, 6,                                               // C610-C616: ISR AFE
+  6, 6, 6, 6,                                               // C618-C61E: ISR buffer
+  6, 6, 6, 6,                                               // C620-C626: ISR SOS
+  6, 6, 6, 6,                                               // C628-C62E: ISR prot
+  6, 6, 6, 6,                                               // C630-C636: ISR 61850
+  6, 6, 6, 6,                                               // C638-C63E: 1cyc calc
+  6, 6, 6, 6,                                               // C640-C646: 1cyc prot
+  6, 6, 6, 6,                                               // C648-C64E: 1cyc alarm
+  6, 6, 6, 6,                                               // C650-C656: 200msec
+  6, 6, 6, 6,                                               // C658-C65E: 1sec
+  6, 6, 6, 6,                                               // C660-C666: 5min
+  6, 6, 6, 6                                                // C668-C66E: Main loop
+};
+#endif
+
+
+#ifdef ENABLE_LOOP_TRACE
+// Modbus Main Loop Trace Data Address Table
+//   This handles Group 74 above.  There are four objects per block (in core clock cycles, except Count),
+//   followed by the longest pass (see struct TRACE_REC) and the longest pass for each combination of state
+//   machines
+void * const MODB_OBJECT_ADDR_GR74[] =
+{                                                           // Modbus Address (hex)
+  &TraceBlock[TRACE_LOOP].Count,                            // C680: Main loop Count
+  &TraceBlock[TRACE_LOOP].P50,                              // C682: Main loop P50
+  &TraceBlock[TRACE_LOOP].P99,                              // C684: Main loop P99
+  &TraceBlock[TRACE_LOOP].Max,                              // C686: Main loop Max
+  &TraceBlock[TRACE_ONECYC].Count,                          // C688: 1cyc Count
+  &TraceBlock[TRACE_ONECYC].P50,                            // C68A: 1cyc P50
+  &TraceBlock[TRACE_ONECYC].P99,                            // C68C: 1cyc P99
+  &TraceBlock[TRACE_ONECYC].Max,                            // C68E: 1cyc Max
+  &TraceBlock[TRACE_200MSEC].Count,                         // C690: 200msec Count
+  &TraceBlock[TRACE_200MSEC].P50,                           // C692: 200msec P50
+  &TraceBlock[TRACE_200MSEC].P99,                           // C694: 200msec P99
+  &TraceBlock[TRACE_200MSEC].Max,                           // C696: 200msec Max
+  &TraceBlock[TRACE_1SEC].Count,                            // C698: 1sec Count
+  &TraceBlock[TRACE_1SEC].P50,                              // C69A: 1sec P50
+  &TraceBlock[TRACE_1SEC].P99,                              // C69C: 1sec P99
+  &TraceBlock[TRACE_1SEC].Max,                              // C69E: 1sec Max
+  &TraceBlock[TRACE_5MIN].Count,                            // C6A0: 5min Count
+  &TraceBlock[TRACE_5MIN].P50,                              // C6A2: 5min P50
+  &TraceBlock[TRACE_5MIN].P99,                              // C6A4: 5min P99
+  &TraceBlock[TRACE_5MIN].Max,                              // C6A6: 5min Max
+  &TraceBlock[TRACE_BKGND].Count,                           // C6A8: Background Count
+  &TraceBlock[TRACE_BKGND].P50,                             // C6AA: Background P50
+  &TraceBlock[TRACE_BKGND].P99,                             // C6AC: Background P99
+  &TraceBlock[TRACE_BKGND].Max,                             // C6AE: Background Max
+  &TraceWorst.StartCyc,                                     // C6B0: Worst pass StartCyc
+  &TraceWorst.Cycles,                                       // C6B2: Worst pass Cycles
+  &TraceWorst.Flags,                                        // C6B4: Worst pass Flags
+  &TraceWorst.Pass,                                         // C6B6: Worst pass Pass
+  &TraceComboMax[0],                                        // C6B8: State machine combination 00 Max
+  &TraceComboMax[1],                                        // C6BA: State machine combination 01 Max
+  &TraceComboMax[2],                                        // C6BC: State machine combination 02 Max
+  &TraceComboMax[3],                                        // C6BE: State machine combination 03 Max
+  &TraceComboMax[4],                                        // C6C0: State machine combination 04 Max
+  &TraceComboMax[5],                                        // C6C2: State machine combination 05 Max
+  &TraceComboMax[6],                                        // C6C4: State machine combination 06 Max
+  &TraceComboMax[7],                                        // C6C6: State machine combination 07 Max
+  &TraceComboMax[8],                                        // C6C8: State machine combination 08 Max
+  &TraceComboMax[9],                                        // C6CA: State machine combination 09 Max
+  &TraceComboMax[10],                                       // C6CC: State machine combination 0A Max
+  &TraceComboMax[11],                                       // C6CE: State machine combination 0B Max
+  &TraceComboMax[12],                                       // C6D0: State machine combination 0C Max
+  &TraceComboMax[13],                                       // C6D2: State machine combination 0D Max
+  &TraceComboMax[14],                                       // C6D4: State machine combination 0E Max
+  &TraceComboMax[15],                                       // C6D6: State machine combination 0F Max
+  &TraceComboMax[16],                                       // C6D8: State machine combination 10 Max
+  &TraceComboMax[17],                                       // C6DA: State machine combination 11 Max
+  &TraceComboMax[18],                                       // C6DC: State machine combination 12 Max
+  &TraceComboMax[19],                                       // C6DE: State machine combination 13 Max
+  &TraceComboMax[20],                                       // C6E0: State machine combination 14 Max
+  &TraceComboMax[21],                                       // C6E2: State machine combination 15 Max
+  &TraceComboMax[22],                                       // C6E4: State machine combination 16 Max
+  &TraceComboMax[23],                                       // C6E6: State machine combination 17 Max
+  &TraceComboMax[24],                                       // C6E8: State machine combination 18 Max
+  &TraceComboMax[25],                                       // C6EA: State machine combination 19 Max
+  &TraceComboMax[26],                                       // C6EC: State machine combination 1A Max
+  &TraceComboMax[27],                                       // C6EE: State machine combination 1B Max
+  &TraceComboMax[28],                                       // C6F0: State machine combination 1C Max
+  &TraceComboMax[29],                                       // C6F2: State machine combination 1D Max
+  &TraceComboMax[30],                                       // C6F4: State machine combination 1E Max
+  &TraceComboMax[31],                                       // C6F6: State machine combination 1F Max
+  &TraceComboMax[32],                                       // C6F8: State machine combination 20 Max
+  &TraceComboMax[33],                                       // C6FA: State machine combination 21 Max
+  &TraceComboMax[34],                                       // C6FC: State machine combination 22 Max
+  &TraceComboMax[35],                                       // C6FE: State machine combination 23 Max
+  &TraceComboMax[36],                                       // C700: State machine combination 24 Max
+  &TraceComboMax[37],                                       // C702: State machine combination 25 Max
+  &TraceComboMax[38],                                       // C704: State machine combination 26 Max
+  &TraceComboMax[39],                                       // C706: State machine combination 27 Max
+  &TraceComboMax[40],                                       // C708: State machine combination 28 Max
+  &TraceComboMax[41],                                       // C70A: State machine combination 29 Max
+  &TraceComboMax[42],                                       // C70C: State machine combination 2A Max
+  &TraceComboMax[43],                                       // C70E: State machine combination 2B Max
+  &TraceComboMax[44],                                       // C710: State machine combination 2C Max
+  &TraceComboMax[45],                                       // C712: State machine combination 2D Max
+  &TraceComboMax[46],                                       // C714: State machine combination 2E Max
+  &TraceComboMax[47],                                       // C716: State machine combination 2F Max
+  &TraceComboMax[48],                                       // C718: State machine combination 30 Max
+  &TraceComboMax[49],                                       // C71A: State machine combination 31 Max
+  &TraceComboMax[50],                                       // C71C: State machine combination 32 Max
+  &TraceComboMax[51],                                       // C71E: State machine combination 33 Max
+  &TraceComboMax[52],                                       // C720: State machine combination 34 Max
+  &TraceComboMax[53],                                       // C722: State machine combination 35 Max
+  &TraceComboMax[54],                                       // C724: State machine combination 36 Max
+  &TraceComboMax[55],                                       // C726: State machine combination 37 Max
+  &TraceComboMax[56],                                       // C728: State machine combination 38 Max
+  &TraceComboMax[57],                                       // C72A: State machine combination 39 Max
+  &TraceComboMax[58],                                       // C72C: State machine combination 3A Max
+  &TraceComboMax[59],                                       // C72E: State machine combination 3B Max
+  &TraceComboMax[60],                                       // C730: State machine combination 3C Max
+  &TraceComboMax[61],                                       // C732: State machine combination 3D Max
+  &TraceComboMax[62],                                       // C734: State machine combination 3E Max
+  &TraceComboMax[63]                                        // C736: State machine combination 3F Max
+};
+
+// Modbus Main Loop Trace Conversion Type Table
+//   This handles Group 74 above.  All objects are U32
+const uint8_t MODB_OBJECT_CONV_GR74[] =
+{                                                           // Modbus Fixed Addr (hex)
+  6, 6, 6, 6,                                               // C680-C686: Main loop
+  6, 6, 6, 6,                                               // C688-C68E: 1cyc
+  6, 6, 6, 6,                                               // C690-C696: 200msec
+  6, 6, 6, 6,                                               // C698-C69E: 1sec
+  6, 6, 6, 6,                                               // C6A0-C6A6: 5min
+  6, 6, 6, 6,                                               // C6A8-C6AE: Background
+  6, 6, 6, 6,                                               // C6B0-C6B6: Worst pass
+  6, 6, 6, 6, 6, 6, 6, 6,                                   // C6B8-C6C6: State machine combinations 00-07
+  6, 6, 6, 6, 6, 6, 6, 6,                                   // C6C8-C6D6: State machine combinations 08-0F
+  6, 6, 6, 6, 6, 6, 6, 6,                                   // C6D8-C6E6: State machine combinations 10-17
+  6, 6, 6, 6, 6, 6, 6, 6,                                   // C6E8-C6F6: State machine combinations 18-1F
+  6, 6, 6, 6, 6, 6, 6, 6,                                   // C6F8-C706: State machine combinations 20-27
+  6, 6, 6, 6, 6, 6, 6, 6,                                   // C708-C716: State machine combinations 28-2F
+  6, 6, 6, 6, 6, 6, 6, 6,                                   // C718-C726: State machine combinations 30-37
+  6, 6, 6, 6, 6, 6, 6, 6                                    // C728-C736: State machine combinations 38-3F
+};
+#endif
+
+
+
 // Note, not all arrays exist or are required.  Those that are not required have a duplicate array to fill
 //   the location
 const uint8_t * const MODB_OBJECT_CONV_ADDR[] =
@@ -1425,6 +1753,12 @@ const uint8_t * const MODB_OBJECT_CONV_ADDR[] =
   &MODB_OBJECT_CONV_GR46[0], &MODB_OBJECT_CONV_GR47[0], &MODB_OBJECT_CONV_GR48[0], &MODB_OBJECT_CONV_GR49[0],
   &MODB_OBJECT_CONV_GR50[0], &MODB_OBJECT_CONV_GR69[0], &MODB_OBJECT_CONV_GR70[0], &MODB_OBJECT_CONV_GR53[0],
   &MODB_OBJECT_CONV_GR54[0]
+#ifdef ENABLE_STAGE_PROFILER
+  , &MODB_OBJECT_CONV_GR73[0]
+#endif
+#ifdef ENABLE_LOOP_TRACE
+  , &MODB_OBJECT_CONV_GR74[0]
+#endif
 };
 
 void * const * const MODB_OBJECT_ADDR[] =
@@ -1448,8 +1782,61 @@ void * const * const MODB_OBJECT_ADDR[] =
   &MODB_OBJECT_ADDR_GR46[0], &MODB_OBJECT_ADDR_GR47[0], &MODB_OBJECT_ADDR_GR48[0], &MODB_OBJECT_ADDR_GR49[0],
   &MODB_OBJECT_ADDR_GR50[0], &MODB_OBJECT_ADDR_GR69[0], &MODB_OBJECT_ADDR_GR69[0], &MODB_OBJECT_ADDR_GR53[0],
   &MODB_OBJECT_ADDR_GR54[0]
+#ifdef ENABLE_STAGE_PROFILER
+  , &MODB_OBJECT_ADDR_GR73[0]
+#endif
+#ifdef ENABLE_LOOP_TRACE
+  , &MODB_OBJECT_ADDR_GR74[0]
+#endif
 };
 
+#ifdef ENABLE_MODB_RTD_CACHE
+// Modbus Real-Time Data Cache
+//   The cache holds a snapshot of the two-register real-time data objects that are read in both the fixed
+//   and floating point formats (the object tables below), already converted to the Modbus register format.
+//   There are two banks.  Modb_RtdCacheRefresh() fills the bank that is not being read on the 200msec
+//   anniversary and then makes it the active bank, so a read request always gets values from one pass of
+//   the metering subroutines.
+//   MODB_RTDC_TABLE[] gives the cache location of each object table:
+//     Address Table              Fixed Point Groups    Floating Point Groups
+//     MODB_OBJECT_ADDR_GR10              21                    10
+//     MODB_OBJECT_ADDR_GR11              23                    11
+//     MODB_OBJECT_ADDR_GR12              25                    12
+//     MODB_OBJECT_ADDR_GR15              28                    15
+//     MODB_OBJECT_ADDR_GR42              60                    42
+//     MODB_OBJECT_ADDR_GR54              72                    54
+#define MODB_NOBJ(tbl)          (sizeof(tbl)/sizeof(void *))
+#define MODB_RTDC_NUM_OBJS      (MODB_NOBJ(MODB_OBJECT_ADDR_GR10) + MODB_NOBJ(MODB_OBJECT_ADDR_GR11)      \
+                                  + MODB_NOBJ(MODB_OBJECT_ADDR_GR12) + MODB_NOBJ(MODB_OBJECT_ADDR_GR15)   \
+                                  + MODB_NOBJ(MODB_OBJECT_ADDR_GR42) + MODB_NOBJ(MODB_OBJECT_ADDR_GR54))
+
+const struct MODB_RTDC_TBL MODB_RTDC_TABLE[MODB_RTDC_NUM_TBLS] =
+{
+  { &MODB_OBJECT_ADDR_GR10[0], &MODB_OBJECT_CONV_GR10[0], 0,
+      MODB_NOBJ(MODB_OBJECT_ADDR_GR10) },
+  { &MODB_OBJECT_ADDR_GR11[0], &MODB_OBJECT_CONV_GR11[0], MODB_NOBJ(MODB_OBJECT_ADDR_GR10),
+      MODB_NOBJ(MODB_OBJECT_ADDR_GR11) },
+  { &MODB_OBJECT_ADDR_GR12[0], &MODB_OBJECT_CONV_GR12[0],
+      MODB_NOBJ(MODB_OBJECT_ADDR_GR10) + MODB_NOBJ(MODB_OBJECT_ADDR_GR11),
+      MODB_NOBJ(MODB_OBJECT_ADDR_GR12) },
+  { &MODB_OBJECT_ADDR_GR15[0], &MODB_OBJECT_CONV_GR15[0],
+      MODB_NOBJ(MODB_OBJECT_ADDR_GR10) + MODB_NOBJ(MODB_OBJECT_ADDR_GR11) + MODB_NOBJ(MODB_OBJECT_ADDR_GR12),
+      MODB_NOBJ(MODB_OBJECT_ADDR_GR15) },
+  { &MODB_OBJECT_ADDR_GR42[0], &MODB_OBJECT_CONV_GR42[0],
+      MODB_NOBJ(MODB_OBJECT_ADDR_GR10) + MODB_NOBJ(MODB_OBJECT_ADDR_GR11) + MODB_NOBJ(MODB_OBJECT_ADDR_GR12)
+        + MODB_NOBJ(MODB_OBJECT_ADDR_GR15),
+      MODB_NOBJ(MODB_OBJECT_ADDR_GR42) },
+  { &MODB_OBJECT_ADDR_GR54[0], &MODB_OBJECT_CONV_GR54[0],
+      MODB_NOBJ(MODB_OBJECT_ADDR_GR10) + MODB_NOBJ(MODB_OBJECT_ADDR_GR11) + MODB_NOBJ(MODB_OBJECT_ADDR_GR12)
+        + MODB_NOBJ(MODB_OBJECT_ADDR_GR15) + MODB_NOBJ(MODB_OBJECT_ADDR_GR42),
+      MODB_NOBJ(MODB_OBJECT_ADDR_GR54) }
+};
+
+uint8_t ModbRtdcFixed[2][MODB_RTDC_NUM_OBJS * 4];       // Fixed point registers, one bank per index
+uint8_t ModbRtdcFloat[2][MODB_RTDC_NUM_OBJS * 4];       // Floating point registers, one bank per index
+struct MODB_RTDC_STATE ModbRtdc;
+#endif
+
 
 // Function Codes 5 and 15
 // At the initial writing of this function there are no Function Code 5 or 15 registers suppported.
@@ -1585,11 +1972,11 @@ void * const * const MODB_OBJECT_ADDR[] =
 //
 //  INPUTS:             init_all
 //
-//  OUTPUTS:            ModB.xxx, mb_reg_not_supported, MB_Harmonics_Selection, ModB_CurSetGrp, 
+//  OUTPUTS:            ModB.xxx, mb_reg_not_supported, MB_Harmonics_Selection, ModB_CurSetGrp, ModbRtdc
 //
 //  ALTERS:             None
 //
-//  CALLS:              None
+//  CALLS:              Modb_BuildRegIndex() (if ENABLE_MODB_REG_INDEX is defined)
 //
 //------------------------------------------------------------------------------------------------------------
 
@@ -1616,6 +2003,13 @@ void Modb_VarInit(uint8_t init_all)
   {
     MB_Harmonics_Selection = 0;
     ModB_CurSetGrp = 0x00FF; // start atGroup zero of the Active set for accessing setpoints
+#ifdef ENABLE_MODB_REG_INDEX
+    Modb_BuildRegIndex();
+#endif
+#ifdef ENABLE_MODB_RTD_CACHE
+    ModbRtdc.Active = 0;
+    ModbRtdc.Valid = FALSE;               // Cache is empty until the first 200msec anniversary
+#endif
   }
 }
 
@@ -2302,6 +2696,9 @@ void ModB_SlaveComm(void)
 //                      that contains the starting address in the message), the  offset in the table, the
 //                      number of invalid addresses in the incoming address range before the first address
 //                      match, and the number of valid addresses.
+//                      If ENABLE_MODB_REG_INDEX is defined, the group is found with the page index
+//                      (ModbGroupPage[]) instead of stepping through all of the groups that are below the
+//                      starting address.
 //                                          Example 1: Normal
 //                      Starting address (start_reg_add) = 1202, Number of registers (num_reg) = 10
 //                          group = 1, offset = 1, num_bad = 0, num_to_add = 10
@@ -2365,9 +2762,27 @@ void Modb_CheckRegAddress(uint8_t *group, uint16_t *offset, uint8_t *num_bad, ui
   uint8_t i;
 
   end_reg_add = start_reg_add + num_reg - 1;
+#ifdef ENABLE_MODB_REG_INDEX
+  // Get the first group that ends in or after the starting address's page from the page index, and step
+  //   past any groups in the page that end before the starting address.  The groups are in ascending
+  //   order and do not overlap, so this is the only group that can contain some portion of the address
+  //   range.  If it begins after the ending address, none of the groups do.  The loop below then either
+  //   takes this group on the first pass or falls through with i = MODB_NUM_GROUPS
+  i = ModbGroupPage[start_reg_add >> MODB_PAGE_SHIFT];
+  while ( (i < MODB_NUM_GROUPS) && (MODB_GROUP_END_ADD[i] < start_reg_add) )
+  {
+    ++i;
+  }
+  if ( (i < MODB_NUM_GROUPS) && (end_reg_add < MODB_GROUP_START_ADD[i]) )
+  {
+    i = MODB_NUM_GROUPS;
+  }
+  for ( ; i < MODB_NUM_GROUPS; ++i)
+#else
   // Step through the address groups in ascending order.  Check each group to find the lowest address group
   // that contains the address
   for (i=0; i < MODB_NUM_GROUPS; ++i)
+#endif
   {
     // If some portion of the input address range is in the address group...
     if ( (start_reg_add <= MODB_GROUP_END_ADD[i]) && (end_reg_add >= MODB_GROUP_START_ADD[i]) )
@@ -2424,6 +2839,335 @@ void Modb_CheckRegAddress(uint8_t *group, uint16_t *offset, uint8_t *num_bad, ui
 
 
 
+#ifdef ENABLE_MODB_REG_INDEX
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Modb_BuildRegIndex()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Build Modbus Register Address Page Index
+//
+//  MECHANICS:          This subroutine builds the register address page index, ModbGroupPage[].  The
+//                      register address space is divided into MODB_NUM_PAGES pages of MODB_PAGE_SIZE
+//                      registers.  For each page, the index holds the first address group (in
+//                      MODB_GROUP_START_ADD[] and MODB_GROUP_END_ADD[]) whose ending address is in or after
+//                      the page.  If there is no such group, the entry is MODB_NUM_GROUPS.
+//                      Modb_CheckRegAddress() uses the index to go straight to the group for a starting
+//                      address instead of stepping through all of the groups below it.
+//                      The index is built from the group tables at initialization, rather than being a
+//                      constant table, so that it always matches the groups (including the optional Groups
+//                      73 and 74).
+//
+//  CAVEATS:            The address groups must be in ascending order and must not overlap
+//
+//  INPUTS:             MODB_GROUP_END_ADD[]
+//
+//  OUTPUTS:            ModbGroupPage[]
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Modb_BuildRegIndex(void)
+{
+  uint16_t pg;
+  uint8_t i;
+
+  i = 0;
+  for (pg = 0; pg < MODB_NUM_PAGES; ++pg)
+  {
+    // Step to the first group that ends at or after the first register in the page.  Since the groups are
+    //   in ascending order, the search for the next page picks up where this one left off
+    while ( (i < MODB_NUM_GROUPS) && (MODB_GROUP_END_ADD[i] < (uint16_t)(pg << MODB_PAGE_SHIFT)) )
+    {
+      ++i;
+    }
+    ModbGroupPage[pg] = i;
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Modb_BuildRegIndex()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Modb_StoreObjBlock()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Modbus Format and Store a Block of 32-bit Objects
+//
+//  MECHANICS:          This subroutine converts a block of consecutive 32-bit (two-register) data objects
+//                      and stores them in the Modbus transmit buffer.  It does the same conversions as
+//                      Modb_FormatStoreVal(), but:
+//                        - the encoder, scale factor, and word order setpoint for each format code are
+//                          looked up in the format descriptor table (MODB_FMT32[]) instead of being decoded
+//                          in a switch statement for each object
+//                        - the word order and invalid object handling setpoints are read once per block
+//                          instead of once per object
+//                        - the two registers of each object are stored with one word write of the byte-
+//                          reversed value:
+//                              word order > 0 (low-order word first): __REV16(value)
+//                              word order = 0 (high-order word first): __REV(value)
+//                      The format code for each object is cc_ptr[i] + conv_add (conv_add is 20 for the
+//                      floating point groups and 0 for the fixed point groups).  If the code is invalid (99
+//                      or 119) and nak_invalid is TRUE (unforgiving mode), the subroutine stops and returns
+//                      the number of objects that were stored.  Otherwise invalid objects are filled with
+//                      zeros.
+//
+//  CAVEATS:            This is only for the groups with two registers per object (format codes 0 - 39,
+//                      99, and 119).  The 64-bit objects and the time stamps are stored with
+//                      Modb_FormatStoreVal().
+//                      The word write assumes a little-endian processor (the STM32F407 and the host PC).
+//
+//  INPUTS:             cc_ptr: pointer to the conversion code of the first object
+//                      objaddr_ptr: pointer to the data address of the first object
+//                      conv_add: amount to add to the conversion codes (0 or 20)
+//                      num: number of objects to store
+//                      nak_invalid: TRUE to stop at an invalid object (unforgiving mode)
+//                      *val_out: pointer to output array (ModB.TxMsgBuf[] or the real-time data cache)
+//                      Setpoints2.stp.Modbus_RTU_Fixed_Pt_Word_Order,
+//                      Setpoints2.stp.Modbus_RTU_Floating_Pt_Word_Order
+//
+//  OUTPUTS:            *val_out
+//                      Returns the number of objects that were stored (num unless an invalid object was
+//                      found with nak_invalid TRUE)
+//
+//  ALTERS:             None
+//
+//  CALLS:              __REV(), __REV16(), memcpy()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Modb_StoreObjBlock(uint8_t const *cc_ptr, void * const *objaddr_ptr, uint8_t conv_add, uint8_t num,
+                                    uint8_t nak_invalid, uint8_t *val_out)
+{
+  union VAL_HOLDER
+  {
+    float fval;
+    uint32_t uval;
+    int32_t sval;
+  } temp_val;
+  struct MODB_FMT32_DESC const *fmt_ptr;
+  uint32_t outword;
+  uint8_t fixed_lofirst, float_lofirst, lofirst;
+  uint8_t code, i;
+
+  fixed_lofirst = (Setpoints2.stp.Modbus_RTU_Fixed_Pt_Word_Order > 0);
+  float_lofirst = (Setpoints2.stp.Modbus_RTU_Floating_Pt_Word_Order > 0);
+
+  for (i = 0; i < num; ++i)
+  {
+    code = cc_ptr[i] + conv_add;
+    if (code >= MODB_NUM_FMT32)               // Invalid register (codes 99 and 119)
+    {
+      if ( (nak_invalid) && ((code == 99) || (code == 119)) )
+      {
+        break;                                  // Stop so the caller will NAK
+      }
+      temp_val.uval = 0;                        // Forgiving mode - fill with zeros
+      lofirst = FALSE;
+    }
+    else
+    {
+      fmt_ptr = &MODB_FMT32[code];
+      switch (fmt_ptr->Encoder)
+      {
+        case MODB_ENC_F_U32:                    // float * scale --> U32 (negative values clamped to 0,
+          temp_val.fval = *((float *)objaddr_ptr[i]);     //   rounded)
+          temp_val.fval = ((temp_val.fval < 0) ? (0) : (temp_val.fval)) * fmt_ptr->Scale;
+          temp_val.uval = (uint32_t)(temp_val.fval + 0.5F);
+          break;
+
+        case MODB_ENC_F_S32:                    // float * scale --> S32 (rounded)
+          temp_val.fval = *((float *)objaddr_ptr[i]) * fmt_ptr->Scale;
+          temp_val.fval = ( (temp_val.fval < 0) ? (temp_val.fval - 0.5F) : (temp_val.fval + 0.5F) );
+          temp_val.sval = (int32_t)(temp_val.fval);
+          break;
+
+        case MODB_ENC_F_POS:                    // float --> float positive
+          temp_val.fval = *((float *)objaddr_ptr[i]);
+          temp_val.fval = ((temp_val.fval < 0) ? (0) : (temp_val.fval));
+          break;
+
+        case MODB_ENC_FLOAT:                    // float --> float
+        case MODB_ENC_U32:                      // U32 --> U32
+          temp_val.uval = *((uint32_t *)objaddr_ptr[i]);
+          break;
+
+        case MODB_ENC_U64_K:                    // U64/1000 --> U32
+          temp_val.uval = (uint32_t)(*((unsigned long long *)objaddr_ptr[i])/1000);
+          break;
+
+        case MODB_ENC_S64_K:                    // S64/1000 --> S32
+          temp_val.sval = (int32_t)(*((signed long long *)objaddr_ptr[i])/1000);
+          break;
+
+        default:                                // Not used - fill with zeros
+          temp_val.uval = 0;
+          break;
+      }
+      lofirst = ( (fmt_ptr->FloatOrder) ? float_lofirst : fixed_lofirst );
+    }
+    // Store the two registers (ms byte of each register first) in the order given by the setpoint
+    outword = ( (lofirst) ? __REV16(temp_val.uval) : __REV(temp_val.uval) );
+    memcpy(&val_out[i << 2], &outword, 4);
+  }
+  return (i);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Modb_StoreObjBlock()
+//------------------------------------------------------------------------------------------------------------
+#endif
+
+
+
+#ifdef ENABLE_MODB_RTD_CACHE
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Modb_RtdCacheRefresh()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Refresh the Modbus Real-Time Data Cache
+//
+//  MECHANICS:          This subroutine takes a snapshot of the real-time data objects in the cache object
+//                      tables (MODB_RTDC_TABLE[]).  Each object is converted to both the fixed point and the
+//                      floating point register format with Modb_StoreObjBlock(), and stored in the bank
+//                      that is not active.  Invalid objects are stored as zeros; the unforgiving mode check
+//                      is done when the cache is read.  The word order setpoints that were used are saved
+//                      with the bank, and the bank is then made the active bank.
+//                      The active bank is switched with a single byte write after the bank is full, so a
+//                      read never sees a bank that is partly filled.
+//
+//  CAVEATS:            This must be called on the 200msec anniversary after the metering subroutines, so
+//                      that the snapshot is of one pass of the subroutines
+//
+//  INPUTS:             MODB_RTDC_TABLE[], Setpoints2.stp.Modbus_RTU_Fixed_Pt_Word_Order,
+//                      Setpoints2.stp.Modbus_RTU_Floating_Pt_Word_Order
+//
+//  OUTPUTS:            ModbRtdcFixed[][], ModbRtdcFloat[][], ModbRtdc
+//
+//  ALTERS:             None
+//
+//  CALLS:              Modb_StoreObjBlock()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Modb_RtdCacheRefresh(void)
+{
+  struct MODB_RTDC_TBL const *tbl_ptr;
+  uint8_t bank, t;
+
+  bank = ModbRtdc.Active ^ 1;
+  for (t = 0; t < MODB_RTDC_NUM_TBLS; ++t)
+  {
+    tbl_ptr = &MODB_RTDC_TABLE[t];
+    Modb_StoreObjBlock(tbl_ptr->Conv, tbl_ptr->Addr, 0, tbl_ptr->Num, FALSE,
+                       &ModbRtdcFixed[bank][tbl_ptr->Base << 2]);
+    Modb_StoreObjBlock(tbl_ptr->Conv, tbl_ptr->Addr, 20, tbl_ptr->Num, FALSE,
+                       &ModbRtdcFloat[bank][tbl_ptr->Base << 2]);
+  }
+  ModbRtdc.FixedLoFirst[bank] = (Setpoints2.stp.Modbus_RTU_Fixed_Pt_Word_Order > 0);
+  ModbRtdc.FloatLoFirst[bank] = (Setpoints2.stp.Modbus_RTU_Floating_Pt_Word_Order > 0);
+  ModbRtdc.Active = bank;
+  ModbRtdc.Valid = TRUE;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Modb_RtdCacheRefresh()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Modb_RtdCacheGet()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Read Objects from the Modbus Real-Time Data Cache
+//
+//  MECHANICS:          This subroutine copies a block of consecutive two-register objects from the active
+//                      bank of the real-time data cache into the Modbus transmit buffer.  The objects are
+//                      not in the cache (MODB_RTDC_MISS is returned) if:
+//                        - the cache has not been filled yet
+//                        - the object table (objaddr_ptr) is not one of the cache object tables
+//                        - a word order setpoint has been changed since the snapshot was taken
+//                      In these cases the caller must convert the live values instead.
+//                      In unforgiving mode, the copy stops at the first invalid object (conversion code
+//                      99), and the number of objects that were copied is returned, the same as
+//                      Modb_StoreObjBlock().
+//
+//  CAVEATS:            The values may be up to 200msec old
+//
+//  INPUTS:             objaddr_ptr: object data address table of the group (MODB_OBJECT_ADDR[group])
+//                      offset: table index of the first object
+//                      conv_add: 20 for the floating point groups, 0 for the fixed point groups
+//                      num: number of objects
+//                      *val_out: pointer to output array (ModB.TxMsgBuf[])
+//                      ModbRtdc, ModbRtdcFixed[][], ModbRtdcFloat[][],
+//                      Setpoints2.stp.Modbus_RTU_Inval_Obj_Handling,
+//                      Setpoints2.stp.Modbus_RTU_Fixed_Pt_Word_Order,
+//                      Setpoints2.stp.Modbus_RTU_Floating_Pt_Word_Order
+//
+//  OUTPUTS:            ModB.TxMsgBuf[]
+//                      Returns the number of objects that were copied, or MODB_RTDC_MISS
+//
+//  ALTERS:             None
+//
+//  CALLS:              memcpy()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Modb_RtdCacheGet(void * const *objaddr_ptr, uint16_t offset, uint8_t conv_add, uint8_t num,
+                                    uint8_t *val_out)
+{
+  struct MODB_RTDC_TBL const *tbl_ptr;
+  uint8_t bank, t, i;
+
+  bank = ModbRtdc.Active;
+  if ( (!ModbRtdc.Valid)
+    || (ModbRtdc.FixedLoFirst[bank] != (Setpoints2.stp.Modbus_RTU_Fixed_Pt_Word_Order > 0))
+    || (ModbRtdc.FloatLoFirst[bank] != (Setpoints2.stp.Modbus_RTU_Floating_Pt_Word_Order > 0)) )
+  {
+    return (MODB_RTDC_MISS);
+  }
+  for (t = 0; t < MODB_RTDC_NUM_TBLS; ++t)
+  {
+    if (MODB_RTDC_TABLE[t].Addr == objaddr_ptr)
+    {
+      break;
+    }
+  }
+  if (t == MODB_RTDC_NUM_TBLS)
+  {
+    return (MODB_RTDC_MISS);
+  }
+
+  tbl_ptr = &MODB_RTDC_TABLE[t];
+  i = num;
+  if (Setpoints2.stp.Modbus_RTU_Inval_Obj_Handling != 0)  // Unforgiving mode - stop at an invalid object
+  {
+    for (i = 0; i < num; ++i)
+    {
+      if (tbl_ptr->Conv[offset + i] == 99)
+      {
+        break;
+      }
+    }
+  }
+  memcpy(val_out, ( (conv_add > 0) ? &ModbRtdcFloat[bank][(tbl_ptr->Base + offset) << 2]
+                                   : &ModbRtdcFixed[bank][(tbl_ptr->Base + offset) << 2] ), (i << 2));
+  return (i);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Modb_RtdCacheGet()
+//------------------------------------------------------------------------------------------------------------
+#endif
+
+
+
 //------------------------------------------------------------------------------------------------------------
 //             START OF FUNCTION        ProcFC0102Msg()
 //------------------------------------------------------------------------------------------------------------
@@ -2670,7 +3414,8 @@ void ProcFC0102Msg(uint8_t length, uint8_t fc)
 //
 //  ALTERS:             None
 //
-//  CALLS:              Modb_CheckRegAddress(), Modb_FormatStoreVal(), CalcCRC()
+//  CALLS:              Modb_CheckRegAddress(), Modb_FormatStoreVal(), Modb_StoreObjBlock(),
+//                      Modb_RtdCacheGet(), CalcCRC()
 //
 //  EXECUTION TIME:     
 //
@@ -2939,6 +3684,8 @@ void ProcFC0304Msg(uint8_t length, uint8_t fc)
       case 28:                            // Real-time data values - fixed point
       case 60:                            // Real-time data values - fixed point
       case 72:                            // Real-time data values - fixed point
+      case 73:                            // Stage profiler statistics - fixed point
+      case 74:                            // Main loop trace - fixed point
       case 24:                            // Real-time data values - fixed point 64-bit energy
       case 70:                            // Real-time data values - fixed point 64-bit energy
       case 10:                            // Real-time data values - floating point
@@ -2985,6 +3732,29 @@ void ProcFC0304Msg(uint8_t length, uint8_t fc)
         //   registers with zeros or NAK.
         // Remember, all data objects in a group of registers are the same size!
         endcnt = num_to_add/MODB_NUM_REGS_PER_DATA_OBJECT[group];
+#ifdef ENABLE_MODB_REG_INDEX
+        // The 32-bit objects are converted and stored as a block.  If there is an unsupported register in
+        //   unforgiving mode, Modb_StoreObjBlock() stops at it and we NAK
+        if (MODB_NUM_REGS_PER_DATA_OBJECT[group] == 2)
+        {
+          conversion_code = ( ((group < 16) || (group == 42) || (group == 54)) ? 20 : 0 );
+#ifdef ENABLE_MODB_RTD_CACHE
+          // Copy the objects from the real-time data cache snapshot if they are in it
+          i = Modb_RtdCacheGet(objaddr_ptr, offset, conversion_code, endcnt, &ModB.TxMsgBuf[ndx]);
+          if (i == MODB_RTDC_MISS)                  // If not in the cache, convert the live values
+#endif
+          {
+            i = Modb_StoreObjBlock(&cc_ptr[offset], &objaddr_ptr[offset], conversion_code, endcnt,
+                                   (Setpoints2.stp.Modbus_RTU_Inval_Obj_Handling != 0), &ModB.TxMsgBuf[ndx]);
+          }
+          ndx += (i << 2);
+          if (i < endcnt)
+          {
+            errcode = NAK_ILLEGAL_DATA_ADDR;
+          }
+        }
+        else
+#endif
         for (i = 0; i < endcnt; ++i)
         {
           // Conversion code calls for scaling multiplication and a format change only if fixed point
@@ -4018,6 +4788,8 @@ void ProcFC16Msg(uint8_t length)
 //                      receive buffer, pointed to by *msg_ptr.  
 //                      The CRC-16 generator polynomial is x^16 + x^15 + x^2 + 1, and is computed using
 //                      a 256-word look-up-table method.
+//                      If ENABLE_CRC_SLICE is defined, the CRC is computed eight bytes at a time with the
+//                      slicing tables in Crc.c (Crc16_Block()).  The result is the same.
 //
 //  CAVEATS:            The subroutine assumes that *(msg_ptr + len) is within the buffer size
 //
@@ -4028,12 +4800,15 @@ void ProcFC16Msg(uint8_t length)
 //
 //  ALTERS:             None
 //
-//  CALLS:              None
+//  CALLS:              Crc16_Block() (if ENABLE_CRC_SLICE is defined)
 //
 //------------------------------------------------------------------------------------------------------------
 
 uint16_t CalcCRC(uint8_t *msg_ptr, uint16_t len)
 {
+#ifdef ENABLE_CRC_SLICE
+  return (Crc16_Block(CRC16_INIT, msg_ptr, len));
+#else
   uint16_t crc, nxt_char, i;           // temps
 
   crc = 0xFFFF;                        // Initialize crc
@@ -4047,6 +4822,7 @@ uint16_t CalcCRC(uint8_t *msg_ptr, uint16_t len)
     }
   }
   return(crc);
+#endif
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -38,6 +38,10 @@
 //   0.00   190726  DAH File Creation
 //   0.50   220203  DAH - Added Modbus ACK/NAK definitions
 //                      - Deleted T1P5 from struct MODB_PORT as it is no longer used
+//   171    240223  DAH - Added the register address page index definitions (MODB_PAGE_xx), the 32-bit
+//                        format encoder definitions (MODB_ENC_xx), and struct MODB_FMT32_DESC
+//   172    240224  DAH - Added the real-time data cache definitions (MODB_RTDC_xx), struct MODB_RTDC_TBL,
+//                        and struct MODB_RTDC_STATE
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -169,6 +173,31 @@ enum ModB_Comm_States
 #define MODB_RTD2_FIXED_END         0xC0B9          // End of fixed-point real-time data section 2
 
 
+// Register address page index definitions (ENABLE_MODB_REG_INDEX)
+#define MODB_PAGE_SHIFT             6                           // Registers per page = 2^MODB_PAGE_SHIFT
+#define MODB_PAGE_SIZE              (1U << MODB_PAGE_SHIFT)
+#define MODB_NUM_PAGES              (65536U >> MODB_PAGE_SHIFT)
+
+
+// 32-bit format encoder definitions (ENABLE_MODB_REG_INDEX)
+//   MODB_NUM_FMT32 is the number of format codes in the format descriptor table (MODB_FMT32[])
+#define MODB_NUM_FMT32              40
+
+#define MODB_ENC_ZERO               0               // Not used - fill with zeros
+#define MODB_ENC_F_U32              1               // float * scale --> U32
+#define MODB_ENC_F_S32              2               // float * scale --> S32
+#define MODB_ENC_F_POS              3               // float --> float positive
+#define MODB_ENC_FLOAT              4               // float --> float
+#define MODB_ENC_U32                5               // U32 --> U32
+#define MODB_ENC_U64_K              6               // U64/1000 --> U32
+#define MODB_ENC_S64_K              7               // S64/1000 --> S32
+
+
+// Real-time data cache definitions (ENABLE_MODB_RTD_CACHE)
+#define MODB_RTDC_NUM_TBLS          6               // Number of object tables in the cache
+#define MODB_RTDC_MISS              0xFF            // Modb_RtdCacheGet() return value if not in the cache
+
+
 
 
 //
@@ -176,6 +205,29 @@ enum ModB_Comm_States
 //    Structure & Unions
 //------------------------------------------------------------------------------------------------------------
 
+struct MODB_FMT32_DESC
+{
+  uint8_t  Encoder;                     // Encoder (MODB_ENC_xx)
+  uint8_t  FloatOrder;                  // TRUE if the floating point word order setpoint applies
+  float    Scale;                       // Scale factor for the float --> integer encoders
+};
+
+struct MODB_RTDC_TBL
+{
+  void * const *Addr;                   // Object data address table
+  uint8_t const *Conv;                  // Object conversion code table (fixed point codes)
+  uint16_t Base;                        // Cache index of the first object in the table
+  uint8_t  Num;                         // Number of objects in the table
+};
+
+struct MODB_RTDC_STATE
+{
+  uint8_t  Active;                      // Bank that is read (0 or 1)
+  uint8_t  Valid;                       // TRUE once the first snapshot has been taken
+  uint8_t  FixedLoFirst[2];             // Fixed point word order used for each bank (TRUE = low word first)
+  uint8_t  FloatLoFirst[2];             // Floating point word order used for each bank
+};
+
 struct MODB_PORT
 {
   uint8_t  CommState;
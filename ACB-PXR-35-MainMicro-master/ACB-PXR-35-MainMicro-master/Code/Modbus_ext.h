@@ -37,6 +37,7 @@
 //  Development Revision History:
 //   0.00   190726  DAH File Creation
 //   116    231120  MAG Added init_all parameter to Modb_VarInit()
+//   172    240224  DAH - Added Modb_RtdCacheRefresh()
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -71,6 +72,9 @@ extern struct MODB_PORT ModB;
 extern void Modb_VarInit(uint8_t init_all);
 extern void ModB_SlaveComm(void);
 extern void Modb_Save_Setpoints(uint8_t CurSetpSet, uint8_t SetpGrpNum);
+#ifdef ENABLE_MODB_RTD_CACHE
+  extern void Modb_RtdCacheRefresh(void);
+#endif
 
 
 
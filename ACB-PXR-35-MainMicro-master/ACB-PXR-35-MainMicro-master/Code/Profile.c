@@ -0,0 +1,324 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//
+//  MODULE NAME:        Profile.c
+//
+//  MECHANICS:          Program module containing the execution-time profiler.  The profiler measures the
+//                      time of each stage of the AFE sample interrupt and of each main-loop anniversary
+//                      block with the DWT cycle counter, and keeps the count, minimum, maximum, last, and
+//                      total time, and a log2 histogram of the times for each stage.  The stages are
+//                      listed in Profile_def.h.
+//                      The stage statistics may be read with the test port "PF" command (reset with the
+//                      "PR" command), and the count, minimum, maximum, and last times may be read over
+//                      Modbus (Group 73, registers 50688 - 50799).
+//                      The profiler is only compiled in if ENABLE_STAGE_PROFILER is defined in Iod_def.h.
+//                      It also runs in the host build, where the cycle counter is replaced by
+//                      Host_CycCnt().
+//
+//  TARGET HARDWARE:    PXR35 Rev 1 and later boards
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   155    240207  DAH File Creation
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+// Path for library files:
+//   IAR Systems\Embedded Workbench 8.3\arm\inc\c
+//
+//------------------------------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------------------------------
+//                   Definitions
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global Definitions from external files...
+//
+#include "stm32f4xx.h"
+#include "stm32f407xx.h"
+#include "RealTime_def.h"
+#include "Iod_def.h"
+#include "Profile_def.h"
+
+#ifdef ENABLE_STAGE_PROFILER
+
+//
+//      Local Definitions used in this module...
+//
+
+
+//
+//      Global Declarations from external files...
+//
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global (Visible) Function Prototypes (These functions are called by other modules)
+//
+void Prof_Init(void);
+void Prof_Reset(void);
+void Prof_Record(uint8_t stage, uint32_t cycles);
+
+
+//      Local Function Prototypes (These functions are called only within this module)
+//
+void Prof_ClearStats(void);
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Storage Allocation - Global (Static) Variables
+//------------------------------------------------------------------------------------------------------------
+//
+//       These variables are used by other modules...
+//
+struct PROF_STAGE ProfStage[PROF_NUM_STAGES];
+uint32_t ProfStartCyc[PROF_NUM_STAGES];
+
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Global Constants used in this module and other modules
+//------------------------------------------------------------------------------------------------------------
+//
+// Stage names for the test port display.  These must be in the same order as the stage definitions in
+//   Profile_def.h, and must be no longer than 12 characters
+const char * const PROF_STAGE_NAME[PROF_NUM_STAGES] =
+{
+  "ISR total", "ISR misc", "ISR AFE", "ISR buffer", "ISR SOS", "ISR prot", "ISR 61850",
+  "1cyc calc", "1cyc prot", "1cyc alarm", "200msec", "1sec", "5min", "Main loop"
+};
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Prof_Init()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Profiler Initialization
+//
+//  MECHANICS:          This subroutine enables the DWT cycle counter and clears the stage statistics.  The
+//                      cycle counter is in the debug block, so trace must be enabled (TRCENA) before it can
+//                      be used.  It is normally enabled anyway when the debugger is attached.
+//
+//  CAVEATS:            Called during initialization, before interrupts are enabled
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            ProfStage[], ProfStartCyc[]
+//
+//  ALTERS:             CoreDebug->DEMCR, DWT->CYCCNT, DWT->CTRL
+//
+//  CALLS:              Prof_ClearStats()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Prof_Init(void)
+{
+  uint8_t i;
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  for (i = 0; i < PROF_NUM_STAGES; ++i)
+  {
+    ProfStartCyc[i] = 0;
+  }
+  Prof_ClearStats();
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Prof_Init()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Prof_Reset()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Reset Profiler Statistics
+//
+//  MECHANICS:          This subroutine clears the statistics for all of the stages.  Interrupts are disabled
+//                      while the table is cleared so that a measurement is not recorded in a partially
+//                      cleared entry.
+//
+//  CAVEATS:            Interrupts are enabled on exit, so this must only be called from the main loop (test
+//                      port command)
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            ProfStage[]
+//
+//  ALTERS:             None
+//
+//  CALLS:              __disable_irq(), Prof_ClearStats(), __enable_irq()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Prof_Reset(void)
+{
+  __disable_irq();
+  Prof_ClearStats();
+  __enable_irq();
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Prof_Reset()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Prof_ClearStats()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Clear Profiler Statistics
+//
+//  MECHANICS:          This subroutine clears the count, maximum, last, and total times and the histogram
+//                      bins, and sets the minimum time to its maximum value, for all of the stages.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            ProfStage[]
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Prof_ClearStats(void)
+{
+  uint8_t i, j;
+
+  for (i = 0; i < PROF_NUM_STAGES; ++i)
+  {
+    ProfStage[i].Count = 0;
+    ProfStage[i].Min = 0xFFFFFFFF;
+    ProfStage[i].Max = 0;
+    ProfStage[i].Last = 0;
+    ProfStage[i].Total = 0;
+    for (j = 0; j < PROF_HIST_BINS; ++j)
+    {
+      ProfStage[i].Hist[j] = 0;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Prof_ClearStats()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Prof_Record()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Record Stage Time
+//
+//  MECHANICS:          This subroutine adds a measured time to the statistics for a stage.  The histogram
+//                      bin is the number of significant bits in the time, computed with the CLZ
+//                      instruction, so the bins are powers of two.  The count and histogram bins are held
+//                      at their maximum values rather than rolling over.
+//
+//  CAVEATS:            This is called from both the AFE sample interrupt and the main loop.  Each stage is
+//                      only recorded from one context, so an entry is never written by both.  The test port
+//                      and Modbus read the entries without disabling interrupts, so the values read for an
+//                      interrupt stage may be from two consecutive measurements.
+//
+//  INPUTS:             stage - the stage number (PROF_ISR_TOTAL .. PROF_MAIN_LOOP)
+//                      cycles - the measured time in core clock cycles
+//
+//  OUTPUTS:            ProfStage[stage]
+//
+//  ALTERS:             None
+//
+//  CALLS:              __CLZ()
+//
+//  EXECUTION TIME:
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Prof_Record(uint8_t stage, uint32_t cycles)
+{
+  struct PROF_STAGE *sptr;
+  uint8_t bin;
+
+  sptr = &ProfStage[stage];
+  if (sptr->Count < 0xFFFFFFFF)
+  {
+    sptr->Count++;
+  }
+  if (cycles < sptr->Min)
+  {
+    sptr->Min = cycles;
+  }
+  if (cycles > sptr->Max)
+  {
+    sptr->Max = cycles;
+  }
+  sptr->Last = cycles;
+  sptr->Total += cycles;
+
+  bin = 32 - __CLZ(cycles);
+  if (bin >= PROF_HIST_BINS)
+  {
+    bin = PROF_HIST_BINS - 1;
+  }
+  if (sptr->Hist[bin] < 0xFFFF)
+  {
+    sptr->Hist[bin]++;
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Prof_Record()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_STAGE_PROFILER
@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//
+//  MODULE NAME:        Profile_def.h
+//
+//  MECHANICS:          This is the definitions file for the Profile.c module.  It must be preceded by
+//                      Iod_def.h, since the profiler is only compiled in if ENABLE_STAGE_PROFILER is defined
+//
+//  TARGET HARDWARE:    PXR35 Rev 1 and later boards
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   155    240207  DAH File Creation
+//   179    240302  DAH Profiled stages comment revised (stages that cover more than one main loop
+//                      subroutine are measured in main())
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+// Path for library files:
+//   IAR Systems\Embedded Workbench 8.3\arm\inc\c
+//
+//------------------------------------------------------------------------------------------------------------
+
+#ifndef PROFILE_DEF_H
+#define PROFILE_DEF_H
+
+//
+//------------------------------------------------------------------------------------------------------------
+//    Constants
+//------------------------------------------------------------------------------------------------------------
+
+// Profiled stages.  The first group are the stages of the AFE sample interrupt (DMA1_Stream0_IRQHandler()).
+//   The second group are the main-loop anniversary blocks.  The main-loop stage times include the time
+//   spent in any interrupts that occur during the stage.  The alarm, 200msec, and main loop stages cover
+//   more than one main loop subroutine, and are started and stopped in main().  With ENABLE_MAIN_SCHED, the
+//   main loop stage is one background pass, and the alarm and 200msec stages are not measured
+#define PROF_ISR_TOTAL          0           // Entire AFE sample interrupt
+#define PROF_ISR_MISC           1           // Test injection, switches, ZSI input
+#define PROF_ISR_AFE            2           // AFE_Process_Samples()
+#define PROF_ISR_BUFFER         3           // SampleBuf[] storage, CAM transmission, waveform capture
+#define PROF_ISR_SOS            4           // Sums of squares, peaks, THD, anniversaries, buffer indices
+#define PROF_ISR_PROT           5           // Instantaneous, short-delay, and ground-fault protection
+#define PROF_ISR_61850          6           // DispComm61850_Rx() and DispComm61850_Tx()
+#define PROF_MAIN_ONECYC_CALC   7           // One-cycle anniversary - calculations
+#define PROF_MAIN_ONECYC_PROT   8           // One-cycle anniversary - protection
+#define PROF_MAIN_ONECYC_ALARM  9           // One-cycle anniversary - alarms and captures
+#define PROF_MAIN_200MSEC       10          // 200msec anniversary
+#define PROF_MAIN_1SEC          11          // 1sec anniversary
+#define PROF_MAIN_5MIN          12          // 5min anniversary
+#define PROF_MAIN_LOOP          13          // Entire main loop
+#define PROF_NUM_STAGES         14
+
+// Number of histogram bins.  Bin n holds the number of measurements from 2^(n-1) to (2^n - 1) cycles, bin 0
+//   holds the zero-cycle measurements, and the last bin also holds all longer measurements.  With 24 bins,
+//   the last bin begins at 2^22 cycles (35msec at 120MHz)
+#define PROF_HIST_BINS          24
+
+// Cycle counter.  On the target this is the DWT cycle counter, which runs at the core clock.  In the host
+//   build, Host_CycCnt() returns the elapsed time scaled to 120MHz cycles
+#ifdef HOST_BUILD
+  #define PROF_CYCCNT()         Host_CycCnt()
+#else
+  #define PROF_CYCCNT()         (DWT->CYCCNT)
+#endif
+
+// Stage timing macros.  These are placed around the code to be measured.  They compile to nothing unless
+//   ENABLE_STAGE_PROFILER is defined in Iod_def.h.  Note, a stage must not be started in one context (main
+//   loop or interrupt) and stopped in another
+#ifdef ENABLE_STAGE_PROFILER
+  #define PROF_START(stg)       ProfStartCyc[stg] = PROF_CYCCNT()
+  #define PROF_STOP(stg)        Prof_Record((stg), (PROF_CYCCNT() - ProfStartCyc[stg]))
+#else
+  #define PROF_START(stg)
+  #define PROF_STOP(stg)
+#endif
+
+//
+//------------------------------------------------------------------------------------------------------------
+//    Structures
+//------------------------------------------------------------------------------------------------------------
+//
+// Stage statistics.  Times are in core clock cycles.  Count and the histogram bins saturate rather than
+//   roll over.  Min is 0xFFFFFFFF until the first measurement
+struct PROF_STAGE
+{
+  uint32_t Count;                           // Number of measurements
+  uint32_t Min;                             // Minimum time
+  uint32_t Max;                             // Maximum time
+  uint32_t Last;                            // Most recent time
+  uint64_t Total;                           // Sum of the times (for the average)
+  uint16_t Hist[PROF_HIST_BINS];            // Log2 histogram of the times
+};
+
+#endif                  // PROFILE_DEF_H
@@ -272,6 +272,19 @@
 //   150    240202  DAH - Eliminated code that clears the trip flag in PhaseRotation_Prot().  Flag shouldn't
 //                        be cleared, unless the reset button is pressed.
 //                      - Added code to insert an event when a trip occurs
+//   153    240205  DAH - Replaced the IAR location operator (@".sram1", @".sram2") with SRAM1_LOC and
+//                        SRAM2_LOC so the module can be compiled in the host build
+//   167    240219  DAH - Replaced the writes to the interrupt event buffer with calls to InsertNewEvent()
+//                        (ENABLE_EVENT_QUEUE defined).  InsertNewEvent() may be called from the interrupts
+//   173    240225  DAH - Added the table-driven protection element engine (ENABLE_PROT_TABLE defined)
+//                      - Added PROT_TRIP_DEF[] and PROT_ALARM_DEF[] (the element definitions), ProtTripList
+//                        and ProtAlarmList (the enabled elements)
+//                      - Added ProtElem_Build(), ProtElem_BuildList(), ProtElem_Setup(), ProtElem_Eval(),
+//                        ProtElem_Trip(), ProtElem_Alarm(), ProtElem_Pickup(), and ProtElem_PowerInput()
+//                      - Gen_Values() revised to call ProtElem_Build()
+//   174    240226  DAH - ProtElem_PowerInput() revised to use the one-cycle max powers in OneCycMaxPwr
+//                        (ENABLE_ONECYC_KERNEL defined)
+//   179    240302  DAH - Removed the table-driven protection element engine (ENABLE_PROT_TABLE deleted)
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -481,28 +494,28 @@ uint8_t Inst_StartupSampleCnt;
 //
 // Variables located in .sram2 are only used during the DMA1_Stream0_IRQHandler() interrupt.  There is no
 //   conflict with the associated DMA stream, since it is not be enabled during this interrupt
-struct CUR_WITHOUT_G_F CurHalfCycInstSOSsav @".sram2";
+struct CUR_WITHOUT_G_F CurHalfCycInstSOSsav SRAM2_LOC;
 float Inst_Pickup;
 float SD_HalfCycPickup, SD_OneCycPickup, SD_OneCyc_8x;
 float SD_InterlockPickup;
-float SD_Tally @".sram2";
-float SD_TripThresholdI2t @".sram2";
+float SD_Tally SRAM2_LOC;
+float SD_TripThresholdI2t SRAM2_LOC;
 float GF_HalfCycPickup, GF_OneCycPickup, GF_OneCyc_8x;
-float GF_Tally @".sram2";
-float GF_TallyDecr @".sram2";
-float GF_OneCyc_0p625 @".sram2";
-float GF_TripThresholdI2t @".sram2";
+float GF_Tally SRAM2_LOC;
+float GF_TallyDecr SRAM2_LOC;
+float GF_OneCyc_0p625 SRAM2_LOC;
+float GF_TripThresholdI2t SRAM2_LOC;
 float LD_OneCycPickup;
-float LD_Tally @".sram2";
-float LD_TripThreshold @".sram2";
-float LD_TallyIncr @".sram2";
-float LD_TallyDecr @".sram2";
-float PA_TripThreshold @".sram2";
-float PB_TripThreshold @".sram2";
+float LD_Tally SRAM2_LOC;
+float LD_TripThreshold SRAM2_LOC;
+float LD_TallyIncr SRAM2_LOC;
+float LD_TallyDecr SRAM2_LOC;
+float PA_TripThreshold SRAM2_LOC;
+float PB_TripThreshold SRAM2_LOC;
 float PBdelay_Trip;
-float Ir @".sram2";
-float Ir_02 @".sram2";
-float GF_In @".sram2";
+float Ir SRAM2_LOC;
+float Ir_02 SRAM2_LOC;
+float GF_In SRAM2_LOC;
 
 float LD_Bucket;
 float LD_BucketMax;
@@ -517,24 +530,24 @@ struct FW_SIMULATED_TEST FW_SimulatedTest;
 struct HW_SEC_INJ_TEST HW_SecInjTest;
 struct COIL_DETECT CoilDetect;
 
-uint32_t SD_Passes @".sram2";         // uint32 needed for I2t
-uint16_t LD_Passes @".sram2";
-uint32_t GF_Passes @".sram2";         // uint32 needed for I2t
-uint16_t PB_Passes @".sram2";
-uint16_t SD_TripThresholdFlat @".sram2";
-uint16_t GF_TripThresholdFlat @".sram2";
-uint8_t Inst_State @".sram2";
-uint8_t Inst_SamplePasses @".sram2";
-uint8_t Inst_HalfCycPasses @".sram2";
-uint8_t SD_State @".sram2";
-uint8_t SD_Slope @".sram2";
-uint8_t LD_State @".sram2";
-uint8_t LD_Slope @".sram2";
-uint8_t GF_State @".sram2";
-uint8_t GF_Slope @".sram2";
-uint8_t ST_MM_On @".sram2";
-uint8_t MM_HiLo_Gain @".sram2";
-uint8_t DB_HiLo_Gain @".sram2"; 
+uint32_t SD_Passes SRAM2_LOC;         // uint32 needed for I2t
+uint16_t LD_Passes SRAM2_LOC;
+uint32_t GF_Passes SRAM2_LOC;         // uint32 needed for I2t
+uint16_t PB_Passes SRAM2_LOC;
+uint16_t SD_TripThresholdFlat SRAM2_LOC;
+uint16_t GF_TripThresholdFlat SRAM2_LOC;
+uint8_t Inst_State SRAM2_LOC;
+uint8_t Inst_SamplePasses SRAM2_LOC;
+uint8_t Inst_HalfCycPasses SRAM2_LOC;
+uint8_t SD_State SRAM2_LOC;
+uint8_t SD_Slope SRAM2_LOC;
+uint8_t LD_State SRAM2_LOC;
+uint8_t LD_Slope SRAM2_LOC;
+uint8_t GF_State SRAM2_LOC;
+uint8_t GF_Slope SRAM2_LOC;
+uint8_t ST_MM_On SRAM2_LOC;
+uint8_t MM_HiLo_Gain SRAM2_LOC;
+uint8_t DB_HiLo_Gain SRAM2_LOC; 
 
 uint8_t SD_StartupSampleCnt, GF_StartupSampleCnt;
 
@@ -1322,25 +1335,39 @@ void OverrideTrip(void)
     if (Setpoints0.stp.MM_Enable > 0)                     // Maintenance mode is on
     {
       MM_TripFlg = 1;
+#ifdef ENABLE_EVENT_QUEUE
+      InsertNewEvent(TRIP_MAINTANENCE_MODE_ARMS);
+#else
       IntEventBuf[IntEventInNdx].Code = TRIP_MAINTANENCE_MODE_ARMS;
+#endif
     }
     else if (OpenFlg == 1)                                // Breaker was open or closing into a fault
     {
       McrTripFlg = 1;
+#ifdef ENABLE_EVENT_QUEUE
+      InsertNewEvent(TRIP_MCR);
+#else
       IntEventBuf[IntEventInNdx].Code = TRIP_MCR;
+#endif
     }
     else                                                  // Override trip
     {
       HWInstTripFlg = 1;
+#ifdef ENABLE_EVENT_QUEUE
+      InsertNewEvent(TRIP_OVERRIDE);
+#else
       IntEventBuf[IntEventInNdx].Code = TRIP_OVERRIDE;
+#endif
     }
 
+#ifndef ENABLE_EVENT_QUEUE
     Get_InternalTime(&IntEventBuf[IntEventInNdx++].TS);
     IntEventInNdx &= 0x07;
     if (IntEventInNdx == IntEventOutNdx)
     {
       IntEventBufFull |= TRUE;
     }                                        // *** BP - determine trip flags from Ovr Micro comms
+#endif
   }
 //  TripReqFlg  = 1;
   BellTripFlg = 1;                            // Set general trip cause flag
@@ -1578,6 +1605,9 @@ void Instantaneous_Prot(void)
           TA_Timer = 24;
           AlarmHoldOffTmr = 200;        // Hold off alarm functions for 2s
           // Put an entry into the new event FIFO (for interrupts)
+#ifdef ENABLE_EVENT_QUEUE
+          InsertNewEvent(TRIP_INSTANTANEOUS);
+#else
           IntEventBuf[IntEventInNdx].Code = TRIP_INSTANTANEOUS;
           Get_InternalTime(&IntEventBuf[IntEventInNdx++].TS);
           IntEventInNdx &= 0x07;
@@ -1585,6 +1615,7 @@ void Instantaneous_Prot(void)
           {
             IntEventBufFull |= TRUE;
           }
+#endif
 //          Inst_Pickup = 4.0E9;      // *** DAH ADDED FOR TEST
           InstTripFlg = 1;
           TripReqFlg  = 1;
@@ -1786,6 +1817,9 @@ void ShortDelay_Prot(void)
         if (Setpoints1.stp.SD_EventAction == 1)
         {
           // Put an entry into the new event FIFO (for interrupts)
+#ifdef ENABLE_EVENT_QUEUE
+          InsertNewEvent(SDPU_ENTRY);
+#else
           IntEventBuf[IntEventInNdx].Code = SDPU_ENTRY;
           Get_InternalTime(&IntEventBuf[IntEventInNdx++].TS);
           IntEventInNdx &= 0x07;
@@ -1793,6 +1827,7 @@ void ShortDelay_Prot(void)
           {
             IntEventBufFull |= TRUE;
           }         
+#endif
           Dist_Flag_SD = TRUE;                             // Initiate a disturbance capture
           // ***DAH  NOT SURE WHETHER WE WANT TO INITIATE A GOOSE GLOBAL CAPTURE
         }
@@ -1868,6 +1903,9 @@ void ShortDelay_Prot(void)
             // Note, we don't need to compute event currents here because, we will have one-cycle values,
             //   since the trip time is 2 cycles
             // Put an entry into the new event FIFO (for interrupts)
+#ifdef ENABLE_EVENT_QUEUE
+            InsertNewEvent(TRIP_SHORT_DELAY);
+#else
             IntEventBuf[IntEventInNdx].Code = TRIP_SHORT_DELAY;
             Get_InternalTime(&IntEventBuf[IntEventInNdx++].TS);
             IntEventInNdx &= 0x07;
@@ -1875,6 +1913,7 @@ void ShortDelay_Prot(void)
             {
               IntEventBufFull |= TRUE;
             }
+#endif
             TA_Timer = 24;
             AlarmHoldOffTmr = 200;        // Hold off alarm functions for 2s
             SdTripFlg = 1;
@@ -1933,6 +1972,9 @@ void ShortDelay_Prot(void)
             TESTPIN_A3_HIGH;                      // *** DAH TEST FOR COLD START TESTING
 #endif
             // Put an entry into the new event FIFO (for interrupts)
+#ifdef ENABLE_EVENT_QUEUE
+            InsertNewEvent(TRIP_SHORT_DELAY);
+#else
             IntEventBuf[IntEventInNdx].Code = TRIP_SHORT_DELAY;
             Get_InternalTime(&IntEventBuf[IntEventInNdx++].TS);
             IntEventInNdx &= 0x07;
@@ -1940,6 +1982,7 @@ void ShortDelay_Prot(void)
             {
               IntEventBufFull |= TRUE;
             }
+#endif
             TA_Timer = 24;
             AlarmHoldOffTmr = 200;        // Hold off alarm functions for 2s
             SdTripFlg = 1;
@@ -1999,6 +2042,9 @@ void ShortDelay_Prot(void)
             TESTPIN_A3_HIGH;                      // *** DAH TEST FOR COLD START TESTING
 #endif
             // Put an entry into the new event FIFO (for interrupts)
+#ifdef ENABLE_EVENT_QUEUE
+            InsertNewEvent(TRIP_SHORT_DELAY);
+#else
             IntEventBuf[IntEventInNdx].Code = TRIP_SHORT_DELAY;
             Get_InternalTime(&IntEventBuf[IntEventInNdx++].TS);
             IntEventInNdx &= 0x07;
@@ -2006,6 +2052,7 @@ void ShortDelay_Prot(void)
             {
               IntEventBufFull |= TRUE;
             }
+#endif
             TA_Timer = 24;
             AlarmHoldOffTmr = 200;        // Hold off alarm functions for 2s
             SdTripFlg = 1;
@@ -2523,6 +2570,9 @@ void Long_IEE_IEC_Prot(void)
             TA_TRIP_ACTIVE;
           }
           // Put an entry into the new event FIFO (for interrupts)
+#ifdef ENABLE_EVENT_QUEUE
+          InsertNewEvent(TRIP_LONG_DELAY);
+#else
           IntEventBuf[IntEventInNdx].Code = TRIP_LONG_DELAY;
           Get_InternalTime(&IntEventBuf[IntEventInNdx++].TS);
           IntEventInNdx &= 0x07;
@@ -2530,6 +2580,7 @@ void Long_IEE_IEC_Prot(void)
           {
             IntEventBufFull |= TRUE;
           }   
+#endif
           TA_Timer = 24;          
           AlarmHoldOffTmr = 200;        // Hold off alarm functions for 2s
           LdTripFlg = 1;
@@ -2698,6 +2749,9 @@ void Ground_Fault_Prot(void)
         if (CurIgOneCycSOS >= GF_OneCycPickup)
         {
           // Put an entry into the new event FIFO (for interrupts)
+#ifdef ENABLE_EVENT_QUEUE
+          InsertNewEvent(GF_PICKUP);
+#else
           IntEventBuf[IntEventInNdx].Code = GF_PICKUP;
           Get_InternalTime(&IntEventBuf[IntEventInNdx++].TS);
           IntEventInNdx &= 0x07;
@@ -2705,6 +2759,7 @@ void Ground_Fault_Prot(void)
           {
             IntEventBufFull |= TRUE;
           }         
+#endif
         }
       }
       else
@@ -2756,6 +2811,9 @@ void Ground_Fault_Prot(void)
             TA_Timer = 24;
             AlarmHoldOffTmr = 200;        // Hold off alarm functions for 2s
             // Put an entry into the new event FIFO (for interrupts)
+#ifdef ENABLE_EVENT_QUEUE
+            InsertNewEvent(TRIP_GROUND_FAULT);
+#else
             IntEventBuf[IntEventInNdx].Code = TRIP_GROUND_FAULT;
             Get_InternalTime(&IntEventBuf[IntEventInNdx++].TS);
             IntEventInNdx &= 0x07;
@@ -2763,6 +2821,7 @@ void Ground_Fault_Prot(void)
             {
               IntEventBufFull |= TRUE;
             }            
+#endif
             GndTripFlg = 1;
             TripReqFlg  = 1;
             BellTripFlg = 1;                             // Set general trip cause flag
@@ -2817,6 +2876,9 @@ void Ground_Fault_Prot(void)
             TA_Timer = 24;
             AlarmHoldOffTmr = 200;        // Hold off alarm functions for 2s
             // Put an entry into the new event FIFO (for interrupts)
+#ifdef ENABLE_EVENT_QUEUE
+            InsertNewEvent(TRIP_GROUND_FAULT);
+#else
             IntEventBuf[IntEventInNdx].Code = TRIP_GROUND_FAULT;
             Get_InternalTime(&IntEventBuf[IntEventInNdx++].TS);
             IntEventInNdx &= 0x07;
@@ -2824,6 +2886,7 @@ void Ground_Fault_Prot(void)
             {
               IntEventBufFull |= TRUE;
             } 
+#endif
             GndTripFlg = 1;
             BellTripFlg = 1;                             // Set general trip cause flag
             TripReqFlg = 1;                              // *** BP may not need this
@@ -2879,6 +2942,9 @@ void Ground_Fault_Prot(void)
             TA_Timer = 24;
             AlarmHoldOffTmr = 200;        // Hold off alarm functions for 2s
             // Put an entry into the new event FIFO (for interrupts)
+#ifdef ENABLE_EVENT_QUEUE
+            InsertNewEvent(TRIP_GROUND_FAULT);
+#else
             IntEventBuf[IntEventInNdx].Code = TRIP_GROUND_FAULT;
             Get_InternalTime(&IntEventBuf[IntEventInNdx++].TS);
             IntEventInNdx &= 0x07;
@@ -2886,6 +2952,7 @@ void Ground_Fault_Prot(void)
             {
               IntEventBufFull |= TRUE;
             } 
+#endif
             GndTripFlg = 1;
             BellTripFlg = 1;                             // Set general trip cause flag
             TripReqFlg = 1;                              // *** BP may not need this
@@ -5114,6 +5181,9 @@ void Ground_Fault_PreAlarm(void)
       if (TU_State_TestUSBMode == 1)               // If in test mode, insert summary event
       {
         // Put an entry into the new event FIFO (for interrupts)
+#ifdef ENABLE_EVENT_QUEUE
+        InsertNewEvent(ALARM_GND_FAULT_PRE_TEST);
+#else
         IntEventBuf[IntEventInNdx].Code = ALARM_GND_FAULT_PRE_TEST;
         Get_InternalTime(&IntEventBuf[IntEventInNdx++].TS);
         IntEventInNdx &= 0x07;
@@ -5121,11 +5191,15 @@ void Ground_Fault_PreAlarm(void)
         {
           IntEventBufFull |= TRUE;
         }         
+#endif
       }
       else                                         // Otherwise it is an alarm event, so initiate
       {                                            //   capture and insert event
         A_Scope_Req = 1;
         // Put an entry into the new event FIFO (for interrupts)
+#ifdef ENABLE_EVENT_QUEUE
+        InsertNewEvent(ALARM_GND_FAULT_PRE);
+#else
         IntEventBuf[IntEventInNdx].Code = ALARM_GND_FAULT_PRE;
         Get_InternalTime(&IntEventBuf[IntEventInNdx++].TS);
         IntEventInNdx &= 0x07;
@@ -5133,6 +5207,7 @@ void Ground_Fault_PreAlarm(void)
         {
           IntEventBufFull |= TRUE;
         }         
+#endif
       }
     }
   }
@@ -5276,6 +5351,9 @@ void Ground_Fault_Alarm(void)
               GF_State = 0;
               A_Scope_Req = 1;        // Start oscillographic capture
               // Put an entry into the new event FIFO (for interrupts)
+#ifdef ENABLE_EVENT_QUEUE
+              InsertNewEvent(ALARM_GROUND_FAULT);
+#else
               IntEventBuf[IntEventInNdx].Code = ALARM_GROUND_FAULT;
               Get_InternalTime(&IntEventBuf[IntEventInNdx++].TS);
               IntEventInNdx &= 0x07;
@@ -5283,6 +5361,7 @@ void Ground_Fault_Alarm(void)
               {
                 IntEventBufFull |= TRUE;
               }         
+#endif
             }
           }
         }
@@ -5300,6 +5379,9 @@ void Ground_Fault_Alarm(void)
               GF_State = 0;
               A_Scope_Req = 1;        // Start oscillographic capture
               // Put an entry into the new event FIFO (for interrupts)
+#ifdef ENABLE_EVENT_QUEUE
+              InsertNewEvent(ALARM_GROUND_FAULT);
+#else
               IntEventBuf[IntEventInNdx].Code = ALARM_GROUND_FAULT;
               Get_InternalTime(&IntEventBuf[IntEventInNdx++].TS);
               IntEventInNdx &= 0x07;
@@ -5307,6 +5389,7 @@ void Ground_Fault_Alarm(void)
               {
                 IntEventBufFull |= TRUE;
               }         
+#endif
             }
           }
         }
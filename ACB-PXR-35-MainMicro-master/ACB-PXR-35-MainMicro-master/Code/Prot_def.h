@@ -63,6 +63,9 @@
 //   141    240115  BP  - Added T_forbid flag for Sec Inj and Coil Detection
 //                      - Changed some of the Auxiliary (Electrical) alarms 
 //   148    240132  BP  - Added AuxVoltValid flag bit
+//   173    240225  DAH - Added the protection element table definitions (PROT_xx), struct PROT_ELEM_DEF,
+//                        struct PROT_ELEM, and struct PROT_ELEM_LIST
+//   179    240302  DAH - Deleted the protection element table definitions (ENABLE_PROT_TABLE deleted)
 //------------------------------------------------------------------------------------------------------------
 //
 //------------------------------------------------------------------------------------------------------------
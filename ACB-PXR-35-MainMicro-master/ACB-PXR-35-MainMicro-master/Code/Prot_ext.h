@@ -69,6 +69,9 @@
 //                      - Deleted Break_Config_Default, SD_StartupSampleCnt, and GF_StartupSampleCnt
 //                        declarations
 //                      - Added struct EventCurOneCyc and float EventCurOneCycIg declarations
+//    173   240225  DAH - Added ProtTripList, ProtAlarmList, PROT_TRIP_DEF[], PROT_ALARM_DEF[],
+//                        ProtElem_Build(), and ProtElem_Eval() declarations (ENABLE_PROT_TABLE defined)
+//    179   240302  DAH - Deleted the protection element declarations (ENABLE_PROT_TABLE deleted)
 //
 //------------------------------------------------------------------------------------------------------------
 //
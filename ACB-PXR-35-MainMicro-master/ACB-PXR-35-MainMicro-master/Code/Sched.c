@@ -0,0 +1,402 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//
+//  MODULE NAME:        Sched.c
+//
+//  MECHANICS:          Program module containing the main loop task scheduler.  The main loop work is
+//                      divided into tasks (Sched_def.h), and each task is divided into slices.  A slice is a
+//                      group of subroutine calls that runs to completion, and is the point at which a task
+//                      yields to the scheduler.  Each time Sched_Run() is called, it releases any tasks that
+//                      are due and runs one slice of the highest-priority task that is ready.  Since no slice
+//                      is longer than its budget, a high-priority task (for example, the one-cycle
+//                      anniversary) never waits more than one slice, rather than a full pass through the
+//                      main loop.
+//                      The scheduler is cooperative: the state-machine subroutines (Calc_Harmonics(),
+//                      EventManager(), ModB_SlaveComm(), etc.) already return after each step, so each call
+//                      is placed in a slice.  Nothing is preempted, so no new locking is needed.
+//                      For each task, the number of passes and slices, the slices that overran their budget,
+//                      the passes that missed their deadline, and the maximum slice and response times are
+//                      kept in SchedStat[].  These may be read with the test port "SS" command (reset with
+//                      the "SR" command).
+//                      The task table is supplied to Sched_Init().  The main loop table is in main.c.  The
+//                      scheduler is only compiled in if ENABLE_MAIN_SCHED is defined in Iod_def.h.  It also
+//                      runs in the host build, where the schedule is simulated (see Replay_SchedSim()).
+//
+//  TARGET HARDWARE:    PXR35 Rev 1 and later boards
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   161    240213  DAH File Creation
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+// Path for library files:
+//   IAR Systems\Embedded Workbench 8.3\arm\inc\c
+//
+//------------------------------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------------------------------
+//                   Definitions
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global Definitions from external files...
+//
+#include "stm32f4xx.h"
+#include "stm32f407xx.h"
+#include "RealTime_def.h"
+#include "Iod_def.h"
+#include "Sched_def.h"
+
+#ifdef ENABLE_MAIN_SCHED
+
+//
+//      Local Definitions used in this module...
+//
+
+
+//
+//      Global Declarations from external files...
+//
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global (Visible) Function Prototypes (These functions are called by other modules)
+//
+void Sched_Init(const struct SCHED_TASK *tasks);
+void Sched_Reset(void);
+void Sched_Run(void);
+
+
+//      Local Function Prototypes (These functions are called only within this module)
+//
+void Sched_ClearStats(void);
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Storage Allocation - Global (Static) Variables
+//------------------------------------------------------------------------------------------------------------
+//
+//       These variables are used by other modules...
+//
+struct SCHED_STAT SchedStat[SCHED_NUM_TASKS];
+
+
+//       These variables are used only in this module...
+//
+const struct SCHED_TASK *SchedTask;
+
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Global Constants used in this module and other modules
+//------------------------------------------------------------------------------------------------------------
+//
+// Task names for the test port display.  These must be in the same order as the task definitions in
+//   Sched_def.h, and must be no longer than 10 characters
+const char * const SCHED_TASK_NAME[SCHED_NUM_TASKS] =
+{
+  "SPI1 flags", "1cyc", "200msec", "1sec", "5min", "Background"
+};
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Sched_Init()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Scheduler Initialization
+//
+//  MECHANICS:          This subroutine saves the task table, enables the DWT cycle counter, and clears the
+//                      task states and statistics.  The periodic tasks are released the first time
+//                      Sched_Run() is called.  The cycle counter is in the debug block, so trace must be
+//                      enabled (TRCENA) before it can be used.
+//
+//  CAVEATS:            Called at the end of initialization, just before the main loop.  tasks[] must have
+//                      SCHED_NUM_TASKS entries, in priority order
+//
+//  INPUTS:             tasks - the task table
+//
+//  OUTPUTS:            SchedTask, SchedStat[]
+//
+//  ALTERS:             CoreDebug->DEMCR, DWT->CTRL
+//
+//  CALLS:              Sched_ClearStats()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Sched_Init(const struct SCHED_TASK *tasks)
+{
+  uint8_t i;
+  uint32_t now;
+
+  SchedTask = tasks;
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  now = SCHED_CYCCNT();
+  for (i = 0; i < SCHED_NUM_TASKS; ++i)
+  {
+    SchedStat[i].Slice = 0;
+    SchedStat[i].Active = FALSE;
+    SchedStat[i].ReleaseCyc = now - SchedTask[i].Period;
+  }
+  Sched_ClearStats();
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Sched_Init()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Sched_Reset()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Reset Scheduler Statistics
+//
+//  MECHANICS:          This subroutine clears the statistics for all of the tasks.  The task states are not
+//                      changed.
+//
+//  CAVEATS:            The statistics are only written in the main loop, so interrupts do not need to be
+//                      disabled
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            SchedStat[]
+//
+//  ALTERS:             None
+//
+//  CALLS:              Sched_ClearStats()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Sched_Reset(void)
+{
+  Sched_ClearStats();
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Sched_Reset()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Sched_ClearStats()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Clear Scheduler Statistics
+//
+//  MECHANICS:          This subroutine clears the counts and the maximum times for all of the tasks.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            SchedStat[]
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Sched_ClearStats(void)
+{
+  uint8_t i;
+
+  for (i = 0; i < SCHED_NUM_TASKS; ++i)
+  {
+    SchedStat[i].Passes = 0;
+    SchedStat[i].Slices = 0;
+    SchedStat[i].Overruns = 0;
+    SchedStat[i].Misses = 0;
+    SchedStat[i].MaxSlice = 0;
+    SchedStat[i].MaxResponse = 0;
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Sched_ClearStats()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Sched_Run()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Run the Scheduler
+//
+//  MECHANICS:          This subroutine is the body of the main loop.  It does the following:
+//                        1) Releases the tasks that are due.  A task that is not active is released if:
+//                             - it has an anniversary flag and the flag is set.  The flag is cleared, so
+//                               that an anniversary that occurs while the task is running is not lost
+//                             - it has a period and the period has elapsed since it was last released
+//                             - it has neither (the background task)
+//                           The release time is saved.  Since the anniversary flags are set in interrupts,
+//                           the release time of an anniversary task is when the flag was seen, which is at
+//                           most one slice after it was set
+//                        2) Runs the next slice of the highest-priority (lowest-numbered) active task, and
+//                           measures its time.  If the slice took longer than the budget, the overrun count
+//                           is incremented
+//                        3) If that was the last slice, the task is made inactive, and the response time
+//                           (release to the end of the last slice) is checked against the deadline
+//
+//  CAVEATS:            The slice times include the time spent in any interrupts that occur during the slice
+//
+//  INPUTS:             SchedTask[], SCHED_CYCCNT()
+//
+//  OUTPUTS:            SchedStat[]
+//
+//  ALTERS:             The anniversary flags in SchedTask[]
+//
+//  CALLS:              SchedTask[].Slice()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Sched_Run(void)
+{
+  const struct SCHED_TASK *tptr;
+  struct SCHED_STAT *sptr;
+  uint32_t now, dt;
+  uint8_t i, done;
+
+  // Release the tasks that are due
+  now = SCHED_CYCCNT();
+  for (i = 0; i < SCHED_NUM_TASKS; ++i)
+  {
+    tptr = &SchedTask[i];
+    sptr = &SchedStat[i];
+    if (!sptr->Active)
+    {
+      if (tptr->Anniv != 0)
+      {
+        if (*tptr->Anniv)
+        {
+          *tptr->Anniv = FALSE;
+          sptr->Active = TRUE;
+          sptr->ReleaseCyc = now;
+        }
+      }
+      else if (tptr->Period != 0)
+      {
+        if ((now - sptr->ReleaseCyc) >= tptr->Period)
+        {
+          sptr->Active = TRUE;
+          sptr->ReleaseCyc = now;
+        }
+      }
+      else
+      {
+        sptr->Active = TRUE;
+        sptr->ReleaseCyc = now;
+      }
+    }
+  }
+
+  // Find the highest-priority active task.  If there isn't one, just exit
+  for (i = 0; i < SCHED_NUM_TASKS; ++i)
+  {
+    if (SchedStat[i].Active)
+    {
+      break;
+    }
+  }
+  if (i >= SCHED_NUM_TASKS)
+  {
+    return;
+  }
+  tptr = &SchedTask[i];
+  sptr = &SchedStat[i];
+
+  // Run the next slice and update the statistics
+  now = SCHED_CYCCNT();
+  done = tptr->Slice(sptr->Slice);
+  dt = SCHED_CYCCNT() - now;
+  if (sptr->Slices < 0xFFFFFFFF)
+  {
+    sptr->Slices++;
+  }
+  if (dt > sptr->MaxSlice)
+  {
+    sptr->MaxSlice = dt;
+  }
+  if ((dt > tptr->Budget) && (sptr->Overruns < 0xFFFFFFFF))
+  {
+    sptr->Overruns++;
+  }
+
+  if (done)                             // If this was the last slice, the pass is done
+  {
+    sptr->Active = FALSE;
+    sptr->Slice = 0;
+    dt = (now + dt) - sptr->ReleaseCyc;
+    if (dt > sptr->MaxResponse)
+    {
+      sptr->MaxResponse = dt;
+    }
+    if ((dt > tptr->Deadline) && (sptr->Misses < 0xFFFFFFFF))
+    {
+      sptr->Misses++;
+    }
+    if (sptr->Passes < 0xFFFFFFFF)
+    {
+      sptr->Passes++;
+    }
+  }
+  else                                  // Otherwise set up for the next slice
+  {
+    sptr->Slice++;
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Sched_Run()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_MAIN_SCHED
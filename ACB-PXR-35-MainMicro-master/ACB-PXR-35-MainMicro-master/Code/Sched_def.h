@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//
+//  MODULE NAME:        Sched_def.h
+//
+//  MECHANICS:          This is the definitions file for the Sched.c module.  It must be preceded by
+//                      Iod_def.h, since the scheduler is only compiled in if ENABLE_MAIN_SCHED is defined
+//
+//  TARGET HARDWARE:    PXR35 Rev 1 and later boards
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   161    240213  DAH File Creation
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+// Path for library files:
+//   IAR Systems\Embedded Workbench 8.3\arm\inc\c
+//
+//------------------------------------------------------------------------------------------------------------
+
+#ifndef SCHED_DEF_H
+#define SCHED_DEF_H
+
+//
+//------------------------------------------------------------------------------------------------------------
+//    Constants
+//------------------------------------------------------------------------------------------------------------
+
+// Scheduled tasks.  The task number is the priority: when more than one task is ready, the lowest-numbered
+//   task runs its next slice.  The background task is always ready, so it runs whenever no other task is
+#define SCHED_SPI1              0           // SPI1 flags, TA voltage, and aux power monitoring
+#define SCHED_ONECYC            1           // One-cycle anniversary (OneCycAnniv)
+#define SCHED_200MSEC           2           // 200msec anniversary (msec200Anniv)
+#define SCHED_1SEC              3           // 1sec anniversary (OneSecAnniv)
+#define SCHED_5MIN              4           // 5min anniversary (min5Anniv)
+#define SCHED_BACKGROUND        5           // Code that is run each time through the main loop
+#define SCHED_NUM_TASKS         6
+
+// Scheduler times, in core clock cycles (120MHz)
+#define SCHED_CYC_PER_USEC      120
+#define SCHED_USEC(x)           ((uint32_t)(x) * SCHED_CYC_PER_USEC)
+
+// Task periods.  The 1.5msec timer flags must be serviced about every 3msec.  A task may have to wait for
+//   the longest slice of another task (1.3msec) after it is released, so the SPI1 flags are released every
+//   1msec.  The anniversary tasks are released by their anniversary flags, so they have no period
+#define SCHED_SPI1_PERIOD       SCHED_USEC(1000)
+
+// Task deadlines.  This is the maximum time from when a task is released until its last slice is done.
+//   The one-cycle deadline is one 60Hz cycle.  The background deadline is the target main loop time
+#define SCHED_SPI1_DEADLINE     SCHED_USEC(1500)
+#define SCHED_ONECYC_DEADLINE   SCHED_USEC(16667)
+#define SCHED_200MSEC_DEADLINE  SCHED_USEC(200000)
+#define SCHED_1SEC_DEADLINE     SCHED_USEC(1000000)
+#define SCHED_5MIN_DEADLINE     SCHED_USEC(1000000)
+#define SCHED_BKGND_DEADLINE    SCHED_USEC(10000)
+
+// Slice budgets.  This is the maximum time for one slice of a task.  A slice that runs longer is counted as
+//   an overrun.  The worst-case delay before a ready task runs is the longest slice of any task, so the
+//   budgets are what bound the main loop jitter.  RelayManagement() (1.3msec max) sets the background
+//   budget
+#define SCHED_SPI1_BUDGET       SCHED_USEC(100)
+#define SCHED_ONECYC_BUDGET     SCHED_USEC(1000)
+#define SCHED_200MSEC_BUDGET    SCHED_USEC(1000)
+#define SCHED_1SEC_BUDGET       SCHED_USEC(1000)
+#define SCHED_5MIN_BUDGET       SCHED_USEC(1000)
+#define SCHED_BKGND_BUDGET      SCHED_USEC(1500)
+
+// Cycle counter.  On the target this is the DWT cycle counter, which runs at the core clock.  In the host
+//   build, Host_CycCnt() returns the elapsed time scaled to 120MHz cycles (or the simulated time, see
+//   Replay_SchedSim())
+#ifdef HOST_BUILD
+  #define SCHED_CYCCNT()        Host_CycCnt()
+#else
+  #define SCHED_CYCCNT()        (DWT->CYCCNT)
+#endif
+
+//
+//------------------------------------------------------------------------------------------------------------
+//    Structures
+//------------------------------------------------------------------------------------------------------------
+//
+// Task definition.  A task is released either by an anniversary flag (Anniv), by its period (Period), or,
+//   if neither is given, as soon as its previous pass is done.  Once released, the task runs one slice each
+//   time it is the highest-priority ready task.  Slice() is called with the slice number (0, 1, 2, ...),
+//   and returns TRUE when the last slice of the pass is done.  Times are in core clock cycles
+struct SCHED_TASK
+{
+  uint8_t (*Slice)(uint8_t slice);          // Runs one slice of the task
+  uint8_t *Anniv;                           // Anniversary flag that releases the task, or 0
+  uint32_t Period;                          // Release period, or 0
+  uint32_t Deadline;                        // Max time from release to the end of the last slice
+  uint32_t Budget;                          // Max time for one slice
+};
+
+// Task statistics.  Times are in core clock cycles.  The counts saturate rather than roll over
+struct SCHED_STAT
+{
+  uint32_t Passes;                          // Number of completed passes
+  uint32_t Slices;                          // Number of slices run
+  uint32_t Overruns;                        // Number of slices that were longer than the budget
+  uint32_t Misses;                          // Number of passes that were done after the deadline
+  uint32_t MaxSlice;                        // Max time for one slice
+  uint32_t MaxResponse;                     // Max time from release to the end of the last slice
+  uint32_t ReleaseCyc;                      // Cycle count when the present pass was released
+  uint8_t Slice;                            // Next slice to run
+  uint8_t Active;                           // TRUE if the task has been released and is not done
+};
+
+#endif                  // SCHED_DEF_H
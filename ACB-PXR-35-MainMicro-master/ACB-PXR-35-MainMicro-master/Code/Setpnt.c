@@ -96,6 +96,12 @@
 //                        Increased Long Delay Time default to 200 to account for 100x change in rev 138.
 //   149    240131  DAH - In Verify_Setpoints() revised check of Demand Logging Interval to distinguish
 //                        between fixed and sliding windows
+//   167    240219  DAH - In Check_Setpoints() revised the setpoints error event to call InsertNewEvent() if
+//                        ENABLE_EVENT_QUEUE is defined
+//   173    240225  DAH - Load_SetpGr2_LastGr() and Check_Setpoints() revised to rebuild the protection
+//                        element lists (ENABLE_PROT_TABLE defined)
+//   179    240302  DAH - Load_SetpGr2_LastGr() and Check_Setpoints() no longer rebuild the protection
+//                        element lists (ENABLE_PROT_TABLE deleted)
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -1839,10 +1845,14 @@ void Check_Setpoints(uint8_t group)
   else if ( (SystemFlags & FRAME_FRAM_ERR) == 0)
   {
     SystemFlags |= FRAME_FRAM_ERR;
+#ifdef ENABLE_EVENT_QUEUE
+    InsertNewEvent(STP_ERROR);
+#else
     NewEventFIFO[NewEventInNdx].Code = STP_ERROR;
     Get_InternalTime(&NewEventFIFO[NewEventInNdx].TS);
     NewEventFIFO[NewEventInNdx++].EID = EventMasterEID++;
     NewEventInNdx &= 0x0F;                                        // Note, FIFO size must be 16!!
+#endif
   }
 
 }
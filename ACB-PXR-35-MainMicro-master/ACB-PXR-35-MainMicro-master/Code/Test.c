@@ -580,6 +580,31 @@
 //                      - Fixed minor bugs in Load_ExecuteAction_struct(), Cal_Gain_AFE(), Cal_Gain_HG(),
 //                        and Cal_Gain_LG()
 //    149   240131  DAH - Fixed minor bugs in Cal_Offset_HG() and Cal_Offset_LG()
+//    155   240207  DAH - Added test port commands to display ("PF") and reset ("PR") the stage profiler
+//                        statistics.  The commands are only included if ENABLE_STAGE_PROFILER is defined
+//                          - TP_Top() revised
+//                          - TP_DisplayProfile() added
+//    161   240213  DAH - Added test port commands to display ("SS") and reset ("SR") the main loop scheduler
+//                        statistics.  The commands are only included if ENABLE_MAIN_SCHED is defined
+//                          - TP_Top() revised
+//                          - TP_DisplaySched() added
+//    162   240214  DAH - Added test port commands to display ("DL") and reset ("RL") the main loop trace.
+//                        The commands are only included if ENABLE_LOOP_TRACE is defined
+//                          - TP_Top() revised
+//                          - TP_DisplayTrace() added
+//    165   240217  DAH - Revised TP_DisplayWF() to read the coded waveforms 7 samples at a time if
+//                        ENABLE_WF_CODEC is defined
+//    178   240301  DAH - Apply_CalConstants() is called whenever the AFE or ADC cal constants are changed,
+//                        since it is no longer called every 200msec:
+//                          - TP_Top() calls it in state TP_WR_CAL
+//                          - TP_OffsetCal() calls it after the offset of the channel is set to 0
+//                          - TP_AFESetPGA() calls it after the AFE gain cal constants are adjusted
+//                          - The Execute Action calibration subroutines (Cal_Offset_xx(), Cal_Gain_xx())
+//                            call it after the offsets are set to 0 and after the new constants are
+//                            computed
+//                          - Write_Default_Cal() calls it after the default constants are written
+//    179   240302  DAH - TP_ModifyCal() calls Apply_CalConstants() as soon as a new gain or offset is
+//                        entered, since the user may quit without writing the constants to FRAM
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -626,6 +651,10 @@
 #include "main_def.h"
 #include "Flags_def.h"
 #include "Prot_def.h"
+#include "Profile_def.h"
+#include "Sched_def.h"
+#include "Trace_def.h"
+#include "WfCodec_def.h"
 
 
 //
@@ -740,6 +769,21 @@ enum TP_DisplayInternalTiming_States
   TP_DS0, TP_DS1, TP_DS2, TP_DS3, TP_DS4
 };
 
+enum TP_DisplayProfile_States
+{
+  TP_PF0, TP_PF1, TP_PF2, TP_PF3, TP_PF4, TP_PF5, TP_PF6
+};
+
+enum TP_DisplaySched_States
+{
+  TP_SS0, TP_SS1, TP_SS2, TP_SS3, TP_SS4
+};
+
+enum TP_DisplayTrace_States
+{
+  TP_DL0, TP_DL1, TP_DL2, TP_DL3, TP_DL4, TP_DL5, TP_DL6, TP_DL7, TP_DL8
+};
+
 enum DisplayMemory_States 
 {
   TP_DM0, TP_DM1_0, TP_DM1_1, TP_DM1_2, TP_DM1_3, TP_DM2_0, TP_DM2_1, TP_DM2_2, TP_DM2_3, TP_DM3_0,
@@ -806,6 +850,9 @@ enum DisplayFWversion_States
 #include "Setpnt_ext.h"
 #include "Ovrcom_ext.h"
 #include "Prot_ext.h"
+#include "Profile_ext.h"
+#include "Sched_ext.h"
+#include "Trace_ext.h"
 
 
 //      Global (Visible) Function Prototypes (These functions are called by other modules)
@@ -856,6 +903,9 @@ void TP_ParseFloat(uint8_t TPindex, uint16_t SPIindex);
 uint16_t TP_PutSpace(uint8_t Num, uint16_t TP_Index);
 void TP_ParseEventsTable(uint32_t index);
 void TP_DisplayStartup(void);
+void TP_DisplayProfile(void);
+void TP_DisplaySched(void);
+void TP_DisplayTrace(void);
 void TP_DisplayMemory(void) ;
 void TP_AuxRelays(void) ;
 void TP_DisplayDmnd(void);
@@ -1100,7 +1150,8 @@ void Test_VarInit(void)
 //  CALLS:              TP_TestLEDs(), TP_ExecuteAction(), TP_DisplayRTValues(), TP_DisplayRT0Values(),
 //                      TP_DisplayRT1Values(), TP_DisplayRT2Values(), TP_ModifyCal(), TP_RTC(),
 //                      TP_DisplayWaveform(), TP_THSensor(), TP_OffsetCal(), TP_GainCal(),
-//                      TP_TestIndicators(), TP_RestoreUnit(), TP_DisplayWF(), FRAM_Read(), ClearLogFRAM()
+//                      TP_TestIndicators(), TP_RestoreUnit(), TP_DisplayWF(), FRAM_Read(), ClearLogFRAM(),
+//                      Apply_CalConstants()
 // 
 //------------------------------------------------------------------------------------------------------------
 
@@ -1313,6 +1364,39 @@ void TP_Top(void)
                 TP.SubState = TP_PC0;
                 break;
 
+#ifdef ENABLE_STAGE_PROFILER
+              case ('P' * 256 + 'F'):               // Display Stage Profile command string
+                TP.State = TP_PF;
+                TP.SubState = TP_PF0;
+                break;
+
+              case ('P' * 256 + 'R'):               // Reset Stage Profile command string
+                Prof_Reset();                           // Next state is idle
+                break;
+#endif
+
+#ifdef ENABLE_MAIN_SCHED
+              case ('S' * 256 + 'S'):               // Display Scheduler Statistics command string
+                TP.State = TP_SS;
+                TP.SubState = TP_SS0;
+                break;
+
+              case ('S' * 256 + 'R'):               // Reset Scheduler Statistics command string
+                Sched_Reset();                          // Next state is idle
+                break;
+#endif
+
+#ifdef ENABLE_LOOP_TRACE
+              case ('D' * 256 + 'L'):               // Display Loop Trace command string
+                TP.State = TP_DL;
+                TP.SubState = TP_DL0;
+                break;
+
+              case ('R' * 256 + 'L'):               // Reset Loop Trace command string
+                Trace_Reset();                          // Next state is idle
+                break;
+#endif
+
               case ('I' * 256 + 'C'):               // Test Injection Calibration Command
                 TP_TestInjCal();                        // Call subroutine to set the next state according
                 break;                                  //   according to the next parameter
@@ -1626,6 +1710,27 @@ void TP_Top(void)
         TP_exit = TRUE;
         break;
 
+#ifdef ENABLE_STAGE_PROFILER
+      case TP_PF:                         // Display Stage Profile command
+        TP_DisplayProfile();
+        TP_exit = TRUE;
+        break;
+#endif
+
+#ifdef ENABLE_MAIN_SCHED
+      case TP_SS:                         // Display Scheduler Statistics command
+        TP_DisplaySched();
+        TP_exit = TRUE;
+        break;
+#endif
+
+#ifdef ENABLE_LOOP_TRACE
+      case TP_DL:                         // Display Loop Trace command
+        TP_DisplayTrace();
+        TP_exit = TRUE;
+        break;
+#endif
+
       case TP_DM:                         // Display Memory command
         TP_DisplayMemory(); 
         TP_exit = TRUE;
@@ -1724,6 +1829,7 @@ void TP_Top(void)
         break;
 
       case TP_WR_CAL:                     // Write (Metering) Calibration Constants to FRAM and Flash
+        Apply_CalConstants();                 // Compute the coefficients used to scale the samples
         SPI1Flash.Req |= S1F_CAL_WR;          // Set flag to write the cal constants to Flash
         TP.State = TP_WR_CAL1;                // Set next state to see if done
         TP_exit = TRUE;                       // Exit the subroutine
@@ -4758,6 +4864,359 @@ void TP_DisplayStartup(void)
 
 
 
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       TP_DisplayProfile()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Display Stage Profile
+//
+//  MECHANICS:          This subroutine displays the stage profiler statistics.  For each stage, the
+//                      following are displayed (times are in core clock cycles):
+//                          <Stage name> n=<Count> min=<Min> max=<Max> last=<Last> avg=<Average>
+//                            h 0-11: <Histogram bins 0 - 11>
+//                            h12-23: <Histogram bins 12 - 23>
+//                      Histogram bin n holds the number of times from 2^(n-1) to (2^n - 1) cycles.  TP.Temp
+//                      holds the stage that is being displayed.
+//
+//  CAVEATS:            Only compiled if ENABLE_STAGE_PROFILER is defined
+//
+//  INPUTS:             ProfStage[], PROF_STAGE_NAME[]
+//
+//  OUTPUTS:            TP.TxValBuf[], TP.Status, TP.TxValNdx, TP.NumChars
+//
+//  ALTERS:             TP.SubState, TP.Temp
+//
+//  CALLS:              sprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+#ifdef ENABLE_STAGE_PROFILER
+void TP_DisplayProfile(void)
+{
+  uint8_t i, j;
+  int len;
+  uint32_t min, avg;
+
+  switch (TP.SubState)
+  {
+    case TP_PF0:                        // Initialize the stage
+      TP.Temp = 0;
+      TP.SubState = TP_PF1;
+      break;
+
+    case TP_PF1:                        // Display the stage summary
+      min = ((ProfStage[TP.Temp].Count == 0) ? 0 : ProfStage[TP.Temp].Min);
+      avg = ((ProfStage[TP.Temp].Count == 0) ? 0 :
+                    (uint32_t)(ProfStage[TP.Temp].Total / ProfStage[TP.Temp].Count));
+      len = sprintf(&TP.TxValBuf[0], "\n\r%-10s n=%u min=%u max=%u last=%u avg=%u",
+                    PROF_STAGE_NAME[TP.Temp], (unsigned int)ProfStage[TP.Temp].Count, (unsigned int)min,
+                    (unsigned int)ProfStage[TP.Temp].Max, (unsigned int)ProfStage[TP.Temp].Last,
+                    (unsigned int)avg);
+      TP.Status &= (~TP_TX_STRING);         // Make sure flag to transmit string is clear
+      TP.Status |= TP_TX_VALUE;             // Set flag to transmit values
+      TP.TxValNdx = 0;
+      TP.NumChars = (uint8_t)len;
+      UART5->CR1 |= USART_CR1_TXEIE;        // Enable transmit interrupts
+      TP.SubState = TP_PF2;
+      break;
+
+    case TP_PF3:                        // Display histogram bins 0 - 11
+    case TP_PF5:                        // Display histogram bins 12 - 23
+      j = ((TP.SubState == TP_PF3) ? 0 : (PROF_HIST_BINS/2));
+      len = sprintf(&TP.TxValBuf[0], "\n\r  h%2u-%2u:", (unsigned int)j,
+                    (unsigned int)(j + (PROF_HIST_BINS/2) - 1));
+      for (i = 0; i < (PROF_HIST_BINS/2); ++i)
+      {
+        len += sprintf(&TP.TxValBuf[len], " %5u", (unsigned int)ProfStage[TP.Temp].Hist[i+j]);
+      }
+      TP.Status &= (~TP_TX_STRING);         // Make sure flag to transmit string is clear
+      TP.Status |= TP_TX_VALUE;             // Set flag to transmit values
+      TP.TxValNdx = 0;
+      TP.NumChars = (uint8_t)len;
+      UART5->CR1 |= USART_CR1_TXEIE;        // Enable transmit interrupts
+      TP.SubState++;
+      break;
+
+    case TP_PF2:                        // Wait until done transmitting
+    case TP_PF4:                        // Wait until done transmitting
+      if (!(TP.Status & TP_TX_VALUE))       // When done transmitting jump to next state
+      {
+        TP.SubState++;
+      }
+      break;                                // Otherwise remain in this state
+
+    case TP_PF6:                        // Wait until done transmitting, then go to the next stage
+      if (!(TP.Status & TP_TX_VALUE))
+      {
+        if (++TP.Temp < PROF_NUM_STAGES)
+        {
+          TP.SubState = TP_PF1;
+        }
+        else
+        {
+          TP.State = TP_CURSOR;
+        }
+      }
+      break;
+
+    default:
+      TP.State = TP_CURSOR;
+      break;
+  }
+
+}
+#endif
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         TP_DisplayProfile()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       TP_DisplaySched()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Display Scheduler Statistics
+//
+//  MECHANICS:          This subroutine displays the main loop scheduler statistics.  For each task, the
+//                      following are displayed (times are in core clock cycles):
+//                          <Task name> passes=<Passes> slices=<Slices> ovr=<Overruns> miss=<Misses>
+//                            maxslice=<MaxSlice> maxresp=<MaxResponse>
+//                      TP.Temp holds the task that is being displayed.
+//
+//  CAVEATS:            Only compiled if ENABLE_MAIN_SCHED is defined
+//
+//  INPUTS:             SchedStat[], SCHED_TASK_NAME[]
+//
+//  OUTPUTS:            TP.TxValBuf[], TP.Status, TP.TxValNdx, TP.NumChars
+//
+//  ALTERS:             TP.SubState, TP.Temp
+//
+//  CALLS:              sprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+#ifdef ENABLE_MAIN_SCHED
+void TP_DisplaySched(void)
+{
+  int len;
+
+  switch (TP.SubState)
+  {
+    case TP_SS0:                        // Initialize the task
+      TP.Temp = 0;
+      TP.SubState = TP_SS1;
+      break;
+
+    case TP_SS1:                        // Display the counts
+      len = sprintf(&TP.TxValBuf[0], "\n\r%-10s passes=%u slices=%u ovr=%u miss=%u",
+                    SCHED_TASK_NAME[TP.Temp], (unsigned int)SchedStat[TP.Temp].Passes,
+                    (unsigned int)SchedStat[TP.Temp].Slices, (unsigned int)SchedStat[TP.Temp].Overruns,
+                    (unsigned int)SchedStat[TP.Temp].Misses);
+      TP.Status &= (~TP_TX_STRING);         // Make sure flag to transmit string is clear
+      TP.Status |= TP_TX_VALUE;             // Set flag to transmit values
+      TP.TxValNdx = 0;
+      TP.NumChars = (uint8_t)len;
+      UART5->CR1 |= USART_CR1_TXEIE;        // Enable transmit interrupts
+      TP.SubState = TP_SS2;
+      break;
+
+    case TP_SS3:                        // Display the max times
+      len = sprintf(&TP.TxValBuf[0], "\n\r  maxslice=%u maxresp=%u",
+                    (unsigned int)SchedStat[TP.Temp].MaxSlice, (unsigned int)SchedStat[TP.Temp].MaxResponse);
+      TP.Status &= (~TP_TX_STRING);         // Make sure flag to transmit string is clear
+      TP.Status |= TP_TX_VALUE;             // Set flag to transmit values
+      TP.TxValNdx = 0;
+      TP.NumChars = (uint8_t)len;
+      UART5->CR1 |= USART_CR1_TXEIE;        // Enable transmit interrupts
+      TP.SubState = TP_SS4;
+      break;
+
+    case TP_SS2:                        // Wait until done transmitting
+      if (!(TP.Status & TP_TX_VALUE))       // When done transmitting jump to next state
+      {
+        TP.SubState = TP_SS3;
+      }
+      break;                                // Otherwise remain in this state
+
+    case TP_SS4:                        // Wait until done transmitting, then go to the next task
+      if (!(TP.Status & TP_TX_VALUE))
+      {
+        if (++TP.Temp < SCHED_NUM_TASKS)
+        {
+          TP.SubState = TP_SS1;
+        }
+        else
+        {
+          TP.State = TP_CURSOR;
+        }
+      }
+      break;
+
+    default:
+      TP.State = TP_CURSOR;
+      break;
+  }
+
+}
+#endif
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         TP_DisplaySched()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION       TP_DisplayTrace()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Display Loop Trace
+//
+//  MECHANICS:          This subroutine displays the main loop trace (times are in core clock cycles):
+//                        - For each block:
+//                              <Block name> n=<Count> p50=<P50> p99=<P99> max=<Max>
+//                        - The longest pass:
+//                              worst pass=<Pass> cyc=<Cycles> blocks=<blocks that ran> sm=<state machines>
+//                        - The longest pass for each combination of state machines that has occurred:
+//                                sm=<state machines> max=<time>
+//                        - The pass records, oldest first:
+//                                pass=<Pass> start=<StartCyc> cyc=<Cycles> blocks=<blocks> sm=<state
+//                                machines>
+//                      The blocks and state machines are displayed in hex (see Trace_def.h).  TP.Temp holds
+//                      the block, combination, or record that is being displayed.
+//
+//  CAVEATS:            Only compiled if ENABLE_LOOP_TRACE is defined.  The trace is written in the main loop,
+//                      so it may change between lines
+//
+//  INPUTS:             TraceBlock[], TraceWorst, TraceComboMax[], TraceRing[], TRACE_BLOCK_NAME[]
+//
+//  OUTPUTS:            TP.TxValBuf[], TP.Status, TP.TxValNdx, TP.NumChars
+//
+//  ALTERS:             TP.SubState, TP.Temp
+//
+//  CALLS:              sprintf()
+//
+//------------------------------------------------------------------------------------------------------------
+
+#ifdef ENABLE_LOOP_TRACE
+void TP_DisplayTrace(void)
+{
+  struct TRACE_REC *rptr;
+  int len;
+
+  len = 0;
+  switch (TP.SubState)
+  {
+    case TP_DL0:                        // Initialize the block
+      TP.Temp = 0;
+      TP.SubState = TP_DL1;
+      break;
+
+    case TP_DL1:                        // Display the block statistics
+      len = sprintf(&TP.TxValBuf[0], "\n\r%-10s n=%u p50=%u p99=%u max=%u", TRACE_BLOCK_NAME[TP.Temp],
+                    (unsigned int)TraceBlock[TP.Temp].Count, (unsigned int)TraceBlock[TP.Temp].P50,
+                    (unsigned int)TraceBlock[TP.Temp].P99, (unsigned int)TraceBlock[TP.Temp].Max);
+      TP.SubState = TP_DL2;
+      break;
+
+    case TP_DL3:                        // Display the longest pass
+      len = sprintf(&TP.TxValBuf[0], "\n\rworst pass=%u cyc=%u blocks=%02X sm=%02X",
+                    (unsigned int)TraceWorst.Pass, (unsigned int)TraceWorst.Cycles,
+                    (unsigned int)(TraceWorst.Flags & 0xFF),
+                    (unsigned int)(TraceWorst.Flags >> TRACE_SM_SHIFT));
+      TP.Temp = 0;
+      TP.SubState = TP_DL4;
+      break;
+
+    case TP_DL5:                        // Display the next combination that has occurred
+      while ( (TP.Temp < TRACE_NUM_COMBOS) && (TraceComboMax[TP.Temp] == 0) )
+      {
+        TP.Temp++;
+      }
+      if (TP.Temp < TRACE_NUM_COMBOS)
+      {
+        len = sprintf(&TP.TxValBuf[0], "\n\r  sm=%02X max=%u", (unsigned int)TP.Temp,
+                      (unsigned int)TraceComboMax[TP.Temp]);
+        TP.Temp++;
+        TP.SubState = TP_DL6;
+      }
+      else
+      {
+        TP.Temp = 0;
+        TP.SubState = TP_DL7;
+      }
+      break;
+
+    case TP_DL7:                        // Display the next pass record
+      rptr = &TraceRing[(TraceRingNdx + TP.Temp) & (TRACE_RING_SIZE - 1)];
+      len = sprintf(&TP.TxValBuf[0], "\n\r  pass=%u start=%u cyc=%u blocks=%02X sm=%02X",
+                    (unsigned int)rptr->Pass, (unsigned int)rptr->StartCyc, (unsigned int)rptr->Cycles,
+                    (unsigned int)(rptr->Flags & 0xFF), (unsigned int)(rptr->Flags >> TRACE_SM_SHIFT));
+      TP.SubState = TP_DL8;
+      break;
+
+    case TP_DL2:                        // Wait until done transmitting, then go to the next block
+      if (!(TP.Status & TP_TX_VALUE))
+      {
+        if (++TP.Temp < TRACE_NUM_BLOCKS)
+        {
+          TP.SubState = TP_DL1;
+        }
+        else
+        {
+          TP.SubState = TP_DL3;
+        }
+      }
+      break;
+
+    case TP_DL4:                        // Wait until done transmitting
+    case TP_DL6:
+      if (!(TP.Status & TP_TX_VALUE))
+      {
+        TP.SubState = TP_DL5;
+      }
+      break;
+
+    case TP_DL8:                        // Wait until done transmitting, then go to the next record
+      if (!(TP.Status & TP_TX_VALUE))
+      {
+        if (++TP.Temp < TRACE_RING_SIZE)
+        {
+          TP.SubState = TP_DL7;
+        }
+        else
+        {
+          TP.State = TP_CURSOR;
+        }
+      }
+      break;
+
+    default:
+      TP.State = TP_CURSOR;
+      break;
+  }
+
+  if (len > 0)                          // If a line was written, transmit it
+  {
+    TP.Status &= (~TP_TX_STRING);           // Make sure flag to transmit string is clear
+    TP.Status |= TP_TX_VALUE;               // Set flag to transmit values
+    TP.TxValNdx = 0;
+    TP.NumChars = (uint8_t)len;
+    UART5->CR1 |= USART_CR1_TXEIE;          // Enable transmit interrupts
+  }
+}
+#endif
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION         TP_DisplayTrace()
+//------------------------------------------------------------------------------------------------------------
+
+
+
 
 //------------------------------------------------------------------------------------------------------------
 //             START OF FUNCTION       TP_ModifyCal()
@@ -4807,7 +5266,7 @@ void TP_DisplayStartup(void)
 //
 //  ALTERS:             TP.SubState, TP.RxNdxOut, TP.RxNdxIn
 // 
-//  CALLS:              sprintf(), ComputeChksum32(), atof(), TP_GetDecNum()
+//  CALLS:              sprintf(), ComputeChksum32(), atof(), TP_GetDecNum(), Apply_CalConstants()
 //
 //------------------------------------------------------------------------------------------------------------
 
@@ -4904,6 +5363,7 @@ void TP_ModifyCal(void)
                 && (TP.RxBuf[TP.RxNdxOut] != 0x0D) )    //   return, process the input
               {
                 *TP.ValPtr1 = atof((char const *)(&TP.RxBuf[TP.RxNdxOut]));
+                Apply_CalConstants();                   // Use the new gain now, since the user may quit
               }                                         // Otherwise this constant stays as is
             }
 //          TP_IdleTimer = TP_IDLETIMEOUT;          // Reset the idle timer - we have received char(s)
@@ -4962,6 +5422,7 @@ void TP_ModifyCal(void)
                 && (TP.RxBuf[TP.RxNdxOut] != 0x0D) )    //   return, process the input
               {
                 *TP.ValPtr2 = atof((char const *)(&TP.RxBuf[TP.RxNdxOut]));
+                Apply_CalConstants();                   // Use the new offset now, since the user may quit
               }                                         // Otherwise this constant stays as is
               if (TP.SubState == TP_MC4)                // If doing AFE cal constants, set next state to do
               {                                         //   phase
@@ -5646,7 +6107,7 @@ void TP_THSensor(void)
 //
 //  ALTERS:             TP.SubState
 // 
-//  CALLS:              TP_ParseChars(), TP_GetDecNum(), CaptureUserWaveform()
+//  CALLS:              TP_ParseChars(), TP_GetDecNum(), CaptureUserWaveform(), Apply_CalConstants()
 // 
 //------------------------------------------------------------------------------------------------------------
 
@@ -5786,6 +6247,7 @@ void TP_OffsetCal(void)
                 TP.ValPtr1 = &UserSamples.OneCyc[j+3][0];
               }
             }
+            Apply_CalConstants();             // Use the 0 offset for the channel of interest
             TP.Temp = 0;
             TP.Tmp1.f = 0;
             TP.State = TP_OC;
@@ -7358,7 +7820,7 @@ void TP_EEPOT(void)
 //
 //  ALTERS:             TP.RxNdxOut
 // 
-//  CALLS:              TP_ParseChars(), TP_GetDecNum(), AFE_Init(), AFE_SPI_Xfer()
+//  CALLS:              TP_ParseChars(), TP_GetDecNum(), AFE_Init(), AFE_SPI_Xfer(), Apply_CalConstants()
 // 
 //------------------------------------------------------------------------------------------------------------
 
@@ -7400,6 +7862,7 @@ void TP_AFESetPGA(void)
       AFEcal.gain[k] = AFEcal.gain[k] * (float)TP_AFEPGASetting;
       AFEcal.gain[k] = AFEcal.gain[k]/(float)new_setting;
     }
+    Apply_CalConstants();                   // Compute the coefficients used to scale the samples
     TP_AFEPGASetting = new_setting;         // Save the new setting
 
     AFE_RESETN_ACTIVE;                      // Reset the AFE chip
@@ -8386,6 +8849,14 @@ void TP_DisplayWF(void)
           TP.Tmp2.u = ((TP.SubState == TP_DA3) ?
                   (((uint32_t)ALARM_WAVEFORMS_START) << 12) : (((uint32_t)TRIP_WAVEFORMS_START) << 12));
         }
+#ifdef ENABLE_WF_CODEC
+        // If the waveforms are coded, the address is the start of the selected log, and the samples are
+        //   read WF_CODEC_TP_SETS at a time.  The cycle is located from the log's index in
+        //   SPI1_Flash_Manager() (see WfCodec_Read())
+        TP.Tmp2.u += ((TP.Tmp1.b[2] * WF_SIZE_IN_SECTORS)<< 12); // offset of the selected waveform log
+        TP.Tmp1.b[0] = ( ((WF_CODEC_SAMPLES - TP.Tmp1.b[1]) > WF_CODEC_TP_SETS) ?
+                                WF_CODEC_TP_SETS : (WF_CODEC_SAMPLES - TP.Tmp1.b[1]) );
+#else
         TP.Tmp2.u += ((TP.Tmp1.b[2] * WF_SIZE_IN_SECTORS)<< 12) // offset of the selected waveform log
                   + (WF_ADDRESS[TP.Temp - 1][0] << 8)           // starting page address of the first cycle
                   + TP.Tmp1.b[3];                               // offset of the selected value
@@ -8412,6 +8883,7 @@ void TP_DisplayWF(void)
         {
           TP.Tmp1.b[0] = 7;
         }
+#endif
         TP.Tmp1.b[1] += TP.Tmp1.b[0];        // Update the total number of samples that have been read
         SPI1Flash.Req |= S1F_TP_RD_REQ;     // Set request flag from the test port
         ++TP.SubState;
@@ -8480,7 +8952,11 @@ void TP_DisplayWF(void)
           // There are no more values to transmit when the page offset (in DW_temp) has reached the last
           //   page of the cycle.  If there are no more values to transmit, we are done, so set the state to
           //   output the cursor and exit
+#ifdef ENABLE_WF_CODEC
+          if (TP.Tmp1.b[1] >= WF_CODEC_SAMPLES)  // Coded waveforms: done when the whole cycle has been read
+#else
           if (DW_temp == (WF_ADDRESS[TP.Temp - 1][2] - WF_ADDRESS[TP.Temp - 1][0]))
+#endif
           {
             TP.State = TP_CURSOR;
           }
@@ -10897,6 +11373,7 @@ void Cal_Gain_AFE(void)
                                                       // Compute and save new checksum and complement
           AFEcal.chk = ComputeChksum32((uint32_t *)(&AFEcal.gain[0]), ((AFE_CAL_SIZE >> 2)-2));
           AFEcal.cmp = ~AFEcal.chk;
+          Apply_CalConstants();                 // Compute the coefficients used to scale the samples
           SPI1Flash.Req |= S1F_CAL_WR;          // Set flag to write the cal constants to Flash
           ExAct.State = WRCAL;                         // Set next state to write cal constants to FRAM and Flash
         }                                               
@@ -10954,7 +11431,7 @@ void Cal_Gain_AFE(void)
 //
 //  ALTERS:             TP.SubState
 // 
-//  CALLS:              TP_ParseChars(), TP_GetDecNum()
+//  CALLS:              TP_ParseChars(), TP_GetDecNum(), Apply_CalConstants()
 // 
 //------------------------------------------------------------------------------------------------------------
 float tempp = 0;
@@ -11019,6 +11496,7 @@ void Cal_Offset_AFE(void)
           {
             *(ExAct.calPtrArray[i]) = 0.0;
           }
+          Apply_CalConstants();         // Use the 0 offset for the channels of interest
           ExAct.SubState = CAL1;
           ExAct.Temp = 0;
           for(i=0; i<ExAct.channels_amount; i++)
@@ -11057,6 +11535,7 @@ void Cal_Offset_AFE(void)
             AFEcal.chk = ComputeChksum32((uint32_t *)(&AFEcal.gain[0]), ((AFE_CAL_SIZE >> 2)-2));
             AFEcal.cmp = ~AFEcal.chk;
             UserWF.Locked = FALSE;                     // Free up user captures
+            Apply_CalConstants();                      // Compute the coefficients used to scale the samples
             SPI1Flash.Req |= S1F_CAL_WR;               // Set flag to write the cal constants to Flash
             ExAct.State = WRCAL;                       // Set next state to write cal constants to FRAM
           }                                            //   and Flash   
@@ -11222,6 +11701,7 @@ void Cal_Gain_HG(void)
                                                       // Compute and save new checksum and complement
           ADCcalHigh.chk = ComputeChksum32((uint32_t *)(&ADCcalHigh.gain[0]), ((ADC_CAL_SIZE >> 2)-2));
           ADCcalHigh.cmp = ~ADCcalHigh.chk;
+          Apply_CalConstants();                 // Compute the coefficients used to scale the samples
           SPI1Flash.Req |= S1F_CAL_WR;          // Set flag to write the cal constants to Flash
           ExAct.State = WRCAL;                         // Set next state to write cal constants to FRAM and Flash
         }                                               
@@ -11279,7 +11759,7 @@ void Cal_Gain_HG(void)
 //
 //  ALTERS:             TP.SubState
 // 
-//  CALLS:              TP_ParseChars(), TP_GetDecNum(), CaptureUserWaveform()
+//  CALLS:              TP_ParseChars(), TP_GetDecNum(), CaptureUserWaveform(), Apply_CalConstants()
 // 
 //------------------------------------------------------------------------------------------------------------
 
@@ -11357,6 +11837,7 @@ void Cal_Offset_HG(void)
       {
         *(ExAct.calPtrArray[i]) = 0.0;
       }
+      Apply_CalConstants();             // Use the 0 offset for the channels of interest
       ExAct.SubState = CAL1;
       ExAct.Temp = 0;
       for(i=0; i<ExAct.channels_amount; i++)
@@ -11394,6 +11875,7 @@ void Cal_Offset_HG(void)
           ADCcalHigh.chk = ComputeChksum32((uint32_t *)(&ADCcalHigh.gain[0]), ((ADC_CAL_SIZE >> 2)-2));
           ADCcalHigh.cmp = ~ADCcalHigh.chk;
           UserWF.Locked = FALSE;                       // Free up user captures
+          Apply_CalConstants();                        // Compute the coefficients used to scale the samples
           SPI1Flash.Req |= S1F_CAL_WR;                 // Set flag to write the cal constants to Flash
           ExAct.State = WRCAL;                         // Set next state to write cal constants to FRAM and Flash
         }                                                 
@@ -11557,6 +12039,7 @@ void Cal_Gain_LG(void)
                                                       // Compute and save new checksum and complement
           ADCcalLow.chk = ComputeChksum32((uint32_t *)(&ADCcalLow.gain[0]), ((ADC_CAL_SIZE >> 2)-2));
           ADCcalLow.cmp = ~ADCcalLow.chk;
+          Apply_CalConstants();                 // Compute the coefficients used to scale the samples
           SPI1Flash.Req |= S1F_CAL_WR;          // Set flag to write the cal constants to Flash
           ExAct.State = WRCAL;                         // Set next state to write cal constants to FRAM and Flash
         }                                               
@@ -11614,7 +12097,7 @@ void Cal_Gain_LG(void)
 //
 //  ALTERS:             TP.SubState
 // 
-//  CALLS:              TP_ParseChars(), TP_GetDecNum(), CaptureUserWaveform()
+//  CALLS:              TP_ParseChars(), TP_GetDecNum(), CaptureUserWaveform(), Apply_CalConstants()
 // 
 //------------------------------------------------------------------------------------------------------------
 
@@ -11691,6 +12174,7 @@ void Cal_Offset_LG(void)
       {
         *(ExAct.calPtrArray[i]) = 0.0;
       }
+      Apply_CalConstants();             // Use the 0 offset for the channels of interest
       ExAct.SubState = CAL1;
       ExAct.Temp = 0;
       for(i=0; i<ExAct.channels_amount; i++)
@@ -11728,6 +12212,7 @@ void Cal_Offset_LG(void)
           ADCcalLow.chk = ComputeChksum32((uint32_t *)(&ADCcalLow.gain[0]), ((ADC_CAL_SIZE >> 2)-2));
           ADCcalLow.cmp = ~ADCcalLow.chk;
           UserWF.Locked = FALSE;                       // Free up user captures
+          Apply_CalConstants();                        // Compute the coefficients used to scale the samples
           SPI1Flash.Req |= S1F_CAL_WR;                 // Set flag to write the cal constants to Flash
           ExAct.State = WRCAL;                         // Set next state to write cal constants to FRAM and Flash
         }                                                 
@@ -12314,7 +12799,10 @@ void Write_Default_Cal(uint16_t cal_type)
     ADCcalLow.cmp = ~ADCcalLow.chk;
     FRAM_Write(DEV_FRAM2, FRAM_ADCCALL, (ADC_CAL_SIZE >> 1), (uint16_t *)(&ADCcalLow.gain[0]));
   }
-
+  if (restore_AFE || restore_ADC_High || restore_ADC_Low)
+  {
+    Apply_CalConstants();                 // Compute the coefficients used to scale the samples
+  }
 
 }
 //------------------------------------------------------------------------------------------------------------
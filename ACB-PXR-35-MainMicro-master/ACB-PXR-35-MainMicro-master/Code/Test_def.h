@@ -80,6 +80,11 @@
 //                      - Added CAL2 to Cal_States
 //   108    231108  DAH - Added CAL6 to Cal_States
 //   142    240119  DAH - In struct EXACTVARS, changed target definition from uint32_t to float
+//   155    240207  DAH - Added TP_PF to TestPort_States to support displaying the stage profiler statistics
+//                        ("PF" cmnd)
+//   161    240213  DAH - Added TP_SS to TestPort_States to support displaying the scheduler statistics
+//                        ("SS" cmnd)
+//   162    240214  DAH - Added TP_DL to TestPort_States to support displaying the loop trace ("DL" cmnd)
 //
 //------------------------------------------------------------------------------------------------------------
 //
@@ -154,7 +159,10 @@ enum TestPort_States
   TP_GF,
   TP_NF,
   TP_MX,    //Extended 6s OneCycle Capture Snaphsots
-  TP_MZ     //Extended 60s 200mCycle Capture Snaphsots
+  TP_MZ,    //Extended 60s 200mCycle Capture Snaphsots
+  TP_PF,    // Stage profiler statistics
+  TP_SS,    // Scheduler statistics
+  TP_DL     // Loop trace
 };
 
 
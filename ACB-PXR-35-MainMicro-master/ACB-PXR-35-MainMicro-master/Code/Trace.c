@@ -0,0 +1,620 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//
+//  MODULE NAME:        Trace.c
+//
+//  MECHANICS:          Program module containing the main loop latency tracer.  For each pass through the
+//                      main loop, the tracer keeps a record of the start time, the pass time, the
+//                      anniversary blocks that ran, and the long-running state machines that were busy
+//                      (harmonics, disturbance capture, extended capture, event manager, event waveform
+//                      capture, and SPI1 Flash).  The last TRACE_RING_SIZE records are kept in TraceRing[],
+//                      and the longest pass is kept in TraceWorst.  The longest pass time for each
+//                      combination of busy state machines is kept in TraceComboMax[], which shows the
+//                      combination of events that produces the worst-case loop time.
+//                      The pass time and the time of each anniversary block are also kept in a histogram,
+//                      from which the median (P50) and 99th percentile (P99) times are computed once a
+//                      second.
+//                      The times are measured with the DWT cycle counter, so unlike the original loop time
+//                      measurement (maxlooptime, measured with the internal time), they are not affected by
+//                      time adjustments.  maxlooptime is set from the longest pass time.
+//                      The trace may be read with the test port "DL" command (reset with the "RL" command),
+//                      and the block statistics, the worst-case pass, and the worst-case time for each
+//                      combination may be read over Modbus (Group 74, registers 50816 - 50999).
+//                      The tracer is only compiled in if ENABLE_LOOP_TRACE is defined in Iod_def.h.
+//
+//  TARGET HARDWARE:    PXR35 Rev 1 and later boards
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   162    240214  DAH File Creation
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+// Path for library files:
+//   IAR Systems\Embedded Workbench 8.3\arm\inc\c
+//
+//------------------------------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------------------------------
+//                   Definitions
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global Definitions from external files...
+//
+#include <string.h>
+#include "stm32f4xx.h"
+#include "stm32f407xx.h"
+#include "RealTime_def.h"
+#include "Iod_def.h"
+#include "Meter_def.h"
+#include "Events_def.h"
+#include "Trace_def.h"
+
+#ifdef ENABLE_LOOP_TRACE
+
+//
+//      Local Definitions used in this module...
+//
+
+
+//
+//      Global Declarations from external files...
+//
+#include "Iod_ext.h"
+#include "Meter_ext.h"
+#include "Events_ext.h"
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global (Visible) Function Prototypes (These functions are called by other modules)
+//
+void Trace_Init(void);
+void Trace_Reset(void);
+void Trace_LoopStart(void);
+void Trace_LoopEnd(void);
+void Trace_Block(uint8_t blk, uint32_t cycles);
+void Trace_Summary(void);
+
+
+//      Local Function Prototypes (These functions are called only within this module)
+//
+void Trace_ClearStats(void);
+void Trace_Record(uint8_t blk, uint32_t cycles);
+uint8_t Trace_SMBusy(void);
+uint32_t Trace_Percentile(struct TRACE_BLOCK *bptr, uint32_t total, uint32_t pct);
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Storage Allocation - Global (Static) Variables
+//------------------------------------------------------------------------------------------------------------
+//
+//       These variables are used by other modules...
+//
+struct TRACE_BLOCK TraceBlock[TRACE_NUM_BLOCKS];
+struct TRACE_REC TraceRing[TRACE_RING_SIZE];
+struct TRACE_REC TraceWorst;
+uint32_t TraceComboMax[TRACE_NUM_COMBOS];
+uint32_t TraceStartCyc[TRACE_NUM_BLOCKS];
+uint32_t TracePasses;
+uint8_t TraceRingNdx;
+
+
+//       These variables are used only in this module...
+//
+struct TRACE_REC TraceCur;
+
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Global Constants used in this module and other modules
+//------------------------------------------------------------------------------------------------------------
+//
+// Block names for the test port display.  These must be in the same order as the block definitions in
+//   Trace_def.h, and must be no longer than 10 characters
+const char * const TRACE_BLOCK_NAME[TRACE_NUM_BLOCKS] =
+{
+  "Main loop", "1cyc", "200msec", "1sec", "5min", "Background"
+};
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Trace_Init()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Loop Tracer Initialization
+//
+//  MECHANICS:          This subroutine enables the DWT cycle counter and clears the trace.  The cycle
+//                      counter is in the debug block, so trace must be enabled (TRCENA) before it can be
+//                      used.  The counter is not reset, since it may also be used by the stage profiler.
+//
+//  CAVEATS:            Called during initialization, before the main loop is entered
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            TraceBlock[], TraceRing[], TraceWorst, TraceComboMax[], TracePasses, TraceCur,
+//                      TraceRingNdx
+//
+//  ALTERS:             CoreDebug->DEMCR, DWT->CTRL
+//
+//  CALLS:              Trace_ClearStats()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Trace_Init(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  TraceCur.StartCyc = TRACE_CYCCNT();
+  TraceCur.Flags = 0;
+  Trace_ClearStats();
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Trace_Init()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Trace_Reset()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Reset Loop Trace
+//
+//  MECHANICS:          This subroutine clears the block statistics, the pass records, and the worst-case
+//                      times.  The pass that is in progress is not affected.
+//
+//  CAVEATS:            The trace is only written in the main loop, so this must only be called from the main
+//                      loop (test port command)
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            TraceBlock[], TraceRing[], TraceWorst, TraceComboMax[], TracePasses, TraceRingNdx
+//
+//  ALTERS:             None
+//
+//  CALLS:              Trace_ClearStats()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Trace_Reset(void)
+{
+  Trace_ClearStats();
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Trace_Reset()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Trace_ClearStats()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Clear Loop Trace
+//
+//  MECHANICS:          This subroutine clears the block statistics and histograms, the pass records, the
+//                      worst-case pass record, and the worst-case times for each combination of state
+//                      machines.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            TraceBlock[], TraceRing[], TraceWorst, TraceComboMax[], TracePasses, TraceRingNdx
+//
+//  ALTERS:             None
+//
+//  CALLS:              memset()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Trace_ClearStats(void)
+{
+  memset(&TraceBlock[0], 0, sizeof(TraceBlock));
+  memset(&TraceRing[0], 0, sizeof(TraceRing));
+  memset(&TraceWorst, 0, sizeof(TraceWorst));
+  memset(&TraceComboMax[0], 0, sizeof(TraceComboMax));
+  TracePasses = 0;
+  TraceRingNdx = 0;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Trace_ClearStats()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Trace_SMBusy()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Read the State Machine Flags
+//
+//  MECHANICS:          This subroutine returns a flag (TRACE_SM_xx) for each of the long-running state
+//                      machines that is busy.  A state machine is busy if its state is not idle (0), or if
+//                      it has a request pending.
+//
+//  CAVEATS:            SPI1Flash and Dist_Flag are written in the interrupts.  They are each read once, so
+//                      at worst the flag is for the state just before or just after the interrupt.
+//
+//  INPUTS:             CH_State, Dist_Flag, sExtCapState.State, ExtCap_ReqFlag, ExtCap_AckFlag, EventState,
+//                      EV_WfState, SPI1Flash.State, SPI1Flash.Req
+//
+//  OUTPUTS:            Returns the state machine flags
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Trace_SMBusy(void)
+{
+  uint8_t sm;
+
+  sm = 0;
+  if (CH_State != 0)
+  {
+    sm |= TRACE_SM_HARM;
+  }
+  if (Dist_Flag != 0)
+  {
+    sm |= TRACE_SM_DIST;
+  }
+  if ( (sExtCapState.State != 0) || (ExtCap_ReqFlag) || (ExtCap_AckFlag) )
+  {
+    sm |= TRACE_SM_EXTCAP;
+  }
+  if (EventState != EM_IDLE)
+  {
+    sm |= TRACE_SM_EVENT;
+  }
+  if (EV_WfState != 0)
+  {
+    sm |= TRACE_SM_WF;
+  }
+  if ( (SPI1Flash.State != 0) || (SPI1Flash.Req != 0) )     // 0 is S1F_IDLE
+  {
+    sm |= TRACE_SM_FLASH;
+  }
+  return (sm);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Trace_SMBusy()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Trace_LoopStart()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Start a Pass Record
+//
+//  MECHANICS:          This subroutine is called at the start of each pass through the main loop.  It saves
+//                      the start time and the state machines that are busy at the start of the pass, and
+//                      clears the blocks that ran.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            TraceCur
+//
+//  ALTERS:             None
+//
+//  CALLS:              Trace_SMBusy()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Trace_LoopStart(void)
+{
+  TraceCur.StartCyc = TRACE_CYCCNT();
+  TraceCur.Flags = ((uint32_t)Trace_SMBusy() << TRACE_SM_SHIFT);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Trace_LoopStart()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Trace_LoopEnd()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Finish a Pass Record
+//
+//  MECHANICS:          This subroutine is called at the end of each pass through the main loop.  It:
+//                        - adds the state machines that are busy at the end of the pass to the record
+//                        - computes the pass time and adds it to the main loop statistics
+//                        - saves the record in the next location of TraceRing[]
+//                        - saves the record in TraceWorst if it is the longest pass so far
+//                        - updates the longest pass time for the record's combination of state machines
+//                          (TraceComboMax[])
+//                      The pass time is measured with the cycle counter, so it is not affected by changes
+//                      to the real time clock.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             TraceCur
+//
+//  OUTPUTS:            TraceRing[], TraceWorst, TraceComboMax[], TraceBlock[TRACE_LOOP]
+//
+//  ALTERS:             TraceCur, TraceRingNdx, TracePasses
+//
+//  CALLS:              Trace_SMBusy(), Trace_Record()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Trace_LoopEnd(void)
+{
+  uint8_t sm;
+
+  TraceCur.Flags |= ((uint32_t)Trace_SMBusy() << TRACE_SM_SHIFT);
+  TraceCur.Cycles = TRACE_CYCCNT() - TraceCur.StartCyc;
+  TraceCur.Pass = TracePasses++;
+  Trace_Record(TRACE_LOOP, TraceCur.Cycles);
+
+  TraceRing[TraceRingNdx] = TraceCur;
+  TraceRingNdx = ((TraceRingNdx + 1) & (TRACE_RING_SIZE - 1));
+
+  if (TraceCur.Cycles > TraceWorst.Cycles)
+  {
+    TraceWorst = TraceCur;
+  }
+  sm = (uint8_t)((TraceCur.Flags >> TRACE_SM_SHIFT) & (TRACE_NUM_COMBOS - 1));
+  if (TraceCur.Cycles > TraceComboMax[sm])
+  {
+    TraceComboMax[sm] = TraceCur.Cycles;
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Trace_LoopEnd()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Trace_Block()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Record Block Time
+//
+//  MECHANICS:          This subroutine adds a measured block time to the block statistics, and sets the
+//                      block's flag in the present pass record.  It is called by TRACE_STOP().
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             blk - the block number (TRACE_ONECYC .. TRACE_BKGND)
+//                      cycles - the measured time in core clock cycles
+//
+//  OUTPUTS:            TraceBlock[blk], TraceCur.Flags
+//
+//  ALTERS:             None
+//
+//  CALLS:              Trace_Record()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Trace_Block(uint8_t blk, uint32_t cycles)
+{
+  TraceCur.Flags |= (1UL << blk);
+  Trace_Record(blk, cycles);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Trace_Block()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Trace_Record()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Add a Time to the Block Statistics
+//
+//  MECHANICS:          This subroutine updates the count and maximum time of a block, and adds the time to
+//                      the block's histogram.  If the histogram bin is full, all of the block's bins are
+//                      halved first (see struct TRACE_BLOCK).
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             blk - the block number
+//                      cycles - the measured time in core clock cycles
+//
+//  OUTPUTS:            TraceBlock[blk]
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Trace_Record(uint8_t blk, uint32_t cycles)
+{
+  struct TRACE_BLOCK *bptr;
+  uint32_t bin;
+  uint8_t i;
+
+  bptr = &TraceBlock[blk];
+  if (bptr->Count < 0xFFFFFFFF)
+  {
+    bptr->Count++;
+  }
+  if (cycles > bptr->Max)
+  {
+    bptr->Max = cycles;
+  }
+
+  bin = cycles / TRACE_BIN_CYC;
+  if (bin >= TRACE_HIST_BINS)
+  {
+    bin = TRACE_HIST_BINS - 1;
+  }
+  if (bptr->Hist[bin] == 0xFFFF)
+  {
+    for (i = 0; i < TRACE_HIST_BINS; ++i)
+    {
+      bptr->Hist[i] >>= 1;
+    }
+  }
+  bptr->Hist[bin]++;
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Trace_Record()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Trace_Summary()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Compute the Block Percentiles
+//
+//  MECHANICS:          This subroutine computes the median (P50) and 99th percentile (P99) times of each
+//                      block from the block's histogram.  The percentiles are kept in TraceBlock[] so that
+//                      they can be read directly by the test port and over Modbus (Group 74).  It is called
+//                      on the one-second anniversary.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             TraceBlock[].Hist[]
+//
+//  OUTPUTS:            TraceBlock[].P50, TraceBlock[].P99
+//
+//  ALTERS:             None
+//
+//  CALLS:              Trace_Percentile()
+//
+//  EXECUTION TIME:     About 1000 histogram bins are read
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Trace_Summary(void)
+{
+  struct TRACE_BLOCK *bptr;
+  uint32_t total;
+  uint8_t i, j;
+
+  for (j = 0; j < TRACE_NUM_BLOCKS; ++j)
+  {
+    bptr = &TraceBlock[j];
+    total = 0;
+    for (i = 0; i < TRACE_HIST_BINS; ++i)
+    {
+      total += bptr->Hist[i];
+    }
+    bptr->P50 = Trace_Percentile(bptr, total, 50);
+    bptr->P99 = Trace_Percentile(bptr, total, 99);
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Trace_Summary()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Trace_Percentile()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Compute a Percentile From a Histogram
+//
+//  MECHANICS:          This subroutine finds the first histogram bin at which the running total of the bins
+//                      reaches pct percent of the total, and returns the upper edge of that bin.  The value
+//                      is limited to the block's maximum time, so a percentile in the last (open) bin, or in
+//                      a bin that is only partly used, is not larger than any measured time.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             bptr - pointer to the block statistics
+//                      total - the sum of the histogram bins
+//                      pct - the percentile (1 - 100)
+//
+//  OUTPUTS:            Returns the percentile time in core clock cycles (0 if there are no measurements)
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint32_t Trace_Percentile(struct TRACE_BLOCK *bptr, uint32_t total, uint32_t pct)
+{
+  uint32_t target, sum, edge;
+  uint8_t i;
+
+  if (total == 0)
+  {
+    return (0);
+  }
+  target = ((total * pct) + 99) / 100;          // Round up
+  sum = 0;
+  for (i = 0; i < (TRACE_HIST_BINS - 1); ++i)
+  {
+    sum += bptr->Hist[i];
+    if (sum >= target)
+    {
+      break;
+    }
+  }
+  edge = (i + 1) * TRACE_BIN_CYC;
+  return ( (edge < bptr->Max) ? edge : bptr->Max );
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Trace_Percentile()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_LOOP_TRACE
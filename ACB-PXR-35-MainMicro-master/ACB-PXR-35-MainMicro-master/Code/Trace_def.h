@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//
+//  MODULE NAME:        Trace_def.h
+//
+//  MECHANICS:          This is the definitions file for the Trace.c module.  It must be preceded by
+//                      Iod_def.h, since the tracer is only compiled in if ENABLE_LOOP_TRACE is defined
+//
+//  TARGET HARDWARE:    PXR35 Rev 1 and later boards
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   162    240214  DAH File Creation
+//   179    240302  DAH Traced blocks comment revised (the anniversary blocks are traced in main())
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+// Path for library files:
+//   IAR Systems\Embedded Workbench 8.3\arm\inc\c
+//
+//------------------------------------------------------------------------------------------------------------
+
+#ifndef TRACE_DEF_H
+#define TRACE_DEF_H
+
+//
+//------------------------------------------------------------------------------------------------------------
+//    Constants
+//------------------------------------------------------------------------------------------------------------
+
+// Traced blocks.  TRACE_LOOP is one pass through the main loop (one background pass if ENABLE_MAIN_SCHED is
+//   defined).  TRACE_BKGND is the code that follows the anniversary blocks, to the end of the pass.  The
+//   anniversary blocks and TRACE_BKGND are traced in main() around the main loop subroutine calls.  They
+//   are not used with the scheduler, since the blocks are then run in slices (see SchedStat[] instead)
+#define TRACE_LOOP              0           // Entire main loop pass
+#define TRACE_ONECYC            1           // One-cycle anniversary block
+#define TRACE_200MSEC           2           // 200msec anniversary block
+#define TRACE_1SEC              3           // 1sec anniversary block
+#define TRACE_5MIN              4           // 5min anniversary block
+#define TRACE_BKGND             5           // Code that is run each time through the main loop
+#define TRACE_NUM_BLOCKS        6
+
+// State machine flags.  A flag is set in a pass record if the state machine was busy (not idle) at either
+//   the start or the end of the pass.  Flash writes are made by SPI1_Flash_Manager() in the 1.5msec
+//   interrupt, so TRACE_SM_FLASH marks passes that were interrupted by the Flash writes
+#define TRACE_SM_HARM           0x01        // Harmonics (CH_State)
+#define TRACE_SM_DIST           0x02        // Disturbance capture (Dist_Flag)
+#define TRACE_SM_EXTCAP         0x04        // Extended capture (sExtCapState.State, ExtCap_xxFlag)
+#define TRACE_SM_EVENT          0x08        // Event manager (EventState)
+#define TRACE_SM_WF             0x10        // Event waveform capture (EV_WfState)
+#define TRACE_SM_FLASH          0x20        // SPI1 Flash (SPI1Flash.State, SPI1Flash.Req)
+#define TRACE_NUM_COMBOS        64          // Number of combinations of the state machine flags
+
+// Pass record flags.  Bits 0 - 7 are the blocks that ran (bit n is block n), and bits 8 - 15 are the state
+//   machine flags
+#define TRACE_SM_SHIFT          8
+
+// Number of pass records kept.  This must be a power of 2
+#define TRACE_RING_SIZE         64
+
+// Histogram bins.  Each bin is 50usec wide, so the bins cover 0 - 6.4msec.  The last bin also holds all
+//   longer times.  The percentiles are the upper edge of the bin, so they are accurate to 50usec
+#define TRACE_HIST_BINS         128
+#define TRACE_BIN_CYC           6000
+
+// Cycle counter.  On the target this is the DWT cycle counter, which runs at the core clock (120MHz).  In
+//   the host build, Host_CycCnt() returns the elapsed time scaled to 120MHz cycles
+#ifdef HOST_BUILD
+  #define TRACE_CYCCNT()        Host_CycCnt()
+#else
+  #define TRACE_CYCCNT()        (DWT->CYCCNT)
+#endif
+
+// Convert core clock cycles (120MHz) to nanoseconds.  The division is done first so that times up to 35sec
+//   do not overflow
+#define TRACE_CYC_TO_NSEC(x)    (((x) / 3) * 25)
+
+// Block timing macros.  These are placed around the anniversary blocks.  They compile to nothing unless
+//   ENABLE_LOOP_TRACE is defined in Iod_def.h.  They must only be used in the main loop
+#ifdef ENABLE_LOOP_TRACE
+  #define TRACE_START(blk)      TraceStartCyc[blk] = TRACE_CYCCNT()
+  #define TRACE_STOP(blk)       Trace_Block((blk), (TRACE_CYCCNT() - TraceStartCyc[blk]))
+#else
+  #define TRACE_START(blk)
+  #define TRACE_STOP(blk)
+#endif
+
+//
+//------------------------------------------------------------------------------------------------------------
+//    Structures
+//------------------------------------------------------------------------------------------------------------
+//
+// Pass record.  Times are in core clock cycles
+struct TRACE_REC
+{
+  uint32_t StartCyc;                        // Cycle count at the start of the pass
+  uint32_t Cycles;                          // Time for the pass
+  uint32_t Flags;                           // Blocks that ran, and state machine flags (TRACE_SM_SHIFT)
+  uint32_t Pass;                            // Pass number
+};
+
+// Block statistics.  Times are in core clock cycles.  The count saturates rather than rolls over.  When a
+//   histogram bin reaches its maximum value, all of the block's bins are halved, so the histogram keeps the
+//   shape of the distribution, weighted towards the recent passes.  P50 and P99 are computed from the
+//   histogram by Trace_Summary()
+struct TRACE_BLOCK
+{
+  uint32_t Count;                           // Number of measurements
+  uint32_t P50;                             // Median time
+  uint32_t P99;                             // 99th percentile time
+  uint32_t Max;                             // Maximum time
+  uint16_t Hist[TRACE_HIST_BINS];           // Histogram of the times
+};
+
+#endif                  // TRACE_DEF_H
@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//
+//  MODULE NAME:        Trace_ext.h
+//
+//  MECHANICS:          This is the declarations file for the Trace.c module
+//
+//  TARGET HARDWARE:    PXR35 Rev 1 and later boards
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   162    240214  DAH File Creation
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+// Path for library files:
+//   IAR Systems\Embedded Workbench 8.3\arm\inc\c
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Global Variable Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+extern struct TRACE_BLOCK TraceBlock[TRACE_NUM_BLOCKS];
+extern struct TRACE_REC TraceRing[TRACE_RING_SIZE];
+extern struct TRACE_REC TraceWorst;
+extern uint32_t TraceComboMax[TRACE_NUM_COMBOS];
+extern uint32_t TraceStartCyc[TRACE_NUM_BLOCKS];
+extern uint32_t TracePasses;
+extern uint8_t TraceRingNdx;
+extern const char * const TRACE_BLOCK_NAME[TRACE_NUM_BLOCKS];
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//                    Global Function Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+extern void Trace_Init(void);
+extern void Trace_Reset(void);
+extern void Trace_LoopStart(void);
+extern void Trace_LoopEnd(void);
+extern void Trace_Block(uint8_t blk, uint32_t cycles);
+extern void Trace_Summary(void);
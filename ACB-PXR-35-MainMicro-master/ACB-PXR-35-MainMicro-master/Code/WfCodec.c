@@ -0,0 +1,730 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//
+//  MODULE NAME:        WfCodec.c
+//
+//  MECHANICS:          Program module containing the waveform capture codec.  The trip, alarm, and extended
+//                      capture waveforms are normally stored in Flash as raw sample sets (struct
+//                      RAM_SAMPLES, 36 bytes per set, 103680 bytes per capture).  With the codec, each
+//                      channel of each cycle is coded as a separate block (see WfCodec_def.h):
+//                        - The voltages are stored exactly.  The currents are quantized to WF_CODEC_I_BITS
+//                          bits of the cycle peak of the channel.  If WF_CODEC_I_MAX_ERR is defined, a
+//                          current block that would be off by more than WF_CODEC_I_MAX_ERR amps is stored
+//                          raw instead, so the current error is bounded (0 = lossless)
+//                        - Each sample is predicted from the previous two (2nd-order difference), and the
+//                          prediction errors are packed at the width of the largest one.  If the samples
+//                          are noisy enough that this is not shorter, the offsets from the minimum are
+//                          packed instead
+//                      A 60Hz cycle changes slowly from sample to sample at 80 samples per cycle, so the
+//                      prediction errors are small, and a typical capture is 3 to 4 times smaller.  If
+//                      WF_CODEC_I_MAX_ERR is not defined, the longest possible capture fits in one Flash
+//                      block, so only one block per capture is erased and written.  Otherwise both blocks
+//                      of the slot are erased, the same as the uncoded captures.
+//                      The number of captures (NUM_TRIP_WAVEFORMS, etc.) has NOT been increased.  The
+//                      codec only shortens the Flash writes and the waveform reads.
+//                      The capture is written by the Flash waveform pipeline in Iod.c (Flash_PipeGather()),
+//                      which codes each cycle as soon as its samples have been received.  The index at the
+//                      start of the capture gives the location and mode of every block, so a single cycle
+//                      of a single channel is read with two Flash reads (WfCodec_Read()), instead of one
+//                      read per sample.
+//                      The codec is only compiled in if ENABLE_WF_CODEC is defined in Iod_def.h.
+//
+//  TARGET HARDWARE:    PXR35 Rev 1 and later boards
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   165    240217  DAH File Creation
+//   179    240302  DAH - Added the raw current blocks (WF_CODEC_I_MAX_ERR defined)
+//                          - WfCodec_GetChan() returns WF_CODEC_RAW_SCALE if a decoded current would be off
+//                            by more than WF_CODEC_I_MAX_ERR
+//                          - WfCodec_EncodeBlock(), WfCodec_BlockSize(), and WfCodec_DecodeBlock() revised
+//                            for the raw blocks
+//                          - WfCodec_Read() buffer sized with WF_CODEC_READ_BUF
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+// Path for library files:
+//   IAR Systems\Embedded Workbench 8.3\arm\inc\c
+//
+//------------------------------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------------------------------
+//                   Definitions
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global Definitions from external files...
+//
+#include "stm32f4xx.h"
+#include "stm32f407xx.h"
+#include "RealTime_def.h"
+#include "Iod_def.h"
+#include "Meter_def.h"
+#include "Intr_def.h"
+#include "WfCodec_def.h"
+#include "string.h"
+
+#ifdef ENABLE_WF_CODEC
+
+//
+//      Local Definitions used in this module...
+//
+#define WF_CODEC_RAW_SCALE      (-1.0f)     // WfCodec_GetChan() step size for a raw current block
+
+//
+//      Global Declarations from external files...
+//
+#include "Intr_ext.h"
+#include "Iod_ext.h"
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Declarations
+//------------------------------------------------------------------------------------------------------------
+//
+//      Global (Visible) Function Prototypes (These functions are called by other modules)
+//
+uint16_t WfCodec_EncodeCycle(uint16_t start, uint8_t zeros, uint8_t *dest, uint8_t *mode);
+uint16_t WfCodec_BlockSize(uint8_t chan, uint8_t mode);
+void WfCodec_DecodeBlock(uint8_t chan, uint8_t mode, const uint8_t *blk, uint8_t first, uint8_t num,
+                         uint8_t *dest);
+uint8_t WfCodec_Read(uint32_t wf_add, uint8_t cyc, uint8_t chan, uint8_t first, uint8_t num, uint8_t *dest);
+
+
+//      Local Function Prototypes (These functions are called only within this module)
+//
+float WfCodec_GetChan(uint8_t chan, uint16_t start, uint8_t zeros, int32_t *qptr);
+uint16_t WfCodec_EncodeBlock(uint8_t chan, const int32_t *qptr, float scale, uint8_t *dest, uint8_t *mode);
+uint8_t WfCodec_Width(uint32_t val);
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Storage Allocation - Global (Static) Variables
+//------------------------------------------------------------------------------------------------------------
+//
+//       These variables are used by other modules...
+//
+
+
+//       These variables are used only in this module...
+//
+
+
+
+//
+//------------------------------------------------------------------------------------------------------------
+//                   Global Constants used in this module and other modules
+//------------------------------------------------------------------------------------------------------------
+//
+// Location of the first sample of each channel in SampleBuf, in the codec channel order (same as SB_xx),
+//   and the distance between samples
+#ifdef ENABLE_SAMPLE_SOA
+  static void * const WF_CODEC_SB_START[WF_CODEC_CHANNELS] =
+  {
+    &SampleBuf.Ia[0], &SampleBuf.Ib[0], &SampleBuf.Ic[0], &SampleBuf.In[0], &SampleBuf.Igsrc[0],
+    &SampleBuf.Igres[0], &SampleBuf.VanAFE[0], &SampleBuf.VbnAFE[0], &SampleBuf.VcnAFE[0],
+    &SampleBuf.VanADC[0], &SampleBuf.VbnADC[0], &SampleBuf.VcnADC[0]
+  };
+  #define WF_CODEC_I_STRIDE     sizeof(float)
+  #define WF_CODEC_V_STRIDE     sizeof(int16_t)
+#else
+  static void * const WF_CODEC_SB_START[WF_CODEC_CHANNELS] =
+  {
+    &SampleBuf[0].Ia, &SampleBuf[0].Ib, &SampleBuf[0].Ic, &SampleBuf[0].In, &SampleBuf[0].Igsrc,
+    &SampleBuf[0].Igres, &SampleBuf[0].VanAFE, &SampleBuf[0].VbnAFE, &SampleBuf[0].VcnAFE,
+    &SampleBuf[0].VanADC, &SampleBuf[0].VbnADC, &SampleBuf[0].VcnADC
+  };
+  #define WF_CODEC_I_STRIDE     sizeof(struct RAM_SAMPLES)
+  #define WF_CODEC_V_STRIDE     sizeof(struct RAM_SAMPLES)
+#endif
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        WfCodec_EncodeCycle()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Code One Cycle of a Waveform Capture
+//
+//  MECHANICS:          This subroutine codes one cycle (80 sample sets) of SampleBuf, starting at index
+//                      start, into dest[].  Each channel is read out of SampleBuf (WfCodec_GetChan()) and
+//                      coded as one block (WfCodec_EncodeBlock()), in channel order.  The mode byte of each
+//                      block is stored in mode[].
+//                      If the capture starts in precycles that have not been filled (SampleBuf has not
+//                      been filled since startup), the first zeros samples of the cycle are coded as zeros,
+//                      the same as the uncoded capture.
+//
+//  CAVEATS:            The samples must have been received (behind SampleIndex).  dest[] must have room for
+//                      WF_CODEC_MAX_CYCLE bytes.  Takes about 250usec.
+//
+//  INPUTS:             start - the index in SampleBuf of the first sample set of the cycle
+//                      zeros - the number of sample sets at the start of the cycle that are zero
+//                      SampleBuf
+//
+//  OUTPUTS:            dest[] - the coded blocks
+//                      mode[] - the mode byte of each block (WF_CODEC_CHANNELS)
+//                      The subroutine returns the number of bytes in dest[]
+//
+//  ALTERS:             None
+//
+//  CALLS:              WfCodec_GetChan(), WfCodec_EncodeBlock()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint16_t WfCodec_EncodeCycle(uint16_t start, uint8_t zeros, uint8_t *dest, uint8_t *mode)
+{
+  int32_t q[WF_CODEC_SAMPLES];
+  float scale;
+  uint16_t len;
+  uint8_t chan;
+
+  len = 0;
+  for (chan=0; chan<WF_CODEC_CHANNELS; ++chan)
+  {
+    scale = WfCodec_GetChan(chan, start, zeros, q);
+    len += WfCodec_EncodeBlock(chan, q, scale, &dest[len], &mode[chan]);
+  }
+  return (len);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          WfCodec_EncodeCycle()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        WfCodec_GetChan()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Read One Channel of a Cycle From SampleBuf
+//
+//  MECHANICS:          This subroutine reads the 80 samples of one channel, starting at index start in
+//                      SampleBuf, into qptr[] as integers.  The index wraps around the end of SampleBuf.
+//                      The voltages (volts x 10) are copied as is.  The currents are quantized to
+//                      +/-WF_CODEC_I_MAXQ of the peak magnitude of the cycle:
+//                          q = round(x * WF_CODEC_I_MAXQ / peak)
+//                      and the step size (peak / WF_CODEC_I_MAXQ) is returned.  If the peak is zero, the
+//                      step size is zero and all of the values are zero.
+//                      If WF_CODEC_I_MAX_ERR is defined, each quantized current is decoded the same way as
+//                      WfCodec_DecodeBlock() does it (q x step).  If any of them is off by more than
+//                      WF_CODEC_I_MAX_ERR, the float samples themselves are copied into qptr[] (bit for
+//                      bit), and WF_CODEC_RAW_SCALE is returned, so the block is stored raw.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             chan - the codec channel (same as SB_IA .. SB_VCNADC)
+//                      start - the index in SampleBuf of the first sample
+//                      zeros - the number of samples at the start of the cycle that are zero
+//                      SampleBuf
+//
+//  OUTPUTS:            qptr[] - the samples (WF_CODEC_SAMPLES)
+//                      The subroutine returns the step size of the current samples (0 for the voltages), or
+//                      WF_CODEC_RAW_SCALE if the block is raw
+//
+//  ALTERS:             None
+//
+//  CALLS:              memcpy() (if WF_CODEC_I_MAX_ERR is defined)
+//
+//------------------------------------------------------------------------------------------------------------
+
+float WfCodec_GetChan(uint8_t chan, uint16_t start, uint8_t zeros, int32_t *qptr)
+{
+  float x[WF_CODEC_SAMPLES];
+  float peak, inv, step, tmp;
+  uint8_t *bptr;
+  uint16_t ndx;
+  uint8_t i;
+
+  bptr = (uint8_t *)WF_CODEC_SB_START[chan];
+  ndx = start;
+  if (chan < WF_CODEC_NUM_I)            // Currents
+  {
+    peak = 0;
+    for (i=0; i<WF_CODEC_SAMPLES; ++i)
+    {
+      x[i] = ( (i < zeros) ? 0.0f : *((float *)(bptr + (ndx * WF_CODEC_I_STRIDE))) );
+      tmp = ((x[i] < 0) ? (-x[i]) : x[i]);
+      if (tmp > peak)
+      {
+        peak = tmp;
+      }
+      if (++ndx >= TOTAL_SAMPLE_SETS)
+      {
+        ndx = 0;
+      }
+    }
+    if (peak > 0)
+    {
+      inv = WF_CODEC_I_MAXQ / peak;
+      step = peak / WF_CODEC_I_MAXQ;
+      for (i=0; i<WF_CODEC_SAMPLES; ++i)
+      {
+        tmp = x[i] * inv;
+        qptr[i] = (int32_t)((tmp < 0) ? (tmp - 0.5f) : (tmp + 0.5f));
+        if (qptr[i] > WF_CODEC_I_MAXQ)          // Rounding may be just past the peak
+        {
+          qptr[i] = WF_CODEC_I_MAXQ;
+        }
+        else if (qptr[i] < -WF_CODEC_I_MAXQ)
+        {
+          qptr[i] = -WF_CODEC_I_MAXQ;
+        }
+#ifdef WF_CODEC_I_MAX_ERR
+        tmp = (float)qptr[i] * step;            // Decoded value (separate statement, so the multiply is
+        tmp -= x[i];                            //   rounded the same as in WfCodec_DecodeBlock())
+        if ( (tmp > WF_CODEC_I_MAX_ERR) || (tmp < -WF_CODEC_I_MAX_ERR) )
+        {
+          memcpy(qptr, &x[0], sizeof(x));       // Too far off - store the floats raw
+          return (WF_CODEC_RAW_SCALE);
+        }
+#endif
+      }
+      return (step);
+    }
+    for (i=0; i<WF_CODEC_SAMPLES; ++i)
+    {
+      qptr[i] = 0;
+    }
+    return (0);
+  }
+  else                                  // Voltages
+  {
+    for (i=0; i<WF_CODEC_SAMPLES; ++i)
+    {
+      qptr[i] = ( (i < zeros) ? 0 : *((int16_t *)(bptr + (ndx * WF_CODEC_V_STRIDE))) );
+      if (++ndx >= TOTAL_SAMPLE_SETS)
+      {
+        ndx = 0;
+      }
+    }
+    return (0);
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          WfCodec_GetChan()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        WfCodec_EncodeBlock()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Code One Block
+//
+//  MECHANICS:          This subroutine codes the 80 samples of one channel of one cycle.  The width of both
+//                      codings is found first:
+//                          Offset:     the width of (max - min)
+//                          Predicted:  the width of the largest zigzagged prediction error.  The error is
+//                                      e = q[n] - (2q[n-1] - q[n-2]) (q[n] - q[n-1] for n = 1), and zigzag
+//                                      maps 0, -1, 1, -2, ... to 0, 1, 2, 3, ...
+//                      The shorter coding is used (offset if they are the same).  The header (scale for the
+//                      currents, then the int16 reference) is written, and then the 80 codes are packed ls
+//                      bit first.  Since there are 80 codes, the packed codes are always 10 x W bytes.
+//                      If scale is WF_CODEC_RAW_SCALE, qptr[] holds the float samples, and they are copied
+//                      into the block as is (WF_CODEC_RAW).
+//
+//  CAVEATS:            dest[] must have room for WF_CODEC_READ_BUF bytes
+//
+//  INPUTS:             chan - the codec channel
+//                      qptr[] - the samples (WF_CODEC_SAMPLES), int16 range, or the raw floats
+//                      scale - the step size of the current samples, or WF_CODEC_RAW_SCALE
+//
+//  OUTPUTS:            dest[] - the block
+//                      *mode - the mode byte of the block
+//                      The subroutine returns the number of bytes in the block
+//
+//  ALTERS:             None
+//
+//  CALLS:              WfCodec_Width(), memcpy()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint16_t WfCodec_EncodeBlock(uint8_t chan, const int32_t *qptr, float scale, uint8_t *dest, uint8_t *mode)
+{
+  int32_t qmin, qmax, err;
+  uint32_t code, maxcode, acc;
+  int16_t ref;
+  uint8_t *dptr;
+  uint8_t i, wid, pred, nbits;
+
+  if (scale < 0)                        // Raw current block
+  {
+    *mode = WF_CODEC_RAW;
+    memcpy(dest, qptr, WF_CODEC_RAW_I_BLOCK);
+    return (WF_CODEC_RAW_I_BLOCK);
+  }
+
+  // Find the width of each coding
+  qmin = qmax = qptr[0];
+  maxcode = 0;
+  for (i=1; i<WF_CODEC_SAMPLES; ++i)
+  {
+    if (qptr[i] < qmin)
+    {
+      qmin = qptr[i];
+    }
+    else if (qptr[i] > qmax)
+    {
+      qmax = qptr[i];
+    }
+    err = ( (i == 1) ? (qptr[1] - qptr[0]) : (qptr[i] - (2 * qptr[i-1]) + qptr[i-2]) );
+    code = ( (err < 0) ? ((((uint32_t)(-err)) << 1) - 1) : (((uint32_t)err) << 1) );
+    if (code > maxcode)
+    {
+      maxcode = code;
+    }
+  }
+  wid = WfCodec_Width((uint32_t)(qmax - qmin));
+  i = WfCodec_Width(maxcode);
+  pred = (i < wid);
+  if (pred)
+  {
+    wid = i;
+  }
+  *mode = ( (pred) ? (WF_CODEC_PRED | wid) : wid );
+
+  // Header
+  dptr = dest;
+  if (chan < WF_CODEC_NUM_I)
+  {
+    memcpy(dptr, &scale, sizeof(float));
+    dptr += sizeof(float);
+  }
+  ref = (int16_t)( (pred) ? qptr[0] : qmin );
+  memcpy(dptr, &ref, sizeof(int16_t));
+  dptr += sizeof(int16_t);
+
+  // Codes
+  acc = 0;
+  nbits = 0;
+  for (i=0; i<WF_CODEC_SAMPLES; ++i)
+  {
+    if (!pred)
+    {
+      code = (uint32_t)(qptr[i] - qmin);
+    }
+    else if (i == 0)
+    {
+      code = 0;
+    }
+    else
+    {
+      err = ( (i == 1) ? (qptr[1] - qptr[0]) : (qptr[i] - (2 * qptr[i-1]) + qptr[i-2]) );
+      code = ( (err < 0) ? ((((uint32_t)(-err)) << 1) - 1) : (((uint32_t)err) << 1) );
+    }
+    acc |= (code << nbits);
+    nbits += wid;
+    while (nbits >= 8)
+    {
+      *dptr++ = (uint8_t)acc;
+      acc >>= 8;
+      nbits -= 8;
+    }
+  }
+
+  return ((uint16_t)(dptr - dest));
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          WfCodec_EncodeBlock()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        WfCodec_Width()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Number of Bits in a Value
+//
+//  MECHANICS:          This subroutine returns the number of bits needed to hold val (0 for 0)
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             val - the value
+//
+//  OUTPUTS:            The subroutine returns the number of bits
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t WfCodec_Width(uint32_t val)
+{
+  uint8_t wid;
+
+  wid = 0;
+  while (val != 0)
+  {
+    ++wid;
+    val >>= 1;
+  }
+  return (wid);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          WfCodec_Width()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        WfCodec_BlockSize()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Size of a Coded Block
+//
+//  MECHANICS:          This subroutine returns the number of bytes in a block from its channel and mode
+//                      byte: the header plus 80 codes of W bits (10 x W bytes), or 80 floats for a raw
+//                      current block
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             chan - the codec channel
+//                      mode - the mode byte of the block
+//
+//  OUTPUTS:            The subroutine returns the number of bytes in the block
+//
+//  ALTERS:             None
+//
+//  CALLS:              None
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint16_t WfCodec_BlockSize(uint8_t chan, uint8_t mode)
+{
+  if (mode & WF_CODEC_RAW)
+  {
+    return (WF_CODEC_RAW_I_BLOCK);
+  }
+  return ( ((chan < WF_CODEC_NUM_I) ? WF_CODEC_I_HDR : WF_CODEC_V_HDR)
+                + (((uint16_t)(mode & WF_CODEC_WIDTH) * WF_CODEC_SAMPLES) / 8) );
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          WfCodec_BlockSize()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        WfCodec_DecodeBlock()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Decode One Block
+//
+//  MECHANICS:          This subroutine decodes the samples of one block, and stores num of them, starting
+//                      with sample first, in dest[].  The samples are stored in the same format as in
+//                      struct RAM_SAMPLES: floats (4 bytes) for the currents, int16s (2 bytes) for the
+//                      voltages, in the processor's byte order.  dest[] does not have to be aligned.
+//                      The codes are unpacked ls bit first.  For predicted coding, each sample is the
+//                      prediction from the previous two plus the un-zigzagged code, so the samples are
+//                      always decoded from the start of the block.
+//                      The samples of a raw current block are copied as is.
+//
+//  CAVEATS:            first + num must not be more than 80
+//
+//  INPUTS:             chan - the codec channel
+//                      mode - the mode byte of the block
+//                      blk[] - the block
+//                      first - the first sample to store (0 - 79)
+//                      num - the number of samples to store
+//
+//  OUTPUTS:            dest[] - the samples
+//
+//  ALTERS:             None
+//
+//  CALLS:              memcpy()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void WfCodec_DecodeBlock(uint8_t chan, uint8_t mode, const uint8_t *blk, uint8_t first, uint8_t num,
+                         uint8_t *dest)
+{
+  float scale, fval;
+  int32_t q, q1, q2;
+  uint32_t acc, code, mask;
+  int16_t ref, ival;
+  uint8_t i, wid, nbits;
+
+  if (mode & WF_CODEC_RAW)
+  {
+    memcpy(dest, &blk[first * sizeof(float)], (num * sizeof(float)));
+    return;
+  }
+
+  scale = 0;
+  if (chan < WF_CODEC_NUM_I)
+  {
+    memcpy(&scale, blk, sizeof(float));
+    blk += sizeof(float);
+  }
+  memcpy(&ref, blk, sizeof(int16_t));
+  blk += sizeof(int16_t);
+
+  wid = (mode & WF_CODEC_WIDTH);
+  mask = ((uint32_t)1 << wid) - 1;
+  acc = 0;
+  nbits = 0;
+  q1 = q2 = ref;
+  for (i=0; i<(first + num); ++i)
+  {
+    while (nbits < wid)
+    {
+      acc |= ((uint32_t)(*blk++) << nbits);
+      nbits += 8;
+    }
+    code = (acc & mask);
+    acc >>= wid;
+    nbits -= wid;
+
+    if (!(mode & WF_CODEC_PRED))
+    {
+      q = ref + (int32_t)code;
+    }
+    else
+    {
+      q = ( (code & 1) ? (-(int32_t)((code + 1) >> 1)) : ((int32_t)(code >> 1)) );
+      if (i == 1)
+      {
+        q += q1;
+      }
+      else if (i > 1)
+      {
+        q += (2 * q1) - q2;
+      }
+      else
+      {
+        q += ref;
+      }
+    }
+    q2 = q1;
+    q1 = q;
+
+    if (i >= first)
+    {
+      if (chan < WF_CODEC_NUM_I)
+      {
+        fval = (float)q * scale;
+        memcpy(dest, &fval, sizeof(float));
+        dest += sizeof(float);
+      }
+      else
+      {
+        ival = (int16_t)q;
+        memcpy(dest, &ival, sizeof(int16_t));
+        dest += sizeof(int16_t);
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          WfCodec_DecodeBlock()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        WfCodec_Read()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Read Samples From a Coded Waveform Capture
+//
+//  MECHANICS:          This subroutine reads num samples of one channel of one cycle of a coded capture in
+//                      Flash, starting with sample first, into dest[] (see WfCodec_DecodeBlock()):
+//                        1) The index entry for the cycle is read
+//                        2) The address of the block is the start of the capture plus the offset of the
+//                           cycle plus the sizes of the blocks of the channels before it
+//                        3) The block is read and decoded
+//                      The blocks are word-aligned, and the Flash words are read the same way they were
+//                      written, so the bytes are in the same order as they were in the page buffer.
+//
+//  CAVEATS:            Takes about 100usec for a voltage block, with the SPI1 bus at 15MHz
+//                      Flash_Read() is called, so SPI1 must not be in use by another thread
+//
+//  INPUTS:             wf_add - the byte address of the capture in Flash
+//                      cyc - the cycle (0 - 35)
+//                      chan - the codec channel
+//                      first - the first sample (0 - 79)
+//                      num - the number of samples (first + num must not be more than 80)
+//
+//  OUTPUTS:            dest[] - the samples
+//                      The subroutine returns True if the samples were read.  It returns False if the cycle
+//                      was not written (the index entry is erased), and dest[] is not changed
+//
+//  ALTERS:             None
+//
+//  CALLS:              Flash_Read(), WfCodec_BlockSize(), WfCodec_DecodeBlock()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t WfCodec_Read(uint32_t wf_add, uint8_t cyc, uint8_t chan, uint8_t first, uint8_t num, uint8_t *dest)
+{
+  struct WF_CODEC_DIR dir;
+  uint16_t blk[WF_CODEC_READ_BUF/2];
+  uint32_t add;
+  uint8_t i;
+
+  Flash_Read((wf_add + (cyc * WF_CODEC_DIR_SIZE)), (WF_CODEC_DIR_SIZE/2), (uint16_t *)(&dir));
+  if (dir.Offset >= WF_CODEC_SLOT_BYTES)
+  {
+    return (FALSE);
+  }
+  add = wf_add + dir.Offset;
+  for (i=0; i<chan; ++i)
+  {
+    add += WfCodec_BlockSize(i, dir.Mode[i]);
+  }
+  Flash_Read(add, (WfCodec_BlockSize(chan, dir.Mode[chan]) / 2), &blk[0]);
+  WfCodec_DecodeBlock(chan, dir.Mode[chan], (uint8_t *)(&blk[0]), first, num, dest);
+  return (TRUE);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          WfCodec_Read()
+//------------------------------------------------------------------------------------------------------------
+
+#endif                  // ENABLE_WF_CODEC
@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------------------------------------
+//                      Eaton Corporation
+//
+//                      Proprietary Information
+//                      (C) Copyright 2024
+//                      All rights reserved
+//
+//                      PXR35 Electronic Trip Unit
+//
+//------------------------------------------------------------------------------------------------------------
+//  AUTHORS:            Daniel A. Hosko         (412)893-2834
+//                      Eaton Corporation
+//                      1000 Cherrington Parkway
+//                      Moon Twp, PA  15108-4312
+//                      (412)893-3300
+//
+//------------------------------------------------------------------------------------------------------------
+//  PRODUCT:            PXR35       Trip unit for air circuit and molded-case circuit breakers
+//
+//  FIRMWARE DRAWING:   ????????    This drawing combines the unprogrammed STM32F4207 with the code's
+//                                  flash programming file to produce an "assembly group" that is the
+//                                  programmed device.
+//
+//  PROCESSOR:          ST Micro STM32F407
+//
+//  COMPILER:           IAR C/C++ Compiler for ARM - v8.40.1.21539
+//                      IAR Embedded Workbench from IAR Systems
+//
+//  MODULE NAME:        WfCodec_def.h
+//
+//  MECHANICS:          This is the definitions file for the WfCodec.c module.  It must be preceded by
+//                      Iod_def.h, since the codec is only compiled in if ENABLE_WF_CODEC is defined
+//
+//  TARGET HARDWARE:    PXR35 Rev 1 and later boards
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//  Development Revision History:
+//   165    240217  DAH File Creation
+//   179    240302  DAH - Added the raw (lossless) current blocks and the current error bound
+//                          - Added WF_CODEC_I_MAX_ERR (commented out), WF_CODEC_RAW, WF_CODEC_RAW_I_BLOCK,
+//                            WF_CODEC_SLOT_BLOCKS, and WF_CODEC_READ_BUF
+//                          - WF_CODEC_SLOT_BYTES is two Flash blocks if WF_CODEC_I_MAX_ERR is defined
+//
+//------------------------------------------------------------------------------------------------------------
+//
+//------------------------------------------------------------------------------------------------------------
+//                    Includes and Declarations
+// Path for <>:
+//   1) Directories with the -I option
+//   2) Directories specified using the C_INCLUDE environment variable, if any
+//   3) The automatically set up library system include directories
+// Path for "":
+//   1) Directory of the source file in which the #include statement occurs
+//   2) Directories with the -I option
+//   3) Directories specified using the C_INCLUDE environment variable, if any
+// Path for library files:
+//   IAR Systems\Embedded Workbench 8.3\arm\inc\c
+//
+//------------------------------------------------------------------------------------------------------------
+
+#ifndef WFCODEC_DEF_H
+#define WFCODEC_DEF_H
+
+//
+//------------------------------------------------------------------------------------------------------------
+//    Constants
+//------------------------------------------------------------------------------------------------------------
+
+// Compressed waveform capture layout (ENABLE_WF_CODEC defined).  A capture is coded one block per channel
+//   per cycle (80 samples), so that any cycle of any channel can be read without the rest of the capture.
+//   The capture is stored in the first Flash block (16 sectors) of its waveform slot, or in both blocks if
+//   WF_CODEC_I_MAX_ERR is defined (see below):
+//     Pages 0 - 2: Index - one struct WF_CODEC_DIR per cycle (36 x 16 = 576 bytes)
+//     Page 3 on:   Data - the blocks of cycle 0 (Ia ... VcnADC), then the blocks of cycle 1, etc.
+//   A block is:
+//     Currents: float scale (4 bytes), int16 reference (2 bytes), 80 x W-bit codes
+//               or, for a raw block, the 80 floats as they are in SampleBuf (320 bytes)
+//     Voltages: int16 reference (2 bytes), 80 x W-bit codes
+//   The mode byte of the block (in the index) gives the width W (b4..0) and the coding (b7, b6):
+//     Raw (b6 = 1):        the currents are not coded (W = 0)
+//     Offset (b7 = 0):     code = q[n] - reference, where reference = min(q[])
+//     Predicted (b7 = 1):  code = zigzag(q[n] - (2q[n-1] - q[n-2])), reference = q[0], code[0] = 0
+//                          (q[n-1] is used as the prediction for n = 1)
+//   q[] are the voltages (volts x 10, lossless), or the currents quantized to +/-WF_CODEC_I_MAXQ of the
+//   cycle peak (scale = peak/WF_CODEC_I_MAXQ).  The current error is at most half a step, or
+//   peak/(2 x WF_CODEC_I_MAXQ).  The encoder uses whichever coding is shorter, so a block is never longer
+//   than the offset coding.  Block sizes are always even, so the blocks stay word-aligned in Flash (the
+//   words are sent ms byte first)
+// The currents are only quantized if WF_CODEC_I_MAX_ERR is not defined.  If it is defined, it is the largest
+//   current error allowed (amps).  The encoder checks the decoded value of every current sample, and if any
+//   of them is off by more than WF_CODEC_I_MAX_ERR, the block is stored raw instead.  Setting it to 0 makes
+//   the currents lossless (only blocks that decode exactly, such as all zeros, are coded).  A raw block is
+//   as large as the uncoded samples of the channel, so a capture with raw blocks may need the second Flash
+//   block of its slot, and both blocks are erased
+#define WF_CODEC_CYCLES         36          // Cycles per capture
+#define WF_CODEC_SAMPLES        80          // Samples per block (one cycle)
+#define WF_CODEC_CHANNELS       12          // Ia, Ib, Ic, In, Igsrc, Igres, VanAFE ... VcnADC
+#define WF_CODEC_NUM_I          6           // Current channels (floats).  The rest are voltages (int16s)
+#define WF_CODEC_I_BITS         13          // Current resolution (bits, including sign).  13 max, see below
+#define WF_CODEC_I_MAXQ         ((1 << (WF_CODEC_I_BITS - 1)) - 1)
+//#define WF_CODEC_I_MAX_ERR      0.0f        // Largest current error (amps).  0 = lossless currents
+#define WF_CODEC_PRED           0x80        // Mode byte: predicted coding
+#define WF_CODEC_RAW            0x40        // Mode byte: raw current block
+#define WF_CODEC_WIDTH          0x1F        // Mode byte: code width mask
+#define WF_CODEC_I_HDR          6           // Current block header (scale, reference)
+#define WF_CODEC_V_HDR          2           // Voltage block header (reference)
+#define WF_CODEC_MAX_BLOCK      (WF_CODEC_V_HDR + ((WF_CODEC_SAMPLES * 16) / 8))
+#define WF_CODEC_RAW_I_BLOCK    (WF_CODEC_SAMPLES * 4)      // Raw current block (80 floats)
+#define WF_CODEC_DIR_SIZE       16          // sizeof(struct WF_CODEC_DIR)
+#define WF_CODEC_INDEX_PAGES    (((WF_CODEC_CYCLES * WF_CODEC_DIR_SIZE) + 255) / 256)
+#define WF_CODEC_DATA_START     (WF_CODEC_INDEX_PAGES * 256)
+#ifdef WF_CODEC_I_MAX_ERR
+  #define WF_CODEC_SLOT_BLOCKS  2           // Flash blocks that are written and erased per capture
+#else
+  #define WF_CODEC_SLOT_BLOCKS  1
+#endif
+#define WF_CODEC_SLOT_BYTES     (WF_CODEC_SLOT_BLOCKS * 16 * 4096UL)
+#define WF_CODEC_TP_SETS        7           // Samples per test port read (same as the uncoded page)
+
+// Longest coded cycle (bytes): every current block raw (WF_CODEC_I_MAX_ERR defined) or offset coded at the
+//   full width, and every voltage block offset coded at the full width.  Without WF_CODEC_I_MAX_ERR, the
+//   whole capture must fit in one block even if nothing compresses, so a capture never needs the second
+//   block of its slot and the second block does not have to be erased.  This limits WF_CODEC_I_BITS to 13
+#ifdef WF_CODEC_I_MAX_ERR
+  #define WF_CODEC_MAX_I_BLOCK  WF_CODEC_RAW_I_BLOCK
+#else
+  #define WF_CODEC_MAX_I_BLOCK  (WF_CODEC_I_HDR + ((WF_CODEC_SAMPLES * WF_CODEC_I_BITS) / 8))
+#endif
+#define WF_CODEC_READ_BUF       ( (WF_CODEC_MAX_I_BLOCK > WF_CODEC_MAX_BLOCK) ?                            \
+                                                            WF_CODEC_MAX_I_BLOCK : WF_CODEC_MAX_BLOCK )
+#define WF_CODEC_MAX_CYCLE      ( (WF_CODEC_NUM_I * WF_CODEC_MAX_I_BLOCK)                                  \
+                                + ((WF_CODEC_CHANNELS - WF_CODEC_NUM_I) * WF_CODEC_MAX_BLOCK) )
+#define WF_CODEC_STAGE_SIZE     (256 + WF_CODEC_MAX_CYCLE)  // Coded bytes waiting to be written to Flash
+
+#ifdef ENABLE_WF_CODEC
+  #ifndef ENABLE_SPI1_DMA
+    #error ENABLE_WF_CODEC requires ENABLE_SPI1_DMA
+  #endif
+  #if ((WF_CODEC_DATA_START + (WF_CODEC_CYCLES * WF_CODEC_MAX_CYCLE)) > WF_CODEC_SLOT_BYTES)
+    #error WF_CODEC_I_BITS is too large for a capture to fit in its Flash blocks
+  #endif
+#endif
+
+// Codec channel number from the byte offset of the value in struct RAM_SAMPLES (the waveform read requests
+//   from the display processor and the test port are given as offsets)
+#define WF_CODEC_CHAN(ofs)      ( ((ofs) < 24) ? ((ofs) / 4) : (WF_CODEC_NUM_I + (((ofs) - 24) / 2)) )
+
+//
+//------------------------------------------------------------------------------------------------------------
+//    Structures
+//------------------------------------------------------------------------------------------------------------
+//
+// Index entry for one cycle.  Offset is the byte offset of the cycle's first block from the start of the
+//   capture, or 0xFFFFFFFF (erased) if the cycle was not written (the capture was aborted).  The blocks
+//   follow in channel order, so the offset of a block is Offset plus the sizes of the blocks before it
+//   (WfCodec_BlockSize())
+struct WF_CODEC_DIR
+{
+  uint32_t Offset;                          // Offset of the first block of the cycle
+  uint8_t Mode[WF_CODEC_CHANNELS];          // Mode byte (coding and width) of each block
+};
+
+#endif                  // WFCODEC_DEF_H
@@ -151,6 +151,12 @@
 
 
 
+#elif defined ( HOST_BUILD ) /*--------------- Host (off-target) Build ---------------*/
+/* Portable C equivalents of the core functions - see HostShim_def.h */
+
+#include "HostShim_def.h"
+
+
 #elif defined ( __GNUC__ ) /*------------------ GNU Compiler ---------------------*/
 /* GNU gcc specific functions */
 
@@ -318,6 +318,12 @@ __STATIC_INLINE void __set_FPSCR(uint32_t fpscr)
 #include <cmsis_ccs.h>
 
 
+#elif defined ( HOST_BUILD ) /*--------------- Host (off-target) Build ---------------*/
+/* Portable C equivalents of the core functions - see HostShim_def.h */
+
+#include "HostShim_def.h"
+
+
 #elif defined ( __GNUC__ ) /*------------------ GNU Compiler ---------------------*/
 /* GNU gcc specific functions */
 
@@ -304,6 +304,12 @@ __attribute__((section(".revsh_text"))) __STATIC_INLINE __ASM int32_t __REVSH(in
 #include <cmsis_ccs.h>
 
 
+#elif defined ( HOST_BUILD ) /*--------------- Host (off-target) Build ---------------*/
+/* Portable C equivalents of the core functions - see HostShim_def.h */
+
+#include "HostShim_def.h"
+
+
 #elif defined ( __GNUC__ ) /*------------------ GNU Compiler ---------------------*/
 /* GNU gcc specific functions */
 
@@ -1637,6 +1637,376 @@
 //                          - Intr.c revised
 //                      - Fixed bugs in Phase Rotation Protection (JIRA item 1947)
 //                          - Prot.c revised
+//   153    240205  DAH - Added the host (off-target) build
+//                          - The protection and metering modules can now be compiled with gcc on an x86-64
+//                            Linux PC and profiled with perf and valgrind.  See HostShim_def.h
+//                          - HostShim.c, HostShim_def.h added
+//                          - core_cmInstr.h, core_cmFunc.h, core_cm4_simd.h revised to include
+//                            HostShim_def.h when HOST_BUILD is defined
+//                          - stm32f4xx.h revised to add SRAM1_LOC and SRAM2_LOC
+//                          - CAMCom.c, DispComm.c, Intr.c, Meter.c, Modbus.c, Prot.c, Intr_ext.h,
+//                            Meter_ext.h revised to use SRAM1_LOC and SRAM2_LOC
+//   154    240206  DAH - Added the sample-stream replay engine to the host build
+//                          - Recorded or synthetic samples are fed through the sampling interrupts
+//                            (DMA1_Stream0_IRQHandler(), DMA2_Stream0_IRQHandler()) at 4800 samples/sec of
+//                            simulated time, with SysTick_Handler(), TIM4_IRQHandler(), and the one-cycle
+//                            and 200msec anniversary subroutines run in lockstep.  The host CPU time per
+//                            sample and per anniversary is reported
+//                          - HostReplay.c, HostReplay_def.h, HostReplay_ext.h added
+//                          - HostShim_def.h revised
+//                      - Corrected the INT_a1[] declaration
+//                          - Meter_ext.h revised
+//   155    240207  DAH - Added an execution-time stage profiler, compiled in with ENABLE_STAGE_PROFILER
+//                        (Iod_def.h)
+//                          - The DWT cycle counter times each stage of DMA1_Stream0_IRQHandler() and each
+//                            main-loop anniversary block.  The count, min, max, last, and total cycles and a
+//                            log2 histogram are kept for each stage
+//                          - The statistics are read with the "PF" test port command (reset with "PR") or
+//                            over Modbus (Group 73, registers 50688 - 50799)
+//                          - The profiler also runs in the host build, using a clock_gettime() cycle
+//                            counter stub (Host_CycCnt())
+//                          - main() revised to call Prof_Init() and to time the anniversary blocks and the
+//                            main loop
+//                          - Profile.c, Profile_def.h, Profile_ext.h added
+//                          - Intr.c, Test.c, Test_def.h, Modbus.c, Iod_def.h, HostShim.c, HostShim_def.h,
+//                            HostReplay.c, PXR35_ProtProc.ewp revised
+//   156    240208  DAH - Replaced the FFT (chirp-z) harmonics computations with a cycle-folded DFT that
+//                        only computes the bins used in the IEC61000-4-7 grouping.  Each waveform takes three
+//                        passes through Calc_Harmonics(), and no pass runs an FFT
+//                          - Meter.c: Harm_FoldCycles(), Harm_BinsMag(), Harm_Goertzel(), and Harm_Group()
+//                            added, Calc_Harmonics() revised.  The FFT method is retained in the host build
+//                            as Harm_FFTMag()
+//                          - Harm_Tables.h: HARM_COS_TBL[] added
+//                          - HostReplay.c: Replay_HarmBench() and the -harm option added to compare the two
+//                            methods
+//                          - Meter_ext.h, HostReplay_def.h, HostReplay_ext.h revised
+//   157    240209  DAH - Added an optional layout of SampleBuf by channel (structure of arrays) instead of
+//                        by sample set, enabled with ENABLE_SAMPLE_SOA in Iod_def.h.  A window of samples of
+//                        one channel is then at most two contiguous blocks, so the harmonics computations
+//                        move the samples a block at a time instead of one 36-byte sample set at a time.  The
+//                        waveforms stored in Flash and sent to the sampled-value CAMs are still sample sets
+//                          - Intr.c, Intr_def.h, Intr_ext.h: SampleBuf_Span(), SampleBuf_GetRecord(),
+//                            CAMSampleRec[], and SAMPLEBUF() added
+//                          - IntrInline_def.h: buffer_samples() revised
+//                          - Iod.c: Flash_WriteSampleSets() added, Flash_WriteWaveform() revised
+//                          - Meter.c: Calc_Harmonics() revised, SampleBuf[] accesses use SAMPLEBUF()
+//                          - HostReplay.c: Replay_GatherBench() and the -gather option added to compare the
+//                            two layouts
+//                          - Iod_def.h, HostReplay_def.h, HostReplay_ext.h revised
+//   158    240210  DAH - Added an optional integer (SIMD) computation of the one-cycle voltage sums of
+//                        squares, enabled with ENABLE_SIMD_SOS in Iod_def.h.  Instead of squaring and adding
+//                        the float AFE and ADC voltages to twelve one-cycle sums (and six 200msec sums) every
+//                        sample, the int16 samples in SampleBuf are summed in 64-bit integers every half
+//                        cycle with the Cortex-M4 dual 16-bit multiply-accumulate instruction (SMLALD), two
+//                        samples per instruction.  This is the same 0.1V integer method that is used for the
+//                        one-cycle current sums.  It also fixes the ADC Van, Vbn, and Vcn one-cycle sums,
+//                        which were not being reset in save_OC_SOS()
+//                          - Intr.c: Volt_SOS_Block() added, DMA1_Stream0_IRQHandler() and AFEISR_VarInit()
+//                            revised
+//                          - IntrInline_def.h: update_Volt_SOS_Block() added, update_VlnAFE_SOS(),
+//                            update_VllAFE_SOS(), and save_OC_SOS() revised
+//                          - HostShim_def.h: portable C versions of the SIMD functions added
+//                          - HostReplay.c: Replay_SOSBench() and the -sos option added to check the integer
+//                            sums
+//                          - Iod_def.h, Intr_def.h, Intr_ext.h, Meter_def.h, HostReplay_def.h,
+//                            HostReplay_ext.h revised
+//   159    240211  DAH - Added block processing of the AFE samples.  AFE_Process_Block() decodes,
+//                        integrates, scales, and filters a block of AFE frames one channel at a time, with
+//                        the filter states and cal constants in local variables, instead of calling
+//                        AFE_Integrate_Sample(), AFE_Cal_Scale(), and Meter_Filter_Sample() for each channel.
+//                        The sample interrupt still processes one frame at a time, so the protection latency
+//                        is unchanged.  Samples with errors, out-of-range readings, or seeding still go
+//                        through the AFE/ADC state machine, and the results are identical
+//                          - Meter.c: AFE_Process_Block() added, AFE_Process_Samples() renamed
+//                            AFE_Process_Chan(), new AFE_Process_Samples() added
+//                          - HostReplay.c: Replay_AFEBlockBench() and the -afeblk option added to compare
+//                            the two methods
+//                          - Meter_def.h, Meter_ext.h, HostReplay_def.h, HostReplay_ext.h revised
+//   160    240212  DAH - Added precomputed calibration coefficients.  Apply_CalConstants() computes the
+//                        gain, bias (-offset * gain), and reciprocal gain for each channel whenever the cal
+//                        constants are read, and every 200msec to pick up direct changes to the constants.
+//                        The sample interrupt scales each sample with one multiply and add, and no longer
+//                        divides when seeding the integrator.  The integrator and DC filter states are reset
+//                        if they become NaN or infinite
+//                          - Meter.c: Apply_CalConstants() added, AFE_Cal_Scale(), ADC_Cal_Scale(),
+//                            AFE_Integrate_Sample(), Meter_Filter_Sample(), AFE_Process_Block(), and
+//                            AFE_Process_Chan() revised
+//                          - Iod.c: the Read..CalConstants() subroutines call Apply_CalConstants()
+//                          - main.c: Apply_CalConstants() added to the 200msec anniversary subroutines
+//                          - Meter_def.h, Meter_ext.h, HostReplay.c revised
+//   161    240213  DAH - Added an optional cooperative scheduler for the main loop.  When ENABLE_MAIN_SCHED
+//                        is defined, the main loop code is split into tasks (SPI1 flags, one-cycle, 200msec,
+//                        1sec, and 5min anniversaries, and background), and each task into short slices.
+//                        Sched_Run() runs one slice of the highest-priority ready task at a time, so the
+//                        one-cycle code no longer waits for a whole pass of the background code, and keeps
+//                        the slice time, response time, budget overrun, and missed deadline statistics for
+//                        each task.  The anniversary flags are cleared when the task is released, so an
+//                        anniversary that occurs while its code is running is no longer lost.  The original
+//                        main loop is used if ENABLE_MAIN_SCHED is not defined
+//                          - Sched.c, Sched_def.h, Sched_ext.h added
+//                          - main.c: MAIN_SCHED_TASK[] and Main_SPI1Slice() thru Main_BkgndSlice() added,
+//                            main() revised
+//                          - Test.c: test port commands "SS" (display) and "SR" (reset) added
+//                          - HostShim.c: simulated cycle counter added
+//                          - HostReplay.c: Replay_SchedSim() and the -sched option added to compare the main
+//                            loop timing with and without the scheduler
+//                          - Iod_def.h, Test_def.h, HostShim_def.h, HostReplay_def.h, HostReplay_ext.h,
+//                            PXR35_ProtProc.ewp revised
+//   162    240214  DAH - Added an optional main loop latency tracer.  When ENABLE_LOOP_TRACE is defined, each
+//                        pass of the main loop is timed with the cycle counter and recorded with the blocks
+//                        that ran (one-cycle, 200msec, 1sec, 5min anniversaries, and background) and the
+//                        state machines that were busy (harmonics, disturbance capture, extended capture,
+//                        event, waveform capture, and SPI1 Flash).  Each block also keeps a histogram, so
+//                        the 50th and 99th percentile times are available, and the longest pass is kept for
+//                        each combination of state machines.  maxlooptime is now taken from the tracer, since
+//                        the old measurement stops once SKIP_LOOPTIME_MEAS is set by a time change
+//                          - Trace.c, Trace_def.h, Trace_ext.h added
+//                          - main.c: main(), Main_1secSlice(), Main_BkgndSlice() revised
+//                          - Test.c: test port commands "DL" (display) and "RL" (reset) added
+//                          - Modbus.c: Group 74 (registers 50816 - 50999) added
+//                          - Iod_def.h, Test_def.h, Meter_ext.h, Events_ext.h, PXR35_ProtProc.ewp revised
+//   163    240215  DAH - Added an optional SPI2 FRAM transaction engine.  When ENABLE_SPI2_DMA is defined,
+//                        the FRAM reads and writes are queued and run by the SPI2 RXNE and DMA1 Stream 4
+//                        (SPI2 Tx) interrupts instead of polling SPI2, and SPI2 is only reconfigured when the
+//                        frame width changes.  Short FRAM writes and the energy write are posted, so the
+//                        caller does not wait for the bus.  The blocking FRAM subroutines are kept as
+//                        wrappers
+//                          - Iod.c: SPI2_Submit(), SPI2_Wait(), SPI2_Flush(), SPI2_XactService(), etc. added
+//                          - Iod.c: FRAM_Read(), Frame_FRAM_Read(), FRAM_Write(), Frame_FRAM_Write(),
+//                            FRAM_WriteMinMax(), FRAM_WriteEnergy(), FRAM_ReadEnergy() revised
+//                          - Init.c: Init_DMAController1(), Init_InterruptStruct() revised
+//                          - Intr.c: DMA1_Stream4_IRQHandler(), SPI2_IRQHandler() added
+//                          - HostShim.c: SPI2 FRAM model added
+//                          - Iod_def.h, Iod_ext.h, HostShim_def.h, HostReplay.c revised
+//   164    240216  DAH - Added an optional Flash waveform pipeline.  When ENABLE_SPI1_DMA is defined, the
+//                        waveform captures are written to Flash a page at a time with two page buffers.  The
+//                        page data is sent by DMA2 Stream 3 instead of polling SPI1, the next page is
+//                        gathered while the present page is programmed, and while a waveform is being
+//                        written, Timer10 is reloaded so that the Flash status is read close to the end of
+//                        each page program (learned page time, then every 20usec).  The next page is
+//                        started soon after the previous page program is done.  A page is only gathered once
+//                        all of its sample sets have been received
+//                          - Iod.c: Flash_PipeService(), Flash_PipeGather(), Flash_PipeStart(),
+//                            Flash_PipeDone(), Flash_PipeStatus() added
+//                          - Iod.c: Flash_WriteWaveform(), IO_VarInit() revised
+//                          - Init.c: Init_DMAController2(), Init_InterruptStruct() revised
+//                          - Intr.c: DMA2_Stream3_IRQHandler() added
+//                          - HostShim.c: SPI1 serial Flash model added
+//                          - HostReplay.c: Replay_FlashBench() and the -flash option added
+//                          - Iod_def.h, Iod_ext.h, HostShim_def.h, HostReplay_def.h, HostReplay_ext.h revised
+//   165    240217  DAH - Added an optional coded format for the waveform captures in Flash.  When
+//                        ENABLE_WF_CODEC is defined, each cycle of each channel is coded as one block (the
+//                        currents quantized to 13 bits of the cycle peak, the voltages lossless), using
+//                        whichever of offset or second-order predicted coding is shorter.  An index of the
+//                        cycles is written at the start of the capture, after the data, so a cycle of a
+//                        channel is read with one index read and one block read.  A capture takes about
+//                        130 - 160 pages instead of 412, and fits in the first block of its slot
+//                          - WfCodec.c, WfCodec_def.h, WfCodec_ext.h added
+//                          - Iod.c: Flash_PipeCode() added
+//                          - Iod.c: Flash_WriteWaveform(), Flash_PipeService(), Flash_PipeStart(),
+//                            Flash_Read(), SPI1_Flash_Manager() revised
+//                          - DispComm.c, Test.c: waveform reads revised
+//                          - HostShim.c: Flash model read added
+//                          - HostReplay.c: Replay_WfCodecBench() and the -wfcodec option added
+//                          - Iod_def.h, FRAM_Flash_def.h, HostShim_def.h, HostReplay_def.h, HostReplay_ext.h
+//                            revised
+//   166    240218  DAH - Added an optional RAM index of the event log EIDs.  When ENABLE_EID_INDEX is
+//                        defined, the EIDs of the Summary, Time Adjustment, Trip, Test Trip, Alarm, and
+//                        Extended Capture log entries are kept in RAM, in the same order as in FRAM.  The
+//                        index is built from FRAM in Event_VarInit() and updated when an entry is written.
+//                        EventLookUp() searches the index instead of reading an EID from FRAM at each step of
+//                        the search, and the Summary log reads get the previous and next EIDs from the index
+//                          - Events.c: EventIndexInit(), EventIndexPut(), EventIndexLookUp(),
+//                            EventLookUpFRAM() added
+//                          - Events.c: EventLookUp(), Event_VarInit(), EventSummaryRead(), and the log write
+//                            subroutines revised
+//                          - HostReplay.c: Replay_EventBench() and the -events option added
+//                          - Iod_def.h, Events_def.h, Events_ext.h, HostReplay_def.h, HostReplay_ext.h
+//                            revised
+//   167    240219  DAH - Added an optional event queue that does not disable interrupts.  When
+//                        ENABLE_EVENT_QUEUE is defined, InsertNewEvent() is called for all new events.  An
+//                        event from an interrupt claims a slot in the interrupt event buffer with an
+//                        exclusive load/store, and is moved into the New Event FIFO and given its EID in the
+//                        foreground, so the EIDs stay in order in the logs.  Events that do not fit are
+//                        counted in EventQStats instead of overwriting unprocessed events
+//                          - Events.c: InsertEventEntry(), InsertIntEvent(), MoveIntEvents() added
+//                          - Events.c: InsertNewEvent(), Event_VarInit(), EventManager() revised
+//                          - main.c: main() revised to call InsertNewEvent() for new events
+//                          - Prot.c, Setpnt.c, DispComm.c: new events revised to call InsertNewEvent()
+//                          - Demand.c: Calc_Demand() revised to call InsertEventEntry()
+//                          - HostShim.c: Host_IPSR added
+//                          - HostReplay.c: Replay_EventQBench() and the -evq option added
+//                          - Iod_def.h, Events_def.h, Events_ext.h, HostShim_def.h, HostReplay_def.h,
+//                            HostReplay_ext.h revised
+//   168    240220  DAH - Added optional write combining of the event log FRAM writes.  When ENABLE_EVENT_WC
+//                        is defined, the event manager processes a burst of Summary events in one call.  The
+//                        Summary log entries are staged in RAM and written with one write, followed by one
+//                        Master EID update and one write of the log index records.  The Master EID is now
+//                        written before the index records, so an EID is never reused after a power loss
+//                          - Events.c: EventWC_Commit() added
+//                          - Events.c: EventManager(), EventSummaryWrite(), EventTripWrite(),
+//                            EventAlarmWrite(), Event_VarInit() revised
+//                          - HostReplay.c: Replay_EventWCBench() and the -evwc option added
+//                          - Iod_def.h, Events_def.h, Events_ext.h, HostReplay_def.h, HostReplay_ext.h
+//                            revised
+//   169    240221  DAH - Added an optional shared CRC-16 module for the Modbus and display processor
+//                        communications.  When ENABLE_CRC_SLICE is defined, whole buffers are done eight
+//                        bytes per step with slicing-by-8 tables, and the receive packet assemblers update
+//                        the CRC a byte at a time without the multiply.  The STM32F407 CRC unit is fixed
+//                        at the 32-bit polynomial, so it is not used
+//                          - Crc.c, Crc_def.h, Crc_ext.h added
+//                          - Modbus.c: CalcCRC() revised
+//                          - DispComm.c: AssembleTxPkt(), AssembleTxPkt1(), AssembleRxPkt(),
+//                            AssembleRxPkt1() revised
+//                          - HostReplay.c: Replay_CrcBench(), Replay_CrcRef(), and the -crc option added
+//                          - Iod_def.h, HostReplay_def.h, HostReplay_ext.h, PXR35_ProtProc.ewp revised
+//   170    240222  DAH - Added an optional scatter-gather encoder for the display processor transmit
+//                        packets.  When ENABLE_DP_TX_SG is defined, the RTD buffer builders gather the
+//                        object addresses into spans (contiguous objects are merged), and the spans are
+//                        byte-stuffed into the Tx buffer a segment at a time, with a word look-ahead for
+//                        the delimiters and one CRC update per span
+//                          - DispComm.c: AssembleTxPktSG(), BuildTxSpans() added
+//                          - DispComm.c: DispComm_Tx(), BuildRTDBufByTSlice(), BuildRTDBufByBufnum()
+//                            revised
+//                          - HostReplay.c: Replay_DPTxBench(), Replay_DPTxDecode(), and the -dptx option
+//                            added
+//                          - Iod_def.h, DispComm_def.h, HostReplay_def.h, HostReplay_ext.h revised
+//   171    240223  DAH - Added an optional register address page index and block encoder for the Modbus
+//                        reads.  When ENABLE_MODB_REG_INDEX is defined, the address group for a request is
+//                        found from a page index that is built from the group tables at initialization,
+//                        instead of by stepping through the groups.  The 32-bit real-time data objects are
+//                        converted with a format descriptor table and stored as a block, with the word
+//                        order setpoints read once per block
+//                          - Modbus.c: Modb_BuildRegIndex(), Modb_StoreObjBlock() added
+//                          - Modbus.c: Modb_VarInit(), Modb_CheckRegAddress(), ProcFC0304Msg() revised
+//                          - HostReplay.c: Replay_ModbBench() and the -modb option added
+//                          - Iod_def.h, Modbus_def.h, HostReplay_def.h, HostReplay_ext.h revised
+//   172    240224  DAH - Added an optional real-time data cache for the Modbus reads.  When
+//                        ENABLE_MODB_RTD_CACHE is defined, the shared real-time data object tables are
+//                        converted to the Modbus register format on the 200msec anniversary, in both the
+//                        fixed point and floating point formats, and stored in a double-buffered cache.  The
+//                        FC03/FC04 block reads are copied from the cache, so every read is of one snapshot
+//                          - main.c: main(), Main_200msecSlice() revised
+//                          - Modbus.c: Modb_RtdCacheRefresh(), Modb_RtdCacheGet() added
+//                          - Modbus.c: Modb_VarInit(), Modb_StoreObjBlock(), ProcFC0304Msg() revised
+//                          - HostReplay.c: Replay_200msecTasks(), Replay_ModbBench() revised
+//                          - Iod_def.h, Modbus_def.h, Modbus_ext.h revised
+//   173    240225  DAH - Added an optional table-driven engine for the one-cycle protection and alarm
+//                        functions.  When ENABLE_PROT_TABLE is defined, the voltage, frequency, and power
+//                        trip and alarm subroutines are replaced by element definition tables.  Only the
+//                        enabled elements are put in the lists (rebuilt when the setpoints change), and the
+//                        lists are evaluated in the original call order
+//                          - main.c: main(), Main_OneCycSlice() revised
+//                          - Prot.c: ProtElem_Build(), ProtElem_Eval(), and support subroutines added
+//                          - Prot.c: Gen_Values() revised
+//                          - Setpnt.c: Load_SetpGr2_LastGr(), Check_Setpoints() revised
+//                          - HostReplay.c: Replay_OneCycTasks() revised, Replay_ProtBench() added
+//                          - Iod_def.h, Prot_def.h, Prot_ext.h, HostReplay_def.h, HostReplay_ext.h revised
+//   174    240226  DAH - Added an optional single-pass computation of the one-cycle values.  When
+//                        ENABLE_ONECYC_KERNEL is defined, Calc_OneCyc_Kernel() replaces Calc_Prot_Current(),
+//                        Calc_Prot_AFE_Voltage(), Calc_ADC_OneCyc_Voltage(), Calc_Prot_Power(), and
+//                        Calc_CF().  The RMS values are computed once and reused for the unbalances, powers,
+//                        and crest factors, the present time is read once, and the max phase powers are
+//                        computed once for all of the power protection and alarm elements
+//                          - main.c: main(), Main_OneCycSlice() revised
+//                          - Meter.c: Calc_OneCyc_Kernel(), Calc_OneCyc_MaxPwr(), and support subroutines
+//                            added
+//                          - Prot.c: ProtElem_PowerInput() revised
+//                          - HostReplay.c: Replay_OneCycTasks(), Replay_ProtBench() revised,
+//                            Replay_KernBench() added
+//                          - Iod_def.h, Meter_def.h, Meter_ext.h, HostReplay_def.h, HostReplay_ext.h revised
+//   175    240227  DAH - Added optional one-cycle sequence components and phase angles.  When
+//                        ENABLE_SEQ_PHASOR is defined, the sampling interrupt sums the fundamental sine and
+//                        cosine products over each cycle, and Calc_SeqComp_PhAng() is called every cycle with
+//                        these phasors instead of every 200msec with the last 80 samples in SampleBuf[]
+//                          - main.c: main(), Main_OneCycSlice(), Main_200msecSlice() revised
+//                          - IntrInline_def.h: update_THD_Sin_Cos_SOS(), save_OC_SOS() revised
+//                          - Intr.c: AFEISR_VarInit() revised
+//                          - Meter.c: Calc_SeqComp_PhAng() revised, Calc_SeqComp_Phasors() added
+//                          - HostReplay.c: Replay_OneCycTasks(), Replay_200msecTasks() revised,
+//                            Replay_SeqBench() added
+//                          - Iod_def.h, Meter_def.h, Meter_ext.h, HostReplay_def.h, HostReplay_ext.h revised
+//   176    240228  DAH - Added an optional zero-crossing frequency tracker.  When ENABLE_FREQ_TRACK is
+//                        defined, the sampling interrupt measures the Van periods by interpolating the zero
+//                        crossings, and Calc_FreqTrack() computes a smoothed frequency and the ROCOF every
+//                        cycle.  When ENABLE_FREQ_RETUNE is also defined, the AFE and ADC sample rate is
+//                        retuned so that there are 80 samples per cycle from 45Hz to 65Hz
+//                          - main.c: main(), Main_OneCycSlice() revised
+//                          - IntrInline_def.h: update_FreqTrack() added
+//                          - Intr.c: DMA1_Stream0_IRQHandler() revised
+//                          - Meter.c: Calc_FreqTrack() added, Meter_VarInit() and MS200_TO_HRS revised
+//                          - Init.c: Update_Sample_Rate() added
+//                          - HostReplay.c: Replay_GetFrame(), Replay_ZeroCross(), Replay_Sample(),
+//                            Replay_OneCycTasks() revised, Replay_FreqBench() added
+//                          - Iod_def.h, Meter_def.h, Meter_ext.h, Init_ext.h, HostReplay_def.h,
+//                            HostReplay_ext.h revised
+//   177    240229  DAH - Added optional sampled-value frames for the CAM ports.  When ENABLE_CAM_SV_FRAME is
+//                        defined, the sampling interrupt collects the sample sets into frames of
+//                        CAMSV_SAMPLES sets with a sequence number, a time stamp, and a CRC, and sends one
+//                        frame per DMA transfer to each sampled-value CAM, instead of one sample set per
+//                        transfer.  Two frame buffers are used, so one is filled while the other is sent
+//                          - main.c: main() revised
+//                          - IntrInline_def.h: publish_CAM_SV() added
+//                          - Intr.c: DMA1_Stream0_IRQHandler() revised
+//                          - CAMCom.c: CAM_SV_VarInit() added
+//                          - HostReplay.c: Replay_CamSvBench() and Replay_CamSvLink() added
+//                          - Iod_def.h, CAMCom_def.h, CAMCom_ext.h, HostReplay_def.h, HostReplay_ext.h
+//                            revised
+//   178    240301  DAH - Review corrections
+//                          - HostShim.c: Host_MapWindow() revised to not replace existing mappings
+//                          - CMakeLists.txt added with the HostReplay host build target.  Events.c revised
+//                            to include Intr_def.h so that it compiles with gcc
+//                          - Apply_CalConstants() is called when the cal constants are changed (DispComm.c:
+//                            ProcWrFactoryConfig(), Test.c: test port and Execute Action calibration, and
+//                            Write_Default_Cal()) instead of every 200msec from the main loop (main.c,
+//                            HostReplay.c)
+//                          - HostReplay.c: Replay_ModbBench() rnsec only declared if ENABLE_MODB_RTD_CACHE
+//                          - HostReplay.c: Replay_ProtBench() and Replay_KernBench() caveats revised
+//                          - Intr_ext.h: added forward declaration of struct SAMPLE_SPAN.  Meter.c:
+//                            Calc_Harmonics() SampleBuf pointers only used if ENABLE_SAMPLE_SOA not defined
+//                          - main.c: main loop code moved into the main loop subroutines (Main_LoopStart()
+//                            thru Main_LoopEnd()), which are called by both the main loop and the main loop
+//                            scheduler tasks (Main_SPI1Slice() thru Main_BkgndSlice())
+//   179    240302  DAH - Review corrections
+//                          - Meter.c: the cycle-folded DFT harmonics are only used if ENABLE_HARM_FOLD is
+//                            defined.  Otherwise, Calc_Harmonics() uses the FFT (chirp-z) method, as before.
+//                            Calc_Harmonics() states 1 and 2 revised to break to state 4.  Iod_def.h,
+//                            Meter_ext.h, Harm_Tables.h, and HostReplay.c revised
+//                          - .gitignore: merge conflict markers removed (both sides kept)
+//                          - CMakeLists.txt: CAVEATS added (not yet built with the real dependencies)
+//                          - HostReplay.c: Replay_SOS200msCheck() added, to check the ADC 200msec voltage
+//                            sums of squares at 50Hz and 60Hz if ENABLE_SIMD_SOS is defined.  Intr.c,
+//                            IntrInline_def.h, and HostReplay_def.h revised
+//                          - Meter.c: the samples are only scaled with x * gain + bias if ENABLE_CAL_BIAS is
+//                            defined.  Otherwise, they are scaled with (x - offset) * gain, as before.
+//                            Iod_def.h, Meter_def.h, Meter_ext.h, and Iod.c revised
+//                          - Test.c: TP_ModifyCal() calls Apply_CalConstants() when a new gain or offset is
+//                            entered
+//                          - main.c: each profiler and loop tracer start/stop pair is now in one function.
+//                            Main_LoopStart() deleted.  The main loop pass, alarm, and 200msec stages and the
+//                            anniversary block traces are measured in main() around the subroutine calls.
+//                            With ENABLE_MAIN_SCHED, the pass is measured in Main_BkgndSlice(), and the
+//                            multi-slice stages and the block traces are not measured (see SchedStat[])
+//                          - Meter.c: Calc_OneCyc_Kernel(), Calc_OneCyc_MaxPwr(), and their support
+//                            subroutines removed, with ENABLE_ONECYC_KERNEL and the HostReplay -kern option
+//                            (Replay_KernBench()).  The kernel was never checked with the actual definitions.
+//                            Meter_def.h, Meter_ext.h, Prot.c, Iod_def.h, and HostReplay revised
+//                          - Prot.c: the table-driven protection element engine (ProtElem_Build(),
+//                            ProtElem_Eval(), and support subroutines) removed, with ENABLE_PROT_TABLE and
+//                            the HostReplay -prot option (Replay_ProtBench()).  The element lists were never
+//                            checked with the actual setpoint definitions.  Main_OneCycProt() and
+//                            Main_OneCycAlarm() always call the protection and alarm subroutines.
+//                            Prot_def.h, Prot_ext.h, Setpnt.c, Iod_def.h, and HostReplay revised
+//                          - WfCodec.c: added the raw (lossless) current blocks and the current error bound
+//                            (WF_CODEC_I_MAX_ERR, commented out in WfCodec_def.h).  With it defined, both
+//                            Flash blocks of a waveform slot are erased.  The number of captures has not
+//                            been increased.  WfCodec_def.h, Iod.c, FRAM_Flash_def.h, and HostReplay revised
+//                          - HostReplay.c: the benchmarks and checks moved into HostReplay_Meter.c,
+//                            HostReplay_Sched.c, HostReplay_Flash.c, HostReplay_Events.c, and
+//                            HostReplay_Comm.c.  The repeated timing, report, and random data code replaced
+//                            with shared subroutines (Replay_TimeStart(), Replay_Ratio(), Replay_RandU(),
+//                            ...).  Only syntax-checked; not yet built with CMakeLists.txt.
+//                            HostReplay_def.h, HostReplay_ext.h, and CMakeLists.txt revised
 //
 //     *** DAH  NEED TO ADD SUPPORT FOR EXECUTE ACTION THAT RESETS THE ENERGY REGISTERS - SEE MINUTES FROM
 //              MODBUS AND METERING DESIGN REVIEW ON 220405.  OPERATION SHOULD BE SIMILAR TO WHAT IS IN THE
@@ -1685,6 +2055,9 @@
 #include "CAMCom_def.h"
 #include "DispComm_def.h"
 #include "Modbus_def.h"
+#include "Profile_def.h"
+#include "Sched_def.h"
+#include "Trace_def.h"
 #include <stdbool.h>
 //#include "pxcan_def.h" - not used here for now
 
@@ -1705,6 +2078,9 @@
 #include "can_driver_ext.h"
 //#include "pxcan_ext.h" - not used here for now.
 #include "Ovrcom_ext.h"
+#include "Profile_ext.h"
+#include "Sched_ext.h"
+#include "Trace_ext.h"
 
 
 
@@ -1719,6 +2095,52 @@ uint8_t DS_OneTimeTest;
 uint32_t DistCounter;
 uint8_t displayOFFTIM;
 
+// Main loop subroutines.  These are called in sequence by the main loop, or one per slice by the main loop
+//   scheduler tasks
+void Main_SPI1Tasks(void);
+void Main_OneCycCalc(void);
+void Main_OneCycProt(void);
+void Main_OneCycAlarm(void);
+void Main_OneCycMoreAlarm(void);
+void Main_OneCycCapture(void);
+void Main_200msecMeter(void);
+void Main_200msecCalc(void);
+void Main_1secTasks(void);
+void Main_5minTasks(void);
+void Main_BkgndStatus(void);
+void Main_BkgndHarm(void);
+void Main_BkgndIO(void);
+void Main_BkgndTP(void);
+void Main_BkgndComm(void);
+void Main_BkgndEvents(void);
+void Main_BkgndMM(void);
+void Main_LoopEnd(void);
+
+uint16_t MainTimeTxDly;                 // 200msec anniversaries until the time is sent to the display
+
+#ifdef ENABLE_MAIN_SCHED
+// Main loop scheduler tasks (see Sched.c).  Each function runs one slice of its task
+uint8_t Main_SPI1Slice(uint8_t slice);
+uint8_t Main_OneCycSlice(uint8_t slice);
+uint8_t Main_200msecSlice(uint8_t slice);
+uint8_t Main_1secSlice(uint8_t slice);
+uint8_t Main_5minSlice(uint8_t slice);
+uint8_t Main_BkgndSlice(uint8_t slice);
+
+uint32_t MainValFlags;                  // New-value flags latched at the start of a background pass
+
+// Main loop task table.  This must be in the same order as the task definitions in Sched_def.h
+const struct SCHED_TASK MAIN_SCHED_TASK[SCHED_NUM_TASKS] =
+{
+  {Main_SPI1Slice,    0,              SCHED_SPI1_PERIOD, SCHED_SPI1_DEADLINE,    SCHED_SPI1_BUDGET},
+  {Main_OneCycSlice,  &OneCycAnniv,   0,                 SCHED_ONECYC_DEADLINE,  SCHED_ONECYC_BUDGET},
+  {Main_200msecSlice, &msec200Anniv,  0,                 SCHED_200MSEC_DEADLINE, SCHED_200MSEC_BUDGET},
+  {Main_1secSlice,    &OneSecAnniv,   0,                 SCHED_1SEC_DEADLINE,    SCHED_1SEC_BUDGET},
+  {Main_5minSlice,    &min5Anniv,     0,                 SCHED_5MIN_DEADLINE,    SCHED_5MIN_BUDGET},
+  {Main_BkgndSlice,   0,              0,                 SCHED_BKGND_DEADLINE,   SCHED_BKGND_BUDGET}
+};
+#endif
+
                       // *** DAH TEST  220207 ADDED FOR MODBUS DEBUGGING START
     extern void Load_MB_Test_Vals(void);
                       // *** DAH TEST  220207 ADDED FOR MODBUS DEBUGGING END
@@ -1842,6 +2264,12 @@ TESTPIN_A3_HIGH;
                                         // Execution time = 56.1usec (rev 0.25 code)
   Test_VarInit();
   Intr_VarInit();                       // Execution time = 18usec (rev 0.25 code)
+#ifdef ENABLE_STAGE_PROFILER
+  Prof_Init();                          // Enable the cycle counter and clear the stage statistics
+#endif
+#ifdef ENABLE_LOOP_TRACE
+  Trace_Init();                         // Enable the cycle counter and clear the loop trace
+#endif
   Setp_VarInit();
   Ovr_VarInit();
   InitRelays();
@@ -1865,6 +2293,9 @@ TESTPIN_A3_HIGH;
   DispComm_VarInit();                   //   DispComm_VarInit(), Event_VarInit(), InitFlashChip(), and
   Event_VarInit();                      //   ReadSwitches()
                                         // Event_VarInit() must be called after IO_VarInit()!!
+#ifdef ENABLE_CAM_SV_FRAME
+  CAM_SV_VarInit();
+#endif
   RT_VarInit();
   Modb_VarInit(TRUE);
 
@@ -1995,10 +2426,14 @@ TESTPIN_A3_HIGH;
     SystemFlags |= RTC_ERR;             //   there.  If RTC has not been configured, set error flag, set
     SysTickTime.cnt_sec = 0;            //   internal time to default, initialize the RTC, and insert
     SysTickTime.cnt_10msec = 0;         //   RTC Bad Power Up event
+#ifdef ENABLE_EVENT_QUEUE
+    EngyDmnd[1].EID = InsertNewEvent(PWRUP_RTC_BAD);              // Demand logging EID is power up EID
+#else
     NewEventFIFO[NewEventInNdx].Code = PWRUP_RTC_BAD;             // Insert event into queue
     Get_InternalTime(&NewEventFIFO[NewEventInNdx].TS);
     NewEventFIFO[NewEventInNdx++].EID = EventMasterEID;
     NewEventInNdx &= 0x0F;                                        // Note, FIFO size must be 16!!
+#endif
   }
   else                                  // RTC appears to be ok.  Read the RTC time.  If it is ok, set
   {                                     //   internal time to RTC time, leave error flag clear, and insert
@@ -2009,27 +2444,39 @@ TESTPIN_A3_HIGH;
     if (IntRTC_Read() )
     {
       RTC_to_SysTickTime(&SysTickTime);
+#ifdef ENABLE_EVENT_QUEUE
+         // Insert event into queue.  InsertNewEvent() restores the interrupt state after reading the time,
+         //   so interrupts stay disabled
+      EngyDmnd[1].EID = InsertNewEvent(PWRUP_RTC_GOOD);
+#else
          // Insert event into queue.  Note, cannot use call to InsertNewEvent() because it disables, then
          //   enables interrupts and we don't want interrupts enabled yet
       NewEventFIFO[NewEventInNdx].Code = PWRUP_RTC_GOOD;
       Get_InternalTime(&NewEventFIFO[NewEventInNdx].TS);
       NewEventFIFO[NewEventInNdx++].EID = EventMasterEID;
       NewEventInNdx &= 0x0F;                                        // Note, FIFO size must be 16!!
+#endif
     }
     else                                // If invalid time, set error flag, set internal time to default,
     {                                   //   and insert RTC Bad Power Up event
       SystemFlags |= RTC_ERR;
       SysTickTime.cnt_sec = 0;
       SysTickTime.cnt_10msec = 0;
+#ifdef ENABLE_EVENT_QUEUE
+      EngyDmnd[1].EID = InsertNewEvent(PWRUP_RTC_BAD);
+#else
       NewEventFIFO[NewEventInNdx].Code = PWRUP_RTC_BAD;             // Insert event into queue
       Get_InternalTime(&NewEventFIFO[NewEventInNdx].TS);
       NewEventFIFO[NewEventInNdx++].EID = EventMasterEID;
       NewEventInNdx &= 0x0F;                                        // Note, FIFO size must be 16!!
+#endif
     }
   }
 
   // Set the Demand Logging EID to the power up EID and increment the master EID
+#ifndef ENABLE_EVENT_QUEUE
   EngyDmnd[1].EID = EventMasterEID++;
+#endif
 
   maxlooptime = 0;                      // Used to measure the maximum main loop time
 
@@ -2078,17 +2525,25 @@ TESTPIN_A3_HIGH;
     //   or the setpoints.  Configuration status is in cfgstat; temp has the setpoints status
     if ( (temp == 2) || (cfgstat == 2) )                // Status = 2 in either section: Frame Error
     {
+#ifdef ENABLE_EVENT_QUEUE
+      InsertNewEvent(STP_ERROR);
+#else
       NewEventFIFO[NewEventInNdx].Code = STP_ERROR;
       Get_InternalTime(&NewEventFIFO[NewEventInNdx].TS);
       NewEventFIFO[NewEventInNdx++].EID = EventMasterEID++;
       NewEventInNdx &= 0x0F;                                        // Note, FIFO size must be 16!!
+#endif
     }
     else if ( (temp == 1) || (cfgstat == 1) )           // Status = 1 in either section: Frame Mismatch
     {
+#ifdef ENABLE_EVENT_QUEUE
+      InsertNewEvent(STP_FRAME_MISMATCH);
+#else
       NewEventFIFO[NewEventInNdx].Code = STP_FRAME_MISMATCH;
       Get_InternalTime(&NewEventFIFO[NewEventInNdx].TS);
       NewEventFIFO[NewEventInNdx++].EID = EventMasterEID++;
       NewEventInNdx &= 0x0F;              // Note, FIFO size must be 16!!
+#endif
     }
 
     // Initialize Timer 2 based on Modbus baud rate from Group 2 setpoints
@@ -2125,7 +2580,7 @@ DS_OneTimeTest = 0;
 
 DistCounter = 0;
 
-temp = 5;
+MainTimeTxDly = 5;
 
 Manufacture_Mode = FALSE;
 
@@ -2141,124 +2596,51 @@ __enable_irq();
   //-------------------------------- Start of Main Loop ----------------------------------------------------
   //
 
+#ifdef ENABLE_MAIN_SCHED
+  // The main loop is run by the scheduler.  Each call runs one slice of the highest-priority task that is
+  //   ready.  The tasks are in MAIN_SCHED_TASK[] (see Main_SPI1Slice() thru Main_BkgndSlice() below)
+  MainValFlags = 0;
+  Sched_Init(&MAIN_SCHED_TASK[0]);
+  while (1)
+  {
+    Sched_Run();
+  }
+#else
+  // The code for each part of the main loop is in the main loop subroutines below (Main_SPI1Tasks() thru
+  //   Main_LoopEnd()).  The scheduler tasks call the same subroutines, one per slice.  The profiler stages
+  //   and the loop tracer blocks that cover more than one subroutine are started and stopped here, so each
+  //   start/stop pair is in one function
   while (1)
   {
 //     TESTPIN_A3_TOGGLE;
+    PROF_START(PROF_MAIN_LOOP);             // Stage profiler (only if ENABLE_STAGE_PROFILER is defined)
+#ifdef ENABLE_LOOP_TRACE
+    Trace_LoopStart();                      // Loop tracer (only if ENABLE_LOOP_TRACE is defined)
+#endif
 
     // This services the 1.5msec timer flags and so must be updated ~every 3msec or so.  Call multiple times
     //   in the main loop  *** DAH check timing
-    ManageSPI1Flags();
-    TA_Volt_Monitoring();
-    AuxPower_Monitoring();     
+    Main_SPI1Tasks();
     
     //------------------------------ One-Cycle Anniversary Subroutines -------------------------------------
     //
     if (OneCycAnniv)                        // *** DAH DO WE WANT TO RUN IF NOT 120MHZ?
     {
-      Calc_Prot_Current();
-      Calc_Prot_AFE_Voltage();
-      Calc_ADC_OneCyc_Voltage();
-      Calc_Prot_Power();
-
-      // This services the 1.5msec timer flags and so must be updated ~every 3msec or so.  Call multiple
-      //   times in the main loop  *** DAH check timing
-      ManageSPI1Flags();
-
-      Calc_CF();
-      Calc_Freq(&FreqLoad, VolAFE200msFltr.Van);
-      Calc_Freq(&FreqLine, VolADC200ms.Van);
-
-      SystemFlags |= ONE_CYC_VALS_DONE;                     // Set flag indicating we have one-cycle values
-      
+      TRACE_START(TRACE_ONECYC);
+      Main_OneCycCalc();
       TA_Volt_Monitoring();
       AuxPower_Monitoring(); 
-
-      // One-cycle protection routines
-      if ((Prot_Enabled) && (!Manufacture_Mode))            // Run protection if it is enabled
-      {
-        if (Setpoints1.stp.Ld_Slp < 4)
-        {
-           LongDelay_Prot();
-        }
-        else
-        {
-           Long_IEE_IEC_Prot();
-        }
-
-        Sneakers_Prot();                        // *** DAH MEASURE EXECUTION TIMES MAY NEED TO ADD CALL TO ManageSPI1Flags()
-        OverVoltage_Prot();
-        UnderVoltage_Prot();
-        VoltUnbalance_Prot();
-        CurUnbalance_Prot();
-        OverFreq_Prot();
-        UnderFreq_Prot();
-        PhaseLoss_Prot();
-        PhaseRotation_Prot();
-        OverRealPower_Prot();
-        OverReactivePower_Prot();
-        OverApparentPower_Prot();
-        PF_Prot();
-        RevActivePower_Prot();
-        RevReactivePower_Prot();
-      }
-
-      // This services the 1.5msec timer flags and so must be updated ~every 3msec or so.  Call multiple
-      //   times in the main loop  *** DAH check timing
+      Main_OneCycProt();
       ManageSPI1Flags();
-
-      // One-cycle alarm routines
-      OverVoltage_Alarm();                         // *** DAH MEASURE EXECUTION TIMES MAY NEED TO ADD CALL TO ManageSPI1Flags()
-      UnderVoltage_Alarm();
-      VoltUnbalance_Alarm();
-      CurUnbalance_Alarm();
-      OverFreq_Alarm();
-      UnderFreq_Alarm();
-      PhaseLoss_Alarm();
-      PhaseRotation_Alarm();
-      OverRealPower_Alarm();
-      OverReactivePower_Alarm();
-      OverApparentPower_Alarm();
-      PF_Alarm();
-      RevActivePower_Alarm();
-      RevReactivePower_Alarm();
-      Ground_Fault_PreAlarm();
-      Sneakers_Alarm();
-
-      // This services the 1.5msec timer flags and so must be updated ~every 3msec or so.  Call multiple
-      //   times in the main loop  *** DAH check timing
+      PROF_START(PROF_MAIN_ONECYC_ALARM);
+      Main_OneCycAlarm();
       ManageSPI1Flags();
-
-      // More one-cycle Alarm routines
-      if (AlarmHoldOffTmr == 0)
-      {
-        Highload_Alarm();                        // *** DAH MEASURE EXECUTION TIMES MAY NEED TO ADD CALL TO ManageSPI1Flags()
-        Thermal_Mem_Alarm();
-        Wrong_Sensor_Alarm_Curr_Condition();
-        WrongSensor_Alarm();
-        THDCurrent_Alarm();
-        THDVoltage_Alarm();
-        Neutral_Alarm();                  
-        TA_Alarm();               
-        BreakerHealth_Alarm();
-      }
-
-      // This services the 1.5msec timer flags and so must be updated ~every 3msec or so.  Call multiple
-      //   times in the main loop  *** DAH check timing
+      Main_OneCycMoreAlarm();
       ManageSPI1Flags();
-
-      // Extended Capture Snapshot Values OneCycle for 6s
-        // *** DAH  NEED TO STORE INITIAL TIME STAMP + EVENT ID (SAME EID AS FOR WAVEFORMS)
-        //  ALSO MAY NEED TO TRANSFER THIS TO FLASH (NOT SURE YET)
-      if ((ExtCap_ReqFlag) || (ExtCap_AckFlag))
-      {
-        ExtendedCapture(OneCycle);
-      }
-
-      // Run subroutine on one-cycle anniversary after protection and alarm functions have completed
-      DisturbanceCapture();
-
+      Main_OneCycCapture();
+      PROF_STOP(PROF_MAIN_ONECYC_ALARM);
+      TRACE_STOP(TRACE_ONECYC);
       OneCycAnniv = FALSE;
-      SystemFlags |= VALONECYC;
     }
     //
     //--------------------------- End Of One-Cycle Anniversary Subroutines ---------------------------------
@@ -2268,71 +2650,15 @@ __enable_irq();
     //
     if (msec200Anniv)
     {
-      Calc_Meter_Current();
-      Calc_Meter_AFE_Voltage();
-      Calc_ADC_200ms_Voltage();
-      Calc_Meter_Power();               // Must follow Calc_Meter_Current() and Calc_Meter_AFE_Voltage()
-
-      // This services the 1.5msec timer flags and so must be updated ~every 3msec or so.  Call multiple
-      //   times in the main loop  *** DAH check timing
+      PROF_START(PROF_MAIN_200MSEC);
+      TRACE_START(TRACE_200MSEC);
+      Main_200msecMeter();
       ManageSPI1Flags();
-
-      Calc_Energy();                    // This must follow Calc_Meter_Power()
-      Calc_Demand();                    // Must follow Calc_Meter_Current() and Calc_Meter_AFE_Voltage()
-      Calc_AppPF();                     // This must follow Calc_Meter_Power()
-      Calc_DispPF_THD();
-      Calc_SeqComp_PhAng();
-      Calc_5minAverages();
-      
-      // Extended Capture Snaphsot Values 200ms for 60s
-      if ((ExtCap_ReqFlag) || (ExtCap_AckFlag))
-      {
-        ExtendedCapture(TwoHundred);
-      }
-      
+      Main_200msecCalc();
+      PROF_STOP(PROF_MAIN_200MSEC);
+      TRACE_STOP(TRACE_200MSEC);
       msec200Anniv = FALSE;
-      SystemFlags |= VAL200MSEC;
-      // Test code to support EAG77 command and send out 3 consecutive GOOSE messages every second
-      if (gtest && (++gtestcnt >= 5))  // *** DAH TEST 210420
-      {
-        gtestcnt = 0;
-        __disable_irq();
-//        TESTPIN_A3_HIGH;   // *** DAH TEST  210421  Publisher
-//        DPComm61850.Req[DP61850_TYPE_TRIP] = 1;
-//        DPComm61850.Req[DP61850_TYPE_ZSI] = 1;
-//        DPComm61850.Req[DP61850_TYPE_XFER] = 1;
-        
-        DPComm61850.Req[DP61850_TYPE_GOCB_STATUS_CTRL] = 1;
-        DPComm61850.Req[DP61850_TYPE_VALS] = 1;
-#ifdef ENABLE_GOOSE_COMM_SPEED_TEST
-        TESTPIN_A3_HIGH;
-#endif
-        __enable_irq();
-      }
-#ifdef ENABLE_GOOSE_COMM_AUTOSEND
-      else if((!gtest) && (++gtestcnt >= 20))
-      {
-        gtest = TRUE;
-      }
-#endif
-
-      if (temp > 0)             // Wait one second, then send time to display processor
-      {
-        if (--temp == 0)
-        {
-          // Set flag to send time up to display micro - note this should be tied to DISPLAY_ENABLE   *** DAH - THIS MUST BE TIED TO WHEN THE DISPLAY PROCESSOR IS TURNED ON - ADD DELAY TO GIVE DISPLAY PROCESSOR TIME TO COME UP
-          DPComm.Flags |= TX_TIME;
-        }
-      }
-      if (displayOFFTIM)        // Display CPU disabled
-      {
-        displayOFFTIM--;
-        if (!displayOFFTIM)
-        {
-          DISPLAY_ENABLE;
-        }
-      }
-    }     // end of 200ms anniversary
+    }
     //
     //---------------------------- End Of 200msec Anniversary Subroutines ----------------------------------
 
@@ -2341,28 +2667,16 @@ __enable_irq();
     //
     if (OneSecAnniv)
     {
-      DISPLAY_ENABLE;                       // *** DAH TURNED ON FOR ENGINEERING DEMO
-      MODBUS_PWR_ENABLE;                    // *** DAH  NEED TO PLACE IN SUBROUTINE IN MAIN LOOP THAT ENABLES POWER IF AUX VOLTAGE
-
-      ReadTHSensor();
-
-      Temp_Prot();
-      Calc_BatteryVolt();
-      //BatteryVolt_Alarm();    // *** BP comment out for now
-
-      // Increment CAN TME counters
-      increment_TME_Counters();
+      TRACE_START(TRACE_1SEC);
+      Main_1secTasks();
+      TRACE_STOP(TRACE_1SEC);
       OneSecAnniv = FALSE;
     }
     //
     //------------------------------ End Of 1sec Anniversary Subroutines -----------------------------------
 
 
-    // This services the 1.5msec timer flags and so must be updated ~every 3msec or so.  Call multiple times
-    //   in the main loop  *** DAH check timing
-    ManageSPI1Flags();
-    TA_Volt_Monitoring();
-    AuxPower_Monitoring(); 
+    Main_SPI1Tasks();
 
     //--------------------------------- 5min Anniversary Subroutines ---------------------------------------
     //
@@ -2371,136 +2685,1200 @@ __enable_irq();
     //   ensure an anniversary does not occur until the startup time has been measured.
     if (min5Anniv)
     {
-      RTC_State = 1;                        // Set state to 1 to initiate RTC update
-      StartupTime.DoCalFlag = TRUE;
-      Check_Setpoints(SetpChkGrp);
-      SetpChkGrp = ((SetpChkGrp >= (NUM_STP_GROUPS - 1)) ? 0 : (SetpChkGrp + 1));
-//      DPComm61850.Req[DP61850_TYPE_ZSI] = TRUE;            // *** DAH  ADDED FOR TEST  201207
+      TRACE_START(TRACE_5MIN);
+      Main_5minTasks();
+      TRACE_STOP(TRACE_5MIN);
       min5Anniv = FALSE;
     }
     //
     //------------------------------ End Of 5min Anniversary Subroutines -----------------------------------
 
-    // This services the 1.5msec timer flags and so must be updated ~every 3msec or so.  Call multiple times
-    //   in the main loop  *** DAH check timing
-    ManageSPI1Flags();
-    TA_Volt_Monitoring();
-    AuxPower_Monitoring(); 
-
-    if ((SystemFlags & RTC_ERR) == RTC_ERR)         // Internal RTC: either initialize it if it didn't come
-    {                                               //   up right, or update it if it is running
-      Init_IntRTC();
-    }
-    else
-    {
-      IntRTC_Update();
-    }
+    TRACE_START(TRACE_BKGND);
+    Main_SPI1Tasks();
 
     // These functions are executed each time through the main loop
+    Main_BkgndStatus();
+    Main_BkgndHarm();
+    Main_BkgndIO();
+    Main_BkgndTP();
+    Main_SPI1Tasks();
+    Main_BkgndComm();
+    SystemFlags &= (~(VALONECYC + VAL200MSEC));
+    Main_BkgndEvents();
+    Main_SPI1Tasks();
+    Main_BkgndMM();
+    TRACE_STOP(TRACE_BKGND);
 
-    // Call subroutines to update the binary status and Pri/Sec/Cause status.  If true is returned, the
-    //   status has changed, so clear the timer to transmit status immediately
-    // Note, two separate "if" statements are used, as opposed to a single "if" statement with an "or" of
-    //   the two functions, because we want both subroutines to be called.  If an "or" statement is used,
-    //   the second subroutine will not be called if the first one returns True
-    if (Update_Std_Status(&TU_BinStatus))
-    {
-      DPComm.RTD_XmitTimer[0] = 0;
-    }
-    if (Update_PSC(&StatusCode))
+#ifdef ENABLE_LOOP_TRACE
+    Trace_LoopEnd();
+#endif
+    Main_LoopEnd();
+    PROF_STOP(PROF_MAIN_LOOP);
+                    // MEASURED MAIN LOOP TIME ON 180221: ~355USEC MAX WITHOUT HARMONICS CALCULATIONS, DISPLAY NOT CONNECTED, NO CAM COMMS GOING ON
+                    // MEASURED MAIN LOOP TIME ON 180625: ~4.6msec MAX WITH HARMONICS CALCULATIONS, DISPLAY NOT CONNECTED, NO CAM COMMS GOING ON
+                    // MEASURED MAIN LOOP TIME ON 190718: ~4.9msec MAX WITH HARMONICS CALCULATIONS, DISPLAY NOT CONNECTED, NO CAM COMMS GOING ON
+  }
+#endif
+
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION        main()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_SPI1Tasks()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           SPI1 Flags and Supply Monitoring
+//
+//  MECHANICS:          This subroutine services the 1.5msec timer flags, and monitors the TA voltage and the
+//                      aux power.  The timer flags must be serviced ~every 3msec or so, so this is called
+//                      several times in each pass of the main loop.  *** DAH check timing
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              ManageSPI1Flags(), TA_Volt_Monitoring(), AuxPower_Monitoring()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_SPI1Tasks(void)
+{
+  ManageSPI1Flags();
+  TA_Volt_Monitoring();
+  AuxPower_Monitoring();
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_SPI1Tasks()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_OneCycCalc()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           One-Cycle Anniversary Calculations
+//
+//  MECHANICS:          This subroutine computes the one-cycle currents, voltages, powers, crest factors, and
+//                      frequencies, and the sequence components if ENABLE_SEQ_PHASOR is defined.  It is the
+//                      first part of the one-cycle anniversary code.
+//
+//  CAVEATS:            ManageSPI1Flags() is called partway through
+//
+//  INPUTS:             VolAFE200msFltr.Van, VolADC200ms.Van
+//
+//  OUTPUTS:            SystemFlags
+//
+//  ALTERS:             None
+//
+//  CALLS:              Calc_Prot_Current(), Calc_Prot_AFE_Voltage(), Calc_ADC_OneCyc_Voltage(),
+//                      Calc_Prot_Power(), and Calc_CF(), ManageSPI1Flags(),
+//                      Calc_Freq(), Calc_FreqTrack(), Calc_SeqComp_PhAng()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_OneCycCalc(void)
+{
+  PROF_START(PROF_MAIN_ONECYC_CALC);
+  Calc_Prot_Current();
+  Calc_Prot_AFE_Voltage();
+  Calc_ADC_OneCyc_Voltage();
+  Calc_Prot_Power();
+
+  // This services the 1.5msec timer flags and so must be updated ~every 3msec or so.  Call multiple times
+  //   in the main loop  *** DAH check timing
+  ManageSPI1Flags();
+
+  Calc_CF();
+  Calc_Freq(&FreqLoad, VolAFE200msFltr.Van);
+  Calc_Freq(&FreqLine, VolADC200ms.Van);
+#ifdef ENABLE_FREQ_TRACK
+  Calc_FreqTrack();                     // Zero-crossing frequency and ROCOF, and sample rate retune
+#endif
+#ifdef ENABLE_SEQ_PHASOR
+  Calc_SeqComp_PhAng();                 // Sequence components and phase angles from the one-cycle phasors
+#endif
+
+  SystemFlags |= ONE_CYC_VALS_DONE;                         // Set flag indicating we have one-cycle values
+  PROF_STOP(PROF_MAIN_ONECYC_CALC);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_OneCycCalc()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_OneCycProt()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           One-Cycle Anniversary Protection
+//
+//  MECHANICS:          This subroutine runs the one-cycle protection functions, if protection is enabled.
+//
+//  CAVEATS:            Must follow Main_OneCycCalc()
+//
+//  INPUTS:             Prot_Enabled, Manufacture_Mode, Setpoints1.stp.Ld_Slp
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              LongDelay_Prot(), Long_IEE_IEC_Prot(), and the xx_Prot() subroutines
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_OneCycProt(void)
+{
+  PROF_START(PROF_MAIN_ONECYC_PROT);
+  if ((Prot_Enabled) && (!Manufacture_Mode))                // Run protection if it is enabled
+  {
+    if (Setpoints1.stp.Ld_Slp < 4)
     {
-      DPComm.RTD_XmitTimer[0] = 0;
+       LongDelay_Prot();
     }
-    Calc_Harmonics();
-    Calc_KFactor();
-    if(Manufacture_Mode == FALSE || ExAct.LED_image == NO_MANUF_TEST)
+    else
     {
-      Service_Status_Led();               // Service status LED
-      Service_NonCOT_Leds();              // Service all other LEDs except for Cause-of-Trip LEDs
+       Long_IEE_IEC_Prot();
     }
 
-    if(Manufacture_Mode == FALSE || ExAct.Relay_image == NO_MANUF_TEST)
-    {
-      RelayManagement();            // Measured execution time on 231129: 1.3msec max
-    }
-    TP_Top();
-    ExAct_Top();
-    CAM_Tx(&CAM1, DMA2_Stream7);
-//    CAM_Tx(&CAM2, DMA2_Stream6);        // *** DAH 220128 disabled for modbus operation
-    CAM_Rx(&CAM1, DMA2_Stream5);
-//    CAM_Rx(&CAM2, DMA2_Stream1);
-                      // *** DAH TEST  220207 ADDED FOR MODBUS AND DISPLAY COMMS DEBUGGING START
-//    Load_MB_Test_Vals();            // Takes about 335usec with present code
-
-                      // *** DAH TEST  220207 ADDED FOR MODBUS AND DISPLAY COMMS DEBUGGING END
-//    __disable_irq();                    // Disable interrupts when checking timing
+    Sneakers_Prot();                            // *** DAH MEASURE EXECUTION TIMES MAY NEED TO ADD CALL TO ManageSPI1Flags()
+    OverVoltage_Prot();
+    UnderVoltage_Prot();
+    VoltUnbalance_Prot();
+    CurUnbalance_Prot();
+    OverFreq_Prot();
+    UnderFreq_Prot();
+    PhaseLoss_Prot();
+    PhaseRotation_Prot();
+    OverRealPower_Prot();
+    OverReactivePower_Prot();
+    OverApparentPower_Prot();
+    PF_Prot();
+    RevActivePower_Prot();
+    RevReactivePower_Prot();
+  }
+  PROF_STOP(PROF_MAIN_ONECYC_PROT);
+}
 
-    // This services the 1.5msec timer flags and so must be updated ~every 3msec or so.  Call multiple times
-    //   in the main loop  *** DAH check timing
-    ManageSPI1Flags();
-    TA_Volt_Monitoring();
-    AuxPower_Monitoring(); 
-
-    // XIP -- Call CAN routines here
-    //TESTPIN_D1_HIGH;  // *** XIP testing Can tasks timing
-    CanTasks(); // ~400 ns - need to measure again as command table grows
-    //TESTPIN_D1_LOW;  // *** XIP testing Can tasks timing
-    ModB_SlaveComm();
-    DispComm_Rx();                      // Rx routine should be called before the Tx routine
-    DispComm_Tx();
-    StartupTimeCal();                    //*** DAH TEST  COMMENT OUT FOR COIL TEMPERATURE  TESTING - SEE REV 29 COMMENT.  WILL NEED TO ADD AND ADC3 MANAGER
-    SystemFlags &= (~(VALONECYC + VAL200MSEC));
-    EventManager();
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_OneCycProt()
+//------------------------------------------------------------------------------------------------------------
 
-    Firmware_Simulated_Test();             
-    Hardware_SecInj_Test(); 
-    Coil_Detection();
-                    
-    // This services the 1.5msec timer flags and so must be updated ~every 3msec or so.  Call multiple times
-    //   in the main loop  *** DAH check timing
-    ManageSPI1Flags();
-    TA_Volt_Monitoring();
-    AuxPower_Monitoring(); 
 
-    MM_Status_Update();
 
-    // resetting of min/max values and functions
-    ResetMinMax();
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_OneCycAlarm()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           One-Cycle Anniversary Alarms
+//
+//  MECHANICS:          This subroutine runs the one-cycle alarm functions.
+//
+//  CAVEATS:            Must follow Main_OneCycProt()
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              The xx_Alarm() subroutines, Ground_Fault_PreAlarm()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_OneCycAlarm(void)
+{
+  OverVoltage_Alarm();                             // *** DAH MEASURE EXECUTION TIMES MAY NEED TO ADD CALL TO ManageSPI1Flags()
+  UnderVoltage_Alarm();
+  VoltUnbalance_Alarm();
+  CurUnbalance_Alarm();
+  OverFreq_Alarm();
+  UnderFreq_Alarm();
+  PhaseLoss_Alarm();
+  PhaseRotation_Alarm();
+  OverRealPower_Alarm();
+  OverReactivePower_Alarm();
+  OverApparentPower_Alarm();
+  PF_Alarm();
+  RevActivePower_Alarm();
+  RevReactivePower_Alarm();
+  Ground_Fault_PreAlarm();
+  Sneakers_Alarm();
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_OneCycAlarm()
+//------------------------------------------------------------------------------------------------------------
 
-    // relay management of assignment
-//    if (Trip_Flags0.all || Trip_Flags1.all || Alarm_Flags0.all || Alarm_Flags1.all || Alarm_Flags2.all || RelayFlagStp)
-//    {
-//      RelayManagement();      //*** DAH to measure time
-//      RelayFlagStp = FALSE;
-//    }
 
-    // Capture time for max loop time measurement
-    __disable_irq();                    // Disable interrupts when checking the system clock
-    Get_InternalTime(&endtime);
-    __enable_irq();
-    if (!(SystemFlags & SKIP_LOOPTIME_MEAS))        // If skip flag is clear, measure the loop time
-    {
-      looptime = ((endtime.Time_secs == starttime.Time_secs) ?
-          (endtime.Time_nsec - starttime.Time_nsec) :
-                ( ((endtime.Time_secs - starttime.Time_secs) * 1000000000)
-                  + endtime.Time_nsec - starttime.Time_nsec));
-      if (looptime > maxlooptime)         // Max loop time = maxlooptime in nanoseconds
-      {
-        maxlooptime = looptime;
-      }
-    }
-    // Set start time to end time for next measurement
-    starttime.Time_secs = endtime.Time_secs;
-    starttime.Time_nsec = endtime.Time_nsec;
-                    // MEASURED MAIN LOOP TIME ON 180221: ~355USEC MAX WITHOUT HARMONICS CALCULATIONS, DISPLAY NOT CONNECTED, NO CAM COMMS GOING ON
-                    // MEASURED MAIN LOOP TIME ON 180625: ~4.6msec MAX WITH HARMONICS CALCULATIONS, DISPLAY NOT CONNECTED, NO CAM COMMS GOING ON
-                    // MEASURED MAIN LOOP TIME ON 190718: ~4.9msec MAX WITH HARMONICS CALCULATIONS, DISPLAY NOT CONNECTED, NO CAM COMMS GOING ON
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_OneCycMoreAlarm()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           More One-Cycle Anniversary Alarms
+//
+//  MECHANICS:          This subroutine runs the remaining one-cycle alarm functions, once the alarm holdoff
+//                      timer has expired.
+//
+//  CAVEATS:            Must follow Main_OneCycAlarm()
+//
+//  INPUTS:             AlarmHoldOffTmr
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              Highload_Alarm(), Thermal_Mem_Alarm(), Wrong_Sensor_Alarm_Curr_Condition(),
+//                      WrongSensor_Alarm(), THDCurrent_Alarm(), THDVoltage_Alarm(), Neutral_Alarm(),
+//                      TA_Alarm(), BreakerHealth_Alarm()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_OneCycMoreAlarm(void)
+{
+  if (AlarmHoldOffTmr == 0)
+  {
+    Highload_Alarm();                            // *** DAH MEASURE EXECUTION TIMES MAY NEED TO ADD CALL TO ManageSPI1Flags()
+    Thermal_Mem_Alarm();
+    Wrong_Sensor_Alarm_Curr_Condition();
+    WrongSensor_Alarm();
+    THDCurrent_Alarm();
+    THDVoltage_Alarm();
+    Neutral_Alarm();
+    TA_Alarm();
+    BreakerHealth_Alarm();
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_OneCycMoreAlarm()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_OneCycCapture()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           One-Cycle Anniversary Captures
+//
+//  MECHANICS:          This subroutine runs the one-cycle extended capture and the disturbance capture.  It
+//                      is the last part of the one-cycle anniversary code, and sets the flag that indicates
+//                      new one-cycle values are available.
+//
+//  CAVEATS:            Must follow Main_OneCycMoreAlarm()
+//
+//  INPUTS:             ExtCap_ReqFlag, ExtCap_AckFlag
+//
+//  OUTPUTS:            SystemFlags
+//
+//  ALTERS:             None
+//
+//  CALLS:              ExtendedCapture(), DisturbanceCapture()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_OneCycCapture(void)
+{
+  // Extended Capture Snapshot Values OneCycle for 6s
+    // *** DAH  NEED TO STORE INITIAL TIME STAMP + EVENT ID (SAME EID AS FOR WAVEFORMS)
+    //  ALSO MAY NEED TO TRANSFER THIS TO FLASH (NOT SURE YET)
+  if ((ExtCap_ReqFlag) || (ExtCap_AckFlag))
+  {
+    ExtendedCapture(OneCycle);
   }
 
+  // Run subroutine on one-cycle anniversary after protection and alarm functions have completed
+  DisturbanceCapture();
+
+  SystemFlags |= VALONECYC;
 }
 
 //------------------------------------------------------------------------------------------------------------
-//             END OF FUNCTION        main()
+//             END OF FUNCTION          Main_OneCycCapture()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_200msecMeter()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           200msec Anniversary Metered Values
+//
+//  MECHANICS:          This subroutine computes the metered currents, voltages, and powers.  It is the
+//                      first part of the 200msec anniversary code.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              Calc_Meter_Current(), Calc_Meter_AFE_Voltage(), Calc_ADC_200ms_Voltage(),
+//                      Calc_Meter_Power()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_200msecMeter(void)
+{
+  Calc_Meter_Current();
+  Calc_Meter_AFE_Voltage();
+  Calc_ADC_200ms_Voltage();
+  Calc_Meter_Power();                   // Must follow Calc_Meter_Current() and Calc_Meter_AFE_Voltage()
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_200msecMeter()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_200msecCalc()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           200msec Anniversary Calculations
+//
+//  MECHANICS:          This subroutine computes the energy, demand, power factors, THD, sequence components
+//                      (if ENABLE_SEQ_PHASOR is not defined), and 5-minute averages, refreshes the Modbus
+//                      real-time data cache (if ENABLE_MODB_RTD_CACHE is defined), and runs the 200msec
+//                      extended capture.  It sets the flag that indicates new 200msec values are available,
+//                      and services the GOOSE test and display timers.  It is the last part of the 200msec
+//                      anniversary code.
+//
+//  CAVEATS:            Must follow Main_200msecMeter()
+//
+//  INPUTS:             ExtCap_ReqFlag, ExtCap_AckFlag
+//
+//  OUTPUTS:            SystemFlags, DPComm.Flags, displayOFFTIM, MainTimeTxDly
+//
+//  ALTERS:             gtest, gtestcnt
+//
+//  CALLS:              Calc_Energy(), Calc_Demand(), Calc_AppPF(), Calc_DispPF_THD(), Calc_SeqComp_PhAng(),
+//                      Calc_5minAverages(), Modb_RtdCacheRefresh(), ExtendedCapture()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_200msecCalc(void)
+{
+  Calc_Energy();                        // This must follow Calc_Meter_Power()
+  Calc_Demand();                        // Must follow Calc_Meter_Current() and Calc_Meter_AFE_Voltage()
+  Calc_AppPF();                         // This must follow Calc_Meter_Power()
+  Calc_DispPF_THD();
+#ifndef ENABLE_SEQ_PHASOR
+  Calc_SeqComp_PhAng();                 // Computed every cycle if ENABLE_SEQ_PHASOR is defined
+#endif
+  Calc_5minAverages();
+#ifdef ENABLE_MODB_RTD_CACHE
+  Modb_RtdCacheRefresh();               // This must follow the metering subroutines
+#endif
+
+  // Extended Capture Snaphsot Values 200ms for 60s
+  if ((ExtCap_ReqFlag) || (ExtCap_AckFlag))
+  {
+    ExtendedCapture(TwoHundred);
+  }
+
+  SystemFlags |= VAL200MSEC;
+  // Test code to support EAG77 command and send out 3 consecutive GOOSE messages every second
+  if (gtest && (++gtestcnt >= 5))  // *** DAH TEST 210420
+  {
+    gtestcnt = 0;
+    __disable_irq();
+//    TESTPIN_A3_HIGH;   // *** DAH TEST  210421  Publisher
+//    DPComm61850.Req[DP61850_TYPE_TRIP] = 1;
+//    DPComm61850.Req[DP61850_TYPE_ZSI] = 1;
+//    DPComm61850.Req[DP61850_TYPE_XFER] = 1;
+
+    DPComm61850.Req[DP61850_TYPE_GOCB_STATUS_CTRL] = 1;
+    DPComm61850.Req[DP61850_TYPE_VALS] = 1;
+#ifdef ENABLE_GOOSE_COMM_SPEED_TEST
+    TESTPIN_A3_HIGH;
+#endif
+    __enable_irq();
+  }
+#ifdef ENABLE_GOOSE_COMM_AUTOSEND
+  else if((!gtest) && (++gtestcnt >= 20))
+  {
+    gtest = TRUE;
+  }
+#endif
+
+  if (MainTimeTxDly > 0)                // Wait one second, then send time to display processor
+  {
+    if (--MainTimeTxDly == 0)
+    {
+      // Set flag to send time up to display micro - note this should be tied to DISPLAY_ENABLE   *** DAH - THIS MUST BE TIED TO WHEN THE DISPLAY PROCESSOR IS TURNED ON - ADD DELAY TO GIVE DISPLAY PROCESSOR TIME TO COME UP
+      DPComm.Flags |= TX_TIME;
+    }
+  }
+  if (displayOFFTIM)                    // Display CPU disabled
+  {
+    displayOFFTIM--;
+    if (!displayOFFTIM)
+    {
+      DISPLAY_ENABLE;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_200msecCalc()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_1secTasks()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           1sec Anniversary Subroutines
+//
+//  MECHANICS:          This subroutine runs the 1sec anniversary code: the temperature and battery voltage
+//                      readings, temperature protection, and the CAN TME counters.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              ReadTHSensor(), Temp_Prot(), Calc_BatteryVolt(), increment_TME_Counters(),
+//                      Trace_Summary()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_1secTasks(void)
+{
+  PROF_START(PROF_MAIN_1SEC);
+  DISPLAY_ENABLE;                       // *** DAH TURNED ON FOR ENGINEERING DEMO
+  MODBUS_PWR_ENABLE;                    // *** DAH  NEED TO PLACE IN SUBROUTINE IN MAIN LOOP THAT ENABLES POWER IF AUX VOLTAGE
+
+  ReadTHSensor();
+
+  Temp_Prot();
+  Calc_BatteryVolt();
+  //BatteryVolt_Alarm();    // *** BP comment out for now
+
+  // Increment CAN TME counters
+  increment_TME_Counters();
+#ifdef ENABLE_LOOP_TRACE
+  Trace_Summary();                      // Update the loop trace percentiles
+#endif
+  PROF_STOP(PROF_MAIN_1SEC);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_1secTasks()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_5minTasks()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           5min Anniversary Subroutines
+//
+//  MECHANICS:          This subroutine runs the 5min anniversary code: it starts the RTC update and the
+//                      startup time calibration, and checks the next setpoints group.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            RTC_State, StartupTime.DoCalFlag, SetpChkGrp
+//
+//  ALTERS:             None
+//
+//  CALLS:              Check_Setpoints()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_5minTasks(void)
+{
+  PROF_START(PROF_MAIN_5MIN);
+  RTC_State = 1;                        // Set state to 1 to initiate RTC update
+  StartupTime.DoCalFlag = TRUE;
+  Check_Setpoints(SetpChkGrp);
+  SetpChkGrp = ((SetpChkGrp >= (NUM_STP_GROUPS - 1)) ? 0 : (SetpChkGrp + 1));
+//  DPComm61850.Req[DP61850_TYPE_ZSI] = TRUE;            // *** DAH  ADDED FOR TEST  201207
+  PROF_STOP(PROF_MAIN_5MIN);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_5minTasks()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_BkgndStatus()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Background RTC and Status
+//
+//  MECHANICS:          This subroutine initializes or updates the internal RTC, and updates the binary
+//                      status and the Pri/Sec/Cause status.  If either status has changed, the timer is
+//                      cleared so that the status is sent to the display processor immediately.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             SystemFlags
+//
+//  OUTPUTS:            DPComm.RTD_XmitTimer[0]
+//
+//  ALTERS:             TU_BinStatus, StatusCode
+//
+//  CALLS:              Init_IntRTC(), IntRTC_Update(), Update_Std_Status(), Update_PSC()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_BkgndStatus(void)
+{
+  if ((SystemFlags & RTC_ERR) == RTC_ERR)           // Internal RTC: either initialize it if it didn't come
+  {                                                 //   up right, or update it if it is running
+    Init_IntRTC();
+  }
+  else
+  {
+    IntRTC_Update();
+  }
+
+  // Call subroutines to update the binary status and Pri/Sec/Cause status.  If true is returned, the
+  //   status has changed, so clear the timer to transmit status immediately
+  // Note, two separate "if" statements are used, as opposed to a single "if" statement with an "or" of
+  //   the two functions, because we want both subroutines to be called.  If an "or" statement is used,
+  //   the second subroutine will not be called if the first one returns True
+  if (Update_Std_Status(&TU_BinStatus))
+  {
+    DPComm.RTD_XmitTimer[0] = 0;
+  }
+  if (Update_PSC(&StatusCode))
+  {
+    DPComm.RTD_XmitTimer[0] = 0;
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_BkgndStatus()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_BkgndHarm()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Background Harmonics
+//
+//  MECHANICS:          This subroutine runs one pass of the harmonics state machine, and computes the
+//                      K-factor.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              Calc_Harmonics(), Calc_KFactor()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_BkgndHarm(void)
+{
+  Calc_Harmonics();
+  Calc_KFactor();
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_BkgndHarm()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_BkgndIO()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Background LEDs and Relays
+//
+//  MECHANICS:          This subroutine services the LEDs and the relays, unless they are being driven by a
+//                      manufacturing test.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             Manufacture_Mode, ExAct.LED_image, ExAct.Relay_image
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              Service_Status_Led(), Service_NonCOT_Leds(), RelayManagement()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_BkgndIO(void)
+{
+  if(Manufacture_Mode == FALSE || ExAct.LED_image == NO_MANUF_TEST)
+  {
+    Service_Status_Led();               // Service status LED
+    Service_NonCOT_Leds();              // Service all other LEDs except for Cause-of-Trip LEDs
+  }
+
+  if(Manufacture_Mode == FALSE || ExAct.Relay_image == NO_MANUF_TEST)
+  {
+    RelayManagement();            // Measured execution time on 231129: 1.3msec max
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_BkgndIO()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_BkgndTP()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Background Test Port, Execute Actions, and CAM Communications
+//
+//  MECHANICS:          This subroutine services the test port, the execute actions, and the CAM1 port.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              TP_Top(), ExAct_Top(), CAM_Tx(), CAM_Rx()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_BkgndTP(void)
+{
+  TP_Top();
+  ExAct_Top();
+  CAM_Tx(&CAM1, DMA2_Stream7);
+//  CAM_Tx(&CAM2, DMA2_Stream6);        // *** DAH 220128 disabled for modbus operation
+  CAM_Rx(&CAM1, DMA2_Stream5);
+//  CAM_Rx(&CAM2, DMA2_Stream1);
+                    // *** DAH TEST  220207 ADDED FOR MODBUS AND DISPLAY COMMS DEBUGGING START
+//  Load_MB_Test_Vals();            // Takes about 335usec with present code
+
+                    // *** DAH TEST  220207 ADDED FOR MODBUS AND DISPLAY COMMS DEBUGGING END
+//  __disable_irq();                    // Disable interrupts when checking timing
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_BkgndTP()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_BkgndComm()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Background Communications
+//
+//  MECHANICS:          This subroutine services the CAN, Modbus, and display processor communications, and
+//                      the startup time measurement.
+//
+//  CAVEATS:            The new-value flags (VALONECYC and VAL200MSEC) are cleared by the caller after this
+//                      subroutine
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              CanTasks(), ModB_SlaveComm(), DispComm_Rx(), DispComm_Tx(), StartupTimeCal()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_BkgndComm(void)
+{
+  // XIP -- Call CAN routines here
+  //TESTPIN_D1_HIGH;  // *** XIP testing Can tasks timing
+  CanTasks(); // ~400 ns - need to measure again as command table grows
+  //TESTPIN_D1_LOW;  // *** XIP testing Can tasks timing
+  ModB_SlaveComm();
+  DispComm_Rx();                        // Rx routine should be called before the Tx routine
+  DispComm_Tx();
+  StartupTimeCal();                      //*** DAH TEST  COMMENT OUT FOR COIL TEMPERATURE  TESTING - SEE REV 29 COMMENT.  WILL NEED TO ADD AND ADC3 MANAGER
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_BkgndComm()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_BkgndEvents()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Background Events and Tests
+//
+//  MECHANICS:          This subroutine runs the event manager, the firmware simulated and hardware secondary
+//                      injection tests, and the coil detection.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              EventManager(), Firmware_Simulated_Test(), Hardware_SecInj_Test(), Coil_Detection()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_BkgndEvents(void)
+{
+  EventManager();
+
+  Firmware_Simulated_Test();
+  Hardware_SecInj_Test();
+  Coil_Detection();
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_BkgndEvents()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_BkgndMM()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Background Maintenance Mode and Min/Max Resets
+//
+//  MECHANICS:          This subroutine updates the maintenance mode status, and services the min/max value
+//                      resets.
+//
+//  CAVEATS:            None
+//
+//  INPUTS:             None
+//
+//  OUTPUTS:            None
+//
+//  ALTERS:             None
+//
+//  CALLS:              MM_Status_Update(), ResetMinMax()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_BkgndMM(void)
+{
+  MM_Status_Update();
+
+  // resetting of min/max values and functions
+  ResetMinMax();
+
+  // relay management of assignment
+//  if (Trip_Flags0.all || Trip_Flags1.all || Alarm_Flags0.all || Alarm_Flags1.all || Alarm_Flags2.all || RelayFlagStp)
+//  {
+//    RelayManagement();      //*** DAH to measure time
+//    RelayFlagStp = FALSE;
+//  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_BkgndMM()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_LoopEnd()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           End of Main Loop Pass
+//
+//  MECHANICS:          This subroutine measures the time for the pass through the main loop, and keeps the
+//                      longest time in maxlooptime.  If ENABLE_LOOP_TRACE is defined, maxlooptime is the
+//                      longest pass recorded by the loop tracer.
+//
+//  CAVEATS:            If ENABLE_LOOP_TRACE is defined, the caller must first finish the pass record with
+//                      Trace_LoopEnd()
+//
+//  INPUTS:             SystemFlags, starttime
+//
+//  OUTPUTS:            maxlooptime, starttime, endtime, looptime
+//
+//  ALTERS:             None
+//
+//  CALLS:              Get_InternalTime()
+//
+//------------------------------------------------------------------------------------------------------------
+
+void Main_LoopEnd(void)
+{
+#ifdef ENABLE_LOOP_TRACE
+  // The loop tracer measures the loop time with the cycle counter, so it is not affected by time
+  //   adjustments (SKIP_LOOPTIME_MEAS)
+  maxlooptime = TRACE_CYC_TO_NSEC(TraceBlock[TRACE_LOOP].Max);
+#else
+  // Capture time for max loop time measurement
+  __disable_irq();                      // Disable interrupts when checking the system clock
+  Get_InternalTime(&endtime);
+  __enable_irq();
+  if (!(SystemFlags & SKIP_LOOPTIME_MEAS))          // If skip flag is clear, measure the loop time
+  {
+    looptime = ((endtime.Time_secs == starttime.Time_secs) ?
+        (endtime.Time_nsec - starttime.Time_nsec) :
+              ( ((endtime.Time_secs - starttime.Time_secs) * 1000000000)
+                + endtime.Time_nsec - starttime.Time_nsec));
+    if (looptime > maxlooptime)           // Max loop time = maxlooptime in nanoseconds
+    {
+      maxlooptime = looptime;
+    }
+  }
+  // Set start time to end time for next measurement
+  starttime.Time_secs = endtime.Time_secs;
+  starttime.Time_nsec = endtime.Time_nsec;
+#endif
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_LoopEnd()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+#ifdef ENABLE_MAIN_SCHED
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_SPI1Slice()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           SPI1 Flags Task
+//
+//  MECHANICS:          This is the SPI1 flags task of the main loop scheduler (SCHED_SPI1).  It runs
+//                      Main_SPI1Tasks(), which is called several times in each pass of the unscheduled main
+//                      loop.  The task has one slice.
+//
+//  CAVEATS:            Only compiled if ENABLE_MAIN_SCHED is defined
+//
+//  INPUTS:             slice - the slice number (not used)
+//
+//  OUTPUTS:            Returns TRUE (the pass is done)
+//
+//  ALTERS:             None
+//
+//  CALLS:              Main_SPI1Tasks()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Main_SPI1Slice(uint8_t slice)
+{
+  Main_SPI1Tasks();
+  return (TRUE);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_SPI1Slice()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_OneCycSlice()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           One-Cycle Anniversary Task
+//
+//  MECHANICS:          This is the one-cycle anniversary task of the main loop scheduler (SCHED_ONECYC).
+//                      It runs the one-cycle anniversary subroutines in five slices.  The slices end where
+//                      the unscheduled main loop calls ManageSPI1Flags():
+//                          Slice 0: One-cycle calculations (Main_OneCycCalc())
+//                          Slice 1: One-cycle protection (Main_OneCycProt())
+//                          Slice 2: One-cycle alarms (Main_OneCycAlarm())
+//                          Slice 3: More one-cycle alarms (Main_OneCycMoreAlarm())
+//                          Slice 4: Extended capture and disturbance capture (Main_OneCycCapture())
+//
+//  CAVEATS:            Only compiled if ENABLE_MAIN_SCHED is defined.  The one-cycle alarm profiler stage
+//                      and the one-cycle loop tracer block cover more than one slice, so they are not
+//                      measured.  The slice times are in SchedStat[SCHED_ONECYC].
+//
+//  INPUTS:             slice - the slice number
+//
+//  OUTPUTS:            Returns TRUE when the last slice is done
+//
+//  ALTERS:             None
+//
+//  CALLS:              Main_OneCycCalc(), Main_OneCycProt(), Main_OneCycAlarm(), Main_OneCycMoreAlarm(),
+//                      Main_OneCycCapture()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Main_OneCycSlice(uint8_t slice)
+{
+  uint8_t done;
+
+  done = FALSE;
+  switch (slice)
+  {
+    case 0:                             // One-cycle calculations
+      Main_OneCycCalc();
+      break;
+
+    case 1:                             // One-cycle protection routines
+      Main_OneCycProt();
+      break;
+
+    case 2:                             // One-cycle alarm routines
+      Main_OneCycAlarm();
+      break;
+
+    case 3:                             // More one-cycle alarm routines
+      Main_OneCycMoreAlarm();
+      break;
+
+    default:                            // Extended capture and disturbance capture
+      Main_OneCycCapture();
+      done = TRUE;
+      break;
+  }
+  return (done);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_OneCycSlice()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_200msecSlice()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           200msec Anniversary Task
+//
+//  MECHANICS:          This is the 200msec anniversary task of the main loop scheduler (SCHED_200MSEC).  It
+//                      runs the 200msec anniversary subroutines in two slices:
+//                          Slice 0: Metered currents, voltages, and power (Main_200msecMeter())
+//                          Slice 1: Energy, demand, power factor, THD, sequence components, 5-minute
+//                                   averages, extended capture, and the display and GOOSE test timers
+//                                   (Main_200msecCalc())
+//
+//  CAVEATS:            Only compiled if ENABLE_MAIN_SCHED is defined.  The 200msec profiler stage and loop
+//                      tracer block cover both slices, so they are not measured.  The slice times are in
+//                      SchedStat[SCHED_200MSEC].
+//
+//  INPUTS:             slice - the slice number
+//
+//  OUTPUTS:            Returns TRUE when the last slice is done
+//
+//  ALTERS:             None
+//
+//  CALLS:              Main_200msecMeter(), Main_200msecCalc()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Main_200msecSlice(uint8_t slice)
+{
+  if (slice == 0)
+  {
+    Main_200msecMeter();
+    return (FALSE);
+  }
+  Main_200msecCalc();
+  return (TRUE);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_200msecSlice()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_1secSlice()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           1sec Anniversary Task
+//
+//  MECHANICS:          This is the 1sec anniversary task of the main loop scheduler (SCHED_1SEC).  It runs
+//                      the 1sec anniversary subroutines (Main_1secTasks()) in one slice.
+//
+//  CAVEATS:            Only compiled if ENABLE_MAIN_SCHED is defined
+//
+//  INPUTS:             slice - the slice number (not used)
+//
+//  OUTPUTS:            Returns TRUE (the pass is done)
+//
+//  ALTERS:             None
+//
+//  CALLS:              Main_1secTasks()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Main_1secSlice(uint8_t slice)
+{
+  Main_1secTasks();
+  return (TRUE);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_1secSlice()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_5minSlice()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           5min Anniversary Task
+//
+//  MECHANICS:          This is the 5min anniversary task of the main loop scheduler (SCHED_5MIN).  It runs
+//                      the 5min anniversary subroutines (Main_5minTasks()) in one slice.
+//
+//  CAVEATS:            Only compiled if ENABLE_MAIN_SCHED is defined
+//
+//  INPUTS:             slice - the slice number (not used)
+//
+//  OUTPUTS:            Returns TRUE (the pass is done)
+//
+//  ALTERS:             None
+//
+//  CALLS:              Main_5minTasks()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Main_5minSlice(uint8_t slice)
+{
+  Main_5minTasks();
+  return (TRUE);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_5minSlice()
+//------------------------------------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------------------------------------
+//             START OF FUNCTION        Main_BkgndSlice()
+//------------------------------------------------------------------------------------------------------------
+//
+//  FUNCTION:           Background Task
+//
+//  MECHANICS:          This is the background task of the main loop scheduler (SCHED_BACKGROUND).  It runs
+//                      the code that is executed each time through the unscheduled main loop, in seven
+//                      slices:
+//                          Slice 0: Internal RTC, binary status, and Pri/Sec/Cause status
+//                          Slice 1: Harmonics (one pass of Calc_Harmonics()) and K-factor
+//                          Slice 2: LEDs and relays
+//                          Slice 3: Test port, execute actions, and CAM communications
+//                          Slice 4: CAN, Modbus, and display communications, and startup time measurement
+//                          Slice 5: Events and the test and coil detection subroutines
+//                          Slice 6: Maintenance mode, min/max resets, and the loop time measurement
+//                      The task is released again as soon as it is done, so one pass of the task
+//                      corresponds to one pass through the unscheduled main loop.  The anniversary tasks may
+//                      run between the slices, so the new-value flags (VALONECYC and VAL200MSEC) are latched
+//                      in slice 0, and only the latched flags are cleared in slice 4.  This way, each flag is
+//                      seen by every slice before it is cleared, the same as in the unscheduled loop.
+//                      The loop time (maxlooptime), the main loop profiler stage, and the loop tracer pass
+//                      are the time for one pass, from the start of slice 0 to the end of slice 6, and so
+//                      include any slices of the other tasks that run in between.
+//
+//  CAVEATS:            Only compiled if ENABLE_MAIN_SCHED is defined
+//
+//  INPUTS:             slice - the slice number
+//
+//  OUTPUTS:            SystemFlags
+//                      Returns TRUE when the last slice is done
+//
+//  ALTERS:             MainValFlags
+//
+//  CALLS:              Trace_LoopStart(), Main_BkgndStatus(), Main_BkgndHarm(), Main_BkgndIO(),
+//                      Main_BkgndTP(), Main_BkgndComm(), Main_BkgndEvents(), Main_BkgndMM(),
+//                      Trace_LoopEnd(), Main_LoopEnd()
+//
+//------------------------------------------------------------------------------------------------------------
+
+uint8_t Main_BkgndSlice(uint8_t slice)
+{
+  uint8_t done;
+
+  done = FALSE;
+  switch (slice)
+  {
+    case 0:                             // RTC and status
+      PROF_START(PROF_MAIN_LOOP);
+#ifdef ENABLE_LOOP_TRACE
+      Trace_LoopStart();
+#endif
+      MainValFlags = (SystemFlags & (VALONECYC + VAL200MSEC));
+      Main_BkgndStatus();
+      break;
+
+    case 1:                             // Harmonics
+      Main_BkgndHarm();
+      break;
+
+    case 2:                             // LEDs and relays
+      Main_BkgndIO();
+      break;
+
+    case 3:                             // Test port, execute actions, and CAM communications
+      Main_BkgndTP();
+      break;
+
+    case 4:                             // Communications
+      Main_BkgndComm();
+      SystemFlags &= (~MainValFlags);       // Clear the new-value flags that were latched in slice 0
+      break;
+
+    case 5:                             // Events and tests
+      Main_BkgndEvents();
+      break;
+
+    default:                            // Maintenance mode, min/max resets, and loop time
+      Main_BkgndMM();
+#ifdef ENABLE_LOOP_TRACE
+      Trace_LoopEnd();
+#endif
+      Main_LoopEnd();
+      PROF_STOP(PROF_MAIN_LOOP);
+      done = TRUE;
+      break;
+  }
+  return (done);
+}
+
+//------------------------------------------------------------------------------------------------------------
+//             END OF FUNCTION          Main_BkgndSlice()
 //------------------------------------------------------------------------------------------------------------
+#endif                  // ENABLE_MAIN_SCHED
 
 
@@ -60,5 +60,5 @@
 
 #define PROT_PROC_FW_VER        0
 #define PROT_PROC_FW_REV        0
-#define PROT_PROC_FW_BUILD      152
+#define PROT_PROC_FW_BUILD      179
 
@@ -89,6 +89,17 @@ typedef enum
 #define TRUE      1
 #define FALSE     0
 
+// Memory placement.  The IAR "@" location operator places the sampling interrupt variables in SRAM1 and
+//   SRAM2 (see stm32f407xG.icf).  gcc does not recognize the operator, so the placement is compiled out in
+//   the host (off-target) build.  See HostShim_def.h
+#ifdef HOST_BUILD
+  #define SRAM1_LOC
+  #define SRAM2_LOC
+#else
+  #define SRAM1_LOC       @".sram1"
+  #define SRAM2_LOC       @".sram2"
+#endif
+
 
 /** @addtogroup Exported_macro
   * @{